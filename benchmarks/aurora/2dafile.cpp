@@ -0,0 +1,146 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for reading 2DA files.
+ */
+
+#include <vector>
+
+#include "src/common/util.h"
+#include "src/common/ustring.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/aurora/2dafile.h"
+
+#include "benchmarks/benchmark.h"
+
+static const size_t kRowCount = 2000;
+
+/** Build an ASCII 2DA, with columns of a few different types, like a baseitems.2da. */
+static void writeASCII(std::vector<byte> &data) {
+	uint32 seed = 0x1234567;
+
+	Common::UString twoda = "2DA V2.0\n\n   Label          Name     Icon        Cost   Weight Flags\n";
+
+	for (size_t i = 0; i < kRowCount; i++) {
+		const uint32 type = Benchmark::random(seed) % 4;
+
+		twoda += Common::UString::format("%u Item_%04u %u %s %u %.2f %s\n", (uint) i, (uint) i,
+		                                 Benchmark::random(seed) % 100000,
+		                                 (type == 0) ? "****" : Common::UString::format("iit_%u", type).c_str(),
+		                                 Benchmark::random(seed) % 5000,
+		                                 (Benchmark::random(seed) % 1000) / 10.0f,
+		                                 (type == 1) ? "****" : Common::UString::format("%u", type * 3).c_str());
+	}
+
+	data.assign(reinterpret_cast<const byte *>(twoda.c_str()), reinterpret_cast<const byte *>(twoda.c_str()) + twoda.size());
+}
+
+/** Convert an ASCII 2DA into a binary 2DA. */
+static void writeBinary(std::vector<byte> &data) {
+	std::vector<byte> ascii;
+	writeASCII(ascii);
+
+	Common::MemoryReadStream asciiStream(&ascii[0], ascii.size());
+	Aurora::TwoDAFile twoda(asciiStream);
+
+	Common::MemoryWriteStreamDynamic stream(true);
+	twoda.writeBinary(stream);
+
+	data.assign(stream.getData(), stream.getData() + stream.size());
+}
+
+BENCHMARK(TwoDAFile, loadASCII) {
+	std::vector<byte> data;
+	writeASCII(data);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Aurora::TwoDAFile twoda(stream);
+
+		Benchmark::doNotOptimize(twoda.getRowCount());
+	}
+}
+
+BENCHMARK(TwoDAFile, loadBinary) {
+	std::vector<byte> data;
+	writeBinary(data);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Aurora::TwoDAFile twoda(stream);
+
+		Benchmark::doNotOptimize(twoda.getRowCount());
+	}
+}
+
+BENCHMARK(TwoDAFile, getValues) {
+	std::vector<byte> data;
+	writeASCII(data);
+
+	Common::MemoryReadStream stream(&data[0], data.size());
+	Aurora::TwoDAFile twoda(stream);
+
+	while (state.keepRunning()) {
+		uint64 sum = 0;
+		for (size_t i = 0; i < twoda.getRowCount(); i++) {
+			const Aurora::TwoDARow &row = twoda.getRow(i);
+
+			sum += row.getString("Label").size();
+			sum += row.getInt("Name");
+			sum += row.getString("Icon").size();
+			sum += row.getInt("Cost");
+			sum += (uint64) row.getFloat("Weight");
+			sum += row.getInt("Flags");
+		}
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+BENCHMARK(TwoDAFile, findRow) {
+	static const size_t kLookupCount = 100;
+
+	std::vector<byte> data;
+	writeASCII(data);
+
+	Common::MemoryReadStream stream(&data[0], data.size());
+	Aurora::TwoDAFile twoda(stream);
+
+	std::vector<Common::UString> labels;
+
+	uint32 seed = 0xABCDEF;
+	for (size_t i = 0; i < kLookupCount; i++)
+		labels.push_back(Common::UString::format("Item_%04u", Benchmark::random(seed) % (uint) kRowCount));
+
+	while (state.keepRunning()) {
+		uint64 sum = 0;
+		for (size_t i = 0; i < kLookupCount; i++)
+			sum += twoda.getRow("Label", labels[i]).getInt("Cost");
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
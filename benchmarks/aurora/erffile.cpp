@@ -0,0 +1,144 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for reading ERF archives.
+ */
+
+#include <vector>
+
+#include "src/common/util.h"
+#include "src/common/ustring.h"
+#include "src/common/scopedptr.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/aurora/types.h"
+#include "src/aurora/erffile.h"
+#include "src/aurora/erfwriter.h"
+
+#include "benchmarks/benchmark.h"
+
+static const uint32 kERFID = MKTAG('M', 'O', 'D', ' ');
+
+static const size_t kResourceCount = 2000;
+
+/** Build an ERF V1.0 with many small text resources, like a module. */
+static void writeERF(std::vector<byte> &data) {
+	uint32 seed = 0x1234567;
+
+	Common::MemoryWriteStreamDynamic stream(true);
+
+	{
+		Aurora::ERFWriter erf(kERFID, kResourceCount, stream);
+
+		for (size_t i = 0; i < kResourceCount; i++) {
+			std::vector<byte> resource;
+			Benchmark::generateText(resource, 512 + Benchmark::random(seed) % 4096, seed);
+
+			Common::MemoryReadStream resourceStream(&resource[0], resource.size());
+			erf.add(Common::UString::format("resource%05u", (uint) i), Aurora::kFileTypeNSS, resourceStream);
+		}
+	}
+
+	data.assign(stream.getData(), stream.getData() + stream.size());
+}
+
+BENCHMARK(ERFFile, load) {
+	std::vector<byte> data;
+	writeERF(data);
+
+	while (state.keepRunning()) {
+		Aurora::ERFFile erf(new Common::MemoryReadStream(&data[0], data.size()));
+
+		Benchmark::doNotOptimize(erf.getResources().size());
+	}
+}
+
+BENCHMARK(ERFFile, getResources) {
+	std::vector<byte> data;
+	writeERF(data);
+
+	Aurora::ERFFile erf(new Common::MemoryReadStream(&data[0], data.size()));
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		uint64 sum = 0;
+		const Aurora::Archive::ResourceList &resources = erf.getResources();
+		for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+			Common::ScopedPtr<Common::SeekableReadStream> resource(erf.getResource(r->index));
+
+			sum += resource->size() + resource->readByte();
+		}
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+BENCHMARK(ERFFile, getResourcesNoCopy) {
+	std::vector<byte> data;
+	writeERF(data);
+
+	Aurora::ERFFile erf(new Common::MemoryReadStream(&data[0], data.size()));
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		uint64 sum = 0;
+		const Aurora::Archive::ResourceList &resources = erf.getResources();
+		for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+			Common::ScopedPtr<Common::SeekableReadStream> resource(erf.getResource(r->index, true));
+
+			sum += resource->size() + resource->readByte();
+		}
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+BENCHMARK(ERFWriter, write) {
+	std::vector<byte> data;
+	writeERF(data);
+
+	// Prepare the resources up front, so that only the writing is measured
+	std::vector< std::vector<byte> > resources(kResourceCount);
+
+	uint32 seed = 0x1234567;
+	for (size_t i = 0; i < kResourceCount; i++)
+		Benchmark::generateText(resources[i], 512 + Benchmark::random(seed) % 4096, seed);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryWriteStreamDynamic stream(true, data.size());
+
+		{
+			Aurora::ERFWriter erf(kERFID, kResourceCount, stream);
+
+			for (size_t i = 0; i < kResourceCount; i++) {
+				Common::MemoryReadStream resourceStream(&resources[i][0], resources[i].size());
+				erf.add(Common::UString::format("resource%05u", (uint) i), Aurora::kFileTypeNSS, resourceStream);
+			}
+		}
+
+		Benchmark::doNotOptimize(stream.size());
+	}
+}
@@ -0,0 +1,147 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for reading and writing GFF3 files.
+ */
+
+#include <vector>
+
+#include "src/common/util.h"
+#include "src/common/ustring.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/aurora/types.h"
+#include "src/aurora/locstring.h"
+#include "src/aurora/gff3file.h"
+#include "src/aurora/gff3writer.h"
+
+#include "benchmarks/benchmark.h"
+
+static const uint32 kGFFID = MKTAG('U', 'T', 'I', ' ');
+
+static const size_t kEntryCount = 2000;
+
+/** Build a GFF3 with a list of item-like structs, each with a few properties. */
+static void createGFF3(Aurora::GFF3Writer &gff) {
+	uint32 seed = 0x1234567;
+
+	Aurora::GFF3WriterListPtr entries = gff.getTopLevel()->addList("Entries");
+
+	for (size_t i = 0; i < kEntryCount; i++) {
+		Aurora::GFF3WriterStructPtr entry = entries->addStruct("Entry");
+
+		entry->addUint32("ID", i);
+		entry->addSint32("Cost", (int32) (Benchmark::random(seed) % 10000) - 5000);
+		entry->addFloat("Weight", (Benchmark::random(seed) % 1000) / 10.0f);
+		entry->addResRef("TemplateResRef", Common::UString::format("it_item%04u", (uint) i));
+		entry->addExoString("Tag", Common::UString::format("ITEM_TAG_%u", Benchmark::random(seed) % 500));
+		entry->addVector("Position", glm::vec3(i * 0.5f, i * 0.25f, 1.0f));
+
+		Aurora::LocString name;
+		name.setString(Aurora::kLanguageEnglish, Common::UString::format("Item number %u", (uint) i));
+		entry->addLocString("LocalizedName", name);
+
+		Aurora::GFF3WriterListPtr properties = entry->addList("PropertiesList");
+		for (uint32 j = 0; j < 3; j++) {
+			Aurora::GFF3WriterStructPtr property = properties->addStruct("Property");
+
+			property->addUint16("PropertyName", Benchmark::random(seed) % 100);
+			property->addByte("CostValue", Benchmark::random(seed) % 20);
+		}
+	}
+}
+
+static void writeGFF3(std::vector<byte> &data) {
+	Aurora::GFF3Writer gff(kGFFID);
+	createGFF3(gff);
+
+	Common::MemoryWriteStreamDynamic stream(true);
+	gff.write(stream);
+
+	data.assign(stream.getData(), stream.getData() + stream.size());
+}
+
+BENCHMARK(GFF3File, load) {
+	std::vector<byte> data;
+	writeGFF3(data);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Aurora::GFF3File gff(new Common::MemoryReadStream(&data[0], data.size()), kGFFID);
+
+		Benchmark::doNotOptimize(gff.getTopLevel().getFieldCount());
+	}
+}
+
+BENCHMARK(GFF3File, loadAndRead) {
+	std::vector<byte> data;
+	writeGFF3(data);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Aurora::GFF3File gff(new Common::MemoryReadStream(&data[0], data.size()), kGFFID);
+
+		const Aurora::GFF3List &entries = gff.getTopLevel().getList("Entries");
+
+		uint64 sum = 0;
+		for (Aurora::GFF3List::const_iterator e = entries.begin(); e != entries.end(); ++e) {
+			sum += (*e)->getUint("ID");
+			sum += (*e)->getSint("Cost");
+			sum += (uint64) (*e)->getDouble("Weight");
+			sum += (*e)->getString("TemplateResRef").size();
+			sum += (*e)->getString("Tag").size();
+
+			float x, y, z;
+			(*e)->getVector("Position", x, y, z);
+			sum += (uint64) x;
+
+			Aurora::LocString name;
+			(*e)->getLocString("LocalizedName", name);
+			sum += name.getString().size();
+
+			const Aurora::GFF3List &properties = (*e)->getList("PropertiesList");
+			for (Aurora::GFF3List::const_iterator p = properties.begin(); p != properties.end(); ++p)
+				sum += (*p)->getUint("PropertyName") + (*p)->getUint("CostValue");
+		}
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+BENCHMARK(GFF3Writer, write) {
+	std::vector<byte> data;
+	writeGFF3(data);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Aurora::GFF3Writer gff(kGFFID);
+		createGFF3(gff);
+
+		Common::MemoryWriteStreamDynamic stream(true, data.size());
+		gff.write(stream);
+
+		Benchmark::doNotOptimize(stream.size());
+	}
+}
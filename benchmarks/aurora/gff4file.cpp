@@ -0,0 +1,174 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for reading GFF4 files.
+ */
+
+#include <vector>
+
+#include "src/common/util.h"
+#include "src/common/ustring.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/aurora/types.h"
+#include "src/aurora/gff4file.h"
+
+#include "benchmarks/benchmark.h"
+
+static const uint32 kGFFType = MKTAG('B', 'E', 'N', 'C');
+
+static const size_t kEntryCount = 5000;
+
+static const uint32 kFieldEntries  = 1;
+static const uint32 kFieldID       = 10;
+static const uint32 kFieldValue    = 11;
+static const uint32 kFieldName     = 12;
+static const uint32 kFieldPosition = 13;
+
+static const size_t kEntrySize = 4 + 4 + 4 + 12;
+
+static void writeFieldDeclaration(Common::WriteStream &stream, uint32 label, uint32 type, uint32 flags, uint32 offset) {
+	stream.writeUint32LE(label);
+	stream.writeUint32LE(type | (flags << 16));
+	stream.writeUint32LE(offset);
+}
+
+/** Build a V4.0 PC GFF4 with a list of structs, each with a few values and a string.
+ *
+ *  We don't have a GFF4 writer, so this is assembled by hand:
+ *  - The header
+ *  - Two struct templates: the top-level struct and a list entry
+ *  - The field declarations of these two templates
+ *  - The data: the top-level struct, the list of entries and their strings
+ */
+static void writeGFF4(std::vector<byte> &data) {
+	static const uint32 kHeaderSize       = 28;
+	static const uint32 kTemplateSize     = 16;
+	static const uint32 kFieldSize        = 12;
+	static const uint32 kTopFieldOffset   = kHeaderSize + 2 * kTemplateSize;
+	static const uint32 kEntryFieldOffset = kTopFieldOffset + 1 * kFieldSize;
+	static const uint32 kDataOffset       = kEntryFieldOffset + 4 * kFieldSize;
+
+	std::vector<Common::UString> names;
+	for (size_t i = 0; i < kEntryCount; i++)
+		names.push_back(Common::UString::format("Entry number %u", (uint) i));
+
+	Common::MemoryWriteStreamDynamic stream(true);
+
+	// Header
+
+	stream.writeUint32BE(MKTAG('G', 'F', 'F', ' '));
+	stream.writeUint32BE(MKTAG('V', '4', '.', '0'));
+	stream.writeUint32BE(MKTAG('P', 'C', ' ', ' '));
+	stream.writeUint32BE(kGFFType);
+	stream.writeUint32BE(MKTAG('V', '0', '.', '1'));
+	stream.writeUint32LE(2);
+	stream.writeUint32LE(kDataOffset);
+
+	// Struct templates
+
+	stream.writeUint32BE(MKTAG('T', 'O', 'P', ' '));
+	stream.writeUint32LE(1);
+	stream.writeUint32LE(kTopFieldOffset);
+	stream.writeUint32LE(4);
+
+	stream.writeUint32BE(MKTAG('E', 'N', 'T', 'R'));
+	stream.writeUint32LE(4);
+	stream.writeUint32LE(kEntryFieldOffset);
+	stream.writeUint32LE(kEntrySize);
+
+	// Field declarations: a list of entry structs in the top-level struct...
+
+	writeFieldDeclaration(stream, kFieldEntries, 1, 0x8000 | 0x4000, 0);
+
+	// ...and the entry values
+
+	writeFieldDeclaration(stream, kFieldID      , Aurora::GFF4Struct::kFieldTypeUint32  , 0,  0);
+	writeFieldDeclaration(stream, kFieldValue   , Aurora::GFF4Struct::kFieldTypeFloat32 , 0,  4);
+	writeFieldDeclaration(stream, kFieldName    , Aurora::GFF4Struct::kFieldTypeString  , 0,  8);
+	writeFieldDeclaration(stream, kFieldPosition, Aurora::GFF4Struct::kFieldTypeVector3f, 0, 12);
+
+	// Data, with all offsets relative to the start of the data
+
+	stream.writeUint32LE(4);
+	stream.writeUint32LE(kEntryCount);
+
+	uint32 stringOffset = 8 + kEntryCount * kEntrySize;
+	for (size_t i = 0; i < kEntryCount; i++) {
+		stream.writeUint32LE(i);
+		stream.writeIEEEFloatLE(i * 0.5f);
+		stream.writeUint32LE(stringOffset);
+		stream.writeIEEEFloatLE(i * 1.0f);
+		stream.writeIEEEFloatLE(i * 2.0f);
+		stream.writeIEEEFloatLE(i * 3.0f);
+
+		stringOffset += 4 + names[i].size() * 2;
+	}
+
+	for (size_t i = 0; i < kEntryCount; i++) {
+		stream.writeUint32LE(names[i].size());
+
+		for (Common::UString::iterator c = names[i].begin(); c != names[i].end(); ++c)
+			stream.writeUint16LE(*c);
+	}
+
+	data.assign(stream.getData(), stream.getData() + stream.size());
+}
+
+BENCHMARK(GFF4File, load) {
+	std::vector<byte> data;
+	writeGFF4(data);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Aurora::GFF4File gff(new Common::MemoryReadStream(&data[0], data.size()), kGFFType);
+
+		Benchmark::doNotOptimize(gff.getTopLevel().getFieldCount());
+	}
+}
+
+BENCHMARK(GFF4File, loadAndRead) {
+	std::vector<byte> data;
+	writeGFF4(data);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Aurora::GFF4File gff(new Common::MemoryReadStream(&data[0], data.size()), kGFFType);
+
+		const Aurora::GFF4List &entries = gff.getTopLevel().getList(kFieldEntries);
+
+		uint64 sum = 0;
+		for (Aurora::GFF4List::const_iterator e = entries.begin(); e != entries.end(); ++e) {
+			sum += (*e)->getUint(kFieldID);
+			sum += (uint64) (*e)->getFloat(kFieldValue);
+			sum += (*e)->getString(kFieldName).size();
+
+			float x, y, z;
+			(*e)->getVector3(kFieldPosition, x, y, z);
+			sum += (uint64) (x + y + z);
+		}
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
@@ -0,0 +1,189 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for reading KEY/BIF archives.
+ */
+
+#include <vector>
+
+#include "src/common/util.h"
+#include "src/common/ustring.h"
+#include "src/common/scopedptr.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/aurora/types.h"
+#include "src/aurora/keyfile.h"
+#include "src/aurora/biffile.h"
+
+#include "benchmarks/benchmark.h"
+
+static const size_t kBIFCount        = 8;
+static const size_t kResourcesPerBIF = 4000;
+
+static Common::UString getResourceName(size_t bif, size_t resource) {
+	return Common::UString::format("res%02u_%05u", (uint) bif, (uint) resource);
+}
+
+/** Build a KEY V1 indexing kBIFCount BIFs of kResourcesPerBIF resources each. */
+static void writeKEY(std::vector<byte> &data) {
+	static const uint32 kHeaderSize        = 64;
+	static const uint32 kBIFEntrySize      = 12;
+	static const uint32 kResourceEntrySize = 22;
+
+	std::vector<Common::UString> bifNames;
+	for (size_t i = 0; i < kBIFCount; i++)
+		bifNames.push_back(Common::UString::format("data\\bench%02u.bif", (uint) i));
+
+	const uint32 offFileTable = kHeaderSize;
+
+	uint32 offResTable = offFileTable + kBIFCount * kBIFEntrySize;
+	for (size_t i = 0; i < kBIFCount; i++)
+		offResTable += bifNames[i].size();
+
+	Common::MemoryWriteStreamDynamic stream(true, offResTable + kBIFCount * kResourcesPerBIF * kResourceEntrySize);
+
+	stream.writeUint32BE(MKTAG('K', 'E', 'Y', ' '));
+	stream.writeUint32BE(MKTAG('V', '1', ' ', ' '));
+	stream.writeUint32LE(kBIFCount);
+	stream.writeUint32LE(kBIFCount * kResourcesPerBIF);
+	stream.writeUint32LE(offFileTable);
+	stream.writeUint32LE(offResTable);
+	stream.writeZeros(8 + 32);
+
+	uint32 nameOffset = offFileTable + kBIFCount * kBIFEntrySize;
+	for (size_t i = 0; i < kBIFCount; i++) {
+		stream.writeUint32LE(0);
+		stream.writeUint32LE(nameOffset);
+		stream.writeUint16LE(bifNames[i].size());
+		stream.writeUint16LE(1);
+
+		nameOffset += bifNames[i].size();
+	}
+
+	for (size_t i = 0; i < kBIFCount; i++)
+		stream.writeString(bifNames[i]);
+
+	for (size_t i = 0; i < kBIFCount; i++) {
+		for (size_t j = 0; j < kResourcesPerBIF; j++) {
+			const Common::UString name = getResourceName(i, j);
+
+			stream.writeString(name);
+			stream.writeZeros(16 - name.size());
+
+			stream.writeUint16LE(Aurora::kFileTypeTXT);
+			stream.writeUint32LE((i << 20) | j);
+		}
+	}
+
+	data.assign(stream.getData(), stream.getData() + stream.size());
+}
+
+/** Build a BIF V1 with kResourcesPerBIF small text resources. */
+static void writeBIF(std::vector<byte> &data) {
+	static const uint32 kHeaderSize        = 20;
+	static const uint32 kResourceEntrySize = 16;
+
+	uint32 seed = 0x1234567;
+
+	std::vector< std::vector<byte> > resources(kResourcesPerBIF);
+	for (size_t i = 0; i < kResourcesPerBIF; i++)
+		Benchmark::generateText(resources[i], 64 + Benchmark::random(seed) % 1024, seed);
+
+	Common::MemoryWriteStreamDynamic stream(true);
+
+	stream.writeUint32BE(MKTAG('B', 'I', 'F', 'F'));
+	stream.writeUint32BE(MKTAG('V', '1', ' ', ' '));
+	stream.writeUint32LE(kResourcesPerBIF);
+	stream.writeUint32LE(0);
+	stream.writeUint32LE(kHeaderSize);
+
+	uint32 offset = kHeaderSize + kResourcesPerBIF * kResourceEntrySize;
+	for (size_t i = 0; i < kResourcesPerBIF; i++) {
+		stream.writeUint32LE(i);
+		stream.writeUint32LE(offset);
+		stream.writeUint32LE(resources[i].size());
+		stream.writeUint32LE(Aurora::kFileTypeTXT);
+
+		offset += resources[i].size();
+	}
+
+	for (size_t i = 0; i < kResourcesPerBIF; i++)
+		stream.write(&resources[i][0], resources[i].size());
+
+	data.assign(stream.getData(), stream.getData() + stream.size());
+}
+
+BENCHMARK(KEYFile, load) {
+	std::vector<byte> data;
+	writeKEY(data);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Aurora::KEYFile key(stream);
+
+		Benchmark::doNotOptimize(key.getResources().size());
+	}
+}
+
+BENCHMARK(BIFFile, loadAndMergeKEY) {
+	std::vector<byte> keyData, bifData;
+	writeKEY(keyData);
+	writeBIF(bifData);
+
+	Common::MemoryReadStream keyStream(&keyData[0], keyData.size());
+	Aurora::KEYFile key(keyStream);
+
+	while (state.keepRunning()) {
+		Aurora::BIFFile bif(new Common::MemoryReadStream(&bifData[0], bifData.size()));
+		bif.mergeKEY(key, 3);
+
+		Benchmark::doNotOptimize(bif.getResources().size());
+	}
+}
+
+BENCHMARK(BIFFile, getResources) {
+	std::vector<byte> keyData, bifData;
+	writeKEY(keyData);
+	writeBIF(bifData);
+
+	Common::MemoryReadStream keyStream(&keyData[0], keyData.size());
+	Aurora::KEYFile key(keyStream);
+
+	Aurora::BIFFile bif(new Common::MemoryReadStream(&bifData[0], bifData.size()));
+	bif.mergeKEY(key, 0);
+
+	state.setBytesPerOperation(bifData.size());
+
+	while (state.keepRunning()) {
+		uint64 sum = 0;
+		const Aurora::Archive::ResourceList &resources = bif.getResources();
+		for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+			Common::ScopedPtr<Common::SeekableReadStream> resource(bif.getResource(r->index));
+
+			sum += resource->size() + resource->readByte();
+		}
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
@@ -0,0 +1,140 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for indexing archives, with and without the index cache.
+ */
+
+#include <boost/filesystem.hpp>
+#include <boost/noncopyable.hpp>
+
+#include "src/common/util.h"
+#include "src/common/ustring.h"
+#include "src/common/platform.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+#include "src/common/writefile.h"
+
+#include "src/aurora/types.h"
+#include "src/aurora/erfwriter.h"
+#include "src/aurora/resman.h"
+
+#include "benchmarks/benchmark.h"
+
+static const uint32 kArchiveCount  =   16;
+static const uint32 kResourceCount = 2000;
+
+/** A temporary directory full of ERF archives, removed again on destruction. */
+class TemporaryArchives : boost::noncopyable {
+public:
+	TemporaryArchives() {
+		Common::Platform::init();
+
+		_path = boost::filesystem::temp_directory_path() /
+		        boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+
+		boost::filesystem::create_directories(_path);
+
+		for (uint32 i = 0; i < kArchiveCount; i++)
+			writeERF(getPath(getArchive(i)), i);
+	}
+
+	~TemporaryArchives() {
+		ResMan.clear();
+
+		boost::filesystem::remove_all(_path);
+	}
+
+	Common::UString getPath(const Common::UString &file) const {
+		return (_path / file.c_str()).generic_string();
+	}
+
+	static Common::UString getArchive(uint32 index) {
+		return Common::UString::format("%u.erf", index);
+	}
+
+	/** Index all archives, optionally through the index cache. */
+	void index(bool useCache, bool saveCache) {
+		ResMan.registerDataBase(_path.generic_string());
+
+		if (useCache)
+			ResMan.setIndexCache(getPath("index.cache"));
+
+		for (uint32 i = 0; i < kArchiveCount; i++)
+			ResMan.indexArchive(getArchive(i), 10 + i);
+
+		if (saveCache)
+			ResMan.saveIndexCache();
+
+		ResMan.clear();
+	}
+
+	void removeCache() {
+		boost::filesystem::remove(_path / "index.cache");
+	}
+
+private:
+	boost::filesystem::path _path;
+
+	/** Write an ERF with many small text resources into a file. */
+	static void writeERF(const Common::UString &path, uint32 seed) {
+		Common::MemoryWriteStreamDynamic erf(true);
+
+		{
+			Aurora::ERFWriter writer(MKTAG('E', 'R', 'F', ' '), kResourceCount, erf);
+
+			for (uint32 i = 0; i < kResourceCount; i++) {
+				const Common::UString data = Common::UString::format("Resource %u of archive %u", i, seed);
+
+				Common::MemoryReadStream stream(data.c_str());
+				writer.add(Common::UString::format("res%u_%u", seed, i), Aurora::kFileTypeTXT, stream);
+			}
+		}
+
+		Common::WriteFile file(path);
+		file.write(erf.getData(), erf.size());
+		file.flush();
+	}
+};
+
+BENCHMARK(ResourceIndexCache, indexUncached) {
+	TemporaryArchives archives;
+
+	while (state.keepRunning())
+		archives.index(false, false);
+}
+
+BENCHMARK(ResourceIndexCache, indexCold) {
+	TemporaryArchives archives;
+
+	// Indexing the archives, and writing them into a new index cache
+	while (state.keepRunning()) {
+		archives.removeCache();
+		archives.index(true, true);
+	}
+}
+
+BENCHMARK(ResourceIndexCache, indexWarm) {
+	TemporaryArchives archives;
+	archives.index(true, true);
+
+	while (state.keepRunning())
+		archives.index(true, false);
+}
@@ -0,0 +1,405 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A small framework for microbenchmarks.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+#include <new>
+#include <atomic>
+#include <string>
+
+#include "src/common/util.h"
+#include "src/common/ustring.h"
+#include "src/common/error.h"
+#include "src/common/writefile.h"
+
+#include "src/version/version.h"
+
+#include "benchmarks/benchmark.h"
+
+// --- Allocation counting ---
+
+/* We replace the global operator new to count the allocations a benchmark
+ * makes. Allocations done with malloc() directly, like within zlib or
+ * liblzma, are not counted. */
+
+static std::atomic<uint64> allocationCount(0);
+
+void *operator new(std::size_t size) {
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	void *ptr = std::malloc(size ? size : 1);
+	if (!ptr)
+		throw std::bad_alloc();
+
+	return ptr;
+}
+
+void *operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+	std::free(ptr);
+}
+
+namespace Benchmark {
+
+// --- State ---
+
+State::State(double minTime) : _minTime(minTime), _phase(kPhaseWarmUp), _startAllocations(0),
+	_operations(0), _time(0.0), _allocations(0), _bytesPerOperation(0) {
+
+}
+
+bool State::keepRunning() {
+	if (_phase == kPhaseWarmUp) {
+		// Run the first operation untimed, to warm up caches and lazy initializations
+		_phase = kPhaseRunning;
+		return true;
+	}
+
+	const Clock::time_point now = Clock::now();
+
+	if (_phase == kPhaseRunning) {
+		if (_operations == 0) {
+			_start            = now;
+			_startAllocations = allocationCount.load(std::memory_order_relaxed);
+
+			_operations = 1;
+			return true;
+		}
+
+		const double time = std::chrono::duration_cast< std::chrono::duration<double> >(now - _start).count();
+		if (time < _minTime) {
+			_operations++;
+			return true;
+		}
+
+		_time        = time;
+		_allocations = allocationCount.load(std::memory_order_relaxed) - _startAllocations;
+
+		_phase = kPhaseDone;
+	}
+
+	return false;
+}
+
+void State::setBytesPerOperation(size_t bytes) {
+	_bytesPerOperation = bytes;
+}
+
+uint64 State::getOperations() const {
+	return _operations;
+}
+
+double State::getTime() const {
+	return _time;
+}
+
+size_t State::getBytesPerOperation() const {
+	return _bytesPerOperation;
+}
+
+uint64 State::getAllocations() const {
+	return _allocations;
+}
+
+// --- Registration ---
+
+struct Entry {
+	const char *group;
+	const char *name;
+
+	Function function;
+};
+
+/** The list of all registered benchmarks, created on first use. */
+static std::vector<Entry> &getBenchmarks() {
+	static std::vector<Entry> benchmarks;
+
+	return benchmarks;
+}
+
+Registrar::Registrar(const char *group, const char *name, Function function) {
+	Entry entry;
+
+	entry.group    = group;
+	entry.name     = name;
+	entry.function = function;
+
+	getBenchmarks().push_back(entry);
+}
+
+// --- Helpers ---
+
+static volatile uint64 sink = 0;
+
+void doNotOptimize(uint64 value) {
+	sink = sink ^ value;
+}
+
+void generateRandom(std::vector<byte> &data, size_t size, uint32 seed) {
+	data.resize(size);
+
+	for (size_t i = 0; i < size; i++)
+		data[i] = random(seed);
+}
+
+void generateText(std::vector<byte> &data, size_t size, uint32 seed) {
+	static const char * const kWords[] = {
+		"the", "a", "of", "and", "to", "in", "is", "was", "that", "it", "for", "on", "with",
+		"sword", "shield", "armor", "ring", "potion", "spell", "scroll", "gold", "door",
+		"dragon", "goblin", "wizard", "knight", "village", "castle", "forest", "journey",
+		"traveller", "antique", "land", "stone", "desert", "visage", "command", "pedestal"
+	};
+
+	data.clear();
+	data.reserve(size);
+
+	size_t lineLength = 0;
+	while (data.size() < size) {
+		const char *word = kWords[random(seed) % ARRAYSIZE(kWords)];
+
+		data.insert(data.end(), word, word + std::strlen(word));
+		lineLength += std::strlen(word) + 1;
+
+		if (lineLength > 60) {
+			data.push_back('\n');
+			lineLength = 0;
+		} else
+			data.push_back(' ');
+	}
+
+	data.resize(size);
+}
+
+// --- Running and reporting ---
+
+struct Result {
+	std::string name;
+
+	bool failed;
+
+	uint64 operations;
+	double nsPerOperation;
+	double mbPerSecond;
+	double allocationsPerOperation;
+};
+
+static bool runBenchmark(const Entry &entry, double minTime, Result &result) {
+	result.name   = std::string(entry.group) + "/" + entry.name;
+	result.failed = false;
+
+	result.operations              = 0;
+	result.nsPerOperation          = 0.0;
+	result.mbPerSecond             = 0.0;
+	result.allocationsPerOperation = 0.0;
+
+	State state(minTime);
+
+	try {
+		entry.function(state);
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Benchmark %s failed", result.name.c_str());
+
+		result.failed = true;
+		return false;
+	}
+
+	result.operations = state.getOperations();
+	if ((result.operations == 0) || (state.getTime() <= 0.0))
+		return true;
+
+	const double seconds = state.getTime() / result.operations;
+
+	result.nsPerOperation          = seconds * 1000000000.0;
+	result.mbPerSecond             = (state.getBytesPerOperation() / (1024.0 * 1024.0)) / seconds;
+	result.allocationsPerOperation = ((double) state.getAllocations()) / result.operations;
+
+	return true;
+}
+
+static void printResult(const Result &result) {
+	if (result.failed) {
+		std::printf("%-48s %12s\n", result.name.c_str(), "FAILED");
+		return;
+	}
+
+	// Not all benchmarks process a meaningful amount of bytes
+	char throughput[32] = "-";
+	if (result.mbPerSecond > 0.0)
+		std::snprintf(throughput, sizeof(throughput), "%.1f", result.mbPerSecond);
+
+	std::printf("%-48s %12llu %16.1f %10s %10.1f\n", result.name.c_str(),
+	            (unsigned long long) result.operations, result.nsPerOperation,
+	            throughput, result.allocationsPerOperation);
+}
+
+/** Quote and escape a string for JSON. */
+static Common::UString quoteJSON(const Common::UString &str) {
+	Common::UString quoted = "\"";
+
+	for (Common::UString::iterator c = str.begin(); c != str.end(); ++c) {
+		if      (*c == '"')
+			quoted += "\\\"";
+		else if (*c == '\\')
+			quoted += "\\\\";
+		else if (*c < 0x20)
+			quoted += Common::UString::format("\\u%04X", (uint) *c);
+		else
+			quoted += *c;
+	}
+
+	quoted += "\"";
+
+	return quoted;
+}
+
+static void writeJSON(const Common::UString &fileName, const char *program, double minTime,
+                      const std::vector<Result> &results) {
+
+	Common::WriteFile json(fileName);
+
+	json.writeString("{\n");
+	json.writeString("  \"context\": {\n");
+	json.writeString("    \"program\": " + quoteJSON(program) + ",\n");
+	json.writeString("    \"version\": " + quoteJSON(Version::getProjectNameVersionFull()) + ",\n");
+	json.writeString(Common::UString::format("    \"min_time\": %.3f\n", minTime));
+	json.writeString("  },\n");
+	json.writeString("  \"benchmarks\": [");
+
+	for (size_t i = 0; i < results.size(); i++) {
+		const Result &result = results[i];
+
+		json.writeString((i == 0) ? "\n" : ",\n");
+		json.writeString("    {\n");
+		json.writeString("      \"name\": " + quoteJSON(result.name) + ",\n");
+
+		if (result.failed) {
+			json.writeString("      \"failed\": true\n");
+		} else {
+			json.writeString(Common::UString::format("      \"operations\": %llu,\n", (unsigned long long) result.operations));
+			json.writeString(Common::UString::format("      \"ns_per_op\": %.1f,\n", result.nsPerOperation));
+			if (result.mbPerSecond > 0.0)
+				json.writeString(Common::UString::format("      \"mb_per_s\": %.3f,\n", result.mbPerSecond));
+			json.writeString(Common::UString::format("      \"allocs_per_op\": %.3f\n", result.allocationsPerOperation));
+		}
+
+		json.writeString("    }");
+	}
+
+	json.writeString("\n  ]\n}\n");
+
+	json.flush();
+	json.close();
+}
+
+} // End of namespace Benchmark
+
+static void printUsage(const char *program) {
+	std::printf("Usage: %s [<options>]\n\n", program);
+	std::printf("  -h      --help               Display this text and exit.\n");
+	std::printf("  -l      --list               List all benchmarks and exit.\n");
+	std::printf("  -f <s>  --filter <s>         Only run benchmarks whose name contains <s>.\n");
+	std::printf("  -t <s>  --min-time <s>       Run each benchmark for at least <s> seconds.\n");
+	std::printf("                               Defaults to 0.5.\n");
+	std::printf("  -j <f>  --json <f>           Also write the results as JSON into file <f>.\n");
+}
+
+static bool isOption(const char *arg, const char *shortName, const char *longName) {
+	return !std::strcmp(arg, shortName) || !std::strcmp(arg, longName);
+}
+
+int main(int argc, char **argv) {
+	const char *program = (argc > 0) ? argv[0] : "benchmark";
+
+	const char *filter   = 0;
+	const char *jsonFile = 0;
+	double      minTime  = 0.5;
+	bool        list     = false;
+
+	for (int i = 1; i < argc; i++) {
+		const bool hasValue = (i + 1) < argc;
+
+		if        (isOption(argv[i], "-h", "--help")) {
+			printUsage(program);
+			return 0;
+		} else if (isOption(argv[i], "-l", "--list")) {
+			list = true;
+		} else if (isOption(argv[i], "-f", "--filter") && hasValue) {
+			filter = argv[++i];
+		} else if (isOption(argv[i], "-t", "--min-time") && hasValue) {
+			minTime = std::atof(argv[++i]);
+		} else if (isOption(argv[i], "-j", "--json") && hasValue) {
+			jsonFile = argv[++i];
+		} else {
+			printUsage(program);
+			return 1;
+		}
+	}
+
+	const std::vector<Benchmark::Entry> &benchmarks = Benchmark::getBenchmarks();
+
+	if (list) {
+		for (std::vector<Benchmark::Entry>::const_iterator b = benchmarks.begin(); b != benchmarks.end(); ++b)
+			std::printf("%s/%s\n", b->group, b->name);
+
+		return 0;
+	}
+
+	std::printf("%-48s %12s %16s %10s %10s\n", "Benchmark", "Operations", "ns/op", "MB/s", "allocs/op");
+
+	std::vector<Benchmark::Result> results;
+
+	bool failed = false;
+	for (std::vector<Benchmark::Entry>::const_iterator b = benchmarks.begin(); b != benchmarks.end(); ++b) {
+		const std::string name = std::string(b->group) + "/" + b->name;
+		if (filter && (name.find(filter) == std::string::npos))
+			continue;
+
+		results.push_back(Benchmark::Result());
+		if (!Benchmark::runBenchmark(*b, minTime, results.back()))
+			failed = true;
+
+		Benchmark::printResult(results.back());
+		std::fflush(stdout);
+	}
+
+	if (jsonFile) {
+		try {
+			Benchmark::writeJSON(jsonFile, program, minTime, results);
+		} catch (...) {
+			Common::exceptionDispatcherError("Failed to write benchmark results to \"%s\"", jsonFile);
+			return 1;
+		}
+	}
+
+	return failed ? 1 : 0;
+}
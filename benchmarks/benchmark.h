@@ -0,0 +1,148 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A small framework for microbenchmarks.
+ *
+ *  A benchmark is a function, defined with the BENCHMARK() macro, that
+ *  first prepares its input and then repeats one operation for as long
+ *  as State::keepRunning() returns true:
+ *
+ *  @code
+ *  BENCHMARK(MemoryReadStream, readUint32LE) {
+ *  	std::vector<byte> data;
+ *  	Benchmark::generateRandom(data, 1024 * 1024);
+ *
+ *  	state.setBytesPerOperation(data.size());
+ *
+ *  	while (state.keepRunning()) {
+ *  		...
+ *  	}
+ *  }
+ *  @endcode
+ *
+ *  The first operation is a warm-up and not counted. Afterwards, the
+ *  operation is repeated until a minimum time has passed. For every
+ *  benchmark, the time per operation, the throughput (if the benchmark
+ *  set the bytes it processes per operation) and the number of allocations
+ *  with operator new per operation are reported.
+ *
+ *  All inputs are meant to be synthetic and generated in-process, so
+ *  that no game data is needed to run the benchmarks.
+ */
+
+#ifndef BENCHMARKS_BENCHMARK_H
+#define BENCHMARKS_BENCHMARK_H
+
+#include <cstddef>
+
+#include <vector>
+#include <chrono>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+
+namespace Benchmark {
+
+/** The state of a running benchmark. */
+class State : boost::noncopyable {
+public:
+	State(double minTime);
+
+	/** Start the next operation.
+	 *
+	 *  @return true if another operation should be run, false if enough
+	 *          operations have been timed.
+	 */
+	bool keepRunning();
+
+	/** Set the number of bytes processed by each operation. */
+	void setBytesPerOperation(size_t bytes);
+
+	/** Return the number of timed operations. */
+	uint64 getOperations() const;
+	/** Return the time taken by all timed operations, in seconds. */
+	double getTime() const;
+	/** Return the number of bytes processed by each operation. */
+	size_t getBytesPerOperation() const;
+	/** Return the number of allocations made by all timed operations. */
+	uint64 getAllocations() const;
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	enum Phase {
+		kPhaseWarmUp,
+		kPhaseRunning,
+		kPhaseDone
+	};
+
+	double _minTime;
+
+	Phase _phase;
+
+	Clock::time_point _start;
+	uint64 _startAllocations;
+
+	uint64 _operations;
+	double _time;
+	uint64 _allocations;
+
+	size_t _bytesPerOperation;
+};
+
+typedef void (*Function)(State &state);
+
+/** Registers a benchmark function on construction. Used by BENCHMARK(). */
+class Registrar {
+public:
+	Registrar(const char *group, const char *name, Function function);
+};
+
+/** Make sure the compiler can't optimize away the calculation of this value. */
+void doNotOptimize(uint64 value);
+
+/** Return the next value of a simple, reproducible pseudo-random number generator. */
+static inline uint32 random(uint32 &seed) {
+	seed = seed * 1103515245 + 12345;
+
+	return seed >> 8;
+}
+
+/** Fill the data with reproducible, pseudo-random bytes. */
+void generateRandom(std::vector<byte> &data, size_t size, uint32 seed = 0x1234567);
+
+/** Fill the data with reproducible, pseudo-random text made of words.
+ *
+ *  Unlike random bytes, this compresses about as well as the text
+ *  and scripts found in the game data.
+ */
+void generateText(std::vector<byte> &data, size_t size, uint32 seed = 0x1234567);
+
+} // End of namespace Benchmark
+
+/** Define and register a benchmark function. */
+#define BENCHMARK(group, name) \
+	static void benchmark_##group##_##name(Benchmark::State &state); \
+	static Benchmark::Registrar benchmarkRegistrar_##group##_##name(#group, #name, &benchmark_##group##_##name); \
+	static void benchmark_##group##_##name(Benchmark::State &state)
+
+#endif // BENCHMARKS_BENCHMARK_H
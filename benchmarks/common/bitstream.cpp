@@ -0,0 +1,229 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for reading from BitStream and MemoryBitStream.
+ */
+
+#include <vector>
+
+#include "src/common/util.h"
+#include "src/common/memreadstream.h"
+#include "src/common/bitstream.h"
+#include "src/common/membitstream.h"
+
+#include "benchmarks/benchmark.h"
+
+static const size_t kDataSize = 256 * 1024;
+
+/** Read the whole bit stream in groups of varying bit counts, like a codec would. */
+template<class BitStreamType>
+static uint64 readBits(BitStreamType &bits, size_t size) {
+	static const size_t kBitCounts[] = { 1, 3, 7, 2, 12, 5, 16, 9, 4, 13, 1, 6 };
+
+	uint64 sum = 0;
+
+	size_t left = size * 8;
+	for (size_t i = 0; ; i = (i + 1) % ARRAYSIZE(kBitCounts)) {
+		if (left < kBitCounts[i])
+			break;
+
+		sum  += bits.getBits(kBitCounts[i]);
+		left -= kBitCounts[i];
+	}
+
+	return sum;
+}
+
+/** Read the bit stream through its abstract interface, as the audio and video decoders do. */
+template<class BitStreamType>
+static void getBitsVirtual(Benchmark::State &state) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		BitStreamType bitStream(stream);
+
+		Common::BitStream &bits = bitStream;
+
+		Benchmark::doNotOptimize(readBits(bits, data.size()));
+	}
+}
+
+/** Read the memory bit stream directly. */
+template<class BitStreamType>
+static void getBitsMemory(Benchmark::State &state) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		BitStreamType bits(&data[0], data.size());
+
+		Benchmark::doNotOptimize(readBits(bits, data.size()));
+	}
+}
+
+BENCHMARK(BitStream, getBit8MSB) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Common::BitStream8MSB bits(stream);
+
+		uint64 sum = 0;
+		for (size_t i = 0; i < (kDataSize * 8); i++)
+			sum += bits.getBit();
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+BENCHMARK(BitStream, getBits8MSB) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Common::BitStream8MSB bits(stream);
+
+		Benchmark::doNotOptimize(readBits(bits, data.size()));
+	}
+}
+
+BENCHMARK(BitStream, getBits32LELSB) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Common::BitStream32LELSB bits(stream);
+
+		Benchmark::doNotOptimize(readBits(bits, data.size()));
+	}
+}
+
+BENCHMARK(BitStream, getBitsVirtual) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Common::BitStream32LELSB bits32(stream);
+
+		// Read through the abstract interface, as the audio and video decoders do
+		Common::BitStream &bits = bits32;
+
+		Benchmark::doNotOptimize(readBits(bits, data.size()));
+	}
+}
+
+BENCHMARK(MemoryBitStream, getBit8MSB) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryBitStream8MSB bits(&data[0], data.size());
+
+		uint64 sum = 0;
+		for (size_t i = 0; i < (kDataSize * 8); i++)
+			sum += bits.getBit();
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+BENCHMARK(MemoryBitStream, getBits8MSB) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryBitStream8MSB bits(&data[0], data.size());
+
+		Benchmark::doNotOptimize(readBits(bits, data.size()));
+	}
+}
+
+BENCHMARK(MemoryBitStream, getBits32LELSB) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryBitStream32LELSB bits(&data[0], data.size());
+
+		Benchmark::doNotOptimize(readBits(bits, data.size()));
+	}
+}
+
+BENCHMARK(MemoryBitStream, getBits16LEMSB) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryBitStream16LEMSB bits(&data[0], data.size());
+
+		Benchmark::doNotOptimize(readBits(bits, data.size()));
+	}
+}
+
+BENCHMARK(BitStream, getBitsVirtual16BEMSB) {
+	getBitsVirtual<Common::BitStream16BEMSB>(state);
+}
+
+BENCHMARK(BitStream, getBitsVirtual64LELSB) {
+	getBitsVirtual<Common::BitStream64LELSB>(state);
+}
+
+BENCHMARK(BitStream, getBitsVirtual64BEMSB) {
+	getBitsVirtual<Common::BitStream64BEMSB>(state);
+}
+
+BENCHMARK(MemoryBitStream, getBits16BEMSB) {
+	getBitsMemory<Common::MemoryBitStream16BEMSB>(state);
+}
+
+BENCHMARK(MemoryBitStream, getBits64LELSB) {
+	getBitsMemory<Common::MemoryBitStream64LELSB>(state);
+}
+
+BENCHMARK(MemoryBitStream, getBits64BEMSB) {
+	getBitsMemory<Common::MemoryBitStream64BEMSB>(state);
+}
@@ -0,0 +1,144 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for decompressing DEFLATE data.
+ */
+
+#include <vector>
+
+#include <zlib.h>
+
+#include "src/common/util.h"
+#include "src/common/scopedptr.h"
+#include "src/common/error.h"
+#include "src/common/memreadstream.h"
+#include "src/common/deflate.h"
+
+#include "benchmarks/benchmark.h"
+
+static const size_t kDataSize = 4 * 1024 * 1024;
+
+/** Generate text and compress it into a zlib stream. */
+static void createCompressed(std::vector<byte> &uncompressed, std::vector<byte> &compressed) {
+	Benchmark::generateText(uncompressed, kDataSize);
+
+	uLongf compressedSize = compressBound(uncompressed.size());
+	compressed.resize(compressedSize);
+
+	if (compress(&compressed[0], &compressedSize, &uncompressed[0], uncompressed.size()) != Z_OK)
+		throw Common::Exception("Failed to compress benchmark data");
+
+	compressed.resize(compressedSize);
+}
+
+BENCHMARK(Deflate, decompressBuffer) {
+	std::vector<byte> uncompressed, compressed;
+	createCompressed(uncompressed, compressed);
+
+	state.setBytesPerOperation(uncompressed.size());
+
+	while (state.keepRunning()) {
+		Common::ScopedArray<byte> data(Common::decompressDeflate(&compressed[0], compressed.size(),
+		                                                         uncompressed.size(), Common::kWindowBitsMax));
+
+		Benchmark::doNotOptimize(data[0]);
+	}
+}
+
+BENCHMARK(Deflate, decompressStream) {
+	std::vector<byte> uncompressed, compressed;
+	createCompressed(uncompressed, compressed);
+
+	state.setBytesPerOperation(uncompressed.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream input(&compressed[0], compressed.size());
+
+		Common::ScopedPtr<Common::SeekableReadStream>
+			data(Common::decompressDeflate(input, compressed.size(), uncompressed.size(), Common::kWindowBitsMax));
+
+		Benchmark::doNotOptimize(data->readByte());
+	}
+}
+
+BENCHMARK(Deflate, decompressWithoutOutputSize) {
+	std::vector<byte> uncompressed, compressed;
+	createCompressed(uncompressed, compressed);
+
+	state.setBytesPerOperation(uncompressed.size());
+
+	while (state.keepRunning()) {
+		size_t size = 0;
+		Common::ScopedArray<byte> data(Common::decompressDeflateWithoutOutputSize(&compressed[0], compressed.size(),
+		                                                                          size, Common::kWindowBitsMax));
+
+		Benchmark::doNotOptimize(data[0] + size);
+	}
+}
+
+BENCHMARK(Deflate, inflateReadStream) {
+	std::vector<byte> uncompressed, compressed;
+	createCompressed(uncompressed, compressed);
+
+	std::vector<byte> chunk(4096);
+
+	state.setBytesPerOperation(uncompressed.size());
+
+	while (state.keepRunning()) {
+		Common::InflateReadStream stream(new Common::MemoryReadStream(&compressed[0], compressed.size()),
+		                                 uncompressed.size(), Common::kWindowBitsMax);
+
+		uint64 sum = 0;
+		while (!stream.eos())
+			sum += stream.read(&chunk[0], chunk.size());
+
+		Benchmark::doNotOptimize(sum + chunk[0]);
+	}
+}
+
+BENCHMARK(Deflate, inflateReadStreamSeek) {
+	static const size_t kSeekCount = 64;
+
+	std::vector<byte> uncompressed, compressed;
+	createCompressed(uncompressed, compressed);
+
+	std::vector<uint32> positions(kSeekCount);
+
+	uint32 seed = 0xABCDEF;
+	for (size_t i = 0; i < kSeekCount; i++)
+		positions[i] = Benchmark::random(seed) % (uncompressed.size() - 4);
+
+	Common::InflateReadStream stream(new Common::MemoryReadStream(&compressed[0], compressed.size()),
+	                                 uncompressed.size(), Common::kWindowBitsMax);
+
+	// Inflate once, to record all restart points
+	stream.seek(uncompressed.size() - 1);
+
+	while (state.keepRunning()) {
+		uint64 sum = 0;
+		for (size_t i = 0; i < kSeekCount; i++) {
+			stream.seek(positions[i]);
+			sum += stream.readUint32LE();
+		}
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
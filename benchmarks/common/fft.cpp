@@ -0,0 +1,126 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for the FFT and the MDCT built on it.
+ *
+ *  Every transform runs with each set of kernels, at sizes typical
+ *  for WMA and Bink audio. Kernels the CPU doesn't support are
+ *  skipped, and report no operations.
+ */
+
+#include <vector>
+#include <algorithm>
+
+#include "src/common/util.h"
+#include "src/common/fft.h"
+#include "src/common/mdct.h"
+
+#include "benchmarks/benchmark.h"
+
+/** Fill with reproducible values between -1.0 and 1.0. */
+static void generateSamples(std::vector<float> &data) {
+	uint32 seed = 0x1234567;
+
+	for (std::vector<float>::iterator d = data.begin(); d != data.end(); ++d)
+		*d = (Benchmark::random(seed) / (float) (1 << 23)) - 1.0f;
+}
+
+static void fft(Benchmark::State &state, int bits, Common::TransformKernels kernels) {
+	if (!Common::hasTransformKernels(kernels))
+		return;
+
+	std::vector<float> input(2 << bits), data(2 << bits);
+	generateSamples(input);
+
+	state.setBytesPerOperation(data.size() * sizeof(float));
+
+	Common::FFT transform(bits, true, kernels);
+
+	while (state.keepRunning()) {
+		// The FFT is in-place, so start with fresh input every time, instead of values growing out of bounds
+		std::copy(input.begin(), input.end(), data.begin());
+
+		transform.calc(reinterpret_cast<Common::Complex *>(&data[0]));
+	}
+}
+
+static void imdct(Benchmark::State &state, int bits, Common::TransformKernels kernels) {
+	if (!Common::hasTransformKernels(kernels))
+		return;
+
+	std::vector<float> input(1 << bits), output(1 << bits);
+	generateSamples(input);
+
+	state.setBytesPerOperation(input.size() * sizeof(float));
+
+	Common::MDCT transform(bits, true, 1.0, kernels);
+
+	while (state.keepRunning())
+		transform.calcIMDCT(&output[0], &input[0]);
+}
+
+BENCHMARK(FFT, points256Scalar) {
+	fft(state, 8, Common::kTransformKernelsScalar);
+}
+
+BENCHMARK(FFT, points256SSE) {
+	fft(state, 8, Common::kTransformKernelsSSE);
+}
+
+BENCHMARK(FFT, points256AVX) {
+	fft(state, 8, Common::kTransformKernelsAVX);
+}
+
+BENCHMARK(FFT, points2048Scalar) {
+	fft(state, 11, Common::kTransformKernelsScalar);
+}
+
+BENCHMARK(FFT, points2048SSE) {
+	fft(state, 11, Common::kTransformKernelsSSE);
+}
+
+BENCHMARK(FFT, points2048AVX) {
+	fft(state, 11, Common::kTransformKernelsAVX);
+}
+
+BENCHMARK(MDCT, imdct256Scalar) {
+	imdct(state, 8, Common::kTransformKernelsScalar);
+}
+
+BENCHMARK(MDCT, imdct256SSE) {
+	imdct(state, 8, Common::kTransformKernelsSSE);
+}
+
+BENCHMARK(MDCT, imdct256AVX) {
+	imdct(state, 8, Common::kTransformKernelsAVX);
+}
+
+BENCHMARK(MDCT, imdct2048Scalar) {
+	imdct(state, 11, Common::kTransformKernelsScalar);
+}
+
+BENCHMARK(MDCT, imdct2048SSE) {
+	imdct(state, 11, Common::kTransformKernelsSSE);
+}
+
+BENCHMARK(MDCT, imdct2048AVX) {
+	imdct(state, 11, Common::kTransformKernelsAVX);
+}
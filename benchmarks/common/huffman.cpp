@@ -0,0 +1,341 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for decoding Huffman codes.
+ */
+
+#include <vector>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
+#include "src/common/memreadstream.h"
+#include "src/common/bitstream.h"
+#include "src/common/membitstream.h"
+#include "src/common/huffman.h"
+
+#include "src/sound/decoders/wmadata.h"
+
+#include "src/video/binkdata.h"
+
+#include "benchmarks/benchmark.h"
+
+static const size_t kDataSize = 256 * 1024;
+
+/** A complete prefix code of 65 codes, with lengths of 4 to 12 bits.
+ *
+ *  Since the code is complete, any sequence of bits is a valid stream
+ *  of codes. And random bits then decode to the shorter codes more
+ *  often than to the longer ones, just like in real data.
+ *
+ *  For LSB-first streams, the first bit read is stored in the LSB of a
+ *  code, so the codes need to be bit-reversed to stay a prefix code.
+ */
+class HuffmanCode {
+public:
+	HuffmanCode(bool lsbFirst = false) {
+		static const uint8 kLengthCounts[] = { 0, 0, 0, 0, 4, 8, 16, 31, 1, 1, 1, 1, 2 };
+
+		// Assign canonical codes
+		uint32 code = 0;
+		for (uint8 length = 1; length < ARRAYSIZE(kLengthCounts); length++) {
+			code <<= 1;
+
+			for (uint8 i = 0; i < kLengthCounts[length]; i++) {
+				_codes.push_back(lsbFirst ? reverseBits(code, length) : code);
+				code++;
+				_lengths.push_back(length);
+				_symbols.push_back(_symbols.size() * 3 + 1);
+			}
+		}
+	}
+
+	Common::Huffman *createDecoder() const {
+		return new Common::Huffman(kMaxLength, _codes.size(), &_codes[0], &_lengths[0], &_symbols[0]);
+	}
+
+	/** Count the number of codes that can be decoded from this data, without running out of bits. */
+	template<class BitStreamType>
+	size_t countCodes(const std::vector<byte> &data) const {
+		Common::ScopedPtr<Common::Huffman> huffman(createDecoder());
+
+		BitStreamType bits(&data[0], data.size());
+
+		size_t count = 0;
+		while ((bits.size() - bits.pos()) >= kMaxLength) {
+			huffman->getSymbol(bits);
+			count++;
+		}
+
+		return count;
+	}
+
+	static const uint8 kMaxLength = 12;
+
+private:
+	std::vector<uint32> _codes;
+	std::vector<uint8>  _lengths;
+	std::vector<uint32> _symbols;
+
+	static uint32 reverseBits(uint32 value, uint8 n) {
+		uint32 result = 0;
+		for (uint8 i = 0; i < n; i++, value >>= 1)
+			result = (result << 1) | (value & 1);
+
+		return result;
+	}
+};
+
+BENCHMARK(Huffman, getSymbolBitStream) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	HuffmanCode code;
+	Common::ScopedPtr<Common::Huffman> huffman(code.createDecoder());
+
+	const size_t count = code.countCodes<Common::MemoryBitStream8MSB>(data);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Common::BitStream8MSB bits8(stream);
+
+		// Decode through the abstract interface, with virtual calls for every bit access
+		Common::BitStream &bits = bits8;
+
+		uint64 sum = 0;
+		for (size_t i = 0; i < count; i++)
+			sum += huffman->getSymbol(bits);
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+BENCHMARK(Huffman, getSymbolMemoryBitStream8MSB) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	HuffmanCode code;
+	Common::ScopedPtr<Common::Huffman> huffman(code.createDecoder());
+
+	const size_t count = code.countCodes<Common::MemoryBitStream8MSB>(data);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryBitStream8MSB bits(&data[0], data.size());
+
+		uint64 sum = 0;
+		for (size_t i = 0; i < count; i++)
+			sum += huffman->getSymbol(bits);
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+BENCHMARK(Huffman, getSymbolMemoryBitStream32LELSB) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	HuffmanCode code(true);
+	Common::ScopedPtr<Common::Huffman> huffman(code.createDecoder());
+
+	const size_t count = code.countCodes<Common::MemoryBitStream32LELSB>(data);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryBitStream32LELSB bits(&data[0], data.size());
+
+		uint64 sum = 0;
+		for (size_t i = 0; i < count; i++)
+			sum += huffman->getSymbol(bits);
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+BENCHMARK(Huffman, construct) {
+	HuffmanCode code;
+
+	while (state.keepRunning()) {
+		Common::ScopedPtr<Common::Huffman> huffman(code.createDecoder());
+
+		Benchmark::doNotOptimize((uint64) (uintptr_t) huffman.get());
+	}
+}
+
+/** The original Huffman decoder, reading a code bit by bit and comparing it against all codes of that length. */
+class ReferenceHuffman {
+public:
+	ReferenceHuffman(size_t codeCount, const uint32 *codes, const uint8 *lengths) {
+		uint8 maxLength = 0;
+		for (size_t i = 0; i < codeCount; i++)
+			maxLength = MAX(maxLength, lengths[i]);
+
+		_codes.resize(maxLength);
+		for (size_t i = 0; i < codeCount; i++)
+			_codes[lengths[i] - 1].push_back(Symbol(codes[i], i));
+	}
+
+	uint32 getSymbol(Common::BitStream &bits) const {
+		uint32 code = 0;
+
+		for (size_t i = 0; i < _codes.size(); i++) {
+			bits.addBit(code, i);
+
+			for (CodeList::const_iterator c = _codes[i].begin(); c != _codes[i].end(); ++c)
+				if (code == c->code)
+					return c->symbol;
+		}
+
+		throw Common::Exception("Unknown Huffman code");
+	}
+
+private:
+	struct Symbol {
+		uint32 code;
+		uint32 symbol;
+
+		Symbol(uint32 c, uint32 s) : code(c), symbol(s) {
+		}
+	};
+
+	typedef std::vector<Symbol> CodeList;
+
+	std::vector<CodeList> _codes;
+};
+
+/* The WMA and Bink codes, decoded the way the decoders do, with the original
+ * bit-by-bit decoder as the baseline. Both sets of codes are complete, so
+ * random data decodes like a real stream. */
+
+/** Count the number of WMA coefficient codes in the data, without running out of bits. */
+static size_t countWMACodes(const std::vector<byte> &data) {
+	const Sound::WMACoefHuffmanParam &param = Sound::coefHuffmanParam[0];
+	Common::Huffman huffman(0, param.n, param.huffCodes, param.huffBits);
+
+	Common::MemoryBitStream8MSB bits(&data[0], data.size());
+
+	size_t count = 0;
+	while ((bits.size() - bits.pos()) >= 32) {
+		huffman.getSymbol(bits);
+		count++;
+	}
+
+	return count;
+}
+
+BENCHMARK(Huffman, wmaReference) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	const Sound::WMACoefHuffmanParam &param = Sound::coefHuffmanParam[0];
+	ReferenceHuffman huffman(param.n, param.huffCodes, param.huffBits);
+
+	const size_t count = countWMACodes(data);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Common::BitStream8MSB bits(stream);
+
+		uint64 sum = 0;
+		for (size_t i = 0; i < count; i++)
+			sum += huffman.getSymbol(bits);
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+BENCHMARK(Huffman, wmaTable) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	const Sound::WMACoefHuffmanParam &param = Sound::coefHuffmanParam[0];
+	Common::Huffman huffman(0, param.n, param.huffCodes, param.huffBits);
+
+	const size_t count = countWMACodes(data);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Common::BitStream8MSB bits8(stream);
+
+		// The WMA decoder reads through the abstract interface
+		Common::BitStream &bits = bits8;
+
+		uint64 sum = 0;
+		for (size_t i = 0; i < count; i++)
+			sum += huffman.getSymbol(bits);
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+/** The number of Bink codes to decode with each of the 16 codebooks. */
+static const size_t kBinkCodeCount = 16384;
+
+BENCHMARK(Huffman, binkReference) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	std::vector<ReferenceHuffman> huffman;
+	for (size_t i = 0; i < ARRAYSIZE(binkHuffmanCodes); i++)
+		huffman.push_back(ReferenceHuffman(16, binkHuffmanCodes[i], binkHuffmanLengths[i]));
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Common::BitStream32LELSB bits(stream);
+
+		uint64 sum = 0;
+		for (size_t i = 0; i < huffman.size(); i++)
+			for (size_t j = 0; j < kBinkCodeCount; j++)
+				sum += huffman[i].getSymbol(bits);
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+BENCHMARK(Huffman, binkTable) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	Common::PtrVector<Common::Huffman> huffman;
+	for (size_t i = 0; i < ARRAYSIZE(binkHuffmanCodes); i++)
+		huffman.push_back(new Common::Huffman(binkHuffmanLengths[i][15], 16, binkHuffmanCodes[i], binkHuffmanLengths[i]));
+
+	while (state.keepRunning()) {
+		// The Bink decoder reads its video packets out of memory
+		Common::MemoryBitStream32LELSB bits(&data[0], data.size());
+
+		uint64 sum = 0;
+		for (size_t i = 0; i < huffman.size(); i++)
+			for (size_t j = 0; j < kBinkCodeCount; j++)
+				sum += huffman[i]->getSymbol(bits);
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
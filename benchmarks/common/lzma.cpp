@@ -0,0 +1,96 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for decompressing LZMA data.
+ */
+
+#include <vector>
+
+#include <lzma.h>
+
+#include "src/common/util.h"
+#include "src/common/scopedptr.h"
+#include "src/common/error.h"
+#include "src/common/memreadstream.h"
+#include "src/common/lzma.h"
+
+#include "benchmarks/benchmark.h"
+
+static const size_t kDataSize = 2 * 1024 * 1024;
+
+/** Generate text and compress it into raw LZMA1 data, prefixed by the LZMA1 properties. */
+static void createCompressed(std::vector<byte> &uncompressed, std::vector<byte> &compressed) {
+	Benchmark::generateText(uncompressed, kDataSize);
+
+	lzma_options_lzma options;
+	if (lzma_lzma_preset(&options, 6))
+		throw Common::Exception("Failed to create LZMA1 options");
+
+	lzma_filter filters[2] = {
+		{ LZMA_FILTER_LZMA1, &options },
+		{ LZMA_VLI_UNKNOWN , 0 }
+	};
+
+	uint32 propsSize;
+	if (lzma_properties_size(&propsSize, &filters[0]) != LZMA_OK)
+		throw Common::Exception("Can't get LZMA1 properties size");
+
+	compressed.resize(propsSize + uncompressed.size() + uncompressed.size() / 2 + 4096);
+
+	if (lzma_properties_encode(&filters[0], &compressed[0]) != LZMA_OK)
+		throw Common::Exception("Failed to encode LZMA1 properties");
+
+	size_t compressedSize = propsSize;
+	if (lzma_raw_buffer_encode(filters, 0, &uncompressed[0], uncompressed.size(),
+	                           &compressed[0], &compressedSize, compressed.size()) != LZMA_OK)
+		throw Common::Exception("Failed to compress benchmark data");
+
+	compressed.resize(compressedSize);
+}
+
+BENCHMARK(LZMA, decompressBuffer) {
+	std::vector<byte> uncompressed, compressed;
+	createCompressed(uncompressed, compressed);
+
+	state.setBytesPerOperation(uncompressed.size());
+
+	while (state.keepRunning()) {
+		Common::ScopedArray<byte> data(Common::decompressLZMA1(&compressed[0], compressed.size(), uncompressed.size()));
+
+		Benchmark::doNotOptimize(data[0]);
+	}
+}
+
+BENCHMARK(LZMA, decompressStream) {
+	std::vector<byte> uncompressed, compressed;
+	createCompressed(uncompressed, compressed);
+
+	state.setBytesPerOperation(uncompressed.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream input(&compressed[0], compressed.size());
+
+		Common::ScopedPtr<Common::SeekableReadStream>
+			data(Common::decompressLZMA1(input, compressed.size(), uncompressed.size()));
+
+		Benchmark::doNotOptimize(data->readByte());
+	}
+}
@@ -0,0 +1,130 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for reading from a MemoryReadStream.
+ */
+
+#include <vector>
+
+#include "src/common/util.h"
+#include "src/common/memreadstream.h"
+
+#include "benchmarks/benchmark.h"
+
+static const size_t kDataSize = 1024 * 1024;
+
+BENCHMARK(MemoryReadStream, readByte) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+
+		uint64 sum = 0;
+		for (size_t i = 0; i < kDataSize; i++)
+			sum += stream.readByte();
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+BENCHMARK(MemoryReadStream, readUint32LE) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+
+		uint64 sum = 0;
+		for (size_t i = 0; i < (kDataSize / 4); i++)
+			sum += stream.readUint32LE();
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+BENCHMARK(MemoryReadStream, readUint32BE) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+
+		uint64 sum = 0;
+		for (size_t i = 0; i < (kDataSize / 4); i++)
+			sum += stream.readUint32BE();
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+BENCHMARK(MemoryReadStream, readChunks4K) {
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	std::vector<byte> chunk(4096);
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+
+		uint64 sum = 0;
+		while (!stream.eos())
+			sum += stream.read(&chunk[0], chunk.size());
+
+		Benchmark::doNotOptimize(sum + chunk[0]);
+	}
+}
+
+BENCHMARK(MemoryReadStream, seekRead) {
+	static const size_t kSeekCount = 65536;
+
+	std::vector<byte> data;
+	Benchmark::generateRandom(data, kDataSize);
+
+	// Random, but reproducible positions to read values from
+	std::vector<uint32> positions(kSeekCount);
+
+	uint32 seed = 0xABCDEF;
+	for (size_t i = 0; i < kSeekCount; i++)
+		positions[i] = Benchmark::random(seed) % (kDataSize - 4);
+
+	state.setBytesPerOperation(kSeekCount * 4);
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+
+		uint64 sum = 0;
+		for (size_t i = 0; i < kSeekCount; i++) {
+			stream.seek(positions[i]);
+			sum += stream.readUint32LE();
+		}
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
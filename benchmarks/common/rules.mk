@@ -0,0 +1,43 @@
+# xoreos - A reimplementation of BioWare's Aurora engine
+#
+# xoreos is the legal property of its developers, whose names
+# can be found in the AUTHORS file distributed with this source
+# distribution.
+#
+# xoreos is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# xoreos is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+
+# Microbenchmarks for the Common namespace.
+
+EXTRA_PROGRAMS += benchmarks/bench_common
+BENCHMARKS     += benchmarks/bench_common
+CLEANFILES     += benchmarks/bench_common.json
+
+benchmarks_bench_common_SOURCES = \
+    $(bench_FRAMEWORK) \
+    benchmarks/common/memreadstream.cpp \
+    benchmarks/common/bitstream.cpp \
+    benchmarks/common/huffman.cpp \
+    benchmarks/common/deflate.cpp \
+    benchmarks/common/ustring.cpp \
+    benchmarks/common/fft.cpp \
+    $(EMPTY)
+
+if ENABLE_LZMA
+benchmarks_bench_common_SOURCES += benchmarks/common/lzma.cpp
+endif
+
+benchmarks_bench_common_LDADD = \
+    src/common/libcommon.la \
+    src/version/libversion.la \
+    $(LDADD)
@@ -0,0 +1,281 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for UString operations.
+ *
+ *  Each operation runs on pure ASCII strings, as found in nearly all of
+ *  the game data, and on strings containing non-ASCII characters.
+ */
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include <boost/unordered_map.hpp>
+
+#include "src/common/util.h"
+#include "src/common/ustring.h"
+#include "src/common/encoding.h"
+
+#include "benchmarks/benchmark.h"
+
+static const size_t kStringCount = 2000;
+
+/** Create a set of resource-name-like strings, optionally with a non-ASCII character in each. */
+static size_t createStrings(std::vector<Common::UString> &strings, bool ascii) {
+	uint32 seed = 0x1234567;
+
+	size_t size = 0;
+
+	strings.reserve(kStringCount);
+	for (size_t i = 0; i < kStringCount; i++) {
+		Common::UString str(ascii ? "N_Tex" : "N_T\xC3\xA9x");
+
+		for (int j = 0; j < 10; j++)
+			str += (uint32) ((j % 2) ? 'a' : 'A') + (Benchmark::random(seed) % 26);
+
+		strings.push_back(str);
+		size += str.size();
+	}
+
+	return size;
+}
+
+static void construct(Benchmark::State &state, bool ascii) {
+	std::vector<Common::UString> strings;
+	state.setBytesPerOperation(createStrings(strings, ascii));
+
+	std::vector<std::string> raw;
+	for (size_t i = 0; i < strings.size(); i++)
+		raw.push_back(strings[i].c_str());
+
+	while (state.keepRunning()) {
+		size_t sizes = 0;
+		for (size_t i = 0; i < raw.size(); i++)
+			sizes += Common::UString(raw[i]).size();
+
+		Benchmark::doNotOptimize(sizes);
+	}
+}
+
+static void append(Benchmark::State &state, bool ascii) {
+	std::vector<Common::UString> strings;
+	state.setBytesPerOperation(createStrings(strings, ascii));
+
+	while (state.keepRunning()) {
+		Common::UString str;
+		for (size_t i = 0; i < strings.size(); i++)
+			str += strings[i];
+
+		Benchmark::doNotOptimize(str.size());
+	}
+}
+
+static void iterate(Benchmark::State &state, bool ascii) {
+	std::vector<Common::UString> strings;
+	state.setBytesPerOperation(createStrings(strings, ascii));
+
+	while (state.keepRunning()) {
+		uint64 sum = 0;
+		for (size_t i = 0; i < strings.size(); i++)
+			for (Common::UString::iterator c = strings[i].begin(); c != strings[i].end(); ++c)
+				sum += *c;
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+static void stricmp(Benchmark::State &state, bool ascii) {
+	std::vector<Common::UString> strings;
+	state.setBytesPerOperation(createStrings(strings, ascii));
+
+	while (state.keepRunning()) {
+		int compares = 0;
+		for (size_t i = 1; i < strings.size(); i++)
+			compares += strings[i].stricmp(strings[i - 1]);
+
+		Benchmark::doNotOptimize(compares);
+	}
+}
+
+static void toLower(Benchmark::State &state, bool ascii) {
+	std::vector<Common::UString> strings;
+	state.setBytesPerOperation(createStrings(strings, ascii));
+
+	while (state.keepRunning()) {
+		size_t sizes = 0;
+		for (size_t i = 0; i < strings.size(); i++)
+			sizes += strings[i].toLower().size();
+
+		Benchmark::doNotOptimize(sizes);
+	}
+}
+
+static void getPosition(Benchmark::State &state, bool ascii) {
+	std::vector<Common::UString> strings;
+	state.setBytesPerOperation(createStrings(strings, ascii));
+
+	while (state.keepRunning()) {
+		size_t sum = 0;
+		for (size_t i = 0; i < strings.size(); i++)
+			sum += strings[i].getPosition(strings[i].getPosition(i % strings[i].size()));
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+static void mapFind(Benchmark::State &state, bool ascii) {
+	std::vector<Common::UString> strings;
+	state.setBytesPerOperation(createStrings(strings, ascii));
+
+	std::map<Common::UString, size_t, Common::UString::iless> map;
+	for (size_t i = 0; i < strings.size(); i++)
+		map.insert(std::make_pair(strings[i], i));
+
+	while (state.keepRunning()) {
+		size_t sum = 0;
+		for (size_t i = 0; i < strings.size(); i++)
+			sum += map.find(strings[i])->second;
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+static void hashMapFind(Benchmark::State &state, bool ascii) {
+	std::vector<Common::UString> strings;
+	state.setBytesPerOperation(createStrings(strings, ascii));
+
+	typedef boost::unordered_map<Common::UString, size_t, Common::hashUStringCaseInsensitive> HashMap;
+
+	HashMap hashMap;
+	for (size_t i = 0; i < strings.size(); i++)
+		hashMap.insert(std::make_pair(strings[i], i));
+
+	while (state.keepRunning()) {
+		size_t sum = 0;
+		for (size_t i = 0; i < strings.size(); i++)
+			sum += hashMap.find(strings[i])->second;
+
+		Benchmark::doNotOptimize(sum);
+	}
+}
+
+static void readStringUTF16LE(Benchmark::State &state, bool ascii) {
+	std::vector<Common::UString> strings;
+	createStrings(strings, ascii);
+
+	// Encode all strings as UTF-16LE, the way they're found in talk tables and GFF4s
+	std::vector<byte> data;
+	std::vector<size_t> offsets;
+
+	for (size_t i = 0; i < strings.size(); i++) {
+		offsets.push_back(data.size());
+
+		for (Common::UString::iterator c = strings[i].begin(); c != strings[i].end(); ++c) {
+			data.push_back( *c       & 0xFF);
+			data.push_back((*c >> 8) & 0xFF);
+		}
+	}
+
+	offsets.push_back(data.size());
+
+	state.setBytesPerOperation(data.size());
+
+	while (state.keepRunning()) {
+		size_t sizes = 0;
+		for (size_t i = 0; i < strings.size(); i++)
+			sizes += Common::readString(&data[offsets[i]], offsets[i + 1] - offsets[i], Common::kEncodingUTF16LE).size();
+
+		Benchmark::doNotOptimize(sizes);
+	}
+}
+
+BENCHMARK(UString, constructASCII) {
+	construct(state, true);
+}
+
+BENCHMARK(UString, constructUTF8) {
+	construct(state, false);
+}
+
+BENCHMARK(UString, appendASCII) {
+	append(state, true);
+}
+
+BENCHMARK(UString, appendUTF8) {
+	append(state, false);
+}
+
+BENCHMARK(UString, iterateASCII) {
+	iterate(state, true);
+}
+
+BENCHMARK(UString, iterateUTF8) {
+	iterate(state, false);
+}
+
+BENCHMARK(UString, stricmpASCII) {
+	stricmp(state, true);
+}
+
+BENCHMARK(UString, stricmpUTF8) {
+	stricmp(state, false);
+}
+
+BENCHMARK(UString, toLowerASCII) {
+	toLower(state, true);
+}
+
+BENCHMARK(UString, toLowerUTF8) {
+	toLower(state, false);
+}
+
+BENCHMARK(UString, getPositionASCII) {
+	getPosition(state, true);
+}
+
+BENCHMARK(UString, getPositionUTF8) {
+	getPosition(state, false);
+}
+
+BENCHMARK(UString, mapFindASCII) {
+	mapFind(state, true);
+}
+
+BENCHMARK(UString, mapFindUTF8) {
+	mapFind(state, false);
+}
+
+BENCHMARK(UString, hashMapFindASCII) {
+	hashMapFind(state, true);
+}
+
+BENCHMARK(UString, hashMapFindUTF8) {
+	hashMapFind(state, false);
+}
+
+BENCHMARK(UString, readUTF16LEASCII) {
+	readStringUTF16LE(state, true);
+}
+
+BENCHMARK(UString, readUTF16LEUTF8) {
+	readStringUTF16LE(state, false);
+}
@@ -0,0 +1,173 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for the render queue's sorting.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "external/glm/gtc/matrix_transform.hpp"
+
+#include "src/common/ptrvector.h"
+#include "src/common/scopedptr.h"
+
+#include "src/graphics/shader/shader.h"
+#include "src/graphics/shader/shadermaterial.h"
+#include "src/graphics/shader/shadersurface.h"
+#include "src/graphics/mesh/mesh.h"
+
+#include "src/graphics/render/renderqueue.h"
+
+#include "benchmarks/benchmark.h"
+
+static const size_t kNodeCount = 50000;
+
+/** A synthetic scene, with resources that are never used for any actual rendering. */
+class SyntheticScene {
+public:
+	static const size_t kProgramCount  =  16;
+	static const size_t kMaterialCount = 400;
+	static const size_t kSurfaceCount  = 100;
+	static const size_t kMeshCount     = 600;
+
+	SyntheticScene() {
+		_vertexShader.reset(new Graphics::Shader::ShaderObject);
+		_fragmentShader.reset(new Graphics::Shader::ShaderObject);
+
+		for (size_t i = 0; i < kProgramCount; i++) {
+			_programs.push_back(new Graphics::Shader::ShaderProgram);
+			_programs.back()->glid = i + 1;
+		}
+
+		for (size_t i = 0; i < kMaterialCount; i++)
+			_materials.push_back(new Graphics::Shader::ShaderMaterial(_fragmentShader.get()));
+		for (size_t i = 0; i < kSurfaceCount; i++)
+			_surfaces.push_back(new Graphics::Shader::ShaderSurface(_vertexShader.get()));
+		for (size_t i = 0; i < kMeshCount; i++)
+			_meshes.push_back(new Graphics::Mesh::Mesh);
+	}
+
+	/** Queue this many nodes, in a random order. */
+	void queue(Graphics::Render::RenderQueue &queue, size_t count, uint32 seed) {
+		_transforms.resize(count);
+
+		for (size_t i = 0; i < count; i++) {
+			// Every material and every surface belongs to one program
+			const size_t material = Benchmark::random(seed) % kMaterialCount;
+			const size_t surface  = (material % (kSurfaceCount / kProgramCount)) * kProgramCount + (material % kProgramCount);
+			const size_t program  = material % kProgramCount;
+			const size_t mesh     = Benchmark::random(seed) % kMeshCount;
+
+			const float x = Benchmark::random(seed) % 1000;
+			const float y = Benchmark::random(seed) % 1000;
+			const float z = Benchmark::random(seed) %  100;
+
+			_transforms[i] = glm::translate(glm::mat4(), glm::vec3(x, y, z));
+
+			queue.queueItem(_programs[program], _surfaces[surface], _materials[material], _meshes[mesh], &_transforms[i], 1.0f);
+		}
+	}
+
+private:
+	Common::ScopedPtr<Graphics::Shader::ShaderObject> _vertexShader;
+	Common::ScopedPtr<Graphics::Shader::ShaderObject> _fragmentShader;
+
+	Common::PtrVector<Graphics::Shader::ShaderProgram>  _programs;
+	Common::PtrVector<Graphics::Shader::ShaderMaterial> _materials;
+	Common::PtrVector<Graphics::Shader::ShaderSurface>  _surfaces;
+	Common::PtrVector<Graphics::Mesh::Mesh>             _meshes;
+
+	std::vector<glm::mat4> _transforms;
+};
+
+/** The comparison the render queue used to sort with, as a baseline. */
+static bool compareResources(const Graphics::Render::RenderQueue::RenderQueueNode &a,
+                             const Graphics::Render::RenderQueue::RenderQueueNode &b) {
+
+	if (a.program != b.program)
+		return a.program < b.program;
+	if (a.material != b.material)
+		return a.material < b.material;
+
+	return a.mesh < b.mesh;
+}
+
+/* The sorting benchmarks need an unsorted queue for every operation, so
+ * they include queueing the nodes. RenderQueue.queue measures that part. */
+
+BENCHMARK(RenderQueue, queue) {
+	SyntheticScene scene;
+	Graphics::Render::RenderQueue queue;
+
+	while (state.keepRunning()) {
+		queue.clear();
+		scene.queue(queue, kNodeCount, 1);
+	}
+
+	Benchmark::doNotOptimize(queue.getSize());
+}
+
+BENCHMARK(RenderQueue, sortShader) {
+	SyntheticScene scene;
+	Graphics::Render::RenderQueue queue;
+
+	while (state.keepRunning()) {
+		queue.clear();
+		scene.queue(queue, kNodeCount, 1);
+
+		queue.sortShader();
+	}
+
+	Benchmark::doNotOptimize(queue.countStateChanges().getStateChanges());
+}
+
+BENCHMARK(RenderQueue, sortDepth) {
+	SyntheticScene scene;
+	Graphics::Render::RenderQueue queue;
+	queue.setCameraReference(glm::vec3(500.0f, 500.0f, 0.0f));
+
+	while (state.keepRunning()) {
+		queue.clear();
+		scene.queue(queue, kNodeCount, 1);
+
+		queue.sortDepth();
+	}
+
+	Benchmark::doNotOptimize(queue.getSize());
+}
+
+BENCHMARK(RenderQueue, sortBaseline) {
+	SyntheticScene scene;
+	Graphics::Render::RenderQueue queue;
+
+	std::vector<Graphics::Render::RenderQueue::RenderQueueNode> nodes;
+
+	while (state.keepRunning()) {
+		queue.clear();
+		scene.queue(queue, kNodeCount, 1);
+
+		nodes = queue.getNodes();
+		std::sort(nodes.begin(), nodes.end(), compareResources);
+	}
+
+	Benchmark::doNotOptimize(nodes.size());
+}
@@ -0,0 +1,38 @@
+# xoreos - A reimplementation of BioWare's Aurora engine
+#
+# xoreos is the legal property of its developers, whose names
+# can be found in the AUTHORS file distributed with this source
+# distribution.
+#
+# xoreos is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# xoreos is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+
+# Microbenchmarks for the Graphics namespace.
+
+EXTRA_PROGRAMS += benchmarks/bench_graphics
+BENCHMARKS     += benchmarks/bench_graphics
+CLEANFILES     += benchmarks/bench_graphics.json
+
+benchmarks_bench_graphics_SOURCES = \
+    $(bench_FRAMEWORK) \
+    benchmarks/graphics/renderqueue.cpp \
+    benchmarks/graphics/yuvtorgb.cpp \
+    $(EMPTY)
+
+benchmarks_bench_graphics_LDADD = \
+    src/graphics/libgraphics.la \
+    src/aurora/libaurora.la \
+    src/events/libevents.la \
+    src/common/libcommon.la \
+    src/version/libversion.la \
+    $(LDADD)
@@ -0,0 +1,74 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for the YUV to RGB conversion of video frames.
+ */
+
+#include <vector>
+
+#include "src/common/util.h"
+
+#include "src/graphics/yuv_to_rgb.h"
+
+#include "benchmarks/benchmark.h"
+
+/** Convert a frame of pseudo-random YUV420 data with an alpha plane, using this many threads. */
+static void convert(Benchmark::State &state, int width, int height, int threads) {
+	const int yPitch  = width;
+	const int uvPitch = width / 2;
+
+	std::vector<byte> y, u, v, a;
+	Benchmark::generateRandom(y, yPitch  * height, 1);
+	Benchmark::generateRandom(a, yPitch  * height, 2);
+	Benchmark::generateRandom(u, uvPitch * (height / 2), 3);
+	Benchmark::generateRandom(v, uvPitch * (height / 2), 4);
+
+	const int dstPitch = width * 4;
+	std::vector<byte> dst(dstPitch * height);
+
+	YUVToRGBMan.setThreadCount(threads);
+
+	state.setBytesPerOperation(dst.size());
+
+	while (state.keepRunning())
+		YUVToRGBMan.convert420(Graphics::YUVToRGBManager::kScaleITU, &dst[0], dstPitch,
+		                       &y[0], &u[0], &v[0], &a[0], width, height, yPitch, uvPitch);
+
+	YUVToRGBMan.setThreadCount(1);
+
+	Benchmark::doNotOptimize(dst[0]);
+}
+
+BENCHMARK(YUVToRGB, convert720p) {
+	convert(state, 1280, 720, 1);
+}
+
+BENCHMARK(YUVToRGB, convert720pThreads4) {
+	convert(state, 1280, 720, 4);
+}
+
+BENCHMARK(YUVToRGB, convert1080p) {
+	convert(state, 1920, 1080, 1);
+}
+
+BENCHMARK(YUVToRGB, convert1080pThreads4) {
+	convert(state, 1920, 1080, 4);
+}
@@ -0,0 +1,103 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for decoding DDS images, and decompressing their S3TC data.
+ */
+
+#include <vector>
+
+#include "src/common/util.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/graphics/images/dds.h"
+
+#include "benchmarks/benchmark.h"
+
+static const uint32 kWidth  = 1024;
+static const uint32 kHeight = 1024;
+
+/** Return the size of the compressed image data. */
+static size_t getDataSize(uint32 fourCC) {
+	const size_t blockSize = (fourCC == MKTAG('D', 'X', 'T', '1')) ? 8 : 16;
+
+	return (kWidth / 4) * (kHeight / 4) * blockSize;
+}
+
+/** Build a standard DDS with a single DXT1 or DXT5 mip map of random blocks. */
+static void writeDDS(std::vector<byte> &data, uint32 fourCC) {
+	std::vector<byte> blocks;
+	Benchmark::generateRandom(blocks, getDataSize(fourCC));
+
+	Common::MemoryWriteStreamDynamic stream(true);
+
+	stream.writeUint32BE(MKTAG('D', 'D', 'S', ' '));
+	stream.writeUint32LE(124);
+	stream.writeUint32LE(0x00001007); // Caps, height, width, pixel format
+	stream.writeUint32LE(kHeight);
+	stream.writeUint32LE(kWidth);
+	stream.writeUint32LE(blocks.size());
+	stream.writeUint32LE(0);          // Depth
+	stream.writeUint32LE(1);          // Mip map count
+	stream.writeZeros(44);            // Reserved
+
+	stream.writeUint32LE(32);         // Pixel format size
+	stream.writeUint32LE(0x00000004); // Has FourCC
+	stream.writeUint32BE(fourCC);
+	stream.writeZeros(5 * 4);         // Bit count and masks
+
+	stream.writeUint32LE(0x00001000); // Caps: texture
+	stream.writeZeros(12 + 4);        // Caps 2 + Reserved
+
+	stream.write(&blocks[0], blocks.size());
+
+	data.assign(stream.getData(), stream.getData() + stream.size());
+}
+
+static void load(Benchmark::State &state, uint32 fourCC, bool decompress) {
+	std::vector<byte> data;
+	writeDDS(data, fourCC);
+
+	// Throughput in the size of the image data we end up with
+	state.setBytesPerOperation(decompress ? (kWidth * kHeight * 4) : getDataSize(fourCC));
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Graphics::DDS dds(stream);
+
+		if (decompress)
+			dds.decompress();
+
+		Benchmark::doNotOptimize(dds.getMipMap(0).data[0]);
+	}
+}
+
+BENCHMARK(DDS, loadDXT1) {
+	load(state, MKTAG('D', 'X', 'T', '1'), false);
+}
+
+BENCHMARK(DDS, loadAndDecompressDXT1) {
+	load(state, MKTAG('D', 'X', 'T', '1'), true);
+}
+
+BENCHMARK(DDS, loadAndDecompressDXT5) {
+	load(state, MKTAG('D', 'X', 'T', '5'), true);
+}
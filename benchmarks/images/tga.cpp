@@ -0,0 +1,115 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for decoding TGA images.
+ */
+
+#include <vector>
+
+#include "src/common/util.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/graphics/images/tga.h"
+
+#include "benchmarks/benchmark.h"
+
+static const uint16 kWidth  = 1024;
+static const uint16 kHeight = 1024;
+
+static void writeHeader(Common::WriteStream &stream, byte imageType, byte pixelDepth) {
+	stream.writeByte(0);           // ID length
+	stream.writeByte(0);           // Color map type
+	stream.writeByte(imageType);
+	stream.writeZeros(5 + 2 + 2);  // Color map specification + X + Y
+	stream.writeUint16LE(kWidth);
+	stream.writeUint16LE(kHeight);
+	stream.writeByte(pixelDepth);
+	stream.writeByte((pixelDepth == 32) ? 8 : 0);
+}
+
+/** Build an uncompressed, 32-bit TGA with random pixels. */
+static void writeTrueColor(std::vector<byte> &data) {
+	std::vector<byte> pixels;
+	Benchmark::generateRandom(pixels, kWidth * kHeight * 4);
+
+	Common::MemoryWriteStreamDynamic stream(true);
+
+	writeHeader(stream, 2, 32);
+	stream.write(&pixels[0], pixels.size());
+
+	data.assign(stream.getData(), stream.getData() + stream.size());
+}
+
+/** Build an RLE-compressed, 24-bit TGA, alternating between runs and raw pixels. */
+static void writeRLE(std::vector<byte> &data) {
+	uint32 seed = 0x1234567;
+
+	Common::MemoryWriteStreamDynamic stream(true);
+
+	writeHeader(stream, 10, 24);
+
+	size_t pixels = kWidth * kHeight;
+	while (pixels > 0) {
+		const size_t count = MIN<size_t>(pixels, 1 + Benchmark::random(seed) % 128);
+		const bool   isRun = (Benchmark::random(seed) % 2) == 0;
+
+		stream.writeByte((isRun ? 0x80 : 0x00) | (count - 1));
+
+		for (size_t i = 0; i < (isRun ? 1 : count); i++) {
+			stream.writeByte(Benchmark::random(seed));
+			stream.writeByte(Benchmark::random(seed));
+			stream.writeByte(Benchmark::random(seed));
+		}
+
+		pixels -= count;
+	}
+
+	data.assign(stream.getData(), stream.getData() + stream.size());
+}
+
+BENCHMARK(TGA, loadTrueColor32) {
+	std::vector<byte> data;
+	writeTrueColor(data);
+
+	state.setBytesPerOperation(kWidth * kHeight * 4);
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Graphics::TGA tga(stream);
+
+		Benchmark::doNotOptimize(tga.getMipMap(0).data[0]);
+	}
+}
+
+BENCHMARK(TGA, loadRLE24) {
+	std::vector<byte> data;
+	writeRLE(data);
+
+	state.setBytesPerOperation(kWidth * kHeight * 3);
+
+	while (state.keepRunning()) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Graphics::TGA tga(stream);
+
+		Benchmark::doNotOptimize(tga.getMipMap(0).data[0]);
+	}
+}
@@ -0,0 +1,52 @@
+# xoreos - A reimplementation of BioWare's Aurora engine
+#
+# xoreos is the legal property of its developers, whose names
+# can be found in the AUTHORS file distributed with this source
+# distribution.
+#
+# xoreos is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# xoreos is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+
+# Microbenchmarks, built and run with "make bench".
+#
+# The benchmark programs are EXTRA_PROGRAMS, so they're neither built
+# by "make all" nor by "make check", only on demand. Extra options for
+# the benchmark programs, like "--filter GFF", can be passed in the
+# BENCH_FLAGS variable.
+
+noinst_HEADERS += \
+    benchmarks/benchmark.h \
+    $(EMPTY)
+
+# The benchmark framework, including main(), linked into every benchmark program
+bench_FRAMEWORK = \
+    benchmarks/benchmark.cpp \
+    $(EMPTY)
+
+BENCHMARKS =
+
+include benchmarks/common/rules.mk
+include benchmarks/aurora/rules.mk
+include benchmarks/images/rules.mk
+include benchmarks/graphics/rules.mk
+include benchmarks/sound/rules.mk
+include benchmarks/video/rules.mk
+
+# Run all benchmarks, writing their results as JSON next to the programs
+bench: $(BENCHMARKS)
+	@for bench in $(BENCHMARKS); do \
+		echo "  BENCH    $$bench"; \
+		./$$bench $(BENCH_FLAGS) --json $$bench.json || exit 1; \
+	done
+
+.PHONY: bench
@@ -0,0 +1,108 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for the software mixer.
+ */
+
+#include <vector>
+
+#include "src/common/util.h"
+#include "src/common/ptrvector.h"
+
+#include "src/sound/mixer.h"
+#include "src/sound/audiostream.h"
+
+#include "benchmarks/benchmark.h"
+
+/** An endless audio stream, with all samples set to the same value. */
+class ConstantStream : public Sound::AudioStream {
+public:
+	ConstantStream(int channels, int rate, int16 value) : _channels(channels), _rate(rate), _value(value) {
+	}
+
+	size_t readBuffer(int16 *buffer, const size_t numSamples) {
+		for (size_t i = 0; i < numSamples; i++)
+			buffer[i] = _value;
+
+		return numSamples;
+	}
+
+	int getChannels() const {
+		return _channels;
+	}
+
+	int getRate() const {
+		return _rate;
+	}
+
+	bool endOfData() const {
+		return false;
+	}
+
+private:
+	int _channels;
+	int _rate;
+
+	int16 _value;
+};
+
+/** Mix blocks of 1024 frames out of this many playing sources. */
+static void mix(Benchmark::State &state, size_t sourceCount) {
+	static const size_t kFrames = 1024;
+
+	Sound::Mixer mixer(44100);
+
+	Common::PtrVector<ConstantStream> streams;
+	for (size_t i = 0; i < sourceCount; i++) {
+		// A mix of mono and stereo sources at different rates
+		const int channels = (i % 4) ? 1 : 2;
+		const int rate     = (i % 3) ? 44100 : 22050;
+
+		streams.push_back(new ConstantStream(channels, rate, 100));
+
+		const size_t source = mixer.addSource(streams.back());
+		mixer.setSourceRelative(source, (i % 2) == 0);
+		mixer.setSourcePosition(source, (float) i, 0.0f, 1.0f);
+		mixer.setSourcePitch(source, (i % 5) ? 1.0f : 1.1f);
+		mixer.setSourcePlaying(source, true);
+	}
+
+	std::vector<int16> buffer(kFrames * 2);
+
+	state.setBytesPerOperation(buffer.size() * sizeof(int16));
+
+	while (state.keepRunning())
+		mixer.mix(&buffer[0], kFrames);
+
+	Benchmark::doNotOptimize(buffer[0]);
+}
+
+BENCHMARK(Mixer, sources1) {
+	mix(state, 1);
+}
+
+BENCHMARK(Mixer, sources8) {
+	mix(state, 8);
+}
+
+BENCHMARK(Mixer, sources64) {
+	mix(state, 64);
+}
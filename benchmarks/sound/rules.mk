@@ -0,0 +1,35 @@
+# xoreos - A reimplementation of BioWare's Aurora engine
+#
+# xoreos is the legal property of its developers, whose names
+# can be found in the AUTHORS file distributed with this source
+# distribution.
+#
+# xoreos is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# xoreos is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+
+# Microbenchmarks for the Sound namespace.
+
+EXTRA_PROGRAMS += benchmarks/bench_sound
+BENCHMARKS     += benchmarks/bench_sound
+CLEANFILES     += benchmarks/bench_sound.json
+
+benchmarks_bench_sound_SOURCES = \
+    $(bench_FRAMEWORK) \
+    benchmarks/sound/mixer.cpp \
+    $(EMPTY)
+
+benchmarks_bench_sound_LDADD = \
+    src/sound/libsound.la \
+    src/common/libcommon.la \
+    src/version/libversion.la \
+    $(LDADD)
@@ -0,0 +1,55 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks for decoding Bink videos.
+ *
+ *  These need a real Bink video: set the environment variable
+ *  XOREOS_BENCH_BINK to the path of a Bink file. Without it,
+ *  the benchmarks run no operations.
+ */
+
+#include <cstdlib>
+
+#include "src/common/scopedptr.h"
+#include "src/common/readfile.h"
+
+#include "src/video/bink.h"
+
+#include "benchmarks/benchmark.h"
+
+/** Decode one frame per operation, starting over at the end of the video. */
+BENCHMARK(Bink, decodeFrame) {
+	const char *file = std::getenv("XOREOS_BENCH_BINK");
+	if (!file || !*file)
+		return;
+
+	// No GL context needed, we never show the video
+	Common::ScopedPtr<Video::Bink> bink(new Video::Bink(new Common::ReadFile(file)));
+
+	state.setBytesPerOperation(bink->getWidth() * bink->getHeight() * 4);
+
+	while (state.keepRunning()) {
+		if (!bink->decodeNextFrame()) {
+			bink.reset(new Video::Bink(new Common::ReadFile(file)));
+			bink->decodeNextFrame();
+		}
+	}
+}
@@ -0,0 +1,39 @@
+# xoreos - A reimplementation of BioWare's Aurora engine
+#
+# xoreos is the legal property of its developers, whose names
+# can be found in the AUTHORS file distributed with this source
+# distribution.
+#
+# xoreos is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# xoreos is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+
+# Microbenchmarks for the Video namespace.
+
+EXTRA_PROGRAMS += benchmarks/bench_video
+BENCHMARKS     += benchmarks/bench_video
+CLEANFILES     += benchmarks/bench_video.json
+
+benchmarks_bench_video_SOURCES = \
+    $(bench_FRAMEWORK) \
+    benchmarks/video/binkdecode.cpp \
+    $(EMPTY)
+
+benchmarks_bench_video_LDADD = \
+    src/video/libvideo.la \
+    src/sound/libsound.la \
+    src/graphics/libgraphics.la \
+    src/aurora/libaurora.la \
+    src/events/libevents.la \
+    src/common/libcommon.la \
+    src/version/libversion.la \
+    $(LDADD)
@@ -222,6 +222,13 @@ GDAFile *TwoDARegistry::loadMGDA(Common::UString prefix) {
 		throw;
 	}
 
+	/* Multiple GDAs are the big tables the engines query over and over,
+	 * so cache all their numerical columns for fast lookups. */
+	const GDAFile::Headers &headers = gda->getHeaders();
+	for (GDAFile::Headers::const_iterator h = headers.begin(); h != headers.end(); ++h)
+		if ((h->type == GDAFile::kTypeInt) || (h->type == GDAFile::kTypeBool) || (h->type == GDAFile::kTypeFloat))
+			gda->cacheColumn(h->hash);
+
 	return gda.release();
 }
 
@@ -68,7 +68,11 @@ public:
 	/** Get a certain GDA, loading it if necessary. */
 	const GDAFile &getGDA(const Common::UString &name);
 
-	/** Get a certain multiple GDA, loading it if necessary. */
+	/** Get a certain multiple GDA, loading it if necessary.
+	 *
+	 *  The integer, bool and float columns of a multiple GDA are cached,
+	 *  see GDAFile::cacheColumn().
+	 */
 	const GDAFile &getMGDA(const Common::UString &prefix);
 
 	/** Add a certain 2DA to the registry, reloading it if necessary. */
@@ -41,6 +41,10 @@ uint32 Archive::getResourceSize(uint32 UNUSED(index)) const {
 	return 0xFFFFFFFF;
 }
 
+bool Archive::getResourceLocation(uint32 UNUSED(index), uint32 &UNUSED(offset), uint32 &UNUSED(size)) const {
+	return false;
+}
+
 Common::HashAlgo Archive::getNameHashAlgo() const {
 	return Common::kHashNone;
 }
@@ -73,6 +73,18 @@ public:
 	 */
 	virtual Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const = 0;
 
+	/** Return where a resource's data can be found within the archive file.
+	 *
+	 *  This is only possible for resources stored unaltered, neither
+	 *  compressed nor encrypted, in one contiguous block.
+	 *
+	 *  @param  index The index of the resource we want.
+	 *  @param  offset Will be set to the offset of the resource's data.
+	 *  @param  size Will be set to the size of the resource's data.
+	 *  @return true if the location is known, false otherwise.
+	 */
+	virtual bool getResourceLocation(uint32 index, uint32 &offset, uint32 &size) const;
+
 	/** Return with which algorithm the name is hashed. */
 	virtual Common::HashAlgo getNameHashAlgo() const;
 
@@ -138,6 +138,15 @@ uint32 BIFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+bool BIFFile::getResourceLocation(uint32 index, uint32 &offset, uint32 &size) const {
+	const IResource &res = getIResource(index);
+
+	offset = res.offset;
+	size   = res.size;
+
+	return true;
+}
+
 Common::SeekableReadStream *BIFFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
@@ -83,6 +83,9 @@ public:
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Return where the resource's data can be found within the BIF. */
+	bool getResourceLocation(uint32 index, uint32 &offset, uint32 &size) const;
+
 	/** Merge information from the KEY into the data file.
 	 *
 	 *  Without this step, this data file archive does not contain any
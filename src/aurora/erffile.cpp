@@ -715,6 +715,16 @@ Common::SeekableReadStream *ERFFile::getResource(uint32 index, bool tryNoCopy) c
 	if (tryNoCopy && (_header.encryption == kEncryptionNone) && (_header.compression == kCompressionNone))
 		return new Common::SeekableSubReadStream(_erf.get(), res.offset, res.offset + res.packedSize);
 
+	/* Large compressed resources are inflated piece by piece while they're being
+	 * read, instead of all at once. If we may, we even leave the compressed data
+	 * in the archive file. */
+	const bool inflateStream = (_header.compression != kCompressionNone) &&
+	                           (res.unpackedSize >= Common::kInflateStreamThreshold);
+
+	if (inflateStream && tryNoCopy && (_header.encryption == kEncryptionNone))
+		return decompressStream(new Common::SeekableSubReadStream(_erf.get(), res.offset,
+		                        res.offset + res.packedSize), res.unpackedSize);
+
 	_erf->seek(res.offset);
 
 	// Read
@@ -725,9 +735,24 @@ Common::SeekableReadStream *ERFFile::getResource(uint32 index, bool tryNoCopy) c
 		stream = decrypt(stream, _header.encryption, _password);
 
 	// Decompress
+	if (inflateStream)
+		return decompressStream(stream, res.unpackedSize);
+
 	return decompress(stream, res.unpackedSize);
 }
 
+bool ERFFile::getResourceLocation(uint32 index, uint32 &offset, uint32 &size) const {
+	if ((_header.encryption != kEncryptionNone) || (_header.compression != kCompressionNone))
+		return false;
+
+	const IResource &res = getIResource(index);
+
+	offset = res.offset;
+	size   = res.packedSize;
+
+	return true;
+}
+
 Common::MemoryReadStream *ERFFile::decrypt(Common::SeekableReadStream &cryptStream,
                                            Encryption encryption, const std::vector<byte> &password) {
 	switch (encryption) {
@@ -845,6 +870,39 @@ Common::SeekableReadStream *ERFFile::decompressZlib(const byte *compressedData,
 	return new Common::MemoryReadStream(data, unpackedSize, true);
 }
 
+Common::SeekableReadStream *ERFFile::decompressStream(Common::SeekableReadStream *packedStream,
+                                                      uint32 unpackedSize) const {
+
+	/* The same variants as in decompress(), but the window sizes are passed on
+	 * to zlib directly. Positive for a zlib header, negative for raw inflate. */
+
+	assert(packedStream);
+
+	Common::ScopedPtr<Common::SeekableReadStream> stream(packedStream);
+
+	switch (_header.compression) {
+		case kCompressionBioWareZlib: {
+			// An extra one byte header specifies the window size
+			const size_t packedSize = stream->size();
+			const int windowBits = stream->readByte() >> 4;
+
+			return new Common::InflateReadStream(new Common::SeekableSubReadStream(stream.release(), 1,
+			                                     packedSize, true), unpackedSize, -windowBits);
+		}
+
+		case kCompressionHeaderlessZlib:
+			return new Common::InflateReadStream(stream.release(), unpackedSize, Common::kWindowBitsMaxRaw);
+
+		case kCompressionStandardZlib:
+			return new Common::InflateReadStream(stream.release(), unpackedSize, Common::kWindowBitsMax);
+
+		default:
+			break;
+	}
+
+	throw Common::Exception("Invalid ERF compression %u", (uint) _header.compression);
+}
+
 Common::HashAlgo ERFFile::getNameHashAlgo() const {
 	// Only V3 uses hashing
 	return (_version == kVersion30) ? Common::kHashFNV64 : Common::kHashNone;
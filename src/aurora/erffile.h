@@ -129,6 +129,9 @@ public:
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Return where the resource's data can be found within the ERF. */
+	bool getResourceLocation(uint32 index, uint32 &offset, uint32 &size) const;
+
 	/** Return the year the ERF was built. */
 	uint32 getBuildYear() const;
 	/** Return the day of year the ERF was built. */
@@ -302,6 +305,10 @@ private:
 
 	Common::SeekableReadStream *decompressZlib(const byte *compressedData, uint32 packedSize,
 	                                           uint32 unpackedSize, int windowBits) const;
+
+	/** Return a stream that inflates the packed data piece by piece, as it's read. */
+	Common::SeekableReadStream *decompressStream(Common::SeekableReadStream *packedStream,
+	                                             uint32 unpackedSize) const;
 	// '---
 
 	const IResource &getIResource(uint32 index) const;
@@ -22,8 +22,15 @@
  *  Writing BioWare's ERFs (encapsulated resource file).
  */
 
+#include <cassert>
 #include <ctime>
 
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+#include "src/common/threads.h"
+
 #include "src/aurora/erfwriter.h"
 #include "src/aurora/util.h"
 
@@ -118,7 +125,62 @@ ERFWriter::ERFWriter(uint32 id, uint32 fileCount, Common::SeekableWriteStream &s
 	}
 }
 
+ERFWriter::~ERFWriter() {
+	// Writing can fail, so we don't do it here. The owner has to flush() explicitly
+	if (!_queue.empty())
+		warning("ERFWriter::~ERFWriter(): Discarding %u queued resources that were never flushed",
+		        (uint) _queue.size());
+}
+
 void ERFWriter::add(const Common::UString &resRef, FileType resType, Common::ReadStream &stream) {
+	// Write everything queued before this one first, to keep the order
+	flush();
+
+	write(resRef, resType, stream);
+}
+
+void ERFWriter::queue(const Common::UString &resRef, FileType resType, Common::ReadStream *stream) {
+	assert(stream);
+
+	Common::ScopedPtr<Common::ReadStream> queuedStream(stream);
+
+	if ((_currentFileCount + _queue.size()) >= _fileCount)
+		throw Common::Exception("More files added than expected");
+
+	_queue.push_back(new QueuedResource(resRef, resType, queuedStream.release()));
+}
+
+void ERFWriter::flush() {
+	if (_queue.empty())
+		return;
+
+	/* Reading the streams might involve a lot of work, for example when
+	 * they are decompressing resources from another archive. So we read
+	 * them all in parallel into memory, and then write them in order. */
+
+	Common::PtrVector<QueuedResource> queue;
+	queue.swap(_queue);
+
+	Common::PtrVector<Common::MemoryWriteStreamDynamic> data;
+	for (size_t i = 0; i < queue.size(); i++)
+		data.push_back(new Common::MemoryWriteStreamDynamic(true));
+
+	Common::runParallel(queue.size(), [&](size_t i) {
+		data[i]->writeStream(*queue[i]->stream);
+
+		queue[i]->stream.reset();
+	});
+
+	for (size_t i = 0; i < queue.size(); i++) {
+		Common::MemoryReadStream stream(data[i]->getData(), data[i]->size());
+
+		write(queue[i]->resRef, queue[i]->resType, stream);
+
+		data[i]->dispose();
+	}
+}
+
+void ERFWriter::write(const Common::UString &resRef, FileType resType, Common::ReadStream &stream) {
 	if (_currentFileCount == _fileCount)
 		throw Common::Exception("More files added than expected");
 
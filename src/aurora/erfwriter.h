@@ -25,6 +25,8 @@
 #ifndef AURORA_ERFWRITER_H
 #define AURORA_ERFWRITER_H
 
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
 #include "src/common/writestream.h"
 #include "src/common/readstream.h"
 
@@ -50,12 +52,41 @@ public:
 	 */
 	ERFWriter(uint32 id, uint32 fileCount, Common::SeekableWriteStream &stream,
 	          Version version = kERFVersion10, LocString description = LocString());
-	~ERFWriter() = default;
+	~ERFWriter();
 
 	/** Add a new stream to this archive to be packed. */
 	void add(const Common::UString &resRef, FileType resType, Common::ReadStream &stream);
 
+	/** Queue a new stream to be packed into this archive, taking over its ownership.
+	 *
+	 *  Queued streams are read in parallel by flush(), and then written in the
+	 *  order they were queued. Since they're read concurrently, the streams
+	 *  must not depend on each other, for example by sharing a parent stream.
+	 *
+	 *  Queued streams that are never flushed are discarded on destruction.
+	 */
+	void queue(const Common::UString &resRef, FileType resType, Common::ReadStream *stream);
+
+	/** Read all queued streams and write them into the archive.
+	 *
+	 *  This is done automatically by add(), but not on destruction. After
+	 *  queueing the last stream, flush() has to be called explicitly.
+	 */
+	void flush();
+
 private:
+	/** A stream waiting to be packed. */
+	struct QueuedResource {
+		Common::UString resRef;
+		FileType resType;
+
+		Common::ScopedPtr<Common::ReadStream> stream;
+
+		QueuedResource(const Common::UString &r, FileType t, Common::ReadStream *s) :
+			resRef(r), resType(t), stream(s) {
+		}
+	};
+
 	Common::SeekableWriteStream &_stream;
 
 	const Version _version;
@@ -65,6 +96,10 @@ private:
 	uint32 _offsetToResourceData { 0 };
 	uint32 _keyTableOffset { 0 };
 	uint32 _resourceTableOffset { 0 };
+
+	Common::PtrVector<QueuedResource> _queue;
+
+	void write(const Common::UString &resRef, FileType resType, Common::ReadStream &stream);
 };
 
 } // End of namespace Aurora
@@ -45,7 +45,7 @@ namespace Aurora {
 const size_t GDAFile::kInvalidColumn;
 const size_t GDAFile::kInvalidRow;
 
-GDAFile::GDAFile(Common::SeekableReadStream *gda) : _columns(0), _rowCount(0) {
+GDAFile::GDAFile(Common::SeekableReadStream *gda) : _columns(0) {
 	assert(gda);
 
 	load(gda);
@@ -59,7 +59,7 @@ size_t GDAFile::getColumnCount() const {
 }
 
 size_t GDAFile::getRowCount() const {
-	return _rowCount;
+	return _rowTable.size();
 }
 
 const GDAFile::Headers &GDAFile::getHeaders() const {
@@ -71,48 +71,18 @@ bool GDAFile::hasRow(size_t row) const {
 }
 
 const GFF4Struct *GDAFile::getRow(size_t row) const {
-	assert(_rowStarts.size() == _rows.size());
-
-	/* To find the correct GFF4 for this row, we go through
-	 * the list of row start indices in reverse, until we
-	 * found one that's not bigger than the row we want.
-	 */
-
-	for (ptrdiff_t i = _rowStarts.size() - 1; i >= 0; i--) {
-		if (_rowStarts[i] <= row) {
-			row -= _rowStarts[i];
-
-			if (row >= _rows[i]->size())
-				return 0;
-
-			return (*_rows[i])[row];
-		}
-	}
+	if (row >= _rowTable.size())
+		return 0;
 
-	return 0;
+	return _rowTable[row];
 }
 
 size_t GDAFile::findRow(uint32 id) const {
-	size_t idColumn = findColumn("ID");
-	if (idColumn == kInvalidColumn)
+	RowIDMap::const_iterator r = _rowIDs.find(id);
+	if (r == _rowIDs.end())
 		return kInvalidRow;
 
-	// Go through all rows of all GFF4s, and look for the ID
-
-	size_t gff4 = 0;
-	for (size_t i = 0, j = 0; i < _rowCount; i++, j++) {
-		if (j >= _rows[gff4]->size()) {
-			if (++gff4 >= _rows.size())
-				break;
-
-			j = 0;
-		}
-
-		if ((*_rows[gff4])[j] && ((*_rows[gff4])[j]->getUint(idColumn) == id))
-			return i;
-	}
-
-	return kInvalidRow;
+	return r->second;
 }
 
 size_t GDAFile::findColumn(const Common::UString &name) const {
@@ -181,7 +151,26 @@ Common::UString GDAFile::getString(size_t row, const Common::UString &columnName
 	return gdaRow->getString(gdaColumn, def);
 }
 
+const GDAFile::ColumnCache *GDAFile::getColumnCache(size_t column, Type type1, Type type2) const {
+	if ((column == kInvalidColumn) || (column < kGFF4G2DAColumn1))
+		return 0;
+
+	column -= kGFF4G2DAColumn1;
+	if (column >= _columnCaches.size())
+		return 0;
+
+	const ColumnCache &cache = _columnCaches[column];
+	if ((cache.type != type1) && (cache.type != type2))
+		return 0;
+
+	return &cache;
+}
+
 int32 GDAFile::getInt(size_t row, uint32 columnHash, int32 def) const {
+	const ColumnCache *cache = getColumnCache(findColumn(columnHash), kTypeInt, kTypeBool);
+	if (cache)
+		return ((row < cache->present.size()) && cache->present[row]) ? cache->ints[row] : def;
+
 	size_t gdaColumn;
 	const GFF4Struct *gdaRow = getRowColumn(row, columnHash, gdaColumn);
 	if (!gdaRow)
@@ -191,6 +180,10 @@ int32 GDAFile::getInt(size_t row, uint32 columnHash, int32 def) const {
 }
 
 int32 GDAFile::getInt(size_t row, const Common::UString &columnName, int32 def) const {
+	const ColumnCache *cache = getColumnCache(findColumn(columnName), kTypeInt, kTypeBool);
+	if (cache)
+		return ((row < cache->present.size()) && cache->present[row]) ? cache->ints[row] : def;
+
 	size_t gdaColumn;
 	const GFF4Struct *gdaRow = getRowColumn(row, columnName, gdaColumn);
 	if (!gdaRow)
@@ -200,6 +193,10 @@ int32 GDAFile::getInt(size_t row, const Common::UString &columnName, int32 def)
 }
 
 float GDAFile::getFloat(size_t row, uint32 columnHash, float def) const {
+	const ColumnCache *cache = getColumnCache(findColumn(columnHash), kTypeFloat, kTypeFloat);
+	if (cache)
+		return ((row < cache->present.size()) && cache->present[row]) ? cache->floats[row] : def;
+
 	size_t gdaColumn;
 	const GFF4Struct *gdaRow = getRowColumn(row, columnHash, gdaColumn);
 	if (!gdaRow)
@@ -209,6 +206,10 @@ float GDAFile::getFloat(size_t row, uint32 columnHash, float def) const {
 }
 
 float GDAFile::getFloat(size_t row, const Common::UString &columnName, float def) const {
+	const ColumnCache *cache = getColumnCache(findColumn(columnName), kTypeFloat, kTypeFloat);
+	if (cache)
+		return ((row < cache->present.size()) && cache->present[row]) ? cache->floats[row] : def;
+
 	size_t gdaColumn;
 	const GFF4Struct *gdaRow = getRowColumn(row, columnName, gdaColumn);
 	if (!gdaRow)
@@ -217,6 +218,70 @@ float GDAFile::getFloat(size_t row, const Common::UString &columnName, float def
 	return gdaRow->getDouble(gdaColumn, def);
 }
 
+bool GDAFile::cacheColumn(uint32 columnHash) {
+	size_t column = findColumn(columnHash);
+	if (column == kInvalidColumn)
+		return false;
+
+	ColumnCache &cache = _columnCaches[column - kGFF4G2DAColumn1];
+	if (cache.type != kTypeEmpty)
+		return true;
+
+	const Type type = _headers[column - kGFF4G2DAColumn1].type;
+	if ((type != kTypeInt) && (type != kTypeBool) && (type != kTypeFloat))
+		return false;
+
+	cache.type = type;
+	fillColumnCache(cache, column, 0);
+
+	return true;
+}
+
+bool GDAFile::cacheColumn(const Common::UString &columnName) {
+	return cacheColumn(Common::hashStringCRC32(columnName.toLower(), Common::kEncodingUTF16LE));
+}
+
+void GDAFile::fillColumnCache(ColumnCache &cache, size_t column, size_t start) {
+	const size_t count = _rowTable.size();
+
+	cache.present.resize(count, false);
+	if (cache.type == kTypeFloat)
+		cache.floats.resize(count, 0.0f);
+	else
+		cache.ints.resize(count, 0);
+
+	for (size_t i = start; i < count; i++) {
+		const GFF4Struct *row = _rowTable[i];
+		if (!row || !row->hasField(column))
+			continue;
+
+		// Read the values the same way getInt() and getFloat() would
+		if (cache.type == kTypeFloat)
+			cache.floats[i] = row->getDouble(column);
+		else
+			cache.ints[i] = row->getSint(column);
+
+		cache.present[i] = true;
+	}
+}
+
+void GDAFile::addRows(const GFF4List &rows) {
+	const size_t idColumn = findColumn("ID");
+
+	const size_t start = _rowTable.size();
+	_rowTable.insert(_rowTable.end(), rows.begin(), rows.end());
+
+	// Index the IDs. Should an ID appear multiple times, the first row wins
+	if (idColumn != kInvalidColumn)
+		for (size_t i = start; i < _rowTable.size(); i++)
+			if (_rowTable[i])
+				_rowIDs.insert(std::make_pair(_rowTable[i]->getUint(idColumn), i));
+
+	for (size_t i = 0; i < _columnCaches.size(); i++)
+		if (_columnCaches[i].type != kTypeEmpty)
+			fillColumnCache(_columnCaches[i], kGFF4G2DAColumn1 + i, start);
+}
+
 GDAFile::Type GDAFile::identifyType(const Columns &columns, const Row &rows, size_t column) const {
 	if (!columns || (column >= columns->size()) || !(*columns)[column])
 		return kTypeEmpty;
@@ -284,10 +349,8 @@ void GDAFile::load(Common::SeekableReadStream *gda) {
 		_columns = &top.getList(kGFF4G2DAColumnList);
 		_rows.push_back(&top.getList(kGFF4G2DARowList));
 
-		_rowStarts.push_back(_rowCount);
-		_rowCount += _rows.back()->size();
-
 		_headers.resize(_columns->size());
+		_columnCaches.resize(_columns->size());
 		for (size_t i = 0; i < _columns->size(); i++) {
 			if (!(*_columns)[i])
 				continue;
@@ -297,6 +360,8 @@ void GDAFile::load(Common::SeekableReadStream *gda) {
 			_headers[i].field = (uint32) kGFF4G2DAColumn1 + i;
 		}
 
+		addRows(*_rows.back());
+
 	} catch (Common::Exception &e) {
 		e.add("Failed reading GDA file");
 		throw;
@@ -315,9 +380,6 @@ void GDAFile::add(Common::SeekableReadStream *gda) {
 
 		_rows.push_back(&top.getList(kGFF4G2DARowList));
 
-		_rowStarts.push_back(_rowCount);
-		_rowCount += _rows.back()->size();
-
 		Columns columns = &top.getList(kGFF4G2DAColumnList);
 		if (columns->size() != _columns->size())
 			throw Common::Exception("Column counts don't match (%u vs. %u)",
@@ -335,6 +397,8 @@ void GDAFile::add(Common::SeekableReadStream *gda) {
 				                        hash1, (int)type1, hash2, (int)type2);
 		}
 
+		addRows(*_rows.back());
+
 	} catch (Common::Exception &e) {
 		e.add("Failed adding GDA file");
 		throw;
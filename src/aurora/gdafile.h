@@ -29,6 +29,7 @@
 #include <map>
 
 #include <boost/noncopyable.hpp>
+#include <boost/unordered/unordered_map.hpp>
 
 #include "src/common/ustring.h"
 #include "src/common/ptrvector.h"
@@ -58,6 +59,11 @@ namespace Aurora {
  *  by the Dragon Age games. Within these MGDAs, rows are not anymore
  *  identified by raw row index (since this index is now meaningless),
  *  but by an "ID" column.
+ *
+ *  All rows are kept in one flat table, and the values of the "ID" column
+ *  are indexed on load, so that both getRow() and findRow() take constant
+ *  time. Additionally, the values of integer and float columns can be
+ *  cached in contiguous arrays with cacheColumn().
  */
 class GDAFile : boost::noncopyable {
 public:
@@ -131,13 +137,39 @@ public:
 	float getFloat(size_t row, uint32 columnHash, float def = 0.0f) const;
 	float getFloat(size_t row, const Common::UString &columnName, float def = 0.0f) const;
 
+	/** Cache the values of an integer or float column.
+	 *
+	 *  getInt() and getFloat() on a cached column read the values directly
+	 *  out of an array, instead of finding them in the row's GFF4 struct.
+	 *  Only columns of type kTypeInt, kTypeBool and kTypeFloat can be cached.
+	 *
+	 *  @return true if the column is now cached.
+	 */
+	bool cacheColumn(uint32 columnHash);
+	bool cacheColumn(const Common::UString &columnName);
+
 
 private:
 	typedef Common::PtrVector<GFF4File> GFF4s;
 	typedef const GFF4List * Columns;
 	typedef const GFF4List * Row;
 	typedef std::vector<Row> Rows;
-	typedef std::vector<size_t> RowStarts;
+	typedef std::vector<const GFF4Struct *> RowTable;
+
+	/** Map of values in the "ID" column to row indices. */
+	typedef boost::unordered_map<uint64, size_t> RowIDMap;
+
+	/** The cached values of one column. */
+	struct ColumnCache {
+		Type type; ///< The type of the column, or kTypeEmpty if it's not cached.
+
+		std::vector<int32> ints;    ///< The values, if the column is an integer column.
+		std::vector<float> floats;  ///< The values, if the column is a float column.
+		std::vector<bool>  present; ///< Does the row have a value in this column?
+
+		ColumnCache() : type(kTypeEmpty) { }
+	};
+	typedef std::vector<ColumnCache> ColumnCaches;
 
 	typedef std::map<uint32, size_t> ColumnHashMap;
 	typedef std::map<Common::UString, size_t> ColumnNameMap;
@@ -150,9 +182,12 @@ private:
 	Columns _columns;
 	Rows    _rows;
 
-	size_t _rowCount;
+	/** All rows of all GFF4s, in order. */
+	RowTable _rowTable;
+	/** Index of the "ID" column values. */
+	RowIDMap _rowIDs;
 
-	RowStarts _rowStarts;
+	ColumnCaches _columnCaches;
 
 	mutable ColumnHashMap _columnHashMap;
 	mutable ColumnNameMap _columnNameMap;
@@ -160,6 +195,14 @@ private:
 
 	void load(Common::SeekableReadStream *gda);
 
+	/** Append these rows to the row table and index them. */
+	void addRows(const GFF4List &rows);
+	/** Fill in the cached values of a column, starting from this row. */
+	void fillColumnCache(ColumnCache &cache, size_t column, size_t start);
+
+	/** Return the cache of this column, if it's cached with one of these types. */
+	const ColumnCache *getColumnCache(size_t column, Type type1, Type type2) const;
+
 	Type identifyType(const Columns &columns, const Row &rows, size_t column) const;
 
 	const GFF4Struct *getRowColumn(size_t row, uint32 hash, size_t &column) const;
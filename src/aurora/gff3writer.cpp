@@ -22,7 +22,7 @@
  *  Writer for writing version V3.2/V3.3 of BioWare's GFFs (generic file format).
  */
 
-#include <algorithm>
+#include <deque>
 
 #include <boost/make_shared.hpp>
 
@@ -33,20 +33,73 @@
 
 namespace Aurora {
 
-GFF3Writer::GFF3Writer(uint32 id, uint32 version) : _id(id), _version(version) {
-	_structs.push_back(boost::make_shared<GFF3WriterStruct>(this));
+struct GFF3Writer::Pool {
+	std::deque<GFF3WriterStruct> structs;
+	std::deque<GFF3WriterList> lists;
+};
+
+GFF3Writer::GFF3Writer(uint32 id, uint32 version) : _id(id), _version(version), _pool(boost::make_shared<Pool>()) {
+	_pool->structs.emplace_back(this);
+	_structs.push_back(&_pool->structs.back());
 }
 
 GFF3WriterStructPtr GFF3Writer::getTopLevel() {
-	return _structs[0];
+	return GFF3WriterStructPtr(_pool, _structs[0]);
 }
 
 void GFF3Writer::write(Common::WriteStream &stream) {
-	// Extract all individual values of the fields.
-	std::list<Value> individualValues;
-	for (const auto &field : _fields) {
-		if (std::find(individualValues.begin(), individualValues.end(), field->value) == individualValues.end())
-			individualValues.push_back(field->value);
+	/* Go through all fields once, to figure out what to write into them. Simple
+	 * values are written directly into the field. Complex values are written
+	 * into the field data section, with equal values sharing the same data. */
+
+	std::vector<uint32> fieldValues(_fields.size());
+
+	std::vector<const Value *> fieldDataValues;
+	std::map<const Value *, uint32, ValuePtrLess> fieldDataIndices;
+
+	uint32 fieldDataCount = 0;
+	uint32 listIndicesCount = 0;
+
+	for (size_t i = 0; i < _fields.size(); ++i) {
+		const Value &value = _fields[i].value;
+
+		switch (value.type) {
+			case GFF3Struct::kFieldTypeByte:
+			case GFF3Struct::kFieldTypeUint16:
+			case GFF3Struct::kFieldTypeUint32:
+			case GFF3Struct::kFieldTypeStruct:
+				fieldValues[i] = boost::get<uint32>(value.data);
+				break;
+
+			case GFF3Struct::kFieldTypeList:
+				// Index into the list indices, where the size comes first
+				fieldValues[i] = listIndicesCount;
+				listIndicesCount += (1 + _lists[boost::get<uint32>(value.data)]->getSize()) * 4;
+				break;
+
+			case GFF3Struct::kFieldTypeChar:
+			case GFF3Struct::kFieldTypeSint16:
+			case GFF3Struct::kFieldTypeSint32:
+				fieldValues[i] = static_cast<uint32>(boost::get<int32>(value.data));
+				break;
+
+			case GFF3Struct::kFieldTypeFloat:
+				fieldValues[i] = convertIEEEFloat(boost::get<float>(value.data));
+				break;
+
+			default: {
+				std::pair<std::map<const Value *, uint32, ValuePtrLess>::iterator, bool> result =
+					fieldDataIndices.insert(std::make_pair(&value, fieldDataCount));
+
+				if (result.second) {
+					fieldDataValues.push_back(&value);
+					fieldDataCount += getFieldDataSize(value);
+				}
+
+				fieldValues[i] = result.first->second;
+				break;
+			}
+		}
 	}
 
 	stream.writeUint32BE(_id);
@@ -62,32 +115,20 @@ void GFF3Writer::write(Common::WriteStream &stream) {
 	uint32 labelCount = static_cast<uint32>(_labels.size());
 
 	uint32 fieldDataOffset = labelOffset + labelCount * 16;
-	uint32 fieldDataCount = 0;
-
-	// Count the total size of field data
-	for (const auto &value : individualValues) {
-		fieldDataCount += getFieldDataSize(value);
-	}
 
 	uint32 fieldIndicesOffset = fieldDataOffset + fieldDataCount;
 	uint32 fieldIndicesCount = 0;
 
 	// Count all fields of structs with more than one field
 	for (size_t i = 0; i < _structs.size(); ++i) {
-		const GFF3WriterStructPtr strct = _structs[i];
-		if (strct->getFieldCount() <= 1)
+		const GFF3WriterStruct &strct = *_structs[i];
+		if (strct.getFieldCount() <= 1)
 			continue;
 
-		fieldIndicesCount += strct->getFieldCount() * 4;
+		fieldIndicesCount += strct.getFieldCount() * 4;
 	}
 
 	uint32 listIndicesOffset = fieldIndicesOffset + fieldIndicesCount;
-	uint32 listIndicesCount = 0;
-
-	// Count all lists elements plus their size as int
-	for (size_t i = 0; i < _lists.size(); ++i) {
-		listIndicesCount += (_lists[i]->getSize() + 1) * 4;
-	}
 
 	// Write the header
 	stream.writeUint32LE(structOffset);
@@ -106,89 +147,31 @@ void GFF3Writer::write(Common::WriteStream &stream) {
 	// Write structs data
 	size_t structFieldIndicesIndex = 0;
 	for (size_t i = 0; i < _structs.size(); ++i) {
-		GFF3WriterStructPtr strct = _structs[i];
+		const GFF3WriterStruct &strct = *_structs[i];
 
 		// Struct ID
-		stream.writeUint32LE(strct->getID());
+		stream.writeUint32LE(strct.getID());
 
 		// Field index
-		if (strct->getFieldCount() > 1) {
+		if (strct.getFieldCount() > 1) {
 			stream.writeUint32LE(structFieldIndicesIndex * 4);
-			structFieldIndicesIndex += strct->getFieldCount();
+			structFieldIndicesIndex += strct.getFieldCount();
 		} else {
-			if (strct->getFieldCount() != 0)
-				stream.writeUint32LE(strct->_fieldIndices[0]);
+			if (strct.getFieldCount() != 0)
+				stream.writeUint32LE(strct._fieldIndices[0]);
 			else
 				stream.writeUint32LE(0);
 		}
 
 		// Field count
-		stream.writeUint32LE(strct->getFieldCount());
+		stream.writeUint32LE(strct.getFieldCount());
 	}
 
 	// Write fields
-	size_t fieldDataIndex = 0;
-	size_t listDataIndex = 0;
-
-	// Maps for checking for already existing values
-	std::map<Value, size_t> valueIndices;
-
 	for (size_t i = 0; i < _fields.size(); ++i) {
-		FieldPtr field = _fields[i];
-		stream.writeUint32LE(field->value.type);
-		stream.writeUint32LE(field->labelIndex);
-
-		/* Determine if this field has simple values (less equal 32 bit) which are written in the field
-		 * or complex values, bigger than 32bit like strings written in the field data section. */
-		const bool simple =
-			field->value.type == GFF3Struct::kFieldTypeByte ||
-			field->value.type == GFF3Struct::kFieldTypeChar ||
-			field->value.type == GFF3Struct::kFieldTypeUint16 ||
-			field->value.type == GFF3Struct::kFieldTypeUint32 ||
-			field->value.type == GFF3Struct::kFieldTypeStruct ||
-			field->value.type == GFF3Struct::kFieldTypeSint16 ||
-			field->value.type == GFF3Struct::kFieldTypeSint32 ||
-			field->value.type == GFF3Struct::kFieldTypeFloat ||
-			field->value.type == GFF3Struct::kFieldTypeList;
-
-		if (simple) {
-			// If the values are simple (less equal 4 bytes) write them to the field
-			switch (field->value.type) {
-				case GFF3Struct::kFieldTypeByte:
-				case GFF3Struct::kFieldTypeUint16:
-				case GFF3Struct::kFieldTypeUint32:
-				case GFF3Struct::kFieldTypeStruct:
-					stream.writeUint32LE(boost::get<uint32>(field->value.data));
-					break;
-				case GFF3Struct::kFieldTypeList:
-					stream.writeUint32LE(listDataIndex * 4);
-					listDataIndex += 1 + _lists[boost::get<uint32>(field->value.data)]->getSize();
-					break;
-				case GFF3Struct::kFieldTypeChar:
-				case GFF3Struct::kFieldTypeSint16:
-				case GFF3Struct::kFieldTypeSint32:
-					stream.writeSint32LE(boost::get<int32>(field->value.data));
-					break;
-				case GFF3Struct::kFieldTypeFloat:
-					stream.writeIEEEFloatLE(boost::get<float>(field->value.data));
-					break;
-				default:
-					throw Common::Exception("Invalid Field type");
-			}
-		} else {
-			// If the values are complex (greater then 4 bytes) write the index to the field data
-
-			size_t index = 0;
-			if (valueIndices.find(field->value) == valueIndices.end()) {
-				index = fieldDataIndex;
-				fieldDataIndex += getFieldDataSize(field->value);
-				valueIndices[field->value] = index;
-			} else {
-				index = valueIndices[field->value];
-			}
-
-			stream.writeUint32LE(index);
-		}
+		stream.writeUint32LE(_fields[i].value.type);
+		stream.writeUint32LE(_fields[i].labelIndex);
+		stream.writeUint32LE(fieldValues[i]);
 	}
 
 	// Write labels
@@ -199,87 +182,90 @@ void GFF3Writer::write(Common::WriteStream &stream) {
 	}
 
 	// Write field data
-	for (const auto &value : individualValues) {
-		switch (value.type) {
-			case GFF3Struct::kFieldTypeUint64:
-				stream.writeUint64LE(boost::get<uint64>(value.data));
-				break;
-			case GFF3Struct::kFieldTypeSint64:
-				stream.writeSint64LE(boost::get<int64>(value.data));
-				break;
-			case GFF3Struct::kFieldTypeDouble:
-				stream.writeIEEEDoubleLE(boost::get<double>(value.data));
-				break;
-			case GFF3Struct::kFieldTypeStrRef:
-				stream.writeUint32LE(4);
-				stream.writeUint32LE(boost::get<uint32>(value.data));
-				break;
-			case GFF3Struct::kFieldTypeResRef:
-				stream.writeByte(MIN<byte>(16, boost::get<Common::UString>(value.data).size()));
-				stream.write(boost::get<Common::UString>(value.data).c_str(), MIN<size_t>(boost::get<Common::UString>(value.data).size(), 16));
-				break;
-			case GFF3Struct::kFieldTypeExoString:
-				stream.writeUint32LE(static_cast<uint32>(boost::get<Common::UString>(value.data).size()));
-				stream.writeString(boost::get<Common::UString>(value.data));
-				break;
-			case GFF3Struct::kFieldTypeLocString:
-				stream.writeUint32LE(boost::get<LocString>(value.data).getWrittenSize() + 8);
-				stream.writeUint32LE(boost::get<LocString>(value.data).getID());
-				stream.writeUint32LE(boost::get<LocString>(value.data).getNumStrings());
-				boost::get<LocString>(value.data).writeLocString(stream);
-				break;
-			case GFF3Struct::kFieldTypeVoid:
-				stream.writeUint32LE(static_cast<uint32>(boost::get<VoidData>(value.data).size));
-				stream.write(boost::get<VoidData>(value.data).data.get(), boost::get<VoidData>(value.data).size);
-				break;
-			case GFF3Struct::kFieldTypeVector:
-				stream.writeIEEEFloatLE(boost::get<Vector4>(value.data).vec.x);
-				stream.writeIEEEFloatLE(boost::get<Vector4>(value.data).vec.y);
-				stream.writeIEEEFloatLE(boost::get<Vector4>(value.data).vec.z);
-				break;
-			case GFF3Struct::kFieldTypeOrientation:
-				stream.writeIEEEFloatLE(boost::get<Vector4>(value.data).vec.x);
-				stream.writeIEEEFloatLE(boost::get<Vector4>(value.data).vec.y);
-				stream.writeIEEEFloatLE(boost::get<Vector4>(value.data).vec.z);
-				stream.writeIEEEFloatLE(boost::get<Vector4>(value.data).vec.w);
-				break;
-			default:
-				break;
-		}
-	}
+	for (std::vector<const Value *>::const_iterator v = fieldDataValues.begin(); v != fieldDataValues.end(); ++v)
+		writeFieldData(stream, **v);
 
 	// Write field indices of every struct with more than one field
 	for (size_t i = 0; i < _structs.size(); ++i) {
-		GFF3WriterStructPtr strct = _structs[i];
-		if (strct->getFieldCount() <= 1)
+		const GFF3WriterStruct &strct = *_structs[i];
+		if (strct.getFieldCount() <= 1)
 			continue;
 
-		for (size_t j = 0; j < strct->getFieldCount(); ++j) {
-			stream.writeUint32LE(strct->_fieldIndices[j]);
+		for (size_t j = 0; j < strct.getFieldCount(); ++j) {
+			stream.writeUint32LE(strct._fieldIndices[j]);
 		}
 	}
 
 	// Write list indices
 	for (size_t i = 0; i < _lists.size(); ++i) {
-		GFF3WriterListPtr list = _lists[i];
-		stream.writeUint32LE(list->getSize());
-		for (size_t j = 0; j < list->_strcts.size(); ++j) {
-			stream.writeUint32LE(list->_strcts[j]);
+		const GFF3WriterList &list = *_lists[i];
+		stream.writeUint32LE(list.getSize());
+		for (size_t j = 0; j < list._strcts.size(); ++j) {
+			stream.writeUint32LE(list._strcts[j]);
 		}
 	}
 }
 
+void GFF3Writer::writeFieldData(Common::WriteStream &stream, const Value &value) {
+	switch (value.type) {
+		case GFF3Struct::kFieldTypeUint64:
+			stream.writeUint64LE(boost::get<uint64>(value.data));
+			break;
+		case GFF3Struct::kFieldTypeSint64:
+			stream.writeSint64LE(boost::get<int64>(value.data));
+			break;
+		case GFF3Struct::kFieldTypeDouble:
+			stream.writeIEEEDoubleLE(boost::get<double>(value.data));
+			break;
+		case GFF3Struct::kFieldTypeStrRef:
+			stream.writeUint32LE(4);
+			stream.writeUint32LE(boost::get<uint32>(value.data));
+			break;
+		case GFF3Struct::kFieldTypeResRef:
+			stream.writeByte(MIN<byte>(16, boost::get<Common::UString>(value.data).size()));
+			stream.write(boost::get<Common::UString>(value.data).c_str(), MIN<size_t>(boost::get<Common::UString>(value.data).size(), 16));
+			break;
+		case GFF3Struct::kFieldTypeExoString:
+			stream.writeUint32LE(static_cast<uint32>(boost::get<Common::UString>(value.data).size()));
+			stream.writeString(boost::get<Common::UString>(value.data));
+			break;
+		case GFF3Struct::kFieldTypeLocString:
+			stream.writeUint32LE(boost::get<LocString>(value.data).getWrittenSize() + 8);
+			stream.writeUint32LE(boost::get<LocString>(value.data).getID());
+			stream.writeUint32LE(boost::get<LocString>(value.data).getNumStrings());
+			boost::get<LocString>(value.data).writeLocString(stream);
+			break;
+		case GFF3Struct::kFieldTypeVoid:
+			stream.writeUint32LE(static_cast<uint32>(boost::get<VoidData>(value.data).size));
+			stream.write(boost::get<VoidData>(value.data).data.get(), boost::get<VoidData>(value.data).size);
+			break;
+		case GFF3Struct::kFieldTypeVector:
+			stream.writeIEEEFloatLE(boost::get<Vector4>(value.data).vec.x);
+			stream.writeIEEEFloatLE(boost::get<Vector4>(value.data).vec.y);
+			stream.writeIEEEFloatLE(boost::get<Vector4>(value.data).vec.z);
+			break;
+		case GFF3Struct::kFieldTypeOrientation:
+			stream.writeIEEEFloatLE(boost::get<Vector4>(value.data).vec.x);
+			stream.writeIEEEFloatLE(boost::get<Vector4>(value.data).vec.y);
+			stream.writeIEEEFloatLE(boost::get<Vector4>(value.data).vec.z);
+			stream.writeIEEEFloatLE(boost::get<Vector4>(value.data).vec.w);
+			break;
+		default:
+			break;
+	}
+}
+
 uint32 GFF3Writer::addLabel(const Common::UString &label) {
-	std::vector<Common::UString>::iterator iter = std::find(_labels.begin(), _labels.end(), label);
-	if (iter != _labels.end()) {
-		return static_cast<uint32>(std::distance(_labels.begin(), iter));
-	} else {
+	std::pair<std::map<Common::UString, uint32>::iterator, bool> result =
+		_labelIndices.insert(std::make_pair(label, static_cast<uint32>(_labels.size())));
+
+	if (result.second)
 		_labels.push_back(label);
-		return static_cast<uint32>(_labels.size() - 1);
-	}
+
+	return result.first->second;
 }
 
-uint32 GFF3Writer::getFieldDataSize(Value value) {
+uint32 GFF3Writer::getFieldDataSize(const Value &value) {
 	switch (value.type) {
 		case GFF3Struct::kFieldTypeUint64:
 		case GFF3Struct::kFieldTypeSint64:
@@ -303,40 +289,46 @@ uint32 GFF3Writer::getFieldDataSize(Value value) {
 	}
 }
 
-size_t GFF3Writer::createField(GFF3Struct::FieldType type, const Common::UString &label) {
-	// Create a field index
-	size_t index = _fields.size();
+GFF3Writer::Field &GFF3Writer::createField(GFF3Struct::FieldType type, const Common::UString &label) {
+	_fields.push_back(Field());
 
-	// Create field
-	GFF3Writer::FieldPtr field = boost::make_shared<Field>();
-	field->value.type = type;
-	field->labelIndex = addLabel(label);
-	_fields.push_back(field);
+	Field &field = _fields.back();
+	field.value.type = type;
+	field.labelIndex = addLabel(label);
 
-	return index;
+	return field;
 }
 
-GFF3WriterStructPtr GFF3WriterList::addStruct(const Common::UString &label) {
-	// Create the structure pointer
-	GFF3WriterStructPtr strct(
-			boost::make_shared<GFF3WriterStruct>(_parent, static_cast<uint32>(_parent->_structs.size()) - 1));
-
-	// Create a field index
-	_strcts.push_back(_parent->_structs.size());
-	GFF3Writer::FieldPtr field = boost::make_shared<GFF3Writer::Field>();
-	field->value.type = GFF3Struct::kFieldTypeStruct;
-	field->value.data = static_cast<uint32>(_parent->_structs.size());
+GFF3WriterStructPtr GFF3Writer::createStruct(const Common::UString &label) {
+	// Create the struct in the pool
+	_pool->structs.emplace_back(this, static_cast<uint32>(_structs.size()) - 1);
 
-	// Add the label
-	field->labelIndex = _parent->addLabel(label);
+	// Create a field referencing the struct
+	createField(GFF3Struct::kFieldTypeStruct, label).value.data = static_cast<uint32>(_structs.size());
 
 	// Insert the newly created struct into the struct vector
-	_parent->_structs.push_back(strct);
+	_structs.push_back(&_pool->structs.back());
 
-	// Insert the struct to the field vector
-	_parent->_fields.push_back(field);
+	return GFF3WriterStructPtr(_pool, _structs.back());
+}
+
+GFF3WriterListPtr GFF3Writer::createList(const Common::UString &label) {
+	// Create the list in the pool
+	_pool->lists.emplace_back(this);
+
+	// Create a field referencing the list
+	createField(GFF3Struct::kFieldTypeList, label).value.data = static_cast<uint32>(_lists.size());
+
+	// Insert the newly created list into the lists vector
+	_lists.push_back(&_pool->lists.back());
+
+	return GFF3WriterListPtr(_pool, _lists.back());
+}
+
+GFF3WriterStructPtr GFF3WriterList::addStruct(const Common::UString &label) {
+	_strcts.push_back(_parent->_structs.size());
 
-	return strct;
+	return _parent->createStruct(label);
 }
 
 size_t GFF3WriterList::getSize() const {
@@ -355,129 +347,97 @@ size_t GFF3WriterStruct::getFieldCount() const {
 }
 
 GFF3WriterStructPtr GFF3WriterStruct::addStruct(const Common::UString &label) {
-	// Create the structure pointer
-	GFF3WriterStructPtr strct(
-			boost::make_shared<GFF3WriterStruct>(_parent, static_cast<uint32>(_parent->_structs.size()) - 1));
-
-	// Create a field index
 	_fieldIndices.push_back(_parent->_fields.size());
-	GFF3Writer::FieldPtr field = boost::make_shared<GFF3Writer::Field>();
-	field->value.type = GFF3Struct::kFieldTypeStruct;
-	field->value.data = static_cast<uint32>(_parent->_structs.size());
-
-	// Add the label
-	field->labelIndex = _parent->addLabel(label);
 
-	// Insert the newly created struct into the struct vector
-	_parent->_structs.push_back(strct);
-
-	// Insert the struct to the field vector
-	_parent->_fields.push_back(field);
-
-	return strct;
+	return _parent->createStruct(label);
 }
 
 GFF3WriterListPtr GFF3WriterStruct::addList(const Common::UString &label) {
-	// Create the list pointer
-	GFF3WriterListPtr strct(boost::make_shared<GFF3WriterList>(_parent));
-
-	// Create a field index
 	_fieldIndices.push_back(_parent->_fields.size());
-	GFF3Writer::FieldPtr field = boost::make_shared<GFF3Writer::Field>();
-	field->value.type = GFF3Struct::kFieldTypeList;
-	field->value.data = static_cast<uint32>(_parent->_lists.size());
-
-	// Add the label
-	field->labelIndex = _parent->addLabel(label);
-
-	// Insert the newly created list into the lists vector
-	_parent->_lists.push_back(strct);
-
-	// Insert the list to the field vector
-	_parent->_fields.push_back(field);
 
-	return strct;
+	return _parent->createList(label);
 }
 
 void GFF3WriterStruct::addByte(const Common::UString &label, byte value) {
-	createField(GFF3Struct::kFieldTypeByte, label)->value.data = static_cast<uint32>(value);
+	createField(GFF3Struct::kFieldTypeByte, label).value.data = static_cast<uint32>(value);
 }
 
 void GFF3WriterStruct::addChar(const Common::UString &label, char value) {
-	createField(GFF3Struct::kFieldTypeChar, label)->value.data = value;
+	createField(GFF3Struct::kFieldTypeChar, label).value.data = value;
 }
 
 void GFF3WriterStruct::addFloat(const Common::UString &label, float value) {
-	createField(GFF3Struct::kFieldTypeFloat, label)->value.data = value;
+	createField(GFF3Struct::kFieldTypeFloat, label).value.data = value;
 }
 
 void GFF3WriterStruct::addDouble(const Common::UString &label, double value) {
-	createField(GFF3Struct::kFieldTypeDouble, label)->value.data = value;
+	createField(GFF3Struct::kFieldTypeDouble, label).value.data = value;
 }
 
 void GFF3WriterStruct::addUint16(const Common::UString &label, uint16 value) {
-	createField(GFF3Struct::kFieldTypeUint16, label)->value.data = static_cast<uint32>(value);
+	createField(GFF3Struct::kFieldTypeUint16, label).value.data = static_cast<uint32>(value);
 }
 
 void GFF3WriterStruct::addUint32(const Common::UString &label, uint32 value) {
-	createField(GFF3Struct::kFieldTypeUint32, label)->value.data = value;
+	createField(GFF3Struct::kFieldTypeUint32, label).value.data = value;
 }
 
 void GFF3WriterStruct::addUint64(const Common::UString &label, uint64 value) {
-	createField(GFF3Struct::kFieldTypeUint64, label)->value.data = value;
+	createField(GFF3Struct::kFieldTypeUint64, label).value.data = value;
 }
 
 void GFF3WriterStruct::addSint16(const Common::UString &label, int16 value) {
-	createField(GFF3Struct::kFieldTypeSint16, label)->value.data = static_cast<int32>(value);
+	createField(GFF3Struct::kFieldTypeSint16, label).value.data = static_cast<int32>(value);
 }
 
 void GFF3WriterStruct::addSint32(const Common::UString &label, int32 value) {
-	createField(GFF3Struct::kFieldTypeSint32, label)->value.data = value;
+	createField(GFF3Struct::kFieldTypeSint32, label).value.data = value;
 }
 
 void GFF3WriterStruct::addSint64(const Common::UString &label, int64 value) {
-	createField(GFF3Struct::kFieldTypeSint64, label)->value.data = value;
+	createField(GFF3Struct::kFieldTypeSint64, label).value.data = value;
 }
 
 void GFF3WriterStruct::addExoString(const Common::UString &label, const Common::UString &value) {
-	createField(GFF3Struct::kFieldTypeExoString, label)->value.data = value;
+	createField(GFF3Struct::kFieldTypeExoString, label).value.data = value;
 }
 
 void GFF3WriterStruct::addStrRef(const Common::UString &label, uint32 value) {
-	createField(GFF3Struct::kFieldTypeStrRef, label)->value.data = value;
+	createField(GFF3Struct::kFieldTypeStrRef, label).value.data = value;
 }
 
 void GFF3WriterStruct::addResRef(const Common::UString &label, const Common::UString &value) {
-	createField(GFF3Struct::kFieldTypeResRef, label)->value.data = value;
+	createField(GFF3Struct::kFieldTypeResRef, label).value.data = value;
 }
 
 void GFF3WriterStruct::addVoid(const Common::UString &label, const byte *data, uint32 size) {
-	GFF3Writer::FieldPtr field = createField(GFF3Struct::kFieldTypeVoid, label);
+	GFF3Writer::Field &field = createField(GFF3Struct::kFieldTypeVoid, label);
+
+	// Construct the data in place, to avoid copying it around
+	field.value.data = GFF3Writer::VoidData();
 
-	GFF3Writer::VoidData voiddata;
+	GFF3Writer::VoidData &voiddata = boost::get<GFF3Writer::VoidData>(field.value.data);
 	voiddata.data.reset(new byte[size]);
 	voiddata.size = size;
 	memcpy(voiddata.data.get(), data, size);
-
-	field->value.data = voiddata;
 }
 
 void GFF3WriterStruct::addVector(const Common::UString &label, glm::vec3 value) {
-	createField(GFF3Struct::kFieldTypeVector, label)->value.data = glm::vec4(value, 0.0f);
+	createField(GFF3Struct::kFieldTypeVector, label).value.data = glm::vec4(value, 0.0f);
 }
 
 void GFF3WriterStruct::addOrientation(const Common::UString &label, glm::vec4 value) {
-	createField(GFF3Struct::kFieldTypeOrientation, label)->value.data = value;
+	createField(GFF3Struct::kFieldTypeOrientation, label).value.data = value;
 }
 
 void GFF3WriterStruct::addLocString(const Common::UString &label, const LocString &value) {
-	createField(GFF3Struct::kFieldTypeLocString, label)->value.data = value;
+	createField(GFF3Struct::kFieldTypeLocString, label).value.data = value;
 }
 
-GFF3Writer::FieldPtr GFF3WriterStruct::createField(GFF3Struct::FieldType type, const Common::UString &label) {
-	size_t index = _parent->createField(type, label);
-	_fieldIndices.push_back(index);
-	return _parent->_fields.back();
+GFF3Writer::Field &GFF3WriterStruct::createField(GFF3Struct::FieldType type, const Common::UString &label) {
+	_fieldIndices.push_back(_parent->_fields.size());
+
+	return _parent->createField(type, label);
 }
 
 GFF3WriterStruct::GFF3WriterStruct(GFF3Writer *parent, uint32 id) : _id(id), _parent(parent) {
@@ -25,7 +25,8 @@
 #ifndef AURORA_GFF3WRITER_H
 #define AURORA_GFF3WRITER_H
 
-#include <list>
+#include <map>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
@@ -71,8 +72,14 @@ private:
 		}
 
 		bool operator<(const Vector4 &v) const {
-			std::hash<glm::vec4> h;
-			return h(vec) < h(v.vec);
+			if (vec.x != v.vec.x)
+				return vec.x < v.vec.x;
+			if (vec.y != v.vec.y)
+				return vec.y < v.vec.y;
+			if (vec.z != v.vec.z)
+				return vec.z < v.vec.z;
+
+			return vec.w < v.vec.w;
 		}
 	};
 
@@ -153,22 +160,38 @@ private:
 		}
 	};
 
+	/** Relational operator on pointers to values, for map find. */
+	struct ValuePtrLess {
+		bool operator()(const Value *v1, const Value *v2) const {
+			return *v1 < *v2;
+		}
+	};
+
 	/** An implementation for a field. */
-	struct Field : boost::noncopyable {
+	struct Field {
 		uint32 labelIndex;
 		Value value;
 	};
 
-	typedef boost::shared_ptr<Field> FieldPtr;
+	/** Pooled storage for all structs and lists.
+	 *
+	 *  The struct and list pointers we hand out share ownership of the pool,
+	 *  instead of each having their own heap allocation.
+	 */
+	struct Pool;
 
 	uint32 _id;
 	uint32 _version;
 
-	std::vector<GFF3WriterStructPtr> _structs;
-	std::vector<GFF3WriterListPtr> _lists;
+	boost::shared_ptr<Pool> _pool;
+
+	std::vector<GFF3WriterStruct *> _structs;
+	std::vector<GFF3WriterList *> _lists;
 
 	std::vector<Common::UString> _labels;
-	std::vector<FieldPtr> _fields;
+	std::map<Common::UString, uint32> _labelIndices;
+
+	std::vector<Field> _fields;
 
 	friend class GFF3WriterList;
 	friend class GFF3WriterStruct;
@@ -176,9 +199,16 @@ private:
 	/** Adds a label to the writer and returns the corresponding index. */
 	uint32 addLabel(const Common::UString &label);
 	/** Get the actual size of the field. */
-	static uint32 getFieldDataSize(Value field);
+	static uint32 getFieldDataSize(const Value &field);
+
+	Field &createField(GFF3Struct::FieldType type, const Common::UString &label);
+
+	/** Create a new struct, and a field referencing it. */
+	GFF3WriterStructPtr createStruct(const Common::UString &label);
+	/** Create a new list, and a field referencing it. */
+	GFF3WriterListPtr createList(const Common::UString &label);
 
-	size_t createField(GFF3Struct::FieldType type, const Common::UString &label);
+	void writeFieldData(Common::WriteStream &stream, const Value &value);
 };
 
 /** A GFF3 list containing GFF3 structs. */
@@ -253,7 +283,7 @@ public:
 	void addLocString(const Common::UString &label, const LocString &value);
 
 private:
-	GFF3Writer::FieldPtr createField(GFF3Struct::FieldType type, const Common::UString &label);
+	GFF3Writer::Field &createField(GFF3Struct::FieldType type, const Common::UString &label);
 
 	uint32 _id;
 	GFF3Writer *_parent;
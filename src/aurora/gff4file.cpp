@@ -28,10 +28,14 @@
 
 #include <cassert>
 
+#include <algorithm>
+
 #include "external/glm/gtc/type_ptr.hpp"
 
+#include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
 #include "src/common/encoding.h"
 #include "src/common/strutil.h"
 
@@ -76,22 +80,20 @@ bool GFF4File::Header::isBigEndian() const {
 }
 
 
-GFF4File::GFF4File(Common::SeekableReadStream *gff4, uint32 type) :
-	_origStream(gff4), _topLevelStruct(0) {
-
-	assert(_origStream);
+GFF4File::GFF4File(Common::SeekableReadStream *gff4, uint32 type) : _data(0), _dataSize(0), _topLevelStruct(0) {
+	assert(gff4);
 
-	load(type);
+	load(gff4, type);
 }
 
 GFF4File::GFF4File(const Common::UString &gff4, FileType fileType, uint32 type) :
-	_topLevelStruct(0) {
+	_data(0), _dataSize(0), _topLevelStruct(0) {
 
-	_origStream.reset(ResMan.getResource(gff4, fileType));
-	if (!_origStream)
+	Common::SeekableReadStream *res = ResMan.getResource(gff4, fileType);
+	if (!res)
 		throw Common::Exception("No such GFF4 \"%s\"", TypeMan.setFileType(gff4, fileType).c_str());
 
-	load(type);
+	load(res, type);
 }
 
 GFF4File::~GFF4File() {
@@ -99,8 +101,11 @@ GFF4File::~GFF4File() {
 }
 
 void GFF4File::clear() {
-	_origStream.reset();
 	_stream.reset();
+	_dataCopy.reset();
+
+	_data     = 0;
+	_dataSize = 0;
 
 	for (StructMap::iterator s = _structs.begin(); s != _structs.end(); ++s)
 		delete s->second;
@@ -140,12 +145,47 @@ const GFF4Struct &GFF4File::getTopLevel() const {
 
 // --- Loader ---
 
-void GFF4File::load(uint32 type) {
+void GFF4File::load(Common::SeekableReadStream *gff4, uint32 type) {
+	Common::ScopedPtr<Common::SeekableReadStream> stream(gff4);
+
 	try {
 
-		loadHeader(type);
-		loadStructs();
-		loadStrings();
+		/* All field values are read directly out of the whole file in memory,
+		 * without going through a shared stream. If the file already is in
+		 * memory, we keep its stream around and use its data. Otherwise, we
+		 * read the whole file into a buffer of our own. */
+
+		_dataSize = stream->size();
+
+		Common::MemoryReadStream *memStream = dynamic_cast<Common::MemoryReadStream *>(stream.get());
+		if (memStream) {
+			_data = memStream->getData();
+
+			_stream.reset(stream.release());
+		} else {
+			stream->seek(0);
+
+			_dataCopy.reset(new byte[_dataSize]);
+
+			if (stream->read(_dataCopy.get(), _dataSize) != _dataSize)
+				throw Common::Exception(Common::kReadError);
+
+			_data = _dataCopy.get();
+
+			stream.reset();
+		}
+
+		Common::MemoryReadStream data(_data, _dataSize);
+
+		loadHeader(data, type);
+
+		const size_t pos = data.pos();
+
+		Common::SeekableSubReadStreamEndian dataEndian(&data, 0, _dataSize, _header.isBigEndian());
+		dataEndian.seek(pos);
+
+		loadStructs(dataEndian);
+		loadStrings(dataEndian);
 
 	} catch (Common::Exception &e) {
 		clear();
@@ -155,8 +195,8 @@ void GFF4File::load(uint32 type) {
 	}
 }
 
-void GFF4File::loadHeader(uint32 type) {
-	readHeader(*_origStream);
+void GFF4File::loadHeader(Common::SeekableReadStream &gff4, uint32 type) {
+	readHeader(gff4);
 
 	if (_id != kGFFID)
 		throw Common::Exception("Not a GFF4 file");
@@ -164,12 +204,7 @@ void GFF4File::loadHeader(uint32 type) {
 	if ((_version != kVersion40) && (_version != kVersion41))
 		throw Common::Exception("Unsupported GFF4 file version %s", Common::debugTag(_version).c_str());
 
-	_header.read(*_origStream, _version);
-
-	const size_t pos = _origStream->pos();
-	_stream.reset(new Common::SeekableSubReadStreamEndian(_origStream.get(), 0, _origStream->size(),
-	                                                      _header.isBigEndian(), false));
-	_stream->seek(pos);
+	_header.read(gff4, _version);
 
 	if ((type != 0xFFFFFFFF) && (_header.type != type))
 		throw Common::Exception("GFF4 has invalid type (want %s, got %s)",
@@ -179,7 +214,7 @@ void GFF4File::loadHeader(uint32 type) {
 		throw Common::Exception("GFF4 has no structs");
 }
 
-void GFF4File::loadStructs() {
+void GFF4File::loadStructs(Common::SeekableSubReadStreamEndian &gff4) {
 	/* Load the struct templates.
 	 *
 	 * The struct template defines the structure of a struct, i.e. how
@@ -192,23 +227,23 @@ void GFF4File::loadStructs() {
 	 * looked, in a GFF4 this has been sourced out into these templates. */
 
 	static const uint32 kStructTemplateSize = 16;
-	const uint32 structTemplateStart = _stream->pos();
+	const uint32 structTemplateStart = gff4.pos();
 
 	_structTemplates.resize(_header.structCount);
 	for (uint32 i = 0; i < _header.structCount; i++) {
-		_stream->seek(structTemplateStart + i * kStructTemplateSize);
+		gff4.seek(structTemplateStart + i * kStructTemplateSize);
 
 		StructTemplate &strct = _structTemplates[i];
 
 		// Read struct properties
 
 		strct.index = i;
-		strct.label = _stream->readUint32BE();
+		strct.label = gff4.readUint32BE();
 
-		const uint32 fieldCount  = _stream->readUint32();
-		const uint32 fieldOffset = _stream->readUint32();
+		const uint32 fieldCount  = gff4.readUint32();
+		const uint32 fieldOffset = gff4.readUint32();
 
-		strct.size = _stream->readUint32();
+		strct.size = gff4.readUint32();
 
 		// Check if we need to read fields
 		if (fieldOffset == 0xFFFFFFFF) {
@@ -218,7 +253,7 @@ void GFF4File::loadStructs() {
 			continue;
 		}
 
-		_stream->seek(fieldOffset);
+		gff4.seek(fieldOffset);
 
 		// Read the field declarations
 
@@ -226,14 +261,18 @@ void GFF4File::loadStructs() {
 		for (uint32 j = 0; j < fieldCount; j++) {
 			StructTemplate::Field &field = strct.fields[j];
 
-			field.label  = _stream->readUint32();
+			field.label  = gff4.readUint32();
 
-			const uint32 typeAndFlags = _stream->readUint32();
+			const uint32 typeAndFlags = gff4.readUint32();
 			field.type  = (typeAndFlags & 0x0000FFFF);
 			field.flags = (typeAndFlags & 0xFFFF0000) >> 16;
 
-			field.offset = _stream->readUint32();
+			field.offset = gff4.readUint32();
+
+			strct.labels.push_back(field.label);
 		}
+
+		sortFieldLabels(strct);
 	}
 
 	/* And load the top level struct, which itself recurses into field structs.
@@ -242,7 +281,28 @@ void GFF4File::loadStructs() {
 	_topLevelStruct->_refCount++;
 }
 
-void GFF4File::loadStrings() {
+void GFF4File::sortFieldLabels(StructTemplate &strct) {
+	/* Sort the field labels, so that a struct can find a field with a binary
+	 * search. Should the same label appear multiple times, the last field wins. */
+
+	std::vector< std::pair<uint32, uint32> > labels;
+	labels.reserve(strct.fields.size());
+
+	for (size_t i = 0; i < strct.fields.size(); i++)
+		labels.push_back(std::make_pair(strct.fields[i].label, (uint32) i));
+
+	std::sort(labels.begin(), labels.end());
+
+	for (size_t i = 0; i < labels.size(); i++) {
+		if (((i + 1) < labels.size()) && (labels[i + 1].first == labels[i].first))
+			continue;
+
+		strct.sortedLabels.push_back(labels[i].first);
+		strct.sortedFields.push_back(labels[i].second);
+	}
+}
+
+void GFF4File::loadStrings(Common::SeekableSubReadStreamEndian &gff4) {
 	/* Load the global, shared string table.
 	 *
 	 * If this GFF4 file has such a table (which is only supported in V4.1),
@@ -254,9 +314,9 @@ void GFF4File::loadStrings() {
 
 	_sharedStrings.resize(_header.stringCount);
 
-	_stream->seek(_header.stringOffset);
+	gff4.seek(_header.stringOffset);
 	for (uint32 i = 0; i < _header.stringCount; i++)
-		_sharedStrings[i] = Common::readString(*_stream, Common::kEncodingUTF8);
+		_sharedStrings[i] = Common::readString(gff4, Common::kEncodingUTF8);
 }
 
 // --- Helpers for GFF4Struct ---
@@ -291,10 +351,12 @@ GFF4Struct *GFF4File::findStruct(uint64 id) {
 	return s->second;
 }
 
-Common::SeekableSubReadStreamEndian &GFF4File::getStream(uint32 offset) const {
-	_stream->seek(offset);
+const byte *GFF4File::getData() const {
+	return _data;
+}
 
-	return *_stream;
+size_t GFF4File::getDataSize() const {
+	return _dataSize;
 }
 
 uint32 GFF4File::getDataOffset() const {
@@ -325,6 +387,126 @@ Common::UString GFF4File::getSharedString(uint32 i) const {
 }
 
 
+/** Reading integers of a fixed endianness out of memory. */
+template<bool kBigEndian> struct GFF4EndianReader;
+
+template<> struct GFF4EndianReader<false> {
+	static uint16 read16(const byte *data) { return READ_LE_UINT16(data); }
+	static uint32 read32(const byte *data) { return READ_LE_UINT32(data); }
+	static uint64 read64(const byte *data) { return READ_LE_UINT64(data); }
+};
+
+template<> struct GFF4EndianReader<true> {
+	static uint16 read16(const byte *data) { return READ_BE_UINT16(data); }
+	static uint32 read32(const byte *data) { return READ_BE_UINT32(data); }
+	static uint64 read64(const byte *data) { return READ_BE_UINT64(data); }
+};
+
+/** The integer reads of one endianness, so that a reader picks them only once. */
+struct GFF4EndianReads {
+	uint16 (*read16)(const byte *data);
+	uint32 (*read32)(const byte *data);
+	uint64 (*read64)(const byte *data);
+};
+
+static const GFF4EndianReads kGFF4ReadsLE = {
+	&GFF4EndianReader<false>::read16, &GFF4EndianReader<false>::read32, &GFF4EndianReader<false>::read64
+};
+
+static const GFF4EndianReads kGFF4ReadsBE = {
+	&GFF4EndianReader<true>::read16, &GFF4EndianReader<true>::read32, &GFF4EndianReader<true>::read64
+};
+
+/** Reading field values directly out of the data of a GFF4.
+ *
+ *  Unlike a stream, a reader is a cheap, non-virtual cursor that only
+ *  holds its own position. Any number of readers, in any number of
+ *  threads, can read from the same GFF4 at the same time.
+ */
+class GFF4Struct::Reader {
+public:
+	Reader(const GFF4File &parent, size_t offset = 0) : _data(parent.getData()),
+		_size(parent.getDataSize()), _reads(parent.isBigEndian() ? &kGFF4ReadsBE : &kGFF4ReadsLE), _pos(0) {
+
+		seek(offset);
+	}
+
+	size_t pos() const {
+		return _pos;
+	}
+
+	size_t size() const {
+		return _size;
+	}
+
+	void seek(size_t offset) {
+		if (offset > _size)
+			throw Common::Exception(Common::kSeekError);
+
+		_pos = offset;
+	}
+
+	/** Return a pointer to the next n bytes, and skip over them. */
+	const byte *read(size_t n) {
+		if ((_size - _pos) < n)
+			throw Common::Exception(Common::kReadError);
+
+		const byte *data = _data + _pos;
+		_pos += n;
+
+		return data;
+	}
+
+	byte readByte() {
+		return *read(1);
+	}
+
+	int8 readSByte() {
+		return (int8) *read(1);
+	}
+
+	uint16 readUint16() {
+		return _reads->read16(read(2));
+	}
+
+	uint32 readUint32() {
+		return _reads->read32(read(4));
+	}
+
+	uint64 readUint64() {
+		return _reads->read64(read(8));
+	}
+
+	int16 readSint16() {
+		return (int16) readUint16();
+	}
+
+	int32 readSint32() {
+		return (int32) readUint32();
+	}
+
+	int64 readSint64() {
+		return (int64) readUint64();
+	}
+
+	float readIEEEFloat() {
+		return convertIEEEFloat(readUint32());
+	}
+
+	double readIEEEDouble() {
+		return convertIEEEDouble(readUint64());
+	}
+
+private:
+	const byte *_data;
+	size_t _size;
+
+	const GFF4EndianReads *_reads;
+
+	size_t _pos;
+};
+
+
 GFF4Struct::Field::Field(uint32 l, uint16 t, uint16 f, uint32 o, bool g) :
 	label(l), offset(o), isGeneric(g) {
 
@@ -364,7 +546,7 @@ GFF4Struct::Field::Field(uint32 l, uint16 t, uint16 f, uint32 o, bool g) :
 
 
 GFF4Struct::GFF4Struct(GFF4File &parent, uint32 offset, const GFF4File::StructTemplate &tmplt) :
-	_parent(&parent), _label(tmplt.label), _refCount(0), _fieldCount(0) {
+	_parent(&parent), _template(&tmplt), _label(tmplt.label), _refCount(0), _fieldCount(0) {
 
 	// Constructor for a real struct, from a template
 
@@ -380,7 +562,7 @@ GFF4Struct::GFF4Struct(GFF4File &parent, uint32 offset, const GFF4File::StructTe
 }
 
 GFF4Struct::GFF4Struct(GFF4File &parent, const Field &genericParent) :
-	_parent(&parent), _label(0), _refCount(0), _fieldCount(0) {
+	_parent(&parent), _template(0), _label(0), _refCount(0), _fieldCount(0) {
 
 	// Constructor for a generic, converted into a struct
 
@@ -420,18 +602,20 @@ void GFF4Struct::load(GFF4File &parent, uint32 offset, const GFF4File::StructTem
 	 * a struct, recursively create a new struct instance for it. If
 	 * the field is a generic, create a struct for it as well. */
 
+	/* The fields are stored in template order. The template also
+	 * holds the sorted labels we need to look them up again. */
+
+	_fields.resize(tmplt.fields.size());
 	for (size_t i = 0; i < tmplt.fields.size(); i++) {
 		const GFF4File::StructTemplate::Field &field = tmplt.fields[i];
 
-		_fieldLabels.push_back(field.label);
-
 		// Calculate the offset for the field data, but guard against NULL pointers
 		uint32 fieldOffset = offset + field.offset;
 		if ((offset == 0xFFFFFFFF) || (field.offset == 0xFFFFFFFF))
 			fieldOffset = 0xFFFFFFFF;
 
 		// Load the field and its struct(s), if any
-		Field &f = _fields[field.label] = Field(field.label, field.type, field.flags, fieldOffset);
+		Field &f = _fields[i] = Field(field.label, field.type, field.flags, fieldOffset);
 		if (f.type == kFieldTypeStruct)
 			loadStructs(parent, f);
 		if (f.type == kFieldTypeGeneric)
@@ -441,7 +625,7 @@ void GFF4Struct::load(GFF4File &parent, uint32 offset, const GFF4File::StructTem
 			throw Common::Exception("GFF4: TODO: ASCII string field in a file with shared strings");
 	}
 
-	_fieldCount = _fields.size();
+	_fieldCount = tmplt.sortedLabels.size();
 }
 
 void GFF4Struct::loadStructs(GFF4File &parent, Field &field) {
@@ -465,7 +649,7 @@ void GFF4Struct::loadStructs(GFF4File &parent, Field &field) {
 
 	const GFF4File::StructTemplate &tmplt = parent.getStructTemplate(field.structIndex);
 
-	Common::SeekableSubReadStreamEndian &data = parent.getStream(field.offset);
+	Reader data(parent, field.offset);
 
 	const uint32 structCount = getListCount(data, field);
 	const uint32 structSize  = field.isReference ? 4 : tmplt.size;
@@ -512,7 +696,7 @@ void GFF4Struct::load(GFF4File &parent, const Field &genericParent) {
 
 	static const uint32 kGenericSize = 8;
 
-	Common::SeekableSubReadStreamEndian &data = parent.getStream(genericParent.offset);
+	Reader data(parent, genericParent.offset);
 
 	const uint32 genericCount = genericParent.isList ? data.readUint32() : 1;
 	const uint32 genericStart = data.pos();
@@ -531,6 +715,10 @@ void GFF4Struct::load(GFF4File &parent, const Field &genericParent) {
 
 		_fieldLabels.push_back(i);
 
+		// The fields of a generic are indexed by their label directly
+		if (_fields.size() <= i)
+			_fields.resize(i + 1);
+
 		// Load the field and its struct(s), if any
 		Field &f = _fields[i] = Field(i, fieldType, fieldFlags, fieldOffset, true);
 		if (f.type == kFieldTypeStruct)
@@ -567,7 +755,7 @@ bool GFF4Struct::hasField(uint32 field) const {
 }
 
 const std::vector<uint32> &GFF4Struct::getFieldLabels() const {
-	return _fieldLabels;
+	return _template ? _template->labels : _fieldLabels;
 }
 
 GFF4Struct::FieldType GFF4Struct::getFieldType(uint32 field) const {
@@ -600,18 +788,27 @@ bool GFF4Struct::getFieldProperties(uint32 field, FieldType &type, uint32 &label
 // --- Field value reader helpers ---
 
 const GFF4Struct::Field *GFF4Struct::getField(uint32 field) const {
-	FieldMap::const_iterator f = _fields.find(field);
-	if (f == _fields.end())
+	if (_template) {
+		const std::vector<uint32> &labels = _template->sortedLabels;
+
+		std::vector<uint32>::const_iterator l = std::lower_bound(labels.begin(), labels.end(), field);
+		if ((l == labels.end()) || (*l != field))
+			return 0;
+
+		return &_fields[_template->sortedFields[l - labels.begin()]];
+	}
+
+	if ((field >= _fields.size()) || (_fields[field].type == kFieldTypeNone))
 		return 0;
 
-	return &f->second;
+	return &_fields[field];
 }
 
 uint32 GFF4Struct::getDataOffset(bool isReference, uint32 offset) const {
 	if (!isReference || (offset == 0xFFFFFFFF))
 		return offset;
 
-	Common::SeekableSubReadStreamEndian &data = _parent->getStream(offset);
+	Reader data(*_parent, offset);
 
 	offset = data.readUint32();
 	if (offset == 0xFFFFFFFF)
@@ -627,19 +824,16 @@ uint32 GFF4Struct::getDataOffset(const Field &field) const {
 	return getDataOffset(field.isReference, field.offset);
 }
 
-Common::SeekableSubReadStreamEndian *GFF4Struct::getData(const Field &field) const {
-	const uint32 offset = getDataOffset(field);
-	if (offset == 0xFFFFFFFF)
-		return 0;
-
-	return &_parent->getStream(offset);
-}
-
-Common::SeekableSubReadStreamEndian *GFF4Struct::getField(uint32 fieldID, const Field *&field) const {
+bool GFF4Struct::getField(uint32 fieldID, const Field *&field, Reader &data) const {
 	if (!(field = getField(fieldID)))
-		return 0;
+		return false;
 
-	return getData(*field);
+	const uint32 offset = getDataOffset(*field);
+	if (offset == 0xFFFFFFFF)
+		return false;
+
+	data.seek(offset);
+	return true;
 }
 
 uint32 GFF4Struct::getVectorMatrixLength(const Field &field, uint32 minLength, uint32 maxLength) const {
@@ -663,7 +857,7 @@ uint32 GFF4Struct::getVectorMatrixLength(const Field &field, uint32 minLength, u
 	return length;
 }
 
-uint32 GFF4Struct::getListCount(Common::SeekableSubReadStreamEndian &data, const Field &field) const {
+uint32 GFF4Struct::getListCount(Reader &data, const Field &field) const {
 	if (!field.isList)
 		return 1;
 
@@ -727,7 +921,7 @@ uint32 GFF4Struct::getFieldSize(FieldType type) const {
 
 // --- Low-level value readers ---
 
-uint64 GFF4Struct::getUint(Common::SeekableSubReadStreamEndian &data, FieldType type) const {
+uint64 GFF4Struct::getUint(Reader &data, FieldType type) const {
 	switch (type) {
 		case kFieldTypeUint8:
 			return (uint64) data.readByte();
@@ -760,7 +954,7 @@ uint64 GFF4Struct::getUint(Common::SeekableSubReadStreamEndian &data, FieldType
 	throw Common::Exception("GFF4: Field is not an int type");
 }
 
-int64 GFF4Struct::getSint(Common::SeekableSubReadStreamEndian &data, FieldType type) const {
+int64 GFF4Struct::getSint(Reader &data, FieldType type) const {
 	switch (type) {
 		case kFieldTypeUint8:
 			return (int64) ((uint64) data.readByte());
@@ -793,7 +987,7 @@ int64 GFF4Struct::getSint(Common::SeekableSubReadStreamEndian &data, FieldType t
 	throw Common::Exception("GFF4: Field is not an int type");
 }
 
-double GFF4Struct::getDouble(Common::SeekableSubReadStreamEndian &data, FieldType type) const {
+double GFF4Struct::getDouble(Reader &data, FieldType type) const {
 	switch (type) {
 		case kFieldTypeFloat32:
 			return (double) data.readIEEEFloat();
@@ -811,7 +1005,7 @@ double GFF4Struct::getDouble(Common::SeekableSubReadStreamEndian &data, FieldTyp
 	throw Common::Exception("GFF4: Field is not a float type");
 }
 
-float GFF4Struct::getFloat(Common::SeekableSubReadStreamEndian &data, FieldType type) const {
+float GFF4Struct::getFloat(Reader &data, FieldType type) const {
 	switch (type) {
 		case kFieldTypeFloat32:
 			return (float) data.readIEEEFloat();
@@ -829,7 +1023,7 @@ float GFF4Struct::getFloat(Common::SeekableSubReadStreamEndian &data, FieldType
 	throw Common::Exception("GFF4: Field is not a float type");
 }
 
-Common::UString GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data, Common::Encoding encoding) const {
+Common::UString GFF4Struct::getString(Reader &data, Common::Encoding encoding) const {
 	/* When the string is encoded in UTF-8, then length field specifies the length in bytes.
 	 * Otherwise, it's the length in characters. */
 	const size_t lengthMult = encoding == Common::kEncodingUTF8 ? 1 : Common::getBytesPerCodepoint(encoding);
@@ -840,17 +1034,21 @@ Common::UString GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data,
 	const size_t size   = length * lengthMult;
 
 	try {
-		return Common::readStringFixed(data, encoding, size);
+		// Like reading a fixed-length string from a stream, cut it off at the end of the data
+		const size_t available = MIN(size, data.size() - data.pos());
+
+		return Common::readString(data.read(available), available, encoding);
 	} catch (...) {
 	}
 
 	return Common::UString::format("GFF4: Invalid string encoding (0x%08X)", (uint) offset);
 }
 
-Common::UString GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data, Common::Encoding encoding,
+Common::UString GFF4Struct::getString(Reader &data, Common::Encoding encoding,
                                       uint32 offset) const {
 
-	const uint32 pos = data.seek(offset);
+	const size_t pos = data.pos();
+	data.seek(offset);
 
 	Common::UString str = getString(data, encoding);
 
@@ -859,7 +1057,7 @@ Common::UString GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data,
 	return str;
 }
 
-Common::UString GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data, const Field &field,
+Common::UString GFF4Struct::getString(Reader &data, const Field &field,
                                       Common::Encoding encoding) const {
 
 	if (field.type == kFieldTypeString) {
@@ -888,26 +1086,26 @@ Common::UString GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data,
 
 uint64 GFF4Struct::getUint(uint32 field, uint64 def) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return def;
 
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	return getUint(*data, f->type);
+	return getUint(data, f->type);
 }
 
 int64 GFF4Struct::getSint(uint32 field, int64 def) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return def;
 
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	return getSint(*data, f->type);
+	return getSint(data, f->type);
 }
 
 bool GFF4Struct::getBool(uint32 field, bool def) const {
@@ -916,40 +1114,40 @@ bool GFF4Struct::getBool(uint32 field, bool def) const {
 
 double GFF4Struct::getDouble(uint32 field, double def) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return def;
 
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	return getDouble(*data, f->type);
+	return getDouble(data, f->type);
 }
 
 float GFF4Struct::getFloat(uint32 field, float def) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return def;
 
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	return getFloat(*data, f->type);
+	return getFloat(data, f->type);
 }
 
 Common::UString GFF4Struct::getString(uint32 field, Common::Encoding encoding,
                                       const Common::UString &def) const {
 
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return def;
 
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	return getString(*data, *f, encoding);
+	return getString(data, *f, encoding);
 }
 
 Common::UString GFF4Struct::getString(uint32 field, const Common::UString &def) const {
@@ -960,8 +1158,8 @@ bool GFF4Struct::getTalkString(uint32 field, Common::Encoding encoding,
                                uint32 &strRef, Common::UString &str) const {
 
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
 	if (f->type != kFieldTypeTlkString)
@@ -969,16 +1167,16 @@ bool GFF4Struct::getTalkString(uint32 field, Common::Encoding encoding,
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	strRef = getUint(*data, kFieldTypeUint32);
+	strRef = getUint(data, kFieldTypeUint32);
 
-	const uint32 offset = getUint(*data, kFieldTypeUint32);
+	const uint32 offset = getUint(data, kFieldTypeUint32);
 
 	str.clear();
 	if (offset != 0xFFFFFFFF) {
 		if (_parent->hasSharedStrings())
 			str = _parent->getSharedString(offset);
 		else if (offset != 0)
-			str = getString(*data, encoding, _parent->getDataOffset() + offset);
+			str = getString(data, encoding, _parent->getDataOffset() + offset);
 	}
 
 	return true;
@@ -990,8 +1188,8 @@ bool GFF4Struct::getTalkString(uint32 field, uint32 &strRef, Common::UString &st
 
 bool GFF4Struct::getVector3(uint32 field, double &v1, double &v2, double &v3) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
 	if (f->isList)
@@ -999,17 +1197,17 @@ bool GFF4Struct::getVector3(uint32 field, double &v1, double &v2, double &v3) co
 
 	getVectorMatrixLength(*f, 3, 3);
 
-	v1 = getDouble(*data, kFieldTypeFloat32);
-	v2 = getDouble(*data, kFieldTypeFloat32);
-	v3 = getDouble(*data, kFieldTypeFloat32);
+	v1 = getDouble(data, kFieldTypeFloat32);
+	v2 = getDouble(data, kFieldTypeFloat32);
+	v3 = getDouble(data, kFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getVector3(uint32 field, float &v1, float &v2, float &v3) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
 	if (f->isList)
@@ -1017,17 +1215,17 @@ bool GFF4Struct::getVector3(uint32 field, float &v1, float &v2, float &v3) const
 
 	getVectorMatrixLength(*f, 3, 3);
 
-	v1 = getFloat(*data, kFieldTypeFloat32);
-	v2 = getFloat(*data, kFieldTypeFloat32);
-	v3 = getFloat(*data, kFieldTypeFloat32);
+	v1 = getFloat(data, kFieldTypeFloat32);
+	v2 = getFloat(data, kFieldTypeFloat32);
+	v3 = getFloat(data, kFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getVector4(uint32 field, double &v1, double &v2, double &v3, double &v4) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
 	if (f->isList)
@@ -1035,18 +1233,18 @@ bool GFF4Struct::getVector4(uint32 field, double &v1, double &v2, double &v3, do
 
 	getVectorMatrixLength(*f, 4, 4);
 
-	v1 = getDouble(*data, kFieldTypeFloat32);
-	v2 = getDouble(*data, kFieldTypeFloat32);
-	v3 = getDouble(*data, kFieldTypeFloat32);
-	v4 = getDouble(*data, kFieldTypeFloat32);
+	v1 = getDouble(data, kFieldTypeFloat32);
+	v2 = getDouble(data, kFieldTypeFloat32);
+	v3 = getDouble(data, kFieldTypeFloat32);
+	v4 = getDouble(data, kFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getVector4(uint32 field, float &v1, float &v2, float &v3, float &v4) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
 	if (f->isList)
@@ -1054,18 +1252,18 @@ bool GFF4Struct::getVector4(uint32 field, float &v1, float &v2, float &v3, float
 
 	getVectorMatrixLength(*f, 4, 4);
 
-	v1 = getFloat(*data, kFieldTypeFloat32);
-	v2 = getFloat(*data, kFieldTypeFloat32);
-	v3 = getFloat(*data, kFieldTypeFloat32);
-	v4 = getFloat(*data, kFieldTypeFloat32);
+	v1 = getFloat(data, kFieldTypeFloat32);
+	v2 = getFloat(data, kFieldTypeFloat32);
+	v3 = getFloat(data, kFieldTypeFloat32);
+	v4 = getFloat(data, kFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getMatrix4x4(uint32 field, double (&m)[16]) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
 	if (f->isList)
@@ -1073,15 +1271,15 @@ bool GFF4Struct::getMatrix4x4(uint32 field, double (&m)[16]) const {
 
 	const uint32 length = getVectorMatrixLength(*f, 16, 16);
 	for (uint32 i = 0; i < length; i++)
-		m[i] = getDouble(*data, kFieldTypeFloat32);
+		m[i] = getDouble(data, kFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getMatrix4x4(uint32 field, float (&m)[16]) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
 	if (f->isList)
@@ -1089,7 +1287,7 @@ bool GFF4Struct::getMatrix4x4(uint32 field, float (&m)[16]) const {
 
 	const uint32 length = getVectorMatrixLength(*f, 16, 16);
 	for (uint32 i = 0; i < length; i++)
-		m[i] = getFloat(*data, kFieldTypeFloat32);
+		m[i] = getFloat(data, kFieldTypeFloat32);
 
 	return true;
 }
@@ -1105,8 +1303,8 @@ bool GFF4Struct::getMatrix4x4(uint32 field, glm::mat4 &m) const {
 
 bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<double> &vectorMatrix) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
 	if (f->isList)
@@ -1116,15 +1314,15 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<double> &vectorMatrix
 
 	vectorMatrix.resize(length);
 	for (uint32 i = 0; i < length; i++)
-		vectorMatrix[i] = getDouble(*data, kFieldTypeFloat32);
+		vectorMatrix[i] = getDouble(data, kFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<float> &vectorMatrix) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
 	if (f->isList)
@@ -1134,7 +1332,7 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<float> &vectorMatrix)
 
 	vectorMatrix.resize(length);
 	for (uint32 i = 0; i < length; i++)
-		vectorMatrix[i] = getFloat(*data, kFieldTypeFloat32);
+		vectorMatrix[i] = getFloat(data, kFieldTypeFloat32);
 
 	return true;
 }
@@ -1143,75 +1341,75 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<float> &vectorMatrix)
 
 bool GFF4Struct::getUint(uint32 field, std::vector<uint64> &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(data, *f);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getUint(*data, f->type);
+		list[i] = getUint(data, f->type);
 
 	return true;
 }
 
 bool GFF4Struct::getSint(uint32 field, std::vector<int64> &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(data, *f);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getSint(*data, f->type);
+		list[i] = getSint(data, f->type);
 
 	return true;
 }
 
 bool GFF4Struct::getBool(uint32 field, std::vector<bool> &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(data, *f);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getUint(*data, f->type) != 0;
+		list[i] = getUint(data, f->type) != 0;
 
 	return true;
 }
 
 bool GFF4Struct::getDouble(uint32 field, std::vector<double> &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(data, *f);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getDouble(*data, f->type);
+		list[i] = getDouble(data, f->type);
 
 	return true;
 }
 
 bool GFF4Struct::getFloat(uint32 field, std::vector<float> &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(data, *f);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getFloat(*data, f->type);
+		list[i] = getFloat(data, f->type);
 
 	return true;
 }
@@ -1220,8 +1418,8 @@ bool GFF4Struct::getString(uint32 field, Common::Encoding encoding,
                            std::vector<Common::UString> &list) const {
 
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data) {
+	Reader data(*_parent);
+	if (!getField(field, f, data)) {
 		if (f && !f->isList) {
 			list.push_back("");
 			return true;
@@ -1230,11 +1428,11 @@ bool GFF4Struct::getString(uint32 field, Common::Encoding encoding,
 		return false;
 	}
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(data, *f);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getString(*data, *f, encoding);
+		list[i] = getString(data, *f, encoding);
 
 	return true;
 }
@@ -1248,14 +1446,14 @@ bool GFF4Struct::getTalkString(uint32 field, Common::Encoding encoding,
 
 
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
 	if (f->type != kFieldTypeTlkString)
 		throw Common::Exception("GFF4: Field is not of TalkString type");
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(data, *f);
 
 	strRefs.resize(count);
 	strs.resize(count);
@@ -1264,15 +1462,15 @@ bool GFF4Struct::getTalkString(uint32 field, Common::Encoding encoding,
 	offsets.resize(count);
 
 	for (uint32 i = 0; i < count; i++) {
-		strRefs[i] = getUint(*data, kFieldTypeUint32);
+		strRefs[i] = getUint(data, kFieldTypeUint32);
 
-		const uint32 offset = getUint(*data, kFieldTypeUint32);
+		const uint32 offset = getUint(data, kFieldTypeUint32);
 
 		if (offset != 0xFFFFFFFF) {
 			if (_parent->hasSharedStrings())
 				strs[i] = _parent->getSharedString(offset);
 			else if (offset != 0)
-				strs[i] = getString(*data, encoding, _parent->getDataOffset() + offset);
+				strs[i] = getString(data, encoding, _parent->getDataOffset() + offset);
 		}
 	}
 
@@ -1287,19 +1485,19 @@ bool GFF4Struct::getTalkString(uint32 field,
 
 bool GFF4Struct::getVectorMatrix(uint32 field, std::vector< std::vector<double> > &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
 	const uint32 length = getVectorMatrixLength(*f, 0, 16);
-	const uint32 count  = getListCount(*data, *f);
+	const uint32 count  = getListCount(data, *f);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++) {
 
 		list[i].resize(length);
 		for (uint32 j = 0; j < length; j++)
-			list[i][j] = getDouble(*data, kFieldTypeFloat32);
+			list[i][j] = getDouble(data, kFieldTypeFloat32);
 	}
 
 	return true;
@@ -1307,19 +1505,19 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector< std::vector<double>
 
 bool GFF4Struct::getVectorMatrix(uint32 field, std::vector< std::vector<float> > &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
 	const uint32 length = getVectorMatrixLength(*f, 0, 16);
-	const uint32 count  = getListCount(*data, *f);
+	const uint32 count  = getListCount(data, *f);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++) {
 
 		list[i].resize(length);
 		for (uint32 j = 0; j < length; j++)
-			list[i][j] = getFloat(*data, kFieldTypeFloat32);
+			list[i][j] = getFloat(data, kFieldTypeFloat32);
 	}
 
 	return true;
@@ -1327,19 +1525,19 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector< std::vector<float> >
 
 bool GFF4Struct::getMatrix4x4(uint32 field, std::vector<glm::mat4> &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return false;
 
 	const uint32 length = getVectorMatrixLength(*f, 0, 16);
-	const uint32 count  = getListCount(*data, *f);
+	const uint32 count  = getListCount(data, *f);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++) {
 		float m[16];
 
 		for (uint32 j = 0; j < length; j++)
-			m[j] = getFloat(*data, kFieldTypeFloat32);
+			m[j] = getFloat(data, kFieldTypeFloat32);
 
 		list[i] = glm::make_mat4(m);
 	}
@@ -1398,25 +1596,25 @@ const GFF4List &GFF4Struct::getList(uint32 field) const {
 
 Common::SeekableReadStream *GFF4Struct::getData(uint32 field) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
-	if (!data)
+	Reader data(*_parent);
+	if (!getField(field, f, data))
 		return 0;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 count = getListCount(data, *f);
 	const uint32 size  = getFieldSize(f->type);
 
 	if ((size == 0) || (count == 0))
 		return 0;
 
 	const size_t dataSize  = count * size;
-	const size_t dataBegin = data->pos();
-	const size_t dataEnd   = data->pos() + dataSize;
+	const size_t dataBegin = data.pos();
 
-	if ((dataBegin >= data->size()) || ((data->size() - dataBegin) < dataSize))
+	if ((dataBegin >= data.size()) || ((data.size() - dataBegin) < dataSize))
 		throw Common::Exception("Invalid data offset (%u, %u, %u)",
-		                        (uint) dataBegin, (uint) dataSize, (uint) data->size());
+		                        (uint) dataBegin, (uint) dataSize, (uint) data.size());
 
-	return new Common::SeekableSubReadStream(data, dataBegin, dataEnd);
+	// The data stays owned by the GFF4, which has to outlive the stream
+	return new Common::MemoryReadStream(data.read(dataSize), dataSize);
 }
 
 } // End of namespace Aurora
@@ -77,6 +77,11 @@ class GFF4Struct;
  *  reference a string within this table, so that duplicated strings don't
  *  need to be stored multiple times.
  *
+ *  The whole GFF4 is read into memory on load, and all field values are
+ *  read directly out of that memory. Since nothing in a loaded GFF4 is
+ *  modified anymore, the same GFF4 can be read from multiple threads at
+ *  the same time.
+ *
  *  Notes:
  *  - Generics and lists of generics are mapped to structs, with the field ID
  *    being the list element indices (or just 0 on non-list generics).
@@ -151,6 +156,10 @@ private:
 		uint32 size;
 
 		std::vector<Field> fields;
+
+		std::vector<uint32> labels;       ///< The labels of all fields, in field order.
+		std::vector<uint32> sortedLabels; ///< The unique labels of all fields, sorted.
+		std::vector<uint32> sortedFields; ///< The field index for each of the sortedLabels.
 	};
 
 	typedef std::vector<StructTemplate> StructTemplates;
@@ -159,8 +168,14 @@ private:
 
 
 
-	Common::ScopedPtr<Common::SeekableReadStream> _origStream;
-	Common::ScopedPtr<Common::SeekableSubReadStreamEndian> _stream;
+	/** The memory stream the GFF4 was loaded from, if we use its data directly. */
+	Common::ScopedPtr<Common::SeekableReadStream> _stream;
+	/** A copy of the whole GFF4 file, if it wasn't loaded from memory. */
+	Common::ScopedArray<byte> _dataCopy;
+
+	/** The whole GFF4 file. */
+	const byte *_data;
+	size_t _dataSize;
 
 	/** This GFF4's header. */
 	Header          _header;
@@ -177,10 +192,12 @@ private:
 
 
 	// .--- Loading helpers
-	void load(uint32 type);
-	void loadHeader(uint32 type);
-	void loadStructs();
-	void loadStrings();
+	void load(Common::SeekableReadStream *gff4, uint32 type);
+	void loadHeader(Common::SeekableReadStream &gff4, uint32 type);
+	void loadStructs(Common::SeekableSubReadStreamEndian &gff4);
+	void loadStrings(Common::SeekableSubReadStreamEndian &gff4);
+
+	static void sortFieldLabels(StructTemplate &strct);
 
 	void clear();
 	// '---
@@ -190,7 +207,8 @@ private:
 	void unregisterStruct(uint64 id);
 	GFF4Struct *findStruct(uint64 id);
 
-	Common::SeekableSubReadStreamEndian &getStream(uint32 offset) const;
+	const byte *getData() const;
+	size_t getDataSize() const;
 	const StructTemplate &getStructTemplate(uint32 i) const;
 	uint32 getDataOffset() const;
 
@@ -367,11 +385,14 @@ private:
 		~Field() = default;
 	};
 
-	typedef std::map<uint32, Field> FieldMap;
+	class Reader;
 
 
 	const GFF4File *_parent;
 
+	/** The template this struct was loaded from, or 0 for a generic. */
+	const GFF4File::StructTemplate *_template;
+
 	uint32 _label;
 
 	uint64 _id;
@@ -379,9 +400,10 @@ private:
 
 	size_t _fieldCount;
 
-	FieldMap _fields;
+	/** All fields, in template order. For generics, indexed by their label. */
+	std::vector<Field> _fields;
 
-	/** The labels of all fields in this struct. */
+	/** The labels of all fields in a generic. Structs use their template's. */
 	std::vector<uint32> _fieldLabels;
 
 
@@ -407,24 +429,24 @@ private:
 	uint32 getDataOffset(bool isReference, uint32 offset) const;
 	uint32 getDataOffset(const Field &field) const;
 
-	Common::SeekableSubReadStreamEndian *getData(const Field &field) const;
-	Common::SeekableSubReadStreamEndian *getField(uint32 fieldID, const Field *&field) const;
+	/** Find a field and point the reader to its data. Returns false if there's no data. */
+	bool getField(uint32 fieldID, const Field *&field, Reader &data) const;
 	// '---
 
 	// .--- Field reader helpers
-	uint32 getListCount(Common::SeekableSubReadStreamEndian &data, const Field &field) const;
+	uint32 getListCount(Reader &data, const Field &field) const;
 	uint32 getFieldSize(FieldType type) const;
 
-	uint64 getUint(Common::SeekableSubReadStreamEndian &data, FieldType type) const;
-	 int64 getSint(Common::SeekableSubReadStreamEndian &data, FieldType type) const;
+	uint64 getUint(Reader &data, FieldType type) const;
+	 int64 getSint(Reader &data, FieldType type) const;
 
-	double getDouble(Common::SeekableSubReadStreamEndian &data, FieldType type) const;
-	float  getFloat (Common::SeekableSubReadStreamEndian &data, FieldType type) const;
+	double getDouble(Reader &data, FieldType type) const;
+	float  getFloat (Reader &data, FieldType type) const;
 
-	Common::UString getString(Common::SeekableSubReadStreamEndian &data, Common::Encoding encoding) const;
-	Common::UString getString(Common::SeekableSubReadStreamEndian &data, Common::Encoding encoding,
+	Common::UString getString(Reader &data, Common::Encoding encoding) const;
+	Common::UString getString(Reader &data, Common::Encoding encoding,
 	                          uint32 offset) const;
-	Common::UString getString(Common::SeekableSubReadStreamEndian &data, const Field &field,
+	Common::UString getString(Reader &data, const Field &field,
 	                          Common::Encoding encoding) const;
 
 	uint32 getVectorMatrixLength(const Field &field, uint32 minLength, uint32 maxLength) const;
@@ -65,6 +65,9 @@ public:
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Return where the resource's data can be found within the HERF. */
+	bool getResourceLocation(uint32 index, uint32 &offset, uint32 &size) const;
+
 	/** Return with which algorithm the name is hashed. */
 	Common::HashAlgo getNameHashAlgo() const;
 
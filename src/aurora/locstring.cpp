@@ -205,15 +205,7 @@ bool LocString::operator<(const LocString &rhs) const {
 	if (_strings.size() != rhs._strings.size())
 		return _strings.size() < rhs._strings.size();
 
-	size_t lhs_size = 0, rhs_size = 0;
-	for (const auto &string : _strings) {
-		lhs_size += string.second.size();
-	}
-	for (const auto &string : rhs._strings) {
-		rhs_size += string.second.size();
-	}
-
-	return lhs_size < rhs_size;
+	return _strings < rhs._strings;
 }
 
 } // End of namespace Aurora
@@ -0,0 +1,397 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A persistent cache of archive indices.
+ */
+
+#include <cassert>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/encoding.h"
+#include "src/common/filepath.h"
+#include "src/common/readfile.h"
+#include "src/common/writefile.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/aurora/resindexcache.h"
+
+static const uint32 kCacheID = MKTAG('X', 'R', 'I', 'C');
+static const uint32 kVersion = 1;
+
+namespace Aurora {
+
+CachedArchive::CachedArchive(Common::SeekableReadStream *archive, Common::HashAlgo hashAlgo,
+                             ResourceList &resources, Locations &locations) :
+	_archive(archive), _hashAlgo(hashAlgo) {
+
+	assert(_archive);
+
+	_resources.swap(resources);
+	_locations.swap(locations);
+}
+
+CachedArchive::~CachedArchive() {
+}
+
+const Archive::ResourceList &CachedArchive::getResources() const {
+	return _resources;
+}
+
+const CachedArchive::Location &CachedArchive::getLocation(uint32 index) const {
+	if (index >= _locations.size())
+		throw Common::Exception("Resource index out of range (%u/%u)", index, (uint) _locations.size());
+
+	return _locations[index];
+}
+
+uint32 CachedArchive::getResourceSize(uint32 index) const {
+	return getLocation(index).size;
+}
+
+bool CachedArchive::getResourceLocation(uint32 index, uint32 &offset, uint32 &size) const {
+	const Location &location = getLocation(index);
+
+	offset = location.offset;
+	size   = location.size;
+
+	return true;
+}
+
+Common::SeekableReadStream *CachedArchive::getResource(uint32 index, bool tryNoCopy) const {
+	const Location &location = getLocation(index);
+
+	if (tryNoCopy)
+		return new Common::SeekableSubReadStream(_archive.get(), location.offset, location.offset + location.size);
+
+	_archive->seek(location.offset);
+
+	return _archive->readStream(location.size);
+}
+
+Common::HashAlgo CachedArchive::getNameHashAlgo() const {
+	return _hashAlgo;
+}
+
+
+ResourceIndexCache::ArchiveIndex::ArchiveIndex() : size(0), time(0), hashAlgo(Common::kHashNone) {
+}
+
+
+ResourceIndexCache::ResourceIndexCache() : _changed(false) {
+}
+
+ResourceIndexCache::~ResourceIndexCache() {
+}
+
+void ResourceIndexCache::clear() {
+	_file.clear();
+
+	_entries.clear();
+	_added.clear();
+	_data.reset();
+
+	_changed = false;
+}
+
+static void writeCacheString(Common::WriteStream &stream, const Common::UString &str) {
+	stream.writeUint32LE(str.size());
+	stream.write(str.c_str(), str.size());
+}
+
+static Common::UString readCacheString(Common::SeekableReadStream &stream) {
+	const uint32 length = stream.readUint32LE();
+	if (length > (stream.size() - stream.pos()))
+		throw Common::Exception(Common::kReadError);
+
+	return Common::readStringFixed(stream, Common::kEncodingUTF8, length);
+}
+
+void ResourceIndexCache::load(const Common::UString &file) {
+	clear();
+
+	_file = file;
+	if (!Common::FilePath::isRegularFile(_file))
+		return;
+
+	try {
+		// Read the whole cache at once. The entries are only parsed when needed
+		Common::ReadFile cache(_file);
+
+		const size_t size = cache.size();
+
+		_data.reset(new byte[size]);
+		if (cache.read(_data.get(), size) != size)
+			throw Common::Exception(Common::kReadError);
+
+		Common::MemoryReadStream stream(_data.get(), size);
+
+		if (stream.readUint32BE() != kCacheID)
+			throw Common::Exception("Not a resource index cache");
+
+		// A different version is not an error, we'll just overwrite it
+		if (stream.readUint32LE() != kVersion) {
+			_changed = true;
+			_data.reset();
+			return;
+		}
+
+		const uint32 count = stream.readUint32LE();
+		for (uint32 i = 0; i < count; i++) {
+			const Common::UString path = readCacheString(stream);
+			const uint32 entrySize = stream.readUint32LE();
+
+			if (entrySize > (stream.size() - stream.pos()))
+				throw Common::Exception(Common::kReadError);
+
+			_entries[path] = Entry(_data.get() + stream.pos(), entrySize);
+
+			stream.skip(entrySize);
+		}
+
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Failed to read the resource index cache \"%s\"", _file.c_str());
+
+		_entries.clear();
+		_data.reset();
+
+		_changed = true;
+	}
+}
+
+void ResourceIndexCache::save() {
+	if (_file.empty() || !_changed)
+		return;
+
+	try {
+		Common::MemoryWriteStreamDynamic cache(true);
+
+		cache.writeUint32BE(kCacheID);
+		cache.writeUint32LE(kVersion);
+
+		// Drop entries of files that don't exist anymore
+		std::vector<Entries::const_iterator> entries;
+		for (Entries::const_iterator e = _entries.begin(); e != _entries.end(); ++e)
+			if (Common::FilePath::isRegularFile(e->first))
+				entries.push_back(e);
+
+		cache.writeUint32LE(entries.size());
+		for (std::vector<Entries::const_iterator>::const_iterator e = entries.begin(); e != entries.end(); ++e) {
+			writeCacheString(cache, (*e)->first);
+
+			cache.writeUint32LE((*e)->second.size);
+			cache.write((*e)->second.data, (*e)->second.size);
+		}
+
+		const Common::UString directory = Common::FilePath::getDirectory(_file);
+		if (!directory.empty())
+			Common::FilePath::createDirectories(directory);
+
+		Common::WriteFile file;
+		if (!file.open(_file))
+			throw Common::Exception(Common::kOpenError);
+
+		if (file.write(cache.getData(), cache.size()) != cache.size())
+			throw Common::Exception(Common::kWriteError);
+
+		file.flush();
+		file.close();
+
+	} catch (Common::Exception &e) {
+		e.add("Failed to write the resource index cache \"%s\"", _file.c_str());
+		throw;
+	}
+
+	_changed = false;
+}
+
+void ResourceIndexCache::getFileStats(const Common::UString &path, uint64 &size, uint64 &time) {
+	size = 0;
+	time = 0;
+
+	if (!Common::FilePath::isRegularFile(path))
+		return;
+
+	size = Common::FilePath::getFileSize(path);
+	time = Common::FilePath::getModificationTime(path);
+}
+
+bool ResourceIndexCache::isUnchanged(const Common::UString &path, uint64 size, uint64 time) {
+	uint64 fileSize, fileTime;
+	getFileStats(path, fileSize, fileTime);
+
+	return (fileTime != 0) && (fileSize == size) && (fileTime == time);
+}
+
+bool ResourceIndexCache::find(const Common::UString &path, ArchiveIndices &archives) {
+	Entries::iterator entry = _entries.find(path);
+	if (entry == _entries.end())
+		return false;
+
+	if (readEntry(path, entry->second, archives))
+		return true;
+
+	// Broken or outdated, there's no point in keeping it around
+	_added.erase(path);
+	_entries.erase(entry);
+
+	_changed = true;
+	return false;
+}
+
+bool ResourceIndexCache::readEntry(const Common::UString &path, const Entry &entry, ArchiveIndices &archives) {
+	archives.clear();
+
+	try {
+		Common::MemoryReadStream stream(entry.data, entry.size);
+
+		const uint64 size = stream.readUint64LE();
+		const uint64 time = stream.readUint64LE();
+
+		if (!isUnchanged(path, size, time))
+			return false;
+
+		archives.resize(stream.readUint32LE());
+
+		// First check that all archive files are unchanged as well...
+		for (ArchiveIndices::iterator a = archives.begin(); a != archives.end(); ++a) {
+			a->path = readCacheString(stream);
+			a->size = stream.readUint64LE();
+			a->time = stream.readUint64LE();
+
+			if ((a->path != path) && !isUnchanged(a->path, a->size, a->time))
+				return false;
+		}
+
+		// ...before reading all their resources
+		for (ArchiveIndices::iterator a = archives.begin(); a != archives.end(); ++a) {
+			a->hashAlgo = (Common::HashAlgo) stream.readUint32LE();
+
+			const uint32 count = stream.readUint32LE();
+			if (count > (stream.size() - stream.pos()))
+				throw Common::Exception(Common::kReadError);
+
+			a->locations.resize(count);
+			for (uint32 i = 0; i < count; i++) {
+				a->resources.push_back(Archive::Resource());
+				Archive::Resource &resource = a->resources.back();
+
+				resource.name  = readCacheString(stream);
+				resource.hash  = stream.readUint64LE();
+				resource.type  = (FileType) stream.readUint32LE();
+				resource.index = stream.readUint32LE();
+
+				if (resource.index >= count)
+					throw Common::Exception("Resource index out of range (%u/%u)", resource.index, count);
+
+				a->locations[resource.index].offset = stream.readUint32LE();
+				a->locations[resource.index].size   = stream.readUint32LE();
+			}
+		}
+
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Broken resource index cache entry for \"%s\"", path.c_str());
+
+		archives.clear();
+		return false;
+	}
+
+	return true;
+}
+
+void ResourceIndexCache::writeEntry(Common::WriteStream &stream, uint64 size, uint64 time,
+                                    const ArchiveIndices &archives) {
+
+	stream.writeUint64LE(size);
+	stream.writeUint64LE(time);
+
+	stream.writeUint32LE(archives.size());
+	for (ArchiveIndices::const_iterator a = archives.begin(); a != archives.end(); ++a) {
+		writeCacheString(stream, a->path);
+
+		stream.writeUint64LE(a->size);
+		stream.writeUint64LE(a->time);
+	}
+
+	for (ArchiveIndices::const_iterator a = archives.begin(); a != archives.end(); ++a) {
+		stream.writeUint32LE((uint32) a->hashAlgo);
+
+		stream.writeUint32LE(a->resources.size());
+		for (Archive::ResourceList::const_iterator r = a->resources.begin(); r != a->resources.end(); ++r) {
+			writeCacheString(stream, r->name);
+
+			stream.writeUint64LE(r->hash);
+			stream.writeUint32LE((uint32) r->type);
+			stream.writeUint32LE(r->index);
+
+			stream.writeUint32LE(a->locations[r->index].offset);
+			stream.writeUint32LE(a->locations[r->index].size);
+		}
+	}
+}
+
+void ResourceIndexCache::add(const Common::UString &path, const ArchiveIndices &archives) {
+	uint64 size, time;
+	getFileStats(path, size, time);
+
+	if (time == 0)
+		return;
+
+	Common::MemoryWriteStreamDynamic stream(true);
+	writeEntry(stream, size, time, archives);
+
+	std::vector<byte> &data = _added[path];
+	data.assign(stream.getData(), stream.getData() + stream.size());
+
+	_entries[path] = Entry(data.empty() ? 0 : &data[0], data.size());
+
+	_changed = true;
+}
+
+bool ResourceIndexCache::createIndex(const Archive &archive, const Common::UString &path, ArchiveIndex &index) {
+	const Archive::ResourceList &resources = archive.getResources();
+
+	index.path     = path;
+	index.hashAlgo = archive.getNameHashAlgo();
+
+	getFileStats(path, index.size, index.time);
+	if (index.time == 0)
+		return false;
+
+	index.resources.clear();
+	index.locations.clear();
+	index.locations.resize(resources.size());
+
+	for (Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+		if (r->index >= resources.size())
+			return false;
+
+		CachedArchive::Location &location = index.locations[r->index];
+		if (!archive.getResourceLocation(r->index, location.offset, location.size))
+			return false;
+	}
+
+	index.resources = resources;
+	return true;
+}
+
+} // End of namespace Aurora
@@ -0,0 +1,202 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A persistent cache of archive indices.
+ */
+
+#ifndef AURORA_RESINDEXCACHE_H
+#define AURORA_RESINDEXCACHE_H
+
+#include <vector>
+#include <map>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ustring.h"
+#include "src/common/hash.h"
+
+#include "src/aurora/archive.h"
+
+namespace Common {
+	class SeekableReadStream;
+	class WriteStream;
+}
+
+namespace Aurora {
+
+/** An archive whose index was read out of a ResourceIndexCache.
+ *
+ *  It knows all the resources and where their data can be found
+ *  within the archive file, so the archive file itself is never
+ *  parsed. See Archive::getResourceLocation().
+ */
+class CachedArchive : public Archive {
+public:
+	/** Where a resource's data can be found within the archive file. */
+	struct Location {
+		uint32 offset;
+		uint32 size;
+
+		Location(uint32 o = 0, uint32 s = 0) : offset(o), size(s) { }
+	};
+
+	/** The locations of all resources, indexed by the resources' indices. */
+	typedef std::vector<Location> Locations;
+
+	/** Take over this archive stream.
+	 *
+	 *  The contents of resources and locations are taken over as well,
+	 *  leaving the parameters empty.
+	 */
+	CachedArchive(Common::SeekableReadStream *archive, Common::HashAlgo hashAlgo,
+	              ResourceList &resources, Locations &locations);
+	~CachedArchive();
+
+	/** Return the list of resources. */
+	const ResourceList &getResources() const;
+
+	/** Return the size of a resource. */
+	uint32 getResourceSize(uint32 index) const;
+
+	/** Return a stream of the resource's contents. */
+	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
+
+	/** Return where the resource's data can be found within the archive. */
+	bool getResourceLocation(uint32 index, uint32 &offset, uint32 &size) const;
+
+	/** Return with which algorithm the name is hashed. */
+	Common::HashAlgo getNameHashAlgo() const;
+
+private:
+	Common::ScopedPtr<Common::SeekableReadStream> _archive;
+
+	Common::HashAlgo _hashAlgo;
+
+	ResourceList _resources;
+	Locations    _locations;
+
+	const Location &getLocation(uint32 index) const;
+};
+
+/** A persistent cache of archive indices.
+ *
+ *  Parsing the indices of all the archives of a game, their headers
+ *  and resource tables, takes quite some time. This cache remembers
+ *  them in a single file, together with the size and modification
+ *  time of the archive files, so that unchanged archives can be
+ *  indexed again without touching them.
+ *
+ *  Each entry in the cache belongs to the file that was indexed, and
+ *  holds the indices of all archives that produced. For most archives,
+ *  that's the archive itself. For a KEY, that's all its BIFs.
+ *
+ *  The cache file is read in one go, but an entry is only parsed, and
+ *  its files checked for changes, when it's looked up.
+ */
+class ResourceIndexCache : boost::noncopyable {
+public:
+	/** The cached index of one archive. */
+	struct ArchiveIndex {
+		Common::UString path; ///< The path of the archive file.
+
+		uint64 size; ///< The size of the archive file.
+		uint64 time; ///< The modification time of the archive file.
+
+		Common::HashAlgo hashAlgo; ///< The algorithm the names are hashed with.
+
+		Archive::ResourceList    resources; ///< All resources in the archive.
+		CachedArchive::Locations locations; ///< Where to find the resources' data.
+
+		ArchiveIndex();
+	};
+
+	typedef std::vector<ArchiveIndex> ArchiveIndices;
+
+	ResourceIndexCache();
+	~ResourceIndexCache();
+
+	/** Clear the cache and forget about its file. */
+	void clear();
+
+	/** Read the cache out of this file.
+	 *
+	 *  A missing file is not an error: the cache then starts out empty.
+	 *  A broken file is ignored with a warning.
+	 */
+	void load(const Common::UString &file);
+
+	/** Write the cache back into the file it was loaded from, if it changed. */
+	void save();
+
+	/** Look up the archive indices produced by indexing this file.
+	 *
+	 *  Only succeeds if this file, and all the archive files,
+	 *  haven't changed since they were cached.
+	 */
+	bool find(const Common::UString &path, ArchiveIndices &archives);
+
+	/** Remember the archive indices produced by indexing this file. */
+	void add(const Common::UString &path, const ArchiveIndices &archives);
+
+	/** Create the index of an archive, if it can be cached.
+	 *
+	 *  @param  archive The archive to create an index of.
+	 *  @param  path The path of the archive file.
+	 *  @param  index The index to fill.
+	 *  @return true if the index was created, false if the archive can't be cached.
+	 */
+	static bool createIndex(const Archive &archive, const Common::UString &path, ArchiveIndex &index);
+
+private:
+	/** The raw data of one cache entry. */
+	struct Entry {
+		const byte *data;
+		size_t size;
+
+		Entry(const byte *d = 0, size_t s = 0) : data(d), size(s) { }
+	};
+
+	typedef std::map<Common::UString, Entry> Entries;
+	typedef std::map<Common::UString, std::vector<byte> > AddedEntries;
+
+	Common::UString _file;
+
+	/** The contents of the cache file. */
+	Common::ScopedArray<byte> _data;
+
+	Entries      _entries; ///< All entries, pointing into _data or _added.
+	AddedEntries _added;   ///< The data of entries added since loading.
+
+	bool _changed;
+
+	static bool readEntry(const Common::UString &path, const Entry &entry, ArchiveIndices &archives);
+	static void writeEntry(Common::WriteStream &stream, uint64 size, uint64 time, const ArchiveIndices &archives);
+
+	/** Does this file still have this size and modification time? */
+	static bool isUnchanged(const Common::UString &path, uint64 size, uint64 time);
+	static void getFileStats(const Common::UString &path, uint64 &size, uint64 &time);
+};
+
+} // End of namespace Aurora
+
+#endif // AURORA_RESINDEXCACHE_H
@@ -24,18 +24,24 @@
 
 #include <cassert>
 
+#include <exception>
+#include <functional>
+
 #include <boost/scope_exit.hpp>
 
 #include "src/common/util.h"
 #include "src/common/scopedptr.h"
 #include "src/common/error.h"
+#include "src/common/encoding.h"
 #include "src/common/readstream.h"
 #include "src/common/filepath.h"
 #include "src/common/readfile.h"
 #include "src/common/writefile.h"
+#include "src/common/threads.h"
 
 #include "src/aurora/resman.h"
 #include "src/aurora/util.h"
+#include "src/aurora/language.h"
 
 #include "src/aurora/keyfile.h"
 #include "src/aurora/keydatafile.h"
@@ -49,6 +55,7 @@
 #include "src/aurora/herffile.h"
 #include "src/aurora/nsbtxfile.h"
 #include "src/aurora/smallfile.h"
+#include "src/aurora/resindexcache.h"
 
 // Check for hash collisions (if possible)
 #define CHECK_HASH_COLLISION 1
@@ -95,6 +102,17 @@ void ResourceManager::OpenedArchive::set(KnownArchive &kA, Archive &a) {
 }
 
 
+ResourceManager::BatchArchive::BatchArchive(const Common::UString &f, uint32 p, bool o,
+                                            Common::ChangeID *c) :
+	file(f), priority(p), optional(o), changeID(c) {
+
+}
+
+
+ResourceManager::ParsedArchive::ParsedArchive() : cached(false) {
+}
+
+
 ResourceManager::Resource::Resource() : type(kFileTypeNone), isSmall(false), priority(0),
 		source(kSourceNone), archive(0), archiveIndex(0xFFFFFFFF) {
 
@@ -106,7 +124,7 @@ bool ResourceManager::Resource::operator<(const Resource &right) const {
 }
 
 
-ResourceManager::ResourceManager() : _hasSmall(false),
+ResourceManager::ResourceManager() : _hasSmall(false), _parallelIndexing(true),
 	_hashAlgo(Common::kHashFNV64) {
 
 	// These file types are archives
@@ -178,7 +196,10 @@ ResourceManager::~ResourceManager() {
 void ResourceManager::clear() {
 	_typeAliases.clear();
 
+	_indexCache.reset();
+
 	_hasSmall = false;
+	_parallelIndexing = true;
 	_hashAlgo = Common::kHashFNV64;
 
 	setRIMsAreERFs(false);
@@ -224,6 +245,10 @@ void ResourceManager::setHasSmall(bool hasSmall) {
 	_hasSmall = hasSmall;
 }
 
+void ResourceManager::setParallelIndexing(bool parallel) {
+	_parallelIndexing = parallel;
+}
+
 void ResourceManager::setHashAlgo(Common::HashAlgo algo) {
 	if ((algo != _hashAlgo) && !_resources.empty())
 		throw Common::Exception("ResourceManager::setHashAlgo(): We already have resources!");
@@ -290,6 +315,17 @@ ResourceManager::KnownArchive *ResourceManager::findArchive(Common::UString file
 	return 0;
 }
 
+ResourceManager::KnownArchive &ResourceManager::findIndexableArchive(const Common::UString &file) {
+	KnownArchive *knownArchive = findArchive(file);
+	if (!knownArchive)
+		throw Common::Exception("No such archive file \"%s\"", file.c_str());
+
+	if (knownArchive->type == kArchiveBIF)
+		throw Common::Exception("Attempted to index a lone BIF");
+
+	return *knownArchive;
+}
+
 bool ResourceManager::hasArchive(const Common::UString &file) {
 	return findArchive(file) != 0;
 }
@@ -301,27 +337,223 @@ Common::SeekableReadStream *ResourceManager::openArchiveStream(const KnownArchiv
 	return getResource(*archive.resource, true);
 }
 
+void ResourceManager::setIndexCache(const Common::UString &file) {
+	_indexCache.reset(new ResourceIndexCache);
+	_indexCache->load(file);
+}
+
+void ResourceManager::saveIndexCache() {
+	if (!_indexCache)
+		return;
+
+	try {
+		_indexCache->save();
+	} catch (...) {
+		Common::exceptionDispatcherWarning();
+	}
+}
+
+Common::UString ResourceManager::getArchivePath(const KnownArchive &archive) {
+	if (!archive.resource || (archive.resource->source != kSourceFile))
+		return "";
+
+	return archive.resource->path;
+}
+
+bool ResourceManager::openCachedArchive(KnownArchive &knownArchive, ParsedArchive &parsed) {
+	const Common::UString path = getArchivePath(knownArchive);
+	if (!_indexCache || path.empty())
+		return false;
+
+	ResourceIndexCache::ArchiveIndices indices;
+	if (!_indexCache->find(path, indices))
+		return false;
+
+	// Find the archives again. A KEY produces all of its BIFs, other archives just themselves
+	std::vector<KnownArchive *> archives;
+	for (ResourceIndexCache::ArchiveIndices::const_iterator i = indices.begin(); i != indices.end(); ++i) {
+		KnownArchive *archive = 0;
+
+		if (knownArchive.type == kArchiveKEY) {
+			KnownArchives &bifs = _knownArchives[kArchiveBIF];
+
+			for (KnownArchives::iterator b = bifs.begin(); b != bifs.end(); ++b) {
+				if (getArchivePath(*b) == i->path) {
+					archive = &*b;
+					break;
+				}
+			}
+
+		} else if (i->path == path)
+			archive = &knownArchive;
+
+		if (!archive)
+			return false;
+
+		archives.push_back(archive);
+	}
+
+	for (size_t i = 0; i < indices.size(); i++) {
+		parsed.archives.push_back(archives[i]);
+		parsed.parsed.push_back(new CachedArchive(openArchiveStream(*archives[i]), indices[i].hashAlgo,
+		                                          indices[i].resources, indices[i].locations));
+	}
+
+	parsed.cached = true;
+	return true;
+}
+
+void ResourceManager::addToIndexCache(const KnownArchive &knownArchive, const std::vector<KnownArchive *> &archives,
+                                      const std::vector<const Archive *> &parsed) {
+
+	const Common::UString path = getArchivePath(knownArchive);
+	if (!_indexCache || path.empty())
+		return;
+
+	assert(archives.size() == parsed.size());
+
+	ResourceIndexCache::ArchiveIndices indices;
+	indices.resize(archives.size());
+
+	for (size_t i = 0; i < archives.size(); i++) {
+		const Common::UString archivePath = getArchivePath(*archives[i]);
+		if (archivePath.empty() || !ResourceIndexCache::createIndex(*parsed[i], archivePath, indices[i]))
+			return;
+	}
+
+	_indexCache->add(path, indices);
+}
+
 void ResourceManager::indexArchive(const Common::UString &file, uint32 priority,
                                    const std::vector<byte> &password, Common::ChangeID *changeID) {
 
-	KnownArchive *knownArchive = findArchive(file);
-	if (!knownArchive)
-		throw Common::Exception("No such archive file \"%s\"", file.c_str());
-
-	if (knownArchive->type == kArchiveBIF)
-		throw Common::Exception("Attempted to index a lone BIF");
+	KnownArchive &knownArchive = findIndexableArchive(file);
 
 	Change *change = 0;
 	if (changeID)
 		change = newChangeSet(*changeID);
 
-	Common::SeekableReadStream *archiveStream = openArchiveStream(*knownArchive);
+	ParsedArchive parsed;
+	if (!openCachedArchive(knownArchive, parsed))
+		parseArchive(knownArchive, password, parsed, _parallelIndexing);
+
+	indexParsedArchive(knownArchive, parsed, priority, change);
+}
+
+void ResourceManager::indexArchive(const Common::UString &file, uint32 priority, Common::ChangeID *changeID) {
+	std::vector<byte> password;
+
+	indexArchive(file, priority, password, changeID);
+}
+
+size_t ResourceManager::indexArchives(const BatchArchives &archives) {
+	typedef std::pair<const BatchArchive *, KnownArchive *> RoundArchive;
+
+	// Create the global managers the archive parsers use, before several threads try to at once
+	TypeMan.getFileType("");
+	LangMan.getCurrentGender();
+	Common::hasSupportEncoding(Common::kEncodingUTF16LE);
+
+	size_t indexed = 0;
+
+	/* Archives can contain other archives, which we only know about once
+	 * the containing archive has been indexed. So we work in rounds: parse
+	 * all archives we already know about, index them in order, then start
+	 * the next round with the first archive we didn't know about yet. */
+
+	size_t next = 0;
+	while (next < archives.size()) {
+		std::vector<RoundArchive> round;
+
+		for (; next < archives.size(); next++) {
+			if (!findArchive(archives[next].file)) {
+				// Might be within one of the archives we're about to index
+				if (!round.empty())
+					break;
+
+				if (archives[next].optional)
+					continue;
+			}
+
+			round.push_back(RoundArchive(&archives[next], &findIndexableArchive(archives[next].file)));
+		}
+
+		Common::PtrVector<ParsedArchive> parsed;
+		std::vector<std::exception_ptr> errors(round.size());
+		std::vector<size_t> parallel;
+
+		// Look into the index cache, and parse what can't be parsed alongside others
+		for (size_t i = 0; i < round.size(); i++) {
+			parsed.push_back(new ParsedArchive);
+
+			try {
+				if (openCachedArchive(*round[i].second, *parsed[i]))
+					continue;
+
+				if (_parallelIndexing && canParseInParallel(*round[i].second))
+					parallel.push_back(i);
+				else
+					parseArchive(*round[i].second, round[i].first->password, *parsed[i], _parallelIndexing);
+
+			} catch (...) {
+				errors[i] = std::current_exception();
+			}
+		}
+
+		// Parse everything else in parallel
+		Common::runParallel(parallel.size(), [&](size_t p) {
+			const size_t i = parallel[p];
+
+			try {
+				parseArchive(*round[i].second, round[i].first->password, *parsed[i], parallel.size() == 1);
+			} catch (...) {
+				errors[i] = std::current_exception();
+			}
+		});
+
+		// Add the resources, in order
+		for (size_t i = 0; i < round.size(); i++) {
+			try {
+				Change *change = 0;
+				if (round[i].first->changeID)
+					change = newChangeSet(*round[i].first->changeID);
+
+				if (errors[i])
+					std::rethrow_exception(errors[i]);
+
+				indexParsedArchive(*round[i].second, *parsed[i], round[i].first->priority, change);
+
+			} catch (Common::Exception &e) {
+				e.add("Failed to index archive \"%s\"", round[i].first->file.c_str());
+				throw;
+			}
+
+			indexed++;
+		}
+	}
+
+	return indexed;
+}
+
+bool ResourceManager::canParseInParallel(const KnownArchive &knownArchive) {
+	/* Archives within other archives read from the stream of their parent,
+	 * and PE files fill our cursor remap table. Everything else only reads
+	 * its own file. */
+
+	return knownArchive.resource && (knownArchive.resource->source == kSourceFile) &&
+	       (knownArchive.type != kArchiveEXE);
+}
+
+void ResourceManager::parseArchive(KnownArchive &knownArchive, const std::vector<byte> &password,
+                                   ParsedArchive &parsed, bool parallel) {
+
+	Common::SeekableReadStream *archiveStream = openArchiveStream(knownArchive);
 
 	Common::ScopedPtr<Archive> archive;
-	switch (knownArchive->type) {
+	switch (knownArchive.type) {
 		case kArchiveKEY:
-			indexKEY(archiveStream, priority, change);
-			break;
+			openKEYBIFs(archiveStream, parsed, parallel);
+			return;
 
 		case kArchiveNDS:
 			archive.reset(new NDSFile(archiveStream));
@@ -352,66 +584,72 @@ void ResourceManager::indexArchive(const Common::UString &file, uint32 priority,
 			break;
 
 		default:
-			throw Common::Exception("Invalid archive type %d", knownArchive->type);
+			throw Common::Exception("Invalid archive type %d", knownArchive.type);
 	}
 
-	if (archive)
-		indexArchive(*knownArchive, archive.release(), priority, change);
-}
-
-void ResourceManager::indexArchive(const Common::UString &file, uint32 priority, Common::ChangeID *changeID) {
-	std::vector<byte> password;
-
-	indexArchive(file, priority, password, changeID);
+	parsed.archives.push_back(&knownArchive);
+	parsed.parsed.push_back(archive.release());
 }
 
-uint32 ResourceManager::openKEYBIFs(Common::SeekableReadStream *keyStream,
-                                    std::vector<KnownArchive *> &archives,
-                                    std::vector<KEYDataFile *> &keyData) {
-
-	bool success = false;
-	BOOST_SCOPE_EXIT( (&success) (&archives) (&keyData) ) {
-		if (!success) {
-			for (std::vector<KEYDataFile *>::iterator b = keyData.begin(); b != keyData.end(); ++b)
-				delete *b;
-
-			keyData.clear();
-			archives.clear();
-		}
-	} BOOST_SCOPE_EXIT_END
-
+void ResourceManager::openKEYBIFs(Common::SeekableReadStream *keyStream, ParsedArchive &parsed, bool parallel) {
 	Common::ScopedPtr<Common::SeekableReadStream> stream(keyStream);
 	KEYFile key(*keyStream);
 
 	const KEYFile::BIFList &keyBIFs = key.getBIFs();
-	archives.resize(keyBIFs.size(), 0);
-	keyData.resize(keyBIFs.size(), 0);
 
-	for (uint32 i = 0; i < keyBIFs.size(); i++) {
+	std::vector<KnownArchive *> archives(keyBIFs.size(), 0);
+	for (size_t i = 0; i < keyBIFs.size(); i++) {
 		archives[i] = findArchive(keyBIFs[i], _knownArchives[kArchiveBIF]);
 		if (!archives[i])
 			throw Common::Exception("BIF \"%s\" not found", keyBIFs[i].c_str());
 
+		parallel = parallel && canParseInParallel(*archives[i]);
+	}
+
+	Common::PtrVector<KEYDataFile> keyData;
+	keyData.resize(archives.size(), 0);
+
+	const std::function<void(size_t)> openBIF = [&](size_t i) {
 		if (Common::FilePath::getExtension(archives[i]->name).equalsIgnoreCase(".bzf"))
 			keyData[i] = new BZFFile(openArchiveStream(*archives[i]));
 		else
 			keyData[i] = new BIFFile(openArchiveStream(*archives[i]));
 
 		keyData[i]->mergeKEY(key, i);
+	};
+
+	// Every BIF only reads its own file, so they can all be parsed at once
+	if (parallel) {
+		Common::runParallel(archives.size(), openBIF);
+	} else {
+		for (size_t i = 0; i < archives.size(); i++)
+			openBIF(i);
 	}
 
-	success = true;
-	return archives.size();
+	for (size_t i = 0; i < archives.size(); i++) {
+		parsed.archives.push_back(archives[i]);
+		parsed.parsed.push_back(keyData[i]);
+
+		keyData[i] = 0;
+	}
 }
 
-void ResourceManager::indexKEY(Common::SeekableReadStream *stream, uint32 priority, Change *change) {
-	std::vector<KnownArchive *> archives;
-	std::vector<KEYDataFile *> keyData;
+void ResourceManager::indexParsedArchive(const KnownArchive &knownArchive, ParsedArchive &parsed,
+                                         uint32 priority, Change *change) {
+
+	assert(parsed.archives.size() == parsed.parsed.size());
+
+	if (!parsed.cached)
+		addToIndexCache(knownArchive, parsed.archives,
+		                std::vector<const Archive *>(parsed.parsed.begin(), parsed.parsed.end()));
 
-	const uint32 count = openKEYBIFs(stream, archives, keyData);
+	for (size_t i = 0; i < parsed.parsed.size(); i++) {
+		// indexArchive() takes over the archive
+		Archive *archive = parsed.parsed[i];
+		parsed.parsed[i] = 0;
 
-	for (uint32 i = 0; i < count; i++)
-		indexArchive(*archives[i], keyData[i], priority, change);
+		indexArchive(*parsed.archives[i], archive, priority, change);
+	}
 }
 
 void ResourceManager::indexArchive(KnownArchive &knownArchive, Archive *archive,
@@ -625,9 +863,7 @@ void ResourceManager::declareResource(const Common::UString &name, FileType type
 	ResourceMap::iterator resList = _resources.find(getHash(name, type));
 	if (resList == _resources.end()) {
 		if (_hasSmall) {
-			Common::UString smallName = TypeMan.addFileType(TypeMan.setFileType(name, type), kFileTypeSMALL);
-
-			resList = _resources.find(getHash(smallName));
+			resList = _resources.find(getSmallHash(name, type));
 			isSmall = true;
 		}
 
@@ -649,11 +885,7 @@ void ResourceManager::declareResource(const Common::UString &name) {
 }
 
 bool ResourceManager::hasResource(const Common::UString &name, FileType type) const {
-	std::vector<FileType> types;
-
-	types.push_back(type);
-
-	return hasResource(name, types);
+	return getRes(name, type) != 0;
 }
 
 bool ResourceManager::hasResource(const Common::UString &name, ResourceType type) const {
@@ -675,11 +907,11 @@ bool ResourceManager::hasResource(uint64 hash) const {
 }
 
 Common::UString ResourceManager::findResourceFile(const Common::UString &name, FileType type) const {
-	std::vector<FileType> types;
-
-	types.push_back(type);
+	const Resource *res = getRes(name, type);
+	if (res && (res->source == kSourceFile))
+		return res->path;
 
-	return findResourceFile(name, types);
+	return "";
 }
 
 Common::UString ResourceManager::findResourceFile(const Common::UString &name, ResourceType type) const {
@@ -723,11 +955,11 @@ Common::SeekableReadStream *ResourceManager::getArchiveResource(const Resource &
 }
 
 Common::SeekableReadStream *ResourceManager::getResource(const Common::UString &name, FileType type) const {
-	std::vector<FileType> types;
-
-	types.push_back(type);
+	const Resource *res = getRes(name, type);
+	if (!res)
+		return 0;
 
-	return getResource(name, types);
+	return getResource(*res);
 }
 
 Common::SeekableReadStream *ResourceManager::getResource(const Common::UString &name) const {
@@ -893,12 +1125,29 @@ bool ResourceManager::normalizeType(Resource &resource) {
 	return true;
 }
 
+uint64 ResourceManager::getResourceHash(const Common::UString &name, FileType type) const {
+	return getHash(name, type);
+}
+
 inline uint64 ResourceManager::getHash(const Common::UString &name, FileType type) const {
-	return getHash(TypeMan.setFileType(name, type));
+	Common::Hasher hasher(_hashAlgo);
+
+	TypeMan.hashFileName(hasher, name, type);
+
+	return hasher.getHash();
+}
+
+inline uint64 ResourceManager::getSmallHash(const Common::UString &name, FileType type) const {
+	Common::Hasher hasher(_hashAlgo);
+
+	TypeMan.hashFileName(hasher, name, type);
+	TypeMan.hashFileType(hasher, kFileTypeSMALL);
+
+	return hasher.getHash();
 }
 
 inline uint64 ResourceManager::getHash(const Common::UString &name) const {
-	return Common::hashString(name.toLower(), _hashAlgo);
+	return Common::hashStringLower(name, _hashAlgo);
 }
 
 void ResourceManager::checkHashCollision(const Resource &resource, ResourceMap::const_iterator resList) {
@@ -1023,19 +1272,17 @@ const ResourceManager::Resource *ResourceManager::getRes(uint64 hash) const {
 }
 
 const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &name,
-		const std::vector<FileType> &types) const {
+		const FileType *types, size_t typeCount) const {
 
 	const Resource *result = 0;
-	for (std::vector<FileType>::const_iterator type = types.begin(); type != types.end(); ++type) {
-		const Resource *res = getRes(getHash(name, *type));
+	for (size_t i = 0; i < typeCount; i++) {
+		const Resource *res = getRes(getHash(name, types[i]));
 		if (res && (!result || *result < *res))
 			result = res;
 	}
 	if (!result && _hasSmall) {
-		for (std::vector<FileType>::const_iterator type = types.begin(); type != types.end(); ++type) {
-			Common::UString smallName = TypeMan.addFileType(TypeMan.setFileType(name, *type), kFileTypeSMALL);
-
-			const Resource *res = getRes(getHash(smallName));
+		for (size_t i = 0; i < typeCount; i++) {
+			const Resource *res = getRes(getSmallHash(name, types[i]));
 			if (res && (!result || *result < *res))
 				result = res;
 		}
@@ -1044,10 +1291,17 @@ const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &
 	return result;
 }
 
-const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &name, FileType type) const {
-	std::vector<FileType> types(1, type);
+const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &name,
+		const std::vector<FileType> &types) const {
 
-	return getRes(name, types);
+	if (types.empty())
+		return 0;
+
+	return getRes(name, &types[0], types.size());
+}
+
+const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &name, FileType type) const {
+	return getRes(name, &type, 1);
 }
 
 void ResourceManager::dumpResourcesList(const Common::UString &fileName) const {
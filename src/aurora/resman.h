@@ -30,7 +30,11 @@
 #include <map>
 #include <set>
 
+#include <boost/noncopyable.hpp>
+
 #include "src/common/types.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
 #include "src/common/ustring.h"
 #include "src/common/singleton.h"
 #include "src/common/filelist.h"
@@ -48,6 +52,7 @@ namespace Aurora {
 class Archive;
 class KEYFile;
 class KEYDataFile;
+class ResourceIndexCache;
 
 /** A resource manager holding information about and handling all request for all
  *  resources usable by the game.
@@ -79,6 +84,13 @@ public:
 	/** Set the array used to map cursor ID to cursor names. */
 	void setCursorRemap(const std::vector<Common::UString> &remap);
 
+	/** Should archives be parsed on several threads at once?
+	 *
+	 *  The resources are always added in the same order, so this does
+	 *  not change which resources are found. Enabled by default.
+	 */
+	void setParallelIndexing(bool parallel);
+
 	/** Add an alias for one file type to another.
 	 *
 	 *  @param alias The type to alias.
@@ -139,6 +151,50 @@ public:
 	 */
 	void indexArchive(const Common::UString &file, uint32 priority, const std::vector<byte> &password,
 	                  Common::ChangeID *changeID = 0);
+
+	/** An archive to index with indexArchives(). */
+	struct BatchArchive {
+		Common::UString file; ///< The name of the archive file.
+		uint32 priority;      ///< The priority the archive's resources have.
+
+		/** Silently skip this archive if it does not exist? */
+		bool optional;
+
+		/** Use this password to decrypt the archive file, if necessary. */
+		std::vector<byte> password;
+
+		/** If given, record the collective changes done by this archive here. */
+		Common::ChangeID *changeID;
+
+		BatchArchive(const Common::UString &f, uint32 p, bool o = false, Common::ChangeID *c = 0);
+	};
+
+	typedef std::vector<BatchArchive> BatchArchives;
+
+	/** Add all the resources of several archives to the resource manager.
+	 *
+	 *  The archives are parsed in parallel, but their resources are added
+	 *  in order, so this has the exact same result as calling indexArchive()
+	 *  on each of the archives, one after the other.
+	 *
+	 *  @param archives The archives to index.
+	 *  @return The number of archives that were indexed.
+	 */
+	size_t indexArchives(const BatchArchives &archives);
+	// '---
+
+	// .--- Index cache
+	/** Use this file as a persistent cache of archive indices.
+	 *
+	 *  Archives found in the cache, and unchanged since, are indexed out
+	 *  of the cache instead of being parsed again. Only archives that are
+	 *  files on disk, with all resources stored neither compressed nor
+	 *  encrypted, can be cached.
+	 */
+	void setIndexCache(const Common::UString &file);
+
+	/** Write the index cache back into its file, if it changed. */
+	void saveIndexCache();
 	// '---
 
 	// .--- Directories and files
@@ -208,6 +264,13 @@ public:
 	// '---
 
 	// .--- Resources
+	/** Return the hash of a resource's name and type.
+	 *
+	 *  Callers looking up the same resource over and over again can
+	 *  hash it once, and use the lookup functions taking a hash.
+	 */
+	uint64 getResourceHash(const Common::UString &name, FileType type) const;
+
 	/** Does a specific resource exist?
 	 *
 	 *  @param  hash The hash of the name and extension of the resource.
@@ -474,6 +537,9 @@ private:
 	/** Do we have "small" files? */
 	bool _hasSmall;
 
+	/** Should archives be parsed on several threads at once? */
+	bool _parallelIndexing;
+
 	/** With which hash algorithm are/should the names be hashed? */
 	Common::HashAlgo _hashAlgo;
 
@@ -497,18 +563,47 @@ private:
 	FileTypeSet  _archiveTypeTypes [kArchiveMAX];  ///< All valid archive types file types.
 	FileTypeList _resourceTypeTypes[kResourceMAX]; ///< All valid resource type file types.
 
+	/** The persistent cache of archive indices, if we have one. */
+	Common::ScopedPtr<ResourceIndexCache> _indexCache;
+
 
 	void clearResources();
 
 	// .--- Searching for archives
 	KnownArchive *findArchive(const Common::UString &file);
 	KnownArchive *findArchive(Common::UString file, KnownArchives &archives);
+
+	/** Find an archive that can be indexed, or throw. */
+	KnownArchive &findIndexableArchive(const Common::UString &file);
 	// '---
 
 	// .--- Indexing archives
-	void indexKEY(Common::SeekableReadStream *stream, uint32 priority, Change *change);
-	uint32 openKEYBIFs(Common::SeekableReadStream *keyStream,
-	                   std::vector<KnownArchive *> &archives, std::vector<KEYDataFile *> &keyData);
+	/** The archives produced by opening an archive, ready to be indexed.
+	 *
+	 *  For most archives, that's just the archive itself. For a KEY,
+	 *  that's all of its BIFs.
+	 */
+	struct ParsedArchive : boost::noncopyable {
+		std::vector<KnownArchive *> archives; ///< The archive files.
+		Common::PtrVector<Archive>  parsed;   ///< The parsed archives.
+
+		/** Were the archives taken from the index cache? */
+		bool cached;
+
+		ParsedArchive();
+	};
+
+	/** Can this archive be parsed alongside others, in another thread? */
+	static bool canParseInParallel(const KnownArchive &knownArchive);
+
+	/** Parse the archive and all archives it produces. */
+	void parseArchive(KnownArchive &knownArchive, const std::vector<byte> &password,
+	                  ParsedArchive &parsed, bool parallel);
+	void openKEYBIFs(Common::SeekableReadStream *keyStream, ParsedArchive &parsed, bool parallel);
+
+	/** Add the resources of all parsed archives. */
+	void indexParsedArchive(const KnownArchive &knownArchive, ParsedArchive &parsed,
+	                        uint32 priority, Change *change);
 
 	void indexArchive(KnownArchive &knownArchive, Archive *archive,
 	                  uint32 priority, Change *change);
@@ -516,6 +611,17 @@ private:
 	Common::SeekableReadStream *openArchiveStream(const KnownArchive &archive) const;
 	// '---
 
+	// .--- Index cache
+	/** Return the path of the archive file, or "" if it's not a file on disk. */
+	static Common::UString getArchivePath(const KnownArchive &archive);
+
+	/** Open the archives produced by indexing this archive out of the index cache. */
+	bool openCachedArchive(KnownArchive &knownArchive, ParsedArchive &parsed);
+	/** Add the archives produced by indexing this archive to the index cache. */
+	void addToIndexCache(const KnownArchive &knownArchive, const std::vector<KnownArchive *> &archives,
+	                     const std::vector<const Archive *> &parsed);
+	// '---
+
 	// .--- Adding resources
 
 	bool checkResourceIsArchive(Resource &resource, Change *change);
@@ -528,6 +634,7 @@ private:
 
 	// .--- Finding and getting resources
 	const Resource *getRes(uint64 hash) const;
+	const Resource *getRes(const Common::UString &name, const FileType *types, size_t typeCount) const;
 	const Resource *getRes(const Common::UString &name, const std::vector<FileType> &types) const;
 	const Resource *getRes(const Common::UString &name, FileType type) const;
 
@@ -547,6 +654,8 @@ private:
 
 	inline uint64 getHash(const Common::UString &name, FileType type) const;
 	inline uint64 getHash(const Common::UString &name) const;
+	/** Return the hash of the "small" version of a resource, name.type.small. */
+	inline uint64 getSmallHash(const Common::UString &name, FileType type) const;
 
 	void checkHashCollision(const Resource &resource, ResourceMap::const_iterator resList);
 
@@ -105,6 +105,15 @@ uint32 RIMFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+bool RIMFile::getResourceLocation(uint32 index, uint32 &offset, uint32 &size) const {
+	const IResource &res = getIResource(index);
+
+	offset = res.offset;
+	size   = res.size;
+
+	return true;
+}
+
 Common::SeekableReadStream *RIMFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
@@ -73,6 +73,9 @@ public:
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Return where the resource's data can be found within the RIM. */
+	bool getResourceLocation(uint32 index, uint32 &offset, uint32 &size) const;
+
 private:
 	/** Internal resource information. */
 	struct IResource {
@@ -39,6 +39,7 @@ src_aurora_libaurora_la_SOURCES += \
     src/aurora/ndsrom.h \
     src/aurora/zipfile.h \
     src/aurora/resman.h \
+    src/aurora/resindexcache.h \
     src/aurora/talktable.h \
     src/aurora/talktable_tlk.h \
     src/aurora/talktable_gff.h \
@@ -87,6 +88,7 @@ src_aurora_libaurora_la_SOURCES += \
     src/aurora/ndsrom.cpp \
     src/aurora/zipfile.cpp \
     src/aurora/resman.cpp \
+    src/aurora/resindexcache.cpp \
     src/aurora/talktable.cpp \
     src/aurora/talktable_tlk.cpp \
     src/aurora/talktable_gff.cpp \
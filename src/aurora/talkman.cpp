@@ -155,6 +155,20 @@ const Common::UString &TalkManager::getSoundResRef(uint32 strRef, LanguageGender
 	return table->getSoundResRef(strRef);
 }
 
+Common::StringView TalkManager::getStringView(uint32 strRef, LanguageGender gender) {
+	if (gender == kLanguageGenderCurrent)
+		gender = LangMan.getCurrentGender();
+
+	if (strRef == kStrRefInvalid)
+		return Common::StringView();
+
+	const TalkTable *table = find(strRef, gender);
+	if (!table)
+		return Common::StringView();
+
+	return table->getStringView(strRef);
+}
+
 const TalkTable *TalkManager::find(const Tables &tables, uint32 strRef, LanguageGender gender) const {
 	/* Look for the strRef in decreasing priority.
 	 *
@@ -31,6 +31,7 @@
 #include "src/common/ustring.h"
 #include "src/common/singleton.h"
 #include "src/common/changeid.h"
+#include "src/common/stringarena.h"
 
 #include "src/aurora/language.h"
 
@@ -63,6 +64,12 @@ public:
 	const Common::UString &getString     (uint32 strRef, LanguageGender gender = kLanguageGenderCurrent);
 	const Common::UString &getSoundResRef(uint32 strRef, LanguageGender gender = kLanguageGenderCurrent);
 
+	/** Return a view of a string, without creating a UString for it.
+	 *
+	 *  The view stays valid as long as the talk table containing the string.
+	 */
+	Common::StringView getStringView(uint32 strRef, LanguageGender gender = kLanguageGenderCurrent);
+
 private:
 	struct Table {
 		uint32 id;
@@ -22,9 +22,13 @@
  *  Base class for BioWare's talk tables.
  */
 
+#include <vector>
+
 #include "src/common/util.h"
 #include "src/common/scopedptr.h"
 #include "src/common/readstream.h"
+#include "src/common/encoding.h"
+#include "src/common/threads.h"
 
 #include "src/aurora/aurorafile.h"
 #include "src/aurora/talktable.h"
@@ -42,6 +46,36 @@ TalkTable::TalkTable(Common::Encoding encoding) : _encoding(encoding) {
 TalkTable::~TalkTable() {
 }
 
+void TalkTable::prewarm(size_t count, const std::function<uint32(size_t)> &strRef) const {
+	if (count == 0)
+		return;
+
+	// Make sure the encoding conversion is set up before the threads start using it
+	if (_encoding != Common::kEncodingInvalid)
+		Common::hasSupportEncoding(_encoding);
+
+	Common::runParallel(count, [this, &strRef](size_t i) {
+		try {
+			getStringView(strRef(i));
+		} catch (...) {
+			// The error will resurface when the string is actually requested
+		}
+	});
+}
+
+void TalkTable::prewarm(uint32 strRef, uint32 count) const {
+	count = MIN<uint32>(count, 0xFFFFFFFF - strRef);
+
+	prewarm(count, [strRef](size_t i) { return strRef + (uint32) i; });
+}
+
+void TalkTable::prewarm() const {
+	std::vector<uint32> strRefs;
+	getStrRefs(strRefs);
+
+	prewarm(strRefs.size(), [&strRefs](size_t i) { return strRefs[i]; });
+}
+
 TalkTable *TalkTable::load(Common::SeekableReadStream *tlk, Common::Encoding encoding) {
 	Common::ScopedPtr<Common::SeekableReadStream> tlkStream(tlk);
 	if (!tlkStream)
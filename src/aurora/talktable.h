@@ -25,10 +25,14 @@
 #ifndef AURORA_TALKTABLE_H
 #define AURORA_TALKTABLE_H
 
+#include <vector>
+#include <functional>
+
 #include <boost/noncopyable.hpp>
 
 #include "src/common/types.h"
 #include "src/common/encoding.h"
+#include "src/common/stringarena.h"
 
 namespace Common {
 	class UString;
@@ -48,6 +52,11 @@ namespace Aurora {
  *
  *  See classes TalkTable_TLK and TalkTable_GFF for the two main
  *  formats a talk table can be found in.
+ *
+ *  Strings are decoded when they're first requested, into a string
+ *  arena shared by all strings of the talk table. getStringView()
+ *  returns the decoded string straight out of that arena, while
+ *  getString() additionally keeps a UString copy around.
  */
 class TalkTable : boost::noncopyable {
 public:
@@ -58,8 +67,24 @@ public:
 	virtual const Common::UString &getString     (uint32 strRef) const = 0;
 	virtual const Common::UString &getSoundResRef(uint32 strRef) const = 0;
 
+	/** Return a view of the string, valid as long as the talk table exists.
+	 *
+	 *  Unlike getString(), this doesn't create a UString for the string.
+	 *  Useful for callers that only need to measure or render the string.
+	 */
+	virtual Common::StringView getStringView(uint32 strRef) const = 0;
+
 	virtual uint32 getSoundID(uint32 strRef) const = 0;
 
+	/** Decode the strings of count entries, starting with strRef, ahead of time.
+	 *
+	 *  The work is split across the worker threads of Common::runParallel().
+	 *  No other thread may access the talk table while this is running.
+	 */
+	void prewarm(uint32 strRef, uint32 count) const;
+	/** Decode the strings of all entries ahead of time. See prewarm(uint32, uint32). */
+	void prewarm() const;
+
 	/** Take over this stream and read a talk table (of either format) out of it. */
 	static TalkTable *load(Common::SeekableReadStream *tlk, Common::Encoding encoding);
 
@@ -68,6 +93,15 @@ protected:
 	TalkTable(Common::Encoding encoding);
 
 	Common::Encoding _encoding;
+
+	/** The decoded strings of all entries. */
+	mutable Common::StringArena _strings;
+
+	/** Return the string references of all entries. */
+	virtual void getStrRefs(std::vector<uint32> &strRefs) const = 0;
+
+private:
+	void prewarm(size_t count, const std::function<uint32(size_t)> &strRef) const;
 };
 
 } // End of namespace Aurora
@@ -61,9 +61,23 @@ const Common::UString &TalkTable_GFF::getString(uint32 strRef) const {
 	if (e == _entries.end())
 		return kEmptyString;
 
+	Entry &entry = *e->second;
+
+	readString(entry);
+	if (entry.text.empty() && !entry.view.empty())
+		entry.text = entry.view.toString();
+
+	return entry.text;
+}
+
+Common::StringView TalkTable_GFF::getStringView(uint32 strRef) const {
+	Entries::iterator e = _entries.find(strRef);
+	if (e == _entries.end())
+		return Common::StringView();
+
 	readString(*e->second);
 
-	return e->second->text;
+	return e->second->view;
 }
 
 const Common::UString &TalkTable_GFF::getSoundResRef(uint32 UNUSED(strRef)) const {
@@ -125,6 +139,24 @@ void TalkTable_GFF::load05(const GFF4Struct &top) {
 	    !top.hasField(kGFF4HuffTalkStringBitStream))
 		return;
 
+	Common::ScopedPtr<Common::SeekableReadStream>
+		huffTree (top.getData(kGFF4HuffTalkStringHuffTree)),
+		bitStream(top.getData(kGFF4HuffTalkStringBitStream));
+
+	if (!huffTree || !bitStream)
+		return;
+
+	Common::SeekableSubReadStreamEndian huffTreeEndian(huffTree.get(), 0, huffTree->size(), _gff->isBigEndian());
+	Common::SeekableSubReadStreamEndian bitStreamEndian(bitStream.get(), 0, bitStream->size(), _gff->isBigEndian());
+
+	_huffTree.resize(huffTreeEndian.size() / 4);
+	for (std::vector<int32>::iterator h = _huffTree.begin(); h != _huffTree.end(); ++h)
+		*h = huffTreeEndian.readSint32();
+
+	_bitStream.resize(bitStreamEndian.size() / 4);
+	for (std::vector<uint32>::iterator b = _bitStream.begin(); b != _bitStream.end(); ++b)
+		*b = bitStreamEndian.readUint32();
+
 	const GFF4List &strings = top.getList(kGFF4HuffTalkStringList);
 
 	for (GFF4List::const_iterator s = strings.begin(); s != strings.end(); ++s) {
@@ -147,39 +179,31 @@ void TalkTable_GFF::readString(Entry &entry) const {
 	if (!entry.strct)
 		return;
 
+	Common::UString text;
+
 	if      (_gff->getTypeVersion() == kVersion02)
-		readString02(entry);
+		text = readString02(*entry.strct);
 	else if (_gff->getTypeVersion() == kVersion04)
-		readString05(entry, _gff->isBigEndian());
+		text = readString05(*entry.strct);
 	else if (_gff->getTypeVersion() == kVersion05)
-		readString05(entry, _gff->isBigEndian());
+		text = readString05(*entry.strct);
 
-	entry.strct = 0;
-}
+	if (!text.empty())
+		entry.view = _strings.add(text);
 
-void TalkTable_GFF::readString02(Entry &entry) const {
-	if (_encoding != Common::kEncodingInvalid)
-		entry.text = entry.strct->getString(kGFF4TalkString, _encoding);
-	else
-		entry.text = "[???]";
+	entry.strct = 0;
 }
 
-void TalkTable_GFF::readString05(Entry &entry, bool bigEndian) const {
-	Common::ScopedPtr<Common::SeekableReadStream>
-		huffTree (_gff->getTopLevel().getData(kGFF4HuffTalkStringHuffTree)),
-		bitStream(_gff->getTopLevel().getData(kGFF4HuffTalkStringBitStream));
-
-	if (!huffTree || !bitStream)
-		return;
+Common::UString TalkTable_GFF::readString02(const GFF4Struct &strct) const {
+	if (_encoding == Common::kEncodingInvalid)
+		return "[???]";
 
-	Common::SeekableSubReadStreamEndian huffTreeEndian(huffTree.get(), 0, huffTree->size(), bigEndian);
-	Common::SeekableSubReadStreamEndian bitStreamEndian(bitStream.get(), 0, bitStream->size(), bigEndian);
-
-	readString05(huffTreeEndian, bitStreamEndian, entry);
+	return strct.getString(kGFF4TalkString, _encoding);
 }
 
-void TalkTable_GFF::readString05(Common::SeekableSubReadStreamEndian &huffTree,
-                                 Common::SeekableSubReadStreamEndian &bitStream, Entry &entry) const {
+Common::UString TalkTable_GFF::readString05(const GFF4Struct &strct) const {
+	if (_huffTree.empty() || _bitStream.empty())
+		return "";
 
 	/* Read a string encoded in a Huffman'd bitstream.
 	 *
@@ -192,20 +216,23 @@ void TalkTable_GFF::readString05(Common::SeekableSubReadStreamEndian &huffTree,
 
 	std::vector<uint16> utf16Str;
 
-	const uint32 startOffset = entry.strct->getUint(kGFF4HuffTalkStringBitOffset);
+	const uint32 startOffset = strct.getUint(kGFF4HuffTalkStringBitOffset);
 
 	uint32 index = startOffset >> 5;
 	uint32 shift = startOffset & 0x1F;
 
 	do {
-		ptrdiff_t e = (huffTree.size() / 8) - 1;
+		ptrdiff_t e = (_huffTree.size() / 2) - 1;
 
 		while (e >= 0) {
-			bitStream.seek(index * 4);
-			const ptrdiff_t offset = (bitStream.readUint32() >> shift) & 1;
+			if (index >= _bitStream.size())
+				throw Common::Exception("Huffman'd string %u runs past the end of the bit stream", startOffset);
+
+			const size_t node = (e * 2) + ((_bitStream[index] >> shift) & 1);
+			if (node >= _huffTree.size())
+				throw Common::Exception("Invalid Huffman tree node %u", (uint) node);
 
-			huffTree.seek(((e * 2) + offset) * 4);
-			e = huffTree.readSint32();
+			e = _huffTree[node];
 
 			shift++;
 			index += (shift >> 5);
@@ -220,7 +247,15 @@ void TalkTable_GFF::readString05(Common::SeekableSubReadStreamEndian &huffTree,
 	const byte  *data = reinterpret_cast<const byte *>(&utf16Str[0]);
 	const size_t size = utf16Str.size() * 2;
 
-	entry.text = Common::readString(data, size, Common::kEncodingUTF16LE);
+	return Common::readString(data, size, Common::kEncodingUTF16LE);
+}
+
+void TalkTable_GFF::getStrRefs(std::vector<uint32> &strRefs) const {
+	strRefs.clear();
+	strRefs.reserve(_entries.size());
+
+	for (Entries::const_iterator e = _entries.begin(); e != _entries.end(); ++e)
+		strRefs.push_back(e->first);
 }
 
 } // End of namespace Aurora
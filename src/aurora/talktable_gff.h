@@ -26,6 +26,7 @@
 #define AURORA_TALKTABLE_GFF_H
 
 #include <map>
+#include <vector>
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
@@ -37,7 +38,6 @@
 
 namespace Common {
 	class SeekableReadStream;
-	class SeekableSubReadStreamEndian;
 }
 
 namespace Aurora {
@@ -56,6 +56,9 @@ namespace Aurora {
  *  - V0.2, used by Sonic Chronicles and Dragon Age: Origins (PC)
  *  - V0.4, used by Dragon Age: Origins (Xbox 360)
  *  - V0.5, used by Dragon Age II
+ *
+ *  For V0.4 and V0.5, the Huffman tree and bit stream are read into
+ *  memory once on load, and strings are decoded directly out of them.
  */
 class TalkTable_GFF : public TalkTable {
 public:
@@ -68,13 +71,17 @@ public:
 	const Common::UString &getString     (uint32 strRef) const;
 	const Common::UString &getSoundResRef(uint32 strRef) const;
 
+	Common::StringView getStringView(uint32 strRef) const;
+
 	uint32 getSoundID(uint32 strRef) const;
 
 
 private:
 	struct Entry {
-		Common::UString text;
+		Common::StringView view; ///< The decoded string, in the talk table's string arena.
+		Common::UString text;    ///< A copy of the decoded string, once getString() asked for it.
 
+		/** The struct to decode the string from, or 0 if it has already been decoded. */
 		const GFF4Struct *strct;
 
 		Entry(const GFF4Struct *s = 0) : strct(s) { }
@@ -87,16 +94,20 @@ private:
 
 	mutable Entries _entries;
 
+	/** V0.5: The Huffman tree, in native endianness. */
+	std::vector<int32>  _huffTree;
+	/** V0.5: The Huffman'd bit stream, in native endianness. */
+	std::vector<uint32> _bitStream;
+
 	void load(Common::SeekableReadStream *tlk);
 	void load02(const GFF4Struct &top);
 	void load05(const GFF4Struct &top);
 
 	void readString(Entry &entry) const;
-	void readString02(Entry &entry) const;
-	void readString05(Entry &entry, bool bigEndian) const;
+	Common::UString readString02(const GFF4Struct &strct) const;
+	Common::UString readString05(const GFF4Struct &strct) const;
 
-	void readString05(Common::SeekableSubReadStreamEndian &huffTree,
-	                  Common::SeekableSubReadStreamEndian &bitStream, Entry &entry) const;
+	void getStrRefs(std::vector<uint32> &strRefs) const;
 };
 
 } // End of namespace Aurora
@@ -27,6 +27,7 @@
  */
 
 #include <cassert>
+#include <cstring>
 
 #include "src/common/util.h"
 #include "src/common/strutil.h"
@@ -44,7 +45,7 @@ static const uint32 kVersion4 = MKTAG('V', '4', '.', '0');
 namespace Aurora {
 
 TalkTable_TLK::TalkTable_TLK(Common::SeekableReadStream *tlk, Common::Encoding encoding) :
-	TalkTable(encoding), _tlk(tlk) {
+	TalkTable(encoding), _tlk(tlk), _data(0), _dataSize(0) {
 
 	assert(_tlk);
 
@@ -56,6 +57,22 @@ TalkTable_TLK::~TalkTable_TLK() {
 
 void TalkTable_TLK::load() {
 	try {
+		/* Make sure we have the whole TLK in memory. That way, we can read
+		 * the strings without seeking around in the stream, and from several
+		 * threads at once. If it already is in memory, we just use it. */
+		Common::MemoryReadStream *tlk = dynamic_cast<Common::MemoryReadStream *>(_tlk.get());
+		if (!tlk) {
+			_tlk->seek(0);
+
+			tlk = _tlk->readStream(_tlk->size());
+			_tlk.reset(tlk);
+		}
+
+		_data     = tlk->getData();
+		_dataSize = tlk->size();
+
+		_tlk->seek(0);
+
 		readHeader(*_tlk);
 
 		if (_id != kTLKID)
@@ -114,25 +131,44 @@ void TalkTable_TLK::readEntryTableV4() {
 }
 
 void TalkTable_TLK::readString(Entry &entry) const {
-	if (!entry.text.empty() || (entry.length == 0) || !(entry.flags & kFlagTextPresent))
+	if (entry.decoded)
 		// We already have the string
 		return;
 
-	assert(_tlk);
+	if ((entry.length == 0) || !(entry.flags & kFlagTextPresent) || (entry.offset >= _dataSize)) {
+		entry.decoded = true;
+		return;
+	}
 
-	_tlk->seek(entry.offset);
+	const byte  *text   = _data + entry.offset;
+	const size_t length = MIN<size_t>(entry.length, _dataSize - entry.offset);
 
-	uint32 length = MIN<size_t>(entry.length, _tlk->size() - _tlk->pos());
-	if (length == 0)
+	if (_encoding == Common::kEncodingInvalid) {
+		entry.view    = _strings.add("[???]", 5);
+		entry.decoded = true;
 		return;
+	}
+
+	Common::MemoryReadStream data(text, length);
 
-	Common::ScopedPtr<Common::MemoryReadStream> data(_tlk->readStream(length));
-	Common::ScopedPtr<Common::MemoryReadStream> parsed(LangMan.preParseColorCodes(*data));
+	// Only strings with color tokens need to be parsed for them
+	if (!std::memchr(text, '<', length)) {
+		entry.view    = _strings.add(Common::readString(data, _encoding));
+		entry.decoded = true;
+		return;
+	}
 
-	if (_encoding != Common::kEncodingInvalid)
-		entry.text = Common::readString(*parsed, _encoding);
-	else
-		entry.text = "[???]";
+	Common::ScopedPtr<Common::MemoryReadStream> parsed(LanguageManager::preParseColorCodes(data));
+
+	entry.view    = _strings.add(Common::readString(*parsed, _encoding));
+	entry.decoded = true;
+}
+
+void TalkTable_TLK::getStrRefs(std::vector<uint32> &strRefs) const {
+	strRefs.resize(_entries.size());
+
+	for (size_t i = 0; i < strRefs.size(); i++)
+		strRefs[i] = i;
 }
 
 uint32 TalkTable_TLK::getLanguageID() const {
@@ -148,9 +184,22 @@ const Common::UString &TalkTable_TLK::getString(uint32 strRef) const {
 	if (strRef >= _entries.size())
 		return kEmptyString;
 
+	Entry &entry = _entries[strRef];
+
+	readString(entry);
+	if (entry.text.empty() && !entry.view.empty())
+		entry.text = entry.view.toString();
+
+	return entry.text;
+}
+
+Common::StringView TalkTable_TLK::getStringView(uint32 strRef) const {
+	if (strRef >= _entries.size())
+		return Common::StringView();
+
 	readString(_entries[strRef]);
 
-	return _entries[strRef].text;
+	return _entries[strRef].view;
 }
 
 const Common::UString &TalkTable_TLK::getSoundResRef(uint32 strRef) const {
@@ -49,6 +49,9 @@ namespace Aurora {
  *  - V3.0, used by Neverwinter Nights, Neverwinter Nights 2, Knight of
  *    the Old Republic, Knight of the Old Republic II and The Witcher
  *  - V4.0, used by Jade Empire
+ *
+ *  The whole TLK is held in memory, and strings are only decoded
+ *  when they're first requested, directly out of that memory.
  */
 class TalkTable_TLK : public AuroraFile, public TalkTable {
 public:
@@ -64,6 +67,8 @@ public:
 	const Common::UString &getString     (uint32 strRef) const;
 	const Common::UString &getSoundResRef(uint32 strRef) const;
 
+	Common::StringView getStringView(uint32 strRef) const;
+
 	uint32 getSoundID(uint32 strRef) const;
 
 	static uint32 getLanguageID(Common::SeekableReadStream &tlk);
@@ -80,7 +85,10 @@ private:
 
 	/** A talk resource entry. */
 	struct Entry {
-		Common::UString text;
+		bool decoded;            ///< Has the string been decoded yet?
+		Common::StringView view; ///< The decoded string, in the talk table's string arena.
+		Common::UString text;    ///< A copy of the decoded string, once getString() asked for it.
+
 		uint32 offset;
 		uint32 length;
 
@@ -93,6 +101,8 @@ private:
 
 		// V4
 		uint32 soundID;
+
+		Entry() : decoded(false) { }
 	};
 
 	typedef std::vector<Entry> Entries;
@@ -100,6 +110,10 @@ private:
 
 	Common::ScopedPtr<Common::SeekableReadStream> _tlk;
 
+	/** The whole TLK, in memory. */
+	const byte *_data;
+	size_t _dataSize;
+
 	uint32 _languageID;
 
 	mutable Entries _entries;
@@ -110,6 +124,8 @@ private:
 	void readEntryTableV4();
 
 	void readString(Entry &entry) const;
+
+	void getStrRefs(std::vector<uint32> &strRefs) const;
 };
 
 } // End of namespace Aurora
@@ -355,14 +355,18 @@ const FileTypeManager::Type FileTypeManager::types[] = {
 
 
 FileTypeManager::FileTypeManager() {
+	// Build all lookups up front, so that they're only ever read afterwards, even from several threads
+	buildExtensionLookup();
+	buildTypeLookup();
+
+	for (int i = 0; i < Common::kHashMAX; i++)
+		buildHashLookup((Common::HashAlgo) i);
 }
 
 FileTypeManager::~FileTypeManager() {
 }
 
 FileType FileTypeManager::getFileType(const Common::UString &path) {
-	buildExtensionLookup();
-
 	Common::UString ext = Common::FilePath::getExtension(path).toLower();
 
 	ExtensionLookup::const_iterator t = _extensionLookup.find(ext);
@@ -377,8 +381,6 @@ Common::UString FileTypeManager::addFileType(const Common::UString &path, FileTy
 }
 
 Common::UString FileTypeManager::setFileType(const Common::UString &path, FileType type) {
-	buildTypeLookup();
-
 	Common::UString ext;
 	TypeLookup::const_iterator t = _typeLookup.find(type);
 	if (t != _typeLookup.end())
@@ -387,12 +389,58 @@ Common::UString FileTypeManager::setFileType(const Common::UString &path, FileTy
 	return Common::FilePath::changeExtension(path, ext);
 }
 
+void FileTypeManager::hashFileName(Common::Hasher &hasher, const Common::UString &path, FileType type) {
+	/* Find where the current extension starts, the same way boost::filesystem
+	 * does it: at the last '.' in the file name, unless that's "." or "..". */
+
+	Common::UString::iterator extension = path.end();
+
+	size_t nameLength = 0, nameDots = 0;
+	for (Common::UString::iterator c = path.begin(); c != path.end(); ++c) {
+		if (*c == '/') {
+			extension  = path.end();
+			nameLength = 0;
+			nameDots   = 0;
+			continue;
+		}
+
+		nameLength++;
+
+		if (*c == '.') {
+			extension = c;
+			nameDots++;
+		}
+	}
+
+	if ((nameLength <= 2) && (nameDots == nameLength))
+		extension = path.end();
+
+	for (Common::UString::iterator c = path.begin(); c != extension; ++c)
+		hasher.add(Common::UString::toLower(*c));
+
+	hashFileType(hasher, type);
+}
+
+void FileTypeManager::hashFileType(Common::Hasher &hasher, FileType type) {
+	TypeLookup::const_iterator t = _typeLookup.find(type);
+	if (t == _typeLookup.end())
+		return;
+
+	const char *extension = t->second->extension;
+	if (*extension == '\0')
+		return;
+
+	if (*extension != '.')
+		hasher.add('.');
+
+	for (; *extension != '\0'; extension++)
+		hasher.add(Common::UString::toLower((byte) *extension));
+}
+
 FileType FileTypeManager::getFileType(Common::HashAlgo algo, uint64 hashedExtension) {
 	if ((algo < 0) || (algo >= Common::kHashMAX))
 		return kFileTypeNone;
 
-	buildHashLookup(algo);
-
 	HashLookup::const_iterator t = _hashLookup[algo].find(hashedExtension);
 	if (t != _hashLookup[algo].end())
 		return t->second->type;
@@ -55,6 +55,15 @@ public:
 	/** Return the file name with a swapped extensions according to the specified file type. */
 	Common::UString setFileType(const Common::UString &path, FileType type);
 
+	/** Add the file name with a swapped extension according to the specified file type to a hash.
+	 *
+	 *  This adds the same characters as setFileType(path, type).toLower() would
+	 *  return, but without building any strings.
+	 */
+	void hashFileName(Common::Hasher &hasher, const Common::UString &path, FileType type);
+	/** Add the extension of the specified file type to a hash, in lowercase. */
+	void hashFileType(Common::Hasher &hasher, FileType type);
+
 
 private:
 	/** File type <-> extension mapping. */
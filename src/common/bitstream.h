@@ -30,6 +30,7 @@
 #include <boost/noncopyable.hpp>
 
 #include "src/common/types.h"
+#include "src/common/util.h"
 #include "src/common/disposableptr.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
@@ -63,9 +64,18 @@ public:
 	/** Read a multi-bit value from the bit stream. */
 	virtual uint32 getBits(size_t n) = 0;
 
+	/** Read a multi-bit value from the bit stream, without consuming the bits.
+	 *
+	 *  Bits past the end of the stream are read as 0.
+	 */
+	virtual uint32 peekBits(size_t n) = 0;
+
 	/** Add a bit to the n-bit value x, making it an (n+1)-bit value. */
 	virtual void addBit(uint32 &x, size_t n) = 0;
 
+	/** Are the bits within a data value handed out from the MSB to the LSB? */
+	virtual bool isMSBFirst() const = 0;
+
 protected:
 	BitStream() {
 	}
@@ -182,22 +192,85 @@ public:
 		if (n > 32)
 			throw Exception("Too many bits requested to be read");
 
-		// Read the number of bits
+		/* Read the number of bits, taking as many of them at once
+		 * from the current value as we can. */
 		uint32 v = 0;
 
-		if (isMSB2LSB) {
-			while (n-- > 0)
-				v = (v << 1) | getBit();
-		} else {
-			for (uint32 i = 0; i < n; i++)
-				v = (v >> 1) | (((uint32) getBit()) << 31);
+		for (size_t done = 0; done < n; ) {
+			if (_inValue == 0)
+				readValue();
+
+			const size_t count = MIN<size_t>(n - done, valueBits - _inValue);
+			const uint64 mask  = (1ULL << count) - 1;
 
-			v >>= (32 - n);
+			if (isMSB2LSB) {
+				// Shift in 64 bits, since count can be 32 when reading a whole value at once
+				v = (uint32) ((((uint64) v) << count) | ((_value >> (64 - count)) & mask));
+				_value <<= count;
+			} else {
+				v |= ((uint32) (_value & mask)) << done;
+				_value >>= count;
+			}
+
+			done += count;
+
+			// Increase the position within the current value
+			_inValue = (_inValue + count) % valueBits;
 		}
 
 		return v;
 	}
 
+	/** Read a multi-bit value from the bit stream, without consuming the bits. */
+	uint32 peekBits(size_t n) {
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		if (n == 0)
+			return 0;
+
+		// Fast path: all the requested bits are still in the current value
+		if ((_inValue != 0) && ((size_t) (valueBits - _inValue) >= n)) {
+			if (isMSB2LSB)
+				return (uint32) (_value >> (64 - n));
+
+			return (uint32) (_value & ((1ULL << n) - 1));
+		}
+
+		// Take what's left in the current value
+		uint64 v     = 0;
+		size_t count = 0;
+
+		if (_inValue != 0) {
+			count = valueBits - _inValue;
+			v     = isMSB2LSB ? (_value >> (64 - count)) : _value;
+		}
+
+		// Look at the following data values, without consuming them
+		const size_t streamPos = _stream->pos();
+		const size_t valueSize = valueBits / 8;
+
+		while ((count < n) && ((_stream->size() - _stream->pos()) >= valueSize)) {
+			const uint64 data = readData();
+			const size_t bits = MIN<size_t>(n - count, valueBits);
+
+			if (isMSB2LSB)
+				v = (v << bits) | (data >> (valueBits - bits));
+			else
+				v |= (data & ((1ULL << bits) - 1)) << count;
+
+			count += bits;
+		}
+
+		_stream->seek(streamPos);
+
+		// Pad bits past the end of the stream with 0
+		if (isMSB2LSB && (count < n))
+			v <<= n - count;
+
+		return (uint32) v;
+	}
+
 	/** Add a bit to the n-bit value x, making it an (n+1)-bit value. */
 	void addBit(uint32 &x, size_t n) {
 		if (n >= 32)
@@ -219,8 +292,17 @@ public:
 
 	/** Skip the specified amount of bits. */
 	void skip(size_t n) {
-		while (n-- > 0)
-			getBit();
+		while (n > 0) {
+			const size_t count = MIN<size_t>(n, 32);
+
+			getBits(count);
+			n -= count;
+		}
+	}
+
+	/** Are the bits within a data value handed out from the MSB to the LSB? */
+	bool isMSBFirst() const {
+		return isMSB2LSB;
 	}
 
 	/** Return the stream position in bits. */
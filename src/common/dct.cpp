@@ -57,14 +57,14 @@
 
 namespace Common {
 
-DCT::DCT(int bits, TransformType trans) : _bits(bits), _trans(trans) {
+DCT::DCT(int bits, TransformType trans, TransformKernels kernels) : _bits(bits), _trans(trans) {
 	int n = 1 << _bits;
 
 	_tCos = getCosineTable(_bits + 2);
 
 	_csc2.reset(new float[n / 2]);
 
-	_rdft.reset(new RDFT(_bits, (_trans == DCT_III) ? RDFT::IDFT_C2R : RDFT::DFT_R2C));
+	_rdft.reset(new RDFT(_bits, (_trans == DCT_III) ? RDFT::IDFT_C2R : RDFT::DFT_R2C, kernels));
 
 	for (int i = 0; i < (n / 2); i++)
 		_csc2[i] = 0.5 / sin((M_PI / (2 * n) * (2 * i + 1)));
@@ -57,6 +57,7 @@
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/fft.h"
 
 namespace Common {
 
@@ -72,7 +73,7 @@ public:
 		DST_I
 	};
 
-	DCT(int bits, TransformType trans);
+	DCT(int bits, TransformType trans, TransformKernels kernels = kTransformKernelsAuto);
 	~DCT();
 
 	void calc(float *data);
@@ -22,6 +22,9 @@
  *  Compress (deflate) and decompress (inflate) using zlib's DEFLATE algorithm.
  */
 
+#include <cassert>
+#include <cstring>
+
 #include <zlib.h>
 
 #include <boost/scope_exit.hpp>
@@ -197,4 +200,264 @@ size_t decompressDeflateChunk(SeekableReadStream &input, int windowBits,
 	return strm.total_out;
 }
 
+
+/** Size of the chunks of compressed data InflateReadStream reads at a time. */
+static const size_t kInflateInputSize   = 16384;
+/** The maximum size of the DEFLATE history buffer. */
+static const size_t kInflateWindowSize  = 1 << kWindowBitsMax;
+/** Distance between two restart points in the decompressed data. */
+static const size_t kInflateRestartSpan = 1024 * 1024;
+
+InflateReadStream::InflateReadStream(SeekableReadStream *input, size_t outputSize, int windowBits,
+                                     bool disposeInput) :
+	_input(input, disposeInput), _size(outputSize), _pos(0), _eos(false), _windowBits(windowBits),
+	_strm(new z_stream), _inputBuffer(new byte[kInflateInputSize]), _inputPos(0),
+	_window(new byte[kInflateWindowSize]), _windowFill(0), _output(0), _restartStart(0) {
+
+	assert(_input);
+
+	std::memset(_strm.get(), 0, sizeof(z_stream));
+
+	restart();
+}
+
+InflateReadStream::~InflateReadStream() {
+	inflateEnd(_strm.get());
+}
+
+bool InflateReadStream::eos() const {
+	return _eos;
+}
+
+size_t InflateReadStream::pos() const {
+	return _pos;
+}
+
+size_t InflateReadStream::size() const {
+	return _size;
+}
+
+size_t InflateReadStream::getRestartPointCount() const {
+	return _restartPoints.size();
+}
+
+size_t InflateReadStream::getHistorySize() const {
+	/* Once we've produced a whole ring buffer's worth of data since the last
+	 * (re)start, the ring buffer is full of valid history, even right after
+	 * it wrapped around. Before that, only the data since the start is valid. */
+	return MIN(_output - _restartStart, kInflateWindowSize);
+}
+
+size_t InflateReadStream::read(void *dataPtr, size_t dataSize) {
+	assert(dataPtr);
+
+	// Read at most as many bytes as are still available...
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	byte *data = static_cast<byte *>(dataPtr);
+
+	size_t bytesRead = 0;
+	while (bytesRead < dataSize) {
+		if (_pos == _output)
+			inflateMore();
+
+		/* Everything between our position and the end of the decompressed data
+		 * is still in the ring buffer, in front of the fill mark. If it's further
+		 * back than the fill mark, it wraps around the end of the ring buffer. */
+		const size_t buffered = _output - _pos;
+		const size_t start    = (buffered <= _windowFill) ?
+		                        (_windowFill - buffered) : (kInflateWindowSize - (buffered - _windowFill));
+
+		const size_t n = MIN(MIN(dataSize - bytesRead, buffered), kInflateWindowSize - start);
+
+		std::memcpy(data + bytesRead, _window.get() + start, n);
+
+		bytesRead += n;
+		_pos      += n;
+	}
+
+	return bytesRead;
+}
+
+size_t InflateReadStream::seek(ptrdiff_t offset, Origin whence) {
+	assert(_pos <= _size);
+
+	const size_t oldPos = _pos;
+	const size_t newPos = evalSeek(offset, whence, _pos, 0, size());
+	if (newPos > _size)
+		throw Exception(kSeekError);
+
+	// Reset end-of-stream flag on a successful seek
+	_eos = false;
+
+	// Still in the ring buffer?
+	if ((newPos <= _output) && (newPos >= (_output - getHistorySize()))) {
+		_pos = newPos;
+		return oldPos;
+	}
+
+	// Find the closest restart point in front of the new position
+	const RestartPoint *point = 0;
+	for (std::vector<RestartPoint>::const_iterator p = _restartPoints.begin(); p != _restartPoints.end(); ++p) {
+		if (p->output > newPos)
+			break;
+
+		point = &*p;
+	}
+
+	if (newPos < _output) {
+		// Seeking backwards, we need to restart inflating further up front
+
+		if (point)
+			restart(*point);
+		else
+			restart();
+
+	} else if (point && (point->output > _output))
+		// Seeking forwards, over a restart point we already know
+		restart(*point);
+
+	inflateTo(newPos);
+
+	return oldPos;
+}
+
+void InflateReadStream::restart() {
+	inflateEnd(_strm.get());
+	initZStream(*_strm, _windowBits, 0, 0);
+
+	_inputPos     = 0;
+	_windowFill   = 0;
+	_output       = 0;
+	_restartStart = 0;
+	_pos          = 0;
+}
+
+void InflateReadStream::restart(const RestartPoint &point) {
+	/* We're starting inflate in the middle of the DEFLATE data, so any zlib
+	 * header is already behind us. The window size only limits how far back
+	 * the data may reference, so the maximum one works for every stream. */
+
+	inflateEnd(_strm.get());
+	initZStream(*_strm, kWindowBitsMaxRaw, 0, 0);
+
+	_inputPos = point.input;
+
+	if (point.bits != 0) {
+		// The block starts in the middle of the previous byte
+
+		_input->seek(point.input - 1);
+		const byte value = _input->readByte();
+
+		const int zResult = inflatePrime(_strm.get(), point.bits, value >> (8 - point.bits));
+		if (zResult != Z_OK)
+			throw Exception("Failed to inflate: %s (%d)", zError(zResult), zResult);
+	}
+
+	if (!point.window.empty()) {
+		const int zResult = inflateSetDictionary(_strm.get(), &point.window[0], point.window.size());
+		if (zResult != Z_OK)
+			throw Exception("Failed to inflate: %s (%d)", zError(zResult), zResult);
+	}
+
+	_windowFill   = 0;
+	_output       = point.output;
+	_restartStart = point.output;
+	_pos          = point.output;
+}
+
+void InflateReadStream::inflateTo(size_t offset) {
+	while (_output < offset) {
+		_pos = _output;
+
+		inflateMore();
+	}
+
+	_pos = offset;
+}
+
+void InflateReadStream::inflateMore() {
+	assert(_output < _size);
+
+	if (_windowFill == kInflateWindowSize)
+		_windowFill = 0;
+
+	z_stream &strm = *_strm;
+
+	size_t produced = 0;
+	while (produced == 0) {
+		if (strm.avail_in == 0) {
+			const size_t inputSize = MIN<size_t>(_input->size() - _inputPos, kInflateInputSize);
+			if (inputSize == 0)
+				throw Exception("Failed to inflate: input buffer empty, stream not ended");
+
+			_input->seek(_inputPos);
+			if (_input->read(_inputBuffer.get(), inputSize) != inputSize)
+				throw Exception(kReadError);
+
+			_inputPos += inputSize;
+
+			setZStreamInput(strm, inputSize, _inputBuffer.get());
+		}
+
+		const size_t outputSize = MIN(kInflateWindowSize - _windowFill, _size - _output);
+
+		strm.avail_out = outputSize;
+		strm.next_out  = _window.get() + _windowFill;
+
+		// Decompress. Z_BLOCK, so that we get to see the boundaries between DEFLATE blocks.
+		const int zResult = inflate(&strm, Z_BLOCK);
+		if ((zResult != Z_OK) && (zResult != Z_STREAM_END) && (zResult != Z_BUF_ERROR))
+			throw Exception("Failed to inflate: %s (%d)", zError(zResult), zResult);
+
+		produced     = outputSize - strm.avail_out;
+		_windowFill += produced;
+		_output     += produced;
+
+		if (zResult == Z_STREAM_END) {
+			if (_output < _size)
+				throw Exception("Failed to inflate: output buffer not completely filled");
+
+			break;
+		}
+
+		// At the end of a block that isn't the last one, we can resume later
+		if ((strm.data_type & 128) && !(strm.data_type & 64))
+			addRestartPoint();
+	}
+}
+
+void InflateReadStream::addRestartPoint() {
+	const size_t lastPoint = _restartPoints.empty() ? 0 : _restartPoints.back().output;
+	if (_output < (lastPoint + kInflateRestartSpan))
+		return;
+
+	_restartPoints.push_back(RestartPoint());
+	RestartPoint &point = _restartPoints.back();
+
+	point.output = _output;
+	point.input  = _inputPos - _strm->avail_in;
+	point.bits   = _strm->data_type & 7;
+
+	/* Remember the history needed to resume inflating here. Since we only add
+	 * restart points far behind the last one, we have either produced enough
+	 * data since the last restart to wrap the ring buffer, or we haven't wrapped
+	 * it yet because we started at the beginning. */
+
+	assert((_output - _restartStart) >= kInflateWindowSize || _restartStart == 0);
+
+	if ((_output - _restartStart) >= kInflateWindowSize) {
+		point.window.resize(kInflateWindowSize);
+
+		const size_t older = kInflateWindowSize - _windowFill;
+
+		std::memcpy(&point.window[0]        , _window.get() + _windowFill, older);
+		std::memcpy(&point.window[0] + older, _window.get()              , _windowFill);
+	} else
+		point.window.assign(_window.get(), _window.get() + _windowFill);
+}
+
 } // End of namespace Common
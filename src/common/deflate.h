@@ -25,7 +25,16 @@
 #ifndef COMMON_DEFLATE_H
 #define COMMON_DEFLATE_H
 
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
 #include "src/common/types.h"
+#include "src/common/scopedptr.h"
+#include "src/common/disposableptr.h"
+#include "src/common/readstream.h"
+
+struct z_stream_s;
 
 namespace Common {
 
@@ -35,12 +44,13 @@ namespace Common {
  *   of the decompressed data beforehand
  */
 
-class ReadStream;
-class SeekableReadStream;
-
 static const int kWindowBitsMax    =  15;
 static const int kWindowBitsMaxRaw = -kWindowBitsMax;
 
+/** Decompressed size from which on archives should hand out an InflateReadStream
+ *  instead of inflating the whole resource into memory at once. */
+static const size_t kInflateStreamThreshold = 1024 * 1024;
+
 /** Decompress (inflate) using zlib's DEFLATE algorithm.
  *
  *  @param  data       The compressed input data.
@@ -117,6 +127,93 @@ SeekableReadStream *decompressDeflateWithoutOutputSize(ReadStream &input, size_t
 size_t decompressDeflateChunk(SeekableReadStream &input, int windowBits, byte *output, size_t outputSize,
                               unsigned int frameSize = 4096);
 
+/** A stream that decompresses (inflates) DEFLATE data incrementally, as it is read.
+ *
+ *  Only a small window of the decompressed data is held in memory at any time.
+ *  Seeking forward inflates and discards the data in-between. While inflating,
+ *  restart points are recorded at regular intervals (together with the 32KB of
+ *  history the decompressor needs to resume there), so that seeking backwards
+ *  only has to re-inflate from the closest restart point, not from the start.
+ *
+ *  The parent stream is expected to contain exactly the compressed data. It is
+ *  always explicitly seeked before reading, so it may be shared with other
+ *  sub streams.
+ */
+class InflateReadStream : boost::noncopyable, public SeekableReadStream {
+public:
+	/** Create an inflating stream.
+	 *
+	 *  @param input        The compressed input data.
+	 *  @param outputSize   The size of the decompressed data.
+	 *  @param windowBits   The base two logarithm of the window size (the size of
+	 *                      the history buffer). See the zlib documentation on
+	 *                      inflateInit2() for details.
+	 *  @param disposeInput Should the input stream be deleted when this stream is?
+	 */
+	InflateReadStream(SeekableReadStream *input, size_t outputSize, int windowBits,
+	                  bool disposeInput = true);
+	~InflateReadStream();
+
+	size_t read(void *dataPtr, size_t dataSize);
+
+	bool eos() const;
+
+	size_t pos() const;
+	size_t size() const;
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
+
+	/** Return the number of restart points recorded so far. */
+	size_t getRestartPointCount() const;
+
+private:
+	/** A position in the compressed data where inflating can be resumed. */
+	struct RestartPoint {
+		size_t output; ///< Offset into the decompressed data.
+		size_t input;  ///< Offset into the compressed data.
+		int bits;      ///< Number of bits of the previous input byte still to consume.
+
+		std::vector<byte> window; ///< The decompressed data preceding this point.
+	};
+
+	DisposablePtr<SeekableReadStream> _input;
+
+	size_t _size;
+	size_t _pos;
+
+	bool _eos;
+
+	int _windowBits;
+
+	ScopedPtr<z_stream_s> _strm;
+
+	ScopedArray<byte> _inputBuffer;
+	size_t _inputPos; ///< Offset into the compressed data after the last input read.
+
+	ScopedArray<byte> _window; ///< Ring buffer of the most recently decompressed data.
+	size_t _windowFill;        ///< Bytes decompressed into the ring buffer since its last wrap.
+
+	size_t _output;       ///< Number of decompressed bytes produced so far.
+	size_t _restartStart; ///< Offset into the decompressed data where inflate was last (re)started.
+
+	std::vector<RestartPoint> _restartPoints;
+
+	/** Restart inflating at the beginning of the data. */
+	void restart();
+	/** Restart inflating at a restart point. */
+	void restart(const RestartPoint &point);
+
+	/** Inflate more data into the ring buffer. */
+	void inflateMore();
+	/** Inflate until the decompressed data reaches this offset. */
+	void inflateTo(size_t offset);
+
+	/** Return the number of decompressed bytes in front of the end still in the ring buffer. */
+	size_t getHistorySize() const;
+
+	void addRestartPoint();
+};
+
 } // End of namespace Common
 
 #endif // COMMON_DEFLATE_H
@@ -33,6 +33,7 @@
 #include "src/common/error.h"
 #include "src/common/scopedptr.h"
 #include "src/common/singleton.h"
+#include "src/common/mutex.h"
 #include "src/common/ustring.h"
 #include "src/common/memreadstream.h"
 #include "src/common/writestream.h"
@@ -61,26 +62,12 @@ class ConversionManager : public Singleton<ConversionManager> {
 public:
 	ConversionManager() {
 		for (size_t i = 0; i < kEncodingMAX; i++) {
-			_contextFrom[i] = (iconv_t) -1;
-			_contextTo  [i] = (iconv_t) -1;
+			_contextsFrom[i].init("UTF-8", kEncodingName[i]);
+			_contextsTo  [i].init(kEncodingName[i], "UTF-8");
 		}
-
-		for (size_t i = 0; i < kEncodingMAX; i++)
-			if ((_contextFrom[i] = iconv_open("UTF-8", kEncodingName[i])) == ((iconv_t) -1))
-				warning("Failed to initialize %s -> UTF-8 conversion: %s", kEncodingName[i], strerror(errno));
-
-		for (size_t i = 0; i < kEncodingMAX; i++)
-			if ((_contextTo  [i] = iconv_open(kEncodingName[i], "UTF-8")) == ((iconv_t) -1))
-				warning("Failed to initialize UTF-8 -> %s conversion: %s", kEncodingName[i], strerror(errno));
 	}
 
 	~ConversionManager() {
-		for (size_t i = 0; i < kEncodingMAX; i++) {
-			if (_contextFrom[i] != ((iconv_t) -1))
-				iconv_close(_contextFrom[i]);
-			if (_contextTo  [i] != ((iconv_t) -1))
-				iconv_close(_contextTo  [i]);
-		}
 	}
 
 	bool hasSupportTranscode(Encoding from, Encoding to) {
@@ -89,10 +76,10 @@ public:
 			return false;
 
 		if (from == kEncodingUTF8)
-			return _contextTo[to] != ((iconv_t) -1);
+			return _contextsTo[to].supported;
 
 		if (to == kEncodingUTF8)
-			return _contextFrom[from] != ((iconv_t) -1);
+			return _contextsFrom[from].supported;
 
 		return false;
 	}
@@ -101,22 +88,85 @@ public:
 		if (((size_t) encoding) >= kEncodingMAX)
 			throw Exception("Invalid encoding %d", encoding);
 
-		return convert(_contextFrom[encoding], data, n, kEncodingGrowthFrom[encoding], 1);
+		return convert(_contextsFrom[encoding], data, n, kEncodingGrowthFrom[encoding], 1);
 	}
 
 	MemoryReadStream *convert(Encoding encoding, const UString &str, bool terminate = true) {
 		if (((size_t) encoding) >= kEncodingMAX)
 			throw Exception("Invalid encoding %d", encoding);
 
-		return convert(_contextTo[encoding], str, kEncodingGrowthTo[encoding],
+		return convert(_contextsTo[encoding], str, kEncodingGrowthTo[encoding],
 		               terminate ? kTerminatorLength[encoding] : 0);
 	}
 
 private:
-	iconv_t _contextFrom[kEncodingMAX];
-	iconv_t _contextTo  [kEncodingMAX];
+	/** The iconv contexts for one conversion direction.
+	 *
+	 *  An iconv context carries state, so it can only be used by one
+	 *  conversion at a time. Instead of making all conversions wait for
+	 *  a single context, each conversion takes a context out of this
+	 *  pool, opening another one if all of them are currently in use.
+	 */
+	struct ContextPool {
+		const char *to;
+		const char *from;
+
+		bool supported;
+
+		std::mutex mutex;             ///< Guards the list of idle contexts.
+		std::vector<iconv_t> contexts; ///< The contexts not currently in use.
+
+		ContextPool() : to(0), from(0), supported(false) {
+		}
+
+		~ContextPool() {
+			for (std::vector<iconv_t>::iterator c = contexts.begin(); c != contexts.end(); ++c)
+				iconv_close(*c);
+		}
+
+		void init(const char *t, const char *f) {
+			to   = t;
+			from = f;
+
+			iconv_t ctx = iconv_open(to, from);
+			if (ctx == ((iconv_t) -1)) {
+				warning("Failed to initialize %s -> %s conversion: %s", from, to, strerror(errno));
+				return;
+			}
+
+			supported = true;
+			contexts.push_back(ctx);
+		}
+
+		iconv_t acquire() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+
+				if (!contexts.empty()) {
+					iconv_t ctx = contexts.back();
+					contexts.pop_back();
 
-	byte *doConvert(iconv_t &ctx, byte *data, size_t nIn, size_t nOut, size_t &size) {
+					return ctx;
+				}
+			}
+
+			return iconv_open(to, from);
+		}
+
+		void release(iconv_t ctx) {
+			if (ctx == ((iconv_t) -1))
+				return;
+
+			std::lock_guard<std::mutex> lock(mutex);
+
+			contexts.push_back(ctx);
+		}
+	};
+
+	ContextPool _contextsFrom[kEncodingMAX];
+	ContextPool _contextsTo  [kEncodingMAX];
+
+	byte *doConvert(ContextPool &pool, byte *data, size_t nIn, size_t nOut, size_t &size) {
 		size_t inBytes  = nIn;
 		size_t outBytes = nOut;
 
@@ -124,14 +174,25 @@ private:
 
 		byte *outBuf = convData.get();
 
+		iconv_t ctx = pool.acquire();
+		if (ctx == ((iconv_t) -1)) {
+			warning("iconv_open() failed: %s", strerror(errno));
+			return 0;
+		}
+
 		// Reset the converter's state
 		iconv(ctx, 0, 0, 0, 0);
 
 		// Convert
-		if (iconv(ctx, const_cast<ICONV_CONST char **>(reinterpret_cast<char **>(&data)), &inBytes,
-		          reinterpret_cast<char **>(&outBuf), &outBytes) == ((size_t) -1)) {
+		const size_t result = iconv(ctx, const_cast<ICONV_CONST char **>(reinterpret_cast<char **>(&data)),
+		                            &inBytes, reinterpret_cast<char **>(&outBuf), &outBytes);
+
+		const int convError = errno;
+
+		pool.release(ctx);
 
-			warning("iconv() failed: %s", strerror(errno));
+		if (result == ((size_t) -1)) {
+			warning("iconv() failed: %s", strerror(convError));
 			return 0;
 		}
 
@@ -140,12 +201,12 @@ private:
 		return convData.release();
 	}
 
-	UString convert(iconv_t &ctx, byte *data, size_t n, size_t growth, size_t termSize) {
-		if (ctx == ((iconv_t) -1))
+	UString convert(ContextPool &pool, byte *data, size_t n, size_t growth, size_t termSize) {
+		if (!pool.supported)
 			return "[!!!]";
 
 		size_t size;
-		ScopedArray<byte> dataOut(doConvert(ctx, data, n, n * growth + termSize, size));
+		ScopedArray<byte> dataOut(doConvert(pool, data, n, n * growth + termSize, size));
 		if (!dataOut)
 			return "[!?!]";
 
@@ -155,8 +216,8 @@ private:
 		return UString(reinterpret_cast<const char *>(dataOut.get()));
 	}
 
-	MemoryReadStream *convert(iconv_t &ctx, const UString &str, size_t growth, size_t termSize) {
-		if (ctx == ((iconv_t) -1))
+	MemoryReadStream *convert(ContextPool &pool, const UString &str, size_t growth, size_t termSize) {
+		if (!pool.supported)
 			return 0;
 
 		byte  *dataIn = const_cast<byte *>(reinterpret_cast<const byte *>(str.c_str()));
@@ -164,7 +225,7 @@ private:
 		size_t nOut   = nIn * growth + termSize;
 
 		size_t size;
-		ScopedArray<byte> dataOut(doConvert(ctx, dataIn, nIn, nOut, size));
+		ScopedArray<byte> dataOut(doConvert(pool, dataIn, nIn, nOut, size));
 		if (!dataOut)
 			return 0;
 
@@ -56,13 +56,77 @@
 #include "src/common/maths.h"
 #include "src/common/cosinetables.h"
 #include "src/common/util.h"
+#include "src/common/error.h"
 #include "src/common/fft.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define FFT_SSE 1
+	#include <emmintrin.h>
+
+	// The AVX kernels are compiled for AVX separately, and only used if the CPU supports it
+	#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ >= 5)))
+		#define FFT_AVX 1
+		#include <immintrin.h>
+	#endif
+#endif
+
 namespace Common {
 
-FFT::FFT(int bits, bool inverse) : _bits(bits), _inverse(inverse) {
+/** One pass of the split-radix FFT: z[0...8n-1], w[1...2n-1]. */
+typedef void (*FFTPass)(Complex *z, const float *wre, unsigned int n);
+
+/** The pass functions of one set of transform kernels. */
+struct FFTPasses {
+	FFTPass pass;    ///< For FFTs of up to 512 points.
+	FFTPass passBig; ///< For FFTs of 1024 points and more.
+};
+
+static const FFTPasses *getFFTPasses(TransformKernels kernels);
+
+bool hasTransformKernels(TransformKernels kernels) {
+	switch (kernels) {
+		case kTransformKernelsAuto:
+		case kTransformKernelsScalar:
+			return true;
+
+#ifdef FFT_SSE
+		case kTransformKernelsSSE:
+			return true;
+#endif
+
+#ifdef FFT_AVX
+		case kTransformKernelsAVX:
+			return __builtin_cpu_supports("avx");
+#endif
+
+		default:
+			break;
+	}
+
+	return false;
+}
+
+TransformKernels getBestTransformKernels() {
+	if (hasTransformKernels(kTransformKernelsAVX))
+		return kTransformKernelsAVX;
+	if (hasTransformKernels(kTransformKernelsSSE))
+		return kTransformKernelsSSE;
+
+	return kTransformKernelsScalar;
+}
+
+FFT::FFT(int bits, bool inverse, TransformKernels kernels) : _bits(bits), _inverse(inverse) {
 	assert((_bits >= 2) && (_bits <= 16));
 
+	if (kernels == kTransformKernelsAuto)
+		kernels = getBestTransformKernels();
+
+	if (!hasTransformKernels(kernels))
+		throw Exception("FFT: Transform kernels %d not supported on this CPU", (int) kernels);
+
+	_kernels = kernels;
+	_passes  = getFFTPasses(_kernels);
+
 	int n = 1 << bits;
 
 	_tmpBuf.reset(new Complex[n]);
@@ -76,6 +140,10 @@ FFT::FFT(int bits, bool inverse) : _bits(bits), _inverse(inverse) {
 FFT::~FFT() {
 }
 
+TransformKernels FFT::getKernels() const {
+	return _kernels;
+}
+
 const uint16 *FFT::getRevTab() const {
 	return _revTab.get();
 }
@@ -190,16 +258,186 @@ PASS(pass)
 #define BUTTERFLIES BUTTERFLIES_BIG
 PASS(pass_big)
 
-#define DECL_FFT(t,n,n2,n4)\
-static void fft##n(Complex *z)\
+static const FFTPasses kPassesScalar = { pass, pass_big };
+
+#ifdef FFT_SSE
+
+/* The SIMD passes do the same calculations as TRANSFORM and BUTTERFLIES
+ * above, for two (SSE) or four (AVX) consecutive complex values at once.
+ * Every value goes through the same operations in the same order, so the
+ * results match the scalar passes.
+ *
+ * For each complex value a2, a3 with the twiddle factor w:
+ *   p = a2 * conj(w)       (t1, t2)
+ *   q = a3 * w             (t5, t6)
+ *   a0, a2 = a0 + (p + q), a0 - (p + q)
+ *   a1, a3 = a1 + d, a1 - d, with d = -i * (p - q)   (t4, t3)
+ */
+
+/** Negate the real parts of two complex values. */
+static FORCEINLINE __m128 negateReSSE(__m128 x) {
+	return _mm_xor_ps(x, _mm_castsi128_ps(_mm_set_epi32(0, 0x80000000, 0, 0x80000000)));
+}
+
+/** Negate the imaginary parts of two complex values. */
+static FORCEINLINE __m128 negateImSSE(__m128 x) {
+	return _mm_xor_ps(x, _mm_castsi128_ps(_mm_set_epi32(0x80000000, 0, 0x80000000, 0)));
+}
+
+/** Swap the real and imaginary parts of two complex values. */
+static FORCEINLINE __m128 swapReImSSE(__m128 x) {
+	return _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+static void passSSE(Complex *z, const float *wre, unsigned int n) {
+	const unsigned int o1 = 2 * n;
+	const float *wim = wre + o1;
+
+	float *z0 = reinterpret_cast<float *>(z);
+	float *z1 = z0 + 2 * o1;
+	float *z2 = z1 + 2 * o1;
+	float *z3 = z2 + 2 * o1;
+
+	for (unsigned int k = 0; k < o1; k += 2, z0 += 4, z1 += 4, z2 += 4, z3 += 4) {
+		__m128 wr, wi;
+
+		if (k == 0) {
+			// The first value is TRANSFORM_ZERO, i.e. multiplied by exactly 1
+			wr = _mm_set_ps(wre[1], wre[1], 1.0f, 1.0f);
+			wi = _mm_set_ps(wim[-1], wim[-1], 0.0f, 0.0f);
+		} else {
+			const __m128 r = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(wre + k));
+			const __m128 i = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(wim - k - 1));
+
+			wr = _mm_unpacklo_ps(r, r);
+			wi = _mm_shuffle_ps(i, i, _MM_SHUFFLE(0, 0, 1, 1));
+		}
+
+		const __m128 a0 = _mm_loadu_ps(z0);
+		const __m128 a1 = _mm_loadu_ps(z1);
+		const __m128 a2 = _mm_loadu_ps(z2);
+		const __m128 a3 = _mm_loadu_ps(z3);
+
+		const __m128 p = _mm_add_ps(_mm_mul_ps(a2, wr), negateImSSE(_mm_mul_ps(swapReImSSE(a2), wi)));
+		const __m128 q = _mm_add_ps(_mm_mul_ps(a3, wr), negateReSSE(_mm_mul_ps(swapReImSSE(a3), wi)));
+
+		const __m128 s = _mm_add_ps(q, p);
+		const __m128 d = negateImSSE(swapReImSSE(_mm_sub_ps(p, q)));
+
+		_mm_storeu_ps(z0, _mm_add_ps(a0, s));
+		_mm_storeu_ps(z2, _mm_sub_ps(a0, s));
+		_mm_storeu_ps(z1, _mm_add_ps(a1, d));
+		_mm_storeu_ps(z3, _mm_sub_ps(a1, d));
+	}
+}
+
+static const FFTPasses kPassesSSE = { passSSE, passSSE };
+
+#endif // FFT_SSE
+
+#ifdef FFT_AVX
+
+#define FFT_AVX_TARGET __attribute__((target("avx")))
+
+/** Negate the real parts of four complex values. */
+FFT_AVX_TARGET static FORCEINLINE __m256 negateReAVX(__m256 x) {
+	return _mm256_xor_ps(x, _mm256_castsi256_ps(_mm256_set1_epi64x(0x0000000080000000LL)));
+}
+
+/** Negate the imaginary parts of four complex values. */
+FFT_AVX_TARGET static FORCEINLINE __m256 negateImAVX(__m256 x) {
+	return _mm256_xor_ps(x, _mm256_castsi256_ps(_mm256_set1_epi64x(0x8000000000000000LL)));
+}
+
+/** Swap the real and imaginary parts of four complex values. */
+FFT_AVX_TARGET static FORCEINLINE __m256 swapReImAVX(__m256 x) {
+	return _mm256_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+/** Duplicate each of four values, for the real and imaginary part of four complex values. */
+FFT_AVX_TARGET static FORCEINLINE __m256 duplicateAVX(__m128 x) {
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(x, x)), _mm_unpackhi_ps(x, x), 1);
+}
+
+FFT_AVX_TARGET static void passAVX(Complex *z, const float *wre, unsigned int n) {
+	const unsigned int o1 = 2 * n;
+	const float *wim = wre + o1;
+
+	float *z0 = reinterpret_cast<float *>(z);
+	float *z1 = z0 + 2 * o1;
+	float *z2 = z1 + 2 * o1;
+	float *z3 = z2 + 2 * o1;
+
+	// The smallest pass, for 32 points, still has 8 values in each quarter
+	assert((o1 % 4) == 0);
+
+	for (unsigned int k = 0; k < o1; k += 4, z0 += 8, z1 += 8, z2 += 8, z3 += 8) {
+		const __m128 r = _mm_loadu_ps(wre + k);
+		const __m128 i = _mm_loadu_ps(wim - k - 3);
+
+		__m256 wr = duplicateAVX(r);
+		__m256 wi = duplicateAVX(_mm_shuffle_ps(i, i, _MM_SHUFFLE(0, 1, 2, 3)));
+
+		if (k == 0) {
+			// The first value is TRANSFORM_ZERO, i.e. multiplied by exactly 1
+			wr = _mm256_blend_ps(wr, _mm256_set1_ps(1.0f), 0x03);
+			wi = _mm256_blend_ps(wi, _mm256_setzero_ps(), 0x03);
+		}
+
+		const __m256 a0 = _mm256_loadu_ps(z0);
+		const __m256 a1 = _mm256_loadu_ps(z1);
+		const __m256 a2 = _mm256_loadu_ps(z2);
+		const __m256 a3 = _mm256_loadu_ps(z3);
+
+		const __m256 p = _mm256_add_ps(_mm256_mul_ps(a2, wr), negateImAVX(_mm256_mul_ps(swapReImAVX(a2), wi)));
+		const __m256 q = _mm256_add_ps(_mm256_mul_ps(a3, wr), negateReAVX(_mm256_mul_ps(swapReImAVX(a3), wi)));
+
+		const __m256 s = _mm256_add_ps(q, p);
+		const __m256 d = negateImAVX(swapReImAVX(_mm256_sub_ps(p, q)));
+
+		_mm256_storeu_ps(z0, _mm256_add_ps(a0, s));
+		_mm256_storeu_ps(z2, _mm256_sub_ps(a0, s));
+		_mm256_storeu_ps(z1, _mm256_add_ps(a1, d));
+		_mm256_storeu_ps(z3, _mm256_sub_ps(a1, d));
+	}
+
+	// Avoid the penalty for mixing AVX and SSE code in the callers
+	_mm256_zeroupper();
+}
+
+static const FFTPasses kPassesAVX = { passAVX, passAVX };
+
+#endif // FFT_AVX
+
+static const FFTPasses *getFFTPasses(TransformKernels kernels) {
+	switch (kernels) {
+#ifdef FFT_SSE
+		case kTransformKernelsSSE:
+			return &kPassesSSE;
+#endif
+
+#ifdef FFT_AVX
+		case kTransformKernelsAVX:
+			return &kPassesAVX;
+#endif
+
+		default:
+			break;
+	}
+
+	return &kPassesScalar;
+}
+
+#define DECL_FFT(t,n,n2,n4,p)\
+static void fft##n(Complex *z, const FFTPasses &passes)\
 {\
-	fft##n2(z);\
-	fft##n4(z+n4*2);\
-	fft##n4(z+n4*3);\
-	pass(z,getCosineTable(t),n4/2);\
+	fft##n2(z, passes);\
+	fft##n4(z+n4*2, passes);\
+	fft##n4(z+n4*3, passes);\
+	passes.p(z,getCosineTable(t),n4/2);\
 }
 
-static void fft4(Complex *z)
+static void fft4(Complex *z, const FFTPasses &UNUSED(passes))
 {
 	float t1, t2, t3, t4, t5, t6, t7, t8;
 
@@ -213,11 +451,11 @@ static void fft4(Complex *z)
 	BF(z[2].im, z[0].im, t2, t5);
 }
 
-static void fft8(Complex *z)
+static void fft8(Complex *z, const FFTPasses &passes)
 {
 	float t1, t2, t3, t4, t5, t6, t7, t8;
 
-	fft4(z);
+	fft4(z, passes);
 
 	BF(t1, z[5].re, z[4].re, -z[5].re);
 	BF(t2, z[5].im, z[4].im, -z[5].im);
@@ -233,13 +471,13 @@ static void fft8(Complex *z)
 	TRANSFORM(z[1],z[3],z[5],z[7],sqrthalf,sqrthalf);
 }
 
-static void fft16(Complex *z)
+static void fft16(Complex *z, const FFTPasses &passes)
 {
 	float t1, t2, t3, t4, t5, t6;
 
-	fft8(z);
-	fft4(z+8);
-	fft4(z+12);
+	fft8(z, passes);
+	fft4(z+8, passes);
+	fft4(z+12, passes);
 
 	const float * const cosTable = getCosineTable(4);
 
@@ -249,27 +487,26 @@ static void fft16(Complex *z)
 	TRANSFORM(z[3],z[7],z[11],z[15],cosTable[3],cosTable[1]);
 }
 
-DECL_FFT(5, 32,16,8)
-DECL_FFT(6, 64,32,16)
-DECL_FFT(7, 128,64,32)
-DECL_FFT(8, 256,128,64)
-DECL_FFT(9, 512,256,128)
-#define pass pass_big
-DECL_FFT(10, 1024,512,256)
-DECL_FFT(11, 2048,1024,512)
-DECL_FFT(12, 4096,2048,1024)
-DECL_FFT(13, 8192,4096,2048)
-DECL_FFT(14, 16384,8192,4096)
-DECL_FFT(15, 32768,16384,8192)
-DECL_FFT(16, 65536,32768,16384)
-
-static void (* const fft_dispatch[])(Complex*) = {
+DECL_FFT(5, 32,16,8, pass)
+DECL_FFT(6, 64,32,16, pass)
+DECL_FFT(7, 128,64,32, pass)
+DECL_FFT(8, 256,128,64, pass)
+DECL_FFT(9, 512,256,128, pass)
+DECL_FFT(10, 1024,512,256, passBig)
+DECL_FFT(11, 2048,1024,512, passBig)
+DECL_FFT(12, 4096,2048,1024, passBig)
+DECL_FFT(13, 8192,4096,2048, passBig)
+DECL_FFT(14, 16384,8192,4096, passBig)
+DECL_FFT(15, 32768,16384,8192, passBig)
+DECL_FFT(16, 65536,32768,16384, passBig)
+
+static void (* const fft_dispatch[])(Complex*, const FFTPasses&) = {
 	fft4, fft8, fft16, fft32, fft64, fft128, fft256, fft512, fft1024,
 	fft2048, fft4096, fft8192, fft16384, fft32768, fft65536,
 };
 
 void FFT::calc(Complex *z) {
-	fft_dispatch[_bits - 2](z);
+	fft_dispatch[_bits - 2](z, *_passes);
 }
 
 } // End of namespace Common
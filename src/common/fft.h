@@ -61,13 +61,31 @@
 namespace Common {
 
 struct Complex;
+struct FFTPasses;
+
+/** The implementations of the inner loops of the FFT, and the transforms built on it. */
+enum TransformKernels {
+	kTransformKernelsAuto,   ///< The fastest kernels this CPU supports.
+	kTransformKernelsScalar, ///< Plain C++, the reference implementation.
+	kTransformKernelsSSE,    ///< SSE2, on x86 and x86-64.
+	kTransformKernelsAVX     ///< AVX, on x86 and x86-64 CPUs that support it.
+};
+
+/** Can these transform kernels be used on this CPU? */
+bool hasTransformKernels(TransformKernels kernels);
+
+/** Return the fastest transform kernels this CPU supports. */
+TransformKernels getBestTransformKernels();
 
 /** (Inverse) Fast Fourier Transform. */
 class FFT : boost::noncopyable {
 public:
-	FFT(int bits, bool inverse);
+	FFT(int bits, bool inverse, TransformKernels kernels = kTransformKernelsAuto);
 	~FFT();
 
+	/** Return the transform kernels this FFT uses. */
+	TransformKernels getKernels() const;
+
 	const uint16 *getRevTab() const;
 
 	/** Do the permutation needed BEFORE calling calc(). */
@@ -84,6 +102,9 @@ private:
 	int  _bits;
 	bool _inverse;
 
+	TransformKernels _kernels;
+	const FFTPasses *_passes;
+
 	ScopedArray<uint16> _revTab;
 
 	ScopedArray<Complex> _expTab;
@@ -214,6 +214,86 @@ static inline uint32 hashStringCRC32(const UString &string, Encoding encoding) {
 }
 // '--- CRC32, based on the implementation by Gary S. Brown ---'
 
+/** A string hash, computed character by character.
+ *
+ *  Feeding characters into a Hasher results in the same hash as
+ *  hashString() on the string they make up, without needing to
+ *  build that string first.
+ */
+class Hasher {
+public:
+	Hasher(HashAlgo algo) : _algo(algo), _hash(0) {
+		switch (_algo) {
+			case kHashDJB2:
+				_hash = 5381;
+				break;
+
+			case kHashFNV32:
+				_hash = 0x811C9DC5;
+				break;
+
+			case kHashFNV64:
+				_hash = 0xCBF29CE484222325LL;
+				break;
+
+			case kHashCRC32:
+				_hash = 0xFFFFFFFF;
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	/** Add one Unicode codepoint to the hash. */
+	void add(uint32 c) {
+		switch (_algo) {
+			case kHashDJB2:
+				_hash = hashDJB2((uint32) _hash, c);
+				break;
+
+			case kHashFNV32:
+				_hash = hashFNV32((uint32) _hash, c);
+				break;
+
+			case kHashFNV64:
+				_hash = hashFNV64(_hash, c);
+				break;
+
+			case kHashCRC32:
+				_hash = hashCRC32((uint32) _hash, c);
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	/** Add all characters of a string to the hash. */
+	void add(const UString &string) {
+		for (UString::iterator it = string.begin(); it != string.end(); ++it)
+			add(*it);
+	}
+
+	/** Add all characters of a string to the hash, converted to lowercase. */
+	void addLower(const UString &string) {
+		for (UString::iterator it = string.begin(); it != string.end(); ++it)
+			add(UString::toLower(*it));
+	}
+
+	/** Return the hash of all characters added so far. */
+	uint64 getHash() const {
+		if (_algo == kHashCRC32)
+			return _hash ^ 0xFFFFFFFF;
+
+		return _hash;
+	}
+
+private:
+	HashAlgo _algo;
+	uint64 _hash;
+};
+
 /** Hash the string with the given algorithm, as a series of UTF-8 characters. */
 static inline uint64 hashString(const UString &string, HashAlgo algo) {
 	switch (algo) {
@@ -236,6 +316,18 @@ static inline uint64 hashString(const UString &string, HashAlgo algo) {
 	return 0;
 }
 
+/** Hash the lowercase version of the string with the given algorithm, as a series of UTF-8 characters.
+ *
+ *  The same as hashString(string.toLower(), algo), without creating a temporary string.
+ */
+static inline uint64 hashStringLower(const UString &string, HashAlgo algo) {
+	Hasher hasher(algo);
+
+	hasher.addLower(string);
+
+	return hasher.getHash();
+}
+
 /** Hash the string with the given algorithm, as a series of bytes in the given encoding. */
 static inline uint64 hashString(const UString &string, HashAlgo algo, Encoding encoding) {
 	switch (algo) {
@@ -24,14 +24,36 @@
 
 #include <cassert>
 
+#include <algorithm>
+#include <map>
+
 #include "src/common/huffman.h"
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/bitstream.h"
 
+/** The maximum number of bits a single lookup table is indexed with. */
+static const uint8 kMaxTableBits = 9;
+
+/** Reverse the order of the lowest n bits of value. */
+static uint32 reverseBits(uint32 value, uint8 n) {
+	uint32 result = 0;
+	for (uint8 i = 0; i < n; i++, value >>= 1)
+		result = (result << 1) | (value & 1);
+
+	return result;
+}
+
 namespace Common {
 
-Huffman::Symbol::Symbol(uint32 c, uint32 s) : code(c), symbol(s) {
+Huffman::Entry::Entry() : value(0), length(0) {
+}
+
+Huffman::Entry::Entry(uint32 v, int8 l) : value(v), length(l) {
+}
+
+
+Huffman::Code::Code(uint32 c, uint8 l, uint32 i) : code(c), length(l), index(i) {
 }
 
 
@@ -45,6 +67,10 @@ Huffman::Huffman(uint8 maxLength, size_t codeCount, const uint32 *codes,
 	init(maxLength, codeCount, codes, lengths, symbols);
 }
 
+bool Huffman::compareCodeLength(const Code &a, const Code &b) {
+	return a.length < b.length;
+}
+
 void Huffman::init(uint8 maxLength, size_t codeCount, const uint32 *codes,
                    const uint8 *lengths, const uint32 *symbols) {
 
@@ -59,18 +85,92 @@ void Huffman::init(uint8 maxLength, size_t codeCount, const uint32 *codes,
 
 	assert(maxLength <= 32);
 
-	_codes.resize(maxLength);
 	_symbols.resize(codeCount);
+	setSymbols(symbols);
+
+	/* Collect the codes in the order their bits are read from the stream, first
+	 * bit in the MSB. For MSB-first streams, that's just the code itself. For
+	 * LSB-first streams, the first bit read is stored in the LSB of the code. */
+
+	Codes codesMSB, codesLSB;
+	codesMSB.reserve(codeCount);
+	codesLSB.reserve(codeCount);
 
 	for (size_t i = 0; i < codeCount; i++) {
-		// The symbol. If none were specified, just assume it's identical to the code index
-		uint32 symbol = symbols ? symbols[i] : i;
+		const uint8 length = lengths[i];
+		if ((length == 0) || (length > maxLength))
+			continue;
+
+		const uint32 code = (uint32) (codes[i] & ((1ULL << length) - 1));
+
+		codesMSB.push_back(Code(code                     , length, i));
+		codesLSB.push_back(Code(reverseBits(code, length), length, i));
+	}
+
+	/* Shorter codes take precedence over longer ones, and within the same
+	 * length, codes earlier in the list take precedence over later ones. */
+	std::stable_sort(codesMSB.begin(), codesMSB.end(), compareCodeLength);
+	std::stable_sort(codesLSB.begin(), codesLSB.end(), compareCodeLength);
+
+	_tableBits = MIN(maxLength, kMaxTableBits);
+
+	_tableMSB.resize(1 << _tableBits);
+	_tableLSB.resize(1 << _tableBits);
 
-		// Put the code and symbol into the correct list
-		_codes[lengths[i] - 1].push_back(Symbol(codes[i], symbol));
+	buildTable(_tableMSB, 0, _tableBits, codesMSB, true);
+	buildTable(_tableLSB, 0, _tableBits, codesLSB, false);
+}
+
+void Huffman::buildTable(Table &table, size_t offset, uint8 bits, const Codes &codes, bool msbFirst) {
+	/* Fill in the entries for all codes fitting into this table directly.
+	 * A code occupies all entries starting with its bits. */
+
+	typedef std::map<uint32, Codes> SubCodes;
+	SubCodes subCodes;
+
+	for (Codes::const_iterator c = codes.begin(); c != codes.end(); ++c) {
+		if (c->length > bits) {
+			// Longer code, sort it into the subtable of its prefix
+			const uint8 subLength = c->length - bits;
+
+			const uint32 prefix = c->code >> subLength;
+			const uint32 suffix = (uint32) (c->code & ((1ULL << subLength) - 1));
+
+			subCodes[prefix].push_back(Code(suffix, subLength, c->index));
+			continue;
+		}
+
+		const uint8  freeBits = bits - c->length;
+		const uint32 first    = c->code << freeBits;
+
+		for (uint32 i = 0; i < (1U << freeBits); i++) {
+			const uint32 index = msbFirst ? (first | i) : reverseBits(first | i, bits);
+
+			Entry &entry = table[offset + index];
+			if (entry.length == 0)
+				entry = Entry(c->index, c->length);
+		}
+	}
 
-		// And put the pointer to the symbol/code struct into the symbol list.
-		_symbols[i] = &_codes[lengths[i] - 1].back();
+	for (SubCodes::const_iterator s = subCodes.begin(); s != subCodes.end(); ++s) {
+		const uint32 index = msbFirst ? s->first : reverseBits(s->first, bits);
+
+		// Unreachable, because a shorter code has this prefix
+		if (table[offset + index].length > 0)
+			continue;
+
+		uint8 subBits = 0;
+		for (Codes::const_iterator c = s->second.begin(); c != s->second.end(); ++c)
+			subBits = MAX(subBits, c->length);
+
+		subBits = MIN(subBits, kMaxTableBits);
+
+		const size_t subOffset = table.size();
+		table.resize(subOffset + (1 << subBits));
+
+		table[offset + index] = Entry(subOffset, -((int8) subBits));
+
+		buildTable(table, subOffset, subBits, s->second, msbFirst);
 	}
 }
 
@@ -79,21 +179,11 @@ Huffman::~Huffman() {
 
 void Huffman::setSymbols(const uint32 *symbols) {
 	for (size_t i = 0; i < _symbols.size(); i++)
-		_symbols[i]->symbol = symbols ? *symbols++ : i;
+		_symbols[i] = symbols ? *symbols++ : i;
 }
 
 uint32 Huffman::getSymbol(BitStream &bits) const {
-	uint32 code = 0;
-
-	for (size_t i = 0; i < _codes.size(); i++) {
-		bits.addBit(code, i);
-
-		for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-			if (code == cCode->code)
-				return cCode->symbol;
-	}
-
-	throw Exception("Unknown Huffman code");
+	return getSymbol<BitStream>(bits);
 }
 
 } // End of namespace Common
@@ -26,9 +26,9 @@
 #define COMMON_HUFFMAN_H
 
 #include <vector>
-#include <list>
 
 #include "src/common/types.h"
+#include "src/common/error.h"
 
 namespace Common {
 
@@ -43,7 +43,16 @@ struct HuffmanTable {
 	const uint32 *symbols; ///< The symbols, 0 if identical to the codes.
 };
 
-/** Decode a Huffman'd bitstream. */
+/** Decode a Huffman'd bitstream.
+ *
+ *  The codes are decoded with the help of multi-level lookup tables: the
+ *  next few bits in the stream are peeked at once and directly index a table
+ *  entry, which either contains the decoded symbol or points to a subtable
+ *  for longer codes.
+ *
+ *  Since the layout of these tables depends on the order the bits are handed
+ *  out by the bit stream, a table for both orders is built.
+ */
 class Huffman {
 public:
 	/** Construct a Huffman decoder.
@@ -65,26 +74,77 @@ public:
 	/** Return the next symbol in the bitstream. */
 	uint32 getSymbol(BitStream &bits) const;
 
+	/** Return the next symbol in the bitstream.
+	 *
+	 *  This works on any bit stream type providing the same interface as
+	 *  BitStream, like a MemoryBitStreamImpl, without any virtual calls.
+	 */
+	template<class BitStreamType>
+	uint32 getSymbol(BitStreamType &bits) const {
+		const Table &table = bits.isMSBFirst() ? _tableMSB : _tableLSB;
+
+		size_t offset    = 0;
+		size_t tableBits = _tableBits;
+
+		while (true) {
+			const Entry &entry = table[offset + bits.peekBits(tableBits)];
+
+			if (entry.length > 0) {
+				bits.skip(entry.length);
+				return _symbols[entry.value];
+			}
+
+			if (entry.length == 0)
+				break;
+
+			// Descend into the subtable
+			bits.skip(tableBits);
+
+			offset    = entry.value;
+			tableBits = -entry.length;
+		}
+
+		throw Exception("Unknown Huffman code");
+	}
+
 private:
-	struct Symbol {
+	/** An entry in a lookup table. */
+	struct Entry {
+		/** The index of the code if this is a leaf, otherwise the offset of the subtable. */
+		uint32 value;
+		/** > 0: the length of the code, < 0: the negated bit count of the subtable, 0: invalid. */
+		int8 length;
+
+		Entry();
+		Entry(uint32 v, int8 l);
+	};
+
+	/** A code, in the order the bits are read from the stream. */
+	struct Code {
 		uint32 code;
-		uint32 symbol;
+		uint8  length;
+		uint32 index;
 
-		Symbol(uint32 c, uint32 s);
+		Code(uint32 c, uint8 l, uint32 i);
 	};
 
-	typedef std::list<Symbol>     CodeList;
-	typedef std::vector<CodeList> CodeLists;
-	typedef std::vector<Symbol *> SymbolList;
+	typedef std::vector<Entry> Table;
+	typedef std::vector<Code>  Codes;
 
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
+	/** The symbols, indexed by code index. */
+	std::vector<uint32> _symbols;
 
-	/** Sorted list of pointers to the symbols. */
-	SymbolList _symbols;
+	/** The number of bits the root tables are indexed with. */
+	uint8 _tableBits;
+
+	Table _tableMSB; ///< Lookup table for bit streams handing out bits MSB to LSB.
+	Table _tableLSB; ///< Lookup table for bit streams handing out bits LSB to MSB.
 
 	void init(uint8 maxLength, size_t codeCount, const uint32 *codes,
 	          const uint8 *lengths, const uint32 *symbols);
+
+	static bool compareCodeLength(const Code &a, const Code &b);
+	static void buildTable(Table &table, size_t offset, uint8 bits, const Codes &codes, bool msbFirst);
 };
 
 } // End of namespace Common
@@ -55,10 +55,10 @@
 
 namespace Common {
 
-MDCT::MDCT(int bits, bool inverse, double scale) : _bits(bits) {
+MDCT::MDCT(int bits, bool inverse, double scale, TransformKernels kernels) : _bits(bits) {
 	_size = 1 << bits;
 
-	_fft.reset(new FFT(_bits - 2, inverse));
+	_fft.reset(new FFT(_bits - 2, inverse, kernels));
 
 	const int size2 = _size >> 1;
 	const int size4 = _size >> 2;
@@ -91,7 +91,7 @@ void MDCT::calcMDCT(float *output, const float *input) {
 	const int size2 = _size >> 1;
 	const int size4 = _size >> 2;
 	const int size8 = _size >> 3;
-	const int size3 = _size * 3;
+	const int size3 = size4 * 3;
 
 	const uint16 *revTab = _fft->getRevTab();
 
@@ -55,15 +55,14 @@
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/fft.h"
 
 namespace Common {
 
-class FFT;
-
 /** (Inverse) Modified Discrete Cosine Transforms. */
 class MDCT : boost::noncopyable {
 public:
-	MDCT(int bits, bool inverse, double scale);
+	MDCT(int bits, bool inverse, double scale, TransformKernels kernels = kTransformKernelsAuto);
 	~MDCT();
 
 	/** Compute MDCT of size N = 2^nbits. */
@@ -0,0 +1,383 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A bit stream reading directly from memory.
+ */
+
+#ifndef COMMON_MEMBITSTREAM_H
+#define COMMON_MEMBITSTREAM_H
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/util.h"
+#include "src/common/endianness.h"
+#include "src/common/error.h"
+
+namespace Common {
+
+/** A template implementing a bit stream reading directly from a memory buffer.
+ *
+ *  It hands out the bits in exactly the same order as the BitStreamImpl with
+ *  the same memory layout parameters, and it provides the same interface.
+ *  However, none of its methods are virtual, and instead of reading data
+ *  values one by one through a ReadStream, it keeps up to 64 bits cached
+ *  and refills them straight from memory, whole words at a time where the
+ *  layout allows it.
+ *
+ *  Hot decoding loops can therefore be instantiated on this class at compile
+ *  time, with all bit reading inlined into them. Note that the memory buffer
+ *  is not copied, it has to outlive the bit stream.
+ */
+template<int valueBits, bool isLE, bool isMSB2LSB>
+class MemoryBitStreamImpl : boost::noncopyable {
+private:
+	/** The size of a data value in bytes. */
+	static const size_t kValueSize = valueBits / 8;
+
+	/** Does the memory layout form one continuous bit sequence through all bytes?
+	 *
+	 *  That's the case when the order of the bytes and the order of the bits
+	 *  within the data values match. Then we can refill by reading a whole
+	 *  64-bit word at once.
+	 */
+	static const bool kSequential = (valueBits == 8) || (isLE != isMSB2LSB);
+
+	const byte *_data; ///< The input data.
+	size_t      _size; ///< The size of the input data, in whole data values.
+	size_t      _pos;  ///< The position of the next data value to be cached.
+
+	/** Cached bits.
+	 *
+	 *  When reading MSB to LSB, the next bit is the MSB of the cache,
+	 *  otherwise it's the LSB of the cache. All bits past the number of
+	 *  cached bits are always 0.
+	 */
+	uint64 _cache;
+	size_t _cacheBits; ///< Number of bits in the cache.
+
+	/** Read a data value from memory. */
+	static inline uint64 readValue(const byte *data) {
+		if (valueBits ==  8)
+			return *data;
+
+		if (isLE) {
+			if (valueBits == 16)
+				return READ_LE_UINT16(data);
+			if (valueBits == 32)
+				return READ_LE_UINT32(data);
+			if (valueBits == 64)
+				return READ_LE_UINT64(data);
+		} else {
+			if (valueBits == 16)
+				return READ_BE_UINT16(data);
+			if (valueBits == 32)
+				return READ_BE_UINT32(data);
+			if (valueBits == 64)
+				return READ_BE_UINT64(data);
+		}
+
+		return 0;
+	}
+
+	/** Fill the cache with as many whole data values as fit. */
+	inline void refill() {
+		if (kSequential && ((_pos + 8) <= _size)) {
+			// Read a whole word, and keep as many whole data values of it as fit
+
+			const size_t bytes = ((64 - _cacheBits) >> 3) & ~(kValueSize - 1);
+			if (bytes == 0)
+				return;
+
+			const size_t bits = bytes * 8;
+
+			if (isMSB2LSB) {
+				uint64 word = READ_BE_UINT64(_data + _pos);
+				if (bits < 64)
+					word &= ~(0xFFFFFFFFFFFFFFFFULL >> bits);
+
+				_cache |= word >> _cacheBits;
+			} else {
+				uint64 word = READ_LE_UINT64(_data + _pos);
+				if (bits < 64)
+					word &= (1ULL << bits) - 1;
+
+				_cache |= word << _cacheBits;
+			}
+
+			_cacheBits += bits;
+			_pos       += bytes;
+			return;
+		}
+
+		while (((_cacheBits + valueBits) <= 64) && ((_pos + kValueSize) <= _size)) {
+			const uint64 value = readValue(_data + _pos);
+
+			if (isMSB2LSB)
+				_cache |= (value << (64 - valueBits)) >> _cacheBits;
+			else
+				_cache |= value << _cacheBits;
+
+			_cacheBits += valueBits;
+			_pos       += kValueSize;
+		}
+	}
+
+	/** Return the next n bits in the cache, 0 < n <= min(32, _cacheBits). */
+	inline uint32 peekCache(size_t n) const {
+		if (isMSB2LSB)
+			return (uint32) (_cache >> (64 - n));
+
+		return (uint32) (_cache & ((1ULL << n) - 1));
+	}
+
+	/** Remove n bits from the cache, n <= _cacheBits. */
+	inline void consumeCache(size_t n) {
+		if (n >= 64)
+			_cache = 0;
+		else if (isMSB2LSB)
+			_cache <<= n;
+		else
+			_cache >>= n;
+
+		_cacheBits -= n;
+	}
+
+	/** Read n bits straddling the cache and the next data value. */
+	uint32 getBitsSlow(size_t n) {
+		if ((_cacheBits + (_size - _pos) * 8) < n)
+			throw Exception("MemoryBitStream::getBits(): End of bit stream reached");
+
+		const size_t have = _cacheBits;
+
+		const uint64 head = (have > 0) ? peekCache(have) : 0;
+		consumeCache(have);
+
+		refill();
+
+		const uint64 tail = peekCache(n - have);
+		consumeCache(n - have);
+
+		if (isMSB2LSB)
+			return (uint32) ((head << (n - have)) | tail);
+
+		return (uint32) (head | (tail << have));
+	}
+
+	/** Peek at n bits straddling the cache and the next data value. */
+	uint32 peekBitsSlow(size_t n) const {
+		const size_t have = _cacheBits;
+		const size_t need = n - have;
+
+		uint64 v = (have > 0) ? peekCache(have) : 0;
+
+		uint64 next     = 0;
+		size_t nextBits = 0;
+
+		if ((_pos + kValueSize) <= _size) {
+			next     = readValue(_data + _pos);
+			nextBits = MIN<size_t>(need, valueBits);
+		}
+
+		if (isMSB2LSB) {
+			if (nextBits > 0)
+				v = (v << nextBits) | (next >> (valueBits - nextBits));
+
+			// Pad bits past the end of the stream with 0
+			v <<= need - nextBits;
+		} else {
+			if (nextBits > 0)
+				v |= (next & ((1ULL << nextBits) - 1)) << have;
+		}
+
+		return (uint32) v;
+	}
+
+public:
+	/** Create a bit stream reading from this memory buffer. */
+	MemoryBitStreamImpl(const byte *data, size_t size) : _data(data),
+		_size(size & ~(kValueSize - 1)), _pos(0), _cache(0), _cacheBits(0) {
+
+		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32) && (valueBits != 64))
+			throw Exception("MemoryBitStream: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+	}
+
+	~MemoryBitStreamImpl() {
+	}
+
+	/** Read a bit from the bit stream. */
+	inline uint32 getBit() {
+		if (_cacheBits == 0) {
+			refill();
+
+			if (_cacheBits == 0)
+				throw Exception("MemoryBitStream::getBit(): End of bit stream reached");
+		}
+
+		const uint32 b = peekCache(1);
+		consumeCache(1);
+
+		return b;
+	}
+
+	/** Read a multi-bit value from the bit stream. */
+	inline uint32 getBits(size_t n) {
+		if (n == 0)
+			return 0;
+
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		if (_cacheBits < n) {
+			refill();
+
+			if (_cacheBits < n)
+				return getBitsSlow(n);
+		}
+
+		const uint32 v = peekCache(n);
+		consumeCache(n);
+
+		return v;
+	}
+
+	/** Read a multi-bit value from the bit stream, without consuming the bits.
+	 *
+	 *  Bits past the end of the stream are read as 0.
+	 */
+	inline uint32 peekBits(size_t n) {
+		if (n == 0)
+			return 0;
+
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		if (_cacheBits < n) {
+			refill();
+
+			if (_cacheBits < n)
+				return peekBitsSlow(n);
+		}
+
+		return peekCache(n);
+	}
+
+	/** Add a bit to the n-bit value x, making it an (n+1)-bit value. */
+	inline void addBit(uint32 &x, size_t n) {
+		if (n >= 32)
+			throw Exception("Too many bits requested to be read");
+
+		if (isMSB2LSB)
+			x = (x << 1) | getBit();
+		else
+			x = (x & ~(1 << n)) | (getBit() << n);
+	}
+
+	/** Rewind the bit stream back to the start. */
+	void rewind() {
+		_pos       = 0;
+		_cache     = 0;
+		_cacheBits = 0;
+	}
+
+	/** Skip the specified amount of bits. */
+	inline void skip(size_t n) {
+		if (n <= _cacheBits) {
+			consumeCache(n);
+			return;
+		}
+
+		n -= _cacheBits;
+		consumeCache(_cacheBits);
+
+		// Jump over whole data values directly
+		const size_t values = n / valueBits;
+		if (values > ((_size - _pos) / kValueSize))
+			throw Exception("MemoryBitStream::skip(): End of bit stream reached");
+
+		_pos += values * kValueSize;
+		n    -= values * valueBits;
+
+		while (n > 0) {
+			const size_t count = MIN<size_t>(n, 32);
+
+			getBits(count);
+			n -= count;
+		}
+	}
+
+	/** Are the bits within a data value handed out from the MSB to the LSB? */
+	bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
+	/** Return the stream position in bits. */
+	size_t pos() const {
+		return _pos * 8 - _cacheBits;
+	}
+
+	/** Return the stream size in bits. */
+	size_t size() const {
+		return _size * 8;
+	}
+
+	bool eos() const {
+		return pos() >= size();
+	}
+};
+
+// typedefs for various memory layouts.
+
+/** 8-bit data, MSB to LSB. */
+typedef MemoryBitStreamImpl<8, false, true > MemoryBitStream8MSB;
+/** 8-bit data, LSB to MSB. */
+typedef MemoryBitStreamImpl<8, false, false> MemoryBitStream8LSB;
+
+/** 16-bit little-endian data, MSB to LSB. */
+typedef MemoryBitStreamImpl<16, true , true > MemoryBitStream16LEMSB;
+/** 16-bit little-endian data, LSB to MSB. */
+typedef MemoryBitStreamImpl<16, true , false> MemoryBitStream16LELSB;
+/** 16-bit big-endian data, MSB to LSB. */
+typedef MemoryBitStreamImpl<16, false, true > MemoryBitStream16BEMSB;
+/** 16-bit big-endian data, LSB to MSB. */
+typedef MemoryBitStreamImpl<16, false, false> MemoryBitStream16BELSB;
+
+/** 32-bit little-endian data, MSB to LSB. */
+typedef MemoryBitStreamImpl<32, true , true > MemoryBitStream32LEMSB;
+/** 32-bit little-endian data, LSB to MSB. */
+typedef MemoryBitStreamImpl<32, true , false> MemoryBitStream32LELSB;
+/** 32-bit big-endian data, MSB to LSB. */
+typedef MemoryBitStreamImpl<32, false, true > MemoryBitStream32BEMSB;
+/** 32-bit big-endian data, LSB to MSB. */
+typedef MemoryBitStreamImpl<32, false, false> MemoryBitStream32BELSB;
+
+/** 64-bit little-endian data, MSB to LSB. */
+typedef MemoryBitStreamImpl<64, true , true > MemoryBitStream64LEMSB;
+/** 64-bit little-endian data, LSB to MSB. */
+typedef MemoryBitStreamImpl<64, true , false> MemoryBitStream64LELSB;
+/** 64-bit big-endian data, MSB to LSB. */
+typedef MemoryBitStreamImpl<64, false, true > MemoryBitStream64BEMSB;
+/** 64-bit big-endian data, LSB to MSB. */
+typedef MemoryBitStreamImpl<64, false, false> MemoryBitStream64BELSB;
+
+} // End of namespace Common
+
+#endif // COMMON_MEMBITSTREAM_H
@@ -58,13 +58,13 @@
 
 namespace Common {
 
-RDFT::RDFT(int bits, TransformType trans) : _bits(bits) {
+RDFT::RDFT(int bits, TransformType trans, TransformKernels kernels) : _bits(bits) {
 	assert ((_bits >= 4) && (_bits <= 16));
 
 	_inverse        = trans == IDFT_C2R || trans == DFT_C2R;
 	_signConvention = trans == IDFT_R2C || trans == DFT_C2R ? 1 : -1;
 
-	_fft.reset(new FFT(bits - 1, trans == IDFT_C2R || trans == IDFT_R2C));
+	_fft.reset(new FFT(bits - 1, trans == IDFT_C2R || trans == IDFT_R2C, kernels));
 
 	int n = 1 << bits;
 
@@ -55,11 +55,10 @@
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/fft.h"
 
 namespace Common {
 
-class FFT;
-
 /** (Inverse) Real Discrete Fourier Transform. */
 class RDFT : boost::noncopyable {
 public:
@@ -70,7 +69,7 @@ public:
 		DFT_C2R
 	};
 
-	RDFT(int bits, TransformType trans);
+	RDFT(int bits, TransformType trans, TransformKernels kernels = kTransformKernelsAuto);
 	~RDFT();
 
 	void calc(float *data);
@@ -65,6 +65,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/memwritestream.h \
     src/common/streamtokenizer.h \
     src/common/stringmap.h \
+    src/common/stringarena.h \
     src/common/readline.h \
     src/common/readfile.h \
     src/common/writefile.h \
@@ -72,6 +73,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/filelist.h \
     src/common/binsearch.h \
     src/common/bitstream.h \
+    src/common/membitstream.h \
     src/common/bitstreamwriter.h \
     src/common/huffman.h \
     src/common/boundingbox.h \
@@ -122,6 +124,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/memwritestream.cpp \
     src/common/streamtokenizer.cpp \
     src/common/stringmap.cpp \
+    src/common/stringarena.cpp \
     src/common/readline.cpp \
     src/common/readfile.cpp \
     src/common/writefile.cpp \
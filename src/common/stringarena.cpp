@@ -0,0 +1,107 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  An append-only storage for lots of small strings.
+ */
+
+#include "src/common/util.h"
+#include "src/common/hash.h"
+#include "src/common/stringarena.h"
+
+namespace Common {
+
+size_t StringArena::HashView::operator()(const StringView &view) const {
+	uint32 hash = 0x811C9DC5;
+
+	for (size_t i = 0; i < view.size; i++)
+		hash = hashFNV32(hash, (byte) view.data[i]);
+
+	return hash;
+}
+
+
+StringArena::StringArena(size_t blockSize) : _blockSize(MAX<size_t>(blockSize, 1)),
+	_current(0), _available(0), _size(0) {
+
+}
+
+StringArena::~StringArena() {
+	for (std::vector<char *>::iterator b = _blocks.begin(); b != _blocks.end(); ++b)
+		delete[] *b;
+}
+
+StringView StringArena::add(const char *data, size_t size) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	Strings::const_iterator s = _strings.find(StringView(data, size));
+	if (s != _strings.end())
+		return *s;
+
+	char *str = allocate(size + 1);
+
+	std::memcpy(str, data, size);
+	str[size] = '\0';
+
+	_size += size + 1;
+
+	return *_strings.insert(StringView(str, size)).first;
+}
+
+StringView StringArena::add(const UString &str) {
+	return add(str.c_str(), std::strlen(str.c_str()));
+}
+
+size_t StringArena::getStringCount() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return _strings.size();
+}
+
+size_t StringArena::getSize() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return _size;
+}
+
+char *StringArena::allocate(size_t size) {
+	// Strings that would waste most of a fresh block get one of their own
+	if (size > (_blockSize / 4)) {
+		_blocks.push_back(new char[size]);
+
+		return _blocks.back();
+	}
+
+	if (size > _available) {
+		_blocks.push_back(new char[_blockSize]);
+
+		_current   = _blocks.back();
+		_available = _blockSize;
+	}
+
+	char *str = _current;
+
+	_current   += size;
+	_available -= size;
+
+	return str;
+}
+
+} // End of namespace Common
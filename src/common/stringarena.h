@@ -0,0 +1,118 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  An append-only storage for lots of small strings.
+ */
+
+#ifndef COMMON_STRINGARENA_H
+#define COMMON_STRINGARENA_H
+
+#include <cstring>
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/unordered/unordered_set.hpp>
+
+#include "src/common/types.h"
+#include "src/common/mutex.h"
+#include "src/common/ustring.h"
+
+namespace Common {
+
+/** A read-only view of an UTF-8 string owned by someone else. */
+struct StringView {
+	const char *data; ///< The string's bytes, always \0-terminated.
+	size_t size;      ///< The length of the string in bytes, without the terminator.
+
+	StringView() : data(""), size(0) {
+	}
+
+	StringView(const char *d, size_t s) : data(d), size(s) {
+	}
+
+	bool empty() const {
+		return size == 0;
+	}
+
+	bool operator==(const StringView &right) const {
+		return (size == right.size) && (std::memcmp(data, right.data, size) == 0);
+	}
+
+	/** Create a real string out of this view. */
+	UString toString() const {
+		return UString(data, size);
+	}
+};
+
+/** An append-only storage for lots of small strings.
+ *
+ *  Strings are packed into large blocks of memory, instead of each
+ *  one living in its own small allocation. A string, once added,
+ *  never moves and stays valid until the arena is destroyed.
+ *
+ *  Strings are interned: adding the same string twice stores it only
+ *  once, and returns the same view both times.
+ *
+ *  Strings can be added from several threads at the same time.
+ */
+class StringArena : boost::noncopyable {
+public:
+	StringArena(size_t blockSize = 65536);
+	~StringArena();
+
+	/** Add a copy of these bytes to the arena. */
+	StringView add(const char *data, size_t size);
+	/** Add a copy of this string to the arena. */
+	StringView add(const UString &str);
+
+	/** Return the number of distinct strings in the arena. */
+	size_t getStringCount() const;
+	/** Return the number of bytes used by the strings in the arena, including terminators. */
+	size_t getSize() const;
+
+private:
+	struct HashView {
+		size_t operator()(const StringView &view) const;
+	};
+
+	typedef boost::unordered_set<StringView, HashView> Strings;
+
+
+	size_t _blockSize;
+
+	std::vector<char *> _blocks;
+
+	char  *_current;   ///< The next free byte in the current block.
+	size_t _available; ///< The number of free bytes in the current block.
+
+	size_t _size;
+
+	Strings _strings;
+
+	mutable std::mutex _mutex;
+
+	char *allocate(size_t size);
+};
+
+} // End of namespace Common
+
+#endif // COMMON_STRINGARENA_H
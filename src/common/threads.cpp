@@ -26,6 +26,14 @@
 
 #include <cassert>
 
+#include <vector>
+#include <list>
+#include <atomic>
+#include <memory>
+#include <exception>
+
+#include <boost/noncopyable.hpp>
+
 #if defined(__MINGW32__ ) && !defined(_GLIBCXX_HAS_GTHREADS)
 	#include "external/mingw-std-threads/mingw.thread.h"
 #else
@@ -33,7 +41,9 @@
 #endif
 
 #include "src/common/types.h"
+#include "src/common/util.h"
 #include "src/common/error.h"
+#include "src/common/mutex.h"
 #include "src/common/threads.h"
 
 static bool            threadsInited = false;
@@ -63,4 +73,188 @@ void enforceMainThread() {
 		throw Exception("Unsafe function called in non-main thread");
 }
 
+size_t getParallelThreadCount() {
+	return MAX<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+namespace {
+
+/** A single runParallel() call, shared between the calling thread and the worker threads. */
+struct ParallelJob {
+	const std::function<void(size_t)> &task;
+	const size_t count;
+
+	std::atomic<size_t> next; ///< The next index to hand out.
+	std::vector<std::exception_ptr> errors;
+
+	/** The number of worker threads currently working on this job. Guarded by the pool mutex. */
+	size_t workers;
+
+	ParallelJob(size_t c, const std::function<void(size_t)> &t) :
+		task(t), count(c), next(0), errors(c), workers(0) {
+
+	}
+
+	/** Call tasks until all indices have been handed out. */
+	void run() {
+		for (size_t i = next++; i < count; i = next++) {
+			try {
+				task(i);
+			} catch (...) {
+				errors[i] = std::current_exception();
+			}
+		}
+	}
+
+	bool isHandedOut() const {
+		return next.load() >= count;
+	}
+};
+
+/** The worker threads behind runParallel() and runInBackground().
+ *
+ *  The threads are started once, on first use, and then sleep until
+ *  there's work for them. That way, even calling runParallel() for
+ *  every single video frame is cheap.
+ */
+class WorkerPool : boost::noncopyable {
+public:
+	WorkerPool() : _quit(false) {
+		// The calling thread helps with runParallel(), but background tasks need at least one worker
+		const size_t threadCount = MAX<size_t>(getParallelThreadCount() - 1, 1);
+
+		_threads.reserve(threadCount);
+		for (size_t i = 0; i < threadCount; i++) {
+			try {
+				_threads.push_back(std::thread(&WorkerPool::threadMethod, this));
+			} catch (...) {
+				// Couldn't start another thread. Not fatal, we just have to make do with the ones we have
+				break;
+			}
+		}
+	}
+
+	~WorkerPool() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_quit = true;
+		}
+
+		_wake.notify_all();
+
+		for (std::vector<std::thread>::iterator t = _threads.begin(); t != _threads.end(); ++t)
+			t->join();
+	}
+
+	void runParallel(ParallelJob &job) {
+		if (!_threads.empty() && (job.count > 1)) {
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			_jobs.push_back(&job);
+			_wake.notify_all();
+		}
+
+		// The calling thread does its share of the work, too
+		job.run();
+
+		// Everything is handed out now. Wait for the workers still busy with their last task
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		_jobs.remove(&job);
+		_finished.wait(lock, [&job] { return job.workers == 0; });
+	}
+
+	void runInBackground(const std::function<void()> &task) {
+		if (_threads.empty()) {
+			task();
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_tasks.push_back(task);
+		_wake.notify_one();
+	}
+
+private:
+	std::mutex _mutex;
+	std::condition_variable _wake;     ///< Signals new work, or that the threads should quit.
+	std::condition_variable _finished; ///< Signals that a worker left a parallel job.
+
+	std::list<ParallelJob *> _jobs;
+	std::list<std::function<void()> > _tasks;
+
+	std::vector<std::thread> _threads;
+
+	bool _quit;
+
+	void threadMethod() {
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		while (true) {
+			_wake.wait(lock, [this] { return _quit || !_jobs.empty() || !_tasks.empty(); });
+			if (_quit)
+				break;
+
+			// Someone is waiting for the parallel jobs, so they go first
+			if (!_jobs.empty()) {
+				ParallelJob &job = *_jobs.front();
+				if (job.isHandedOut()) {
+					_jobs.pop_front();
+					continue;
+				}
+
+				job.workers++;
+
+				lock.unlock();
+				job.run();
+				lock.lock();
+
+				_jobs.remove(&job);
+				if (--job.workers == 0)
+					_finished.notify_all();
+
+				continue;
+			}
+
+			std::function<void()> task;
+			task.swap(_tasks.front());
+			_tasks.pop_front();
+
+			lock.unlock();
+			task();
+			lock.lock();
+		}
+	}
+};
+
+WorkerPool &getWorkerPool() {
+	static WorkerPool pool;
+
+	return pool;
+}
+
+} // End of anonymous namespace
+
+void runParallel(size_t count, const std::function<void(size_t)> &task) {
+	if (count == 0)
+		return;
+
+	ParallelJob job(count, task);
+	getWorkerPool().runParallel(job);
+
+	for (std::vector<std::exception_ptr>::const_iterator e = job.errors.begin(); e != job.errors.end(); ++e)
+		if (*e)
+			std::rethrow_exception(*e);
+}
+
+std::future<void> runInBackground(const std::function<void()> &task) {
+	std::shared_ptr<std::packaged_task<void()> > packagedTask = std::make_shared<std::packaged_task<void()> >(task);
+
+	std::future<void> result = packagedTask->get_future();
+	getWorkerPool().runInBackground([packagedTask] { (*packagedTask)(); });
+
+	return result;
+}
+
 } // End of namespace Common
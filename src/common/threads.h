@@ -27,6 +27,16 @@
 #ifndef COMMON_THREADS_H
 #define COMMON_THREADS_H
 
+#include <cstddef>
+
+#include <functional>
+
+#if defined(__MINGW32__ ) && !defined(_GLIBCXX_HAS_GTHREADS)
+	#include "external/mingw-std-threads/mingw.future.h"
+#else
+	#include <future>
+#endif
+
 namespace Common {
 
 /** Initialize the global threading system.
@@ -42,6 +52,27 @@ bool isMainThread();
 /** Throws an Exception if called from a non-main thread. */
 void enforceMainThread();
 
+/** Return the number of threads runParallel() spreads its work across. */
+size_t getParallelThreadCount();
+
+/** Call task(i) for every i in [0, count), spread across several threads.
+ *
+ *  The calls happen in no particular order, and runParallel() only
+ *  returns once all of them did. If any call threw an exception, the
+ *  exception of the call with the lowest i is rethrown afterwards.
+ *
+ *  The worker threads are kept around between calls, so this is cheap
+ *  enough to use for every frame.
+ */
+void runParallel(size_t count, const std::function<void(size_t)> &task);
+
+/** Call task() on one of the runParallel() worker threads, without waiting for it.
+ *
+ *  The returned future becomes ready once the task ran, and rethrows the
+ *  exception the task threw, if any.
+ */
+std::future<void> runInBackground(const std::function<void()> &task);
+
 } // End of namespace Common
 
 #endif // COMMON_THREADS_H
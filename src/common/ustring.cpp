@@ -34,7 +34,37 @@
 
 namespace Common {
 
-UString::UString() : _size(0) {
+/** Lowercase a byte of UTF-8 data. Only touches ASCII, never any part of a multi-byte sequence. */
+static inline byte lowerByte(byte c) {
+	return ((c >= 'A') && (c <= 'Z')) ? (c + ('a' - 'A')) : c;
+}
+
+/** Uppercase a byte of UTF-8 data. Only touches ASCII, never any part of a multi-byte sequence. */
+static inline byte upperByte(byte c) {
+	return ((c >= 'a') && (c <= 'z')) ? (c - ('a' - 'A')) : c;
+}
+
+/** Compare two byte ranges of UTF-8 data, lowercasing the ASCII characters in it. */
+static inline int compareLower(const std::string &str1, const std::string &str2) {
+	const byte *s1 = reinterpret_cast<const byte *>(str1.c_str());
+	const byte *s2 = reinterpret_cast<const byte *>(str2.c_str());
+
+	const size_t n = MIN(str1.size(), str2.size());
+	for (size_t i = 0; i < n; i++) {
+		const byte c1 = lowerByte(s1[i]);
+		const byte c2 = lowerByte(s2[i]);
+
+		if (c1 != c2)
+			return (c1 < c2) ? -1 : 1;
+	}
+
+	if (str1.size() == str2.size())
+		return 0;
+
+	return (str1.size() < str2.size()) ? -1 : 1;
+}
+
+UString::UString() : _size(0), _ascii(true) {
 }
 
 UString::UString(const UString &str) {
@@ -53,12 +83,12 @@ UString::UString(const char *str, size_t n) {
 	*this = std::string(str, n);
 }
 
-UString::UString(uint32 c, size_t n) : _size(0) {
+UString::UString(uint32 c, size_t n) : _size(0), _ascii(true) {
 	while (n-- > 0)
 		*this += c;
 }
 
-UString::UString(iterator sBegin, iterator sEnd) : _size(0) {
+UString::UString(iterator sBegin, iterator sEnd) : _size(0), _ascii(true) {
 	for (; (sBegin != sEnd) && *sBegin; ++sBegin)
 		*this += *sBegin;
 }
@@ -69,6 +99,7 @@ UString::~UString() {
 UString &UString::operator=(const UString &str) {
 	_string = str._string;
 	_size   = str._size;
+	_ascii  = str._ascii;
 
 	return *this;
 }
@@ -138,6 +169,7 @@ UString UString::operator+(uint32 c) const {
 UString &UString::operator+=(const UString &str) {
 	_string += str._string;
 	_size   += str._size;
+	_ascii   = _ascii && str._ascii;
 
 	return *this;
 }
@@ -163,60 +195,24 @@ UString &UString::operator+=(uint32 c) {
 	}
 
 	_size++;
+	_ascii = _ascii && isASCII(c);
 
 	return *this;
 }
 
-int UString::strcmp(const UString &str) const {
-	try {
-		UString::iterator it1 = begin();
-		UString::iterator it2 = str.begin();
-		for (; (it1 != end()) && (it2 != str.end()); ++it1, ++it2) {
-			const uint32 c1 = *it1;
-			const uint32 c2 = *it2;
-
-			if (c1 < c2)
-				return -1;
-			if (c1 > c2)
-				return  1;
-		}
-
-		if ((it1 == end()) && (it2 == str.end()))
-			return 0;
+/* Comparing UTF-8 data byte by byte orders it the same way as comparing
+ * the decoded codepoints, so neither compare needs to decode anything.
+ * And since lowercasing only ever changes ASCII characters, which never
+ * appear inside a multi-byte sequence, the same holds for stricmp(). */
 
-		if (it1 == end())
-			return -1;
-
-	} catch (...) {
-	}
+int UString::strcmp(const UString &str) const {
+	const int result = _string.compare(str._string);
 
-	return 1;
+	return (result < 0) ? -1 : ((result > 0) ? 1 : 0);
 }
 
 int UString::stricmp(const UString &str) const {
-	try {
-		UString::iterator it1 = begin();
-		UString::iterator it2 = str.begin();
-		for (; (it1 != end()) && (it2 != str.end()); ++it1, ++it2) {
-			const uint32 c1 = toLower(*it1);
-			const uint32 c2 = toLower(*it2);
-
-			if (c1 < c2)
-				return -1;
-			if (c1 > c2)
-				return  1;
-		}
-
-		if ((it1 == end()) && (it2 == str.end()))
-			return 0;
-
-		if (it1 == end())
-			return -1;
-
-	} catch (...) {
-	}
-
-	return 1;
+	return compareLower(_string, str._string);
 }
 
 bool UString::equals(const UString &str) const {
@@ -239,11 +235,13 @@ void UString::swap(UString &str) {
 	_string.swap(str._string);
 
 	SWAP(_size, str._size);
+	SWAP(_ascii, str._ascii);
 }
 
 void UString::clear() {
 	_string.clear();
-	_size = 0;
+	_size  = 0;
+	_ascii = true;
 }
 
 size_t UString::size() const {
@@ -254,6 +252,10 @@ bool UString::empty() const {
 	return _string.empty() || (_string[0] == '\0');
 }
 
+bool UString::isASCII() const {
+	return _ascii;
+}
+
 const char *UString::c_str() const {
 	return _string.c_str();
 }
@@ -361,6 +363,12 @@ void UString::truncate(size_t n) {
 	if (n >= _size)
 		return;
 
+	if (_ascii) {
+		_string.resize(n);
+		_size = n;
+		return;
+	}
+
 	UString temp;
 
 	for (iterator it = begin(); n > 0; ++it, n--)
@@ -467,6 +475,7 @@ void UString::replaceAll(uint32 what, uint32 with) {
 
 		// And set the new string's contents
 		_string.swap(newString);
+		recalculateSize();
 
 	} catch (const std::exception &se) {
 		Exception e(se);
@@ -476,6 +485,8 @@ void UString::replaceAll(uint32 what, uint32 with) {
 
 void UString::replaceAll(const UString &what, const UString &with) {
 	boost::replace_all(_string, what._string, with._string);
+
+	recalculateSize();
 }
 
 void UString::makeLower() {
@@ -487,32 +498,37 @@ void UString::makeUpper() {
 }
 
 UString UString::toLower() const {
-	UString str;
+	// Only ASCII characters change, so this can work on the bytes directly
+	UString str(*this);
 
-	str._string.reserve(_string.size());
-	for (iterator it = begin(); it != end(); ++it)
-		str += toLower(*it);
+	for (std::string::iterator c = str._string.begin(); c != str._string.end(); ++c)
+		*c = (char) lowerByte((byte) *c);
 
 	return str;
 }
 
 UString UString::toUpper() const {
-	UString str;
+	UString str(*this);
 
-	str._string.reserve(_string.size());
-	for (iterator it = begin(); it != end(); ++it)
-		str += toUpper(*it);
+	for (std::string::iterator c = str._string.begin(); c != str._string.end(); ++c)
+		*c = (char) upperByte((byte) *c);
 
 	return str;
 }
 
 UString::iterator UString::getPosition(size_t n) const {
+	if (_ascii)
+		return iterator(_string.begin() + MIN(n, _size), _string.begin(), _string.end());
+
 	iterator it = begin();
 	for (size_t i = 0; (i < n) && (it != end()); i++, ++it);
 	return it;
 }
 
 size_t UString::getPosition(iterator it) const {
+	if (_ascii)
+		return it.base() - _string.begin();
+
 	size_t n = 0;
 	for (iterator i = begin(); i != it; ++i, n++);
 	return n;
@@ -762,6 +778,19 @@ size_t UString::split(const UString &text, uint32 delim, std::vector<UString> &t
 }
 
 void UString::recalculateSize() {
+	_ascii = true;
+	for (std::string::const_iterator c = _string.begin(); c != _string.end(); ++c) {
+		if (((byte) *c) & 0x80) {
+			_ascii = false;
+			break;
+		}
+	}
+
+	if (_ascii) {
+		_size = _string.size();
+		return;
+	}
+
 	try {
 		// Calculate the "distance" in characters from the beginning and end
 		_size = utf8::distance(_string.begin(), _string.end());
@@ -779,7 +808,7 @@ uint32 UString::toLower(uint32 c) {
 		// We don't know how to lowercase that
 		return c;
 
-	return std::tolower(c);
+	return lowerByte(c);
 }
 
 uint32 UString::toUpper(uint32 c) {
@@ -787,7 +816,7 @@ uint32 UString::toUpper(uint32 c) {
 		// We don't know how to uppercase that
 		return c;
 
-	return std::toupper(c);
+	return upperByte(c);
 }
 
 bool UString::isASCII(uint32 c) {
@@ -827,4 +856,40 @@ uint32 UString::fromUTF16(uint16 c) {
 	return *iterator(utf8result.begin(), utf8result.begin(), utf8result.end());
 }
 
+
+size_t hashUStringCaseSensitive::operator()(const UString &str) const {
+	size_t seed = 0;
+
+	if (str.isASCII()) {
+		// Every byte is a whole character
+		const byte *s = reinterpret_cast<const byte *>(str.c_str());
+		for (size_t i = 0; i < str.size(); i++)
+			boost::hash_combine<uint32>(seed, s[i]);
+
+		return seed;
+	}
+
+	for (UString::iterator it = str.begin(); it != str.end(); ++it)
+		boost::hash_combine<uint32>(seed, *it);
+
+	return seed;
+}
+
+size_t hashUStringCaseInsensitive::operator()(const UString &str) const {
+	size_t seed = 0;
+
+	if (str.isASCII()) {
+		const byte *s = reinterpret_cast<const byte *>(str.c_str());
+		for (size_t i = 0; i < str.size(); i++)
+			boost::hash_combine<uint32>(seed, lowerByte(s[i]));
+
+		return seed;
+	}
+
+	for (UString::iterator it = str.begin(); it != str.end(); ++it)
+		boost::hash_combine<uint32>(seed, UString::toLower(*it));
+
+	return seed;
+}
+
 } // End of namespace Common
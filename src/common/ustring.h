@@ -39,6 +39,11 @@
 namespace Common {
 
 /** A class holding an UTF-8 string.
+ *
+ *  The string keeps track of whether it only contains ASCII characters.
+ *  Since nearly all of the game data is pure ASCII, operations that would
+ *  otherwise need to decode the UTF-8 data character by character (like
+ *  finding a position or hashing) can then work on the bytes directly.
  *
  *  WARNING:
  *  Copy constructors and assignment operators copying from std::string and
@@ -119,6 +124,9 @@ public:
 	/** Is the string empty? */
 	bool empty() const;
 
+	/** Does the string only contain ASCII characters? */
+	bool isASCII() const;
+
 	/** Return the (utf8 encoded) string data. */
 	const char *c_str() const;
 
@@ -202,7 +210,8 @@ public:
 private:
 	std::string _string; ///< Internal string holding the actual data.
 
-	size_t _size;
+	size_t _size;  ///< The size of the string, in characters.
+	bool   _ascii; ///< Does the string only contain ASCII characters?
 
 	void recalculateSize();
 };
@@ -221,25 +230,11 @@ static inline UString operator+(const char *left, const UString &right) {
 // Hash functions
 
 struct hashUStringCaseSensitive {
-	size_t operator()(const UString &str) const {
-		size_t seed = 0;
-
-		for (UString::iterator it = str.begin(); it != str.end(); ++it)
-			boost::hash_combine<uint32>(seed, *it);
-
-		return seed;
-	}
+	size_t operator()(const UString &str) const;
 };
 
 struct hashUStringCaseInsensitive {
-	size_t operator()(const UString &str) const {
-		size_t seed = 0;
-
-		for (UString::iterator it = str.begin(); it != str.end(); ++it)
-			boost::hash_combine<uint32>(seed, UString::toLower(*it));
-
-		return seed;
-	}
+	size_t operator()(const UString &str) const;
 };
 
 } // End of namespace Common
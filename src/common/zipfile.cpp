@@ -170,6 +170,17 @@ SeekableReadStream *ZipFile::getFile(uint32 index, bool tryNoCopy) const {
 	if (tryNoCopy && (compMethod == 0))
 		return new SeekableSubReadStream(_zip.get(), _zip->pos(), _zip->pos() + compSize);
 
+	// Inflate large files piece by piece while they're being read, instead of all at once
+	if ((compMethod == 8) && (realSize >= kInflateStreamThreshold)) {
+		SeekableReadStream *compressed = 0;
+		if (tryNoCopy)
+			compressed = new SeekableSubReadStream(_zip.get(), _zip->pos(), _zip->pos() + compSize);
+		else
+			compressed = _zip->readStream(compSize);
+
+		return new InflateReadStream(compressed, realSize, kWindowBitsMaxRaw);
+	}
+
 	return decompressFile(*_zip, compMethod, compSize, realSize);
 }
 
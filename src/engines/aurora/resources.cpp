@@ -109,6 +109,35 @@ bool indexOptionalArchive(const Common::UString &file, uint32 priority, ChangeLi
 	return indexOptionalArchive(file, priority, password, changes);
 }
 
+void ArchiveBatch::addMandatory(const Common::UString &file, uint32 priority, Common::ChangeID *changeID) {
+	_archives.push_back(Aurora::ResourceManager::BatchArchive(file, priority, false, changeID));
+}
+
+void ArchiveBatch::addMandatory(const Common::UString &file, uint32 priority, ChangeList &changes) {
+	changes.push_back(Common::ChangeID());
+	addMandatory(file, priority, &changes.back());
+}
+
+void ArchiveBatch::addOptional(const Common::UString &file, uint32 priority, Common::ChangeID *changeID) {
+	_archives.push_back(Aurora::ResourceManager::BatchArchive(file, priority, true, changeID));
+}
+
+void ArchiveBatch::index() {
+	if (EventMan.quitRequested())
+		return;
+
+	try {
+		ResMan.indexArchives(_archives);
+	} catch (Common::Exception &e) {
+		_archives.clear();
+
+		e.add("Failed to index archives");
+		throw;
+	}
+
+	_archives.clear();
+}
+
 void indexMandatoryDirectory(const Common::UString &dir, const char *glob, int depth,
                              uint32 priority, Common::ChangeID *changeID) {
 
@@ -31,6 +31,7 @@
 #include "src/common/changeid.h"
 
 #include "src/aurora/types.h"
+#include "src/aurora/resman.h"
 
 namespace Common {
 	class UString;
@@ -56,6 +57,28 @@ bool indexOptionalArchive(const Common::UString &file, uint32 priority, const st
 bool indexOptionalArchive(const Common::UString &file, uint32 priority, const std::vector<byte> &password,
                           ChangeList &changes);
 
+/** A collection of archive files to add to the resource manager in one go.
+ *
+ *  The archives are parsed in parallel, but their resources are added in
+ *  the order the archives were added here. The result is the same as
+ *  calling indexMandatoryArchive() and indexOptionalArchive() in turn.
+ */
+class ArchiveBatch {
+public:
+	/** Add an archive file, erroring out in index() if it does not exist. */
+	void addMandatory(const Common::UString &file, uint32 priority, Common::ChangeID *changeID = 0);
+	void addMandatory(const Common::UString &file, uint32 priority, ChangeList &changes);
+
+	/** Add an archive file, to be indexed only if it exists. */
+	void addOptional(const Common::UString &file, uint32 priority, Common::ChangeID *changeID = 0);
+
+	/** Add all collected archive files to the resource manager, and clear the batch. */
+	void index();
+
+private:
+	Aurora::ResourceManager::BatchArchives _archives;
+};
+
 /** Add a directory to the resource manager, erroring out if it does not exist. */
 void indexMandatoryDirectory(const Common::UString &dir, const char *glob, int depth,
                              uint32 priority, Common::ChangeID *changeID = 0);
@@ -50,6 +50,8 @@
 #include "src/graphics/shader/materialman.h"
 #include "src/graphics/shader/surfaceman.h"
 
+#include "src/sound/soundbankman.h"
+
 #include "src/events/events.h"
 #include "src/events/requests.h"
 
@@ -249,6 +251,10 @@ void EngineManager::run(GameInstance &game) const {
 	GameInstanceEngine *gameEngine = dynamic_cast<GameInstanceEngine *>(&game);
 	assert(gameEngine);
 
+	// Remember the indices of unchanged archives between runs
+	if (ConfigMan.getBool("indexcache", true))
+		ResMan.setIndexCache(Common::FilePath::getConfigDirectory() + "/resourceindex.cache");
+
 	gameEngine->run();
 
 	GfxMan.lockFrame();
@@ -277,6 +283,9 @@ void EngineManager::cleanup() const {
 		LangMan.clear();
 		TalkMan.clear();
 		TwoDAReg.clear();
+		SoundBankMan.clear();
+
+		ResMan.saveIndexCache();
 		ResMan.clear();
 
 		ConfigMan.setGame();
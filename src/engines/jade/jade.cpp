@@ -267,15 +267,18 @@ void JadeEngine::initResources(LoadProgress &progress) {
 	progress.step("Loading main KEY");
 	indexMandatoryArchive("chitin.key", 10);
 
+	ArchiveBatch archives;
+
 	progress.step("Loading global auxiliary resources");
-	indexMandatoryArchive("loadscreens.mod"   , 50);
-	indexMandatoryArchive("players.mod"       , 51);
-	indexMandatoryArchive("global-a.rim"      , 52);
-	indexMandatoryArchive("ingamemenu-a.rim"  , 53);
-	indexMandatoryArchive("globalunload-a.rim", 54);
-	indexMandatoryArchive("minigame-a.rim"    , 55);
-	indexMandatoryArchive("miniglobal-a.rim"  , 56);
-	indexMandatoryArchive("mmenu-a.rim"       , 57);
+	archives.addMandatory("loadscreens.mod"   , 50);
+	archives.addMandatory("players.mod"       , 51);
+	archives.addMandatory("global-a.rim"      , 52);
+	archives.addMandatory("ingamemenu-a.rim"  , 53);
+	archives.addMandatory("globalunload-a.rim", 54);
+	archives.addMandatory("minigame-a.rim"    , 55);
+	archives.addMandatory("miniglobal-a.rim"  , 56);
+	archives.addMandatory("mmenu-a.rim"       , 57);
+	archives.index();
 
 	progress.step("Indexing extra font resources");
 	indexMandatoryDirectory("fonts"   , 0, -1, 100);
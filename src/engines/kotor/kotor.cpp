@@ -227,17 +227,20 @@ void KotOREngine::initResources(LoadProgress &progress) {
 	if (indexOptionalArchive("live1.key", 11))
 		_hasLiveKey = true;
 
+	ArchiveBatch archives;
+
 	progress.step("Loading global auxiliary resources");
-	indexMandatoryArchive("mainmenu.rim"    , 50);
-	indexMandatoryArchive("mainmenudx.rim"  , 51);
-	indexMandatoryArchive("legal.rim"       , 52);
-	indexMandatoryArchive("legaldx.rim"     , 53);
-	indexMandatoryArchive("global.rim"      , 54);
-	indexMandatoryArchive("subglobaldx.rim" , 55);
-	indexMandatoryArchive("miniglobaldx.rim", 56);
-	indexMandatoryArchive("globaldx.rim"    , 57);
-	indexMandatoryArchive("chargen.rim"     , 58);
-	indexMandatoryArchive("chargendx.rim"   , 59);
+	archives.addMandatory("mainmenu.rim"    , 50);
+	archives.addMandatory("mainmenudx.rim"  , 51);
+	archives.addMandatory("legal.rim"       , 52);
+	archives.addMandatory("legaldx.rim"     , 53);
+	archives.addMandatory("global.rim"      , 54);
+	archives.addMandatory("subglobaldx.rim" , 55);
+	archives.addMandatory("miniglobaldx.rim", 56);
+	archives.addMandatory("globaldx.rim"    , 57);
+	archives.addMandatory("chargen.rim"     , 58);
+	archives.addMandatory("chargendx.rim"   , 59);
+	archives.index();
 
 	if (_platform == Aurora::kPlatformXbox) {
 		// The Xbox version has most of its textures in "textures.bif"
@@ -219,105 +219,111 @@ void NWN2Engine::initResources(LoadProgress &progress) {
 	indexMandatoryDirectory("modules", 0, 0, 3);
 	indexMandatoryDirectory("hak"    , 0, 0, 4);
 
+	ArchiveBatch archives;
+
 	progress.step("Loading main resource files");
 
-	indexMandatoryArchive("2da.zip"           , 10);
-	indexMandatoryArchive("actors.zip"        , 11);
-	indexMandatoryArchive("animtags.zip"      , 12);
-	indexMandatoryArchive("convo.zip"         , 13);
-	indexMandatoryArchive("ini.zip"           , 14);
-	indexMandatoryArchive("lod-merged.zip"    , 15);
-	indexMandatoryArchive("music.zip"         , 16);
-	indexMandatoryArchive("nwn2_materials.zip", 17);
-	indexMandatoryArchive("nwn2_models.zip"   , 18);
-	indexMandatoryArchive("nwn2_vfx.zip"      , 19);
-	indexMandatoryArchive("prefabs.zip"       , 20);
-	indexMandatoryArchive("scripts.zip"       , 21);
-	indexMandatoryArchive("sounds.zip"        , 22);
-	indexMandatoryArchive("soundsets.zip"     , 23);
-	indexMandatoryArchive("speedtree.zip"     , 24);
-	indexMandatoryArchive("templates.zip"     , 25);
-	indexMandatoryArchive("vo.zip"            , 26);
-	indexMandatoryArchive("walkmesh.zip"      , 27);
+	archives.addMandatory("2da.zip"           , 10);
+	archives.addMandatory("actors.zip"        , 11);
+	archives.addMandatory("animtags.zip"      , 12);
+	archives.addMandatory("convo.zip"         , 13);
+	archives.addMandatory("ini.zip"           , 14);
+	archives.addMandatory("lod-merged.zip"    , 15);
+	archives.addMandatory("music.zip"         , 16);
+	archives.addMandatory("nwn2_materials.zip", 17);
+	archives.addMandatory("nwn2_models.zip"   , 18);
+	archives.addMandatory("nwn2_vfx.zip"      , 19);
+	archives.addMandatory("prefabs.zip"       , 20);
+	archives.addMandatory("scripts.zip"       , 21);
+	archives.addMandatory("sounds.zip"        , 22);
+	archives.addMandatory("soundsets.zip"     , 23);
+	archives.addMandatory("speedtree.zip"     , 24);
+	archives.addMandatory("templates.zip"     , 25);
+	archives.addMandatory("vo.zip"            , 26);
+	archives.addMandatory("walkmesh.zip"      , 27);
+	archives.index();
 
 	progress.step("Loading expansion 1 resource files");
 
 	// Expansion 1: Mask of the Betrayer (MotB)
 	_hasXP1 = ResMan.hasArchive("2da_x1.zip");
-	indexOptionalArchive("2da_x1.zip"           , 50);
-	indexOptionalArchive("actors_x1.zip"        , 51);
-	indexOptionalArchive("animtags_x1.zip"      , 52);
-	indexOptionalArchive("convo_x1.zip"         , 53);
-	indexOptionalArchive("ini_x1.zip"           , 54);
-	indexOptionalArchive("lod-merged_x1.zip"    , 55);
-	indexOptionalArchive("music_x1.zip"         , 56);
-	indexOptionalArchive("nwn2_materials_x1.zip", 57);
-	indexOptionalArchive("nwn2_models_x1.zip"   , 58);
-	indexOptionalArchive("nwn2_vfx_x1.zip"      , 59);
-	indexOptionalArchive("prefabs_x1.zip"       , 60);
-	indexOptionalArchive("scripts_x1.zip"       , 61);
-	indexOptionalArchive("soundsets_x1.zip"     , 62);
-	indexOptionalArchive("sounds_x1.zip"        , 63);
-	indexOptionalArchive("speedtree_x1.zip"     , 64);
-	indexOptionalArchive("templates_x1.zip"     , 65);
-	indexOptionalArchive("vo_x1.zip"            , 66);
-	indexOptionalArchive("walkmesh_x1.zip"      , 67);
+	archives.addOptional("2da_x1.zip"           , 50);
+	archives.addOptional("actors_x1.zip"        , 51);
+	archives.addOptional("animtags_x1.zip"      , 52);
+	archives.addOptional("convo_x1.zip"         , 53);
+	archives.addOptional("ini_x1.zip"           , 54);
+	archives.addOptional("lod-merged_x1.zip"    , 55);
+	archives.addOptional("music_x1.zip"         , 56);
+	archives.addOptional("nwn2_materials_x1.zip", 57);
+	archives.addOptional("nwn2_models_x1.zip"   , 58);
+	archives.addOptional("nwn2_vfx_x1.zip"      , 59);
+	archives.addOptional("prefabs_x1.zip"       , 60);
+	archives.addOptional("scripts_x1.zip"       , 61);
+	archives.addOptional("soundsets_x1.zip"     , 62);
+	archives.addOptional("sounds_x1.zip"        , 63);
+	archives.addOptional("speedtree_x1.zip"     , 64);
+	archives.addOptional("templates_x1.zip"     , 65);
+	archives.addOptional("vo_x1.zip"            , 66);
+	archives.addOptional("walkmesh_x1.zip"      , 67);
+	archives.index();
 
 	progress.step("Loading expansion 2 resource files");
 
 	// Expansion 2: Storm of Zehir (SoZ)
 	_hasXP2 = ResMan.hasArchive("2da_x2.zip");
-	indexOptionalArchive("2da_x2.zip"           , 100);
-	indexOptionalArchive("actors_x2.zip"        , 101);
-	indexOptionalArchive("animtags_x2.zip"      , 102);
-	indexOptionalArchive("lod-merged_x2.zip"    , 103);
-	indexOptionalArchive("music_x2.zip"         , 104);
-	indexOptionalArchive("nwn2_materials_x2.zip", 105);
-	indexOptionalArchive("nwn2_models_x2.zip"   , 106);
-	indexOptionalArchive("nwn2_vfx_x2.zip"      , 107);
-	indexOptionalArchive("prefabs_x2.zip"       , 108);
-	indexOptionalArchive("scripts_x2.zip"       , 109);
-	indexOptionalArchive("soundsets_x2.zip"     , 110);
-	indexOptionalArchive("sounds_x2.zip"        , 111);
-	indexOptionalArchive("speedtree_x2.zip"     , 112);
-	indexOptionalArchive("templates_x2.zip"     , 113);
-	indexOptionalArchive("vo_x2.zip"            , 114);
+	archives.addOptional("2da_x2.zip"           , 100);
+	archives.addOptional("actors_x2.zip"        , 101);
+	archives.addOptional("animtags_x2.zip"      , 102);
+	archives.addOptional("lod-merged_x2.zip"    , 103);
+	archives.addOptional("music_x2.zip"         , 104);
+	archives.addOptional("nwn2_materials_x2.zip", 105);
+	archives.addOptional("nwn2_models_x2.zip"   , 106);
+	archives.addOptional("nwn2_vfx_x2.zip"      , 107);
+	archives.addOptional("prefabs_x2.zip"       , 108);
+	archives.addOptional("scripts_x2.zip"       , 109);
+	archives.addOptional("soundsets_x2.zip"     , 110);
+	archives.addOptional("sounds_x2.zip"        , 111);
+	archives.addOptional("speedtree_x2.zip"     , 112);
+	archives.addOptional("templates_x2.zip"     , 113);
+	archives.addOptional("vo_x2.zip"            , 114);
+	archives.index();
 
 	// Expansion 3: Mysteries of Westgate
 	_hasXP3 = ResMan.hasArchive("westgate.hak");
 
 	progress.step("Loading patch resource files");
 
-	indexOptionalArchive("actors_v103x1.zip"         , 150);
-	indexOptionalArchive("actors_v106.zip"           , 151);
-	indexOptionalArchive("lod-merged_v101.zip"       , 152);
-	indexOptionalArchive("lod-merged_v107.zip"       , 153);
-	indexOptionalArchive("lod-merged_v121.zip"       , 154);
-	indexOptionalArchive("lod-merged_x1_v121.zip"    , 155);
-	indexOptionalArchive("lod-merged_x2_v121.zip"    , 156);
-	indexOptionalArchive("nwn2_materials_v103x1.zip" , 157);
-	indexOptionalArchive("nwn2_materials_v104.zip"   , 158);
-	indexOptionalArchive("nwn2_materials_v106.zip"   , 159);
-	indexOptionalArchive("nwn2_materials_v107.zip"   , 160);
-	indexOptionalArchive("nwn2_materials_v110.zip"   , 161);
-	indexOptionalArchive("nwn2_materials_v112.zip"   , 162);
-	indexOptionalArchive("nwn2_materials_v121.zip"   , 163);
-	indexOptionalArchive("nwn2_materials_x1_v113.zip", 164);
-	indexOptionalArchive("nwn2_materials_x1_v121.zip", 165);
-	indexOptionalArchive("nwn2_models_v103x1.zip"    , 166);
-	indexOptionalArchive("nwn2_models_v104.zip"      , 167);
-	indexOptionalArchive("nwn2_models_v105.zip"      , 168);
-	indexOptionalArchive("nwn2_models_v106.zip"      , 169);
-	indexOptionalArchive("nwn2_models_v107.zip"      , 160);
-	indexOptionalArchive("nwn2_models_v112.zip"      , 171);
-	indexOptionalArchive("nwn2_models_v121.zip"      , 172);
-	indexOptionalArchive("nwn2_models_x1_v121.zip"   , 173);
-	indexOptionalArchive("nwn2_models_x2_v121.zip"   , 174);
-	indexOptionalArchive("templates_v112.zip"        , 175);
-	indexOptionalArchive("templates_v122.zip"        , 176);
-	indexOptionalArchive("templates_x1_v122.zip"     , 177);
-	indexOptionalArchive("vo_103x1.zip"              , 178);
-	indexOptionalArchive("vo_106.zip"                , 179);
+	archives.addOptional("actors_v103x1.zip"         , 150);
+	archives.addOptional("actors_v106.zip"           , 151);
+	archives.addOptional("lod-merged_v101.zip"       , 152);
+	archives.addOptional("lod-merged_v107.zip"       , 153);
+	archives.addOptional("lod-merged_v121.zip"       , 154);
+	archives.addOptional("lod-merged_x1_v121.zip"    , 155);
+	archives.addOptional("lod-merged_x2_v121.zip"    , 156);
+	archives.addOptional("nwn2_materials_v103x1.zip" , 157);
+	archives.addOptional("nwn2_materials_v104.zip"   , 158);
+	archives.addOptional("nwn2_materials_v106.zip"   , 159);
+	archives.addOptional("nwn2_materials_v107.zip"   , 160);
+	archives.addOptional("nwn2_materials_v110.zip"   , 161);
+	archives.addOptional("nwn2_materials_v112.zip"   , 162);
+	archives.addOptional("nwn2_materials_v121.zip"   , 163);
+	archives.addOptional("nwn2_materials_x1_v113.zip", 164);
+	archives.addOptional("nwn2_materials_x1_v121.zip", 165);
+	archives.addOptional("nwn2_models_v103x1.zip"    , 166);
+	archives.addOptional("nwn2_models_v104.zip"      , 167);
+	archives.addOptional("nwn2_models_v105.zip"      , 168);
+	archives.addOptional("nwn2_models_v106.zip"      , 169);
+	archives.addOptional("nwn2_models_v107.zip"      , 160);
+	archives.addOptional("nwn2_models_v112.zip"      , 171);
+	archives.addOptional("nwn2_models_v121.zip"      , 172);
+	archives.addOptional("nwn2_models_x1_v121.zip"   , 173);
+	archives.addOptional("nwn2_models_x2_v121.zip"   , 174);
+	archives.addOptional("templates_v112.zip"        , 175);
+	archives.addOptional("templates_v122.zip"        , 176);
+	archives.addOptional("templates_x1_v122.zip"     , 177);
+	archives.addOptional("vo_103x1.zip"              , 178);
+	archives.addOptional("vo_106.zip"                , 179);
+	archives.index();
 
 	progress.step("Indexing extra sound resources");
 	indexMandatoryDirectory("ambient"   , 0,  0, 200);
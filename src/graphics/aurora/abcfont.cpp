@@ -85,6 +85,25 @@ void ABCFont::draw(uint32 c) const {
 	glTranslatef(cC.width + cC.spaceR, 0.0f, 0.0f);
 }
 
+bool ABCFont::getCharQuad(uint32 c, CharQuad &quad) const {
+	const Char &cC = findChar(c);
+
+	quad.page = 0;
+
+	for (int i = 0; i < 4; i++) {
+		quad.tX[i] = cC.tX[i];
+		quad.tY[i] = cC.tY[i];
+		quad.vX[i] = cC.vX[i] + cC.spaceL;
+		quad.vY[i] = cC.vY[i];
+	}
+
+	return true;
+}
+
+void ABCFont::bindPage(size_t UNUSED(page)) const {
+	TextureMan.set(_texture);
+}
+
 void ABCFont::renderBind(const glm::mat4 &transform) const {
 	glUseProgram(_renderable->getProgram()->glid);
 	_material->bindProgram(_renderable->getProgram(), 1.0f);
@@ -118,6 +137,12 @@ void ABCFont::render(uint32 c, float &x, float &y, float *rgba) const {
 	x += cC.width + cC.spaceR;
 }
 
+void ABCFont::renderQuads(size_t UNUSED(page), const float *pos, const float *uv, const float *rgba,
+                          size_t count) const {
+
+	_mesh->render(pos, uv, rgba, count);
+}
+
 void ABCFont::renderUnbind() const {
 	_mesh->renderUnbind();
 
@@ -57,6 +57,9 @@ public:
 
 	void draw(uint32 c) const;
 
+	bool getCharQuad(uint32 c, CharQuad &quad) const;
+	void bindPage(size_t page) const;
+
 	/**
 	 * @brief Bind the font for rendering. Must be performed before render is called.
 	 * @param transform  Base modelview transform. Under most circumstances this is expected to be the identity matrix.
@@ -66,6 +69,7 @@ public:
 	virtual void render(uint32 c, float &x, float &y, float *rgba) const;
 	virtual void renderUnbind() const;
 
+	virtual void renderQuads(size_t page, const float *pos, const float *uv, const float *rgba, size_t count) const;
 private:
 	/** A font character. */
 	struct Char {
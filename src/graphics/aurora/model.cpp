@@ -159,6 +159,15 @@ bool Model::isIn(float x1, float y1, float z1, float x2, float y2, float z2) con
 	return _absoluteBoundBox.isIn(x1, y1, z1, x2, y2, z2);
 }
 
+bool Model::getWorldBound(glm::vec3 &min, glm::vec3 &max) const {
+	if (_absoluteBoundBox.empty())
+		return false;
+
+	_absoluteBoundBox.getMin(min.x, min.y, min.z);
+	_absoluteBoundBox.getMax(max.x, max.y, max.z);
+	return true;
+}
+
 float Model::getWidth() const {
 	return _boundBox.getWidth() * _scale[0];
 }
@@ -894,6 +903,8 @@ void Model::createBound() {
 	_absoluteBoundBox = _boundBox;
 	_absoluteBoundBox.transform(_absolutePosition);
 	_absoluteBoundBox.absolutize();
+
+	updateBound();
 }
 
 void Model::readValue(Common::SeekableReadStream &stream, uint32 &value) {
@@ -516,6 +516,7 @@ void ModelNode_DragonAge::load(Model_DragonAge::ParserContext &ctx, const GFF4St
 		meshName += _name;
 
 		_mesh->data->rawMesh->setName(meshName);
+		_mesh->data->rawMesh->optimize();
 		_mesh->data->rawMesh->init();
 		if (MeshMan.getMesh(meshName)) {
 			warning("Warning: probable mesh duplication of: %s", meshName.c_str());
@@ -369,6 +369,7 @@ void ModelNode_Jade::load(Model_Jade::ParserContext &ctx) {
 		return;
 	}
 
+	_mesh->data->rawMesh->optimize();
 	_mesh->data->rawMesh->init();
 	if (MeshMan.getMesh(meshName)) {
 		warning("Warning: probable mesh duplication of: %s", meshName.c_str());
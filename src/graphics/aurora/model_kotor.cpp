@@ -589,6 +589,8 @@ void ModelNode_KotOR::load(Model_KotOR::ParserContext &ctx) {
 					_mesh->data->rawMesh = checkMesh;
 				} else {
 					_mesh->data->rawMesh->setName(meshName);
+					if (!_mesh->skin)
+						_mesh->data->rawMesh->optimize();
 					_mesh->data->rawMesh->init();
 					MeshMan.addMesh(_mesh->data->rawMesh);
 				}
@@ -608,6 +610,8 @@ void ModelNode_KotOR::load(Model_KotOR::ParserContext &ctx) {
 			 */
 			meshName += "#" + Common::generateIDRandomString();
 			_mesh->data->rawMesh->setName(meshName);
+			if (!_mesh->skin)
+				_mesh->data->rawMesh->optimize();
 			_mesh->data->rawMesh->init();
 
 			MeshMan.addMesh(_mesh->data->rawMesh);
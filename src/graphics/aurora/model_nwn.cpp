@@ -961,6 +961,7 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 		_mesh->data->rawMesh = checkMesh;
 	} else {
 		_mesh->data->rawMesh->setName(meshName);
+		_mesh->data->rawMesh->optimize();
 		_mesh->data->rawMesh->init();
 		MeshMan.addMesh(_mesh->data->rawMesh);
 	}
@@ -1212,6 +1213,8 @@ void ModelNode_NWN_ASCII::load(Model_NWN::ParserContext &ctx,
 	}
 
 	_mesh->data->rawMesh->setName(meshName);
+	if (!_mesh->dangly)
+		_mesh->data->rawMesh->optimize();
 	_mesh->data->rawMesh->init();
 	if (MeshMan.getMesh(meshName)) {
 		warning("Warning: probable mesh duplication of: %s", meshName.c_str());
@@ -319,6 +319,7 @@ bool ModelNode_NWN2::loadRigid(Model_NWN2::ParserContext &ctx) {
 		_mesh->data->rawMesh = checkMesh;
 	} else {
 		_mesh->data->rawMesh->setName(meshName);
+		_mesh->data->rawMesh->optimize();
 		_mesh->data->rawMesh->init();
 		MeshMan.addMesh(_mesh->data->rawMesh);
 	}
@@ -449,6 +450,7 @@ bool ModelNode_NWN2::loadSkin(Model_NWN2::ParserContext &ctx) {
 		_mesh->data->rawMesh = checkMesh;
 	} else {
 		_mesh->data->rawMesh->setName(meshName);
+		_mesh->data->rawMesh->optimize();
 		_mesh->data->rawMesh->init();
 		MeshMan.addMesh(_mesh->data->rawMesh);
 	}
@@ -333,6 +333,7 @@ void ModelNode_Witcher::load(Model_Witcher::ParserContext &ctx) {
 				_mesh->data->rawMesh = checkMesh;
 			} else {
 				_mesh->data->rawMesh->setName(meshName);
+				_mesh->data->rawMesh->optimize();
 				_mesh->data->rawMesh->init();
 				MeshMan.addMesh(_mesh->data->rawMesh);
 			}
@@ -819,6 +820,7 @@ void ModelNode_Witcher::readTexturePaint(Model_Witcher::ParserContext &ctx) {
 		ctx.mdb->skip(68); // Unknown
 	}
 
+	_mesh->data->rawMesh->optimize();
 	_mesh->data->rawMesh->init();
 
 	createBound();
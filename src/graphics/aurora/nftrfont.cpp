@@ -407,6 +407,25 @@ void NFTRFont::draw(uint32 c) const {
 	glTranslatef(cC->second.width, 0.0f, 0.0f);
 }
 
+bool NFTRFont::getCharQuad(uint32 c, CharQuad &quad) const {
+	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
+	if (cC == _chars.end())
+		return false;
+
+	quad.page = 0;
+
+	std::memcpy(quad.tX, cC->second.tX, sizeof(quad.tX));
+	std::memcpy(quad.tY, cC->second.tY, sizeof(quad.tY));
+	std::memcpy(quad.vX, cC->second.vX, sizeof(quad.vX));
+	std::memcpy(quad.vY, cC->second.vY, sizeof(quad.vY));
+
+	return true;
+}
+
+void NFTRFont::bindPage(size_t UNUSED(page)) const {
+	TextureMan.set(_texture);
+}
+
 void NFTRFont::drawGlyphs(const std::vector<Glyph> &glyphs) {
 	if (glyphs.empty())
 		return;
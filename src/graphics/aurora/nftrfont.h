@@ -53,6 +53,9 @@ public:
 
 	void draw(uint32 c) const;
 
+	bool getCharQuad(uint32 c, CharQuad &quad) const;
+	void bindPage(size_t page) const;
+
 private:
 	struct Header {
 		uint8 width;
@@ -24,6 +24,7 @@ src_graphics_libgraphics_la_SOURCES += \
     src/graphics/aurora/texture.h \
     src/graphics/aurora/texturehandle.h \
     src/graphics/aurora/textureman.h \
+    src/graphics/aurora/textureresidency.h \
     src/graphics/aurora/pltfile.h \
     src/graphics/aurora/cursor.h \
     src/graphics/aurora/cursorman.h \
@@ -67,6 +68,7 @@ src_graphics_libgraphics_la_SOURCES += \
     src/graphics/aurora/texture.cpp \
     src/graphics/aurora/texturehandle.cpp \
     src/graphics/aurora/textureman.cpp \
+    src/graphics/aurora/textureresidency.cpp \
     src/graphics/aurora/pltfile.cpp \
     src/graphics/aurora/cursor.cpp \
     src/graphics/aurora/cursorman.cpp \
@@ -22,9 +22,14 @@
  *  A text object.
  */
 
+#include "external/glm/gtc/matrix_transform.hpp"
+
+#include "src/common/util.h"
+
 #include "src/events/requests.h"
 
 #include "src/graphics/font.h"
+#include "src/graphics/vertexbuffer.h"
 
 #include "src/graphics/aurora/fontman.h"
 #include "src/graphics/aurora/text.h"
@@ -39,6 +44,8 @@ Text::Text(const FontHandle &font, const Common::UString &str,
 	_r(r), _g(g), _b(b), _a(a), _font(font), _x(0.0f), _y(0.0f), _halign(halign),_valign(valign),
 	_disableColorTokens(false) {
 
+	_layout.setDefaultColor(_r, _g, _b, _a);
+
 	set(str);
 
 	_distance = -FLT_MAX;
@@ -53,6 +60,8 @@ Text::Text(const FontHandle &font, float w, float h, const Common::UString &str,
 	_width = roundf(w);
 	_height = roundf(h);
 
+	_layout.setDefaultColor(_r, _g, _b, _a);
+
 	setText(str);
 
 	_distance = -FLT_MAX;
@@ -67,6 +76,8 @@ Text::Text(Graphics::GUIElement::GUIElementType type, const FontHandle &font, fl
 	_width = roundf(w);
 	_height = roundf(h);
 
+	_layout.setDefaultColor(_r, _g, _b, _a);
+
 	setText(str);
 
 	_distance = -FLT_MAX;
@@ -97,6 +108,8 @@ void Text::set(const Common::UString &str, float maxWidth, float maxHeight) {
 	_height = font.getHeight(_str, maxWidth, maxHeight);
 	_width  = font.getWidth (_str, maxWidth);
 
+	updateLayout();
+
 	unlockFrameIfVisible();
 }
 
@@ -112,7 +125,9 @@ void Text::setText(const Common::UString &str) {
 
 	font.buildChars(str);
 
-	_lineCount = font.getLineCount(_str, _width, _height);
+	updateLayout();
+
+	_lineCount = _layout.getLineCount();
 
 	unlockFrameIfVisible();
 }
@@ -132,6 +147,8 @@ void Text::setColor(float r, float g, float b, float a) {
 	_b = b;
 	_a = a;
 
+	_layout.setDefaultColor(_r, _g, _b, _a);
+
 	unlockFrameIfVisible();
 }
 
@@ -144,7 +161,13 @@ float Text::getHorizontalAlign() const {
 }
 
 void Text::setHorizontalAlign(float halign) {
+	lockFrameIfVisible();
+
 	_halign = halign;
+
+	updateLayout();
+
+	unlockFrameIfVisible();
 }
 
 float Text::getVerticalAlign() const {
@@ -152,7 +175,13 @@ float Text::getVerticalAlign() const {
 }
 
 void Text::setVerticalAlign(float valign) {
+	lockFrameIfVisible();
+
 	_valign = valign;
+
+	updateLayout();
+
+	unlockFrameIfVisible();
 }
 
 const Common::UString &Text::get() const {
@@ -187,7 +216,9 @@ void Text::setSize(float width, float height) {
 	_width = roundf(width);
 	_height = roundf(height);
 
-	_lineCount = _font.getFont().getLineCount(_str, _width, _height);
+	updateLayout();
+
+	_lineCount = _layout.getLineCount();
 
 	unlockFrameIfVisible();
 }
@@ -221,39 +252,30 @@ void Text::render(RenderPass pass) {
 		return;
 
 	Font &font = _font.getFont();
-	float lineHeight = font.getHeight() + font.getLineSpacing();
 
 	glTranslatef(roundf(_x), roundf(_y), 0.0f);
 
-	glColor4f(_r, _g, _b, _a);
-
-	std::vector<Common::UString> lines;
-	font.split(_str, lines, _width, _height, false);
-
-	float blockSize = lines.size() * lineHeight;
-
-	// Move position to the top
-	glTranslatef(0.0f, roundf(((_height - blockSize) * _valign) + blockSize - lineHeight), 0.0f);
-
-	size_t position = 0;
-
-	ColorPositions::const_iterator color = _colors.begin();
+	// Draw all characters on a page in one go
+	for (size_t i = 0; i < _layout.getPageCount(); i++) {
+		const TextLayout::Page &page = _layout.getPage(i);
+		if (page.getQuadCount() == 0)
+			continue;
 
-	// Draw lines
-	for (std::vector<Common::UString>::iterator l = lines.begin(); l != lines.end(); ++l) {
-		// Save the current position
-		glPushMatrix();
+		font.bindPage(i);
 
-		drawLine(*l, color, position);
+		const VertexAttrib attribs[3] = {
+			VertexAttrib(VPOSITION, 3, GL_FLOAT, 0, &page.vertices[0]),
+			VertexAttrib(VTCOORD  , 2, GL_FLOAT, 0, &page.texCoords[0]),
+			VertexAttrib(VCOLOR   , 4, GL_FLOAT, 0, &page.colors[0])
+		};
 
-		// Restore position to the start of the line
-		glPopMatrix();
+		for (size_t j = 0; j < ARRAYSIZE(attribs); j++)
+			attribs[j].enable();
 
-		// Move to the next line
-		glTranslatef(0.0f, -lineHeight, 0.0f);
+		glDrawArrays(GL_QUADS, 0, page.getQuadCount() * 4);
 
-		// \n character
-		position++;
+		for (size_t j = 0; j < ARRAYSIZE(attribs); j++)
+			attribs[j].disable();
 	}
 
 	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
@@ -269,35 +291,23 @@ bool Text::isIn(float x, float y) const {
 	return true;
 }
 
-void Text::renderImmediate(const glm::mat4 &parentTransform)
-{
+void Text::renderImmediate(const glm::mat4 &parentTransform) {
 	Font &font = _font.getFont();
-	float lineHeight = font.getHeight() + font.getLineSpacing();
-
-	std::vector<Common::UString> lines;
-	font.split(_str, lines, _width, _height, false);
-
-	float blockSize = lines.size() * lineHeight;
-
-	// Move position to the top
-	size_t position = 0;
-
-	ColorPositions::const_iterator color = _colors.begin();
-
-	_font.getFont().renderBind(parentTransform);
-	float x = roundf(_x);
-	float y = roundf(_y) + roundf(((_height - blockSize) * _valign) + blockSize - lineHeight);
-	// Draw lines
-	for (std::vector<Common::UString>::iterator l = lines.begin(); l != lines.end(); ++l) {
-		float saved_x = x;
-		float saved_y = y;
-		drawLineImmediate(*l, color, position, x, y);
-		x = saved_x;
-		y = saved_y - lineHeight;
-		// \n character
-		position++;
+
+	const glm::mat4 transform = glm::translate(parentTransform, glm::vec3(roundf(_x), roundf(_y), 0.0f));
+
+	font.renderBind(transform);
+
+	// Draw all characters on a page in one go
+	for (size_t i = 0; i < _layout.getPageCount(); i++) {
+		const TextLayout::Page &page = _layout.getPage(i);
+		if (page.getQuadCount() == 0)
+			continue;
+
+		font.renderQuads(i, &page.vertices[0], &page.texCoords[0], &page.colors[0], page.getQuadCount());
 	}
-	_font.getFont().renderUnbind();
+
+	font.renderUnbind();
 }
 
 void Text::parseColors(const Common::UString &str, Common::UString &parsed,
@@ -385,67 +395,19 @@ void Text::parseColors(const Common::UString &str, Common::UString &parsed,
 }
 
 void Text::setFont(const Common::UString &fnt) {
-	_font = FontMan.get(fnt);
-}
-
-void Text::drawLine(const Common::UString &line,
-                    ColorPositions::const_iterator color,
-                    size_t position) {
-
-	Font &font = _font.getFont();
-
-	// Horizontal Align
-	glTranslatef(roundf((_width - font.getLineWidth(line)) * _halign), 0.0f, 0.0f);
+	lockFrameIfVisible();
 
-	// Draw line
-	for (Common::UString::iterator s = line.begin(); s != line.end(); ++s, position++) {
-		// If we have color changes, apply them
-		while ((color != _colors.end()) && (color->position <= position)) {
-			if (color->defaultColor)
-				glColor4f(_r, _g, _b, _a);
-			else
-				glColor4f(color->r, color->g, color->b, color->a);
+	_font = FontMan.get(fnt);
 
-			++color;
-		}
+	_font.getFont().buildChars(_str);
 
-		font.draw(*s);
-	}
+	updateLayout();
 
+	unlockFrameIfVisible();
 }
 
-void Text::drawLineImmediate(const Common::UString &line,
-                             ColorPositions::const_iterator color,
-                             size_t position,
-                             float &x,
-                             float &y) {
-
-	Font &font = _font.getFont();
-
-	// Horizontal Align
-	x += round((_width - font.getLineWidth(line)) * _halign);
-
-	// Draw line
-	float rgba[] = { _r, _g, _b, _a };
-	for (Common::UString::iterator s = line.begin(); s != line.end(); ++s, position++) {
-		// If we have color changes, apply them
-		while ((color != _colors.end()) && (color->position <= position)) {
-			if (color->defaultColor) {
-				rgba[0] = _r;
-				rgba[1] = _g;
-				rgba[2] = _b;
-				rgba[3] = _a;
-			} else {
-				rgba[0] = color->r;
-				rgba[1] = color->g;
-				rgba[2] = color->b;
-				rgba[3] = color->a;
-			}
-
-			++color;
-		}
-		font.render(*s, x, y, rgba);
-	}
+void Text::updateLayout() {
+	_layout.build(_font.getFont(), _str, _colors, _width, _height, _halign, _valign);
 }
 
 } // End of namespace Aurora
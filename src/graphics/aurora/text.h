@@ -30,6 +30,7 @@
 
 #include "src/graphics/types.h"
 #include "src/graphics/guielement.h"
+#include "src/graphics/textlayout.h"
 
 #include "src/graphics/aurora/fonthandle.h"
 #include "src/graphics/aurora/types.h"
@@ -111,18 +112,13 @@ private:
 
 	bool _disableColorTokens;
 
+	/** The quads of all characters, laid out whenever the text, its box or its font changes. */
+	TextLayout _layout;
+
 	void parseColors(const Common::UString &str, Common::UString &parsed,
 	                 ColorPositions &colors);
 
-	void drawLine(const Common::UString &line,
-	              ColorPositions::const_iterator color,
-	              size_t position);
-
-	void drawLineImmediate(const Common::UString &line,
-	                       ColorPositions::const_iterator color,
-	                       size_t position,
-	                       float &x,
-	                       float &y);
+	void updateLayout();
 };
 
 } // End of namespace Aurora
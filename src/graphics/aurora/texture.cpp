@@ -55,12 +55,49 @@ namespace Graphics {
 
 namespace Aurora {
 
-Texture::Texture() : _type(::Aurora::kFileTypeNone), _width(0), _height(0), _deswizzle(false) {
+Texture::FullImage::FullImage(const Common::UString &n, bool d) : name(n), deswizzle(d),
+	type(::Aurora::kFileTypeNone) {
+
+}
+
+Texture::FullImage::~FullImage() {
+}
+
+void Texture::FullImage::fetch() {
+	try {
+		txi.reset(loadTXI(name));
+		getImageStreams(name, txi.get(), type, streams);
+
+	} catch (Common::Exception &e) {
+		e.add("Failed to reload texture \"%s\" (%d)", name.c_str(), type);
+		throw;
+	}
+}
+
+void Texture::FullImage::decode() {
+	try {
+		image.reset(loadImage(streams, type, txi.get(), deswizzle));
+
+	} catch (Common::Exception &e) {
+		e.add("Failed to reload texture \"%s\" (%d)", name.c_str(), type);
+		throw;
+	}
+}
+
+void Texture::FullImage::load() {
+	fetch();
+	decode();
+}
+
+
+Texture::Texture() : _type(::Aurora::kFileTypeNone), _width(0), _height(0), _deswizzle(false),
+	_droppedMipMaps(0) {
+
 }
 
 Texture::Texture(const Common::UString &name, ImageDecoder *image,
                  ::Aurora::FileType type, TXI *txi, bool deswizzle) :
-	_name(name), _type(type), _width(0), _height(0), _deswizzle(deswizzle) {
+	_name(name), _type(type), _width(0), _height(0), _deswizzle(deswizzle), _droppedMipMaps(0) {
 
 	set(name, image, type, txi, deswizzle);
 	addToQueues();
@@ -113,27 +150,64 @@ bool Texture::reload() {
 	if (_name.empty())
 		return false;
 
-	::Aurora::FileType type = ::Aurora::kFileTypeNone;
-	ImageDecoder *image = 0;
-	TXI *txi = 0;
+	FullImage fullImage(_name, _deswizzle);
+	fullImage.load();
 
-	try {
+	setFullImage(fullImage);
 
-		txi   = loadTXI  (_name);
-		image = loadImage(_name, type, txi, _deswizzle);
+	return true;
+}
 
-	} catch (Common::Exception &e) {
-		delete txi;
+bool Texture::isStreamable() const {
+	return !_name.empty() && !isDynamic() && (_mipMapSizes.size() > 1);
+}
 
-		e.add("Failed to reload texture \"%s\" (%d)", _name.c_str(), type);
-		throw;
+void Texture::getMipMapSizes(std::vector<size_t> &sizes) const {
+	sizes = _mipMapSizes;
+}
+
+size_t Texture::getDroppedMipMaps() const {
+	return _droppedMipMaps;
+}
+
+bool Texture::setDroppedMipMaps(size_t count) {
+	if (count == _droppedMipMaps)
+		return true;
+
+	if (!isStreamable() || (count >= _mipMapSizes.size()))
+		return false;
+
+	if (count < _droppedMipMaps) {
+		// We need mip maps we don't have anymore. Reload the full image and start over
+
+		if (!reload())
+			return false;
+	}
+
+	if (count > _droppedMipMaps) {
+		const size_t mipMapCount = _image->getMipMapCount();
+
+		_image->dropMipMaps(count - _droppedMipMaps);
+		_droppedMipMaps += mipMapCount - _image->getMipMapCount();
+
+		// Free the now oversized texture and rebuild it with the remaining mip maps
+		destroy();
+		refresh();
 	}
 
+	return _droppedMipMaps == count;
+}
+
+Texture::FullImage *Texture::createFullImage() const {
+	return new FullImage(_name, _deswizzle);
+}
+
+void Texture::setFullImage(FullImage &fullImage) {
+	assert(fullImage.image);
+
 	removeFromQueues();
-	set(_name, image, type, txi, _deswizzle);
+	set(_name, fullImage.image.release(), fullImage.type, fullImage.txi.release(), _deswizzle);
 	addToQueues();
-
-	return true;
 }
 
 bool Texture::dumpTGA(const Common::UString &fileName) const {
@@ -396,6 +470,12 @@ void Texture::set(const Common::UString &name, ImageDecoder *image, ::Aurora::Fi
 	_height = _image->getMipMap(0).height;
 
 	_deswizzle = deswizzle;
+
+	_mipMapSizes.resize(_image->getMipMapCount());
+	for (size_t i = 0; i < _mipMapSizes.size(); i++)
+		_mipMapSizes[i] = _image->getMipMapSize(i);
+
+	_droppedMipMaps = 0;
 }
 
 ImageDecoder *Texture::loadImage(const Common::UString &name, bool deswizzle) {
@@ -426,23 +506,56 @@ ImageDecoder *Texture::loadImage(const Common::UString &name, ::Aurora::FileType
 ImageDecoder *Texture::loadImage(const Common::UString &name, ::Aurora::FileType &type,
                                  TXI *txi, bool deswizzle) {
 
+	Common::PtrVector<Common::SeekableReadStream> streams;
+	getImageStreams(name, txi, type, streams);
+
+	return loadImage(streams, type, txi, deswizzle);
+}
+
+void Texture::getImageStreams(const Common::UString &name, const TXI *txi, ::Aurora::FileType &type,
+                              Common::PtrVector<Common::SeekableReadStream> &streams) {
+
+	streams.clear();
+
 	const bool isFileCubeMap = txi && txi->getFeatures().cube && (txi->getFeatures().fileRange == 6);
 	if (!isFileCubeMap) {
 		Common::SeekableReadStream *imageStream = ResMan.getResource(::Aurora::kResourceImage, name, &type);
 		if (!imageStream)
 			throw Common::Exception("No such image resource \"%s\"", name.c_str());
 
+		streams.push_back(imageStream);
+		return;
+	}
+
+	for (size_t i = 0; i < 6; i++) {
+		const Common::UString side = name + Common::composeString(i);
+		Common::SeekableReadStream *imageStream = ResMan.getResource(::Aurora::kResourceImage, side, &type);
+		if (!imageStream)
+			throw Common::Exception("No such cube side image resource \"%s\"", side.c_str());
+
+		streams.push_back(imageStream);
+	}
+}
+
+ImageDecoder *Texture::loadImage(Common::PtrVector<Common::SeekableReadStream> &streams,
+                                 ::Aurora::FileType type, TXI *txi, bool deswizzle) {
+
+	if (streams.size() == 1) {
+		Common::SeekableReadStream *imageStream = streams[0];
+		streams[0] = 0;
+
 		return loadImage(imageStream, type, txi, deswizzle);
 	}
 
+	if (streams.size() != 6)
+		throw Common::Exception("Invalid number of image files (%u)", (uint) streams.size());
+
 	ImageDecoder *layers[6] = { 0, 0, 0, 0, 0, 0 };
 
 	try {
 		for (size_t i = 0; i < 6; i++) {
-			const Common::UString side = name + Common::composeString(i);
-			Common::SeekableReadStream *imageStream = ResMan.getResource(::Aurora::kResourceImage, side, &type);
-			if (!imageStream)
-				throw Common::Exception("No such cube side image resource \"%s\"", side.c_str());
+			Common::SeekableReadStream *imageStream = streams[i];
+			streams[i] = 0;
 
 			layers[i] = loadImage(imageStream, type, txi, deswizzle);
 		}
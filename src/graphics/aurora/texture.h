@@ -25,7 +25,10 @@
 #ifndef GRAPHICS_AURORA_TEXTURE_H
 #define GRAPHICS_AURORA_TEXTURE_H
 
+#include <vector>
+
 #include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
 #include "src/common/ustring.h"
 
 #include "src/graphics/types.h"
@@ -47,6 +50,35 @@ namespace Aurora {
 /** A texture. */
 class Texture : public Graphics::Texture {
 public:
+	/** The full image of a texture, loaded again to bring back dropped mip maps.
+	 *
+	 *  Loading happens in two steps: fetching the files out of the resource
+	 *  manager, which isn't thread-safe, and decoding them, which is.
+	 */
+	struct FullImage {
+		Common::UString name;
+		bool deswizzle;
+
+		::Aurora::FileType type;
+
+		Common::ScopedPtr<ImageDecoder> image;
+		Common::ScopedPtr<TXI> txi;
+
+		/** The fetched image files, not yet decoded. */
+		Common::PtrVector<Common::SeekableReadStream> streams;
+
+		FullImage(const Common::UString &n, bool d);
+		~FullImage();
+
+		/** Fetch the TXI and image files. This needs to happen in the main thread. */
+		void fetch();
+		/** Decode the fetched image files. This does not need to happen in the main thread. */
+		void decode();
+
+		/** Fetch and decode the image. */
+		void load();
+	};
+
 	virtual ~Texture();
 
 	uint32 getWidth()  const;
@@ -65,6 +97,20 @@ public:
 	/** Try to reload the texture. */
 	virtual bool reload();
 
+	/** Can the largest mip maps of this texture be dropped and later reloaded? */
+	bool isStreamable() const;
+	/** Return the size in bytes of each mip map level, as originally loaded. */
+	void getMipMapSizes(std::vector<size_t> &sizes) const;
+	/** Return the number of largest mip maps that are currently not in memory. */
+	size_t getDroppedMipMaps() const;
+	/** Drop or reload mip maps, so that exactly this many of the largest are not in memory. */
+	bool setDroppedMipMaps(size_t count);
+
+	/** Create an empty full image of this texture, to be loaded with FullImage::load(). */
+	FullImage *createFullImage() const;
+	/** Take over this loaded full image, bringing back all dropped mip maps. */
+	void setFullImage(FullImage &fullImage);
+
 	/** Dump the texture into a TGA. */
 	bool dumpTGA(const Common::UString &fileName) const;
 
@@ -94,6 +140,11 @@ protected:
 
 	bool _deswizzle;
 
+	/** The sizes of all mip map levels of the full image. */
+	std::vector<size_t> _mipMapSizes;
+	/** The number of largest mip maps dropped from the image. */
+	size_t _droppedMipMaps;
+
 
 	Texture();
 	Texture(const Common::UString &name, ImageDecoder *image, ::Aurora::FileType type, TXI *txi = 0,
@@ -128,6 +179,13 @@ protected:
 	static ImageDecoder *loadImage(const Common::UString &name, ::Aurora::FileType &type, TXI *txi,
 	                               bool deswizzle = false);
 
+	/** Get the image files of this texture, one for each cube side if the TXI says so. */
+	static void getImageStreams(const Common::UString &name, const TXI *txi, ::Aurora::FileType &type,
+	                            Common::PtrVector<Common::SeekableReadStream> &streams);
+	/** Decode these image files, taking them over. */
+	static ImageDecoder *loadImage(Common::PtrVector<Common::SeekableReadStream> &streams,
+	                               ::Aurora::FileType type, TXI *txi, bool deswizzle);
+
 	static Texture *createPLT(const Common::UString &name, Common::SeekableReadStream *imageStream);
 };
 
@@ -22,6 +22,8 @@
  *  A texture font, as used by NWN and KotOR/KotOR2.
  */
 
+#include <cstring>
+
 #include <vector>
 
 #include "src/common/types.h"
@@ -133,6 +135,25 @@ void TextureFont::draw(uint32 c) const {
 	glTranslatef(cC->second.width + _spaceR, 0.0f, 0.0f);
 }
 
+bool TextureFont::getCharQuad(uint32 c, CharQuad &quad) const {
+	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
+	if (cC == _chars.end())
+		return false;
+
+	quad.page = 0;
+
+	std::memcpy(quad.tX, cC->second.tX, sizeof(quad.tX));
+	std::memcpy(quad.tY, cC->second.tY, sizeof(quad.tY));
+	std::memcpy(quad.vX, cC->second.vX, sizeof(quad.vX));
+	std::memcpy(quad.vY, cC->second.vY, sizeof(quad.vY));
+
+	return true;
+}
+
+void TextureFont::bindPage(size_t UNUSED(page)) const {
+	TextureMan.set(_texture);
+}
+
 void TextureFont::renderBind(const glm::mat4 &transform) const {
 	glUseProgram(_renderable->getProgram()->glid);
 	_material->bindProgram(_renderable->getProgram(), 1.0f);
@@ -177,6 +198,12 @@ void TextureFont::render(uint32 c, float &x, float &y, float *rgba) const {
 	x += cC->second.width + _spaceR;
 }
 
+void TextureFont::renderQuads(size_t UNUSED(page), const float *pos, const float *uv, const float *rgba,
+                              size_t count) const {
+
+	_mesh->render(pos, uv, rgba, count);
+}
+
 void TextureFont::renderUnbind() const {
 	_mesh->renderUnbind();
 
@@ -32,7 +32,7 @@ namespace Graphics {
 
 namespace Aurora {
 
-ManagedTexture::ManagedTexture(Texture *t) : texture(t), referenceCount(0) {
+ManagedTexture::ManagedTexture(Texture *t) : texture(t), referenceCount(0), residency(0) {
 }
 
 ManagedTexture::~ManagedTexture() {
@@ -30,6 +30,8 @@
 #include "src/common/types.h"
 #include "src/common/ustring.h"
 
+#include "src/graphics/aurora/textureresidency.h"
+
 namespace Graphics {
 
 namespace Aurora {
@@ -41,6 +43,9 @@ struct ManagedTexture {
 	Texture *texture;
 	uint32 referenceCount;
 
+	/** The memory bookkeeping of this texture. */
+	TextureResidency::Entry *residency;
+
 	ManagedTexture(Texture *t);
 	~ManagedTexture();
 };
@@ -22,10 +22,14 @@
  *  The Aurora texture manager.
  */
 
+#include <map>
+#include <chrono>
+
 #include "src/common/scopedptr.h"
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/uuid.h"
+#include "src/common/threads.h"
 
 #include "src/graphics/aurora/textureman.h"
 #include "src/graphics/aurora/texture.h"
@@ -80,7 +84,7 @@ static GLenum kTextureUnit[] = {
 static const size_t kTextureUnitCount = ARRAYSIZE(kTextureUnit);
 
 
-TextureManager::TextureManager() : _deswizzleSBM(false), _recordNewTextures(false) {
+TextureManager::TextureManager() : _deswizzleSBM(false), _recordNewTextures(false), _renderDistance(0.0) {
 }
 
 TextureManager::~TextureManager() {
@@ -96,6 +100,11 @@ void TextureManager::clear() {
 		delete t->second;
 	_textures.clear();
 
+	_residency.clear();
+
+	// Loads still running in the background keep their image alive until they're done
+	_streamIns.clear();
+
 	_deswizzleSBM = false;
 
 	_recordNewTextures = false;
@@ -140,7 +149,7 @@ TextureHandle TextureManager::add(Texture *texture, Common::UString name) {
 	if (!result.second)
 		throw Common::Exception("Texture \"%s\" already exists", name.c_str());
 
-	managedTexture.release();
+	addResidency(*managedTexture.release());
 	TextureMap::iterator textureIterator = result.first;
 
 	if (_recordNewTextures)
@@ -167,6 +176,8 @@ TextureHandle TextureManager::get(Common::UString name) {
 		result = _textures.insert(std::make_pair(name, managedTexture));
 
 		texture = result.first;
+
+		addResidency(*managedTexture);
 	}
 
 	if (_recordNewTextures)
@@ -219,6 +230,11 @@ void TextureManager::release(TextureHandle &texture) {
 
 	if (!texture._empty && (texture._it != _textures.end())) {
 		if (--texture._it->second->referenceCount == 0) {
+			// A full image still loading in the background is of no use anymore
+			_streamIns.erase(texture._it->second);
+
+			removeResidency(*texture._it->second);
+
 			delete texture._it->second;
 			_textures.erase(texture._it);
 		}
@@ -245,6 +261,175 @@ void TextureManager::reloadAll() {
 	GfxMan.unlockFrame();
 }
 
+void TextureManager::setMemoryBudget(size_t budget) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	_residency.setBudget(budget);
+}
+
+void TextureManager::setStreamDistance(double distance) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	_residency.setStreamDistance(distance);
+}
+
+size_t TextureManager::getMemorySizeCPU() {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	return _residency.getCPUSize();
+}
+
+size_t TextureManager::getMemorySizeGPU() {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	return _residency.getGPUSize();
+}
+
+void TextureManager::setRenderDistance(double distance) {
+	_renderDistance = distance;
+}
+
+void TextureManager::addResidency(ManagedTexture &texture) {
+	std::vector<size_t> mipMapSizes;
+	texture.texture->getMipMapSizes(mipMapSizes);
+
+	texture.residency = _residency.addTexture(mipMapSizes, texture.texture->isStreamable());
+}
+
+void TextureManager::removeResidency(ManagedTexture &texture) {
+	_residency.removeTexture(texture.residency);
+	texture.residency = 0;
+}
+
+void TextureManager::syncResidency(ManagedTexture &texture) {
+	TextureResidency::Entry *entry = texture.residency;
+	if (!entry)
+		return;
+
+	// The image might have changed completely, so update everything
+	std::vector<size_t> mipMapSizes;
+	texture.texture->getMipMapSizes(mipMapSizes);
+
+	_residency.setUploaded(entry, false);
+	_residency.setLevelSizes(entry, mipMapSizes);
+	_residency.setBaseLevel(entry, texture.texture->getDroppedMipMaps());
+}
+
+void TextureManager::touch(const TextureHandle &handle) {
+	if (handle.empty())
+		return;
+
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	TextureResidency::Entry *residency = handle._it->second->residency;
+	if (!residency)
+		return;
+
+	_residency.touch(residency, _renderDistance);
+	_residency.setUploaded(residency, handle._it->second->texture->getID() != 0);
+}
+
+void TextureManager::startStreamIn(const Common::UString &name, ManagedTexture &texture) {
+	std::shared_ptr<Texture::FullImage> image(texture.texture->createFullImage());
+
+	/* The resource manager isn't thread-safe, so the files are fetched here,
+	 * in the main thread. Only the decoding happens in the background. */
+	try {
+		image->fetch();
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Failed to change the mip maps of texture \"%s\"", name.c_str());
+
+		if (texture.residency)
+			texture.residency->streamable = false;
+
+		return;
+	}
+
+	StreamIn &streamIn = _streamIns[&texture];
+
+	streamIn.name  = name;
+	streamIn.image = image;
+
+	streamIn.loaded = Common::runInBackground([image]() {
+		image->decode();
+	});
+}
+
+void TextureManager::finishStreamIns() {
+	for (StreamIns::iterator s = _streamIns.begin(); s != _streamIns.end(); ) {
+		if (s->second.loaded.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			++s;
+			continue;
+		}
+
+		// Released textures drop their stream-in, so this is still the texture the image was loaded for
+		ManagedTexture &texture = *s->first;
+
+		try {
+			s->second.loaded.get();
+
+			texture.texture->setFullImage(*s->second.image);
+		} catch (...) {
+			Common::exceptionDispatcherWarning("Failed to change the mip maps of texture \"%s\"", s->second.name.c_str());
+
+			if (texture.residency)
+				texture.residency->streamable = false;
+		}
+
+		syncResidency(texture);
+
+		_streamIns.erase(s++);
+	}
+}
+
+void TextureManager::updateResidency() {
+	Common::enforceMainThread();
+
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	finishStreamIns();
+
+	TextureResidency::Changes changes;
+	_residency.update(changes);
+
+	if (!changes.empty()) {
+		std::map<TextureResidency::Entry *, size_t> baseLevels;
+		for (TextureResidency::Changes::const_iterator c = changes.begin(); c != changes.end(); ++c)
+			baseLevels.insert(std::make_pair(c->entry, c->baseLevel));
+
+		for (TextureMap::iterator t = _textures.begin(); t != _textures.end(); ++t) {
+			std::map<TextureResidency::Entry *, size_t>::const_iterator baseLevel = baseLevels.find(t->second->residency);
+			if (baseLevel == baseLevels.end())
+				continue;
+
+			// Still waiting for the full image
+			if (_streamIns.find(t->second) != _streamIns.end())
+				continue;
+
+			Texture &texture = *t->second->texture;
+
+			if (baseLevel->second < texture.getDroppedMipMaps()) {
+				// We need mip maps we don't have anymore. Load the full image without stalling the frame
+				startStreamIn(t->first, *t->second);
+				continue;
+			}
+
+			try {
+				if (!texture.setDroppedMipMaps(baseLevel->second))
+					t->second->residency->streamable = false;
+			} catch (...) {
+				Common::exceptionDispatcherWarning("Failed to change the mip maps of texture \"%s\"", t->first.c_str());
+
+				t->second->residency->streamable = false;
+			}
+
+			syncResidency(*t->second);
+		}
+	}
+
+	_residency.nextFrame();
+}
+
 void TextureManager::reset() {
 	for (size_t i = 0; i < kTextureUnitCount; i++) {
 		activeTexture(i);
@@ -283,6 +468,8 @@ void TextureManager::set(const TextureHandle &handle, TextureMode mode) {
 	if (id == 0)
 		warning("Empty texture ID for texture \"%s\"", handle._it->first.c_str());
 
+	touch(handle);
+
 	if (handle._it->second->texture->getImage().isCubeMap()) {
 		glBindTexture(GL_TEXTURE_CUBE_MAP, id);
 
@@ -27,13 +27,18 @@
 
 #include <set>
 #include <list>
+#include <map>
+#include <memory>
 
 #include "src/common/types.h"
 #include "src/common/singleton.h"
 #include "src/common/ustring.h"
 #include "src/common/mutex.h"
+#include "src/common/threads.h"
 
+#include "src/graphics/aurora/texture.h"
 #include "src/graphics/aurora/texturehandle.h"
+#include "src/graphics/aurora/textureresidency.h"
 
 namespace Graphics {
 
@@ -90,6 +95,33 @@ public:
 	void reloadAll();
 	// '---
 
+	// .--- Texture memory
+	/** Set the memory budget for all textures, in bytes. 0 means unlimited. */
+	void setMemoryBudget(size_t budget);
+	/** Textures used by renderables closer than this will have all their mip maps loaded. */
+	void setStreamDistance(double distance);
+
+	/** Return the number of bytes of texture data held in system memory. */
+	size_t getMemorySizeCPU();
+	/** Return the number of bytes of texture data uploaded to the GPU. */
+	size_t getMemorySizeGPU();
+
+	/** Set the distance of the renderable the following texture binds are used for. */
+	void setRenderDistance(double distance);
+
+	/** Mark this texture as used in the current frame, by the current renderable. */
+	void touch(const TextureHandle &handle);
+
+	/** Drop and reload mip maps according to the memory budget, and start a new frame.
+	 *
+	 *  Dropping mip maps happens right away. Mip maps that need to be reloaded
+	 *  are loaded in the background, and brought back in a later frame.
+	 *
+	 *  Needs to be called from the main thread, once per frame.
+	 */
+	void updateResidency();
+	// '---
+
 	// .--- Texture rendering
 	/** Bind this texture to the current texture unit. */
 	void set(const TextureHandle &handle, TextureMode mode = kModeDiffuse);
@@ -113,6 +145,30 @@ private:
 	bool _recordNewTextures;
 	std::list<Common::UString> _newTextureNames;
 
+	/** The full image of a texture, being decoded in the background. */
+	struct StreamIn {
+		Common::UString name;
+
+		std::shared_ptr<Texture::FullImage> image;
+		std::future<void> loaded;
+	};
+
+	/** The stream-ins, by the texture they belong to. Dropped when that texture is released. */
+	typedef std::map<ManagedTexture *, StreamIn> StreamIns;
+
+	TextureResidency _residency;
+	double _renderDistance;
+
+	StreamIns _streamIns;
+
+	void addResidency(ManagedTexture &texture);
+	void removeResidency(ManagedTexture &texture);
+	/** Update the residency bookkeeping after the mip maps of this texture changed. */
+	void syncResidency(ManagedTexture &texture);
+
+	void startStreamIn(const Common::UString &name, ManagedTexture &texture);
+	void finishStreamIns();
+
 	void assign(TextureHandle &texture, const TextureHandle &from);
 	void release(TextureHandle &texture);
 
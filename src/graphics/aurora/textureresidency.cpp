@@ -0,0 +1,269 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Bookkeeping of texture memory against a budget.
+ */
+
+#include <cassert>
+#include <cfloat>
+
+#include <algorithm>
+
+#include "src/common/util.h"
+
+#include "src/graphics/aurora/textureresidency.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+size_t TextureResidency::Entry::getSize(size_t level) const {
+	size_t size = 0;
+	for (size_t i = level; i < levelSizes.size(); i++)
+		size += levelSizes[i];
+
+	return size;
+}
+
+size_t TextureResidency::Entry::getResidentSize() const {
+	return getSize(baseLevel);
+}
+
+
+TextureResidency::Change::Change(Entry *e, size_t b) : entry(e), baseLevel(b) {
+}
+
+
+TextureResidency::TextureResidency(size_t budget) : _budget(budget), _streamDistance(0.0),
+	_frame(0), _sizeCPU(0), _sizeGPU(0) {
+
+}
+
+TextureResidency::~TextureResidency() {
+	clear();
+}
+
+void TextureResidency::clear() {
+	for (Entries::iterator e = _entries.begin(); e != _entries.end(); ++e)
+		delete *e;
+
+	_entries.clear();
+
+	_sizeCPU = 0;
+	_sizeGPU = 0;
+}
+
+void TextureResidency::setBudget(size_t budget) {
+	_budget = budget;
+}
+
+size_t TextureResidency::getBudget() const {
+	return _budget;
+}
+
+void TextureResidency::setStreamDistance(double distance) {
+	_streamDistance = distance;
+}
+
+double TextureResidency::getStreamDistance() const {
+	return _streamDistance;
+}
+
+TextureResidency::Entry *TextureResidency::addTexture(const std::vector<size_t> &levelSizes, bool streamable) {
+	Entry *entry = new Entry;
+
+	entry->levelSizes = levelSizes;
+	entry->baseLevel  = 0;
+	entry->uploaded   = false;
+	entry->streamable = streamable && (levelSizes.size() > 1);
+	entry->lastUsed   = _frame;
+	entry->distance   = DBL_MAX;
+
+	_entries.insert(entry);
+	addSize(*entry);
+
+	return entry;
+}
+
+void TextureResidency::removeTexture(Entry *entry) {
+	if (!entry)
+		return;
+
+	Entries::iterator e = _entries.find(entry);
+	if (e == _entries.end())
+		return;
+
+	removeSize(*entry);
+	_entries.erase(e);
+
+	delete entry;
+}
+
+size_t TextureResidency::getTextureCount() const {
+	return _entries.size();
+}
+
+void TextureResidency::nextFrame() {
+	_frame++;
+}
+
+uint32 TextureResidency::getFrame() const {
+	return _frame;
+}
+
+void TextureResidency::touch(Entry *entry, double distance) {
+	assert(entry);
+
+	if (entry->lastUsed != _frame) {
+		entry->lastUsed = _frame;
+		entry->distance = distance;
+		return;
+	}
+
+	entry->distance = MIN(entry->distance, distance);
+}
+
+void TextureResidency::setUploaded(Entry *entry, bool uploaded) {
+	assert(entry);
+
+	if (entry->uploaded == uploaded)
+		return;
+
+	removeSize(*entry);
+	entry->uploaded = uploaded;
+	addSize(*entry);
+}
+
+void TextureResidency::setBaseLevel(Entry *entry, size_t baseLevel) {
+	assert(entry);
+	assert(baseLevel < entry->levelSizes.size());
+
+	removeSize(*entry);
+	entry->baseLevel = baseLevel;
+	addSize(*entry);
+}
+
+void TextureResidency::setLevelSizes(Entry *entry, const std::vector<size_t> &levelSizes) {
+	assert(entry);
+
+	removeSize(*entry);
+
+	entry->levelSizes = levelSizes;
+	entry->baseLevel  = 0;
+	entry->streamable = entry->streamable && (levelSizes.size() > 1);
+
+	addSize(*entry);
+}
+
+size_t TextureResidency::getCPUSize() const {
+	return _sizeCPU;
+}
+
+size_t TextureResidency::getGPUSize() const {
+	return _sizeGPU;
+}
+
+size_t TextureResidency::getSize() const {
+	return _sizeCPU + _sizeGPU;
+}
+
+void TextureResidency::addSize(const Entry &entry) {
+	const size_t size = entry.getResidentSize();
+
+	_sizeCPU += size;
+	if (entry.uploaded)
+		_sizeGPU += size;
+}
+
+void TextureResidency::removeSize(const Entry &entry) {
+	const size_t size = entry.getResidentSize();
+
+	assert(_sizeCPU >= size);
+	_sizeCPU -= size;
+
+	if (entry.uploaded) {
+		assert(_sizeGPU >= size);
+		_sizeGPU -= size;
+	}
+}
+
+/** Least recently used first; of those used in the same frame, the farthest first. */
+static bool compareEviction(const TextureResidency::Entry *a, const TextureResidency::Entry *b) {
+	if (a->lastUsed != b->lastUsed)
+		return a->lastUsed < b->lastUsed;
+
+	return a->distance > b->distance;
+}
+
+void TextureResidency::update(Changes &changes) const {
+	changes.clear();
+
+	size_t size = getSize();
+
+	std::vector<Entry *> candidates;
+	for (Entries::const_iterator e = _entries.begin(); e != _entries.end(); ++e) {
+		Entry &entry = **e;
+		if (!entry.streamable)
+			continue;
+
+		const bool isNear = (entry.lastUsed == _frame) && (entry.distance <= _streamDistance);
+
+		if (isNear) {
+			// Used by something close to the camera, stream the full mip map chain back in
+
+			if (entry.baseLevel > 0) {
+				const size_t missing = entry.getSize(0) - entry.getResidentSize();
+				size += entry.uploaded ? (2 * missing) : missing;
+
+				changes.push_back(Change(&entry, 0));
+			}
+
+			continue;
+		}
+
+		// Always keep the smallest mip map around
+		if ((entry.baseLevel + 1) < entry.levelSizes.size())
+			candidates.push_back(&entry);
+	}
+
+	if ((_budget == 0) || (size <= _budget))
+		return;
+
+	std::sort(candidates.begin(), candidates.end(), compareEviction);
+
+	for (std::vector<Entry *>::iterator c = candidates.begin(); (c != candidates.end()) && (size > _budget); ++c) {
+		Entry &entry = **c;
+
+		size_t level = entry.baseLevel;
+		while ((size > _budget) && ((level + 1) < entry.levelSizes.size())) {
+			const size_t levelSize = entry.levelSizes[level++];
+
+			size -= entry.uploaded ? (2 * levelSize) : levelSize;
+		}
+
+		if (level != entry.baseLevel)
+			changes.push_back(Change(&entry, level));
+	}
+}
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
@@ -0,0 +1,160 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Bookkeeping of texture memory against a budget.
+ */
+
+#ifndef GRAPHICS_AURORA_TEXTURERESIDENCY_H
+#define GRAPHICS_AURORA_TEXTURERESIDENCY_H
+
+#include <vector>
+#include <set>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** Bookkeeping of texture memory against a budget.
+ *
+ *  Every texture registers the sizes of its mip map levels here. While
+ *  rendering, each texture is marked as used, together with the distance
+ *  of the closest renderable it was used for.
+ *
+ *  Once per frame, update() then decides which textures should get their
+ *  full mip map chain streamed back in, because something using them
+ *  came close to the camera, and which textures should drop their largest
+ *  mip maps, least recently used first, to get back under the budget.
+ *
+ *  This class only does the accounting. The TextureManager is responsible
+ *  for applying the changes to the actual textures. That way, the residency
+ *  logic can be exercised without an OpenGL context.
+ */
+class TextureResidency : boost::noncopyable {
+public:
+	/** The residency state of a single texture. */
+	struct Entry {
+		/** The size in bytes of each mip map level, summed over all layers. */
+		std::vector<size_t> levelSizes;
+
+		size_t baseLevel; ///< The largest mip map level currently in memory.
+		bool uploaded;    ///< Have the resident mip maps been uploaded to the GPU?
+		bool streamable;  ///< Can mip maps of this texture be dropped and reloaded?
+
+		uint32 lastUsed;  ///< The frame this texture was last used in.
+		double distance;  ///< The distance of the closest user in that frame.
+
+		/** Return the size of all mip map levels, starting with this one. */
+		size_t getSize(size_t level) const;
+		/** Return the size of all resident mip map levels. */
+		size_t getResidentSize() const;
+	};
+
+	/** A requested change in the resident mip map levels of a texture. */
+	struct Change {
+		Entry *entry;     ///< The texture to change.
+		size_t baseLevel; ///< The new largest resident mip map level.
+
+		Change(Entry *e = 0, size_t b = 0);
+	};
+
+	typedef std::vector<Change> Changes;
+
+	/** Create a texture residency tracker with that budget in bytes. 0 means unlimited. */
+	TextureResidency(size_t budget = 0);
+	~TextureResidency();
+
+	/** Forget about all textures. */
+	void clear();
+
+	/** Set the memory budget in bytes for all textures. 0 means unlimited. */
+	void setBudget(size_t budget);
+	/** Return the memory budget in bytes for all textures. */
+	size_t getBudget() const;
+
+	/** Textures used by renderables closer than this distance will be streamed back in. */
+	void setStreamDistance(double distance);
+	/** Return the distance under which textures will be streamed back in. */
+	double getStreamDistance() const;
+
+	/** Register a texture with these mip map level sizes. */
+	Entry *addTexture(const std::vector<size_t> &levelSizes, bool streamable = true);
+	/** Forget about a texture. */
+	void removeTexture(Entry *entry);
+
+	/** Return the number of registered textures. */
+	size_t getTextureCount() const;
+
+	/** Advance to the next frame. */
+	void nextFrame();
+	/** Return the current frame. */
+	uint32 getFrame() const;
+
+	/** Mark this texture as used in the current frame, by a renderable at that distance. */
+	void touch(Entry *entry, double distance);
+
+	/** Mark whether the resident mip maps of this texture are uploaded to the GPU. */
+	void setUploaded(Entry *entry, bool uploaded);
+	/** Record that this texture now holds all mip maps starting with this level. */
+	void setBaseLevel(Entry *entry, size_t baseLevel);
+	/** Record that this texture now has these mip map level sizes, with all of them resident. */
+	void setLevelSizes(Entry *entry, const std::vector<size_t> &levelSizes);
+
+	/** Return the number of bytes of mip map data held in system memory. */
+	size_t getCPUSize() const;
+	/** Return the number of bytes of mip map data uploaded to the GPU. */
+	size_t getGPUSize() const;
+	/** Return the number of bytes counting against the budget. */
+	size_t getSize() const;
+
+	/** Evaluate the residency of all textures.
+	 *
+	 *  Fills changes with the base level changes needed to honor the stream
+	 *  distance and the budget. The changes are not applied; the caller has
+	 *  to do that, and then report back with setBaseLevel().
+	 */
+	void update(Changes &changes) const;
+
+private:
+	typedef std::set<Entry *> Entries;
+
+	size_t _budget;
+	double _streamDistance;
+
+	uint32 _frame;
+
+	Entries _entries;
+
+	size_t _sizeCPU;
+	size_t _sizeGPU;
+
+	void addSize(const Entry &entry);
+	void removeSize(const Entry &entry);
+};
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_AURORA_TEXTURERESIDENCY_H
@@ -23,6 +23,7 @@
  */
 
 #include <cassert>
+#include <cstring>
 
 #include "src/common/util.h"
 #include "src/common/error.h"
@@ -181,6 +182,31 @@ void TTFFont::draw(uint32 c) const {
 	glTranslatef(cC->second.width, 0.0f, 0.0f);
 }
 
+bool TTFFont::getCharQuad(uint32 c, CharQuad &quad) const {
+	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
+	if (cC == _chars.end()) {
+		cC = _missingChar;
+
+		if (cC == _chars.end())
+			return false;
+	}
+
+	quad.page = cC->second.page;
+
+	std::memcpy(quad.tX, cC->second.tX, sizeof(quad.tX));
+	std::memcpy(quad.tY, cC->second.tY, sizeof(quad.tY));
+	std::memcpy(quad.vX, cC->second.vX, sizeof(quad.vX));
+	std::memcpy(quad.vY, cC->second.vY, sizeof(quad.vY));
+
+	return true;
+}
+
+void TTFFont::bindPage(size_t page) const {
+	assert(page < _pages.size());
+
+	TextureMan.set(_pages[page]->texture);
+}
+
 void TTFFont::buildChars(const Common::UString &str) {
 	for (Common::UString::iterator c = str.begin(); c != str.end(); ++c)
 		addChar(*c);
@@ -247,6 +273,13 @@ void TTFFont::render(uint32 c, float &x, float &y, float *rgba) const {
 	x += cC->second.width;
 }
 
+void TTFFont::renderQuads(size_t page, const float *pos, const float *uv, const float *rgba, size_t count) const {
+	// As in render(), the sampler was bound last, so we can switch textures on the fly
+	bindPage(page);
+
+	_mesh->render(pos, uv, rgba, count);
+}
+
 void TTFFont::renderUnbind() const {
 	_mesh->renderUnbind();
 
@@ -62,6 +62,9 @@ public:
 
 	void draw(uint32 c) const;
 
+	bool getCharQuad(uint32 c, CharQuad &quad) const;
+	void bindPage(size_t page) const;
+
 	void buildChars(const Common::UString &str);
 
 	/** Bind the font for rendering. Must be performed before render is called.
@@ -73,6 +76,8 @@ public:
 	virtual void render(uint32 c, float &x, float &y, float *rgba) const;
 	virtual void renderUnbind() const;
 
+	virtual void renderQuads(size_t page, const float *pos, const float *uv, const float *rgba, size_t count) const;
+
 private:
 	/** A texture page filled with characters. */
 	struct Page {
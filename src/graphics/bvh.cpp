@@ -0,0 +1,569 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A dynamic bounding volume hierarchy of axis-aligned boxes.
+ */
+
+/* The insertion heuristic and the tree rotations are modelled after
+ * the dynamic AABB tree found in Erin Catto's Box2D. */
+
+#include <cassert>
+
+#include <algorithm>
+
+#include "src/common/util.h"
+
+#include "src/graphics/bvh.h"
+#include "src/graphics/frustum.h"
+
+namespace Graphics {
+
+/** Return the surface area of a box. */
+static inline float getArea(const glm::vec3 &min, const glm::vec3 &max) {
+	const glm::vec3 d = max - min;
+
+	return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+/** Return the surface area of the box enclosing two boxes. */
+static inline float getCombinedArea(const glm::vec3 &min1, const glm::vec3 &max1,
+                                    const glm::vec3 &min2, const glm::vec3 &max2) {
+
+	return getArea(glm::min(min1, min2), glm::max(max1, max2));
+}
+
+/** Does the outer box completely contain the inner box? */
+static inline bool contains(const glm::vec3 &outerMin, const glm::vec3 &outerMax,
+                            const glm::vec3 &innerMin, const glm::vec3 &innerMax) {
+
+	return (outerMin.x <= innerMin.x) && (outerMin.y <= innerMin.y) && (outerMin.z <= innerMin.z) &&
+	       (outerMax.x >= innerMax.x) && (outerMax.y >= innerMax.y) && (outerMax.z >= innerMax.z);
+}
+
+/** Intersect the line segment start + t * direction, with t in [0, 1], with a box.
+ *
+ *  @param  distance Will be set to the t where the segment enters the box or,
+ *                   if the segment starts inside the box, where it leaves it.
+ *  @return true if the segment hits the box.
+ */
+static inline bool intersectRay(const glm::vec3 &start, const glm::vec3 &direction,
+                                const glm::vec3 &min, const glm::vec3 &max, float &distance) {
+
+	float tMin = 0.0f, tMax = 1.0f;
+
+	bool inside = true;
+
+	for (int i = 0; i < 3; i++) {
+		if (direction[i] == 0.0f) {
+			// Parallel to these two planes, so it either runs between them or misses
+			if ((start[i] < min[i]) || (start[i] > max[i]))
+				return false;
+
+			continue;
+		}
+
+		float t1 = (min[i] - start[i]) / direction[i];
+		float t2 = (max[i] - start[i]) / direction[i];
+		if (t1 > t2)
+			std::swap(t1, t2);
+
+		if (t1 >= 0.0f)
+			inside = false;
+
+		tMin = MAX(tMin, t1);
+		tMax = MIN(tMax, t2);
+
+		if (tMin > tMax)
+			return false;
+	}
+
+	/* A box around the start would otherwise always be the nearest hit,
+	 * hiding everything in front of its far side. */
+	distance = inside ? tMax : tMin;
+	return true;
+}
+
+static bool compareRayHits(const BVH::RayHit &a, const BVH::RayHit &b) {
+	return a.distance < b.distance;
+}
+
+
+BVH::BVH(float margin) : _margin(margin), _root(kInvalidProxy), _freeList(kInvalidProxy), _leafCount(0) {
+}
+
+BVH::~BVH() {
+}
+
+void BVH::clear() {
+	_nodes.clear();
+
+	_root      = kInvalidProxy;
+	_freeList  = kInvalidProxy;
+	_leafCount = 0;
+}
+
+size_t BVH::size() const {
+	return _leafCount;
+}
+
+int BVH::getHeight() const {
+	if (_root == kInvalidProxy)
+		return 0;
+
+	return _nodes[_root].height + 1;
+}
+
+int BVH::allocateNode() {
+	int node = _freeList;
+
+	if (node != kInvalidProxy) {
+		_freeList = _nodes[node].parent;
+	} else {
+		node = (int) _nodes.size();
+		_nodes.push_back(Node());
+	}
+
+	Node &n = _nodes[node];
+
+	n.data   = 0;
+	n.parent = kInvalidProxy;
+	n.child1 = kInvalidProxy;
+	n.child2 = kInvalidProxy;
+	n.height = 0;
+
+	return node;
+}
+
+void BVH::freeNode(int node) {
+	assert((node >= 0) && ((size_t) node < _nodes.size()));
+
+	_nodes[node].parent = _freeList;
+	_nodes[node].height = -1;
+	_nodes[node].data   = 0;
+
+	_freeList = node;
+}
+
+void BVH::fatten(Node &node, const glm::vec3 &min, const glm::vec3 &max) const {
+	const glm::vec3 margin = (max - min) * 0.1f + glm::vec3(_margin);
+
+	node.leafMin = min;
+	node.leafMax = max;
+
+	node.min = min - margin;
+	node.max = max + margin;
+}
+
+int BVH::insert(const glm::vec3 &min, const glm::vec3 &max, void *data) {
+	const int proxy = allocateNode();
+
+	fatten(_nodes[proxy], min, max);
+	_nodes[proxy].data = data;
+
+	insertLeaf(proxy);
+	_leafCount++;
+
+	return proxy;
+}
+
+void BVH::remove(int proxy) {
+	assert((proxy >= 0) && ((size_t) proxy < _nodes.size()) && _nodes[proxy].isLeaf());
+
+	removeLeaf(proxy);
+	freeNode(proxy);
+
+	_leafCount--;
+}
+
+bool BVH::move(int proxy, const glm::vec3 &min, const glm::vec3 &max) {
+	assert((proxy >= 0) && ((size_t) proxy < _nodes.size()) && _nodes[proxy].isLeaf());
+
+	Node &node = _nodes[proxy];
+
+	const glm::vec3 margin = (max - min) * 0.1f + glm::vec3(_margin);
+
+	/* Still within the fat box, and the fat box isn't overly large
+	 * (because the object shrunk a lot)? Then just remember the box. */
+	if (contains(node.min, node.max, min, max) &&
+	    (getArea(node.min, node.max) <= (4.0f * getArea(min - margin, max + margin)))) {
+
+		node.leafMin = min;
+		node.leafMax = max;
+		return false;
+	}
+
+	removeLeaf(proxy);
+
+	fatten(_nodes[proxy], min, max);
+
+	insertLeaf(proxy);
+	return true;
+}
+
+void *BVH::getData(int proxy) const {
+	assert((proxy >= 0) && ((size_t) proxy < _nodes.size()) && _nodes[proxy].isLeaf());
+
+	return _nodes[proxy].data;
+}
+
+void BVH::getBox(int proxy, glm::vec3 &min, glm::vec3 &max) const {
+	assert((proxy >= 0) && ((size_t) proxy < _nodes.size()) && _nodes[proxy].isLeaf());
+
+	min = _nodes[proxy].leafMin;
+	max = _nodes[proxy].leafMax;
+}
+
+void BVH::insertLeaf(int leaf) {
+	if (_root == kInvalidProxy) {
+		_root = leaf;
+		_nodes[_root].parent = kInvalidProxy;
+		return;
+	}
+
+	const glm::vec3 leafMin = _nodes[leaf].min;
+	const glm::vec3 leafMax = _nodes[leaf].max;
+
+	// Walk down the tree, looking for the best sibling for the new leaf
+	int index = _root;
+	while (!_nodes[index].isLeaf()) {
+		const Node &node = _nodes[index];
+
+		const float area         = getArea(node.min, node.max);
+		const float combinedArea = getCombinedArea(node.min, node.max, leafMin, leafMax);
+
+		// Cost of creating a new parent for this node and the new leaf
+		const float cost = 2.0f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCost[2];
+		const int children[2] = { node.child1, node.child2 };
+
+		for (int i = 0; i < 2; i++) {
+			const Node &child = _nodes[children[i]];
+
+			childCost[i] = getCombinedArea(child.min, child.max, leafMin, leafMax) + inheritanceCost;
+			if (!child.isLeaf())
+				childCost[i] -= getArea(child.min, child.max);
+		}
+
+		if ((cost < childCost[0]) && (cost < childCost[1]))
+			break;
+
+		index = (childCost[0] < childCost[1]) ? children[0] : children[1];
+	}
+
+	const int sibling   = index;
+	const int oldParent = _nodes[sibling].parent;
+	const int newParent = allocateNode();
+
+	Node &parent = _nodes[newParent];
+
+	parent.parent = oldParent;
+	parent.min    = glm::min(leafMin, _nodes[sibling].min);
+	parent.max    = glm::max(leafMax, _nodes[sibling].max);
+	parent.height = _nodes[sibling].height + 1;
+	parent.child1 = sibling;
+	parent.child2 = leaf;
+
+	if (oldParent != kInvalidProxy) {
+		if (_nodes[oldParent].child1 == sibling)
+			_nodes[oldParent].child1 = newParent;
+		else
+			_nodes[oldParent].child2 = newParent;
+	} else
+		_root = newParent;
+
+	_nodes[sibling].parent = newParent;
+	_nodes[leaf].parent    = newParent;
+
+	refit(newParent);
+}
+
+void BVH::removeLeaf(int leaf) {
+	if (leaf == _root) {
+		_root = kInvalidProxy;
+		return;
+	}
+
+	const int parent      = _nodes[leaf].parent;
+	const int grandParent = _nodes[parent].parent;
+	const int sibling     = (_nodes[parent].child1 == leaf) ? _nodes[parent].child2 : _nodes[parent].child1;
+
+	// Replace the parent with the sibling
+	if (grandParent != kInvalidProxy) {
+		if (_nodes[grandParent].child1 == parent)
+			_nodes[grandParent].child1 = sibling;
+		else
+			_nodes[grandParent].child2 = sibling;
+
+		_nodes[sibling].parent = grandParent;
+		freeNode(parent);
+
+		refit(grandParent);
+	} else {
+		_root = sibling;
+
+		_nodes[sibling].parent = kInvalidProxy;
+		freeNode(parent);
+	}
+}
+
+void BVH::refit(int node) {
+	while (node != kInvalidProxy) {
+		node = balance(node);
+
+		Node &n = _nodes[node];
+		const Node &child1 = _nodes[n.child1];
+		const Node &child2 = _nodes[n.child2];
+
+		n.height = 1 + MAX(child1.height, child2.height);
+		n.min    = glm::min(child1.min, child2.min);
+		n.max    = glm::max(child1.max, child2.max);
+
+		node = n.parent;
+	}
+}
+
+int BVH::balance(int iA) {
+	Node &a = _nodes[iA];
+	if (a.isLeaf() || (a.height < 2))
+		return iA;
+
+	const int iB = a.child1;
+	const int iC = a.child2;
+
+	Node &b = _nodes[iB];
+	Node &c = _nodes[iC];
+
+	const int balance = c.height - b.height;
+
+	// Rotate C up
+	if (balance > 1) {
+		const int iF = c.child1;
+		const int iG = c.child2;
+
+		Node &f = _nodes[iF];
+		Node &g = _nodes[iG];
+
+		c.child1 = iA;
+		c.parent = a.parent;
+		a.parent = iC;
+
+		if (c.parent != kInvalidProxy) {
+			if (_nodes[c.parent].child1 == iA)
+				_nodes[c.parent].child1 = iC;
+			else
+				_nodes[c.parent].child2 = iC;
+		} else
+			_root = iC;
+
+		// Keep the higher of C's children with C
+		Node &kept  = (f.height > g.height) ? f : g;
+		Node &moved = (f.height > g.height) ? g : f;
+		const int iKept  = (f.height > g.height) ? iF : iG;
+		const int iMoved = (f.height > g.height) ? iG : iF;
+
+		c.child2     = iKept;
+		a.child2     = iMoved;
+		moved.parent = iA;
+
+		a.min = glm::min(b.min, moved.min);
+		a.max = glm::max(b.max, moved.max);
+		c.min = glm::min(a.min, kept.min);
+		c.max = glm::max(a.max, kept.max);
+
+		a.height = 1 + MAX(b.height, moved.height);
+		c.height = 1 + MAX(a.height, kept.height);
+
+		return iC;
+	}
+
+	// Rotate B up
+	if (balance < -1) {
+		const int iD = b.child1;
+		const int iE = b.child2;
+
+		Node &d = _nodes[iD];
+		Node &e = _nodes[iE];
+
+		b.child1 = iA;
+		b.parent = a.parent;
+		a.parent = iB;
+
+		if (b.parent != kInvalidProxy) {
+			if (_nodes[b.parent].child1 == iA)
+				_nodes[b.parent].child1 = iB;
+			else
+				_nodes[b.parent].child2 = iB;
+		} else
+			_root = iB;
+
+		// Keep the higher of B's children with B
+		Node &kept  = (d.height > e.height) ? d : e;
+		Node &moved = (d.height > e.height) ? e : d;
+		const int iKept  = (d.height > e.height) ? iD : iE;
+		const int iMoved = (d.height > e.height) ? iE : iD;
+
+		b.child2     = iKept;
+		a.child1     = iMoved;
+		moved.parent = iA;
+
+		a.min = glm::min(c.min, moved.min);
+		a.max = glm::max(c.max, moved.max);
+		b.min = glm::min(a.min, kept.min);
+		b.max = glm::max(a.max, kept.max);
+
+		a.height = 1 + MAX(c.height, moved.height);
+		b.height = 1 + MAX(a.height, kept.height);
+
+		return iB;
+	}
+
+	return iA;
+}
+
+void BVH::getAll(std::vector<void *> &data) const {
+	if (_root != kInvalidProxy)
+		collect(_root, data);
+}
+
+void BVH::collect(int node, std::vector<void *> &data) const {
+	const Node &n = _nodes[node];
+
+	if (n.isLeaf()) {
+		data.push_back(n.data);
+		return;
+	}
+
+	collect(n.child1, data);
+	collect(n.child2, data);
+}
+
+void BVH::cull(const Frustum &frustum, std::vector<void *> &visible) const {
+	if (_root != kInvalidProxy)
+		cull(_root, frustum, visible);
+}
+
+void BVH::cull(int node, const Frustum &frustum, std::vector<void *> &visible) const {
+	const Node &n = _nodes[node];
+
+	const Frustum::Intersection intersection = frustum.classifyBox(n.min, n.max);
+	if (intersection == Frustum::kIntersectionOutside)
+		return;
+
+	// Everything in this subtree is visible, no need to test any further
+	if (intersection == Frustum::kIntersectionInside) {
+		collect(node, visible);
+		return;
+	}
+
+	if (n.isLeaf()) {
+		if (frustum.isBoxIn(n.leafMin, n.leafMax))
+			visible.push_back(n.data);
+
+		return;
+	}
+
+	cull(n.child1, frustum, visible);
+	cull(n.child2, frustum, visible);
+}
+
+void BVH::raycast(const glm::vec3 &start, const glm::vec3 &end, std::vector<RayHit> &hits) const {
+	if (_root == kInvalidProxy)
+		return;
+
+	const size_t first = hits.size();
+
+	raycast(_root, start, end - start, hits);
+
+	std::stable_sort(hits.begin() + first, hits.end(), compareRayHits);
+}
+
+void BVH::raycast(int node, const glm::vec3 &start, const glm::vec3 &direction, std::vector<RayHit> &hits) const {
+	const Node &n = _nodes[node];
+
+	float distance;
+	if (!intersectRay(start, direction, n.min, n.max, distance))
+		return;
+
+	if (n.isLeaf()) {
+		if (intersectRay(start, direction, n.leafMin, n.leafMax, distance)) {
+			RayHit hit;
+			hit.distance = distance;
+			hit.data     = n.data;
+
+			hits.push_back(hit);
+		}
+
+		return;
+	}
+
+	raycast(n.child1, start, direction, hits);
+	raycast(n.child2, start, direction, hits);
+}
+
+bool BVH::validate() const {
+	if (_root == kInvalidProxy)
+		return _leafCount == 0;
+
+	size_t leaves = 0;
+	if (validate(_root, kInvalidProxy, leaves) < 0)
+		return false;
+
+	return leaves == _leafCount;
+}
+
+int BVH::validate(int node, int parent, size_t &leaves) const {
+	const Node &n = _nodes[node];
+
+	if (n.parent != parent)
+		return -1;
+
+	if (n.isLeaf()) {
+		if (n.child2 != kInvalidProxy)
+			return -1;
+
+		if (!contains(n.min, n.max, n.leafMin, n.leafMax))
+			return -1;
+
+		leaves++;
+		return (n.height == 0) ? 0 : -1;
+	}
+
+	const int height1 = validate(n.child1, node, leaves);
+	const int height2 = validate(n.child2, node, leaves);
+	if ((height1 < 0) || (height2 < 0))
+		return -1;
+
+	if (n.height != (1 + MAX(height1, height2)))
+		return -1;
+
+	const Node &child1 = _nodes[n.child1];
+	const Node &child2 = _nodes[n.child2];
+	if (!contains(n.min, n.max, child1.min, child1.max) || !contains(n.min, n.max, child2.min, child2.max))
+		return -1;
+
+	return n.height;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,161 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A dynamic bounding volume hierarchy of axis-aligned boxes.
+ */
+
+#ifndef GRAPHICS_BVH_H
+#define GRAPHICS_BVH_H
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "external/glm/vec3.hpp"
+
+#include "src/common/types.h"
+
+namespace Graphics {
+
+class Frustum;
+
+/** A dynamic bounding volume hierarchy of axis-aligned boxes.
+ *
+ *  Every box, together with an opaque user data pointer, is a leaf in
+ *  a binary tree. Each inner node holds a box enclosing both of its
+ *  children, so whole subtrees can be rejected with one test.
+ *
+ *  The tree is kept balanced on insertion and removal. Leaves store a
+ *  slightly enlarged ("fat") box, so that objects moving by small amounts
+ *  don't need to be reinserted every time.
+ *
+ *  The BVH itself is not thread-safe.
+ */
+class BVH : boost::noncopyable {
+public:
+	static const int kInvalidProxy = -1;
+
+	/** A box hit by a ray. */
+	struct RayHit {
+		float distance; ///< Where the ray enters (or leaves) the box, from 0.0f (start) to 1.0f (end).
+		void *data;     ///< The user data of the box.
+	};
+
+	/** Create an empty BVH.
+	 *
+	 *  @param margin How much to enlarge the leaf boxes, in world units,
+	 *                on top of 10% of their extent.
+	 */
+	BVH(float margin = 0.1f);
+	~BVH();
+
+	/** Remove all boxes. */
+	void clear();
+
+	/** Return the number of boxes in the BVH. */
+	size_t size() const;
+	/** Return the height of the tree. An empty tree has a height of 0. */
+	int getHeight() const;
+
+	/** Insert a box. Returns the proxy ID identifying it. */
+	int insert(const glm::vec3 &min, const glm::vec3 &max, void *data);
+	/** Remove a box. */
+	void remove(int proxy);
+
+	/** Update a box after the object it bounds has moved or changed.
+	 *
+	 *  @return true if the box had to be reinserted into the tree.
+	 */
+	bool move(int proxy, const glm::vec3 &min, const glm::vec3 &max);
+
+	/** Return the user data of this box. */
+	void *getData(int proxy) const;
+	/** Return the box itself, as given by insert() or move(). */
+	void getBox(int proxy, glm::vec3 &min, glm::vec3 &max) const;
+
+	/** Collect the user data of all boxes. */
+	void getAll(std::vector<void *> &data) const;
+
+	/** Collect the user data of all boxes that are at least partially inside the frustum. */
+	void cull(const Frustum &frustum, std::vector<void *> &visible) const;
+
+	/** Collect all boxes hit by the line segment from start to end, nearest first.
+	 *
+	 *  A ray starting inside a box hits it at the distance where it leaves the box.
+	 */
+	void raycast(const glm::vec3 &start, const glm::vec3 &end, std::vector<RayHit> &hits) const;
+
+	/** Check the internal consistency of the tree. */
+	bool validate() const;
+
+private:
+	struct Node {
+		glm::vec3 min; ///< Box enclosing the whole subtree (or the fat box for leaves).
+		glm::vec3 max; ///< Box enclosing the whole subtree (or the fat box for leaves).
+
+		glm::vec3 leafMin; ///< The box of a leaf as given.
+		glm::vec3 leafMax; ///< The box of a leaf as given.
+
+		void *data;
+
+		int parent; ///< The parent node, or the next free node in the free list.
+		int child1;
+		int child2;
+
+		/** Height of the subtree. Leaves have height 0, free nodes -1. */
+		int height;
+
+		bool isLeaf() const { return child1 == kInvalidProxy; }
+	};
+
+	float _margin;
+
+	std::vector<Node> _nodes;
+
+	int _root;
+	int _freeList;
+
+	size_t _leafCount;
+
+	int allocateNode();
+	void freeNode(int node);
+
+	void insertLeaf(int leaf);
+	void removeLeaf(int leaf);
+
+	/** Rotate the tree around this node if it's unbalanced. Returns the new subtree root. */
+	int balance(int node);
+
+	/** Recalculate the boxes and heights of this node and all its ancestors, balancing as we go. */
+	void refit(int node);
+
+	void fatten(Node &node, const glm::vec3 &min, const glm::vec3 &max) const;
+
+	void collect(int node, std::vector<void *> &data) const;
+	void cull(int node, const Frustum &frustum, std::vector<void *> &visible) const;
+	void raycast(int node, const glm::vec3 &start, const glm::vec3 &direction, std::vector<RayHit> &hits) const;
+
+	int validate(int node, int parent, size_t &leaves) const;
+};
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_BVH_H
@@ -66,6 +66,10 @@ float Font::getHeight(const Common::UString &text, float maxWidth, float maxHeig
 void Font::buildChars(const Common::UString &UNUSED(str)) {
 }
 
+bool Font::getCharQuad(uint32 UNUSED(c), CharQuad &UNUSED(quad)) const {
+	return false;
+}
+
 float Font::split(const Common::UString &line, std::vector<Common::UString> &lines,
                   float maxWidth, float maxHeight, bool trim) const {
 
@@ -38,6 +38,13 @@ namespace Graphics {
 /** An abstract font. */
 class Font {
 public:
+	/** The textured quad a character is drawn as. */
+	struct CharQuad {
+		size_t page;        ///< Index of the texture page holding the character.
+		float tX[4], tY[4]; ///< Texture coordinates.
+		float vX[4], vY[4]; ///< Vertex coordinates, relative to the pen position.
+	};
+
 	Font();
 	virtual ~Font();
 
@@ -65,10 +72,26 @@ public:
 	/** Draw this character. */
 	virtual void draw(uint32 c) const = 0;
 
+	/** Get the quad this character is drawn as.
+	 *
+	 *  Returns false if nothing is drawn for this character. Either way,
+	 *  the pen then moves on by the width of the character.
+	 */
+	virtual bool getCharQuad(uint32 c, CharQuad &quad) const;
+
+	/** Bind the texture of this page, for drawing the quads on it. */
+	virtual void bindPage(size_t UNUSED(page)) const {}
+
 	virtual void renderBind(const glm::mat4 &UNUSED(transform)) const {}
 	virtual void render(uint32 UNUSED(c), float &UNUSED(x), float &UNUSED(y), float *UNUSED(rgba)) const {}
 	virtual void renderUnbind() const {}
 
+	/** Render quads on this page, each made of four consecutive vertices.
+	 *  Must be performed between renderBind and renderUnbind.
+	 */
+	virtual void renderQuads(size_t UNUSED(page), const float *UNUSED(pos), const float *UNUSED(uv),
+	                         const float *UNUSED(rgba), size_t UNUSED(count)) const {}
+
 	float split(const Common::UString &line, std::vector<Common::UString> &lines,
 	            float maxWidth = 0.0f, float maxHeight = 0.0f, bool trim = true) const;
 	float split(Common::UString &line, float maxWidth, float maxHeight = 0.0f, bool trim = true) const;
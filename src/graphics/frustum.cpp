@@ -0,0 +1,121 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A view frustum, for culling objects that can't be seen.
+ */
+
+#include <cassert>
+
+#include "external/glm/geometric.hpp"
+
+#include "src/graphics/frustum.h"
+
+namespace Graphics {
+
+Frustum::Frustum() {
+	// Planes that never cull anything
+	for (size_t i = 0; i < kPlaneCount; i++)
+		_planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+Frustum::Frustum(const glm::mat4 &viewProjection) {
+	setMatrix(viewProjection);
+}
+
+void Frustum::setMatrix(const glm::mat4 &viewProjection) {
+	/* Extract the planes directly out of the matrix, as described by
+	 * Gribb and Hartmann in "Fast Extraction of Viewing Frustum Planes
+	 * from the World-View-Projection Matrix". glm matrices are column
+	 * major, so we're collecting the rows first. */
+
+	glm::vec4 rows[4];
+	for (int i = 0; i < 4; i++)
+		rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+
+	_planes[0] = rows[3] + rows[0]; // Left
+	_planes[1] = rows[3] - rows[0]; // Right
+	_planes[2] = rows[3] + rows[1]; // Bottom
+	_planes[3] = rows[3] - rows[1]; // Top
+	_planes[4] = rows[3] + rows[2]; // Near
+	_planes[5] = rows[3] - rows[2]; // Far
+
+	for (size_t i = 0; i < kPlaneCount; i++) {
+		const float length = glm::length(glm::vec3(_planes[i]));
+		if (length > 0.0f)
+			_planes[i] /= length;
+	}
+}
+
+const glm::vec4 &Frustum::getPlane(size_t n) const {
+	assert(n < kPlaneCount);
+
+	return _planes[n];
+}
+
+bool Frustum::isIn(const glm::vec3 &point) const {
+	for (size_t i = 0; i < kPlaneCount; i++)
+		if ((glm::dot(glm::vec3(_planes[i]), point) + _planes[i].w) < 0.0f)
+			return false;
+
+	return true;
+}
+
+bool Frustum::isBoxIn(const glm::vec3 &min, const glm::vec3 &max) const {
+	for (size_t i = 0; i < kPlaneCount; i++) {
+		const glm::vec4 &plane = _planes[i];
+
+		// The corner furthest along the plane normal
+		const glm::vec3 positive((plane.x >= 0.0f) ? max.x : min.x,
+		                         (plane.y >= 0.0f) ? max.y : min.y,
+		                         (plane.z >= 0.0f) ? max.z : min.z);
+
+		if ((glm::dot(glm::vec3(plane), positive) + plane.w) < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+Frustum::Intersection Frustum::classifyBox(const glm::vec3 &min, const glm::vec3 &max) const {
+	Intersection result = kIntersectionInside;
+
+	for (size_t i = 0; i < kPlaneCount; i++) {
+		const glm::vec4 &plane = _planes[i];
+
+		// The corners furthest along and furthest against the plane normal
+		const glm::vec3 positive((plane.x >= 0.0f) ? max.x : min.x,
+		                         (plane.y >= 0.0f) ? max.y : min.y,
+		                         (plane.z >= 0.0f) ? max.z : min.z);
+		const glm::vec3 negative((plane.x >= 0.0f) ? min.x : max.x,
+		                         (plane.y >= 0.0f) ? min.y : max.y,
+		                         (plane.z >= 0.0f) ? min.z : max.z);
+
+		if ((glm::dot(glm::vec3(plane), positive) + plane.w) < 0.0f)
+			return kIntersectionOutside;
+
+		if ((glm::dot(glm::vec3(plane), negative) + plane.w) < 0.0f)
+			result = kIntersectionPartial;
+	}
+
+	return result;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,82 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A view frustum, for culling objects that can't be seen.
+ */
+
+#ifndef GRAPHICS_FRUSTUM_H
+#define GRAPHICS_FRUSTUM_H
+
+#include "external/glm/vec3.hpp"
+#include "external/glm/vec4.hpp"
+#include "external/glm/mat4x4.hpp"
+
+namespace Graphics {
+
+/** A view frustum, made up of six planes.
+ *
+ *  The planes are extracted out of a combined projection and modelview
+ *  matrix, so the frustum lives in the same (world) space the objects
+ *  are placed in.
+ */
+class Frustum {
+public:
+	/** Where a box lies in relation to the frustum. */
+	enum Intersection {
+		kIntersectionOutside = 0, ///< The box is completely outside the frustum.
+		kIntersectionPartial,     ///< The box is partially inside the frustum.
+		kIntersectionInside       ///< The box is completely inside the frustum.
+	};
+
+	/** Create a frustum that contains everything. */
+	Frustum();
+	/** Create a frustum out of a combined projection * modelview matrix. */
+	Frustum(const glm::mat4 &viewProjection);
+
+	/** Set the frustum from a combined projection * modelview matrix. */
+	void setMatrix(const glm::mat4 &viewProjection);
+
+	/** Return one of the six planes, as (normal, distance). */
+	const glm::vec4 &getPlane(size_t n) const;
+
+	/** Is this point inside the frustum? */
+	bool isIn(const glm::vec3 &point) const;
+
+	/** Is this axis-aligned box at least partially inside the frustum?
+	 *
+	 *  The test is conservative: a box close to an edge of the frustum
+	 *  might be reported as visible even though it's not.
+	 */
+	bool isBoxIn(const glm::vec3 &min, const glm::vec3 &max) const;
+
+	/** Where does this axis-aligned box lie in relation to the frustum? */
+	Intersection classifyBox(const glm::vec3 &min, const glm::vec3 &max) const;
+
+private:
+	static const size_t kPlaneCount = 6;
+
+	/** The planes, with the normals pointing into the frustum. */
+	glm::vec4 _planes[kPlaneCount];
+};
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_FRUSTUM_H
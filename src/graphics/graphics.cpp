@@ -25,6 +25,8 @@
 #include <cassert>
 #include <cstring>
 
+#include <algorithm>
+
 #include <boost/bind.hpp>
 
 #include "external/glm/gtc/type_ptr.hpp"
@@ -51,6 +53,8 @@
 #include "src/graphics/glcontainer.h"
 #include "src/graphics/renderable.h"
 #include "src/graphics/camera.h"
+#include "src/graphics/frustum.h"
+#include "src/graphics/yuv_to_rgb.h"
 
 #include "src/graphics/images/decoder.h"
 #include "src/graphics/images/screenshot.h"
@@ -62,6 +66,8 @@
 
 #include "src/graphics/render/renderman.h"
 
+#include "src/graphics/aurora/textureman.h"
+
 DECLARE_SINGLETON(Graphics::GraphicsManager)
 
 static glm::mat4 inverse(const glm::mat4 &m);
@@ -80,6 +86,7 @@ GraphicsManager::GraphicsManager() : Events::Notifyable() {
 	_needManualDeS3TC        = false;
 	_supportMultipleTextures = false;
 	_multipleTextureCount    = 0;
+	_supportInstancing       = false;
 
 	// Default to an OpenGL 3.2 compatibility context. GL3.x will be available on most modern systems.
 	_renderType = WindowManager::kOpenGL32Compat;
@@ -112,6 +119,8 @@ GraphicsManager::GraphicsManager() : Events::Notifyable() {
 
 	_lastSampled = 0;
 
+	_frustumCulling = true;
+
 	glCompressedTexImage2D = 0;
 }
 
@@ -131,6 +140,8 @@ void GraphicsManager::init() {
 
 	_rendererExperimental = ConfigMan.getBool("rendernew", false);
 
+	_frustumCulling = ConfigMan.getBool("frustumculling", true);
+
 	if (!setupSDLGL())
 		throw Common::Exception("Failed initializing the OpenGL renderer");
 
@@ -148,6 +159,15 @@ void GraphicsManager::init() {
 	// Check if we have all needed OpenGL extensions
 	checkGLExtensions();
 
+	// Texture memory budget, in MB
+	TextureMan.setMemoryBudget(static_cast<size_t>(MAX(ConfigMan.getInt("texturebudget", 0), 0)) * 1024 * 1024);
+	TextureMan.setStreamDistance(ConfigMan.getDouble("texturestreamdistance", 20.0));
+
+	// Threads for converting video frames. 0 keeps the default of one per CPU core
+	const int videoThreads = ConfigMan.getInt("videothreads", 0);
+	if (videoThreads > 0)
+		YUVToRGBMan.setThreadCount(videoThreads);
+
 	setupScene();
 
 	ShaderMan.init();
@@ -168,10 +188,12 @@ void GraphicsManager::deinit() {
 		return;
 
 	QueueMan.clearAllQueues();
+	clearWorldObjects();
 
 	_animationThread.pause();
 	_animationThread.destroyThread();
 
+	RenderMan.destroyGL();
 	MeshMan.deinit();
 	ShaderMan.deinit();
 	WindowMan.deinit();
@@ -181,6 +203,7 @@ void GraphicsManager::deinit() {
 	_needManualDeS3TC        = false;
 	_supportMultipleTextures = false;
 	_multipleTextureCount    = 0;
+	_supportInstancing       = false;
 }
 
 bool GraphicsManager::ready() const {
@@ -199,6 +222,10 @@ size_t GraphicsManager::getMultipleTextureCount() const {
 	return _multipleTextureCount;
 }
 
+bool GraphicsManager::supportInstancing() const {
+	return _supportInstancing;
+}
+
 int GraphicsManager::getCurrentFSAA() const {
 	return _fsaa;
 }
@@ -356,6 +383,17 @@ void GraphicsManager::checkGLExtensions() {
 		warning("xoreos will only use one texture. Certain surfaces may look weird");
 	}
 
+	// Instanced drawing, for rendering many copies of the same mesh in one call
+	_supportInstancing = false;
+	if (isGL3()) {
+		// Make sure we use the right glVertexAttribDivisor function
+		glVertexAttribDivisor = GLEW_GET_FUN(__glewVertexAttribDivisor) ?
+			(PFNGLVERTEXATTRIBDIVISORPROC)GLEW_GET_FUN(__glewVertexAttribDivisor) :
+			(PFNGLVERTEXATTRIBDIVISORPROC)GLEW_GET_FUN(__glewVertexAttribDivisorARB);
+
+		_supportInstancing = glVertexAttribDivisor && glDrawElementsInstanced && glDrawArraysInstanced;
+	}
+
 	if (_debugGL && GLEW_ARB_debug_output) {
 		warning("Enabled OpenGL debug output");
 
@@ -407,6 +445,10 @@ void GraphicsManager::setupScene() {
 
 	setCullFace(_cullFaceEnabled, _cullFaceMode);
 
+	// The shaders' per-instance inputs, for when we're not drawing instanced
+	if (isGL3())
+		Render::RenderQueue::resetInstanceAttributes();
+
 	setupViewMatrices();
 }
 
@@ -785,7 +827,8 @@ void GraphicsManager::recalculateObjectDistances() {
 	for (std::list<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o)
 		static_cast<Renderable *>(*o)->calculateDistance();
 
-	QueueMan.sortQueue(kQueueVisibleWorldObject);
+	/* No need to sort the world objects here. Only the ones that survive
+	 * culling are sorted, each frame, in cullWorldObjects(). */
 	QueueMan.unlockQueue(kQueueVisibleWorldObject);
 
 	// GUI front objects
@@ -894,36 +937,155 @@ Renderable *GraphicsManager::getGUIObjectAt(float x, float y) const {
 }
 
 Renderable *GraphicsManager::getWorldObjectAt(float x, float y) const {
-	if (QueueMan.isQueueEmpty(kQueueVisibleWorldObject))
-		return 0;
-
 	float x1, y1, z1, x2, y2, z2;
 	if (!unproject(x, y, x1, y1, z1, x2, y2, z2))
 		return 0;
 
+	std::vector<BVH::RayHit> hits;
+
+	/* Holding the world mutex keeps the objects from going away under us,
+	 * without blocking the render queues. Only objects whose bounding box
+	 * the ray actually hits are checked any further. */
+	std::lock_guard<std::mutex> lock(_worldMutex);
+
+	_worldObjects.raycast(glm::vec3(x1, y1, z1), glm::vec3(x2, y2, z2), hits);
+
+	// The hits are sorted along the ray, so the first clickable one is the nearest
 	Renderable *object = 0;
+	for (std::vector<BVH::RayHit>::const_iterator h = hits.begin(); h != hits.end(); ++h) {
+		Renderable &r = *static_cast<Renderable *>(h->data);
 
-	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+		if (r.isClickable() && r.isIn(x1, y1, z1, x2, y2, z2)) {
+			object = &r;
+			break;
+		}
+	}
 
-	for (std::list<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o) {
-		Renderable &r = static_cast<Renderable &>(**o);
+	/* Objects without a bounding box aren't in the BVH, so check them one by one.
+	 * They have no position along the ray, so they compete with the object found
+	 * in the BVH by their distance to the camera, like they always did. */
+	for (std::set<Renderable *>::const_iterator o = _worldUnbounded.begin(); o != _worldUnbounded.end(); ++o) {
+		Renderable &r = **o;
 
 		if (!r.isClickable())
-			// Object isn't clickable, don't check
 			continue;
 
-		// If the line intersects with the object, return it
-		if (r.isIn(x1, y1, z1, x2, y2, z2)) {
+		if (object && (object->getDistance() <= r.getDistance()))
+			// We already found a nearer object
+			continue;
+
+		if (r.isIn(x1, y1, z1, x2, y2, z2))
 			object = &r;
-			break;
-		}
 	}
 
-	QueueMan.unlockQueue(kQueueVisibleWorldObject);
 	return object;
 }
 
+static bool compareDistance(const Renderable *a, const Renderable *b) {
+	if (a->getDistance() != b->getDistance())
+		return a->getDistance() < b->getDistance();
+
+	// Keep the order stable between frames
+	return a->getID() < b->getID();
+}
+
+void GraphicsManager::cullWorldObjects() {
+	_worldCulled.clear();
+	_worldVisible.clear();
+
+	{
+		std::lock_guard<std::mutex> lock(_worldMutex);
+
+		if (_frustumCulling)
+			_worldObjects.cull(Frustum(_projection * _modelview), _worldCulled);
+		else
+			_worldObjects.getAll(_worldCulled);
+
+		// Objects without bounds are always drawn
+		_worldVisible.reserve(_worldCulled.size() + _worldUnbounded.size());
+		_worldVisible.insert(_worldVisible.end(), _worldUnbounded.begin(), _worldUnbounded.end());
+	}
+
+	for (std::vector<void *>::const_iterator o = _worldCulled.begin(); o != _worldCulled.end(); ++o)
+		_worldVisible.push_back(static_cast<Renderable *>(*o));
+
+	// Nearest objects first, just like the queues
+	std::sort(_worldVisible.begin(), _worldVisible.end(), compareDistance);
+}
+
+void GraphicsManager::addWorldObject(Renderable &renderable) {
+	std::lock_guard<std::mutex> lock(_worldMutex);
+
+	if (renderable._inWorld)
+		return;
+
+	glm::vec3 min, max;
+	if (renderable.getWorldBound(min, max))
+		renderable._worldProxy = _worldObjects.insert(min, max, &renderable);
+	else
+		_worldUnbounded.insert(&renderable);
+
+	renderable._inWorld = true;
+}
+
+void GraphicsManager::updateWorldObject(Renderable &renderable) {
+	std::lock_guard<std::mutex> lock(_worldMutex);
+
+	if (!renderable._inWorld)
+		return;
+
+	glm::vec3 min, max;
+	const bool bounded = renderable.getWorldBound(min, max);
+
+	if (bounded && (renderable._worldProxy != BVH::kInvalidProxy)) {
+		_worldObjects.move(renderable._worldProxy, min, max);
+
+	} else if (bounded) {
+		_worldUnbounded.erase(&renderable);
+		renderable._worldProxy = _worldObjects.insert(min, max, &renderable);
+
+	} else if (renderable._worldProxy != BVH::kInvalidProxy) {
+		_worldObjects.remove(renderable._worldProxy);
+		renderable._worldProxy = BVH::kInvalidProxy;
+
+		_worldUnbounded.insert(&renderable);
+	}
+}
+
+void GraphicsManager::removeWorldObject(Renderable &renderable) {
+	std::lock_guard<std::mutex> lock(_worldMutex);
+
+	if (!renderable._inWorld)
+		return;
+
+	if (renderable._worldProxy != BVH::kInvalidProxy)
+		_worldObjects.remove(renderable._worldProxy);
+	else
+		_worldUnbounded.erase(&renderable);
+
+	renderable._worldProxy = BVH::kInvalidProxy;
+	renderable._inWorld    = false;
+}
+
+void GraphicsManager::clearWorldObjects() {
+	std::lock_guard<std::mutex> lock(_worldMutex);
+
+	std::vector<void *> objects;
+	_worldObjects.getAll(objects);
+	objects.insert(objects.end(), _worldUnbounded.begin(), _worldUnbounded.end());
+
+	for (std::vector<void *>::iterator o = objects.begin(); o != objects.end(); ++o) {
+		static_cast<Renderable *>(*o)->_worldProxy = BVH::kInvalidProxy;
+		static_cast<Renderable *>(*o)->_inWorld    = false;
+	}
+
+	_worldObjects.clear();
+	_worldUnbounded.clear();
+
+	_worldCulled.clear();
+	_worldVisible.clear();
+}
+
 Renderable *GraphicsManager::getObjectAt(float x, float y) {
 	Renderable *object = 0;
 
@@ -1034,30 +1196,40 @@ bool GraphicsManager::renderWorld() {
 	_modelview = glm::translate(_modelview, glm::vec3(-cPos[0], -cPos[1], -cPos[2]));
 
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
 
 	buildNewTextures();
 
 	_animationThread.flush();
 
+	cullWorldObjects();
+
 	// Draw opaque objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
-	     o != objects.rend(); ++o) {
+	for (std::vector<Renderable *>::const_reverse_iterator o = _worldVisible.rbegin();
+	     o != _worldVisible.rend(); ++o) {
+
+		Renderable *renderable = *o;
+		TextureMan.setRenderDistance(renderable->getDistance());
 
 		glPushMatrix();
-		static_cast<Renderable *>(*o)->render(kRenderPassOpaque);
+		renderable->render(kRenderPassOpaque);
 		glPopMatrix();
 	}
 
 	// Draw transparent objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
-	     o != objects.rend(); ++o) {
+	for (std::vector<Renderable *>::const_reverse_iterator o = _worldVisible.rbegin();
+	     o != _worldVisible.rend(); ++o) {
+
+		Renderable *renderable = *o;
+		TextureMan.setRenderDistance(renderable->getDistance());
 
 		glPushMatrix();
-		static_cast<Renderable *>(*o)->render(kRenderPassTransparent);
+		renderable->render(kRenderPassTransparent);
 		glPopMatrix();
 	}
 
+	// Everything else is always considered close to the viewer
+	TextureMan.setRenderDistance(0.0);
+
 	QueueMan.unlockQueue(kQueueVisibleWorldObject);
 	return true;
 }
@@ -1161,17 +1333,18 @@ bool GraphicsManager::renderWorldShader() {
 	_modelview = glm::translate(_modelview, glm::vec3(-cPos[0], -cPos[1], -cPos[2]));
 
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
 
 	buildNewTextures();
 
 	_animationThread.flush();
 
+	cullWorldObjects();
+
 	glm::mat4 ident;
 	RenderMan.clear();
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
-	     o != objects.rend(); ++o) {
-		static_cast<Renderable *>(*o)->queueRender(ident);
+	for (std::vector<Renderable *>::const_reverse_iterator o = _worldVisible.rbegin();
+	     o != _worldVisible.rend(); ++o) {
+		(*o)->queueRender(ident);
 	}
 	RenderMan.sort();
 	RenderMan.render();
@@ -1294,6 +1467,8 @@ void GraphicsManager::renderScene() {
 
 	endScene();
 
+	TextureMan.updateResidency();
+
 	_frameEndSignal.store(true, std::memory_order_release);
 }
 
@@ -1365,6 +1540,8 @@ void GraphicsManager::destroyContext() {
 	// Destroying all GL containers, since we need to
 	// reload/rebuild them anyway when the context is recreated
 	destroyGLContainers();
+
+	RenderMan.destroyGL();
 }
 
 void GraphicsManager::rebuildContext() {
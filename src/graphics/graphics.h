@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <list>
+#include <set>
 #include <atomic>
 
 #include "external/glm/mat4x4.hpp"
@@ -39,6 +40,7 @@
 
 #include "src/graphics/types.h"
 #include "src/graphics/windowman.h"
+#include "src/graphics/bvh.h"
 
 #include "src/graphics/aurora/animationthread.h"
 
@@ -79,6 +81,8 @@ public:
 	bool supportMultipleTextures() const;
 	/** Return the number of texture units for multiple textures. */
 	size_t getMultipleTextureCount() const;
+	/** Do we have support for instanced drawing? */
+	bool supportInstancing() const;
 
 	/** Are we currently running an OpenGL 3.x context? */
 	bool isGL3() const;
@@ -127,6 +131,13 @@ public:
 	/** Recalculate all object distances to the camera and resort the objects. */
 	void recalculateObjectDistances();
 
+	/** Add a visible world object to the BVH used for culling. */
+	void addWorldObject(Renderable &renderable);
+	/** Update the BVH after a visible world object moved or changed its bounds. */
+	void updateWorldObject(Renderable &renderable);
+	/** Remove a world object that's not visible anymore from the BVH. */
+	void removeWorldObject(Renderable &renderable);
+
 	/** Increase the frame lock counter, disabling all frame rendering.
 	 *
 	 *  Frame locking is useful for updating several things in one batch,
@@ -198,6 +209,7 @@ private:
 	bool   _needManualDeS3TC;        ///< Do we need to do manual S3TC DXTn decompression?
 	bool   _supportMultipleTextures; ///< Do we have support for multiple textures?
 	size_t _multipleTextureCount;    ///< The number of texture units for multiple textures.
+	bool   _supportInstancing;       ///< Do we have support for instanced drawing?
 
 	WindowManager::RenderType _renderType;
 
@@ -248,6 +260,15 @@ private:
 
 	Aurora::AnimationThread _animationThread;
 
+	bool _frustumCulling; ///< Should world objects outside the view frustum be culled?
+
+	BVH                    _worldObjects;   ///< All visible world objects with a bounding box.
+	std::set<Renderable *> _worldUnbounded; ///< All visible world objects without a bounding box.
+	mutable std::mutex     _worldMutex;     ///< A mutex protecting the world object BVH.
+
+	std::vector<void *>       _worldCulled;  ///< Temporary storage for the culling results.
+	std::vector<Renderable *> _worldVisible; ///< The world objects to render this frame, sorted by distance.
+
 	void setupScene();
 
 	bool setupSDLGL();
@@ -273,6 +294,11 @@ private:
 
 	void buildNewTextures();
 
+	/** Collect the world objects inside the view frustum into _worldVisible. */
+	void cullWorldObjects();
+	/** Forget about all world objects in the BVH. */
+	void clearWorldObjects();
+
 	void beginScene();
 	bool playVideo();
 	bool renderWorld();
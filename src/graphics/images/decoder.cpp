@@ -212,6 +212,47 @@ const ImageDecoder::MipMap &ImageDecoder::getMipMap(size_t mipMap, size_t layer)
 	return *_mipMaps[index];
 }
 
+size_t ImageDecoder::getMipMapSize(size_t mipMap) const {
+	size_t size = 0;
+	for (size_t i = 0; i < _layerCount; i++)
+		size += getMipMap(mipMap, i).size;
+
+	return size;
+}
+
+size_t ImageDecoder::getSize() const {
+	size_t size = 0;
+	for (MipMaps::const_iterator m = _mipMaps.begin(); m != _mipMaps.end(); ++m)
+		size += (*m)->size;
+
+	return size;
+}
+
+void ImageDecoder::dropMipMaps(size_t n) {
+	const size_t mipMapCount = getMipMapCount();
+
+	n = MIN<size_t>(n, mipMapCount - 1);
+	if ((mipMapCount == 0) || (n == 0))
+		return;
+
+	std::vector<MipMap *> mipMaps;
+	mipMaps.reserve(_layerCount * (mipMapCount - n));
+
+	for (size_t i = 0; i < _layerCount; i++) {
+		for (size_t j = 0; j < mipMapCount; j++) {
+			MipMap *mipMap = _mipMaps[i * mipMapCount + j];
+
+			if (j < n)
+				delete mipMap;
+			else
+				mipMaps.push_back(mipMap);
+		}
+	}
+
+	// The old pointers are either deleted or owned by the new vector now
+	_mipMaps.std::vector<MipMap *>::swap(mipMaps);
+}
+
 void ImageDecoder::decompress(MipMap &out, const MipMap &in, PixelFormatRaw format) {
 	if ((format != kPixelFormatDXT1) &&
 	    (format != kPixelFormatDXT3) &&
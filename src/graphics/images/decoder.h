@@ -104,6 +104,18 @@ public:
 	/** Return a mip map. */
 	const MipMap &getMipMap(size_t mipMap, size_t layer = 0) const;
 
+	/** Return the size in bytes of a mip map level, summed over all layers. */
+	size_t getMipMapSize(size_t mipMap) const;
+	/** Return the size in bytes of all mip maps in all layers. */
+	size_t getSize() const;
+
+	/** Remove the n largest mip maps from every layer.
+	 *
+	 *  The smallest mip map is always kept, so an image will never
+	 *  end up without any image data.
+	 */
+	void dropMipMaps(size_t n);
+
 	/** Manually decompress the texture image data. */
 	void decompress();
 
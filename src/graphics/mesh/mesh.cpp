@@ -23,6 +23,7 @@
  */
 
 #include "src/graphics/mesh/mesh.h"
+#include "src/graphics/mesh/meshoptimizer.h"
 
 namespace Graphics {
 
@@ -68,6 +69,13 @@ GLuint Mesh::getHint() const {
 	return _hint;
 }
 
+void Mesh::optimize() {
+	if (_type != GL_TRIANGLES)
+		return;
+
+	optimizeMesh(_vertexBuffer, _indexBuffer);
+}
+
 void Mesh::init() {
 	float minx = 0.0f, miny = 0.0f, minz = 0.0f, maxx = 0.0f, maxy = 0.0f, maxz = 0.0f;
 	float *vertices = static_cast<float *>(_vertexBuffer.getData());
@@ -228,6 +236,14 @@ void Mesh::render() {
 	}
 }
 
+void Mesh::renderInstanced(uint32 count) {
+	if (_indexBuffer.getCount()) {
+		glDrawElementsInstanced(_type, _indexBuffer.getCount(), _indexBuffer.getType(), 0, count);
+	} else {
+		glDrawArraysInstanced(_type, 0, _vertexBuffer.getCount(), count);
+	}
+}
+
 void Mesh::renderUnbind() {
 	if (GfxMan.isGL3()) {
 		// So long as each mesh rebinds what it needs, there's actually no need to bind 0 here.
@@ -55,6 +55,12 @@ public:
 	void setHint(GLuint hint);
 	GLuint getHint() const;
 
+	/** Optimize the mesh data for rendering speed. See optimizeMesh().
+	 *
+	 *  Only for static triangle meshes, before calling init().
+	 */
+	void optimize();
+
 	/** General mesh initialisation, queuing the mesh for GL resource creation. */
 	void init();
 
@@ -69,6 +75,13 @@ public:
 	void render();
 	void renderUnbind();
 
+	/** Render count instances of the mesh in one draw call. Needs OpenGL 3.x.
+	 *
+	 *  Must happen between renderBind() and renderUnbind(), with the
+	 *  per-instance vertex attributes set up.
+	 */
+	void renderInstanced(uint32 count);
+
 	void useIncrement();
 	void useDecrement();
 	uint32 useCount() const;
@@ -22,6 +22,10 @@
  *  Generic mesh handling class.
  */
 
+#include <cstring>
+
+#include "src/common/util.h"
+
 #include "src/graphics/mesh/meshfont.h"
 
 namespace Graphics {
@@ -30,100 +34,53 @@ namespace Mesh {
 
 MeshFont::MeshFont() : Mesh(GL_QUADS, GL_DYNAMIC_DRAW) {
 	// Each vertex is { x, y, z, u, v, r, g, b, a }
-	_vertexBuffer.setSize(4, 9 * sizeof(float));
-
 	VertexDecl vertexDecl;
 	vertexDecl.push_back(VertexAttrib(VPOSITION, 3, GL_FLOAT));
 	vertexDecl.push_back(VertexAttrib(VTCOORD, 2, GL_FLOAT));
 	vertexDecl.push_back(VertexAttrib(VCOLOR, 4, GL_FLOAT));
-	_vertexBuffer.setVertexDeclLinear(4, vertexDecl);
+	_vertexBuffer.setVertexDeclLinear(kMaxQuads * 4, vertexDecl);
 
 	// Fill in some valid data so that mesh init doesn't go beserk.
-	float *verts = static_cast<float *>(_vertexBuffer.getData());
-
-	// Position Data.
-	*verts++ = -1.0f;
-	*verts++ = 0.0f;
-	*verts++ = 0.0f;
-
-	*verts++ = 0.0f;
-	*verts++ = 1.0f;
-	*verts++ = 0.0f;
-
-	*verts++ = 1.0f;
-	*verts++ = 1.0f;
-	*verts++ = 0.0f;
-
-	*verts++ = 1.0f;
-	*verts++ = 0.0f;
-	*verts++ = 0.0f;
-
-	// UV coordinates.
-	*verts++ = 0.0f;
-	*verts++ = 0.0f;
-
-	*verts++ = 0.0f;
-	*verts++ = 1.0f;
-
-	*verts++ = 1.0f;
-	*verts++ = 1.0f;
-
-	*verts++ = 1.0f;
-	*verts++ = 0.0f;
-
-	// Colour information.
-	*verts++ = 1.0f;
-	*verts++ = 1.0f;
-	*verts++ = 1.0f;
-	*verts++ = 1.0f;
-
-	*verts++ = 1.0f;
-	*verts++ = 1.0f;
-	*verts++ = 1.0f;
-	*verts++ = 1.0f;
-
-	*verts++ = 1.0f;
-	*verts++ = 1.0f;
-	*verts++ = 1.0f;
-	*verts++ = 1.0f;
-
-	*verts++ = 1.0f;
-	*verts++ = 1.0f;
-	*verts++ = 1.0f;
-	*verts++ = 1.0f;
+	std::memset(_vertexBuffer.getData(), 0, _vertexBuffer.getCount() * _vertexBuffer.getSize());
 }
 
-void MeshFont::render(float *pos, float *uv, float *rgba) {
-	/**
-	 * This is somewhat simpler than the normal mesh rendering method. There are not
-	 * indices into the vertex array, so that can be stripped out. It's also assumed
-	 * that GL_ARRAY_BUFFER is bound, so it can be overwritten entirely with dynamic
-	 * data. This is the same between GL3 and GL2, so there's no need to check for that.
-	 */
-
-	/**
-	 * Also note that this is really a most inefficient way of updating the vertex buffer.
-	 * Basically creating all vertices on the stack, passing them in here to be copied
-	 * into an internal vertex buffer, and then updating that internal buffer to server
-	 * side resources. It could happily be updated directly from stack values.
+void MeshFont::render(const float *pos, const float *uv, const float *rgba, size_t count) {
+	/* This is somewhat simpler than the normal mesh rendering method. There are not
+	 * indices into the vertex array, so that can be stripped out. The dynamic data
+	 * is directly copied into the server side buffer, attribute by attribute, in as
+	 * many batches of quads as needed. The attributes are laid out linearly, at fixed
+	 * offsets, so the vertex attribute pointers never change.
 	 *
-	 * Alternatively, sub-allocating from a very large pool of vertices and then using
-	 * an offset (index value start) for the actual draw call is an even better way of
-	 * doing things. Most text doesn't change per-frame.
+	 * This is the same between GL3 and GL2, so there's no need to check for that.
+	 * Using a VAO doesn't automatically bind the VBO for data updates, though.
 	 */
 
-	float *verts = static_cast<float *>(_vertexBuffer.getData());
-	for (uint32 i = 0; i < 12; ++i) {
-		verts[i] = pos[i];
-	}
-	for (uint32 i = 0; i < 8; ++i) {
-		verts[i+12] = uv[i];
-	}
-	for (uint32 i = 0; i < 16; ++i) {
-		verts[i+20] = rgba[i];
+	glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer.getVBO());
+
+	const VertexDecl &decl = _vertexBuffer.getVertexDecl();
+
+	const byte *data = static_cast<const byte *>(_vertexBuffer.getData());
+
+	const intptr_t posOffset  = static_cast<const byte *>(decl[0].pointer) - data;
+	const intptr_t uvOffset   = static_cast<const byte *>(decl[1].pointer) - data;
+	const intptr_t rgbaOffset = static_cast<const byte *>(decl[2].pointer) - data;
+
+	while (count > 0) {
+		const size_t quads    = MIN(count, kMaxQuads);
+		const size_t vertices = quads * 4;
+
+		glBufferSubData(GL_ARRAY_BUFFER, posOffset , vertices * 3 * sizeof(float), pos);
+		glBufferSubData(GL_ARRAY_BUFFER, uvOffset  , vertices * 2 * sizeof(float), uv);
+		glBufferSubData(GL_ARRAY_BUFFER, rgbaOffset, vertices * 4 * sizeof(float), rgba);
+
+		glDrawArrays(_type, 0, vertices);
+
+		pos  += vertices * 3;
+		uv   += vertices * 2;
+		rgba += vertices * 4;
+
+		count -= quads;
 	}
-	_vertexBuffer.updateGLBound();
-	glDrawArrays(_type, 0, _vertexBuffer.getCount());
 }
 
 } // End of namespace Mesh
@@ -35,8 +35,18 @@ class MeshFont : public Mesh {
 public:
 	MeshFont();
 
-	/** Dynamic data prior to render call. */
-	void render(float *pos, float *uv, float *rgba);
+	/** Render quads from dynamic data, each made of four consecutive vertices.
+	 *
+	 *  @param pos   { x, y, z } of each vertex.
+	 *  @param uv    { u, v } of each vertex.
+	 *  @param rgba  { r, g, b, a } of each vertex.
+	 *  @param count Number of quads.
+	 */
+	void render(const float *pos, const float *uv, const float *rgba, size_t count = 1);
+
+private:
+	/** Number of quads that fit into the vertex buffer, and can be drawn with one call. */
+	static const size_t kMaxQuads = 256;
 };
 
 } // End of namespace Mesh
@@ -0,0 +1,421 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Optimizing the layout of meshes, for faster rendering.
+ */
+
+/* The vertex cache optimization follows Tom Forsyth's "Linear-Speed
+ * Vertex Cache Optimisation", with the scoring constants given there.
+ * See <https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html>. */
+
+#include <cstring>
+#include <cmath>
+
+#include <algorithm>
+
+#include "src/common/util.h"
+#include "src/common/hash.h"
+
+#include "src/graphics/vertexbuffer.h"
+#include "src/graphics/indexbuffer.h"
+
+#include "src/graphics/mesh/meshoptimizer.h"
+
+namespace Graphics {
+
+namespace Mesh {
+
+static const uint32 kInvalidIndex = 0xFFFFFFFF;
+
+static const float kCacheDecayPower   = 1.5f;
+static const float kLastTriangleScore = 0.75f;
+static const float kValenceBoostScale = 2.0f;
+static const float kValenceBoostPower = 0.5f;
+
+/** Vertices used by more triangles than this all get the same valence score. */
+static const size_t kMaxValence = 32;
+
+float getACMR(const std::vector<uint32> &indices, size_t cacheSize) {
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+		return 0.0f;
+
+	uint32 maxIndex = 0;
+	for (std::vector<uint32>::const_iterator i = indices.begin(); i != indices.end(); ++i)
+		maxIndex = MAX(maxIndex, *i);
+
+	/* In a FIFO cache, a vertex stays cached until cacheSize other
+	 * vertices have been put in after it. So all we need to remember
+	 * is when each vertex was put in, counted in cache misses. */
+	std::vector<size_t> inserted(maxIndex + 1, SIZE_MAX);
+
+	size_t misses = 0;
+	for (std::vector<uint32>::const_iterator i = indices.begin(); i != indices.end(); ++i) {
+		if ((inserted[*i] != SIZE_MAX) && ((misses - inserted[*i]) <= cacheSize))
+			continue;
+
+		inserted[*i] = misses++;
+	}
+
+	return misses / (float) triangleCount;
+}
+
+static inline uint32 hashVertex(const byte *vertex, size_t size) {
+	uint32 hash = 0x811C9DC5;
+
+	for (size_t i = 0; i < size; i++)
+		hash = Common::hashFNV32(hash, vertex[i]);
+
+	return hash;
+}
+
+size_t deduplicateVertices(const byte *vertices, size_t vertexCount, size_t vertexSize,
+                           std::vector<uint32> &remap) {
+
+	remap.resize(vertexCount);
+
+	// Open addressing hash table of the first vertex of each kind
+	size_t tableSize = 2;
+	while (tableSize < (vertexCount * 2))
+		tableSize *= 2;
+
+	std::vector<uint32> table(tableSize, kInvalidIndex);
+	const size_t mask = tableSize - 1;
+
+	size_t uniqueCount = 0;
+	for (size_t v = 0; v < vertexCount; v++) {
+		const byte *vertex = vertices + v * vertexSize;
+
+		for (size_t i = hashVertex(vertex, vertexSize) & mask; ; i = (i + 1) & mask) {
+			if (table[i] == kInvalidIndex) {
+				table[i] = v;
+				remap[v] = uniqueCount++;
+				break;
+			}
+
+			if (std::memcmp(vertices + table[i] * vertexSize, vertex, vertexSize) == 0) {
+				remap[v] = remap[table[i]];
+				break;
+			}
+		}
+	}
+
+	return uniqueCount;
+}
+
+/** Precalculated vertex scores. */
+class VertexScores {
+public:
+	VertexScores() {
+		for (size_t i = 0; i < kVertexCacheSize; i++) {
+			// The vertices of the last triangle are penalized, to avoid strips going back and forth
+			if (i < 3)
+				_cache[i] = kLastTriangleScore;
+			else
+				_cache[i] = std::pow(1.0f - (i - 3) / (float) (kVertexCacheSize - 3), kCacheDecayPower);
+		}
+
+		// Boost vertices with few triangles left, to get rid of them quickly
+		_valence[0] = 0.0f;
+		for (size_t i = 1; i <= kMaxValence; i++)
+			_valence[i] = kValenceBoostScale * std::pow((float) i, -kValenceBoostPower);
+	}
+
+	/** Return the score of a vertex in this cache position (-1 if not cached), used by this many triangles. */
+	float get(int32 cachePosition, uint32 triangles) const {
+		if (triangles == 0)
+			return -1.0f;
+
+		return ((cachePosition >= 0) ? _cache[cachePosition] : 0.0f) + _valence[MIN<size_t>(triangles, kMaxValence)];
+	}
+
+private:
+	float _cache[kVertexCacheSize];
+	float _valence[kMaxValence + 1];
+};
+
+void optimizeVertexCache(std::vector<uint32> &indices, size_t vertexCount) {
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount < 2)
+		return;
+
+	static const VertexScores kScores;
+
+	// The triangles still to be output using each vertex, as ranges in one big list
+	std::vector<uint32> triangleCounts(vertexCount, 0);
+	for (size_t i = 0; i < (triangleCount * 3); i++)
+		triangleCounts[indices[i]]++;
+
+	std::vector<uint32> offsets(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++)
+		offsets[v + 1] = offsets[v] + triangleCounts[v];
+
+	std::vector<uint32> triangles(triangleCount * 3);
+	std::vector<uint32> fill(offsets.begin(), offsets.end() - 1);
+	for (size_t i = 0; i < (triangleCount * 3); i++)
+		triangles[fill[indices[i]]++] = i / 3;
+
+	std::vector<int32> cachePositions(vertexCount, -1);
+
+	std::vector<float> vertexScores(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+		vertexScores[v] = kScores.get(-1, triangleCounts[v]);
+
+	std::vector<float> triangleScores(triangleCount);
+	for (size_t t = 0; t < triangleCount; t++)
+		triangleScores[t] = vertexScores[indices[t * 3 + 0]] +
+		                    vertexScores[indices[t * 3 + 1]] +
+		                    vertexScores[indices[t * 3 + 2]];
+
+	std::vector<bool> output(triangleCount, false);
+
+	std::vector<uint32> optimized;
+	optimized.reserve(triangleCount * 3);
+
+	// The simulated LRU cache. It briefly grows beyond its size when a triangle is added
+	std::vector<uint32> cache, newCache;
+	cache.reserve(kVertexCacheSize + 3);
+	newCache.reserve(kVertexCacheSize + 3);
+
+	uint32 best = 0;
+	for (size_t t = 1; t < triangleCount; t++)
+		if (triangleScores[t] > triangleScores[best])
+			best = t;
+
+	size_t nextUnused = 0;
+
+	while (optimized.size() < (triangleCount * 3)) {
+		if (best == kInvalidIndex) {
+			// Nothing in the cache to continue with, start afresh
+			while (output[nextUnused])
+				nextUnused++;
+
+			best = nextUnused;
+		}
+
+		output[best] = true;
+
+		const uint32 *triangle = &indices[best * 3];
+		optimized.insert(optimized.end(), triangle, triangle + 3);
+
+		newCache.clear();
+
+		for (size_t i = 0; i < 3; i++) {
+			const uint32 v = triangle[i];
+
+			// Remove the triangle from the vertex's list
+			uint32 *vertexTriangles = &triangles[offsets[v]];
+			for (uint32 j = 0; j < triangleCounts[v]; j++) {
+				if (vertexTriangles[j] == best) {
+					vertexTriangles[j] = vertexTriangles[triangleCounts[v] - 1];
+					break;
+				}
+			}
+
+			triangleCounts[v]--;
+
+			// And move the vertex to the front of the cache
+			if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+				newCache.push_back(v);
+		}
+
+		for (std::vector<uint32>::const_iterator c = cache.begin(); c != cache.end(); ++c)
+			if (std::find(newCache.begin(), newCache.end(), *c) == newCache.end())
+				newCache.push_back(*c);
+
+		cache.swap(newCache);
+
+		// Rescore the vertices in the cache, including the ones that just fell out of it
+		for (size_t i = 0; i < cache.size(); i++) {
+			const uint32 v = cache[i];
+
+			cachePositions[v] = (i < kVertexCacheSize) ? (int32) i : -1;
+
+			const float score = kScores.get(cachePositions[v], triangleCounts[v]);
+			const float delta = score - vertexScores[v];
+
+			vertexScores[v] = score;
+
+			for (uint32 j = 0; j < triangleCounts[v]; j++)
+				triangleScores[triangles[offsets[v] + j]] += delta;
+		}
+
+		if (cache.size() > kVertexCacheSize)
+			cache.resize(kVertexCacheSize);
+
+		// The next triangle is the best one using a cached vertex
+		best = kInvalidIndex;
+		float bestScore = -1.0f;
+
+		for (std::vector<uint32>::const_iterator c = cache.begin(); c != cache.end(); ++c) {
+			for (uint32 j = 0; j < triangleCounts[*c]; j++) {
+				const uint32 t = triangles[offsets[*c] + j];
+
+				if (triangleScores[t] > bestScore) {
+					bestScore = triangleScores[t];
+					best      = t;
+				}
+			}
+		}
+	}
+
+	indices.swap(optimized);
+}
+
+size_t optimizeVertexFetch(std::vector<uint32> &indices, size_t vertexCount, std::vector<uint32> &remap) {
+	remap.assign(vertexCount, kInvalidIndex);
+
+	uint32 usedCount = 0;
+	for (std::vector<uint32>::iterator i = indices.begin(); i != indices.end(); ++i) {
+		if (remap[*i] == kInvalidIndex)
+			remap[*i] = usedCount++;
+
+		*i = remap[*i];
+	}
+
+	return usedCount;
+}
+
+/** Read the indices of a mesh. Without an index buffer, every vertex is used once, in order. */
+static bool readIndices(const IndexBuffer &indexBuffer, size_t vertexCount, std::vector<uint32> &indices) {
+	const size_t count = indexBuffer.getCount();
+
+	if (count == 0) {
+		indices.resize(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+			indices[i] = i;
+
+		return true;
+	}
+
+	indices.resize(count);
+
+	const GLvoid *data = indexBuffer.getData();
+	switch (indexBuffer.getType()) {
+		case GL_UNSIGNED_BYTE:
+			for (size_t i = 0; i < count; i++)
+				indices[i] = static_cast<const uint8 *>(data)[i];
+			break;
+
+		case GL_UNSIGNED_SHORT:
+			for (size_t i = 0; i < count; i++)
+				indices[i] = static_cast<const uint16 *>(data)[i];
+			break;
+
+		case GL_UNSIGNED_INT:
+			std::memcpy(&indices[0], data, count * sizeof(uint32));
+			break;
+
+		default:
+			return false;
+	}
+
+	for (size_t i = 0; i < count; i++)
+		if (indices[i] >= vertexCount)
+			return false;
+
+	return true;
+}
+
+bool optimizeMesh(VertexBuffer &vertexBuffer, IndexBuffer &indexBuffer) {
+	const size_t vertexCount = vertexBuffer.getCount();
+
+	VertexDecl decl = vertexBuffer.getVertexDecl();
+	if ((vertexCount == 0) || decl.empty())
+		return false;
+
+	// Gather all attributes of each vertex together
+
+	size_t vertexSize = 0;
+	for (VertexDecl::const_iterator a = decl.begin(); a != decl.end(); ++a) {
+		if (!a->pointer)
+			return false;
+
+		vertexSize += a->size * VertexBuffer::getTypeSize(a->type);
+	}
+
+	std::vector<byte> vertices(vertexCount * vertexSize);
+
+	size_t offset = 0;
+	for (VertexDecl::const_iterator a = decl.begin(); a != decl.end(); ++a) {
+		const size_t size   = a->size * VertexBuffer::getTypeSize(a->type);
+		const size_t stride = (a->stride != 0) ? a->stride : size;
+
+		const byte *source = static_cast<const byte *>(a->pointer);
+		for (size_t v = 0; v < vertexCount; v++)
+			std::memcpy(&vertices[v * vertexSize + offset], source + v * stride, size);
+
+		offset += size;
+	}
+
+	std::vector<uint32> indices;
+	if (!readIndices(indexBuffer, vertexCount, indices) || ((indices.size() % 3) != 0) || indices.empty())
+		return false;
+
+	// Merge identical vertices
+
+	std::vector<uint32> uniqueRemap;
+	const size_t uniqueCount = deduplicateVertices(&vertices[0], vertexCount, vertexSize, uniqueRemap);
+
+	std::vector<byte> uniqueVertices(uniqueCount * vertexSize);
+	for (size_t v = 0; v < vertexCount; v++)
+		std::memcpy(&uniqueVertices[uniqueRemap[v] * vertexSize], &vertices[v * vertexSize], vertexSize);
+
+	for (std::vector<uint32>::iterator i = indices.begin(); i != indices.end(); ++i)
+		*i = uniqueRemap[*i];
+
+	// Reorder the triangles, then the vertices
+
+	optimizeVertexCache(indices, uniqueCount);
+
+	std::vector<uint32> fetchRemap;
+	const size_t usedCount = optimizeVertexFetch(indices, uniqueCount, fetchRemap);
+
+	// Write the vertices back, interleaved
+
+	vertexBuffer.setVertexDeclInterleave(usedCount, decl);
+
+	byte *data = static_cast<byte *>(vertexBuffer.getData());
+	for (size_t v = 0; v < uniqueCount; v++)
+		if (fetchRemap[v] != kInvalidIndex)
+			std::memcpy(data + fetchRemap[v] * vertexSize, &uniqueVertices[v * vertexSize], vertexSize);
+
+	// And the indices, as small as possible
+
+	if (usedCount <= 0x10000) {
+		indexBuffer.setSize(indices.size(), sizeof(uint16), GL_UNSIGNED_SHORT);
+
+		uint16 *index = static_cast<uint16 *>(indexBuffer.getData());
+		for (size_t i = 0; i < indices.size(); i++)
+			index[i] = indices[i];
+
+	} else {
+		indexBuffer.setSize(indices.size(), sizeof(uint32), GL_UNSIGNED_INT);
+
+		std::memcpy(indexBuffer.getData(), &indices[0], indices.size() * sizeof(uint32));
+	}
+
+	return true;
+}
+
+} // End of namespace Mesh
+
+} // End of namespace Graphics
@@ -0,0 +1,93 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Optimizing the layout of meshes, for faster rendering.
+ */
+
+#ifndef GRAPHICS_MESH_MESHOPTIMIZER_H
+#define GRAPHICS_MESH_MESHOPTIMIZER_H
+
+#include <vector>
+
+#include "src/common/types.h"
+
+namespace Graphics {
+
+class VertexBuffer;
+class IndexBuffer;
+
+namespace Mesh {
+
+/** The size of the vertex cache assumed by the optimizer and getACMR(). */
+static const size_t kVertexCacheSize = 32;
+
+/** Return the average cache miss ratio of a triangle list.
+ *
+ *  That's the number of vertices that need to be transformed per
+ *  triangle, with a FIFO post-transform vertex cache of this size.
+ *  It ranges from 3.0 (no vertex ever reused) down to about 0.5
+ *  (a perfect regular grid).
+ */
+float getACMR(const std::vector<uint32> &indices, size_t cacheSize = kVertexCacheSize);
+
+/** Find identical vertices.
+ *
+ *  @param  vertices The vertex data, vertexSize bytes for each vertex.
+ *  @param  remap Will map each vertex to its unique vertex.
+ *  @return The number of unique vertices.
+ */
+size_t deduplicateVertices(const byte *vertices, size_t vertexCount, size_t vertexSize,
+                           std::vector<uint32> &remap);
+
+/** Reorder the triangles of a triangle list, so that they reuse recently
+ *  transformed vertices as much as possible.
+ *
+ *  This is Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+ */
+void optimizeVertexCache(std::vector<uint32> &indices, size_t vertexCount);
+
+/** Reorder vertices in the order they are first used by a triangle list.
+ *
+ *  @param  indices The triangle list, which will be rewritten to use the new order.
+ *  @param  remap Will map each vertex to its new index, or 0xFFFFFFFF if unused.
+ *  @return The number of used vertices.
+ */
+size_t optimizeVertexFetch(std::vector<uint32> &indices, size_t vertexCount, std::vector<uint32> &remap);
+
+/** Optimize a triangle list mesh in place.
+ *
+ *  Removes duplicate vertices, reorders the triangles for the vertex cache
+ *  and the vertices for fetch locality, interleaves all vertex attributes,
+ *  and uses 16-bit indices when possible. The triangles themselves, and
+ *  their winding, stay the same.
+ *
+ *  Anything referring to the vertices by their index (like separately
+ *  stored skinning data) won't match anymore afterwards.
+ *
+ *  @return true if the mesh was optimized, false if it couldn't be.
+ */
+bool optimizeMesh(VertexBuffer &vertexBuffer, IndexBuffer &indexBuffer);
+
+} // End of namespace Mesh
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_MESH_MESHOPTIMIZER_H
@@ -32,7 +32,10 @@ namespace Graphics {
 
 namespace Render {
 
-RenderManager::RenderManager() : _sortingHints(SORT_HINT_NORMAL) {
+RenderManager::RenderManager() :
+		_queueColorSolidPrimary(0), _queueColorSolidSecondary(1), _queueColorSolidDecal(2),
+		_queueColorTransparentPrimary(3), _queueColorTransparentSecondary(4), _queueLast(5),
+		_sortingHints(SORT_HINT_NORMAL), _instanceBuffer(0) {
 }
 
 RenderManager::~RenderManager() {
@@ -92,11 +95,34 @@ void RenderManager::sort() {
 }
 
 void RenderManager::render() {
-	_queueColorSolidPrimary.render();
-	_queueColorSolidSecondary.render();
-	_queueColorSolidDecal.render();
-	_queueColorTransparentPrimary.render();
-	_queueColorTransparentSecondary.render();
+	// Without instancing support, the queues fall back to drawing each node by itself
+	if (GfxMan.supportInstancing() && (_instanceBuffer == 0))
+		glGenBuffers(1, &_instanceBuffer);
+
+	_queueColorSolidPrimary.render(_instanceBuffer);
+	_queueColorSolidSecondary.render(_instanceBuffer);
+	_queueColorSolidDecal.render(_instanceBuffer);
+	_queueColorTransparentPrimary.render(_instanceBuffer);
+	_queueColorTransparentSecondary.render(_instanceBuffer);
+}
+
+RenderQueue::Statistics RenderManager::getStatistics() const {
+	RenderQueue::Statistics statistics;
+
+	statistics += _queueColorSolidPrimary.getStatistics();
+	statistics += _queueColorSolidSecondary.getStatistics();
+	statistics += _queueColorSolidDecal.getStatistics();
+	statistics += _queueColorTransparentPrimary.getStatistics();
+	statistics += _queueColorTransparentSecondary.getStatistics();
+
+	return statistics;
+}
+
+void RenderManager::destroyGL() {
+	if (_instanceBuffer != 0)
+		glDeleteBuffers(1, &_instanceBuffer);
+
+	_instanceBuffer = 0;
 }
 
 void RenderManager::clear() {
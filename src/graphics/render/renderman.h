@@ -59,6 +59,12 @@ public:
 
 	void clear();
 
+	/** Destroy the OpenGL objects held, for example when the context goes away. */
+	void destroyGL();
+
+	/** Return the state changes and draw calls of the last rendered frame. */
+	RenderQueue::Statistics getStatistics() const;
+
 	void init() {}
 	void deinit() {}
 	void cleanup() {}
@@ -73,6 +79,9 @@ private:
 
 	SortingHints _sortingHints;
 
+	/** Buffer for the per-instance data of instanced draws, shared by all queues. */
+	GLuint _instanceBuffer;
+
 	//std::vector<GLContainer *> _queueColorImmediate; // For anything special outside the normal render path.
 };
 
@@ -23,40 +23,135 @@
  */
 
 #include <cassert>
+#include <cstddef>
+#include <cstring>
+
+#include <algorithm>
 
 #include "external/glm/gtc/type_ptr.hpp"
 
 #include "src/graphics/render/renderqueue.h"
 #include "src/common/util.h"
 
-#include <algorithm>
-
 namespace Graphics {
 
 namespace Render {
 
-bool compareShader(const RenderQueue::RenderQueueNode &a, const RenderQueue::RenderQueueNode &b)
-{
-	if (a.program < b.program)
-		return false;
-	else if (a.program > b.program)
-		return true;
-	if (a.material < b.material)  // node_program values are equal.
-		return false;
-	else if (a.material > b.material)
-		return true;
-	else  // node material values are equal, compare mesh values next.
-		return (a.mesh <= b.mesh ? false : true);
-	// No, surfaces are not compared here.
+/* The layout of the sort keys, from the most significant bit down.
+ *
+ * Sorting by state: pass (3 bits), program (10 bits), material (14 bits),
+ * surface (10 bits), mesh (13 bits), depth (14 bits).
+ *
+ * Sorting by depth: pass (3 bits), depth (32 bits), program (10 bits),
+ * material (14 bits), surface (5 bits).
+ *
+ * Resources are identified by small IDs handed out anew for each sort.
+ * Should there be more resources than fit into a field, IDs are cut down
+ * to size. That only ever costs us batching opportunities, since render()
+ * compares the actual resources to decide on state changes. */
+
+static const int kKeyPassShift = 61;
+
+static inline uint64 getKeyField(uint32 value, int bits, int shift) {
+	return ((uint64) (value & ((1U << bits) - 1))) << shift;
+}
+
+/** Convert a non-negative depth value into an unsigned integer with the same ordering. */
+static inline uint32 getDepthBits(float depth) {
+	// Also catches NaNs
+	if (!(depth > 0.0f))
+		return 0;
+
+	uint32 bits;
+	std::memcpy(&bits, &depth, sizeof(bits));
+
+	return bits;
+}
+
+
+RenderQueue::Statistics &RenderQueue::Statistics::operator+=(const Statistics &s) {
+	programChanges  += s.programChanges;
+	materialChanges += s.materialChanges;
+	surfaceChanges  += s.surfaceChanges;
+	meshChanges     += s.meshChanges;
+	drawCalls       += s.drawCalls;
+
+	instancedBatches += s.instancedBatches;
+	drawsSaved       += s.drawsSaved;
+
+	return *this;
+}
+
+
+RenderQueue::ResourceIDs::ResourceIDs() : _entries(64), _generation(1), _count(0), _lastResource(0), _lastID(0) {
+}
+
+void RenderQueue::ResourceIDs::clear() {
+	_count = 0;
+
+	_lastResource = 0;
+	_lastID       = 0;
+
+	// Generation 0 marks empty entries. Very unlikely to ever wrap around, though
+	if (++_generation == 0) {
+		for (std::vector<Entry>::iterator e = _entries.begin(); e != _entries.end(); ++e)
+			e->generation = 0;
+
+		_generation = 1;
+	}
+}
+
+static inline size_t hashResource(const void *resource) {
+	return (size_t) ((((uint64) (uintptr_t) resource) * UINT64_C(0x9E3779B97F4A7C15)) >> 32);
+}
+
+uint32 RenderQueue::ResourceIDs::get(const void *resource) {
+	if (resource == _lastResource)
+		return _lastID;
+
+	if ((2 * (_count + 1)) > _entries.size())
+		grow();
+
+	const size_t mask = _entries.size() - 1;
+
+	for (size_t i = hashResource(resource) & mask; ; i = (i + 1) & mask) {
+		Entry &entry = _entries[i];
+
+		if (entry.generation != _generation) {
+			entry.resource   = resource;
+			entry.generation = _generation;
+			entry.id         = _count++;
+		} else if (entry.resource != resource)
+			continue;
+
+		_lastResource = resource;
+		_lastID       = entry.id;
+
+		return entry.id;
+	}
 }
 
-bool compareDepth(const RenderQueue::RenderQueueNode &a, const RenderQueue::RenderQueueNode &b) {
-	return (a.reference <= b.reference);
-	//return (a.reference.lengthSquared() <= b.reference.lengthSquared());
+void RenderQueue::ResourceIDs::grow() {
+	std::vector<Entry> entries(_entries.size() * 2);
+	_entries.swap(entries);
+
+	const size_t mask = _entries.size() - 1;
+
+	for (std::vector<Entry>::const_iterator e = entries.begin(); e != entries.end(); ++e) {
+		if (e->generation != _generation)
+			continue;
+
+		size_t i = hashResource(e->resource) & mask;
+		while (_entries[i].generation == _generation)
+			i = (i + 1) & mask;
+
+		_entries[i] = *e;
+	}
 }
 
-RenderQueue::RenderQueue(uint32 precache) : _nodeArray(precache), _cameraReference(0.0f, 0.0f, 0.0f) {
-//	_nodeArray.reserve(1000);
+
+RenderQueue::RenderQueue(uint32 pass, uint32 precache) : _pass(pass), _cameraReference(0.0f, 0.0f, 0.0f) {
+	_nodeArray.reserve(precache);
 }
 
 RenderQueue::~RenderQueue()
@@ -90,29 +185,228 @@ void RenderQueue::queueItem(Shader::ShaderRenderable *renderable, const glm::mat
 }
 
 void RenderQueue::sortShader() {
-	if (_nodeArray.size() > 1) {
-		std::sort(_nodeArray.begin(), _nodeArray.end(), compareShader);
+	if (_nodeArray.size() <= 1)
+		return;
+
+	_programIDs.clear();
+	_materialIDs.clear();
+	_surfaceIDs.clear();
+	_meshIDs.clear();
+
+	_sortEntries.resize(_nodeArray.size());
+	for (size_t i = 0; i < _nodeArray.size(); i++) {
+		const RenderQueueNode &node = _nodeArray[i];
+
+		_sortEntries[i].index = i;
+		_sortEntries[i].key   =
+			getKeyField(_pass                         ,  3, kKeyPassShift) |
+			getKeyField(_programIDs.get(node.program)  , 10, 51) |
+			getKeyField(_materialIDs.get(node.material), 14, 37) |
+			getKeyField(_surfaceIDs.get(node.surface)  , 10, 27) |
+			getKeyField(_meshIDs.get(node.mesh)        , 13, 14) |
+			getKeyField(getDepthBits(node.reference) >> 17, 14, 0);
 	}
+
+	sortByKeys();
 }
 
 void RenderQueue::sortDepth() {
-	if (_nodeArray.size() > 1) {
-		std::sort(_nodeArray.begin(), _nodeArray.end(), compareDepth);
+	if (_nodeArray.size() <= 1)
+		return;
+
+	_programIDs.clear();
+	_materialIDs.clear();
+	_surfaceIDs.clear();
+
+	_sortEntries.resize(_nodeArray.size());
+	for (size_t i = 0; i < _nodeArray.size(); i++) {
+		const RenderQueueNode &node = _nodeArray[i];
+
+		_sortEntries[i].index = i;
+		_sortEntries[i].key   =
+			getKeyField(_pass                         ,  3, kKeyPassShift) |
+			((uint64) getDepthBits(node.reference) << 29) |
+			getKeyField(_programIDs.get(node.program)  , 10, 19) |
+			getKeyField(_materialIDs.get(node.material), 14,  5) |
+			getKeyField(_surfaceIDs.get(node.surface)  ,  5,  0);
 	}
+
+	sortByKeys();
+}
+
+void RenderQueue::sortByKeys() {
+	/* An LSD radix sort, one byte at a time. It's stable, so nodes with
+	 * equal keys stay in the order they were queued in. */
+
+	const size_t count = _sortEntries.size();
+	_sortBuffer.resize(count);
+
+	// Count the values of all bytes in one go
+	uint32 histograms[8][256];
+	std::memset(histograms, 0, sizeof(histograms));
+
+	for (size_t i = 0; i < count; i++) {
+		const uint64 key = _sortEntries[i].key;
+
+		for (int b = 0; b < 8; b++)
+			histograms[b][(key >> (b * 8)) & 0xFF]++;
+	}
+
+	SortEntry *src = &_sortEntries[0];
+	SortEntry *dst = &_sortBuffer[0];
+
+	for (int b = 0; b < 8; b++) {
+		const int shift = b * 8;
+
+		uint32 *histogram = histograms[b];
+
+		// All keys are the same in this byte, nothing to sort
+		if (histogram[(src[0].key >> shift) & 0xFF] == count)
+			continue;
+
+		uint32 offset = 0;
+		for (int i = 0; i < 256; i++) {
+			const uint32 n = histogram[i];
+
+			histogram[i] = offset;
+			offset += n;
+		}
+
+		for (size_t i = 0; i < count; i++)
+			dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+		std::swap(src, dst);
+	}
+
+	_sortedNodes.resize(count);
+	for (size_t i = 0; i < count; i++)
+		_sortedNodes[i] = _nodeArray[src[i].index];
+
+	_nodeArray.swap(_sortedNodes);
+}
+
+size_t RenderQueue::findBatchEnd(size_t start) const {
+	const RenderQueueNode &first = _nodeArray[start];
+
+	size_t end = start + 1;
+	while ((end < _nodeArray.size()) &&
+	       (_nodeArray[end].program  == first.program)  && (_nodeArray[end].mesh    == first.mesh) &&
+	       (_nodeArray[end].material == first.material) && (_nodeArray[end].surface == first.surface))
+		end++;
+
+	return end;
 }
 
-void RenderQueue::render() {
+bool RenderQueue::canInstance(size_t start, size_t end) const {
+	return ((end - start) >= kMinInstanceCount) && _nodeArray[start].program->instanced;
+}
+
+void RenderQueue::gatherInstances(std::vector<InstanceBatch> &batches, std::vector<InstanceData> &instances) const {
+	batches.clear();
+	instances.clear();
+
+	size_t i = 0;
+	while (i < _nodeArray.size()) {
+		const size_t end = findBatchEnd(i);
+
+		if (canInstance(i, end)) {
+			InstanceBatch batch;
+			batch.start  = i;
+			batch.count  = end - i;
+			batch.offset = instances.size();
+
+			batches.push_back(batch);
+
+			instances.resize(instances.size() + batch.count);
+			for (size_t j = 0; j < batch.count; j++) {
+				InstanceData &instance = instances[batch.offset + j];
+
+				std::memcpy(instance.transform, glm::value_ptr(*_nodeArray[i + j].transform), sizeof(instance.transform));
+				instance.alpha = _nodeArray[i + j].alpha;
+			}
+		}
+
+		i = end;
+	}
+}
+
+void RenderQueue::resetInstanceAttributes() {
+	glVertexAttrib4f(Shader::VERTEX_INSTANCE_TRANSFORM + 0, 1.0f, 0.0f, 0.0f, 0.0f);
+	glVertexAttrib4f(Shader::VERTEX_INSTANCE_TRANSFORM + 1, 0.0f, 1.0f, 0.0f, 0.0f);
+	glVertexAttrib4f(Shader::VERTEX_INSTANCE_TRANSFORM + 2, 0.0f, 0.0f, 1.0f, 0.0f);
+	glVertexAttrib4f(Shader::VERTEX_INSTANCE_TRANSFORM + 3, 0.0f, 0.0f, 0.0f, 1.0f);
+
+	glVertexAttrib1f(Shader::VERTEX_INSTANCE_ALPHA, 1.0f);
+}
+
+void RenderQueue::bindInstances(GLuint instanceBuffer, const InstanceBatch &batch) {
+	const size_t base = batch.offset * sizeof(InstanceData);
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+
+	// A mat4 input takes up four consecutive locations, one per column
+	for (GLuint i = 0; i < 4; i++) {
+		const GLuint index = Shader::VERTEX_INSTANCE_TRANSFORM + i;
+
+		glVertexAttribPointer(index, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+		                      (const GLvoid *) (base + offsetof(InstanceData, transform) + i * 4 * sizeof(float)));
+		glVertexAttribDivisor(index, 1);
+		glEnableVertexAttribArray(index);
+	}
+
+	glVertexAttribPointer(Shader::VERTEX_INSTANCE_ALPHA, 1, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+	                      (const GLvoid *) (base + offsetof(InstanceData, alpha)));
+	glVertexAttribDivisor(Shader::VERTEX_INSTANCE_ALPHA, 1);
+	glEnableVertexAttribArray(Shader::VERTEX_INSTANCE_ALPHA);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void RenderQueue::unbindInstances() {
+	// The arrays are part of the mesh's vertex array object, so leave that as we found it
+	for (GLuint i = 0; i < 4; i++) {
+		glDisableVertexAttribArray(Shader::VERTEX_INSTANCE_TRANSFORM + i);
+		glVertexAttribDivisor(Shader::VERTEX_INSTANCE_TRANSFORM + i, 0);
+	}
+
+	glDisableVertexAttribArray(Shader::VERTEX_INSTANCE_ALPHA);
+	glVertexAttribDivisor(Shader::VERTEX_INSTANCE_ALPHA, 0);
+
+	// Drawing from the arrays leaves the constant values undefined
+	resetInstanceAttributes();
+}
+
+void RenderQueue::render(GLuint instanceBuffer) {
+	_statistics = Statistics();
+
 	if (_nodeArray.size() == 0) {
 		return;
 	}
 
+	_instanceBatches.clear();
+	_instanceData.clear();
+
+	if (instanceBuffer != 0) {
+		gatherInstances(_instanceBatches, _instanceData);
+
+		// All instance data of this queue in one upload, orphaning the previous contents
+		if (!_instanceData.empty()) {
+			glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+			glBufferData(GL_ARRAY_BUFFER, _instanceData.size() * sizeof(InstanceData), &_instanceData[0], GL_STREAM_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+	}
+
+	size_t nextBatch = 0;
+	static const glm::mat4 kIdentity(1.0f);
+
 	Shader::ShaderProgram *currentProgram = 0;
 	Shader::ShaderMaterial *currentMaterial = 0;
 	Shader::ShaderSurface *currentSurface = 0;
 	Mesh::Mesh *currentMesh = 0;
 
-	uint32 i = 0;
-	uint32 limit = _nodeArray.size();
+	size_t i = 0;
+	const size_t limit = _nodeArray.size();
 	while (i < limit) {
 		assert(_nodeArray[i].program);
 		if (currentProgram != _nodeArray[i].program) {
@@ -127,6 +421,8 @@ void RenderQueue::render() {
 			}
 			currentMaterial = 0;
 			currentSurface = 0;
+
+			_statistics.programChanges++;
 		}
 
 		assert(_nodeArray[i].material);
@@ -137,6 +433,8 @@ void RenderQueue::render() {
 			currentMaterial = _nodeArray[i].material;
 			currentMaterial->bindProgramNoFade(currentProgram);
 			currentMaterial->bindGLState();
+
+			_statistics.materialChanges++;
 		}
 
 		assert(_nodeArray[i].surface);
@@ -148,32 +446,59 @@ void RenderQueue::render() {
 			}
 			currentSurface = _nodeArray[i].surface;
 			currentSurface->bindGLState();
+
+			_statistics.surfaceChanges++;
 		}
 
-		currentSurface = _nodeArray[i].surface;
 		currentMesh = _nodeArray[i].mesh;
 		currentMesh->renderBind();  // Binds VAO ready for rendering.
 
+		_statistics.meshChanges++;
+
 		// There's at least one mesh to be rendering here.
 		assert(_nodeArray[i].transform);
 		assert(currentSurface);
 		assert(currentMaterial);
 
-		currentSurface->bindProgram(currentProgram, _nodeArray[i].transform);
-		//currentSurface->bindObjectModelview(currentProgram, _nodeArray[i].transform);
-		bindBoneUniforms(currentProgram, currentSurface, currentMesh);
-		currentMaterial->bindFade(currentProgram, _nodeArray[i].alpha);
-		currentMesh->render();
-
-		++i;  // Move to next object.
-		while ((i < limit) && (_nodeArray[i].mesh == currentMesh) && (_nodeArray[i].material == currentMaterial) && (_nodeArray[i].surface == currentSurface)) {
-			// Next object is basically the same, but will have a different object modelview transform. So rebind that, and render again.
-			assert(_nodeArray[i].transform);
-			currentSurface->bindObjectModelview(currentProgram, _nodeArray[i].transform);
+		const size_t end = findBatchEnd(i);
+
+		if ((nextBatch < _instanceBatches.size()) && (_instanceBatches[nextBatch].start == i)) {
+			// The whole run in one go. The transforms and alphas come from the instance data instead.
+			const InstanceBatch &batch = _instanceBatches[nextBatch++];
+			assert(batch.count == (end - i));
+
+			currentSurface->bindProgram(currentProgram, &kIdentity);
+			bindBoneUniforms(currentProgram, currentSurface, currentMesh);
+			currentMaterial->bindFade(currentProgram, 1.0f);
+
+			bindInstances(instanceBuffer, batch);
+			currentMesh->renderInstanced(batch.count);
+			unbindInstances();
+
+			_statistics.drawCalls++;
+			_statistics.instancedBatches++;
+			_statistics.drawsSaved += batch.count - 1;
+
+			i = end;
+		} else {
+			currentSurface->bindProgram(currentProgram, _nodeArray[i].transform);
+			//currentSurface->bindObjectModelview(currentProgram, _nodeArray[i].transform);
 			bindBoneUniforms(currentProgram, currentSurface, currentMesh);
 			currentMaterial->bindFade(currentProgram, _nodeArray[i].alpha);
 			currentMesh->render();
-			++i;
+
+			_statistics.drawCalls += end - i;
+
+			++i;  // Move to next object.
+			while (i < end) {
+				// Next object is basically the same, but will have a different object modelview transform. So rebind that, and render again.
+				assert(_nodeArray[i].transform);
+				currentSurface->bindObjectModelview(currentProgram, _nodeArray[i].transform);
+				bindBoneUniforms(currentProgram, currentSurface, currentMesh);
+				currentMaterial->bindFade(currentProgram, _nodeArray[i].alpha);
+				currentMesh->render();
+				++i;
+			}
 		}
 		// Done rendering, unbind the mesh, and onwards into the queue.
 		currentMesh->renderUnbind();
@@ -189,10 +514,70 @@ void RenderQueue::render() {
 	glActiveTexture(GL_TEXTURE0);
 }
 
+RenderQueue::Statistics RenderQueue::countStateChanges(bool instancing) const {
+	// The same decisions render() makes, without actually rendering anything
+
+	Statistics statistics;
+
+	const Shader::ShaderProgram *currentProgram = 0;
+	const Shader::ShaderMaterial *currentMaterial = 0;
+	const Shader::ShaderSurface *currentSurface = 0;
+
+	size_t i = 0;
+	while (i < _nodeArray.size()) {
+		const RenderQueueNode &node = _nodeArray[i];
+
+		if (currentProgram != node.program) {
+			currentProgram  = node.program;
+			currentMaterial = 0;
+			currentSurface  = 0;
+
+			statistics.programChanges++;
+		}
+
+		if (currentMaterial != node.material) {
+			currentMaterial = node.material;
+			statistics.materialChanges++;
+		}
+
+		if (currentSurface != node.surface) {
+			currentSurface = node.surface;
+			statistics.surfaceChanges++;
+		}
+
+		statistics.meshChanges++;
+
+		const size_t end = findBatchEnd(i);
+
+		if (instancing && canInstance(i, end)) {
+			statistics.drawCalls++;
+			statistics.instancedBatches++;
+			statistics.drawsSaved += end - i - 1;
+		} else
+			statistics.drawCalls += end - i;
+
+		i = end;
+	}
+
+	return statistics;
+}
+
 void RenderQueue::clear() {
 	_nodeArray.clear();
 }
 
+size_t RenderQueue::getSize() const {
+	return _nodeArray.size();
+}
+
+const std::vector<RenderQueue::RenderQueueNode> &RenderQueue::getNodes() const {
+	return _nodeArray;
+}
+
+const RenderQueue::Statistics &RenderQueue::getStatistics() const {
+	return _statistics;
+}
+
 void RenderQueue::bindBoneUniforms(Shader::ShaderProgram *program, Shader::ShaderSurface *surface, Mesh::Mesh *mesh) {
 	surface->bindBindPose(program, mesh->getBindPosePtr());
 
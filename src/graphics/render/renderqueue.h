@@ -55,7 +55,49 @@ public:
 		inline const RenderQueueNode &operator=(const RenderQueueNode &src) { program = src.program; material = src.material; surface = src.surface; mesh = src.mesh; transform = src.transform; reference = src.reference; alpha = src.alpha; return *this; }
 	};
 
-	RenderQueue(uint32 precache = 1000);
+	/** Number of state changes and draw calls needed to render a queue. */
+	struct Statistics {
+		uint32 programChanges;
+		uint32 materialChanges;
+		uint32 surfaceChanges;
+		uint32 meshChanges;
+		uint32 drawCalls;
+
+		uint32 instancedBatches; ///< Number of runs of nodes drawn with one instanced draw call.
+		uint32 drawsSaved;       ///< Number of draw calls instancing saved.
+
+		Statistics() : programChanges(0), materialChanges(0), surfaceChanges(0), meshChanges(0), drawCalls(0),
+		               instancedBatches(0), drawsSaved(0) {}
+
+		/** Return the total number of state changes. */
+		uint32 getStateChanges() const { return programChanges + materialChanges + surfaceChanges + meshChanges; }
+
+		Statistics &operator+=(const Statistics &s);
+	};
+
+	/** The per-instance data of an instanced draw. */
+	struct InstanceData {
+		float transform[16]; ///< The object modelview transform.
+		float alpha;         ///< The alpha value applied to the object.
+	};
+
+	/** A run of nodes sharing all their state, drawn with one instanced draw call. */
+	struct InstanceBatch {
+		size_t start;  ///< Index of the first node of the run.
+		size_t count;  ///< Number of nodes in the run.
+		size_t offset; ///< Index of the first node's instance data.
+	};
+
+	/** The minimum number of nodes in a run to be worth drawing instanced. */
+	static const size_t kMinInstanceCount = 4;
+
+	/** Create a render queue.
+	 *
+	 *  @param pass The render pass this queue holds, used as the most
+	 *              significant part of the sort keys.
+	 *  @param precache Number of nodes to reserve space for.
+	 */
+	RenderQueue(uint32 pass = 0, uint32 precache = 1000);
 	~RenderQueue();
 
 	void setCameraReference(const glm::vec3 &reference);
@@ -66,15 +108,107 @@ public:
 	void sortShader(); ///< Sort queue elements by shader program.
 	void sortDepth();  ///< Sort queue elements by depth.
 
-	void render();  ///< Render all queued items.
+	/** Render all queued items.
+	 *
+	 *  @param instanceBuffer An OpenGL buffer object to hold the per-instance
+	 *                        data. If given, runs of nodes sharing all their
+	 *                        state are drawn instanced.
+	 */
+	void render(GLuint instanceBuffer = 0);
 
 	void clear();  ///< Clear the queue of all items.
 
+	size_t getSize() const; ///< Return the number of queued items.
+
+	/** Return the queued items, in their current order. */
+	const std::vector<RenderQueueNode> &getNodes() const;
+
+	/** Return the state changes and draw calls of the last render(). */
+	const Statistics &getStatistics() const;
+	/** Count the state changes and draw calls rendering the queue in its current order would need.
+	 *
+	 *  @param instancing Count as if runs of nodes sharing all their state were drawn instanced.
+	 */
+	Statistics countStateChanges(bool instancing = false) const;
+
+	/** Find the runs of nodes to draw instanced, and gather their per-instance data.
+	 *
+	 *  Only runs of at least kMinInstanceCount nodes, whose program takes
+	 *  the per-instance inputs, are drawn instanced.
+	 */
+	void gatherInstances(std::vector<InstanceBatch> &batches, std::vector<InstanceData> &instances) const;
+
+	/** Set the per-instance inputs to their values for drawing without instancing. */
+	static void resetInstanceAttributes();
+
 private:
+	/** Hands out small, dense IDs for the resources used in one sort. */
+	class ResourceIDs {
+	public:
+		ResourceIDs();
+
+		/** Forget all IDs given out so far. */
+		void clear();
+		/** Return the ID of this resource, giving out a new one if necessary. */
+		uint32 get(const void *resource);
+
+	private:
+		struct Entry {
+			const void *resource;
+			uint32 generation;
+			uint32 id;
+		};
+
+		std::vector<Entry> _entries; ///< Open addressing hash table, power of two sized.
+
+		uint32 _generation; ///< Entries from older generations are considered empty.
+		uint32 _count;      ///< Number of IDs given out in the current generation.
+
+		// Consecutive nodes often use the same resources
+		const void *_lastResource;
+		uint32 _lastID;
+
+		void grow();
+	};
+
+	/** A sort key, together with the index of its node. */
+	struct SortEntry {
+		uint64 key;
+		uint32 index;
+	};
+
+	uint32 _pass;
 
 	std::vector<RenderQueueNode>_nodeArray;
 	glm::vec3 _cameraReference;
 
+	ResourceIDs _programIDs;
+	ResourceIDs _materialIDs;
+	ResourceIDs _surfaceIDs;
+	ResourceIDs _meshIDs;
+
+	// Reused between frames, to avoid reallocating them every time
+	std::vector<SortEntry> _sortEntries;
+	std::vector<SortEntry> _sortBuffer;
+	std::vector<RenderQueueNode> _sortedNodes;
+	std::vector<InstanceBatch> _instanceBatches;
+	std::vector<InstanceData> _instanceData;
+
+	Statistics _statistics;
+
+	/** Sort the nodes by their keys, keeping the order of nodes with equal keys. */
+	void sortByKeys();
+
+	/** Return the index after the last node using the same state as the node at start. */
+	size_t findBatchEnd(size_t start) const;
+
+	/** Can the run of nodes from start to end be drawn instanced? */
+	bool canInstance(size_t start, size_t end) const;
+
+	/** Point the per-instance inputs at the instance data of a batch. */
+	void bindInstances(GLuint instanceBuffer, const InstanceBatch &batch);
+	void unbindInstances();
+
 	void bindBoneUniforms(Shader::ShaderProgram *program, Shader::ShaderSurface *surface, Mesh::Mesh *mesh);
 };
 
@@ -30,7 +30,9 @@
 
 namespace Graphics {
 
-Renderable::Renderable(RenderableType type) : _clickable(false), _distance(0.0f) {
+Renderable::Renderable(RenderableType type) : _clickable(false), _distance(0.0f),
+	_inWorld(false), _worldProxy(BVH::kInvalidProxy) {
+
 	switch (type) {
 		case kRenderableTypeVideo:
 			_queueExists  = kQueueVideo;
@@ -108,20 +110,40 @@ bool Renderable::isVisible() const {
 }
 
 void Renderable::resort() {
-	sortQueue(_queueVisible);
+	// World objects aren't kept sorted, they're culled and sorted every frame
+	if (_queueVisible == kQueueVisibleWorldObject)
+		updateBound();
+	else
+		sortQueue(_queueVisible);
+}
+
+void Renderable::updateBound() {
+	if (_queueVisible == kQueueVisibleWorldObject)
+		GfxMan.updateWorldObject(*this);
 }
 
 void Renderable::show() {
 	lockQueue(_queueVisible);
 
 	addToQueue(_queueVisible);
-	sortQueue(_queueVisible);
+
+	if (_queueVisible == kQueueVisibleWorldObject)
+		GfxMan.addWorldObject(*this);
+	else
+		sortQueue(_queueVisible);
 
 	unlockQueue(_queueVisible);
 }
 
 void Renderable::hide() {
+	lockQueue(_queueVisible);
+
+	if (_inWorld)
+		GfxMan.removeWorldObject(*this);
+
 	removeFromQueue(_queueVisible);
+
+	unlockQueue(_queueVisible);
 }
 
 bool Renderable::isIn(float UNUSED(x), float UNUSED(y)) const {
@@ -138,6 +160,10 @@ bool Renderable::isIn(float UNUSED(x1), float UNUSED(y1), float UNUSED(z1),
 	return false;
 }
 
+bool Renderable::getWorldBound(glm::vec3 &UNUSED(min), glm::vec3 &UNUSED(max)) const {
+	return false;
+}
+
 void Renderable::lockFrame() {
 	GfxMan.lockFrame();
 }
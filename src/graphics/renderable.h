@@ -27,6 +27,7 @@
 
 #include <boost/noncopyable.hpp>
 
+#include "external/glm/vec3.hpp"
 #include "external/glm/mat4x4.hpp"
 
 #include "src/common/ustring.h"
@@ -89,6 +90,14 @@ public:
 	/** Does the line from x1.y1.z1 to x2.y2.z2 intersect with the object? */
 	virtual bool isIn(float x1, float y1, float z1, float x2, float y2, float z2) const;
 
+	/** Get the axis-aligned box around the object in world coordinates.
+	 *
+	 *  World objects with a bounding box are culled against the view frustum.
+	 *  Returns false if the object has no bounding box, in which case it's
+	 *  always drawn.
+	 */
+	virtual bool getWorldBound(glm::vec3 &min, glm::vec3 &max) const;
+
 protected:
 	QueueType _queueExists;
 	QueueType _queueVisible;
@@ -102,11 +111,20 @@ protected:
 
 	void resort();
 
+	/** Notify the graphics manager that the object's world bounding box changed. */
+	void updateBound();
+
 	void lockFrame();
 	void unlockFrame();
 
 	void lockFrameIfVisible();
 	void unlockFrameIfVisible();
+
+private:
+	bool _inWorld;    ///< Is the object in the graphics manager's world object BVH?
+	int  _worldProxy; ///< The object's ID within the world object BVH.
+
+	friend class GraphicsManager;
 };
 
 } // End of namespace Graphics
@@ -34,7 +34,10 @@ src_graphics_libgraphics_la_SOURCES += \
     src/graphics/glcontainer.h \
     src/graphics/texture.h \
     src/graphics/font.h \
+    src/graphics/textlayout.h \
     src/graphics/camera.h \
+    src/graphics/frustum.h \
+    src/graphics/bvh.h \
     src/graphics/renderable.h \
     src/graphics/resolution.h \
     src/graphics/object.h \
@@ -56,7 +59,10 @@ src_graphics_libgraphics_la_SOURCES += \
     src/graphics/glcontainer.cpp \
     src/graphics/texture.cpp \
     src/graphics/font.cpp \
+    src/graphics/textlayout.cpp \
     src/graphics/camera.cpp \
+    src/graphics/frustum.cpp \
+    src/graphics/bvh.cpp \
     src/graphics/renderable.cpp \
     src/graphics/yuv_to_rgb.cpp \
     src/graphics/ttf.cpp \
@@ -35,6 +35,7 @@
 #include "src/graphics/shader/shaderbuilder.h"
 
 #include "src/graphics/aurora/texture.h"
+#include "src/graphics/aurora/textureman.h"
 
 /*--------------------------------------------------------------------*/
 
@@ -225,6 +226,15 @@ ShaderObject *ShaderManager::getShaderObject(const Common::UString &name, const
 	return shaderObject;
 }
 
+/** Return the ID of a sampler's texture, marking the texture as used for the texture memory budget. */
+static TextureID getSamplerTexture(const void *data) {
+	const ShaderSampler *sampler = static_cast<const ShaderSampler *>(data);
+
+	TextureMan.touch(sampler->handle);
+
+	return sampler->handle.getTexture().getID();
+}
+
 void ShaderManager::bindShaderVariable(ShaderObject::ShaderObjectVariable &var, GLint loc, const void *data) {
 	switch (var.type) {
 		case SHADER_FLOAT: glUniform1fv(loc, var.count, static_cast<const float *>(data)); break;
@@ -250,57 +260,57 @@ void ShaderManager::bindShaderVariable(ShaderObject::ShaderObjectVariable &var,
 		case SHADER_SAMPLER1D:
 			glUniform1i(loc, static_cast<const ShaderSampler *>(data)->unit);
 			glActiveTexture(GL_TEXTURE0 + static_cast<const ShaderSampler *>(data)->unit);
-			glBindTexture(GL_TEXTURE_1D, static_cast<const ShaderSampler *>(data)->handle.getTexture().getID());
+			glBindTexture(GL_TEXTURE_1D, getSamplerTexture(data));
 			break;
 		case SHADER_SAMPLER2D:
 			glUniform1i(loc, static_cast<const ShaderSampler *>(data)->unit);
 			glActiveTexture(GL_TEXTURE0 + static_cast<const ShaderSampler *>(data)->unit);
-			glBindTexture(GL_TEXTURE_2D, static_cast<const ShaderSampler *>(data)->handle.getTexture().getID());
+			glBindTexture(GL_TEXTURE_2D, getSamplerTexture(data));
 			break;
 		case SHADER_SAMPLER3D:
 			glUniform1i(loc, static_cast<const ShaderSampler *>(data)->unit);
 			glActiveTexture(GL_TEXTURE0 + static_cast<const ShaderSampler *>(data)->unit);
-			glBindTexture(GL_TEXTURE_3D, static_cast<const ShaderSampler *>(data)->handle.getTexture().getID());
+			glBindTexture(GL_TEXTURE_3D, getSamplerTexture(data));
 			break;
 		case SHADER_SAMPLERCUBE:
 			glUniform1i(loc, static_cast<const ShaderSampler *>(data)->unit);
 			glActiveTexture(GL_TEXTURE0 + static_cast<const ShaderSampler *>(data)->unit);
-			glBindTexture(GL_TEXTURE_CUBE_MAP, static_cast<const ShaderSampler *>(data)->handle.getTexture().getID());
+			glBindTexture(GL_TEXTURE_CUBE_MAP, getSamplerTexture(data));
 			break;
 		case SHADER_SAMPLER1DSHADOW:
 			glUniform1i(loc, static_cast<const ShaderSampler *>(data)->unit);
 			glActiveTexture(GL_TEXTURE0 + static_cast<const ShaderSampler *>(data)->unit);
-			glBindTexture(GL_TEXTURE_1D_ARRAY, static_cast<const ShaderSampler *>(data)->handle.getTexture().getID());
+			glBindTexture(GL_TEXTURE_1D_ARRAY, getSamplerTexture(data));
 			break;
 		case SHADER_SAMPLER2DSHADOW:
 			glUniform1i(loc, static_cast<const ShaderSampler *>(data)->unit);
 			glActiveTexture(GL_TEXTURE0 + static_cast<const ShaderSampler *>(data)->unit);
-			glBindTexture(GL_TEXTURE_2D, static_cast<const ShaderSampler *>(data)->handle.getTexture().getID());
+			glBindTexture(GL_TEXTURE_2D, getSamplerTexture(data));
 			break;
 		case SHADER_SAMPLER1DARRAY:
 			glUniform1i(loc, static_cast<const ShaderSampler *>(data)->unit);
 			glActiveTexture(GL_TEXTURE0 + static_cast<const ShaderSampler *>(data)->unit);
-			glBindTexture(GL_TEXTURE_1D_ARRAY, static_cast<const ShaderSampler *>(data)->handle.getTexture().getID());
+			glBindTexture(GL_TEXTURE_1D_ARRAY, getSamplerTexture(data));
 			break;
 		case SHADER_SAMPLER2DARRAY:
 			glUniform1i(loc, static_cast<const ShaderSampler *>(data)->unit);
 			glActiveTexture(GL_TEXTURE0 + static_cast<const ShaderSampler *>(data)->unit);
-			glBindTexture(GL_TEXTURE_2D_ARRAY, static_cast<const ShaderSampler *>(data)->handle.getTexture().getID());
+			glBindTexture(GL_TEXTURE_2D_ARRAY, getSamplerTexture(data));
 			break;
 		case SHADER_SAMPLER1DARRAYSHADOW:
 			glUniform1i(loc, static_cast<const ShaderSampler *>(data)->unit);
 			glActiveTexture(GL_TEXTURE0 + static_cast<const ShaderSampler *>(data)->unit);
-			glBindTexture(GL_TEXTURE_1D_ARRAY, static_cast<const ShaderSampler *>(data)->handle.getTexture().getID());
+			glBindTexture(GL_TEXTURE_1D_ARRAY, getSamplerTexture(data));
 			break;
 		case SHADER_SAMPLER2DARRAYSHADOW:
 			glUniform1i(loc, static_cast<const ShaderSampler *>(data)->unit);
 			glActiveTexture(GL_TEXTURE0 + static_cast<const ShaderSampler *>(data)->unit);
-			glBindTexture(GL_TEXTURE_2D_ARRAY, static_cast<const ShaderSampler *>(data)->handle.getTexture().getID());
+			glBindTexture(GL_TEXTURE_2D_ARRAY, getSamplerTexture(data));
 			break;
 		case SHADER_SAMPLERBUFFER:
 			glUniform1i(loc, static_cast<const ShaderSampler *>(data)->unit);
 			glActiveTexture(GL_TEXTURE0 + static_cast<const ShaderSampler *>(data)->unit);
-			glBindTexture(GL_TEXTURE_BUFFER, static_cast<const ShaderSampler *>(data)->handle.getTexture().getID());
+			glBindTexture(GL_TEXTURE_BUFFER, getSamplerTexture(data));
 			break;
 		case SHADER_ISAMPLER1D: break;
 		case SHADER_ISAMPLER2D: break;
@@ -586,6 +596,9 @@ void ShaderManager::genGLProgram(ShaderProgram *program) {
 		glBindAttribLocation(glid, (GLuint)(VERTEX_NORMAL), "inputNormal0");
 		glBindAttribLocation(glid, (GLuint)(VERTEX_TEXCOORD1), "inputUV1");
 		glBindAttribLocation(glid, (GLuint)(VERTEX_COLOR), "inputColour");
+
+		glBindAttribLocation(glid, (GLuint)(VERTEX_INSTANCE_TRANSFORM), "inputInstanceTransform");
+		glBindAttribLocation(glid, (GLuint)(VERTEX_INSTANCE_ALPHA), "inputInstanceAlpha");
 	}
 
 	glBindAttribLocation(glid, (GLuint)(VERTEX_BONEINDICES), "inputBoneIndices");
@@ -608,6 +621,11 @@ void ShaderManager::genGLProgram(ShaderProgram *program) {
 
 	program->glid = glid;
 
+	// Only programs taking the per-instance inputs can be drawn instanced
+	if (GfxMan.isGL3())
+		program->instanced = (glGetAttribLocation(glid, "inputInstanceTransform") == VERTEX_INSTANCE_TRANSFORM) &&
+		                     (glGetAttribLocation(glid, "inputInstanceAlpha")     == VERTEX_INSTANCE_ALPHA);
+
 	for (uint32 i = 0; i < vertexObject->variablesCombined.size(); ++i) {
 		GLint location;
 		if (vertexObject->variablesCombined[i].type != SHADER_UNIFORM_BUFFER)
@@ -150,7 +150,10 @@ enum ShaderVertexAttrib {
 	VERTEX_BONEINDICES = 3,
 	VERTEX_BONEWEIGHTS = 4,
 	VERTEX_TEXCOORD0   = 5,
-	VERTEX_TEXCOORD1   = 6
+	VERTEX_TEXCOORD1   = 6,
+
+	VERTEX_INSTANCE_TRANSFORM = 7,  ///< Per-instance transform, a mat4 taking up 4 locations.
+	VERTEX_INSTANCE_ALPHA     = 11  ///< Per-instance alpha.
 };
 
 enum ShaderUBOIndex {
@@ -224,6 +227,7 @@ public:
 	uint64 id { 0 };  // Set to (vertex.id << 32) | fragment.id
 	GLuint glid { 0 };
 	uint32 usageCount { 0 };
+	bool instanced { false };  // Does the program take a per-instance transform and alpha?
 
 	void bindAttribute(ShaderVertexAttrib attrib, const Common::UString &name) {
 		glBindAttribLocation(glid, (GLuint)(attrib), name.c_str());
@@ -86,18 +86,25 @@ void ShaderDescriptor::build(bool isGL3, Common::UString &v_string, Common::UStr
 	 * final colour output.
 	 */
 	if (isGL3) {
+		/* The per-instance transform and alpha are vertex attributes. When not
+		 * drawing instanced, they stay at their constant identity and 1.0. */
 		v_header = "#version 150\n\n"
 		           "uniform mat4 _objectModelviewMatrix;\n"
 		           "uniform mat4 _projectionMatrix;\n"
-		           "uniform mat4 _modelviewMatrix;\n";
+		           "uniform mat4 _modelviewMatrix;\n"
+		           "in mat4 inputInstanceTransform;\n"
+		           "in float inputInstanceAlpha;\n"
+		           "out float instanceAlpha;\n";
 
 		v_body =   "void main(void) {\n"
-		           "	mat4 mo = (_modelviewMatrix * _objectModelviewMatrix);\n";
+		           "	mat4 mo = (_modelviewMatrix * _objectModelviewMatrix * inputInstanceTransform);\n"
+		           "	instanceAlpha = inputInstanceAlpha;\n";
 
 
 		f_header = "#version 150\n\n"
 		           "precision highp float;\n\n"
-		           "uniform float _alpha;\n";
+		           "uniform float _alpha;\n"
+		           "in float instanceAlpha;\n";
 
 		f_body =   "out vec4 outColor;\n"
 		           "void main(void) {\n"
@@ -631,7 +638,7 @@ void ShaderDescriptor::build(bool isGL3, Common::UString &v_string, Common::UStr
 	if (isGL3) {
 		v_body += "}\n";
 
-		f_body += "fraggle.a = fraggle.a * _alpha;\n"
+		f_body += "fraggle.a = fraggle.a * _alpha * instanceAlpha;\n"
 		          "outColor = fraggle;\n"
 		          "}\n";
 	} else {
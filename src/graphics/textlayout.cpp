@@ -0,0 +1,170 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The laid out quads of a text, ready to be drawn.
+ */
+
+#include <cassert>
+
+#include <algorithm>
+
+#include "src/common/util.h"
+#include "src/common/maths.h"
+#include "src/common/ustring.h"
+
+#include "src/graphics/font.h"
+#include "src/graphics/textlayout.h"
+
+namespace Graphics {
+
+size_t TextLayout::Page::getQuadCount() const {
+	return defaultColor.size();
+}
+
+
+TextLayout::TextLayout() : _lineCount(0) {
+	for (int i = 0; i < 4; i++)
+		_defaultColor[i] = 1.0f;
+}
+
+TextLayout::~TextLayout() {
+}
+
+void TextLayout::clear() {
+	_pages.clear();
+
+	_lineCount = 0;
+}
+
+void TextLayout::build(const Font &font, const Common::UString &text, const ColorPositions &colors,
+                       float width, float height, float halign, float valign) {
+
+	clear();
+
+	const float lineHeight = font.getHeight() + font.getLineSpacing();
+
+	std::vector<Common::UString> lines;
+	font.split(text, lines, width, height, false);
+
+	_lineCount = lines.size();
+
+	const float blockSize = lines.size() * lineHeight;
+
+	// Start at the top
+	float y = roundf(((height - blockSize) * valign) + blockSize - lineHeight);
+
+	ColorPositions::const_iterator color = colors.begin();
+	const float *rgba = 0;
+
+	size_t position = 0;
+	for (std::vector<Common::UString>::const_iterator l = lines.begin(); l != lines.end(); ++l) {
+		float x = roundf((width - font.getLineWidth(*l)) * halign);
+
+		for (Common::UString::iterator s = l->begin(); s != l->end(); ++s, position++) {
+			// If we have color changes, apply them
+			while ((color != colors.end()) && (color->position <= position)) {
+				rgba = color->defaultColor ? 0 : &color->r;
+
+				++color;
+			}
+
+			addQuad(font, *s, x, y, rgba);
+
+			x += font.getWidth(*s);
+		}
+
+		y -= lineHeight;
+
+		// \n character
+		position++;
+	}
+}
+
+void TextLayout::addQuad(const Font &font, uint32 c, float x, float y, const float *color) {
+	Font::CharQuad quad;
+	if (!font.getCharQuad(c, quad))
+		return;
+
+	if (quad.page >= _pages.size())
+		_pages.resize(quad.page + 1);
+
+	Page &page = _pages[quad.page];
+
+	const float *rgba = color ? color : _defaultColor;
+
+	for (int i = 0; i < 4; i++) {
+		page.vertices.push_back(x + quad.vX[i]);
+		page.vertices.push_back(y + quad.vY[i]);
+		page.vertices.push_back(0.0f);
+
+		page.texCoords.push_back(quad.tX[i]);
+		page.texCoords.push_back(quad.tY[i]);
+
+		page.colors.insert(page.colors.end(), rgba, rgba + 4);
+	}
+
+	page.defaultColor.push_back(color == 0);
+}
+
+void TextLayout::setDefaultColor(float r, float g, float b, float a) {
+	if ((_defaultColor[0] == r) && (_defaultColor[1] == g) && (_defaultColor[2] == b) && (_defaultColor[3] == a))
+		return;
+
+	_defaultColor[0] = r;
+	_defaultColor[1] = g;
+	_defaultColor[2] = b;
+	_defaultColor[3] = a;
+
+	for (std::vector<Page>::iterator p = _pages.begin(); p != _pages.end(); ++p) {
+		for (size_t i = 0; i < p->getQuadCount(); i++) {
+			if (!p->defaultColor[i])
+				continue;
+
+			float *colors = &p->colors[i * 16];
+			for (int j = 0; j < 4; j++)
+				std::copy(_defaultColor, _defaultColor + 4, colors + j * 4);
+		}
+	}
+}
+
+size_t TextLayout::getLineCount() const {
+	return _lineCount;
+}
+
+size_t TextLayout::getQuadCount() const {
+	size_t count = 0;
+	for (std::vector<Page>::const_iterator p = _pages.begin(); p != _pages.end(); ++p)
+		count += p->getQuadCount();
+
+	return count;
+}
+
+size_t TextLayout::getPageCount() const {
+	return _pages.size();
+}
+
+const TextLayout::Page &TextLayout::getPage(size_t page) const {
+	assert(page < _pages.size());
+
+	return _pages[page];
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,110 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The laid out quads of a text, ready to be drawn.
+ */
+
+#ifndef GRAPHICS_TEXTLAYOUT_H
+#define GRAPHICS_TEXTLAYOUT_H
+
+#include <vector>
+
+#include "src/common/types.h"
+
+#include "src/graphics/types.h"
+
+namespace Common {
+	class UString;
+}
+
+namespace Graphics {
+
+class Font;
+
+/** The laid out quads of a text, ready to be drawn.
+ *
+ *  Laying out a text means wrapping it into lines, aligning these lines
+ *  and looking up the quad of every character. Doing that only when the
+ *  text changes, instead of every frame, leaves nothing but the drawing.
+ *
+ *  The quads are packed into arrays per texture page of the font, so
+ *  that all characters on one page can be drawn with a single call.
+ */
+class TextLayout {
+public:
+	/** The quads of all characters on one texture page. */
+	struct Page {
+		std::vector<float> vertices;  ///< { x, y, z } of 4 vertices per quad.
+		std::vector<float> texCoords; ///< { u, v } of 4 vertices per quad.
+		std::vector<float> colors;    ///< { r, g, b, a } of 4 vertices per quad.
+
+		/** Is the quad drawn in the default color, instead of a color token's? */
+		std::vector<bool> defaultColor;
+
+		size_t getQuadCount() const;
+	};
+
+	TextLayout();
+	~TextLayout();
+
+	void clear();
+
+	/** Lay out a text.
+	 *
+	 *  The quads are positioned relative to the lower left corner of the
+	 *  text's box, the same way Text used to draw them character by character.
+	 *
+	 *  @param font   The font to lay out the text in.
+	 *  @param text   The text, with all color tokens already removed.
+	 *  @param colors The color changes found in the text.
+	 *  @param width  The width of the text's box, for wrapping and aligning.
+	 *  @param height The height of the text's box, for wrapping and aligning.
+	 *  @param halign The horizontal alignment, see kHAlignLeft and friends.
+	 *  @param valign The vertical alignment, see kVAlignTop and friends.
+	 */
+	void build(const Font &font, const Common::UString &text, const ColorPositions &colors,
+	           float width, float height, float halign, float valign);
+
+	/** Set the color of all quads not colored by color tokens. */
+	void setDefaultColor(float r, float g, float b, float a);
+
+	/** Return the number of lines in the laid out text. */
+	size_t getLineCount() const;
+	/** Return the number of quads on all pages together. */
+	size_t getQuadCount() const;
+
+	/** Return the number of texture pages with quads on them, or before them. */
+	size_t getPageCount() const;
+	const Page &getPage(size_t page) const;
+
+private:
+	std::vector<Page> _pages;
+
+	size_t _lineCount;
+
+	float _defaultColor[4];
+
+	void addQuad(const Font &font, uint32 c, float x, float y, const float *color);
+};
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_TEXTLAYOUT_H
@@ -80,6 +80,9 @@ public:
 	/** Change buffer size. Will allocate memory, free previous. */
 	void setSize(uint32 vertCount, uint32 vertSize);
 
+	/** Return the size of one component of this type, in bytes. */
+	static uint32 getTypeSize(GLenum type);
+
 	/** Set vertex declaration for this buffer. */
 	void setVertexDecl(const VertexDecl &decl);
 
@@ -144,8 +147,6 @@ private:
 
 	GLuint _vbo;      ///< Vertex Buffer Object.
 	GLuint _hint;     ///< GL hint for static or dynamic data.
-
-	static uint32 getTypeSize(GLenum type);
 };
 
 } // End of namespace Graphics
@@ -86,9 +86,15 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define YUVTORGB_SSE2 1
+	#include <emmintrin.h>
+#endif
+
 #include "src/common/error.h"
 #include "src/common/singleton.h"
 #include "src/common/util.h"
+#include "src/common/threads.h"
 
 #include "src/graphics/yuv_to_rgb.h"
 
@@ -158,7 +164,9 @@ YUVToRGBLookup::YUVToRGBLookup(YUVToRGBManager::LuminanceScale scale) {
 	}
 }
 
-YUVToRGBManager::YUVToRGBManager() {
+YUVToRGBManager::YUVToRGBManager() :
+	_threadCount(CLIP<int>(Common::getParallelThreadCount(), 1, kMaxThreads)) {
+
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
 	int16 *Cb_g_tab = &_colorTab[2 * 256];
@@ -196,79 +204,191 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(LuminanceScale scale) {
 	*((d) + 2) = L[cr_r]; \
 	*((d) + 3) = (a)
 
-void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup(scale);
-	const byte *rgbToPix = lookup->getRGBToPix();
+#ifdef YUVTORGB_SSE2
+
+/* The SSE2 path calculates the same values the lookup tables contain.
+ *
+ * The color tables hold the chroma differences, truncated towards 0.
+ * We calculate them with 16-bit fixed point multiplications on the
+ * absolute values, which gives exactly the same results for all chroma
+ * values. Likewise, the ITU scaling x * 255 / 219 is calculated as
+ * x + x * 36 / 219, again exact for all x in [0, 219]. */
+
+static const uint16 kCrR = 45919; ///< (0.419 / 0.299) << 15
+static const uint16 kCrG = 46766; ///< (0.299 / 0.419) << 16
+static const uint16 kCbG = 22570; ///< (0.114 / 0.331) << 16
+static const uint16 kCbB = 58110; ///< (0.587 / 0.331) << 15
+static const uint16 kITU = 10774; ///< (36 / 219) << 16
+
+/** Multiply the absolute chroma values with a fixed point coefficient, and restore the sign. */
+static inline __m128i chromaMul(__m128i absC, __m128i sign, int shift, uint16 coeff) {
+	const __m128i d = _mm_mulhi_epu16(_mm_slli_epi16(absC, shift), _mm_set1_epi16((int16) coeff));
+
+	return _mm_sub_epi16(_mm_xor_si128(d, sign), sign);
+}
 
-	int halfHeight = yHeight >> 1;
-	int halfWidth = yWidth >> 1;
+/** Clamp and scale 16 color values to bytes, like the rgbToPix lookup table does. */
+static inline __m128i scaleColor(__m128i lo, __m128i hi, bool itu) {
+	if (itu) {
+		const __m128i min   = _mm_set1_epi16(16);
+		const __m128i max   = _mm_set1_epi16(235);
+		const __m128i scale = _mm_set1_epi16((int16) kITU);
 
-	dst += dstPitch * (yHeight - 2);
+		lo = _mm_sub_epi16(_mm_min_epi16(_mm_max_epi16(lo, min), max), min);
+		hi = _mm_sub_epi16(_mm_min_epi16(_mm_max_epi16(hi, min), max), min);
 
-	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
-			const byte *L;
+		lo = _mm_add_epi16(lo, _mm_mulhi_epu16(lo, scale));
+		hi = _mm_add_epi16(hi, _mm_mulhi_epu16(hi, scale));
+	}
 
-			int16 cr_r  = _colorTab[*vSrc + 0 * 256];
-			int16 crb_g = _colorTab[*vSrc + 1 * 256] + _colorTab[*uSrc + 2 * 256];
-			int16 cb_b  = _colorTab[*uSrc + 3 * 256];
-			uSrc++;
-			vSrc++;
-
-			PUT_PIXEL(*ySrc, *aSrc, dst + dstPitch);
-			PUT_PIXEL(*(ySrc + yPitch), *(aSrc + yPitch), dst);
-			ySrc++;
-			aSrc++;
-			dst += 4;
-			PUT_PIXEL(*ySrc, *aSrc, dst + dstPitch);
-			PUT_PIXEL(*(ySrc + yPitch), *(aSrc + yPitch), dst);
-			ySrc++;
-			aSrc++;
-			dst += 4;
-		}
+	return _mm_packus_epi16(lo, hi);
+}
+
+/** Convert 16 pixels of one row, with the chroma differences of 8 chroma samples. */
+static inline void convertPixels(byte *dst, const byte *y, const byte *a,
+                                 __m128i dR, __m128i dG, __m128i dB, bool itu) {
 
-		dst -= yWidth * 4 + dstPitch * 2;
-		ySrc += (yPitch << 1) - yWidth;
-		aSrc += (yPitch << 1) - yWidth;
-		uSrc += uvPitch - halfWidth;
-		vSrc += uvPitch - halfWidth;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i luma = _mm_loadu_si128(reinterpret_cast<const __m128i *>(y));
+
+	const __m128i yLo = _mm_unpacklo_epi8(luma, zero);
+	const __m128i yHi = _mm_unpackhi_epi8(luma, zero);
+
+	// Each chroma sample covers two pixels
+	const __m128i r = scaleColor(_mm_add_epi16(yLo, _mm_unpacklo_epi16(dR, dR)),
+	                             _mm_add_epi16(yHi, _mm_unpackhi_epi16(dR, dR)), itu);
+	const __m128i g = scaleColor(_mm_add_epi16(yLo, _mm_unpacklo_epi16(dG, dG)),
+	                             _mm_add_epi16(yHi, _mm_unpackhi_epi16(dG, dG)), itu);
+	const __m128i b = scaleColor(_mm_add_epi16(yLo, _mm_unpacklo_epi16(dB, dB)),
+	                             _mm_add_epi16(yHi, _mm_unpackhi_epi16(dB, dB)), itu);
+
+	const __m128i alpha = a ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(a)) : _mm_set1_epi8((char) 0xFF);
+
+	const __m128i bgLo = _mm_unpacklo_epi8(b, g), bgHi = _mm_unpackhi_epi8(b, g);
+	const __m128i raLo = _mm_unpacklo_epi8(r, alpha), raHi = _mm_unpackhi_epi8(r, alpha);
+
+	__m128i *d = reinterpret_cast<__m128i *>(dst);
+
+	_mm_storeu_si128(d + 0, _mm_unpacklo_epi16(bgLo, raLo));
+	_mm_storeu_si128(d + 1, _mm_unpackhi_epi16(bgLo, raLo));
+	_mm_storeu_si128(d + 2, _mm_unpacklo_epi16(bgHi, raHi));
+	_mm_storeu_si128(d + 3, _mm_unpackhi_epi16(bgHi, raHi));
+}
+
+/** Convert the first width & ~15 pixels of two rows sharing the same chroma samples.
+ *
+ *  Returns the number of pixels converted.
+ */
+static int convertRowsSSE2(byte *dst0, byte *dst1, const byte *y0, const byte *y1,
+                           const byte *a0, const byte *a1, const byte *u, const byte *v,
+                           int width, bool itu) {
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i bias = _mm_set1_epi16(128);
+
+	int x = 0;
+	for (; (x + 16) <= width; x += 16, u += 8, v += 8) {
+		const __m128i cb = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(u)), zero), bias);
+		const __m128i cr = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(v)), zero), bias);
+
+		const __m128i signB = _mm_cmpgt_epi16(zero, cb);
+		const __m128i signR = _mm_cmpgt_epi16(zero, cr);
+		const __m128i absB  = _mm_max_epi16(cb, _mm_sub_epi16(zero, cb));
+		const __m128i absR  = _mm_max_epi16(cr, _mm_sub_epi16(zero, cr));
+
+		const __m128i dR = chromaMul(absR, signR, 1, kCrR);
+		const __m128i dB = chromaMul(absB, signB, 1, kCbB);
+		const __m128i dG = _mm_sub_epi16(zero, _mm_add_epi16(chromaMul(absR, signR, 0, kCrG),
+		                                                     chromaMul(absB, signB, 0, kCbG)));
+
+		convertPixels(dst0 + x * 4, y0 + x, a0 ? (a0 + x) : 0, dR, dG, dB, itu);
+		convertPixels(dst1 + x * 4, y1 + x, a1 ? (a1 + x) : 0, dR, dG, dB, itu);
 	}
+
+	return x;
 }
 
-void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup(scale);
+#endif // YUVTORGB_SSE2
+
+void YUVToRGBManager::convertBand(const YUVToRGBLookup *lookup, byte *dst, int dstPitch,
+                                  const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                                  int yWidth, int yHeight, int yPitch, int uvPitch, int start, int end) const {
+
 	const byte *rgbToPix = lookup->getRGBToPix();
 
-	int halfHeight = yHeight >> 1;
-	int halfWidth = yWidth >> 1;
+	// Only whole pairs of pixels are converted
+	const int width = yWidth & ~1;
+
+	// The image is flipped vertically, source row n goes into destination row yHeight - 1 - n
+	for (int h = start; h < end; h++) {
+		byte *dst0 = dst + dstPitch * (yHeight - 1 - 2 * h);
+		byte *dst1 = dst0 - dstPitch;
 
-	dst += dstPitch * (yHeight - 2);
+		const byte *y0 = ySrc + yPitch * 2 * h;
+		const byte *y1 = y0 + yPitch;
+		const byte *a0 = aSrc ? (aSrc + yPitch * 2 * h) : 0;
+		const byte *a1 = aSrc ? (a0 + yPitch) : 0;
+		const byte *u  = uSrc + uvPitch * h;
+		const byte *v  = vSrc + uvPitch * h;
 
-	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
+		int w = 0;
+
+#ifdef YUVTORGB_SSE2
+		w = convertRowsSSE2(dst0, dst1, y0, y1, a0, a1, u, v, width, lookup->getScale() == kScaleITU);
+#endif
+
+		for (; w < width; w += 2) {
 			const byte *L;
 
-			int16 cr_r  = _colorTab[*vSrc + 0 * 256];
-			int16 crb_g = _colorTab[*vSrc + 1 * 256] + _colorTab[*uSrc + 2 * 256];
-			int16 cb_b  = _colorTab[*uSrc + 3 * 256];
-			uSrc++;
-			vSrc++;
-
-			PUT_PIXEL(*ySrc, 0xFF, dst + dstPitch);
-			PUT_PIXEL(*(ySrc + yPitch), 0xFF, dst);
-			ySrc++;
-			dst += 4;
-			PUT_PIXEL(*ySrc, 0xFF, dst + dstPitch);
-			PUT_PIXEL(*(ySrc + yPitch), 0xFF, dst);
-			ySrc++;
-			dst += 4;
+			int16 cr_r  = _colorTab[v[w >> 1] + 0 * 256];
+			int16 crb_g = _colorTab[v[w >> 1] + 1 * 256] + _colorTab[u[w >> 1] + 2 * 256];
+			int16 cb_b  = _colorTab[u[w >> 1] + 3 * 256];
+
+			PUT_PIXEL(y0[w    ], a0 ? a0[w    ] : 0xFF, dst0 + w * 4    );
+			PUT_PIXEL(y1[w    ], a1 ? a1[w    ] : 0xFF, dst1 + w * 4    );
+			PUT_PIXEL(y0[w + 1], a0 ? a0[w + 1] : 0xFF, dst0 + w * 4 + 4);
+			PUT_PIXEL(y1[w + 1], a1 ? a1[w + 1] : 0xFF, dst1 + w * 4 + 4);
 		}
+	}
+}
+
+void YUVToRGBManager::convert(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const YUVToRGBLookup *lookup = getLookup(scale);
+
+	const int halfHeight = yHeight >> 1;
+
+	// Only split off bands that are worth handing to another thread
+	static const int kMinBandPixels = 128 * 1024;
+
+	const int bands = CLIP<int>(MIN(_threadCount, (yWidth * yHeight) / kMinBandPixels), 1, kMaxThreads);
 
-		dst -= yWidth * 4 + dstPitch * 2;
-		ySrc += (yPitch << 1) - yWidth;
-		uSrc += uvPitch - halfWidth;
-		vSrc += uvPitch - halfWidth;
+	if (bands <= 1) {
+		convertBand(lookup, dst, dstPitch, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch, 0, halfHeight);
+		return;
 	}
+
+	Common::runParallel(bands, [&](size_t i) {
+		const int band = static_cast<int>(i);
+
+		convertBand(lookup, dst, dstPitch, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch,
+		            (halfHeight * band) / bands, (halfHeight * (band + 1)) / bands);
+	});
+}
+
+void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	convert(scale, dst, dstPitch, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
+void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	convert(scale, dst, dstPitch, ySrc, uSrc, vSrc, 0, yWidth, yHeight, yPitch, uvPitch);
+}
+
+void YUVToRGBManager::setThreadCount(int threads) {
+	_threadCount = CLIP(threads, 1, (int) kMaxThreads);
+}
+
+int YUVToRGBManager::getThreadCount() const {
+	return _threadCount;
 }
 
 } // End of namespace Graphics
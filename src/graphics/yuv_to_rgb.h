@@ -75,15 +75,37 @@ public:
 	 */
 	void convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Set the number of threads used for converting an image.
+	 *
+	 * Large enough images are split into horizontal bands, which are
+	 * converted in parallel. By default, one thread per CPU core is used.
+	 */
+	void setThreadCount(int threads);
+	/** Return the number of threads used for converting an image. */
+	int getThreadCount() const;
+
 private:
+	/** The maximum number of threads used for converting an image. */
+	static const int kMaxThreads = 16;
+
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
 	~YUVToRGBManager();
 
 	const YUVToRGBLookup *getLookup(LuminanceScale scale);
 
+	/** Convert a YUV420 image, with an optional alpha plane, splitting it into bands. */
+	void convert(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+	/** Convert the pairs of rows [start, end) of a YUV420 image. */
+	void convertBand(const YUVToRGBLookup *lookup, byte *dst, int dstPitch,
+	                 const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+	                 int yWidth, int yHeight, int yPitch, int uvPitch, int start, int end) const;
+
 	Common::ScopedPtr<YUVToRGBLookup> _lookup;
 	int16 _colorTab[4 * 256]; // 2048 bytes
+
+	int _threadCount;
 };
 
 } // End of namespace Graphics
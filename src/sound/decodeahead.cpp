@@ -0,0 +1,335 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Decoding audio streams ahead of playback, in worker threads.
+ */
+
+#include <cstring>
+
+#include <algorithm>
+#include <chrono>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+
+#include "src/sound/decodeahead.h"
+
+namespace Sound {
+
+SampleRingBuffer::SampleRingBuffer(size_t capacity) : _capacity(capacity), _readPos(0), _writePos(0) {
+	if (_capacity == 0)
+		throw Common::Exception("SampleRingBuffer: Invalid capacity");
+
+	_buffer.reset(new int16[_capacity]);
+}
+
+SampleRingBuffer::~SampleRingBuffer() {
+}
+
+size_t SampleRingBuffer::getCapacity() const {
+	return _capacity;
+}
+
+size_t SampleRingBuffer::getFill() const {
+	return _writePos.load(std::memory_order_acquire) - _readPos.load(std::memory_order_acquire);
+}
+
+size_t SampleRingBuffer::getFree() const {
+	return _capacity - getFill();
+}
+
+size_t SampleRingBuffer::read(int16 *data, size_t n) {
+	const uint64 readPos  = _readPos.load(std::memory_order_relaxed);
+	const uint64 writePos = _writePos.load(std::memory_order_acquire);
+
+	n = MIN<size_t>(n, writePos - readPos);
+
+	// In up to two parts, if the data wraps around the end of the buffer
+	const size_t start = readPos % _capacity;
+	const size_t part1 = MIN(n, _capacity - start);
+
+	std::memcpy(data, _buffer.get() + start, part1 * sizeof(int16));
+	std::memcpy(data + part1, _buffer.get(), (n - part1) * sizeof(int16));
+
+	_readPos.store(readPos + n, std::memory_order_release);
+	return n;
+}
+
+size_t SampleRingBuffer::write(const int16 *data, size_t n) {
+	size_t written = 0;
+
+	while (written < n) {
+		size_t space;
+		int16 *dest = getWritePointer(space);
+
+		space = MIN(space, n - written);
+		if (space == 0)
+			break;
+
+		std::memcpy(dest, data + written, space * sizeof(int16));
+		commitWrite(space);
+
+		written += space;
+	}
+
+	return written;
+}
+
+int16 *SampleRingBuffer::getWritePointer(size_t &n) {
+	const uint64 readPos  = _readPos.load(std::memory_order_acquire);
+	const uint64 writePos = _writePos.load(std::memory_order_relaxed);
+
+	const size_t start = writePos % _capacity;
+
+	n = MIN<size_t>(_capacity - (writePos - readPos), _capacity - start);
+
+	return _buffer.get() + start;
+}
+
+void SampleRingBuffer::commitWrite(size_t n) {
+	_writePos.store(_writePos.load(std::memory_order_relaxed) + n, std::memory_order_release);
+}
+
+
+DecodeAheadStream::DecodeAheadStream(AudioStream *stream, bool disposeAfterUse, size_t bufferSize) :
+	_stream(stream, disposeAfterUse), _channels(stream->getChannels()), _rate(stream->getRate()),
+	_buffer(MAX<size_t>(bufferSize - (bufferSize % MAX(_channels, 1)), MAX(_channels, 1))),
+	_endOfData(false), _endOfStream(false), _underruns(0), _pool(0) {
+
+}
+
+DecodeAheadStream::~DecodeAheadStream() {
+	if (_pool)
+		_pool->removeStream(this);
+}
+
+int DecodeAheadStream::getChannels() const {
+	return _channels;
+}
+
+int DecodeAheadStream::getRate() const {
+	return _rate;
+}
+
+bool DecodeAheadStream::endOfData() const {
+	// Check the flag first: once the decoder sets it, all data it found is in the buffer
+	return _endOfData.load(std::memory_order_acquire) && (_buffer.getFill() == 0);
+}
+
+bool DecodeAheadStream::endOfStream() const {
+	return _endOfStream.load(std::memory_order_acquire) && (_buffer.getFill() == 0);
+}
+
+uint32 DecodeAheadStream::getUnderruns() const {
+	return _underruns.load(std::memory_order_relaxed);
+}
+
+size_t DecodeAheadStream::readBuffer(int16 *buffer, const size_t numSamples) {
+	const bool ended = _endOfStream.load(std::memory_order_acquire);
+
+	const size_t n = _buffer.read(buffer, numSamples);
+	if ((n == 0) && (numSamples > 0) && !ended)
+		_underruns.fetch_add(1, std::memory_order_relaxed);
+
+	// Let the decoders refill what we just took out
+	if (_pool && needsData())
+		_pool->wake();
+
+	return n;
+}
+
+bool DecodeAheadStream::needsData() const {
+	if (_endOfStream.load(std::memory_order_relaxed))
+		return false;
+
+	return _buffer.getFree() >= MIN(_buffer.getCapacity() / 4, kDecodeChunk);
+}
+
+bool DecodeAheadStream::decode() {
+	if (_endOfStream.load(std::memory_order_relaxed))
+		return false;
+
+	const size_t channels = MAX(_channels, 1);
+
+	size_t decoded = 0;
+	while (decoded < kDecodeChunk) {
+		size_t space;
+		int16 *dest = _buffer.getWritePointer(space);
+
+		// Only ever decode whole frames
+		space = MIN(space, kDecodeChunk - decoded);
+		space -= space % channels;
+		if (space == 0)
+			break;
+
+		size_t n = _stream->readBuffer(dest, space);
+		if (n == kSizeInvalid) {
+			warning("DecodeAheadStream::decode(): Failed reading from stream");
+
+			// Don't let the stream's own state revive us, or we'd retry forever
+			_endOfData.store(true, std::memory_order_release);
+			_endOfStream.store(true, std::memory_order_release);
+			return decoded > 0;
+		}
+
+		_buffer.commitWrite(n);
+		decoded += n;
+
+		if (n < space)
+			break;
+	}
+
+	_endOfData.store(_stream->endOfData(), std::memory_order_release);
+	_endOfStream.store(_stream->endOfStream(), std::memory_order_release);
+
+	return decoded > 0;
+}
+
+void DecodeAheadStream::fill() {
+	std::lock_guard<std::mutex> lock(_decodeMutex);
+
+	while (decode())
+		;
+}
+
+void DecodeAheadStream::seed() {
+	std::lock_guard<std::mutex> lock(_decodeMutex);
+
+	decode();
+}
+
+
+DecoderPool::DecoderPool(size_t threadCount) : _nextStream(0), _kill(false) {
+	threadCount = MAX<size_t>(threadCount, 1);
+
+	for (size_t i = 0; i < threadCount; i++)
+		_threads.push_back(std::thread(&DecoderPool::threadMethod, this));
+}
+
+DecoderPool::~DecoderPool() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_kill.store(true);
+	}
+
+	_wake.notify_all();
+
+	for (std::vector<std::thread>::iterator t = _threads.begin(); t != _threads.end(); ++t)
+		t->join();
+
+	for (std::vector<DecodeAheadStream *>::iterator s = _streams.begin(); s != _streams.end(); ++s)
+		(*s)->_pool = 0;
+}
+
+void DecoderPool::addStream(DecodeAheadStream *stream) {
+	if (!stream)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		if (stream->_pool)
+			throw Common::Exception("DecoderPool::addStream(): Stream is already being decoded");
+
+		stream->_pool = this;
+		_streams.push_back(stream);
+	}
+
+	_wake.notify_one();
+}
+
+void DecoderPool::removeStream(DecodeAheadStream *stream) {
+	if (!stream)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		std::vector<DecodeAheadStream *>::iterator s = std::find(_streams.begin(), _streams.end(), stream);
+		if (s == _streams.end())
+			return;
+
+		_streams.erase(s);
+		stream->_pool = 0;
+	}
+
+	// No thread will pick it up anymore, but one might still be decoding it
+	std::lock_guard<std::mutex> decodeLock(stream->_decodeMutex);
+}
+
+void DecoderPool::wake() {
+	_wake.notify_one();
+}
+
+DecodeAheadStream *DecoderPool::lockStream() {
+	for (size_t i = 0; i < _streams.size(); i++) {
+		const size_t index = (_nextStream + i) % _streams.size();
+
+		DecodeAheadStream *stream = _streams[index];
+		if (!stream->needsData() || !stream->_decodeMutex.try_lock())
+			continue;
+
+		// Start looking at the next stream next time, so that every stream gets its turn
+		_nextStream = index + 1;
+		return stream;
+	}
+
+	return 0;
+}
+
+void DecoderPool::threadMethod() {
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	// Number of streams in a row that had nothing to decode
+	size_t idle = 0;
+
+	while (!_kill.load()) {
+		DecodeAheadStream *stream = (idle < _streams.size()) ? lockStream() : 0;
+		if (!stream) {
+			/* Nothing to do. Wake up regularly anyway, for streams that
+			 * are waiting for more data to arrive from elsewhere. */
+			_wake.wait_for(lock, std::chrono::milliseconds(10));
+
+			idle = 0;
+			continue;
+		}
+
+		lock.unlock();
+
+		bool decoded = false;
+		try {
+			decoded = stream->decode();
+		} catch (...) {
+			Common::exceptionDispatcherWarning("Failed decoding ahead");
+
+			stream->_endOfData.store(true, std::memory_order_release);
+			stream->_endOfStream.store(true, std::memory_order_release);
+		}
+
+		stream->_decodeMutex.unlock();
+
+		lock.lock();
+
+		idle = decoded ? 0 : (idle + 1);
+	}
+}
+
+} // End of namespace Sound
@@ -0,0 +1,185 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Decoding audio streams ahead of playback, in worker threads.
+ */
+
+#ifndef SOUND_DECODEAHEAD_H
+#define SOUND_DECODEAHEAD_H
+
+#include <atomic>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/scopedptr.h"
+#include "src/common/disposableptr.h"
+#include "src/common/thread.h"
+#include "src/common/mutex.h"
+
+#include "src/sound/audiostream.h"
+
+namespace Sound {
+
+/** A ring buffer of samples.
+ *
+ *  Lock-free, for exactly one thread writing and one thread reading.
+ */
+class SampleRingBuffer : boost::noncopyable {
+public:
+	SampleRingBuffer(size_t capacity);
+	~SampleRingBuffer();
+
+	/** Return the number of samples the buffer can hold. */
+	size_t getCapacity() const;
+
+	/** Return the number of samples ready to be read. */
+	size_t getFill() const;
+	/** Return the number of samples that can be written. */
+	size_t getFree() const;
+
+	/** Read up to n samples. Returns the number of samples read. */
+	size_t read(int16 *data, size_t n);
+	/** Write up to n samples. Returns the number of samples written. */
+	size_t write(const int16 *data, size_t n);
+
+	/** Return the free space directly after the last written sample.
+	 *
+	 *  Together with commitWrite(), this lets the writer fill the
+	 *  buffer without an intermediate copy.
+	 *
+	 *  @param  n Will be set to the number of samples that fit there.
+	 */
+	int16 *getWritePointer(size_t &n);
+	/** Mark n samples at the write pointer as written. */
+	void commitWrite(size_t n);
+
+private:
+	Common::ScopedArray<int16> _buffer;
+	size_t _capacity;
+
+	// Both only ever grow; their difference is the fill
+	std::atomic<uint64> _readPos;
+	std::atomic<uint64> _writePos;
+};
+
+class DecoderPool;
+
+/** An audio stream wrapping another audio stream, decoding it ahead of time.
+ *
+ *  The decoding happens in a DecoderPool, into a ring buffer. Reading
+ *  from this stream only copies samples out of that ring buffer.
+ *
+ *  A read that finds no samples ready, while the wrapped stream still
+ *  has more to come, counts as an underrun.
+ */
+class DecodeAheadStream : public AudioStream {
+public:
+	/** Wrap this stream.
+	 *
+	 *  @param stream The stream to decode ahead.
+	 *  @param disposeAfterUse Should the stream be deleted together with this one?
+	 *  @param bufferSize The number of samples to decode ahead.
+	 */
+	DecodeAheadStream(AudioStream *stream, bool disposeAfterUse, size_t bufferSize);
+	~DecodeAheadStream();
+
+	size_t readBuffer(int16 *buffer, const size_t numSamples);
+
+	int getChannels() const;
+	int getRate() const;
+
+	bool endOfData() const;
+	bool endOfStream() const;
+
+	/** Decode until the ring buffer is full, or the wrapped stream has no more data. */
+	void fill();
+	/** Decode a single chunk, to have the first samples ready before the pool gets to this stream. */
+	void seed();
+
+	/** Return the number of reads that found no samples ready. */
+	uint32 getUnderruns() const;
+
+private:
+	/** Number of samples decoded in one go, for fairness between streams. */
+	static const size_t kDecodeChunk = 8192;
+
+	Common::DisposablePtr<AudioStream> _stream;
+
+	int _channels;
+	int _rate;
+
+	SampleRingBuffer _buffer;
+
+	std::atomic<bool> _endOfData;   ///< Did the wrapped stream run out of data?
+	std::atomic<bool> _endOfStream; ///< Has the wrapped stream ended?
+
+	std::atomic<uint32> _underruns;
+
+	DecoderPool *_pool; ///< The pool decoding this stream, if any.
+
+	/** Held while decoding. Only one thread decodes at a time. */
+	std::mutex _decodeMutex;
+
+	/** Does the ring buffer have enough space to make decoding worthwhile? */
+	bool needsData() const;
+
+	/** Decode one chunk. Returns false if nothing could be decoded. */
+	bool decode();
+
+	friend class DecoderPool;
+};
+
+/** A small pool of threads decoding audio streams ahead of playback. */
+class DecoderPool : boost::noncopyable {
+public:
+	DecoderPool(size_t threadCount);
+	~DecoderPool();
+
+	/** Start decoding this stream. */
+	void addStream(DecodeAheadStream *stream);
+	/** Stop decoding this stream. Waits for a running decode to finish. */
+	void removeStream(DecodeAheadStream *stream);
+
+	/** Signal that a stream has space to decode into. */
+	void wake();
+
+private:
+	std::vector<std::thread> _threads;
+
+	std::vector<DecodeAheadStream *> _streams;
+	size_t _nextStream; ///< Where to continue looking for work.
+
+	std::atomic<bool> _kill;
+
+	std::mutex _mutex;
+	std::condition_variable _wake;
+
+	/** Find a stream that needs data, and lock it for decoding. */
+	DecodeAheadStream *lockStream();
+
+	void threadMethod();
+};
+
+} // End of namespace Sound
+
+#endif // SOUND_DECODEAHEAD_H
@@ -57,6 +57,7 @@
 #include "src/aurora/resman.h"
 
 #include "src/sound/fmodsamplebank.h"
+#include "src/sound/soundbankdata.h"
 
 #ifdef ENABLE_MAD
 #include "src/sound/decoders/mp3.h"
@@ -65,18 +66,26 @@
 
 namespace Sound {
 
-FMODSampleBank::FMODSampleBank(Common::SeekableReadStream *fsb) : _fsb(fsb) {
-	assert(_fsb);
+FMODSampleBank::FMODSampleBank(Common::SeekableReadStream *fsb) {
+	assert(fsb);
 
-	load(*_fsb);
+	open(fsb);
 }
 
 FMODSampleBank::FMODSampleBank(const Common::UString &name) {
-	_fsb.reset(ResMan.getResource(name, Aurora::kFileTypeFSB));
-	if (!_fsb)
+	Common::SeekableReadStream *fsb = ResMan.getResource(name, Aurora::kFileTypeFSB);
+	if (!fsb)
 		throw Common::Exception("No such FSB resource \"%s\"", name.c_str());
 
-	load(*_fsb);
+	open(fsb);
+}
+
+void FMODSampleBank::open(Common::SeekableReadStream *fsb) {
+	std::unique_ptr<Common::SeekableReadStream> stream(fsb);
+
+	load(*stream);
+
+	_data = std::make_shared<const SoundBankData>(stream.release());
 }
 
 size_t FMODSampleBank::getSampleCount() const {
@@ -100,8 +109,7 @@ static constexpr uint32 kSampleFlagMP3      = 0x00000200;
 static constexpr uint32 kSampleFlagIMAADPCM = 0x00400000;
 
 RewindableAudioStream *FMODSampleBank::getSample(const Sample &sample) const {
-	_fsb->seek(sample.offset);
-	std::unique_ptr<Common::SeekableReadStream> dataStream(_fsb->readStream(sample.size));
+	std::unique_ptr<Common::SeekableReadStream> dataStream(new SoundBankReadStream(_data, sample.offset, sample.size));
 
 	if (sample.flags & kSampleFlagMP3) {
 		warning("MP3");
@@ -114,7 +122,7 @@ RewindableAudioStream *FMODSampleBank::getSample(const Sample &sample) const {
 
 	if (sample.flags & kSampleFlagIMAADPCM) {
 		warning("APCM");
-		return makeADPCMStream(dataStream.release(), true, dataStream->size(),
+		return makeADPCMStream(dataStream.release(), true, sample.size,
 		                       kADPCMMSIma, sample.defFreq, sample.channels, 36 * sample.channels);
 	}
 
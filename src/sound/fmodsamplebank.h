@@ -35,6 +35,7 @@
 namespace Sound {
 
 class RewindableAudioStream;
+class SoundBankData;
 
 /** Class to hold audio resource data of an FMOD samplebank file.
  *
@@ -96,13 +97,16 @@ private:
 	};
 
 
-	std::unique_ptr<Common::SeekableReadStream> _fsb;
+	/** The whole bank, which the sample streams read from. */
+	std::shared_ptr<const SoundBankData> _data;
 
 	std::vector<Sample> _samples;
 
 	std::map<Common::UString, const Sample *> _sampleMap;
 
 
+	/** Take over this stream, load the bank's index and keep its data. */
+	void open(Common::SeekableReadStream *fsb);
 	void load(Common::SeekableReadStream &fsb);
 
 	RewindableAudioStream *getSample(const Sample &sample) const;
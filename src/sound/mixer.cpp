@@ -0,0 +1,455 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A software mixer, mixing audio streams into one stereo output.
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+
+#include "src/sound/mixer.h"
+#include "src/sound/audiostream.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define MIXER_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+namespace Sound {
+
+/** Number of frames buffered from a stream. */
+static const size_t kInputFrames = 1024;
+
+/** The maximum number of channels in a stream we read. */
+static const int kMaxChannels = 6;
+
+/** The maximum pitch, in input frames per output frame. */
+static const uint32 kMaxStep = 64 << 16;
+
+/** Contribution of the center and rear channels when downmixing 5.1. */
+static const float kDownmixGain = 0.70710678f;
+
+/** Add the stereo frames in src, multiplied by the gains, onto dst. */
+static void accumulate(float *dst, const float *src, size_t frames, float left, float right) {
+	size_t i = 0;
+
+#ifdef MIXER_SSE2
+	const __m128 gain = _mm_setr_ps(left, right, left, right);
+
+	for (; (i + 4) <= frames; i += 4, src += 8, dst += 8) {
+		const __m128 s0 = _mm_mul_ps(_mm_loadu_ps(src    ), gain);
+		const __m128 s1 = _mm_mul_ps(_mm_loadu_ps(src + 4), gain);
+
+		_mm_storeu_ps(dst    , _mm_add_ps(_mm_loadu_ps(dst    ), s0));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), s1));
+	}
+#endif
+
+	for (; i < frames; i++, src += 2, dst += 2) {
+		dst[0] += src[0] * left;
+		dst[1] += src[1] * right;
+	}
+}
+
+/** Convert the samples to 16-bit, saturating. */
+static void convert(int16 *dst, const float *src, size_t samples, float gain) {
+	size_t i = 0;
+
+#ifdef MIXER_SSE2
+	const __m128 scale = _mm_set1_ps(gain);
+	const __m128 low   = _mm_set1_ps(-32768.0f);
+	const __m128 high  = _mm_set1_ps( 32767.0f);
+
+	for (; (i + 8) <= samples; i += 8, src += 8, dst += 8) {
+		// Clamp first: out-of-range values would convert to INT_MIN
+		const __m128 s0 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src    ), scale), low), high);
+		const __m128 s1 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + 4), scale), low), high);
+
+		const __m128i p = _mm_packs_epi32(_mm_cvtps_epi32(s0), _mm_cvtps_epi32(s1));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst), p);
+	}
+#endif
+
+	for (; i < samples; i++, src++, dst++)
+		*dst = (int16) std::lrint(CLIP(*src * gain, -32768.0f, 32767.0f));
+}
+
+
+Mixer::Source::Source(AudioStream *s) : stream(s), channels(s->getChannels()),
+	playing(false), finished(false), gain(1.0f), step(0x10000), relative(true),
+	minDistance(1.0f), maxDistance(3.40282347e+38f),
+	inputFrames(0), inputPos(0), inputFrac(0), consumed(0) {
+
+	position[0] = position[1] = position[2] = 0.0f;
+
+	input.resize(kInputFrames * 2);
+}
+
+
+Mixer::Mixer(int rate) : _rate(rate), _listenerGain(1.0f) {
+	if (_rate <= 0)
+		throw Common::Exception("Invalid mixer rate %d", _rate);
+
+	_listenerPosition[0] = _listenerPosition[1] = _listenerPosition[2] = 0.0f;
+
+	// OpenAL's default orientation: looking along -Z, with +Y up
+	_listenerOrientation[0] =  0.0f;
+	_listenerOrientation[1] =  0.0f;
+	_listenerOrientation[2] = -1.0f;
+	_listenerOrientation[3] =  0.0f;
+	_listenerOrientation[4] =  1.0f;
+	_listenerOrientation[5] =  0.0f;
+
+	_readBuffer.resize(kInputFrames * kMaxChannels);
+
+	_mixBuffer.resize(kBlockFrames * 2);
+	_sourceBuffer.resize(kBlockFrames * 2);
+}
+
+Mixer::~Mixer() {
+	for (std::vector<Source *>::iterator s = _sources.begin(); s != _sources.end(); ++s)
+		delete *s;
+}
+
+int Mixer::getRate() const {
+	return _rate;
+}
+
+size_t Mixer::addSource(AudioStream *stream) {
+	if (!stream)
+		throw Common::Exception("Mixer::addSource(): No stream");
+
+	Source *source = new Source(stream);
+
+	const int channels = source->channels;
+	if ((channels != 1) && (channels != 2) && (channels != 6)) {
+		warning("Mixer::addSource(): Unsupported channel count %d", channels);
+		source->finished = true;
+	}
+
+	updateStep(*source, 1.0f);
+
+	// Reuse a free slot, if we have one
+	for (size_t i = 0; i < _sources.size(); i++) {
+		if (!_sources[i]) {
+			_sources[i] = source;
+			return i;
+		}
+	}
+
+	_sources.push_back(source);
+	return _sources.size() - 1;
+}
+
+void Mixer::removeSource(size_t source) {
+	if ((source >= _sources.size()) || !_sources[source])
+		return;
+
+	delete _sources[source];
+	_sources[source] = 0;
+
+	while (!_sources.empty() && !_sources.back())
+		_sources.pop_back();
+}
+
+Mixer::Source &Mixer::getSource(size_t source) {
+	if ((source >= _sources.size()) || !_sources[source])
+		throw Common::Exception("Invalid mixer source %u", (uint) source);
+
+	return *_sources[source];
+}
+
+const Mixer::Source &Mixer::getSource(size_t source) const {
+	if ((source >= _sources.size()) || !_sources[source])
+		throw Common::Exception("Invalid mixer source %u", (uint) source);
+
+	return *_sources[source];
+}
+
+void Mixer::setSourcePlaying(size_t source, bool playing) {
+	getSource(source).playing = playing;
+}
+
+bool Mixer::isSourceFinished(size_t source) const {
+	return getSource(source).finished;
+}
+
+uint64 Mixer::getSourceSamplesPlayed(size_t source) const {
+	const Source &s = getSource(source);
+
+	return s.consumed + MIN(s.inputPos, s.inputFrames);
+}
+
+void Mixer::setSourceGain(size_t source, float gain) {
+	getSource(source).gain = gain;
+}
+
+void Mixer::setSourcePitch(size_t source, float pitch) {
+	updateStep(getSource(source), pitch);
+}
+
+void Mixer::setSourcePosition(size_t source, float x, float y, float z) {
+	Source &s = getSource(source);
+
+	s.position[0] = x;
+	s.position[1] = y;
+	s.position[2] = z;
+}
+
+void Mixer::getSourcePosition(size_t source, float &x, float &y, float &z) const {
+	const Source &s = getSource(source);
+
+	x = s.position[0];
+	y = s.position[1];
+	z = s.position[2];
+}
+
+void Mixer::setSourceRelative(size_t source, bool relative) {
+	getSource(source).relative = relative;
+}
+
+void Mixer::setSourceDistance(size_t source, float minDistance, float maxDistance) {
+	Source &s = getSource(source);
+
+	s.minDistance = minDistance;
+	s.maxDistance = maxDistance;
+}
+
+void Mixer::setListenerGain(float gain) {
+	_listenerGain = gain;
+}
+
+void Mixer::setListenerPosition(float x, float y, float z) {
+	_listenerPosition[0] = x;
+	_listenerPosition[1] = y;
+	_listenerPosition[2] = z;
+}
+
+void Mixer::setListenerOrientation(float dirX, float dirY, float dirZ, float upX, float upY, float upZ) {
+	_listenerOrientation[0] = dirX;
+	_listenerOrientation[1] = dirY;
+	_listenerOrientation[2] = dirZ;
+	_listenerOrientation[3] = upX;
+	_listenerOrientation[4] = upY;
+	_listenerOrientation[5] = upZ;
+}
+
+void Mixer::updateStep(Source &source, float pitch) const {
+	const double step = ((double) source.stream->getRate() * MAX(pitch, 0.0f) * 65536.0) / _rate;
+
+	source.step = (uint32) CLIP<double>(step + 0.5, 1.0, kMaxStep);
+}
+
+void Mixer::getGains(const Source &source, float &left, float &right) const {
+	left = right = source.gain;
+
+	// Like OpenAL, only mono sources are spatialized
+	if (source.channels != 1)
+		return;
+
+	float direction[3];
+	for (int i = 0; i < 3; i++)
+		direction[i] = source.position[i] - (source.relative ? 0.0f : _listenerPosition[i]);
+
+	const float distance = std::sqrt(direction[0] * direction[0] +
+	                                 direction[1] * direction[1] +
+	                                 direction[2] * direction[2]);
+
+	// AL_LINEAR_DISTANCE_CLAMPED, with a rolloff factor of 1
+	if (source.maxDistance > source.minDistance) {
+		const float clamped = CLIP(distance, source.minDistance, source.maxDistance);
+		const float attenuation = 1.0f - (clamped - source.minDistance) / (source.maxDistance - source.minDistance);
+
+		left = right = source.gain * CLIP(attenuation, 0.0f, 1.0f);
+	}
+
+	if (distance <= 1e-6f)
+		return;
+
+	/* Project the direction onto the listener's right vector. The positions
+	 * of relative sources are already in the listener's coordinate system. */
+	float side = direction[0];
+	if (!source.relative) {
+		const float *at = _listenerOrientation, *up = _listenerOrientation + 3;
+
+		float rightVector[3] = {
+			at[1] * up[2] - at[2] * up[1],
+			at[2] * up[0] - at[0] * up[2],
+			at[0] * up[1] - at[1] * up[0]
+		};
+
+		const float length = std::sqrt(rightVector[0] * rightVector[0] +
+		                               rightVector[1] * rightVector[1] +
+		                               rightVector[2] * rightVector[2]);
+		if (length <= 1e-6f)
+			return;
+
+		side = (direction[0] * rightVector[0] + direction[1] * rightVector[1] + direction[2] * rightVector[2]) / length;
+	}
+
+	// Balance: a centered source plays at full volume on both sides
+	const float pan = CLIP(side / distance, -1.0f, 1.0f);
+
+	left  *= MIN(1.0f - pan, 1.0f);
+	right *= MIN(1.0f + pan, 1.0f);
+}
+
+void Mixer::fillInput(Source &source) {
+	// Throw away the frames we're done with
+	const size_t done = MIN(source.inputPos, source.inputFrames);
+
+	source.consumed    += done;
+	source.inputPos    -= done;
+	source.inputFrames -= done;
+
+	if (source.inputFrames > 0)
+		std::memmove(&source.input[0], &source.input[done * 2], source.inputFrames * 2 * sizeof(float));
+
+	if (source.stream->endOfData())
+		return;
+
+	const size_t channels = source.channels;
+	const size_t frames   = kInputFrames - source.inputFrames;
+
+	const size_t samples = source.stream->readBuffer(&_readBuffer[0], frames * channels);
+	if (samples == AudioStream::kSizeInvalid) {
+		warning("Mixer::fillInput(): Failed reading from stream");
+
+		source.finished = true;
+		return;
+	}
+
+	const size_t read = samples / channels;
+
+	const int16 *in  = &_readBuffer[0];
+	float       *out = &source.input[source.inputFrames * 2];
+
+	if (channels == 1) {
+		for (size_t i = 0; i < read; i++, in++, out += 2)
+			out[0] = out[1] = *in;
+
+	} else if (channels == 2) {
+		for (size_t i = 0; i < read * 2; i++)
+			*out++ = *in++;
+
+	} else {
+		// 5.1: front left, front right, center, LFE, rear left, rear right
+		for (size_t i = 0; i < read; i++, in += 6, out += 2) {
+			out[0] = in[0] + (in[2] + in[4]) * kDownmixGain;
+			out[1] = in[1] + (in[2] + in[5]) * kDownmixGain;
+		}
+	}
+
+	source.inputFrames += read;
+}
+
+size_t Mixer::resample(Source &source, float *buffer, size_t frames) {
+	size_t done = 0;
+
+	while ((done < frames) && !source.finished) {
+		// We need the current and the next frame to interpolate between
+		if ((source.inputPos + 1) >= source.inputFrames) {
+			fillInput(source);
+
+			if ((source.inputPos + 1) >= source.inputFrames) {
+				// No new data yet, but there might be more later
+				if (!source.stream->endOfStream())
+					break;
+
+				if (source.inputPos >= source.inputFrames) {
+					source.finished = true;
+					break;
+				}
+			}
+		}
+
+		if ((source.step == 0x10000) && (source.inputFrac == 0)) {
+			// Same rate as the output: just copy the frames over
+			const size_t n = MIN(frames - done, source.inputFrames - source.inputPos);
+
+			std::memcpy(buffer + done * 2, &source.input[source.inputPos * 2], n * 2 * sizeof(float));
+
+			source.inputPos += n;
+			done            += n;
+			continue;
+		}
+
+		// Linearly interpolate as long as both frames are buffered
+		const size_t last = (source.inputFrames > 0) ? (source.inputFrames - 1) : 0;
+		while ((done < frames) && (source.inputPos <= last)) {
+			const float *a = &source.input[source.inputPos * 2];
+			const float *b = (source.inputPos < last) ? (a + 2) : a;
+
+			const float t = source.inputFrac * (1.0f / 65536.0f);
+
+			buffer[done * 2 + 0] = a[0] + (b[0] - a[0]) * t;
+			buffer[done * 2 + 1] = a[1] + (b[1] - a[1]) * t;
+			done++;
+
+			source.inputFrac += source.step;
+			source.inputPos  += source.inputFrac >> 16;
+			source.inputFrac &= 0xFFFF;
+
+			// Refill before interpolating towards a frame we don't have yet
+			if ((source.inputPos >= last) && (b != a))
+				break;
+		}
+	}
+
+	return done;
+}
+
+void Mixer::mixBlock(int16 *buffer, size_t frames) {
+	float *mix = &_mixBuffer[0];
+	std::memset(mix, 0, frames * 2 * sizeof(float));
+
+	for (std::vector<Source *>::iterator s = _sources.begin(); s != _sources.end(); ++s) {
+		Source *source = *s;
+		if (!source || !source->playing || source->finished)
+			continue;
+
+		float left, right;
+		getGains(*source, left, right);
+
+		const size_t n = resample(*source, &_sourceBuffer[0], frames);
+
+		if ((left != 0.0f) || (right != 0.0f))
+			accumulate(mix, &_sourceBuffer[0], n, left, right);
+	}
+
+	convert(buffer, mix, frames * 2, _listenerGain);
+}
+
+void Mixer::mix(int16 *buffer, size_t frames) {
+	while (frames > 0) {
+		const size_t n = MIN(frames, kBlockFrames);
+
+		mixBlock(buffer, n);
+
+		buffer += n * 2;
+		frames -= n;
+	}
+}
+
+} // End of namespace Sound
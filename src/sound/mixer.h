@@ -0,0 +1,182 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A software mixer, mixing audio streams into one stereo output.
+ */
+
+#ifndef SOUND_MIXER_H
+#define SOUND_MIXER_H
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+
+namespace Sound {
+
+class AudioStream;
+
+/** A software mixer.
+ *
+ *  The mixer mixes any number of audio streams into one stream of
+ *  interleaved 16-bit stereo samples. Every source is resampled to
+ *  the output rate, taking its pitch into account, and then added
+ *  to the output with its gain applied.
+ *
+ *  Mono sources are positioned in space the same way OpenAL does it,
+ *  with the linear clamped distance model and a stereo panning
+ *  depending on the direction of the source as seen by the listener.
+ *  Sources with more than one channel are neither attenuated nor
+ *  panned. 5.1 sources are downmixed to stereo.
+ *
+ *  The mixer is not thread-safe. Concurrent access to a mixer, and
+ *  to the audio streams it reads from, needs to be serialized.
+ */
+class Mixer : boost::noncopyable {
+public:
+	static const size_t kSourceInvalid = SIZE_MAX;
+
+	Mixer(int rate);
+	~Mixer();
+
+	/** Return the sample rate of the output. */
+	int getRate() const;
+
+	/** Mix this many frames of all playing sources into the buffer.
+	 *
+	 *  The buffer receives frames * 2 interleaved samples, left first.
+	 */
+	void mix(int16 *buffer, size_t frames);
+
+	// .--- Sources
+	/** Add a new, paused source, reading from this audio stream.
+	 *
+	 *  The stream is not taken over, and needs to stay valid until
+	 *  the source is removed again.
+	 */
+	size_t addSource(AudioStream *stream);
+	/** Remove a source. */
+	void removeSource(size_t source);
+
+	/** Start or pause a source. */
+	void setSourcePlaying(size_t source, bool playing);
+
+	/** Has that source reached the end of its stream? */
+	bool isSourceFinished(size_t source) const;
+	/** Return the number of samples per channel this source has played. */
+	uint64 getSourceSamplesPlayed(size_t source) const;
+
+	/** Set the gain of a source. */
+	void setSourceGain(size_t source, float gain);
+	/** Set the pitch of a source. */
+	void setSourcePitch(size_t source, float pitch);
+
+	/** Set the position of a source. */
+	void setSourcePosition(size_t source, float x, float y, float z);
+	/** Get the position of a source. */
+	void getSourcePosition(size_t source, float &x, float &y, float &z) const;
+	/** Set if the position of a source is relative to the listener. */
+	void setSourceRelative(size_t source, bool relative);
+	/** Set the distances over which the volume of a source is attenuated. */
+	void setSourceDistance(size_t source, float minDistance, float maxDistance);
+	// '---
+
+	// .--- Listener
+	/** Set the gain of the listener (= the global master volume). */
+	void setListenerGain(float gain);
+	/** Set the position of the listener. */
+	void setListenerPosition(float x, float y, float z);
+	/** Set the orientation of the listener. */
+	void setListenerOrientation(float dirX, float dirY, float dirZ, float upX, float upY, float upZ);
+	// '---
+
+private:
+	/** Number of frames mixed in one go. */
+	static const size_t kBlockFrames = 1024;
+
+	/** A source, playing an audio stream. */
+	struct Source {
+		AudioStream *stream; ///< The stream we're playing.
+		int channels;        ///< The number of channels in the stream.
+
+		bool playing;  ///< Is the source currently playing?
+		bool finished; ///< Has the source played its whole stream?
+
+		float gain;  ///< The gain of the source.
+		uint32 step; ///< Number of input frames per output frame, in 16.16 fixed point.
+
+		float position[3]; ///< The position of the source.
+		bool relative;     ///< Is the position relative to the listener?
+
+		float minDistance; ///< Closer than that, the source has its full volume.
+		float maxDistance; ///< Further away than that, the volume isn't attenuated further.
+
+		/** Frames read from the stream, converted to stereo floats. */
+		std::vector<float> input;
+
+		size_t inputFrames; ///< Number of valid frames in the input buffer.
+		size_t inputPos;    ///< Position of the current frame in the input buffer.
+		uint32 inputFrac;   ///< Position between the current and next frame, in 16.16 fixed point.
+
+		/** Number of frames consumed and discarded from the input buffer. */
+		uint64 consumed;
+
+		Source(AudioStream *s);
+	};
+
+	int _rate; ///< The sample rate of the output.
+
+	std::vector<Source *> _sources;
+
+	float _listenerGain;           ///< The gain of the listener.
+	float _listenerPosition[3];    ///< The position of the listener.
+	float _listenerOrientation[6]; ///< Direction and up vectors of the listener.
+
+	std::vector<int16> _readBuffer; ///< Buffer for reading from the streams.
+
+	std::vector<float> _mixBuffer;    ///< The mixed frames.
+	std::vector<float> _sourceBuffer; ///< Resampled frames of a single source.
+
+	Source &getSource(size_t source);
+	const Source &getSource(size_t source) const;
+
+	/** Calculate the step through the input for this source. */
+	void updateStep(Source &source, float pitch) const;
+
+	/** Calculate the gain of the left and right output channel for this source. */
+	void getGains(const Source &source, float &left, float &right) const;
+
+	/** Read more frames from the stream into the input buffer of the source. */
+	void fillInput(Source &source);
+
+	/** Resample up to this many frames of the source into the buffer.
+	 *
+	 *  @return The number of frames written.
+	 */
+	size_t resample(Source &source, float *buffer, size_t frames);
+
+	void mixBlock(int16 *buffer, size_t frames);
+};
+
+} // End of namespace Sound
+
+#endif // SOUND_MIXER_H
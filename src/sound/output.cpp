@@ -0,0 +1,191 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Outputs for the sound mixed by the software mixer.
+ */
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/ustring.h"
+
+#include "src/sound/output.h"
+
+namespace Sound {
+
+SoundOutput::SoundOutput(int rate) : _rate(rate) {
+}
+
+SoundOutput::~SoundOutput() {
+}
+
+int SoundOutput::getRate() const {
+	return _rate;
+}
+
+
+NullSoundOutput::NullSoundOutput(int rate) : SoundOutput(rate), _start(Clock::now()), _written(0) {
+}
+
+NullSoundOutput::~NullSoundOutput() {
+}
+
+size_t NullSoundOutput::getFreeFrames() {
+	const uint64 elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - _start).count();
+	const uint64 played  = (elapsed * _rate) / 1000;
+
+	// If we fell behind by more than half a second, skip ahead instead of catching up
+	const uint64 maxFree = _rate / 2;
+	if (played > (_written + maxFree))
+		_written = played - maxFree;
+
+	return (size_t) (played - MIN(played, _written));
+}
+
+void NullSoundOutput::write(const int16 *UNUSED(data), size_t frames) {
+	_written += frames;
+}
+
+
+WAVSoundOutput::WAVSoundOutput(const Common::UString &fileName, int rate) : NullSoundOutput(rate),
+	_file(fileName), _dataSize(0) {
+
+	_buffer.resize(kMaxFrames * 4);
+
+	writeHeader();
+}
+
+WAVSoundOutput::~WAVSoundOutput() {
+	try {
+		// Now that we know the size of the data, rewrite the header
+		_file.seek(0);
+		writeHeader();
+
+		_file.flush();
+	} catch (...) {
+	}
+}
+
+void WAVSoundOutput::writeHeader() {
+	_file.writeUint32BE(MKTAG('R', 'I', 'F', 'F'));
+	_file.writeUint32LE(36 + _dataSize);
+	_file.writeUint32BE(MKTAG('W', 'A', 'V', 'E'));
+
+	_file.writeUint32BE(MKTAG('f', 'm', 't', ' '));
+	_file.writeUint32LE(16);
+	_file.writeUint16LE(1);         // PCM
+	_file.writeUint16LE(2);         // Channels
+	_file.writeUint32LE(_rate);     // Sample rate
+	_file.writeUint32LE(_rate * 4); // Bytes per second
+	_file.writeUint16LE(4);         // Bytes per frame
+	_file.writeUint16LE(16);        // Bits per sample
+
+	_file.writeUint32BE(MKTAG('d', 'a', 't', 'a'));
+	_file.writeUint32LE(_dataSize);
+}
+
+void WAVSoundOutput::write(const int16 *data, size_t frames) {
+	NullSoundOutput::write(data, frames);
+
+	frames = MIN(frames, kMaxFrames);
+
+	byte *buffer = &_buffer[0];
+	for (size_t i = 0; i < (frames * 2); i++, buffer += 2)
+		WRITE_LE_UINT16(buffer, (uint16) data[i]);
+
+	_file.write(&_buffer[0], frames * 4);
+
+	_dataSize += frames * 4;
+}
+
+
+OpenALSoundOutput::OpenALSoundOutput(int rate) : SoundOutput(rate), _source(0) {
+	ALenum error = AL_NO_ERROR;
+
+	alGenSources(1, &_source);
+	if ((error = alGetError()) != AL_NO_ERROR)
+		throw Common::Exception("OpenAL error while generating the output source: 0x%X", error);
+
+	alGenBuffers(kBufferCount, _buffers);
+	if ((error = alGetError()) != AL_NO_ERROR) {
+		alDeleteSources(1, &_source);
+		throw Common::Exception("OpenAL error while generating the output buffers: 0x%X", error);
+	}
+
+	// The mixer already positioned everything, play the output as-is
+	alSourcei(_source, AL_SOURCE_RELATIVE, AL_TRUE);
+	alSource3f(_source, AL_POSITION, 0.0f, 0.0f, 0.0f);
+
+	_freeBuffers.assign(_buffers, _buffers + kBufferCount);
+}
+
+OpenALSoundOutput::~OpenALSoundOutput() {
+	alSourceStop(_source);
+	alDeleteSources(1, &_source);
+	alDeleteBuffers(kBufferCount, _buffers);
+}
+
+size_t OpenALSoundOutput::getFreeFrames() {
+	ALint processed = 0;
+	alGetSourcei(_source, AL_BUFFERS_PROCESSED, &processed);
+
+	if (alGetError() != AL_NO_ERROR)
+		processed = 0;
+
+	processed = MIN<ALint>(processed, kBufferCount - _freeBuffers.size());
+
+	if (processed > 0) {
+		ALuint buffers[kBufferCount];
+		alSourceUnqueueBuffers(_source, processed, buffers);
+
+		if (alGetError() == AL_NO_ERROR)
+			_freeBuffers.insert(_freeBuffers.end(), buffers, buffers + processed);
+	}
+
+	return _freeBuffers.size() * kMaxFrames;
+}
+
+void OpenALSoundOutput::write(const int16 *data, size_t frames) {
+	if (_freeBuffers.empty() || (frames == 0))
+		return;
+
+	frames = MIN(frames, kMaxFrames);
+
+	const ALuint buffer = _freeBuffers.back();
+
+	alBufferData(buffer, AL_FORMAT_STEREO16, data, frames * 4, _rate);
+	alSourceQueueBuffers(_source, 1, &buffer);
+
+	ALenum error = alGetError();
+	if (error != AL_NO_ERROR) {
+		warning("OpenAL error while queueing the output buffer: 0x%X", error);
+		return;
+	}
+
+	_freeBuffers.pop_back();
+
+	// Start the source initially, and restart it after it ran dry
+	ALint state;
+	alGetSourcei(_source, AL_SOURCE_STATE, &state);
+	if (state != AL_PLAYING)
+		alSourcePlay(_source);
+}
+
+} // End of namespace Sound
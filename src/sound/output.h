@@ -0,0 +1,130 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Outputs for the sound mixed by the software mixer.
+ */
+
+#ifndef SOUND_OUTPUT_H
+#define SOUND_OUTPUT_H
+
+// Mac OS X has to have this set up separately because of the include
+// path for the OpenAL framework.
+#ifdef MACOSX
+	#include <OpenAL/al.h>
+#else
+	#include <AL/al.h>
+#endif
+
+#include <chrono>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/writefile.h"
+
+namespace Common {
+	class UString;
+}
+
+namespace Sound {
+
+/** An output taking interleaved 16-bit stereo samples from the mixer. */
+class SoundOutput : boost::noncopyable {
+public:
+	/** The maximum number of frames written to an output at once. */
+	static const size_t kMaxFrames = 1024;
+
+	SoundOutput(int rate);
+	virtual ~SoundOutput();
+
+	/** Return the sample rate of the output. */
+	int getRate() const;
+
+	/** Return the number of frames the output wants to be written right now. */
+	virtual size_t getFreeFrames() = 0;
+
+	/** Write up to kMaxFrames frames to the output. */
+	virtual void write(const int16 *data, size_t frames) = 0;
+
+protected:
+	int _rate;
+};
+
+/** An output that discards the sound, while consuming it in real time. */
+class NullSoundOutput : public SoundOutput {
+public:
+	NullSoundOutput(int rate);
+	~NullSoundOutput();
+
+	size_t getFreeFrames();
+	void write(const int16 *data, size_t frames);
+
+protected:
+	typedef std::chrono::steady_clock Clock;
+
+	Clock::time_point _start; ///< The time the output started.
+	uint64 _written;          ///< Number of frames written since the start.
+};
+
+/** An output that writes the sound into a WAVE file, in real time. */
+class WAVSoundOutput : public NullSoundOutput {
+public:
+	WAVSoundOutput(const Common::UString &fileName, int rate);
+	~WAVSoundOutput();
+
+	void write(const int16 *data, size_t frames);
+
+private:
+	Common::WriteFile _file;
+
+	uint32 _dataSize; ///< Number of bytes of sample data written.
+
+	std::vector<byte> _buffer;
+
+	void writeHeader();
+};
+
+/** An output that plays the sound through a single OpenAL source.
+ *
+ *  Needs a current OpenAL context.
+ */
+class OpenALSoundOutput : public SoundOutput {
+public:
+	OpenALSoundOutput(int rate);
+	~OpenALSoundOutput();
+
+	size_t getFreeFrames();
+	void write(const int16 *data, size_t frames);
+
+private:
+	/** Number of buffers queued on the source. */
+	static const size_t kBufferCount = 4;
+
+	ALuint _source;
+	ALuint _buffers[kBufferCount];
+
+	std::vector<ALuint> _freeBuffers;
+};
+
+} // End of namespace Sound
+
+#endif // SOUND_OUTPUT_H
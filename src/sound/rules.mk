@@ -27,6 +27,11 @@ src_sound_libsound_la_SOURCES += \
     src/sound/sound.h \
     src/sound/audiostream.h \
     src/sound/interleaver.h \
+    src/sound/mixer.h \
+    src/sound/output.h \
+    src/sound/decodeahead.h \
+    src/sound/soundbankdata.h \
+    src/sound/soundbankman.h \
     src/sound/xactwavebank.h \
     src/sound/xactwavebank_ascii.h \
     src/sound/xactwavebank_binary.h \
@@ -42,6 +47,11 @@ src_sound_libsound_la_SOURCES += \
     src/sound/sound.cpp \
     src/sound/audiostream.cpp \
     src/sound/interleaver.cpp \
+    src/sound/mixer.cpp \
+    src/sound/output.cpp \
+    src/sound/decodeahead.cpp \
+    src/sound/soundbankdata.cpp \
+    src/sound/soundbankman.cpp \
     src/sound/xactwavebank.cpp \
     src/sound/xactwavebank_ascii.cpp \
     src/sound/xactwavebank_binary.cpp \
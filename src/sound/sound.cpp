@@ -23,7 +23,6 @@
  */
 
 #include <cassert>
-#include <cstring>
 
 #include <boost/scope_exit.hpp>
 
@@ -36,6 +35,9 @@
 
 #include "src/sound/sound.h"
 #include "src/sound/audiostream.h"
+#include "src/sound/mixer.h"
+#include "src/sound/output.h"
+#include "src/sound/decodeahead.h"
 #include "src/sound/decoders/asf.h"
 #ifdef ENABLE_MAD
 #include "src/sound/decoders/mp3.h"
@@ -62,17 +64,37 @@ static const size_t kOpenALBufferCount = 5;
  */
 static const size_t kOpenALBufferSize = 32768;
 
+/** The sample rate of the software mixer's output. */
+static const int kMixerRate = 44100;
+
+/** Milliseconds between updates when using the software mixer.
+ *
+ *  @note The OpenAL output of the software mixer only queues about
+ *        90ms of sound, so we need to update quite often.
+ */
+static const int kMixerUpdateInterval = 10;
+
+/** Number of threads decoding the streams ahead of playback. */
+static const size_t kDecoderThreadCount = 2;
+
+/** Number of samples decoded ahead, per channel.
+ *
+ *  @note Enough to fill all OpenAL buffers of a channel at once.
+ */
+static const size_t kDecodeAheadSize = kOpenALBufferCount * (kOpenALBufferSize / 2);
+
 namespace Sound {
 
 SoundManager::Channel::Channel(uint32 i, size_t idx, SoundType t,
                                const TypeList::iterator &ti, AudioStream *s, bool d) :
-	id(i), index(idx), state(AL_PAUSED), stream(s, d), source(0),
-	type(t), typeIt(ti), finishedBuffers(0), gain(1.0f) {
+	id(i), index(idx), state(AL_PAUSED), stream(s, d), decodeAhead(0), source(0),
+	mixerSource(Mixer::kSourceInvalid), type(t), typeIt(ti), finishedBuffers(0), gain(1.0f) {
 
 }
 
 
-SoundManager::SoundManager() : _ready(false), _hasSound(false), _hasMultiChannel(false), _format51(0) {
+SoundManager::SoundManager() : _ready(false), _hasSound(false), _hasMultiChannel(false), _format51(0),
+	_dev(0), _ctx(0) {
 }
 
 SoundManager::~SoundManager() {
@@ -84,6 +106,7 @@ void SoundManager::init() {
 
 	_curID = 1;
 
+	_dev = 0;
 	_ctx = 0;
 
 	_hasSound = false;
@@ -91,38 +114,35 @@ void SoundManager::init() {
 	_hasMultiChannel = false;
 	_format51        = 0;
 
-	try {
-		_dev = alcOpenDevice(0);
-		if (!_dev)
-			throw Common::Exception("Could not open OpenAL device");
-
-		_ctx = alcCreateContext(_dev, 0);
-		if (!_ctx)
-			throw Common::Exception("Could not create OpenAL context: 0x%X", (uint) alGetError());
-
-		alcMakeContextCurrent(_ctx);
-
-		ALenum error = alGetError();
-		if (error != AL_NO_ERROR)
-			throw Common::Exception("Could not use OpenAL context: 0x%X", (uint) alGetError());
+	const Common::UString output = ConfigMan.getString("soundoutput", "openal");
 
-		_hasMultiChannel = alIsExtensionPresent("AL_EXT_MCFORMATS") != 0;
-		_format51        = alGetEnumValue("AL_FORMAT_51CHN16");
+	try {
+		if (output == "openal")
+			openDevice();
+		else
+			createMixer(output);
 
 		if (!createThread("SoundManager"))
 			throw Common::Exception("Failed to create sound thread: %s", SDL_GetError());
 
-		_hasSound = true;
+		_hasSound = !_mixer;
 
 	} catch (...) {
-		Common::exceptionDispatcherWarning("Failed to initialize OpenAL. Disabling sound output!");
+		Common::exceptionDispatcherWarning("Failed to initialize sound output \"%s\". Disabling sound output!",
+		                                   output.c_str());
+
+		_output.reset();
+		_mixer.reset();
 	}
 
 	_ready = true;
 
-	if (!_hasSound)
+	if (!_hasSound && !_mixer)
 		return;
 
+	_decoders.reset(new DecoderPool(kDecoderThreadCount));
+	_fillBuffer.reset(new int16[kOpenALBufferSize / 2]);
+
 	setListenerGain(ConfigMan.getDouble("volume", 1.0));
 
 	setTypeGain(kSoundTypeMusic, ConfigMan.getDouble("volume_music", 1.0));
@@ -130,7 +150,63 @@ void SoundManager::init() {
 	setTypeGain(kSoundTypeVoice, ConfigMan.getDouble("volume_voice", 1.0));
 	setTypeGain(kSoundTypeVideo, ConfigMan.getDouble("volume_video", 1.0));
 
-	alDistanceModel(AL_LINEAR_DISTANCE_CLAMPED);
+	if (_hasSound)
+		alDistanceModel(AL_LINEAR_DISTANCE_CLAMPED);
+}
+
+void SoundManager::openDevice() {
+	_dev = alcOpenDevice(0);
+	if (!_dev)
+		throw Common::Exception("Could not open OpenAL device");
+
+	_ctx = alcCreateContext(_dev, 0);
+	if (!_ctx)
+		throw Common::Exception("Could not create OpenAL context: 0x%X", (uint) alGetError());
+
+	alcMakeContextCurrent(_ctx);
+
+	ALenum error = alGetError();
+	if (error != AL_NO_ERROR)
+		throw Common::Exception("Could not use OpenAL context: 0x%X", (uint) alGetError());
+
+	_hasMultiChannel = alIsExtensionPresent("AL_EXT_MCFORMATS") != 0;
+	_format51        = alGetEnumValue("AL_FORMAT_51CHN16");
+}
+
+void SoundManager::closeDevice() {
+	if (_ctx) {
+		alcMakeContextCurrent(0);
+		alcDestroyContext(_ctx);
+	}
+
+	if (_dev)
+		alcCloseDevice(_dev);
+
+	_ctx = 0;
+	_dev = 0;
+}
+
+void SoundManager::createMixer(const Common::UString &output) {
+	_mixer.reset(new Mixer(kMixerRate));
+	_mixBuffer.reset(new int16[SoundOutput::kMaxFrames * 2]);
+
+	try {
+		if        (output == "mixer") {
+			openDevice();
+			_output.reset(new OpenALSoundOutput(kMixerRate));
+		} else if (output == "wav") {
+			_output.reset(new WAVSoundOutput(ConfigMan.getString("soundcapture"), kMixerRate));
+		} else if (output != "null")
+			throw Common::Exception("Unknown sound output \"%s\"", output.c_str());
+
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Failed to create the sound output. Mixing into the void instead");
+
+		closeDevice();
+	}
+
+	if (!_output)
+		_output.reset(new NullSoundOutput(kMixerRate));
 }
 
 void SoundManager::deinit() {
@@ -142,13 +218,15 @@ void SoundManager::deinit() {
 	for (size_t i = 0; i < kChannelCount; i++)
 		freeChannel(i);
 
-	if (_hasSound) {
-		alcMakeContextCurrent(0);
-		alcDestroyContext(_ctx);
-		alcCloseDevice(_dev);
-	}
+	_decoders.reset();
+
+	_output.reset();
+	_mixer.reset();
+
+	closeDevice();
 
-	_ready = false;
+	_hasSound = false;
+	_ready    = false;
 }
 
 bool SoundManager::ready() const {
@@ -187,6 +265,9 @@ bool SoundManager::isPlaying(size_t channel) const {
 	if ((channel >= kChannelCount) || !_channels[channel])
 		return false;
 
+	if (_mixer)
+		return !_mixer->isSourceFinished(_channels[channel]->mixerSource);
+
 	// TODO: This might pose a problem should we ever need to wait
 	//       for sounds to finish (for syncing, ...). We need to
 	//       add a way for audio streams to tell us how long they are
@@ -347,7 +428,20 @@ ChannelHandle SoundManager::playAudioStream(AudioStream *audStream, SoundType ty
 
 	const TypeList::iterator typeEndIt = _types[type].list.end();
 
-	_channels[handle.channel].reset(new Channel(handle.id, handle.channel, type, typeEndIt, audStream, disposeAfterUse));
+	if (_decoders) {
+		// Decode the stream ahead. Only the first chunk is decoded right now, so
+		// that we have data to buffer; the decoder pool takes care of the rest
+		DecodeAheadStream *decodeAhead = new DecodeAheadStream(audStream, disposeAfterUse, kDecodeAheadSize);
+
+		_channels[handle.channel].reset(new Channel(handle.id, handle.channel, type, typeEndIt, decodeAhead, true));
+		_channels[handle.channel]->decodeAhead = decodeAhead;
+
+		decodeAhead->seed();
+		_decoders->addStream(decodeAhead);
+
+	} else
+		_channels[handle.channel].reset(new Channel(handle.id, handle.channel, type, typeEndIt, audStream, disposeAfterUse));
+
 	Channel &channel = *_channels[handle.channel];
 
 	if (!channel.stream)
@@ -389,6 +483,12 @@ ChannelHandle SoundManager::playAudioStream(AudioStream *audStream, SoundType ty
 		alSourcei(channel.source, AL_SOURCE_RELATIVE, AL_TRUE);
 	}
 
+	if (_mixer) {
+		// Mixer sources are relative by default
+		channel.mixerSource = _mixer->addSource(channel.stream.get());
+		_mixer->setSourceGain(channel.mixerSource, _types[channel.type].gain);
+	}
+
 	// Add the channel to the correct type list
 	_types[channel.type].list.push_back(&channel);
 	channel.typeIt = --_types[channel.type].list.end();
@@ -456,6 +556,9 @@ void SoundManager::startChannel(ChannelHandle &handle) {
 
 	channel->state = AL_PLAYING;
 
+	if (_mixer)
+		_mixer->setSourcePlaying(channel->mixerSource, true);
+
 	debugC(Common::kDebugSound, 1, "Start sound channel %s", formatChannel(handle).c_str());
 
 	triggerUpdate();
@@ -512,7 +615,9 @@ void SoundManager::setListenerGain(float gain) {
 
 	std::lock_guard<std::recursive_mutex> lock(_mutex);
 
-	if (_hasSound)
+	if (_mixer)
+		_mixer->setListenerGain(gain);
+	else if (_hasSound)
 		alListenerf(AL_GAIN, gain);
 }
 
@@ -521,7 +626,10 @@ void SoundManager::setListenerPosition(float x, float y, float z) {
 
 	std::lock_guard<std::recursive_mutex> lock(_mutex);
 
-	alListener3f(AL_POSITION, x, y, z);
+	if (_mixer)
+		_mixer->setListenerPosition(x, y, z);
+	else
+		alListener3f(AL_POSITION, x, y, z);
 }
 
 void SoundManager::setListenerOrientation(float dirX, float dirY, float dirZ, float upX, float upY, float upZ) {
@@ -529,6 +637,11 @@ void SoundManager::setListenerOrientation(float dirX, float dirY, float dirZ, fl
 
 	std::lock_guard<std::recursive_mutex> lock(_mutex);
 
+	if (_mixer) {
+		_mixer->setListenerOrientation(dirX, dirY, dirZ, upX, upY, upZ);
+		return;
+	}
+
 	float orientation[] = {dirX, dirY, dirZ, upX, upY, upZ};
 	alListenerfv(AL_ORIENTATION, orientation);
 }
@@ -544,7 +657,9 @@ void SoundManager::setChannelPosition(const ChannelHandle &handle, float x, floa
 		throw Common::Exception("Cannot set position of a non-mono sound in %s",
 		                        formatChannel(handle).c_str());
 
-	if (_hasSound)
+	if (_mixer)
+		_mixer->setSourcePosition(channel->mixerSource, x, y, z);
+	else if (_hasSound)
 		alSource3f(channel->source, AL_POSITION, x, y, z);
 }
 
@@ -559,7 +674,9 @@ void SoundManager::getChannelPosition(const ChannelHandle &handle, float &x, flo
 		throw Common::Exception("Cannot get position of a non-mono sound in %s",
 		                        formatChannel(handle).c_str());
 
-	if (_hasSound)
+	if (_mixer)
+		_mixer->getSourcePosition(channel->mixerSource, x, y, z);
+	else if (_hasSound)
 		alGetSource3f(channel->source, AL_POSITION, &x, &y, &z);
 }
 
@@ -572,7 +689,9 @@ void SoundManager::setChannelGain(const ChannelHandle &handle, float gain) {
 
 	channel->gain = gain;
 
-	if (_hasSound)
+	if (_mixer)
+		_mixer->setSourceGain(channel->mixerSource, _types[channel->type].gain * gain);
+	else if (_hasSound)
 		alSourcef(channel->source, AL_GAIN, _types[channel->type].gain * gain);
 }
 
@@ -583,7 +702,9 @@ void SoundManager::setChannelPitch(const ChannelHandle &handle, float pitch) {
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
-	if (_hasSound)
+	if (_mixer)
+		_mixer->setSourcePitch(channel->mixerSource, pitch);
+	else if (_hasSound)
 		alSourcef(channel->source, AL_PITCH, pitch);
 }
 
@@ -594,7 +715,9 @@ void SoundManager::setChannelRelative(const ChannelHandle &handle, bool relative
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
-	if (_hasSound)
+	if (_mixer)
+		_mixer->setSourceRelative(channel->mixerSource, relative);
+	else if (_hasSound)
 		alSourcei(channel->source, AL_SOURCE_RELATIVE, relative ? AL_TRUE : AL_FALSE);
 }
 
@@ -605,7 +728,9 @@ void SoundManager::setChannelDistance(const ChannelHandle &handle, float minDist
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
-	if (_hasSound) {
+	if (_mixer)
+		_mixer->setSourceDistance(channel->mixerSource, minDistance, maxDistance);
+	else if (_hasSound) {
 		alSourcef(channel->source, AL_REFERENCE_DISTANCE, minDistance);
 		alSourcef(channel->source, AL_MAX_DISTANCE, maxDistance);
 	}
@@ -618,6 +743,9 @@ uint64 SoundManager::getChannelSamplesPlayed(const ChannelHandle &handle) {
 	if (!channel || !channel->stream)
 		return 0;
 
+	if (_mixer)
+		return _mixer->getSourceSamplesPlayed(channel->mixerSource);
+
 	// Update the queued/unqueued buffers to make sure the channel is up-to-date
 	bufferData(*channel);
 
@@ -632,6 +760,16 @@ uint64 SoundManager::getChannelSamplesPlayed(const ChannelHandle &handle) {
 	return byteCount / channel->stream->getChannels() / 2;
 }
 
+uint32 SoundManager::getChannelUnderruns(const ChannelHandle &handle) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	Channel *channel = getChannel(handle);
+	if (!channel || !channel->decodeAhead)
+		return 0;
+
+	return channel->decodeAhead->getUnderruns();
+}
+
 uint64 SoundManager::getChannelDurationPlayed(const ChannelHandle &handle) {
 	std::lock_guard<std::recursive_mutex> lock(_mutex);
 
@@ -654,13 +792,15 @@ void SoundManager::setTypeGain(SoundType type, float gain) {
 	for (TypeList::iterator t = _types[type].list.begin(); t != _types[type].list.end(); ++t) {
 		assert(*t);
 
-		if (_hasSound)
+		if (_mixer)
+			_mixer->setSourceGain((*t)->mixerSource, (*t)->gain * gain);
+		else if (_hasSound)
 			alSourcef((*t)->source, AL_GAIN, (*t)->gain * gain);
 	}
 }
 
 bool SoundManager::fillBuffer(const Channel &channel, ALuint alBuffer,
-                              AudioStream *stream, ALsizei &bufferedSize) const {
+                              AudioStream *stream, ALsizei &bufferedSize) {
 
 	bufferedSize = 0;
 
@@ -698,17 +838,18 @@ bool SoundManager::fillBuffer(const Channel &channel, ALuint alBuffer,
 	// Read in the required amount of samples
 	size_t numSamples = kOpenALBufferSize / 2;
 
-	Common::ScopedArray<byte> buffer(new byte[kOpenALBufferSize]);
-	std::memset(buffer.get(), 0, kOpenALBufferSize);
-
-	numSamples = stream->readBuffer(reinterpret_cast<int16 *>(buffer.get()), numSamples);
+	numSamples = stream->readBuffer(_fillBuffer.get(), numSamples);
 	if (numSamples == AudioStream::kSizeInvalid) {
 		warning("Failed reading from stream while filling buffer in %s", formatChannel(&channel).c_str());
 		return false;
 	}
 
+	// Nothing decoded yet, try again later
+	if (numSamples == 0)
+		return false;
+
 	bufferedSize = numSamples * 2;
-	alBufferData(alBuffer, format, buffer.get(), bufferedSize, stream->getRate());
+	alBufferData(alBuffer, format, _fillBuffer.get(), bufferedSize, stream->getRate());
 
 	ALenum error = alGetError();
 	if (error != AL_NO_ERROR) {
@@ -802,9 +943,26 @@ void SoundManager::update() {
 		bufferData(i);
 	}
 
+	mixOutput();
+
 	debugC(Common::kDebugSound, 9, "Active sound channel: %s", Common::composeString(channelCount).c_str());
 }
 
+void SoundManager::mixOutput() {
+	if (!_mixer || !_output)
+		return;
+
+	size_t frames = _output->getFreeFrames();
+	while (frames > 0) {
+		const size_t n = MIN(frames, SoundOutput::kMaxFrames);
+
+		_mixer->mix(_mixBuffer.get(), n);
+		_output->write(_mixBuffer.get(), n);
+
+		frames -= n;
+	}
+}
+
 ChannelHandle SoundManager::newChannel() {
 	size_t foundChannel = kChannelInvalid;
 
@@ -844,6 +1002,9 @@ void SoundManager::pauseChannel(Channel *channel, bool pause) {
 	} else
 		channel->state = AL_PLAYING;
 
+	if (_mixer)
+		_mixer->setSourcePlaying(channel->mixerSource, !pause);
+
 	triggerUpdate();
 }
 
@@ -877,6 +1038,12 @@ void SoundManager::freeChannel(size_t channel) {
 		// Nothing to do
 		return;
 
+	// Remove the channel from the mixer and the decoders before its stream goes away
+	if (_mixer)
+		_mixer->removeSource(c->mixerSource);
+	if (_decoders && c->decodeAhead)
+		_decoders->removeStream(c->decodeAhead);
+
 	// Discard the stream
 	c->stream.reset();
 
@@ -901,8 +1068,11 @@ void SoundManager::freeChannel(size_t channel) {
 void SoundManager::threadMethod() {
 	while (!_killThread.load(std::memory_order_relaxed)) {
 		update();
+
+		const int interval = _mixer ? kMixerUpdateInterval : 100;
+
 		std::unique_lock<std::recursive_mutex> lock(_needUpdateMutex);
-		_needUpdate.wait_for(lock, std::chrono::duration<int, std::milli>(100));
+		_needUpdate.wait_for(lock, std::chrono::duration<int, std::milli>(interval));
 	}
 }
 
@@ -55,8 +55,27 @@ namespace Common {
 namespace Sound {
 
 class AudioStream;
+class Mixer;
+class SoundOutput;
+class DecodeAheadStream;
+class DecoderPool;
 
-/** The sound manager. */
+/** The sound manager.
+ *
+ *  By default, every channel is played through its own OpenAL source.
+ *  Alternatively, the config option "soundoutput" can select the
+ *  software mixer, which mixes all channels into one output:
+ *
+ *  - "openal": One OpenAL source per channel (default)
+ *  - "mixer":  Software mixer, played through a single OpenAL source
+ *  - "null":   Software mixer, discarding the sound
+ *  - "wav":    Software mixer, writing into the WAVE file "soundcapture"
+ *
+ *  The last two do not need an audio device at all.
+ *
+ *  While sound output works, all streams are decoded ahead of playback
+ *  by a small pool of decoder threads.
+ */
 class SoundManager : public Common::Singleton<SoundManager>, public Common::Thread {
 public:
 	SoundManager();
@@ -88,6 +107,9 @@ public:
 	uint64 getChannelSamplesPlayed(const ChannelHandle &handle);
 	/** Return the time this channel has already played in milliseconds. */
 	uint64 getChannelDurationPlayed(const ChannelHandle &handle);
+
+	/** Return how often this channel wanted to play sound that wasn't decoded yet. */
+	uint32 getChannelUnderruns(const ChannelHandle &handle);
 	// '---
 
 	// .--- Playing sounds
@@ -207,8 +229,13 @@ private:
 
 		Common::DisposablePtr<AudioStream> stream;  ///< The actual audio stream.
 
+		/** The stream decoding the audio stream ahead, if any. Owned by stream. */
+		DecodeAheadStream *decodeAhead;
+
 		ALuint source; ///< OpenAL source for this channel.
 
+		size_t mixerSource; ///< Software mixer source for this channel.
+
 		std::list<ALuint> buffers;     ///< List of buffers for that channel.
 		std::list<ALuint> freeBuffers; ///< List of free buffers not filled with data.
 
@@ -227,7 +254,7 @@ private:
 
 	bool _ready; ///< Was the sound subsystem successfully initialized?
 
-	bool _hasSound; ///< Do we have working sound output?
+	bool _hasSound; ///< Do we have working OpenAL output, with one source per channel?
 
 	bool _hasMultiChannel; ///< Do we have the multi-channel extension?
 	ALenum _format51; ///< The value for the 5.1 multi-channel format.
@@ -246,9 +273,29 @@ private:
 	ALCdevice *_dev;
 	ALCcontext *_ctx;
 
+	Common::ScopedPtr<Mixer>       _mixer;  ///< The software mixer, if we use it.
+	Common::ScopedPtr<SoundOutput> _output; ///< The output the software mixer feeds.
+
+	Common::ScopedArray<int16> _mixBuffer; ///< Buffer for the output of the software mixer.
+
+	Common::ScopedPtr<DecoderPool> _decoders; ///< The threads decoding the streams ahead.
+
+	/** Buffer for moving samples into OpenAL buffers. */
+	Common::ScopedArray<int16> _fillBuffer;
+
 	/** Check that the SoundManager was properly initialized. */
 	void checkReady();
 
+	/** Open the OpenAL device and create a context. */
+	void openDevice();
+	/** Destroy the OpenAL context and close the device. */
+	void closeDevice();
+
+	/** Create the software mixer and the output it feeds. */
+	void createMixer(const Common::UString &output);
+	/** Mix as much sound as the output of the software mixer needs. */
+	void mixOutput();
+
 	/** Update the sound information. Called regularly from within the thread method. */
 	void update();
 
@@ -282,7 +329,7 @@ private:
 
 	/** Fill the buffer with data from the audio stream. */
 	bool fillBuffer(const Channel &channel, ALuint alBuffer,
-	                AudioStream *stream, ALsizei &bufferedSize) const;
+	                AudioStream *stream, ALsizei &bufferedSize);
 
 	/** Return a string representing this channel. */
 	Common::UString formatChannel(const Channel *channel) const;
@@ -0,0 +1,136 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The data of a sound bank, shared between all sounds read from it.
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/strutil.h"
+#include "src/common/memreadstream.h"
+
+#include "src/sound/soundbankdata.h"
+
+namespace Sound {
+
+SoundBankData::SoundBankData(Common::SeekableReadStream *bank) : _bank(bank), _data(0), _size(0) {
+	assert(_bank);
+
+	_size = _bank->size();
+
+	/* A bank from an archive usually already sits in memory completely,
+	 * so we can read straight from there. */
+	Common::MemoryReadStream *memBank = dynamic_cast<Common::MemoryReadStream *>(_bank.get());
+	if (memBank)
+		_data = memBank->getData();
+}
+
+SoundBankData::~SoundBankData() {
+}
+
+size_t SoundBankData::size() const {
+	return _size;
+}
+
+bool SoundBankData::isInMemory() const {
+	return _data != 0;
+}
+
+size_t SoundBankData::read(size_t offset, void *dataPtr, size_t dataSize) const {
+	if (offset >= _size)
+		return 0;
+
+	dataSize = MIN(dataSize, _size - offset);
+
+	if (_data) {
+		std::memcpy(dataPtr, _data + offset, dataSize);
+		return dataSize;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_bank->seek(offset);
+	return _bank->read(dataPtr, dataSize);
+}
+
+
+SoundBankReadStream::SoundBankReadStream(const std::shared_ptr<const SoundBankData> &bank,
+                                         size_t offset, size_t size) :
+	_bank(bank), _offset(offset), _size(size), _pos(0), _eos(false) {
+
+	assert(_bank);
+
+	if ((_offset > _bank->size()) || (_size > (_bank->size() - _offset)))
+		throw Common::Exception("SoundBankReadStream: Part (%s, %s) out of bank range (%s)",
+		                        Common::composeString(_offset).c_str(),
+		                        Common::composeString(_size).c_str(),
+		                        Common::composeString(_bank->size()).c_str());
+}
+
+SoundBankReadStream::~SoundBankReadStream() {
+}
+
+size_t SoundBankReadStream::read(void *dataPtr, size_t dataSize) {
+	assert(_pos <= _size);
+
+	const size_t toRead = MIN(dataSize, _size - _pos);
+
+	const size_t bytesRead = _bank->read(_offset + _pos, dataPtr, toRead);
+
+	_pos += bytesRead;
+	if (bytesRead < dataSize)
+		_eos = true;
+
+	return bytesRead;
+}
+
+bool SoundBankReadStream::eos() const {
+	return _eos;
+}
+
+size_t SoundBankReadStream::pos() const {
+	return _pos;
+}
+
+size_t SoundBankReadStream::size() const {
+	return _size;
+}
+
+size_t SoundBankReadStream::seek(ptrdiff_t offset, Origin whence) {
+	assert(_pos <= _size);
+
+	const size_t oldPos = _pos;
+	const size_t newPos = evalSeek(offset, whence, _pos, 0, _size);
+	if (newPos > _size)
+		throw Common::Exception(Common::kSeekError);
+
+	_pos = newPos;
+
+	// Reset end-of-stream flag on a successful seek
+	_eos = false;
+
+	return oldPos;
+}
+
+} // End of namespace Sound
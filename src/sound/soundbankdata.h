@@ -0,0 +1,105 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The data of a sound bank, shared between all sounds read from it.
+ */
+
+#ifndef SOUND_SOUNDBANKDATA_H
+#define SOUND_SOUNDBANKDATA_H
+
+#include <memory>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/readstream.h"
+#include "src/common/mutex.h"
+
+namespace Sound {
+
+/** The complete data of a sound bank file.
+ *
+ *  If the bank is already in memory, reading from it only copies
+ *  out of that memory. Otherwise, the bank is read from its stream
+ *  on demand.
+ *
+ *  Reading is thread-safe, so sounds from the same bank can be
+ *  decoded in different threads.
+ */
+class SoundBankData : boost::noncopyable {
+public:
+	/** Take over this stream of a whole sound bank. */
+	SoundBankData(Common::SeekableReadStream *bank);
+	~SoundBankData();
+
+	/** Return the size of the bank in bytes. */
+	size_t size() const;
+
+	/** Is the whole bank in memory? */
+	bool isInMemory() const;
+
+	/** Read from the bank, starting at this offset. Returns the number of bytes read. */
+	size_t read(size_t offset, void *dataPtr, size_t dataSize) const;
+
+private:
+	std::unique_ptr<Common::SeekableReadStream> _bank;
+
+	const byte *_data; ///< The bank data, if the bank is in memory.
+	size_t _size;
+
+	/** Protects the bank stream, when it isn't in memory. */
+	mutable std::mutex _mutex;
+};
+
+/** A stream over a part of a sound bank.
+ *
+ *  Reads directly from the shared bank data, without copying the
+ *  whole part first. Keeps the bank data alive for as long as
+ *  the stream exists.
+ */
+class SoundBankReadStream : public Common::SeekableReadStream {
+public:
+	SoundBankReadStream(const std::shared_ptr<const SoundBankData> &bank, size_t offset, size_t size);
+	~SoundBankReadStream();
+
+	size_t read(void *dataPtr, size_t dataSize);
+
+	bool eos() const;
+
+	size_t pos() const;
+	size_t size() const;
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
+
+private:
+	std::shared_ptr<const SoundBankData> _bank;
+
+	size_t _offset;
+	size_t _size;
+
+	size_t _pos;
+
+	bool _eos;
+};
+
+} // End of namespace Sound
+
+#endif // SOUND_SOUNDBANKDATA_H
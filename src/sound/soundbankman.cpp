@@ -0,0 +1,84 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The global sound bank manager, keeping sound banks loaded.
+ */
+
+#include "src/sound/soundbankman.h"
+#include "src/sound/wwisesoundbank.h"
+#include "src/sound/fmodsamplebank.h"
+#include "src/sound/xactwavebank.h"
+
+DECLARE_SINGLETON(Sound::SoundBankManager)
+
+namespace Sound {
+
+/** Find a bank in this map, or load it with the loader function and remember it. */
+template<typename Bank, typename Loader>
+static std::shared_ptr<const Bank> getBank(std::map<Common::UString, std::shared_ptr<const Bank> > &banks,
+                                           const Common::UString &name, Loader load) {
+
+	// Resource names aren't case-sensitive
+	const Common::UString key = name.toLower();
+
+	typename std::map<Common::UString, std::shared_ptr<const Bank> >::const_iterator bank = banks.find(key);
+	if (bank != banks.end())
+		return bank->second;
+
+	std::shared_ptr<const Bank> loaded(load(name));
+
+	banks.insert(std::make_pair(key, loaded));
+	return loaded;
+}
+
+SoundBankManager::SoundBankManager() {
+}
+
+SoundBankManager::~SoundBankManager() {
+}
+
+void SoundBankManager::clear() {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	_wwiseBanks.clear();
+	_fmodBanks.clear();
+	_xactBanks.clear();
+}
+
+std::shared_ptr<const WwiseSoundBank> SoundBankManager::getWwiseSoundBank(const Common::UString &name) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	return getBank(_wwiseBanks, name, [](const Common::UString &n) { return new WwiseSoundBank(n); });
+}
+
+std::shared_ptr<const FMODSampleBank> SoundBankManager::getFMODSampleBank(const Common::UString &name) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	return getBank(_fmodBanks, name, [](const Common::UString &n) { return new FMODSampleBank(n); });
+}
+
+std::shared_ptr<const XACTWaveBank> SoundBankManager::getXACTWaveBank(const Common::UString &name) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	return getBank(_xactBanks, name, [](const Common::UString &n) { return XACTWaveBank::load(n); });
+}
+
+} // End of namespace Sound
@@ -0,0 +1,83 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The global sound bank manager, keeping sound banks loaded.
+ */
+
+#ifndef SOUND_SOUNDBANKMAN_H
+#define SOUND_SOUNDBANKMAN_H
+
+#include <memory>
+#include <map>
+
+#include "src/common/types.h"
+#include "src/common/singleton.h"
+#include "src/common/ustring.h"
+#include "src/common/mutex.h"
+
+namespace Sound {
+
+class WwiseSoundBank;
+class FMODSampleBank;
+class XACTWaveBank;
+
+/** The global sound bank manager.
+ *
+ *  Sound banks are loaded and have their index parsed only once, the
+ *  first time they're requested. After that, every request for the
+ *  same bank shares the already loaded one.
+ *
+ *  The banks are kept until clear() is called, which should happen
+ *  whenever the available resources change.
+ */
+class SoundBankManager : public Common::Singleton<SoundBankManager> {
+public:
+	SoundBankManager();
+	~SoundBankManager();
+
+	/** Forget all loaded sound banks. */
+	void clear();
+
+	/** Return the Wwise SoundBank (BNK) with this name, loading it if necessary. */
+	std::shared_ptr<const WwiseSoundBank> getWwiseSoundBank(const Common::UString &name);
+	/** Return the FMOD SampleBank (FSB) with this name, loading it if necessary. */
+	std::shared_ptr<const FMODSampleBank> getFMODSampleBank(const Common::UString &name);
+	/** Return the XACT WaveBank (XWB) with this name, loading it if necessary. */
+	std::shared_ptr<const XACTWaveBank> getXACTWaveBank(const Common::UString &name);
+
+private:
+	typedef std::map<Common::UString, std::shared_ptr<const WwiseSoundBank> > WwiseBanks;
+	typedef std::map<Common::UString, std::shared_ptr<const FMODSampleBank> > FMODBanks;
+	typedef std::map<Common::UString, std::shared_ptr<const XACTWaveBank> >   XACTBanks;
+
+	WwiseBanks _wwiseBanks;
+	FMODBanks  _fmodBanks;
+	XACTBanks  _xactBanks;
+
+	std::recursive_mutex _mutex;
+};
+
+} // End of namespace Sound
+
+/** Shortcut for accessing the sound bank manager. */
+#define SoundBankMan ::Sound::SoundBankManager::instance()
+
+#endif // SOUND_SOUNDBANKMAN_H
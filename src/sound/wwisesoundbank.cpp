@@ -37,34 +37,42 @@
 #include "src/aurora/resman.h"
 
 #include "src/sound/wwisesoundbank.h"
+#include "src/sound/soundbankdata.h"
+#include "src/sound/soundbankman.h"
 #include "src/sound/audiostream.h"
 
 #include "src/sound/decoders/wwriffvorbis.h"
 
 namespace Sound {
 
-WwiseSoundBank::WwiseSoundBank(Common::SeekableReadStream *bnk) : _bnk(bnk), _bankID(0),
-		_dataOffset(SIZE_MAX) {
+WwiseSoundBank::WwiseSoundBank(Common::SeekableReadStream *bnk) : _bankID(0), _dataOffset(SIZE_MAX) {
+	assert(bnk);
 
-	assert(_bnk);
-
-	load(*_bnk);
+	open(bnk);
 }
 
 WwiseSoundBank::WwiseSoundBank(const Common::UString &name) : _bankID(0), _dataOffset(SIZE_MAX) {
-	_bnk.reset(ResMan.getResource(name, Aurora::kFileTypeBNK));
-	if (!_bnk)
+	Common::SeekableReadStream *bnk = ResMan.getResource(name, Aurora::kFileTypeBNK);
+	if (!bnk)
 		throw Common::Exception("No such BNK resource \"%s\"", name.c_str());
 
-	load(*_bnk);
+	open(bnk);
 }
 
 WwiseSoundBank::WwiseSoundBank(uint64 hash) : _bankID(0), _dataOffset(SIZE_MAX) {
-	_bnk.reset(ResMan.getResource(hash));
-	if (!_bnk)
+	Common::SeekableReadStream *bnk = ResMan.getResource(hash);
+	if (!bnk)
 		throw Common::Exception("No such BNK resource \"%s\"", Common::formatHash(hash).c_str());
 
-	load(*_bnk);
+	open(bnk);
+}
+
+void WwiseSoundBank::open(Common::SeekableReadStream *bnk) {
+	std::unique_ptr<Common::SeekableReadStream> stream(bnk);
+
+	load(*stream);
+
+	_data = std::make_shared<const SoundBankData>(stream.release());
 }
 
 size_t WwiseSoundBank::getFileCount() const {
@@ -153,9 +161,7 @@ Common::SeekableReadStream *WwiseSoundBank::getFileData(size_t index) const {
 	if (_dataOffset == SIZE_MAX)
 		throw Common::Exception("WwiseSoundBank::getFileData(): No data offset");
 
-	_bnk->seek(_dataOffset + file.offset);
-
-	return _bnk->readStream(file.size);
+	return new SoundBankReadStream(_data, _dataOffset + file.offset, file.size);
 }
 
 Common::SeekableReadStream *WwiseSoundBank::getSoundData(size_t index) const {
@@ -177,9 +183,7 @@ Common::SeekableReadStream *WwiseSoundBank::getSoundData(size_t index) const {
 	if (sound.fileSource == _bankID) {
 		// Sound file is embedded in this bank
 
-		_bnk->seek(sound.fileOffset);
-
-		return _bnk->readStream(sound.fileSize);
+		return new SoundBankReadStream(_data, sound.fileOffset, sound.fileSize);
 	}
 
 	// Sound file is embedded in another bank
@@ -190,15 +194,18 @@ Common::SeekableReadStream *WwiseSoundBank::getSoundData(size_t index) const {
 		                        "without a bank name", Common::composeString(index).c_str(),
 		                        sound.id, sound.fileID, sound.fileSource);
 
-	std::unique_ptr<Common::SeekableReadStream> bank(ResMan.getResource(bankName->second, Aurora::kFileTypeBNK));
-	if (!bank)
-		throw Common::Exception("WwiseSoundBank::getSoundData(): Bank \"%s\" for externally embedded file "
-		                        "(%s, %u, %u) does not exist", bankName->second.c_str(),
-		                        Common::composeString(index).c_str(), sound.id, sound.fileID);
-
-	bank->seek(sound.fileOffset);
+	// The other bank stays loaded, so playing its sounds again doesn't re-read it
+	std::shared_ptr<const WwiseSoundBank> bank;
+	try {
+		bank = SoundBankMan.getWwiseSoundBank(bankName->second);
+	} catch (Common::Exception &e) {
+		e.add("WwiseSoundBank::getSoundData(): Bank \"%s\" for externally embedded file (%s, %u, %u) "
+		      "failed to load", bankName->second.c_str(), Common::composeString(index).c_str(),
+		      sound.id, sound.fileID);
+		throw;
+	}
 
-	return bank->readStream(sound.fileSize);
+	return new SoundBankReadStream(bank->_data, sound.fileOffset, sound.fileSize);
 }
 
 static constexpr uint32 kSectionBankHeader  = MKTAG('B', 'K', 'H', 'D');
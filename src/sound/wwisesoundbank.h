@@ -35,6 +35,7 @@
 namespace Sound {
 
 class RewindableAudioStream;
+class SoundBankData;
 
 /** Class to hold audio resources and information of a Wwise soundbank file.
  *
@@ -101,7 +102,8 @@ private:
 		size_t fileSize;
 	};
 
-	std::unique_ptr<Common::SeekableReadStream> _bnk;
+	/** The whole bank, which the sound streams read from. */
+	std::shared_ptr<const SoundBankData> _data;
 
 	uint32 _bankID;
 	size_t _dataOffset;
@@ -115,6 +117,8 @@ private:
 	std::map<uint32, size_t> _soundIDs;
 
 
+	/** Take over this stream, load the bank's index and keep its data. */
+	void open(Common::SeekableReadStream *bnk);
 	void load(Common::SeekableReadStream &bnk);
 
 	const File &getFileStruct(size_t index) const;
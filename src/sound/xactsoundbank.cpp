@@ -29,6 +29,7 @@
 #include "src/sound/xactsoundbank.h"
 #include "src/sound/xactsoundbank_ascii.h"
 #include "src/sound/xactsoundbank_binary.h"
+#include "src/sound/soundbankman.h"
 #include "src/sound/audiostream.h"
 #include "src/sound/sound.h"
 
@@ -262,7 +263,7 @@ const XACTWaveBank &XACTSoundBank::getWaveBank(const Common::UString &name) {
 		throw Common::Exception("XACTSoundBank::getWaveBank(): Don't know wave bank \"%s\"", name.c_str());
 
 	if (!bank->second->bank)
-		bank->second->bank.reset(XACTWaveBank::load(name));
+		bank->second->bank = SoundBankMan.getXACTWaveBank(name);
 
 	return *bank->second->bank.get();
 }
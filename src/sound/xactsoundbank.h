@@ -200,7 +200,7 @@ protected:
 	struct WaveBank {
 		Common::UString name; ///< File name, without extension.
 
-		std::unique_ptr<XACTWaveBank> bank;
+		std::shared_ptr<const XACTWaveBank> bank;
 
 		WaveBank(const Common::UString &n = "") : name(n) { }
 	};
@@ -58,6 +58,7 @@
 #include "src/common/memreadstream.h"
 
 #include "src/sound/xactwavebank_binary.h"
+#include "src/sound/soundbankdata.h"
 
 #include "src/sound/decoders/pcm.h"
 #include "src/sound/decoders/adpcm.h"
@@ -76,10 +77,14 @@ static constexpr uint32 kWaveFlagsLoopCache      = 0x00000002; ///< Audio file i
 static constexpr uint32 kWaveFlagsRemoveLoopTail = 0x00000004; ///< Ignore the data after the looping section.
 static constexpr uint32 kWaveFlagsIgnoreLoop     = 0x00000008; ///< Don't loop this sound.
 
-XACTWaveBank_Binary::XACTWaveBank_Binary(Common::SeekableReadStream *xwb) : _xwb(xwb) {
-	assert(_xwb);
+XACTWaveBank_Binary::XACTWaveBank_Binary(Common::SeekableReadStream *xwb) {
+	assert(xwb);
 
-	load(*_xwb);
+	std::unique_ptr<Common::SeekableReadStream> stream(xwb);
+
+	load(*stream);
+
+	_data = std::make_shared<const SoundBankData>(stream.release());
 }
 
 bool XACTWaveBank_Binary::isStreaming() const {
@@ -98,8 +103,7 @@ RewindableAudioStream *XACTWaveBank_Binary::getWave(size_t index) const {
 
 	const Wave &wave = _waves[index];
 
-	_xwb->seek(wave.offset);
-	std::unique_ptr<Common::SeekableReadStream> dataStream(_xwb->readStream(wave.size));
+	std::unique_ptr<Common::SeekableReadStream> dataStream(new SoundBankReadStream(_data, wave.offset, wave.size));
 
 	switch (wave.codec) {
 		case Codec::PCM:
@@ -108,7 +112,7 @@ RewindableAudioStream *XACTWaveBank_Binary::getWave(size_t index) const {
 			                     wave.channels);
 
 		case Codec::ADPCM:
-			return makeADPCMStream(dataStream.release(), true, dataStream->size(),
+			return makeADPCMStream(dataStream.release(), true, wave.size,
 			                       kADPCMXbox, wave.samplingRate,  wave.channels);
 
 		case Codec::WMA:
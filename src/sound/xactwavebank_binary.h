@@ -35,6 +35,8 @@
 
 namespace Sound {
 
+class SoundBankData;
+
 /** Class to hold audio resource data of an XWB wavebank file.
  *
  *  An XWB file is a wavebank, i.e. an archive containing one or more
@@ -101,7 +103,8 @@ private:
 	using Waves = std::vector<Wave>;
 
 
-	std::unique_ptr<Common::SeekableReadStream> _xwb;
+	/** The whole bank, which the wave streams read from. */
+	std::shared_ptr<const SoundBankData> _data;
 
 	Common::UString _name; ///< The internal name of this wavebank. */
 	uint32 _flags;
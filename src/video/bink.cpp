@@ -79,6 +79,8 @@
 #include "src/common/strutil.h"
 #include "src/common/readstream.h"
 #include "src/common/bitstream.h"
+#include "src/common/membitstream.h"
+#include "src/common/threads.h"
 #include "src/common/huffman.h"
 #include "src/common/rdft.h"
 #include "src/common/dct.h"
@@ -93,6 +95,7 @@
 
 #include "src/video/bink.h"
 #include "src/video/binkdata.h"
+#include "src/video/binkdsp.h"
 
 static const uint32 kBIKfID = MKTAG('B', 'I', 'K', 'f');
 static const uint32 kBIKgID = MKTAG('B', 'I', 'K', 'g');
@@ -131,6 +134,9 @@ Bink::BinkVideoTrack::Bundle::Bundle() : countLength(0), dataEnd(0), curDec(0),
 	countLengths[0] = countLengths[1] = 0;
 }
 
+Bink::BinkVideoTrack::PlaneBlocks::PlaneBlocks() : pitch(0) {
+}
+
 
 Bink::VideoFrame::VideoFrame() : bits(0) {
 }
@@ -180,12 +186,12 @@ void Bink::decodeNextTrackFrame(VideoTrack &track) {
 		frameSize -= audioPacketLength;
 	}
 
-	size_t videoPacketStart = _bink->pos();
-	size_t videoPacketEnd   = _bink->pos() + frameSize;
+	// Read the whole video packet, so that the bit stream can work directly on memory
+	_videoPacket.resize(frameSize);
+	if ((frameSize > 0) && (_bink->read(&_videoPacket[0], frameSize) != frameSize))
+		throw Common::Exception(Common::kReadError);
 
-	frame.bits =
-		new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink.get(),
-		    videoPacketStart, videoPacketEnd), true);
+	frame.bits = new Common::MemoryBitStream32LELSB(_videoPacket.empty() ? 0 : &_videoPacket[0], frameSize);
 
 	assert(_surface);
 	videoTrack.decodePacket(*_surface, frame);
@@ -203,11 +209,19 @@ void Bink::checkAudioBuffer(AudioTrack &track, const Common::Timestamp &endTime)
 void Bink::BinkVideoTrack::decodePacket(Graphics::Surface &surface, VideoFrame &video) {
 	assert(video.bits);
 
+	/* The planes are stored one after the other, so we have to decode them in
+	 * order. But once a plane is decoded into a list of blocks, rendering these
+	 * blocks is independent of everything else. So we first decode all planes,
+	 * and then render them in parallel. */
+	int planes[4];
+	size_t planeCount = 0;
+
 	if (_hasAlpha) {
 		if (_id == kBIKiID)
 			video.bits->skip(32);
 
 		decodePlane(video, 3, false);
+		planes[planeCount++] = 3;
 	}
 
 	if (_id == kBIKiID)
@@ -217,11 +231,16 @@ void Bink::BinkVideoTrack::decodePacket(Graphics::Surface &surface, VideoFrame &
 		int planeIdx = ((i == 0) || !_swapPlanes) ? i : (i ^ 3);
 
 		decodePlane(video, planeIdx, i != 0);
+		planes[planeCount++] = planeIdx;
 
 		if (video.bits->pos() >= video.bits->size())
 			break;
 	}
 
+	Common::runParallel(planeCount, [this, &planes](size_t i) {
+		renderPlane(planes[i]);
+	});
+
 	// Convert the YUVA data we have to BGRA
 	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
 	YUVToRGBMan.convert420(Graphics::YUVToRGBManager::kScaleITU,
@@ -252,14 +271,15 @@ void Bink::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isC
 	ctx.prevEnd   = _oldPlanes[planeIdx].get() + width * height;
 	ctx.pitch     = width;
 
-	for (int i = 0; i < 64; i++) {
-		ctx.coordMap[i] = (i & 7) + (i >> 3) * ctx.pitch;
+	PlaneBlocks &blocks = _planeBlocks[planeIdx];
 
-		ctx.coordScaledMap1[i] = ((i & 7) * 2 + 0) + (((i >> 3) * 2 + 0) * ctx.pitch);
-		ctx.coordScaledMap2[i] = ((i & 7) * 2 + 1) + (((i >> 3) * 2 + 0) * ctx.pitch);
-		ctx.coordScaledMap3[i] = ((i & 7) * 2 + 0) + (((i >> 3) * 2 + 1) * ctx.pitch);
-		ctx.coordScaledMap4[i] = ((i & 7) * 2 + 1) + (((i >> 3) * 2 + 1) * ctx.pitch);
-	}
+	blocks.pitch = width;
+
+	blocks.ops.clear();
+	blocks.coeffs.clear();
+	blocks.pixels.clear();
+
+	blocks.ops.reserve(blockWidth * blockHeight);
 
 	for (int i = 0; i < kSourceMAX; i++) {
 		_bundles[i].countLength = _bundles[i].countLengths[isChroma ? 1 : 0];
@@ -346,6 +366,71 @@ void Bink::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isC
 
 }
 
+static inline void copyBlock(byte *dest, uint32 destPitch, const byte *src, uint32 srcPitch) {
+	for (int j = 0; j < 8; j++, dest += destPitch, src += srcPitch)
+		std::memcpy(dest, src, 8);
+}
+
+void Bink::BinkVideoTrack::renderPlane(int planeIdx) {
+	const PlaneBlocks &blocks = _planeBlocks[planeIdx];
+
+	byte       *dest  = _curPlanes[planeIdx].get();
+	const byte *prev  = _oldPlanes[planeIdx].get();
+	const uint32 pitch = blocks.pitch;
+
+	// Blocks on the right edge might overlap the next line, so we have to keep the order
+	for (std::vector<BlockOp>::const_iterator op = blocks.ops.begin(); op != blocks.ops.end(); ++op) {
+		byte *blockDest = dest + op->dest;
+
+		switch (op->type) {
+			case kOpCopy:
+				copyBlock(blockDest, pitch, prev + op->prev, pitch);
+				break;
+
+			case kOpFill:
+				for (int i = 0; i < 8; i++, blockDest += pitch)
+					std::memset(blockDest, op->color, 8);
+				break;
+
+			case kOpFillScaled:
+				for (int i = 0; i < 16; i++, blockDest += pitch)
+					std::memset(blockDest, op->color, 16);
+				break;
+
+			case kOpPixels:
+				copyBlock(blockDest, pitch, &blocks.pixels[op->data], 8);
+				break;
+
+			case kOpPixelsScaled:
+				BinkDSP::putPixelsScaled(blockDest, pitch, &blocks.pixels[op->data]);
+				break;
+
+			case kOpIntra:
+				BinkDSP::idctPut(blockDest, pitch, &blocks.coeffs[op->data]);
+				break;
+
+			case kOpIntraScaled:
+				{
+					int16 block[64];
+
+					BinkDSP::idct(block, &blocks.coeffs[op->data]);
+					BinkDSP::putPixelsScaled(blockDest, pitch, block);
+				}
+				break;
+
+			case kOpInter:
+				copyBlock(blockDest, pitch, prev + op->prev, pitch);
+				BinkDSP::idctAdd(blockDest, pitch, &blocks.coeffs[op->data]);
+				break;
+
+			case kOpResidue:
+				copyBlock(blockDest, pitch, prev + op->prev, pitch);
+				BinkDSP::addPixels(blockDest, pitch, &blocks.coeffs[op->data]);
+				break;
+		}
+	}
+}
+
 void Bink::BinkVideoTrack::readBundle(VideoFrame &video, Source source) {
 	if (source == kSourceColors) {
 		for (int i = 0; i < 16; i++)
@@ -386,7 +471,8 @@ void Bink::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffman) {
 			hasSymbol[huffman.symbols[i]] = 1;
 		}
 
-		for (int i = 0; i < 16; i++)
+		// Duplicate symbols in the selection must not overflow the list
+		for (int i = 0; (i < 16) && (length < 15); i++)
 			if (hasSymbol[i] == 0)
 				huffman.symbols[++length] = i;
 
@@ -643,23 +729,47 @@ uint32 Bink::BinkVideoTrack::readBundleCount(VideoFrame &video, Bundle &bundle)
 	return n;
 }
 
-void Bink::BinkVideoTrack::blockSkip(DecodeContext &ctx) {
-	byte *dest = ctx.dest;
-	byte *prev = ctx.prev;
+Bink::BinkVideoTrack::BlockOp &Bink::BinkVideoTrack::addBlockOp(DecodeContext &ctx, BlockOpType type) {
+	PlaneBlocks &blocks = _planeBlocks[ctx.planeIdx];
+
+	blocks.ops.push_back(BlockOp());
+	BlockOp &op = blocks.ops.back();
+
+	op.type  = type;
+	op.color = 0;
+	op.dest  = ctx.dest - ctx.destStart;
+	op.prev  = ctx.prev - ctx.prevStart;
+	op.data  = 0;
 
-	for (int j = 0; j < 8; j++, dest += ctx.pitch, prev += ctx.pitch)
-		std::memcpy(dest, prev, 8);
+	return op;
 }
 
-void Bink::BinkVideoTrack::blockScaledSkip(DecodeContext &ctx) {
-	byte *dest = ctx.dest;
-	byte *prev = ctx.prev;
+byte *Bink::BinkVideoTrack::addBlockPixels(DecodeContext &ctx, BlockOp &op) {
+	std::vector<byte> &pixels = _planeBlocks[ctx.planeIdx].pixels;
+
+	op.data = pixels.size();
+	pixels.resize(pixels.size() + 64);
+
+	return &pixels[op.data];
+}
+
+int16 *Bink::BinkVideoTrack::addBlockCoeffs(DecodeContext &ctx, BlockOp &op) {
+	std::vector<int16> &coeffs = _planeBlocks[ctx.planeIdx].coeffs;
+
+	// The new coefficients are initialized to 0
+	op.data = coeffs.size();
+	coeffs.resize(coeffs.size() + 64);
 
-	for (int j = 0; j < 16; j++, dest += ctx.pitch, prev += ctx.pitch)
-		std::memcpy(dest, prev, 16);
+	return &coeffs[op.data];
+}
+
+void Bink::BinkVideoTrack::blockSkip(DecodeContext &ctx) {
+	addBlockOp(ctx, kOpCopy);
 }
 
 void Bink::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
+	byte *dest = addBlockPixels(ctx, addBlockOp(ctx, kOpPixelsScaled));
+
 	const uint8 *scan = binkPatterns[ctx.video->bits->getBits(4)];
 
 	int i = 0;
@@ -673,86 +783,53 @@ void Bink::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
 		if (ctx.video->bits->getBit()) {
 
 			byte v = getBundleValue(kSourceColors);
-			for (int j = 0; j < run; j++, scan++)
-				ctx.dest[ctx.coordScaledMap1[*scan]] =
-				ctx.dest[ctx.coordScaledMap2[*scan]] =
-				ctx.dest[ctx.coordScaledMap3[*scan]] =
-				ctx.dest[ctx.coordScaledMap4[*scan]] = v;
+			for (int j = 0; j < run; j++)
+				dest[*scan++] = v;
 
 		} else
-			for (int j = 0; j < run; j++, scan++)
-				ctx.dest[ctx.coordScaledMap1[*scan]] =
-				ctx.dest[ctx.coordScaledMap2[*scan]] =
-				ctx.dest[ctx.coordScaledMap3[*scan]] =
-				ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(kSourceColors);
+			for (int j = 0; j < run; j++)
+				dest[*scan++] = getBundleValue(kSourceColors);
 
 	} while (i < 63);
 
 	if (i == 63)
-		ctx.dest[ctx.coordScaledMap1[*scan]] =
-		ctx.dest[ctx.coordScaledMap2[*scan]] =
-		ctx.dest[ctx.coordScaledMap3[*scan]] =
-		ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(kSourceColors);
+		dest[*scan++] = getBundleValue(kSourceColors);
 }
 
 void Bink::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
-	int16 block[64];
-	std::memset(block, 0, 64 * sizeof(int16));
+	int16 *block = addBlockCoeffs(ctx, addBlockOp(ctx, kOpIntraScaled));
 
 	block[0] = getBundleValue(kSourceIntraDC);
 
 	readDCTCoeffs(*ctx.video, block, true);
-
-	IDCT(block);
-
-	int16 *src   = block;
-	byte  *dest1 = ctx.dest;
-	byte  *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16, src += 8) {
-
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
-
-	}
 }
 
 void Bink::BinkVideoTrack::blockScaledFill(DecodeContext &ctx) {
-	byte v = getBundleValue(kSourceColors);
-
-	byte *dest = ctx.dest;
-	for (int i = 0; i < 16; i++, dest += ctx.pitch)
-		std::memset(dest, v, 16);
+	addBlockOp(ctx, kOpFillScaled).color = getBundleValue(kSourceColors);
 }
 
 void Bink::BinkVideoTrack::blockScaledPattern(DecodeContext &ctx) {
+	byte *dest = addBlockPixels(ctx, addBlockOp(ctx, kOpPixelsScaled));
+
 	byte col[2];
 
 	for (int i = 0; i < 2; i++)
 		col[i] = getBundleValue(kSourceColors);
 
-	byte *dest1 = ctx.dest;
-	byte *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
+	for (int j = 0; j < 8; j++) {
 		byte v = getBundleValue(kSourcePattern);
 
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2, v >>= 1)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = col[v & 1];
+		for (int i = 0; i < 8; i++, v >>= 1)
+			*dest++ = col[v & 1];
 	}
 }
 
 void Bink::BinkVideoTrack::blockScaledRaw(DecodeContext &ctx) {
-	byte row[8];
+	byte *dest = addBlockPixels(ctx, addBlockOp(ctx, kOpPixelsScaled));
 
-	byte *dest1 = ctx.dest;
-	byte *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
-		std::memcpy(row, _bundles[kSourceColors].curPtr, 8);
+	std::memcpy(dest, _bundles[kSourceColors].curPtr, 64);
 
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = row[i];
-
-		_bundles[kSourceColors].curPtr += 8;
-	}
+	_bundles[kSourceColors].curPtr += 64;
 }
 
 void Bink::BinkVideoTrack::blockScaled(DecodeContext &ctx) {
@@ -788,20 +865,26 @@ void Bink::BinkVideoTrack::blockScaled(DecodeContext &ctx) {
 	ctx.prev   += 8;
 }
 
-void Bink::BinkVideoTrack::blockMotion(DecodeContext &ctx) {
+uint32 Bink::BinkVideoTrack::readMotion(DecodeContext &ctx) {
 	int8 xOff = getBundleValue(kSourceXOff);
 	int8 yOff = getBundleValue(kSourceYOff);
 
-	byte *dest = ctx.dest;
 	byte *prev = ctx.prev + yOff * ((int32) ctx.pitch) + xOff;
 	if ((prev < ctx.prevStart) || (prev > ctx.prevEnd))
 		throw Common::Exception("Copy out of bounds (%d | %d)", ctx.blockX * 8 + xOff, ctx.blockY * 8 + yOff);
 
-	for (int j = 0; j < 8; j++, dest += ctx.pitch, prev += ctx.pitch)
-		std::memcpy(dest, prev, 8);
+	return prev - ctx.prevStart;
+}
+
+void Bink::BinkVideoTrack::blockMotion(DecodeContext &ctx) {
+	const uint32 prev = readMotion(ctx);
+
+	addBlockOp(ctx, kOpCopy).prev = prev;
 }
 
 void Bink::BinkVideoTrack::blockRun(DecodeContext &ctx) {
+	byte *dest = addBlockPixels(ctx, addBlockOp(ctx, kOpPixels));
+
 	const uint8 *scan = binkPatterns[ctx.video->bits->getBits(4)];
 
 	int i = 0;
@@ -816,75 +899,63 @@ void Bink::BinkVideoTrack::blockRun(DecodeContext &ctx) {
 
 			byte v = getBundleValue(kSourceColors);
 			for (int j = 0; j < run; j++)
-				ctx.dest[ctx.coordMap[*scan++]] = v;
+				dest[*scan++] = v;
 
 		} else
 			for (int j = 0; j < run; j++)
-				ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(kSourceColors);
+				dest[*scan++] = getBundleValue(kSourceColors);
 
 	} while (i < 63);
 
 	if (i == 63)
-		ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(kSourceColors);
+		dest[*scan++] = getBundleValue(kSourceColors);
 }
 
 void Bink::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
-	blockMotion(ctx);
+	const uint32 prev = readMotion(ctx);
 
 	byte v = ctx.video->bits->getBits(7);
 
-	int16 block[64];
-	std::memset(block, 0, 64 * sizeof(int16));
-
-	readResidue(*ctx.video, block, v);
+	BlockOp &op = addBlockOp(ctx, kOpResidue);
+	op.prev = prev;
 
-	byte  *dst = ctx.dest;
-	int16 *src = block;
-	for (int i = 0; i < 8; i++, dst += ctx.pitch, src += 8)
-		for (int j = 0; j < 8; j++)
-			dst[j] += src[j];
+	readResidue(*ctx.video, addBlockCoeffs(ctx, op), v);
 }
 
 void Bink::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
-	int16 block[64];
-	std::memset(block, 0, 64 * sizeof(int16));
+	int16 *block = addBlockCoeffs(ctx, addBlockOp(ctx, kOpIntra));
 
 	block[0] = getBundleValue(kSourceIntraDC);
 
 	readDCTCoeffs(*ctx.video, block, true);
-
-	IDCTPut(ctx, block);
 }
 
 void Bink::BinkVideoTrack::blockFill(DecodeContext &ctx) {
-	byte v = getBundleValue(kSourceColors);
-
-	byte *dest = ctx.dest;
-	for (int i = 0; i < 8; i++, dest += ctx.pitch)
-		std::memset(dest, v, 8);
+	addBlockOp(ctx, kOpFill).color = getBundleValue(kSourceColors);
 }
 
 void Bink::BinkVideoTrack::blockInter(DecodeContext &ctx) {
-	blockMotion(ctx);
+	const uint32 prev = readMotion(ctx);
+
+	BlockOp &op = addBlockOp(ctx, kOpInter);
+	op.prev = prev;
 
-	int16 block[64];
-	std::memset(block, 0, 64 * sizeof(int16));
+	int16 *block = addBlockCoeffs(ctx, op);
 
 	block[0] = getBundleValue(kSourceInterDC);
 
 	readDCTCoeffs(*ctx.video, block, false);
-
-	IDCTAdd(ctx, block);
 }
 
 void Bink::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
+	byte *dest = addBlockPixels(ctx, addBlockOp(ctx, kOpPixels));
+
 	byte col[2];
 
 	for (int i = 0; i < 2; i++)
 		col[i] = getBundleValue(kSourceColors);
 
-	byte *dest = ctx.dest;
-	for (int i = 0; i < 8; i++, dest += ctx.pitch - 8) {
+	for (int i = 0; i < 8; i++) {
 		byte v = getBundleValue(kSourcePattern);
 
 		for (int j = 0; j < 8; j++, v >>= 1)
@@ -893,10 +964,9 @@ void Bink::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
 }
 
 void Bink::BinkVideoTrack::blockRaw(DecodeContext &ctx) {
-	byte *dest = ctx.dest;
-	byte *data = _bundles[kSourceColors].curPtr;
-	for (int i = 0; i < 8; i++, dest += ctx.pitch, data += 8)
-		std::memcpy(dest, data, 8);
+	byte *dest = addBlockPixels(ctx, addBlockOp(ctx, kOpPixels));
+
+	std::memcpy(dest, _bundles[kSourceColors].curPtr, 64);
 
 	_bundles[kSourceColors].curPtr += 64;
 }
@@ -986,6 +1056,8 @@ void Bink::BinkVideoTrack::readBlockTypes(VideoFrame &video, Bundle &bundle) {
 			*bundle.curDec++ = v;
 		} else {
 			int run = rleLens[v - 12];
+			if ((bundle.curDec + run) > bundle.dataEnd)
+				throw Common::Exception("Block type run went out of bounds");
 
 			std::memset(bundle.curDec, last, run);
 
@@ -1062,6 +1134,9 @@ void Bink::BinkVideoTrack::readDCS(VideoFrame &video, Bundle &bundle, int startB
 	if (length == 0)
 		return;
 
+	if ((bundle.curDec + length * 2) > bundle.dataEnd)
+		throw Common::Exception("Too many DC values");
+
 	int16 *dest = reinterpret_cast<int16 *>(bundle.curDec);
 
 	int32 v = video.bits->getBits(startBits - (hasSign ? 1 : 0));
@@ -1522,89 +1597,6 @@ void Bink::BinkAudioTrack::readAudioCoeffs(Common::BitStream &bits, float *coeff
 
 }
 
-#define A1  2896 /* (1/sqrt(2))<<12 */
-#define A2  2217
-#define A3  3784
-#define A4 -5352
-
-#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
-    const int a0 = (src)[s0] + (src)[s4]; \
-    const int a1 = (src)[s0] - (src)[s4]; \
-    const int a2 = (src)[s2] + (src)[s6]; \
-    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
-    const int a4 = (src)[s5] + (src)[s3]; \
-    const int a5 = (src)[s5] - (src)[s3]; \
-    const int a6 = (src)[s1] + (src)[s7]; \
-    const int a7 = (src)[s1] - (src)[s7]; \
-    const int b0 = a4 + a6; \
-    const int b1 = (A3*(a5 + a7)) >> 11; \
-    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
-    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
-    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
-    (dest)[d0] = munge(a0+a2   +b0); \
-    (dest)[d1] = munge(a1+a3-a2+b2); \
-    (dest)[d2] = munge(a1-a3+a2+b3); \
-    (dest)[d3] = munge(a0-a2   -b4); \
-    (dest)[d4] = munge(a0-a2   +b4); \
-    (dest)[d5] = munge(a1-a3+a2-b3); \
-    (dest)[d6] = munge(a1+a3-a2-b2); \
-    (dest)[d7] = munge(a0+a2   -b0); \
-}
-/* end IDCT_TRANSFORM macro */
-
-#define MUNGE_NONE(x) (x)
-#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
-
-#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
-#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
-
-static inline void IDCTCol(int16 *dest, const int16 *src)
-{
-	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
-		dest[ 0] =
-		dest[ 8] =
-		dest[16] =
-		dest[24] =
-		dest[32] =
-		dest[40] =
-		dest[48] =
-		dest[56] = src[0];
-	} else {
-		IDCT_COL(dest, src);
-	}
-}
-
-void Bink::BinkVideoTrack::IDCT(int16 *block) {
-	int i;
-	int16 temp[64];
-
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
-	}
-}
-
-void Bink::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int16 *block) {
-	int i, j;
-
-	IDCT(block);
-	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
-		for (j = 0; j < 8; j++)
-			 dest[j] += block[j];
-}
-
-void Bink::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int16 *block) {
-	int i;
-	int16 temp[64];
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
-	}
-}
-
 Bink::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id) :
 		_width(width), _height(height), _curFrame(-1), _frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id) {
 	// Give the planes a bit extra space
@@ -76,6 +76,7 @@
 #include "src/common/types.h"
 #include "src/common/rational.h"
 #include "src/common/scopedptr.h"
+#include "src/common/membitstream.h"
 
 #include "src/video/decoder.h"
 
@@ -156,7 +157,7 @@ private:
 		uint32 offset;
 		uint32 size;
 
-		Common::BitStream *bits;
+		Common::MemoryBitStream32LELSB *bits;
 
 		VideoFrame();
 		~VideoFrame();
@@ -169,6 +170,8 @@ private:
 
 	uint32 _audioTrack; ///< Audio track to use.
 
+	std::vector<byte> _videoPacket; ///< The video packet of the current frame.
+
 	/** Load a Bink file. */
 	void load();
 
@@ -204,12 +207,6 @@ private:
 			byte *prevStart, *prevEnd;
 
 			uint32 pitch;
-
-			int coordMap[64];
-			int coordScaledMap1[64];
-			int coordScaledMap2[64];
-			int coordScaledMap3[64];
-			int coordScaledMap4[64];
 		};
 
 		/** IDs for different data types used in Bink video codec. */
@@ -241,6 +238,41 @@ private:
 			kBlockRaw           ///< Uncoded 8x8 block.
 		};
 
+		/** Operations rendering a decoded block into a plane. */
+		enum BlockOpType {
+			kOpCopy        , ///< Copy 8x8 pixels from the last frame.
+			kOpFill        , ///< Fill 8x8 pixels with one color.
+			kOpFillScaled  , ///< Fill 16x16 pixels with one color.
+			kOpPixels      , ///< Copy 8x8 decoded pixels.
+			kOpPixelsScaled, ///< Copy 8x8 decoded pixels, scaled to 16x16.
+			kOpIntra       , ///< Inverse DCT of decoded coefficients into 8x8 pixels.
+			kOpIntraScaled , ///< Inverse DCT of decoded coefficients into 16x16 pixels.
+			kOpInter       , ///< Copy 8x8 pixels from the last frame, add the inverse DCT of decoded coefficients.
+			kOpResidue       ///< Copy 8x8 pixels from the last frame, add decoded residue.
+		};
+
+		/** A decoded block, waiting to be rendered into a plane. */
+		struct BlockOp {
+			BlockOpType type;
+
+			byte color; ///< The color to fill with.
+
+			uint32 dest; ///< Offset of the block within the current plane.
+			uint32 prev; ///< Offset of the source block within the last frame's plane.
+			uint32 data; ///< Offset of the decoded pixels or coefficients.
+		};
+
+		/** All decoded blocks of a plane. */
+		struct PlaneBlocks {
+			uint32 pitch;
+
+			std::vector<BlockOp> ops;    ///< The blocks, in decoding order.
+			std::vector<int16>   coeffs; ///< Decoded DCT coefficients and residues, 64 per block.
+			std::vector<byte>    pixels; ///< Decoded pixels, 64 per block.
+
+			PlaneBlocks();
+		};
+
 		/** Data structure for decoding and translating Huffman'd data. */
 		struct Huffman {
 			int  index;       ///< Index of the Huffman codebook to use.
@@ -290,6 +322,8 @@ private:
 		Common::ScopedArray<byte> _curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		Common::ScopedArray<byte> _oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		PlaneBlocks _planeBlocks[4]; ///< The decoded blocks of the 4 color planes, YUVA.
+
 		/** Initialize the bundles. */
 		void initBundles();
 
@@ -299,8 +333,10 @@ private:
 		/** Decode a video packet. */
 		void videoPacket(VideoFrame &video);
 
-		/** Decode a plane. */
+		/** Decode a plane into a list of blocks. */
 		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
+		/** Render the decoded blocks of a plane. */
+		void renderPlane(int planeIdx);
 
 		/** Read/Initialize a bundle for decoding a plane. */
 		void readBundle(VideoFrame &video, Source source);
@@ -318,9 +354,18 @@ private:
 		/** Read a count value out of a bundle. */
 		uint32 readBundleCount(VideoFrame &video, Bundle &bundle);
 
+		/** Add a block to the decoded blocks of the current plane. */
+		BlockOp &addBlockOp(DecodeContext &ctx, BlockOpType type);
+		/** Add space for the pixels of a decoded block. */
+		byte *addBlockPixels(DecodeContext &ctx, BlockOp &op);
+		/** Add space for the coefficients of a decoded block. */
+		int16 *addBlockCoeffs(DecodeContext &ctx, BlockOp &op);
+
+		/** Read a motion vector, returning the offset of the source block within the last frame's plane. */
+		uint32 readMotion(DecodeContext &ctx);
+
 		// Handle the block types
 		void blockSkip         (DecodeContext &ctx);
-		void blockScaledSkip   (DecodeContext &ctx);
 		void blockScaledRun    (DecodeContext &ctx);
 		void blockScaledIntra  (DecodeContext &ctx);
 		void blockScaledFill   (DecodeContext &ctx);
@@ -345,11 +390,6 @@ private:
 		void readDCS         (VideoFrame &video, Bundle &bundle, int startBits, bool hasSign);
 		void readDCTCoeffs   (VideoFrame &video, int16 *block, bool isIntra);
 		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
-
-		// Bink video IDCT
-		void IDCT(int16 *block);
-		void IDCTPut(DecodeContext &ctx, int16 *block);
-		void IDCTAdd(DecodeContext &ctx, int16 *block);
 	};
 
 	class BinkAudioTrack : public AudioTrack {
@@ -0,0 +1,418 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Bink video DSP routines.
+ */
+
+/* Based on the Bink implementation in FFmpeg (<https://ffmpeg.org/)>,
+ * which is released under the terms of version 2 or later of the GNU
+ * Lesser General Public License.
+ *
+ * The original copyright note in libavcodec/binkdsp.c reads as follows:
+ *
+ * Bink DSP routines
+ * Copyright (c) 2009 Konstantin Shishkov
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define BINKDSP_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+#include "src/video/binkdsp.h"
+
+namespace Video {
+
+namespace BinkDSP {
+
+#define A1  2896 /* (1/sqrt(2))<<12 */
+#define A2  2217
+#define A3  3784
+#define A4 -5352
+
+namespace Reference {
+
+#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
+    const int a0 = (src)[s0] + (src)[s4]; \
+    const int a1 = (src)[s0] - (src)[s4]; \
+    const int a2 = (src)[s2] + (src)[s6]; \
+    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
+    const int a4 = (src)[s5] + (src)[s3]; \
+    const int a5 = (src)[s5] - (src)[s3]; \
+    const int a6 = (src)[s1] + (src)[s7]; \
+    const int a7 = (src)[s1] - (src)[s7]; \
+    const int b0 = a4 + a6; \
+    const int b1 = (A3*(a5 + a7)) >> 11; \
+    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
+    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
+    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
+    (dest)[d0] = munge(a0+a2   +b0); \
+    (dest)[d1] = munge(a1+a3-a2+b2); \
+    (dest)[d2] = munge(a1-a3+a2+b3); \
+    (dest)[d3] = munge(a0-a2   -b4); \
+    (dest)[d4] = munge(a0-a2   +b4); \
+    (dest)[d5] = munge(a1-a3+a2-b3); \
+    (dest)[d6] = munge(a1+a3-a2-b2); \
+    (dest)[d7] = munge(a0+a2   -b0); \
+}
+/* end IDCT_TRANSFORM macro */
+
+#define MUNGE_NONE(x) (x)
+#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
+
+#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
+#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
+
+static inline void IDCTCol(int16 *dest, const int16 *src)
+{
+	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
+		dest[ 0] =
+		dest[ 8] =
+		dest[16] =
+		dest[24] =
+		dest[32] =
+		dest[40] =
+		dest[48] =
+		dest[56] = src[0];
+	} else {
+		IDCT_COL(dest, src);
+	}
+}
+
+void idct(int16 *dest, const int16 *block) {
+	int i;
+	int16 temp[64];
+
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[8*i]), (&temp[8*i]) );
+	}
+}
+
+void idctPut(byte *dest, uint32 pitch, const int16 *block) {
+	int i;
+	int16 temp[64];
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
+	}
+}
+
+void idctAdd(byte *dest, uint32 pitch, const int16 *block) {
+	int16 temp[64];
+
+	idct(temp, block);
+	addPixels(dest, pitch, temp);
+}
+
+void addPixels(byte *dest, uint32 pitch, const int16 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (int j = 0; j < 8; j++)
+			dest[j] += block[j];
+}
+
+void putPixelsScaled(byte *dest, uint32 pitch, const int16 *block) {
+	byte *dest1 = dest;
+	byte *dest2 = dest + pitch;
+	for (int j = 0; j < 8; j++, dest1 += (pitch << 1) - 16, dest2 += (pitch << 1) - 16, block += 8) {
+
+		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
+			dest1[0] = dest1[1] = dest2[0] = dest2[1] = block[i];
+
+	}
+}
+
+void putPixelsScaled(byte *dest, uint32 pitch, const byte *block) {
+	byte *dest1 = dest;
+	byte *dest2 = dest + pitch;
+	for (int j = 0; j < 8; j++, dest1 += (pitch << 1) - 16, dest2 += (pitch << 1) - 16, block += 8) {
+
+		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
+			dest1[0] = dest1[1] = dest2[0] = dest2[1] = block[i];
+
+	}
+}
+
+} // End of namespace Reference
+
+#ifdef BINKDSP_SSE2
+
+/* The SSE2 versions work on whole rows (for the column transform) and,
+ * after a transposition, on whole columns (for the row transform) of the
+ * block at once. To stay bit-exact with the plain C implementations, all
+ * arithmetic is done with 32-bit lanes, and the intermediate results are
+ * truncated to 16 bits where the C code stores them into int16 values.
+ *
+ * The shortcut the C column transform takes when all AC coefficients of
+ * a column are 0 yields the same result as the full transform, so it is
+ * not needed here. */
+
+/** Multiply the signed 32-bit lanes of a with the constant c, keeping the low 32 bits. */
+static inline __m128i mul32(__m128i a, int c) {
+	const __m128i b = _mm_set1_epi32(c);
+
+	const __m128i even = _mm_mul_epu32(a, b);
+	const __m128i odd  = _mm_mul_epu32(_mm_srli_si128(a, 4), b);
+
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+	                          _mm_shuffle_epi32(odd , _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+/** The IDCT transform on 8 vectors of 4 signed 32-bit values each. */
+static inline void transform(__m128i *d, const __m128i *s, bool row) {
+	const __m128i a0 = _mm_add_epi32(s[0], s[4]);
+	const __m128i a1 = _mm_sub_epi32(s[0], s[4]);
+	const __m128i a2 = _mm_add_epi32(s[2], s[6]);
+	const __m128i a3 = _mm_srai_epi32(mul32(_mm_sub_epi32(s[2], s[6]), A1), 11);
+	const __m128i a4 = _mm_add_epi32(s[5], s[3]);
+	const __m128i a5 = _mm_sub_epi32(s[5], s[3]);
+	const __m128i a6 = _mm_add_epi32(s[1], s[7]);
+	const __m128i a7 = _mm_sub_epi32(s[1], s[7]);
+
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = _mm_srai_epi32(mul32(_mm_add_epi32(a5, a7), A3), 11);
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(_mm_srai_epi32(mul32(a5, A4), 11), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(_mm_srai_epi32(mul32(_mm_sub_epi32(a6, a4), A1), 11), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(_mm_srai_epi32(mul32(a7, A2), 11), b3), b1);
+
+	const __m128i c0 = _mm_add_epi32(a0, a2);
+	const __m128i c1 = _mm_sub_epi32(a0, a2);
+	const __m128i c2 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i c3 = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+
+	d[0] = _mm_add_epi32(c0, b0);
+	d[1] = _mm_add_epi32(c2, b2);
+	d[2] = _mm_add_epi32(c3, b3);
+	d[3] = _mm_sub_epi32(c1, b4);
+	d[4] = _mm_add_epi32(c1, b4);
+	d[5] = _mm_sub_epi32(c3, b3);
+	d[6] = _mm_sub_epi32(c2, b2);
+	d[7] = _mm_sub_epi32(c0, b0);
+
+	if (row) {
+		const __m128i round = _mm_set1_epi32(0x7F);
+
+		for (int i = 0; i < 8; i++)
+			d[i] = _mm_srai_epi32(_mm_add_epi32(d[i], round), 8);
+	}
+}
+
+/** Pack two vectors of 32-bit values into one vector of 16-bit values, truncating them. */
+static inline __m128i truncatePack(__m128i lo, __m128i hi) {
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+
+	return _mm_packs_epi32(lo, hi);
+}
+
+/** Run the transform over 8 vectors of 8 signed 16-bit values each. */
+static inline void transform16(__m128i *v, bool row) {
+	__m128i s[8], d[8];
+
+	// Low 4 values
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm_srai_epi32(_mm_unpacklo_epi16(v[i], v[i]), 16);
+
+	transform(d, s, row);
+
+	__m128i lo[8];
+	for (int i = 0; i < 8; i++)
+		lo[i] = d[i];
+
+	// High 4 values
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm_srai_epi32(_mm_unpackhi_epi16(v[i], v[i]), 16);
+
+	transform(d, s, row);
+
+	for (int i = 0; i < 8; i++)
+		v[i] = truncatePack(lo[i], d[i]);
+}
+
+/** Transpose an 8x8 matrix of 16-bit values. */
+static inline void transpose(__m128i *v) {
+	const __m128i t0 = _mm_unpacklo_epi16(v[0], v[1]);
+	const __m128i t1 = _mm_unpackhi_epi16(v[0], v[1]);
+	const __m128i t2 = _mm_unpacklo_epi16(v[2], v[3]);
+	const __m128i t3 = _mm_unpackhi_epi16(v[2], v[3]);
+	const __m128i t4 = _mm_unpacklo_epi16(v[4], v[5]);
+	const __m128i t5 = _mm_unpackhi_epi16(v[4], v[5]);
+	const __m128i t6 = _mm_unpacklo_epi16(v[6], v[7]);
+	const __m128i t7 = _mm_unpackhi_epi16(v[6], v[7]);
+
+	const __m128i u0 = _mm_unpacklo_epi32(t0, t2);
+	const __m128i u1 = _mm_unpackhi_epi32(t0, t2);
+	const __m128i u2 = _mm_unpacklo_epi32(t1, t3);
+	const __m128i u3 = _mm_unpackhi_epi32(t1, t3);
+	const __m128i u4 = _mm_unpacklo_epi32(t4, t6);
+	const __m128i u5 = _mm_unpackhi_epi32(t4, t6);
+	const __m128i u6 = _mm_unpacklo_epi32(t5, t7);
+	const __m128i u7 = _mm_unpackhi_epi32(t5, t7);
+
+	v[0] = _mm_unpacklo_epi64(u0, u4);
+	v[1] = _mm_unpackhi_epi64(u0, u4);
+	v[2] = _mm_unpacklo_epi64(u1, u5);
+	v[3] = _mm_unpackhi_epi64(u1, u5);
+	v[4] = _mm_unpacklo_epi64(u2, u6);
+	v[5] = _mm_unpackhi_epi64(u2, u6);
+	v[6] = _mm_unpacklo_epi64(u3, u7);
+	v[7] = _mm_unpackhi_epi64(u3, u7);
+}
+
+/** Inverse DCT of a block, into 8 rows of 8 16-bit values each. */
+static inline void idctRows(__m128i *rows, const int16 *block) {
+	for (int i = 0; i < 8; i++)
+		rows[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 8 * i));
+
+	transform16(rows, false);
+	transpose(rows);
+	transform16(rows, true);
+	transpose(rows);
+}
+
+/** Pack the low 8 bits of two rows of 16-bit values into 16 bytes. */
+static inline __m128i packLowBytes(__m128i row1, __m128i row2) {
+	const __m128i mask = _mm_set1_epi16(0xFF);
+
+	return _mm_packus_epi16(_mm_and_si128(row1, mask), _mm_and_si128(row2, mask));
+}
+
+/** Load two rows of 8 pixels each. */
+static inline __m128i loadPixels(const byte *row1, const byte *row2) {
+	return _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(row1)),
+	                          _mm_loadl_epi64(reinterpret_cast<const __m128i *>(row2)));
+}
+
+/** Store two rows of 8 pixels each. */
+static inline void storePixels(byte *row1, byte *row2, __m128i pixels) {
+	_mm_storel_epi64(reinterpret_cast<__m128i *>(row1), pixels);
+	_mm_storel_epi64(reinterpret_cast<__m128i *>(row2), _mm_unpackhi_epi64(pixels, pixels));
+}
+
+/** Add two rows of 8 16-bit values each onto two rows of pixels, wrapping around. */
+static inline void addRows(byte *dest, uint32 pitch, __m128i row1, __m128i row2) {
+	const __m128i pixels = _mm_add_epi8(loadPixels(dest, dest + pitch), packLowBytes(row1, row2));
+
+	storePixels(dest, dest + pitch, pixels);
+}
+
+/** Write 8 pixels into a 16x2 area, doubling them in each direction. */
+static inline void putScaledRow(byte *dest, uint32 pitch, __m128i pixels) {
+	const __m128i doubled = _mm_unpacklo_epi8(pixels, pixels);
+
+	/* In planes narrower than 16 pixels, the two rows overlap. The plain C
+	 * implementation interleaves them, so that the upper row wins. */
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + pitch), doubled);
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(dest)        , doubled);
+}
+
+void idct(int16 *dest, const int16 *block) {
+	__m128i rows[8];
+	idctRows(rows, block);
+
+	for (int i = 0; i < 8; i++)
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + 8 * i), rows[i]);
+}
+
+void idctPut(byte *dest, uint32 pitch, const int16 *block) {
+	__m128i rows[8];
+	idctRows(rows, block);
+
+	for (int i = 0; i < 8; i += 2, dest += 2 * pitch)
+		storePixels(dest, dest + pitch, packLowBytes(rows[i], rows[i + 1]));
+}
+
+void idctAdd(byte *dest, uint32 pitch, const int16 *block) {
+	__m128i rows[8];
+	idctRows(rows, block);
+
+	for (int i = 0; i < 8; i += 2, dest += 2 * pitch)
+		addRows(dest, pitch, rows[i], rows[i + 1]);
+}
+
+void addPixels(byte *dest, uint32 pitch, const int16 *block) {
+	for (int i = 0; i < 8; i += 2, dest += 2 * pitch, block += 16)
+		addRows(dest, pitch, _mm_loadu_si128(reinterpret_cast<const __m128i *>(block)),
+		                     _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 8)));
+}
+
+void putPixelsScaled(byte *dest, uint32 pitch, const int16 *block) {
+	for (int i = 0; i < 8; i += 2, dest += 4 * pitch, block += 16) {
+		const __m128i pixels = packLowBytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(block)),
+		                                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 8)));
+
+		putScaledRow(dest            , pitch, pixels);
+		putScaledRow(dest + 2 * pitch, pitch, _mm_unpackhi_epi64(pixels, pixels));
+	}
+}
+
+void putPixelsScaled(byte *dest, uint32 pitch, const byte *block) {
+	for (int i = 0; i < 8; i++, dest += 2 * pitch, block += 8)
+		putScaledRow(dest, pitch, _mm_loadl_epi64(reinterpret_cast<const __m128i *>(block)));
+}
+
+#else // BINKDSP_SSE2
+
+void idct(int16 *dest, const int16 *block) {
+	Reference::idct(dest, block);
+}
+
+void idctPut(byte *dest, uint32 pitch, const int16 *block) {
+	Reference::idctPut(dest, pitch, block);
+}
+
+void idctAdd(byte *dest, uint32 pitch, const int16 *block) {
+	Reference::idctAdd(dest, pitch, block);
+}
+
+void addPixels(byte *dest, uint32 pitch, const int16 *block) {
+	Reference::addPixels(dest, pitch, block);
+}
+
+void putPixelsScaled(byte *dest, uint32 pitch, const int16 *block) {
+	Reference::putPixelsScaled(dest, pitch, block);
+}
+
+void putPixelsScaled(byte *dest, uint32 pitch, const byte *block) {
+	Reference::putPixelsScaled(dest, pitch, block);
+}
+
+#endif // BINKDSP_SSE2
+
+} // End of namespace BinkDSP
+
+} // End of namespace Video
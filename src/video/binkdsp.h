@@ -0,0 +1,99 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Bink video DSP routines.
+ */
+
+/* Based on the Bink implementation in FFmpeg (<https://ffmpeg.org/)>,
+ * which is released under the terms of version 2 or later of the GNU
+ * Lesser General Public License.
+ *
+ * The original copyright note in libavcodec/binkdsp.c reads as follows:
+ *
+ * Bink DSP routines
+ * Copyright (c) 2009 Konstantin Shishkov
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef VIDEO_BINKDSP_H
+#define VIDEO_BINKDSP_H
+
+#include "src/common/types.h"
+
+namespace Video {
+
+/** The pixel kernels of the Bink video decoder.
+ *
+ *  All blocks are 8x8. Results written into pixels are truncated to
+ *  8 bits, and additions onto pixels wrap around, exactly like the
+ *  plain C implementations do.
+ *
+ *  Where available, these use SSE2. The results are bit-identical to
+ *  the plain C implementations, which are always available in the
+ *  Reference namespace.
+ */
+namespace BinkDSP {
+
+/** Inverse DCT of a block of coefficients, into a block of 16-bit values. */
+void idct(int16 *dest, const int16 *block);
+/** Inverse DCT of a block of coefficients, writing the result into the pixels. */
+void idctPut(byte *dest, uint32 pitch, const int16 *block);
+/** Inverse DCT of a block of coefficients, adding the result onto the pixels. */
+void idctAdd(byte *dest, uint32 pitch, const int16 *block);
+
+/** Add a block of 16-bit values onto the pixels. */
+void addPixels(byte *dest, uint32 pitch, const int16 *block);
+/** Write a block of 16-bit values into a 16x16 area of pixels, doubling them in each direction. */
+void putPixelsScaled(byte *dest, uint32 pitch, const int16 *block);
+/** Write a block of pixels into a 16x16 area of pixels, doubling them in each direction. */
+void putPixelsScaled(byte *dest, uint32 pitch, const byte *block);
+
+/** The plain C implementations. */
+namespace Reference {
+
+void idct(int16 *dest, const int16 *block);
+void idctPut(byte *dest, uint32 pitch, const int16 *block);
+void idctAdd(byte *dest, uint32 pitch, const int16 *block);
+
+void addPixels(byte *dest, uint32 pitch, const int16 *block);
+void putPixelsScaled(byte *dest, uint32 pitch, const int16 *block);
+void putPixelsScaled(byte *dest, uint32 pitch, const byte *block);
+
+} // End of namespace Reference
+
+} // End of namespace BinkDSP
+
+} // End of namespace Video
+
+#endif // VIDEO_BINKDSP_H
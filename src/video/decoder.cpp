@@ -84,7 +84,9 @@ void VideoDecoder::initVideo() {
 
 	_surface->fill(0, 0, 0, 0);
 
-	rebuild();
+	// Without the graphics subsystem, we can still decode, just not display
+	if (GfxMan.ready())
+		rebuild();
 }
 
 uint32 VideoDecoder::getWidth() const {
@@ -329,6 +331,16 @@ void VideoDecoder::update() {
 			checkAudioBuffer(static_cast<AudioTrack&>(**it), audioNeeded);
 }
 
+bool VideoDecoder::decodeNextFrame() {
+	VideoTrackPtr track = findNextVideoTrack();
+	if (!track)
+		return false;
+
+	decodeNextTrackFrame(*track);
+
+	return true;
+}
+
 void VideoDecoder::getQuadDimensions(float &width, float &height) const {
 	width  = getWidth();
 	height = getHeight();
@@ -151,6 +151,17 @@ public:
 	 */
 	bool isPaused() const { return _pauseLevel != 0; }
 
+	/**
+	 * Decode the next frame right away, without any timing, audio or display.
+	 *
+	 * This is meant for measuring and testing the video decoders. It works
+	 * without the graphics subsystem and must not be mixed with playing
+	 * the video.
+	 *
+	 * @return false if there are no more frames to decode, true otherwise
+	 */
+	bool decodeNextFrame();
+
 protected:
 	/**
 	 * An abstract representation of a track in a movie. Since tracks here are designed
@@ -26,6 +26,7 @@ src_video_libvideo_la_SOURCES += \
     src/video/decoder.h \
     src/video/bink.h \
     src/video/binkdata.h \
+    src/video/binkdsp.h \
     src/video/fader.h \
     src/video/quicktime.h \
     src/video/xmv.h \
@@ -36,6 +37,7 @@ src_video_libvideo_la_SOURCES += \
 src_video_libvideo_la_SOURCES += \
     src/video/decoder.cpp \
     src/video/bink.cpp \
+    src/video/binkdsp.cpp \
     src/video/fader.cpp \
     src/video/quicktime.cpp \
     src/video/xmv.cpp \
@@ -71,6 +71,7 @@
 #include "src/graphics/shader/shader.h"
 
 #include "src/sound/sound.h"
+#include "src/sound/soundbankman.h"
 
 #include "src/events/requests.h"
 #include "src/events/events.h"
@@ -277,6 +278,8 @@ static void initConfig() {
 
 	ConfigMan.setBool(Common::kConfigRealmDefault, "saveconf", true);
 
+	ConfigMan.setBool(Common::kConfigRealmDefault, "indexcache", true);
+
 	// Populate the new config with the defaults
 	if (newConfig) {
 		ConfigMan.setDefaults();
@@ -339,6 +342,9 @@ static void deinit() {
 	Graphics::Aurora::CursorManager::destroy();
 	Graphics::Aurora::TextureManager::destroy();
 
+	// Sound banks hold on to resource streams, so they need to go before the resource manager
+	Sound::SoundBankManager::destroy();
+
 	Aurora::LanguageManager::destroy();
 	Aurora::TalkManager::destroy();
 	Aurora::TwoDARegistry::destroy();
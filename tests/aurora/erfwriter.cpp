@@ -538,3 +538,52 @@ GTEST_TEST(ERFWriter, WriteMultipleFiles) {
 	delete readStream2;
 	delete readStream3;
 }
+
+GTEST_TEST(ERFWriter, WriteQueuedFiles) {
+	static const Aurora::ERFWriter::Version kVersions[] = {
+		Aurora::ERFWriter::kERFVersion10, Aurora::ERFWriter::kERFVersion20
+	};
+
+	for (size_t v = 0; v < ARRAYSIZE(kVersions); v++) {
+		Common::MemoryWriteStreamDynamic addedStream(true);
+		Common::MemoryWriteStreamDynamic queuedStream(true);
+
+		{
+			Aurora::ERFWriter erfWriter(MKTAG('E', 'R', 'F', ' '), 4, addedStream, kVersions[v]);
+
+			Common::MemoryReadStream dataStream1(kFileData, true);
+			Common::MemoryReadStream dataStream2(kLogoData);
+
+			erfWriter.add("ozymandias_1", Aurora::kFileTypeTXT, dataStream1);
+			erfWriter.add("logo_1", Aurora::kFileTypeBMP, dataStream2);
+			dataStream1.seek(0);
+			erfWriter.add("ozymandias_2", Aurora::kFileTypeTXT, dataStream1);
+			dataStream2.seek(0);
+			erfWriter.add("logo_2", Aurora::kFileTypeBMP, dataStream2);
+		}
+
+		{
+			Aurora::ERFWriter erfWriter(MKTAG('E', 'R', 'F', ' '), 4, queuedStream, kVersions[v]);
+
+			erfWriter.queue("ozymandias_1", Aurora::kFileTypeTXT, new Common::MemoryReadStream(kFileData, true));
+			erfWriter.queue("logo_1", Aurora::kFileTypeBMP, new Common::MemoryReadStream(kLogoData));
+
+			// Adding writes out the queue first
+			Common::MemoryReadStream dataStream(kFileData, true);
+			erfWriter.add("ozymandias_2", Aurora::kFileTypeTXT, dataStream);
+
+			// The rest of the queue has to be flushed explicitly
+			erfWriter.queue("logo_2", Aurora::kFileTypeBMP, new Common::MemoryReadStream(kLogoData));
+
+			EXPECT_THROW(erfWriter.queue("logo_3", Aurora::kFileTypeBMP, new Common::MemoryReadStream(kLogoData)),
+			             Common::Exception);
+
+			erfWriter.flush();
+		}
+
+		ASSERT_EQ(queuedStream.size(), addedStream.size());
+
+		for (size_t i = 0; i < addedStream.size(); i++)
+			ASSERT_EQ(queuedStream.getData()[i], addedStream.getData()[i]) << "Version " << v << ", at index " << i;
+	}
+}
@@ -261,6 +261,37 @@ GTEST_TEST(GDAFile, getFloatHash) {
 	EXPECT_THROW(gda.getFloat(0, hash1), Common::Exception);
 }
 
+GTEST_TEST(GDAFile, cacheColumn) {
+	Aurora::GDAFile gda(new Common::MemoryReadStream(kGDAFile));
+
+	const uint32 hash2 = Common::hashStringCRC32(kHeadersLow[2], Common::kEncodingUTF16LE);
+
+	EXPECT_FALSE(gda.cacheColumn(kHeaders[1]));
+	EXPECT_FALSE(gda.cacheColumn(kHeaders[5]));
+	EXPECT_FALSE(gda.cacheColumn("NOPE"));
+
+	EXPECT_TRUE(gda.cacheColumn(kHeaders[0]));
+	EXPECT_TRUE(gda.cacheColumn(hash2));
+	EXPECT_TRUE(gda.cacheColumn(kHeaders[3]));
+	EXPECT_TRUE(gda.cacheColumn(kHeaders[4]));
+
+	for (size_t i = 0; i < kRowCount; i++) {
+		EXPECT_EQ(gda.getInt(i, kHeaders[0]), kDataID[i]);
+		EXPECT_EQ(gda.getInt(i, hash2), kDataInt[i]);
+		EXPECT_EQ(gda.getInt(i, kHeaders[4]), kDataBool[i]);
+
+		EXPECT_FLOAT_EQ(gda.getFloat(i, kHeaders[3]), kDataFloat[i]);
+	}
+
+	EXPECT_EQ(gda.getInt(9999, kHeaders[0]), 0);
+	EXPECT_EQ(gda.getInt(9999, kHeaders[0], 9999), 9999);
+	EXPECT_FLOAT_EQ(gda.getFloat(9999, kHeaders[3], 9999.0f), 9999.0f);
+
+	// Columns of the wrong type still throw
+	EXPECT_THROW(gda.getInt(0, kHeaders[3]), Common::Exception);
+	EXPECT_THROW(gda.getFloat(0, kHeaders[1]), Common::Exception);
+}
+
 GTEST_TEST(GDAFile, v02) {
 	static const byte kGDAv02[] = {
 		0x47,0x46,0x46,0x20,0x56,0x34,0x2E,0x30,0x50,0x43,0x20,0x20,0x47,0x32,0x44,0x41,
@@ -368,4 +399,14 @@ GTEST_TEST(GDAFile, add) {
 
 		EXPECT_EQ(gda.getInt(index, "Value"), kIDs[i]);
 	}
+
+	// A cached column is extended by the added rows
+	Aurora::GDAFile cached(new Common::MemoryReadStream(kMGDA1));
+	EXPECT_TRUE(cached.cacheColumn("Value"));
+
+	cached.add(new Common::MemoryReadStream(kMGDA3));
+	cached.add(new Common::MemoryReadStream(kMGDA2));
+
+	for (size_t i = 0; i < ARRAYSIZE(kIDs); i++)
+		EXPECT_EQ(cached.getInt(cached.findRow(kIDs[i]), "Value"), kIDs[i]);
 }
@@ -344,3 +344,42 @@ GTEST_TEST(GFF3Writer, WriteEquivalentValues) {
 
 	delete writeStream;
 }
+
+GTEST_TEST(GFF3Writer, WriteSimilarValues) {
+	Aurora::GFF3Writer writer(MKTAG('G', 'F', 'F', ' '));
+	Aurora::GFF3WriterStructPtr strct = writer.getTopLevel();
+
+	// Different values of the same size must not share field data
+	Aurora::LocString locString1, locString2;
+	locString1.setString(Aurora::kLanguageEnglish, Aurora::kLanguageGenderMale, "Test String 1");
+	locString2.setString(Aurora::kLanguageEnglish, Aurora::kLanguageGenderMale, "Test String 2");
+
+	strct->addLocString("FieldLocString_1", locString1);
+	strct->addLocString("FieldLocString_2", locString2);
+	strct->addLocString("FieldLocString_3", locString1);
+
+	strct->addVector("FieldVector_1", glm::vec3(1.0f, 2.0f, 3.0f));
+	strct->addVector("FieldVector_2", glm::vec3(3.0f, 2.0f, 1.0f));
+
+	Common::MemoryWriteStreamDynamic writeStream(true);
+	writer.write(writeStream);
+
+	Aurora::GFF3File gff(new Common::MemoryReadStream(writeStream.getData(), writeStream.size()));
+
+	Aurora::LocString loc1, loc2, loc3;
+	EXPECT_TRUE(gff.getTopLevel().getLocString("FieldLocString_1", loc1));
+	EXPECT_TRUE(gff.getTopLevel().getLocString("FieldLocString_2", loc2));
+	EXPECT_TRUE(gff.getTopLevel().getLocString("FieldLocString_3", loc3));
+	EXPECT_EQ(loc1, locString1);
+	EXPECT_EQ(loc2, locString2);
+	EXPECT_EQ(loc3, locString1);
+
+	float x = 0.0f, y = 0.0f, z = 0.0f;
+	gff.getTopLevel().getVector("FieldVector_1", x, y, z);
+	EXPECT_EQ(x, 1.0f);
+	EXPECT_EQ(z, 3.0f);
+
+	gff.getTopLevel().getVector("FieldVector_2", x, y, z);
+	EXPECT_EQ(x, 3.0f);
+	EXPECT_EQ(z, 1.0f);
+}
@@ -37,9 +37,12 @@
 
 #include "gtest/gtest.h"
 
+#include "src/common/thread.h"
+
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/encoding.h"
+#include "src/common/readstream.h"
 #include "src/common/memreadstream.h"
 
 #include "src/aurora/gff4file.h"
@@ -130,6 +133,21 @@ GTEST_TEST(GFF4File, getPlatform) {
 	EXPECT_EQ(gff4.getPlatform(), MKTAG('P', 'C', ' ', ' '));
 }
 
+GTEST_TEST(GFF4File, loadFromStream) {
+	// Not a memory stream, so the whole file is copied into memory first
+	Common::MemoryReadStream memStream(kGFF4SingleValues);
+	memStream.seek(16);
+
+	Aurora::GFF4File gff4(new Common::SeekableSubReadStream(&memStream, 0, memStream.size()));
+	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
+
+	EXPECT_EQ(gff4.getType(), MKTAG('T', 'E', 'S', 'T'));
+
+	EXPECT_EQ(strct.getUint(256), 23);
+	EXPECT_EQ(strct.getSint(257), -23);
+	EXPECT_STREQ(strct.getString(1024).c_str(), "Barfoo");
+}
+
 GTEST_TEST(GFF4Struct, getRefCount) {
 	Aurora::GFF4File gff4(new Common::MemoryReadStream(kGFF4SingleValues));
 	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
@@ -3224,3 +3242,67 @@ GTEST_TEST(GFF4StructShared, getString) {
 	EXPECT_EQ(strRef, 23);
 	EXPECT_STREQ(tlkString.c_str(), "Foobar");
 }
+
+// --- GFF4, big endian ---
+
+static const byte kGFF4BigEndian[] = {
+	0x47,0x46,0x46,0x20,0x56,0x34,0x2E,0x30,0x50,0x53,0x33,0x20,0x54,0x45,0x53,0x54,
+	0x56,0x30,0x2E,0x31,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x50,0x54,0x4F,0x50,0x20,
+	0x00,0x00,0x00,0x03,0x00,0x00,0x00,0x2C,0x00,0x00,0x00,0x0C,0x00,0x00,0x01,0x2C,
+	0x00,0x00,0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x64,0x00,0x00,0x00,0x08,
+	0x00,0x00,0x00,0x04,0x00,0x00,0x00,0xC8,0x00,0x00,0x00,0x02,0x00,0x00,0x00,0x08,
+	0x12,0x34,0x56,0x78,0x3F,0xC0,0x00,0x00,0xBE,0xEF,0x00,0x00
+};
+
+GTEST_TEST(GFF4StructBigEndian, getFields) {
+	Aurora::GFF4File gff4(new Common::MemoryReadStream(kGFF4BigEndian));
+	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
+
+	EXPECT_TRUE(gff4.isBigEndian());
+	EXPECT_EQ(strct.getLabel(), MKTAG('T', 'O', 'P', ' '));
+
+	// The fields aren't sorted by label in the file
+	ASSERT_EQ(strct.getFieldCount(), 3);
+	ASSERT_EQ(strct.getFieldLabels().size(), 3);
+	EXPECT_EQ(strct.getFieldLabels()[0], 300);
+	EXPECT_EQ(strct.getFieldLabels()[1], 100);
+	EXPECT_EQ(strct.getFieldLabels()[2], 200);
+
+	EXPECT_EQ(strct.getUint(300), 0x12345678);
+	EXPECT_FLOAT_EQ(strct.getFloat(100), 1.5f);
+	EXPECT_EQ(strct.getUint(200), 0xBEEF);
+
+	EXPECT_FALSE(strct.hasField(0));
+	EXPECT_FALSE(strct.hasField(150));
+	EXPECT_FALSE(strct.hasField(400));
+}
+
+// --- GFF4, reading from multiple threads ---
+
+static void readSingleValues(const Aurora::GFF4Struct *strct, bool *success) {
+	*success = true;
+
+	for (int i = 0; i < 10000; i++) {
+		if ((strct->getUint(256) != 23) || (strct->getUint(262) != 26) ||
+		    (strct->getSint(257) != -23) || (strct->getString(1024) != "Barfoo"))
+			*success = false;
+	}
+}
+
+GTEST_TEST(GFF4StructThreads, readSingleValues) {
+	static const size_t kThreadCount = 4;
+
+	Aurora::GFF4File gff4(new Common::MemoryReadStream(kGFF4SingleValues));
+
+	bool success[kThreadCount];
+
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < kThreadCount; i++)
+		threads.push_back(std::thread(&readSingleValues, &gff4.getTopLevel(), &success[i]));
+
+	for (size_t i = 0; i < kThreadCount; i++) {
+		threads[i].join();
+
+		EXPECT_TRUE(success[i]) << "In thread " << i;
+	}
+}
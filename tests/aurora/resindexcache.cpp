@@ -0,0 +1,249 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our persistent archive index cache.
+ */
+
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/platform.h"
+#include "src/common/ustring.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+#include "src/common/readfile.h"
+#include "src/common/writefile.h"
+
+#include "src/aurora/erfwriter.h"
+#include "src/aurora/erffile.h"
+#include "src/aurora/resindexcache.h"
+#include "src/aurora/resman.h"
+
+static boost::filesystem::path kDirPath;
+
+static Common::UString getPath(const char *file) {
+	return (kDirPath / file).generic_string();
+}
+
+static Common::UString getResourceData(uint32 seed, uint32 index) {
+	return Common::UString::format("Resource %u of archive %u", index, seed);
+}
+
+/** Write an ERF with this many text resources into a file. */
+static void writeERF(const Common::UString &path, uint32 seed, uint32 count) {
+	Common::MemoryWriteStreamDynamic erf(true);
+
+	{
+		Aurora::ERFWriter writer(MKTAG('E', 'R', 'F', ' '), count, erf);
+
+		for (uint32 i = 0; i < count; i++) {
+			const Common::UString data = getResourceData(seed, i);
+
+			Common::MemoryReadStream stream(data.c_str());
+			writer.add(Common::UString::format("res%u_%u", seed, i), Aurora::kFileTypeTXT, stream);
+		}
+	}
+
+	Common::WriteFile file(path);
+	file.write(erf.getData(), erf.size());
+	file.flush();
+}
+
+class ResourceIndexCache : public ::testing::Test {
+protected:
+	static void SetUpTestCase() {
+		Common::Platform::init();
+
+		boost::filesystem::path tmpPath    = boost::filesystem::temp_directory_path();
+		boost::filesystem::path uniquePath = boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+
+		kDirPath = tmpPath / uniquePath;
+	}
+
+	static void TearDownTestCase() {
+		if (!kDirPath.empty())
+			boost::filesystem::remove_all(kDirPath);
+	}
+
+	void SetUp() {
+		ASSERT_FALSE(kDirPath.empty());
+
+		boost::filesystem::remove_all(kDirPath);
+		boost::filesystem::create_directories(kDirPath);
+	}
+
+	void TearDown() {
+		ResMan.clear();
+	}
+};
+
+GTEST_TEST_F(ResourceIndexCache, roundtrip) {
+	writeERF(getPath("test.erf"), 0, 4);
+
+	Aurora::ERFFile erf(new Common::ReadFile(getPath("test.erf")));
+
+	Aurora::ResourceIndexCache::ArchiveIndices indices(1);
+	ASSERT_TRUE(Aurora::ResourceIndexCache::createIndex(erf, getPath("test.erf"), indices[0]));
+
+	{
+		Aurora::ResourceIndexCache cache;
+
+		// A missing cache file is fine
+		cache.load(getPath("index.cache"));
+
+		cache.add(getPath("test.erf"), indices);
+		cache.save();
+	}
+
+	Aurora::ResourceIndexCache cache;
+	cache.load(getPath("index.cache"));
+
+	Aurora::ResourceIndexCache::ArchiveIndices cached;
+	ASSERT_TRUE(cache.find(getPath("test.erf"), cached));
+	ASSERT_EQ(cached.size(), 1);
+
+	EXPECT_STREQ(cached[0].path.c_str(), getPath("test.erf").c_str());
+	EXPECT_EQ(cached[0].size, indices[0].size);
+	EXPECT_EQ(cached[0].time, indices[0].time);
+	EXPECT_EQ(cached[0].hashAlgo, erf.getNameHashAlgo());
+
+	ASSERT_EQ(cached[0].resources.size(), erf.getResources().size());
+	ASSERT_EQ(cached[0].locations.size(), erf.getResources().size());
+
+	Aurora::Archive::ResourceList::const_iterator c = cached[0].resources.begin();
+	Aurora::Archive::ResourceList::const_iterator r = erf.getResources().begin();
+	for (; r != erf.getResources().end(); ++r, ++c) {
+		EXPECT_STREQ(c->name.c_str(), r->name.c_str());
+		EXPECT_EQ(c->hash, r->hash);
+		EXPECT_EQ(c->type, r->type);
+		EXPECT_EQ(c->index, r->index);
+
+		uint32 offset = 0, size = 0;
+		ASSERT_TRUE(erf.getResourceLocation(r->index, offset, size));
+
+		EXPECT_EQ(cached[0].locations[c->index].offset, offset);
+		EXPECT_EQ(cached[0].locations[c->index].size  , size);
+	}
+
+	EXPECT_FALSE(cache.find(getPath("other.erf"), cached));
+}
+
+GTEST_TEST_F(ResourceIndexCache, changed) {
+	writeERF(getPath("test.erf"), 0, 4);
+
+	{
+		Aurora::ERFFile erf(new Common::ReadFile(getPath("test.erf")));
+
+		Aurora::ResourceIndexCache::ArchiveIndices indices(1);
+		ASSERT_TRUE(Aurora::ResourceIndexCache::createIndex(erf, getPath("test.erf"), indices[0]));
+
+		Aurora::ResourceIndexCache cache;
+		cache.load(getPath("index.cache"));
+
+		cache.add(getPath("test.erf"), indices);
+		cache.save();
+	}
+
+	// The archive changed, so its cached index is outdated
+	writeERF(getPath("test.erf"), 0, 5);
+
+	Aurora::ResourceIndexCache cache;
+	cache.load(getPath("index.cache"));
+
+	Aurora::ResourceIndexCache::ArchiveIndices cached;
+	EXPECT_FALSE(cache.find(getPath("test.erf"), cached));
+}
+
+GTEST_TEST_F(ResourceIndexCache, broken) {
+	{
+		static const byte kGarbage[] = { 'X', 'R', 'I', 'C', 0x01, 0x00, 0x00, 0x00, 0xFF, 0xFF };
+
+		Common::WriteFile file(getPath("index.cache"));
+		file.write(kGarbage, sizeof(kGarbage));
+		file.flush();
+	}
+
+	Aurora::ResourceIndexCache cache;
+	EXPECT_NO_THROW(cache.load(getPath("index.cache")));
+
+	Aurora::ResourceIndexCache::ArchiveIndices cached;
+	EXPECT_FALSE(cache.find(getPath("test.erf"), cached));
+}
+
+static void expectResources(uint32 seed, uint32 count) {
+	for (uint32 i = 0; i < count; i++) {
+		const Common::UString name = Common::UString::format("res%u_%u", seed, i);
+
+		Common::ScopedPtr<Common::SeekableReadStream> stream(ResMan.getResource(name, Aurora::kFileTypeTXT));
+		ASSERT_TRUE(stream) << name.c_str();
+
+		const Common::UString data = getResourceData(seed, i);
+		ASSERT_EQ(stream->size(), data.size()) << name.c_str();
+
+		Common::ScopedArray<char> buffer(new char[data.size()]);
+		ASSERT_EQ(stream->read(buffer.get(), data.size()), data.size()) << name.c_str();
+
+		EXPECT_EQ(Common::UString(buffer.get(), data.size()), data) << name.c_str();
+	}
+}
+
+GTEST_TEST_F(ResourceIndexCache, resourceManager) {
+	writeERF(getPath("a.erf"), 1, 8);
+	writeERF(getPath("b.erf"), 2, 8);
+
+	// Cold: parse the archives and fill the cache
+	ResMan.registerDataBase(kDirPath.generic_string());
+	ResMan.setIndexCache(getPath("index.cache"));
+
+	ResMan.indexArchive("a.erf", 10);
+	ResMan.indexArchive("b.erf", 11);
+
+	expectResources(1, 8);
+	expectResources(2, 8);
+
+	ResMan.saveIndexCache();
+	ResMan.clear();
+
+	ASSERT_TRUE(boost::filesystem::exists(kDirPath / "index.cache"));
+
+	{
+		Aurora::ResourceIndexCache cache;
+		cache.load(getPath("index.cache"));
+
+		Aurora::ResourceIndexCache::ArchiveIndices cached;
+		EXPECT_TRUE(cache.find(getPath("a.erf"), cached));
+		EXPECT_TRUE(cache.find(getPath("b.erf"), cached));
+	}
+
+	// Warm: index the archives out of the cache
+	ResMan.registerDataBase(kDirPath.generic_string());
+	ResMan.setIndexCache(getPath("index.cache"));
+
+	ResMan.indexArchive("a.erf", 10);
+	ResMan.indexArchive("b.erf", 11);
+
+	expectResources(1, 8);
+	expectResources(2, 8);
+
+	EXPECT_FALSE(ResMan.hasResource("res1_8", Aurora::kFileTypeTXT));
+}
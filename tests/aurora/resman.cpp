@@ -0,0 +1,291 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our global resource manager.
+ */
+
+#include <cstring>
+
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/platform.h"
+#include "src/common/ustring.h"
+#include "src/common/scopedptr.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+#include "src/common/readfile.h"
+#include "src/common/writefile.h"
+
+#include "src/aurora/erfwriter.h"
+#include "src/aurora/resman.h"
+
+static boost::filesystem::path kDirPath;
+
+static const uint32 kBIFCount         = 8;
+static const uint32 kERFCount         = 8;
+static const uint32 kResourcesPerFile = 64;
+
+static Common::UString getPath(const Common::UString &file) {
+	return (kDirPath / file.c_str()).generic_string();
+}
+
+static Common::UString getResourceName(uint32 index) {
+	return Common::UString::format("res%u", index);
+}
+
+static Common::UString getResourceData(const char *file, uint32 seed, uint32 index) {
+	return Common::UString::format("Resource %u of %s %u", index, file, seed);
+}
+
+static void writeFile(const Common::UString &path, Common::MemoryWriteStreamDynamic &data) {
+	Common::WriteFile file(path);
+	file.write(data.getData(), data.size());
+	file.flush();
+}
+
+/** Write a BIF V1 with kResourcesPerFile text resources. */
+static void writeBIF(const Common::UString &path, uint32 seed) {
+	Common::MemoryWriteStreamDynamic bif(true);
+
+	bif.writeString("BIFFV1  ");
+	bif.writeUint32LE(kResourcesPerFile);
+	bif.writeUint32LE(0);
+	bif.writeUint32LE(20);
+
+	uint32 offset = 20 + kResourcesPerFile * 16;
+	for (uint32 i = 0; i < kResourcesPerFile; i++) {
+		const uint32 size = getResourceData("BIF", seed, i).size();
+
+		bif.writeUint32LE(i);
+		bif.writeUint32LE(offset);
+		bif.writeUint32LE(size);
+		bif.writeUint32LE(Aurora::kFileTypeTXT);
+
+		offset += size;
+	}
+
+	for (uint32 i = 0; i < kResourcesPerFile; i++)
+		bif.writeString(getResourceData("BIF", seed, i));
+
+	writeFile(path, bif);
+}
+
+/** Write a KEY V1 for kBIFCount BIFs, data/0.bif to data/7.bif. */
+static void writeKEY(const Common::UString &path) {
+	Common::MemoryWriteStreamDynamic key(true);
+
+	static const uint32 kNameSize = 10; // "data\0.bif"
+
+	const uint32 offFileTable = 64;
+	const uint32 offNames     = offFileTable + kBIFCount * 12;
+	const uint32 offResTable  = offNames + kBIFCount * kNameSize;
+
+	key.writeString("KEY V1  ");
+	key.writeUint32LE(kBIFCount);
+	key.writeUint32LE(kBIFCount * kResourcesPerFile);
+	key.writeUint32LE(offFileTable);
+	key.writeUint32LE(offResTable);
+	key.writeUint32LE(0);
+	key.writeUint32LE(0);
+
+	for (uint32 i = 0; i < 8; i++)
+		key.writeUint32LE(0);
+
+	for (uint32 i = 0; i < kBIFCount; i++) {
+		key.writeUint32LE(0);
+		key.writeUint32LE(offNames + i * kNameSize);
+		key.writeUint16LE(kNameSize);
+		key.writeUint16LE(0);
+	}
+
+	for (uint32 i = 0; i < kBIFCount; i++)
+		key.writeString(Common::UString::format("data\\%u.bif", i));
+
+	for (uint32 i = 0; i < kBIFCount; i++) {
+		for (uint32 j = 0; j < kResourcesPerFile; j++) {
+			// Every BIF shares half of its names with the next BIF
+			const Common::UString name = getResourceName(1000 + i * (kResourcesPerFile / 2) + j);
+
+			byte resRef[16] = { 0 };
+			std::memcpy(resRef, name.c_str(), MIN<size_t>(name.size(), sizeof(resRef)));
+
+			key.write(resRef, sizeof(resRef));
+			key.writeUint16LE(Aurora::kFileTypeTXT);
+			key.writeUint32LE((i << 20) | j);
+		}
+	}
+
+	writeFile(path, key);
+}
+
+/** Write an ERF with kResourcesPerFile text resources. */
+static void writeERF(const Common::UString &path, uint32 seed) {
+	Common::MemoryWriteStreamDynamic erf(true);
+
+	{
+		Aurora::ERFWriter writer(MKTAG('E', 'R', 'F', ' '), kResourcesPerFile, erf);
+
+		for (uint32 i = 0; i < kResourcesPerFile; i++) {
+			const Common::UString data = getResourceData("ERF", seed, i);
+
+			Common::MemoryReadStream stream(data.c_str());
+			// Every ERF shares half of its names with the next ERF
+			writer.add(getResourceName(seed * (kResourcesPerFile / 2) + i), Aurora::kFileTypeTXT, stream);
+		}
+	}
+
+	writeFile(path, erf);
+}
+
+static Common::UString readFile(const Common::UString &path) {
+	Common::ReadFile file(path);
+
+	Common::ScopedArray<char> data(new char[file.size()]);
+	if (file.read(data.get(), file.size()) != file.size())
+		throw Common::Exception(Common::kReadError);
+
+	return Common::UString(data.get(), file.size());
+}
+
+static Common::UString readResource(const Common::UString &name) {
+	Common::ScopedPtr<Common::SeekableReadStream> stream(ResMan.getResource(name, Aurora::kFileTypeTXT));
+	if (!stream)
+		return "";
+
+	Common::ScopedArray<char> data(new char[stream->size()]);
+	if (stream->read(data.get(), stream->size()) != stream->size())
+		throw Common::Exception(Common::kReadError);
+
+	return Common::UString(data.get(), stream->size());
+}
+
+class ResourceManager : public ::testing::Test {
+protected:
+	static void SetUpTestCase() {
+		Common::Platform::init();
+
+		boost::filesystem::path tmpPath    = boost::filesystem::temp_directory_path();
+		boost::filesystem::path uniquePath = boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+
+		kDirPath = tmpPath / uniquePath;
+
+		boost::filesystem::create_directories(kDirPath / "data");
+		boost::filesystem::create_directories(kDirPath / "dumps");
+
+		for (uint32 i = 0; i < kBIFCount; i++)
+			writeBIF(getPath(Common::UString::format("data/%u.bif", i)), i);
+
+		writeKEY(getPath("chitin.key"));
+
+		for (uint32 i = 0; i < kERFCount; i++)
+			writeERF(getPath(Common::UString::format("%u.erf", i)), i);
+	}
+
+	static void TearDownTestCase() {
+		if (!kDirPath.empty())
+			boost::filesystem::remove_all(kDirPath);
+	}
+
+	void TearDown() {
+		ResMan.clear();
+	}
+
+	/** Index the KEY and all ERFs, pairs of ERFs sharing the same priority. */
+	static void indexAll(bool parallel) {
+		ResMan.setParallelIndexing(parallel);
+
+		ResMan.registerDataBase(kDirPath.generic_string());
+		ResMan.indexResourceDir("data", 0, 0, 2);
+
+		if (!parallel) {
+			ResMan.indexArchive("chitin.key", 10);
+
+			for (uint32 i = 0; i < kERFCount; i++)
+				ResMan.indexArchive(Common::UString::format("%u.erf", i), 20 + i / 2);
+
+			return;
+		}
+
+		Aurora::ResourceManager::BatchArchives archives;
+
+		archives.push_back(Aurora::ResourceManager::BatchArchive("chitin.key", 10));
+		for (uint32 i = 0; i < kERFCount; i++)
+			archives.push_back(Aurora::ResourceManager::BatchArchive(Common::UString::format("%u.erf", i), 20 + i / 2));
+
+		EXPECT_EQ(ResMan.indexArchives(archives), kERFCount + 1);
+	}
+};
+
+GTEST_TEST_F(ResourceManager, indexArchivesDeterministic) {
+	indexAll(false);
+	ResMan.dumpResourcesList(getPath("dumps/serial.txt"));
+	ResMan.clear();
+
+	indexAll(true);
+	ResMan.dumpResourcesList(getPath("dumps/parallel.txt"));
+
+	const Common::UString serial   = readFile(getPath("dumps/serial.txt"));
+	const Common::UString parallel = readFile(getPath("dumps/parallel.txt"));
+
+	EXPECT_FALSE(serial.empty());
+	EXPECT_EQ(serial, parallel);
+
+	// Of two archives with the same priority, the later one wins
+	EXPECT_EQ(readResource("res32"), getResourceData("ERF", 1, 0));
+	// Of two BIFs in the same KEY, the later one wins
+	EXPECT_EQ(readResource("res1040"), getResourceData("BIF", 1, 8));
+}
+
+GTEST_TEST_F(ResourceManager, indexArchivesOptional) {
+	ResMan.registerDataBase(kDirPath.generic_string());
+
+	Aurora::ResourceManager::BatchArchives archives;
+
+	archives.push_back(Aurora::ResourceManager::BatchArchive("0.erf"      , 10));
+	archives.push_back(Aurora::ResourceManager::BatchArchive("missing.erf", 11, true));
+	archives.push_back(Aurora::ResourceManager::BatchArchive("1.erf"      , 12));
+
+	EXPECT_EQ(ResMan.indexArchives(archives), 2);
+
+	EXPECT_EQ(readResource("res0") , getResourceData("ERF", 0,  0));
+	EXPECT_EQ(readResource("res32"), getResourceData("ERF", 1,  0));
+	EXPECT_EQ(readResource("res95"), getResourceData("ERF", 1, 63));
+}
+
+GTEST_TEST_F(ResourceManager, indexArchivesMandatory) {
+	ResMan.registerDataBase(kDirPath.generic_string());
+
+	Aurora::ResourceManager::BatchArchives archives;
+
+	archives.push_back(Aurora::ResourceManager::BatchArchive("0.erf"      , 10));
+	archives.push_back(Aurora::ResourceManager::BatchArchive("missing.erf", 11));
+
+	EXPECT_THROW(ResMan.indexArchives(archives), Common::Exception);
+
+	// The archives before the missing one were still indexed
+	EXPECT_EQ(readResource("res0"), getResourceData("ERF", 0, 0));
+}
@@ -189,3 +189,13 @@ check_PROGRAMS                     += tests/aurora/test_xmlfixer
 tests_aurora_test_xmlfixer_SOURCES  = tests/aurora/xmlfixer.cpp
 tests_aurora_test_xmlfixer_LDADD    = $(aurora_LIBS)
 tests_aurora_test_xmlfixer_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                          += tests/aurora/test_resindexcache
+tests_aurora_test_resindexcache_SOURCES  = tests/aurora/resindexcache.cpp
+tests_aurora_test_resindexcache_LDADD    = $(aurora_LIBS)
+tests_aurora_test_resindexcache_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                   += tests/aurora/test_resman
+tests_aurora_test_resman_SOURCES  = tests/aurora/resman.cpp
+tests_aurora_test_resman_LDADD    = $(aurora_LIBS)
+tests_aurora_test_resman_CXXFLAGS = $(test_CXXFLAGS)
@@ -151,6 +151,44 @@ GTEST_TEST(TalkTable_TLK05, getString) {
 	EXPECT_STREQ(tlk.getString(5).c_str(), "");
 }
 
+GTEST_TEST(TalkTable_TLK05, prewarm) {
+	Aurora::TalkTable_GFF tlk(new Common::MemoryReadStream(kTLKV05), Common::kEncodingUTF16LE);
+
+	tlk.prewarm(0, 6);
+
+	EXPECT_STREQ(tlk.getString(0).c_str(), "Foobar");
+	EXPECT_STREQ(tlk.getString(1).c_str(), "");
+	EXPECT_STREQ(tlk.getString(2).c_str(), "");
+	EXPECT_STREQ(tlk.getString(3).c_str(), "");
+	EXPECT_STREQ(tlk.getString(4).c_str(), "Barfoo");
+}
+
+GTEST_TEST(TalkTable_TLK05, prewarmAll) {
+	Aurora::TalkTable_GFF tlk(new Common::MemoryReadStream(kTLKV05), Common::kEncodingUTF16LE);
+
+	tlk.prewarm();
+
+	EXPECT_STREQ(tlk.getString(0).c_str(), "Foobar");
+	EXPECT_STREQ(tlk.getString(1).c_str(), "");
+	EXPECT_STREQ(tlk.getString(2).c_str(), "");
+	EXPECT_STREQ(tlk.getString(3).c_str(), "");
+	EXPECT_STREQ(tlk.getString(4).c_str(), "Barfoo");
+}
+
+GTEST_TEST(TalkTable_TLK05, getStringView) {
+	Aurora::TalkTable_GFF tlk(new Common::MemoryReadStream(kTLKV05), Common::kEncodingUTF16LE);
+
+	const Common::StringView string0 = tlk.getStringView(0);
+	EXPECT_STREQ(string0.data, "Foobar");
+	EXPECT_EQ(string0.size, 6U);
+
+	EXPECT_TRUE(tlk.getStringView(1).empty());
+	EXPECT_TRUE(tlk.getStringView(3).empty());
+	EXPECT_STREQ(tlk.getStringView(4).data, "Barfoo");
+
+	EXPECT_STREQ(tlk.getStringView(5).data, "");
+}
+
 GTEST_TEST(TalkTable_TLK05, getSoundResRef) {
 	Aurora::TalkTable_GFF tlk(new Common::MemoryReadStream(kTLKV05), Common::kEncodingUTF16LE);
 
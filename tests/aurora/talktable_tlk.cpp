@@ -27,6 +27,7 @@
 #include "src/common/util.h"
 #include "src/common/encoding.h"
 #include "src/common/memreadstream.h"
+#include "src/common/readstream.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/talktable.h"
@@ -83,6 +84,59 @@ GTEST_TEST(TalkTable_TLK30, getString) {
 	EXPECT_STREQ(tlk.getString(5000).c_str(), "");
 }
 
+GTEST_TEST(TalkTable_TLK30, getStringFromStream) {
+	// A stream that's not directly in memory
+	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kTLKV30);
+	Aurora::TalkTable_TLK tlk(new Common::SeekableSubReadStream(stream, 0, stream->size(), true),
+	                          Common::kEncodingUTF8);
+
+	EXPECT_STREQ(tlk.getString(0).c_str(), "Foobar");
+	EXPECT_STREQ(tlk.getString(1).c_str(), "");
+	EXPECT_STREQ(tlk.getString(2).c_str(), "Barfoo");
+}
+
+GTEST_TEST(TalkTable_TLK30, prewarm) {
+	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kTLKV30);
+	Aurora::TalkTable_TLK tlk(stream, Common::kEncodingUTF8);
+
+	tlk.prewarm(0, 5000);
+	tlk.prewarm(0xFFFFFFF0, 0xFFFFFFFF);
+
+	EXPECT_STREQ(tlk.getString(0).c_str(), "Foobar");
+	EXPECT_STREQ(tlk.getString(1).c_str(), "");
+	EXPECT_STREQ(tlk.getString(2).c_str(), "Barfoo");
+}
+
+GTEST_TEST(TalkTable_TLK30, prewarmAll) {
+	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kTLKV30);
+	Aurora::TalkTable_TLK tlk(stream, Common::kEncodingUTF8);
+
+	tlk.prewarm();
+
+	EXPECT_STREQ(tlk.getString(0).c_str(), "Foobar");
+	EXPECT_STREQ(tlk.getString(1).c_str(), "");
+	EXPECT_STREQ(tlk.getString(2).c_str(), "Barfoo");
+}
+
+GTEST_TEST(TalkTable_TLK30, getStringView) {
+	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kTLKV30);
+	Aurora::TalkTable_TLK tlk(stream, Common::kEncodingUTF8);
+
+	const Common::StringView string0 = tlk.getStringView(0);
+	EXPECT_STREQ(string0.data, "Foobar");
+	EXPECT_EQ(string0.size, 6U);
+
+	EXPECT_TRUE(tlk.getStringView(1).empty());
+	EXPECT_STREQ(tlk.getStringView(2).data, "Barfoo");
+
+	EXPECT_TRUE(tlk.getStringView(3).empty());
+	EXPECT_STREQ(tlk.getStringView(5000).data, "");
+
+	// The view and the string agree, and asking again doesn't decode anew
+	EXPECT_STREQ(tlk.getString(0).c_str(), "Foobar");
+	EXPECT_EQ(tlk.getStringView(0).data, string0.data);
+}
+
 GTEST_TEST(TalkTable_TLK30, getSoundResRef) {
 	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kTLKV30);
 	Aurora::TalkTable_TLK tlk(stream, Common::kEncodingUTF8);
@@ -24,6 +24,8 @@
 
 #include "gtest/gtest.h"
 
+#include "src/common/util.h"
+
 #include "src/aurora/util.h"
 
 static void destroyTypeMan() {
@@ -39,3 +41,42 @@ GTEST_TEST(AuroraUtil, getFileType) {
 
 	destroyTypeMan();
 }
+
+GTEST_TEST(AuroraUtil, hashFileName) {
+	const char *kNames[] = {
+		"file", "FILE", "file.tga", "File.TGA", "file.name.tga", "file.", ".file", "..", ".",
+		"", "path/to/file", "path.to/file", "path/to/file.tga", "path/to/", "path/.", "path/..",
+		"\xC3\xA4\xC3\x84.Tga"
+	};
+
+	const Aurora::FileType kTypes[] = {
+		Aurora::kFileTypeNone, Aurora::kFileTypeTGA, Aurora::kFileTypeSMALL, Aurora::kFileTypeMAXArchive
+	};
+
+	for (size_t i = 0; i < ARRAYSIZE(kNames); i++) {
+		for (size_t j = 0; j < ARRAYSIZE(kTypes); j++) {
+			for (int algo = 0; algo < Common::kHashMAX; algo++) {
+				const Common::UString name = TypeMan.setFileType(kNames[i], kTypes[j]).toLower();
+
+				Common::Hasher hasher((Common::HashAlgo) algo);
+				TypeMan.hashFileName(hasher, kNames[i], kTypes[j]);
+
+				EXPECT_EQ(hasher.getHash(), Common::hashString(name, (Common::HashAlgo) algo))
+					<< "\"" << kNames[i] << "\" (\"" << name.c_str() << "\"), " << kTypes[j] << ", " << algo;
+
+				// And with another type added, for names that still have a file name left
+				if (name.empty() || (*--name.end() == '/') || (*--name.end() == '.'))
+					continue;
+
+				const Common::UString smallName = TypeMan.addFileType(name, Aurora::kFileTypeSMALL);
+
+				TypeMan.hashFileType(hasher, Aurora::kFileTypeSMALL);
+
+				EXPECT_EQ(hasher.getHash(), Common::hashString(smallName, (Common::HashAlgo) algo))
+					<< "\"" << kNames[i] << "\" (\"" << smallName.c_str() << "\"), " << kTypes[j] << ", " << algo;
+			}
+		}
+	}
+
+	destroyTypeMan();
+}
@@ -25,6 +25,7 @@
 #include "gtest/gtest.h"
 
 #include "src/common/util.h"
+#include "src/common/error.h"
 #include "src/common/memreadstream.h"
 #include "src/common/bitstream.h"
 
@@ -192,3 +193,107 @@ GTEST_TEST(BitStream, BitStream64BELSB) {
 
 	testBitStream(bitStream, compValues);
 }
+
+/** Read n bits one by one, in the order the stream hands them out. */
+static uint32 getBitsSingly(Common::BitStream &bitStream, size_t n) {
+	uint32 x = 0;
+	for (size_t i = 0; i < n; i++)
+		bitStream.addBit(x, i);
+
+	return x;
+}
+
+template<class BitStreamType>
+static void testGetBitsSpanning() {
+	static const byte data[16] = {
+		0x12, 0x34, 0x56, 0x78, 0x90, 0xAB, 0xCD, 0xEF,
+		0xFE, 0xDC, 0xBA, 0x09, 0x87, 0x65, 0x43, 0x21
+	};
+	static const size_t counts[] = { 3, 7, 13, 1, 32, 5, 17, 22, 9, 11 };
+
+	Common::MemoryReadStream stream1(data), stream2(data);
+	BitStreamType bitStream1(stream1), bitStream2(stream2);
+
+	for (size_t i = 0; i < ARRAYSIZE(counts); i++) {
+		const uint32 peeked = bitStream1.peekBits(counts[i]);
+
+		EXPECT_EQ(bitStream1.getBits(counts[i]), getBitsSingly(bitStream2, counts[i])) << "At index " << i;
+		EXPECT_EQ(bitStream1.pos(), bitStream2.pos()) << "At index " << i;
+
+		bitStream1.rewind();
+		bitStream1.skip(bitStream2.pos() - counts[i]);
+
+		EXPECT_EQ(bitStream1.peekBits(counts[i]), peeked) << "At index " << i;
+		EXPECT_EQ(bitStream1.getBits(counts[i]), peeked) << "At index " << i;
+	}
+}
+
+GTEST_TEST(BitStream, getBitsSpanning) {
+	testGetBitsSpanning<Common::BitStream8MSB>();
+	testGetBitsSpanning<Common::BitStream8LSB>();
+	testGetBitsSpanning<Common::BitStream16LEMSB>();
+	testGetBitsSpanning<Common::BitStream32LELSB>();
+	testGetBitsSpanning<Common::BitStream64BEMSB>();
+	testGetBitsSpanning<Common::BitStream64BELSB>();
+}
+
+template<class BitStreamType>
+static void testGetBits32(uint32 first, uint32 second) {
+	static const byte data[8] = { 0x12, 0x34, 0x56, 0x78, 0x90, 0xAB, 0xCD, 0xEF };
+
+	Common::MemoryReadStream stream(data);
+	BitStreamType bitStream(stream);
+
+	// Whole values read at once
+	EXPECT_EQ(bitStream.getBits(32), first);
+	EXPECT_EQ(bitStream.getBits(32), second);
+}
+
+GTEST_TEST(BitStream, getBits32) {
+	testGetBits32<Common::BitStream32BEMSB>(0x12345678, 0x90ABCDEF);
+	testGetBits32<Common::BitStream32LEMSB>(0x78563412, 0xEFCDAB90);
+	testGetBits32<Common::BitStream32LELSB>(0x78563412, 0xEFCDAB90);
+	testGetBits32<Common::BitStream64BEMSB>(0x12345678, 0x90ABCDEF);
+}
+
+GTEST_TEST(BitStream, peekBits) {
+	static const byte data[2] = { 0x12, 0x34 };
+
+	Common::MemoryReadStream stream(data);
+	Common::BitStream8MSB bitStream(stream);
+
+	EXPECT_EQ(bitStream.peekBits(4), 0x1);
+	EXPECT_EQ(bitStream.peekBits(12), 0x123);
+	EXPECT_EQ(bitStream.pos(), 0);
+
+	bitStream.skip(4);
+
+	EXPECT_EQ(bitStream.peekBits(8), 0x23);
+	EXPECT_EQ(bitStream.pos(), 4);
+
+	// Bits past the end of the stream are read as 0
+	bitStream.skip(8);
+
+	EXPECT_EQ(bitStream.peekBits(8), 0x40);
+	EXPECT_EQ(bitStream.pos(), 12);
+	EXPECT_EQ(bitStream.getBits(4), 0x4);
+
+	EXPECT_EQ(bitStream.peekBits(8), 0x00);
+	EXPECT_THROW(bitStream.getBit(), Common::Exception);
+}
+
+GTEST_TEST(BitStream, peekBitsLSB) {
+	static const byte data[2] = { 0x12, 0x34 };
+
+	Common::MemoryReadStream stream(data);
+	Common::BitStream8LSB bitStream(stream);
+
+	EXPECT_EQ(bitStream.peekBits(4), 0x2);
+	EXPECT_EQ(bitStream.peekBits(12), 0x412);
+	EXPECT_EQ(bitStream.pos(), 0);
+
+	bitStream.skip(12);
+
+	EXPECT_EQ(bitStream.peekBits(8), 0x03);
+	EXPECT_EQ(bitStream.getBits(4), 0x3);
+}
@@ -22,6 +22,10 @@
  *  Unit tests for our DEFLATE decompressor (which uses zlib).
  */
 
+#include <vector>
+
+#include <zlib.h>
+
 #include "gtest/gtest.h"
 
 #include "src/common/deflate.h"
@@ -282,3 +286,177 @@ GTEST_TEST(DEFLATE, decompressChunked) {
 
 	delete[] output;
 }
+
+GTEST_TEST(DEFLATE, inflateStream) {
+	static const size_t kSizeDecompressed = strlen(kDataUncompressed);
+
+	Common::InflateReadStream decompressed(new Common::MemoryReadStream(kDataCompressed),
+	                                       kSizeDecompressed, Common::kWindowBitsMaxRaw);
+
+	ASSERT_EQ(decompressed.size(), kSizeDecompressed);
+
+	for (size_t i = 0; i < kSizeDecompressed; i++)
+		EXPECT_EQ(decompressed.readByte(), kDataUncompressed[i]) << "At index " << i;
+
+	EXPECT_FALSE(decompressed.eos());
+
+	byte data;
+	EXPECT_EQ(decompressed.read(&data, 1), 0);
+	EXPECT_TRUE(decompressed.eos());
+}
+
+GTEST_TEST(DEFLATE, inflateStreamSeek) {
+	static const size_t kSizeDecompressed = strlen(kDataUncompressed);
+
+	Common::InflateReadStream decompressed(new Common::MemoryReadStream(kDataCompressed),
+	                                       kSizeDecompressed, Common::kWindowBitsMaxRaw);
+
+	decompressed.seek(100);
+	EXPECT_EQ(decompressed.readByte(), kDataUncompressed[100]);
+
+	decompressed.seek(10);
+	EXPECT_EQ(decompressed.readByte(), kDataUncompressed[10]);
+
+	decompressed.seek(-1, Common::SeekableReadStream::kOriginEnd);
+	EXPECT_EQ(decompressed.readByte(), kDataUncompressed[kSizeDecompressed - 1]);
+
+	decompressed.seek(0);
+	EXPECT_EQ(decompressed.readByte(), kDataUncompressed[0]);
+
+	EXPECT_THROW(decompressed.seek(kSizeDecompressed + 1), Common::Exception);
+}
+
+GTEST_TEST(DEFLATE, inflateStreamFailOutputBig) {
+	static const size_t kSizeDecompressed = strlen(kDataUncompressed) * 2;
+
+	Common::InflateReadStream decompressed(new Common::MemoryReadStream(kDataCompressed),
+	                                       kSizeDecompressed, Common::kWindowBitsMaxRaw);
+
+	std::vector<byte> data(kSizeDecompressed);
+	EXPECT_THROW(decompressed.read(&data[0], data.size()), Common::Exception);
+}
+
+GTEST_TEST(DEFLATE, inflateStreamFailInputCut) {
+	static const size_t kSizeCompressed   = sizeof(kDataCompressed) / 2;
+	static const size_t kSizeDecompressed = strlen(kDataUncompressed);
+
+	Common::InflateReadStream decompressed(new Common::MemoryReadStream(kDataCompressed, kSizeCompressed),
+	                                       kSizeDecompressed, Common::kWindowBitsMaxRaw);
+
+	std::vector<byte> data(kSizeDecompressed);
+	EXPECT_THROW(decompressed.read(&data[0], data.size()), Common::Exception);
+}
+
+/** Create a few MB of reproducible, compressible text. */
+static void createText(std::vector<byte> &data, size_t size) {
+	static const char * const kWords[] = {
+		"king ", "of ", "kings ", "look ", "on ", "my ", "works ", "ye ", "mighty ", "and ", "despair\n"
+	};
+
+	uint32 seed = 0;
+
+	data.clear();
+	while (data.size() < size) {
+		seed = seed * 1664525 + 1013904223;
+
+		const char *word = kWords[(seed >> 16) % ARRAYSIZE(kWords)];
+
+		data.insert(data.end(), word, word + strlen(word));
+	}
+
+	data.resize(size);
+}
+
+GTEST_TEST(DEFLATE, inflateStreamLarge) {
+	static const size_t kSizeDecompressed = 6 * 1024 * 1024;
+
+	std::vector<byte> uncompressed;
+	createText(uncompressed, kSizeDecompressed);
+
+	uLongf compressedSize = compressBound(kSizeDecompressed);
+	byte *compressed = new byte[compressedSize];
+
+	ASSERT_EQ(compress(compressed, &compressedSize, &uncompressed[0], kSizeDecompressed), Z_OK);
+
+	// Zlib header, so positive window size
+	Common::InflateReadStream decompressed(new Common::MemoryReadStream(compressed, compressedSize, true),
+	                                       kSizeDecompressed, Common::kWindowBitsMax);
+
+	std::vector<byte> data(kSizeDecompressed);
+	ASSERT_EQ(decompressed.read(&data[0], data.size()), kSizeDecompressed);
+	EXPECT_TRUE(data == uncompressed);
+
+	// Inflating everything once should have left us with a few restart points
+	EXPECT_GE(decompressed.getRestartPointCount(), 4);
+
+	// Jump around a bit and make sure we always read the correct data
+	uint32 seed = 0;
+	for (size_t i = 0; i < 64; i++) {
+		seed = seed * 1664525 + 1013904223;
+
+		const size_t offset = seed % (kSizeDecompressed - 256);
+
+		decompressed.seek(offset);
+		ASSERT_EQ(decompressed.read(&data[0], 256), 256);
+
+		for (size_t j = 0; j < 256; j++)
+			ASSERT_EQ(data[j], uncompressed[offset + j]) << "At offset " << offset << " + " << j;
+	}
+}
+
+/** A memory stream counting how many bytes have been read out of it. */
+class CountingReadStream : public Common::MemoryReadStream {
+public:
+	CountingReadStream(const byte *data, size_t size, bool dispose) :
+		Common::MemoryReadStream(data, size, dispose), _bytesRead(0) {
+	}
+
+	size_t read(void *dataPtr, size_t dataSize) {
+		const size_t n = Common::MemoryReadStream::read(dataPtr, dataSize);
+
+		_bytesRead += n;
+		return n;
+	}
+
+	size_t getBytesRead() const {
+		return _bytesRead;
+	}
+
+private:
+	size_t _bytesRead;
+};
+
+GTEST_TEST(DEFLATE, inflateStreamSeekBackWrapped) {
+	static const size_t kSizeDecompressed = 256 * 1024;
+
+	std::vector<byte> uncompressed;
+	createText(uncompressed, kSizeDecompressed);
+
+	uLongf compressedSize = compressBound(kSizeDecompressed);
+	byte *compressed = new byte[compressedSize];
+
+	ASSERT_EQ(compress(compressed, &compressedSize, &uncompressed[0], kSizeDecompressed), Z_OK);
+
+	CountingReadStream *input = new CountingReadStream(compressed, compressedSize, true);
+	Common::InflateReadStream decompressed(input, kSizeDecompressed, Common::kWindowBitsMax);
+
+	// Read far enough that the ring buffer has wrapped around a few times, ending just behind a wrap
+	static const size_t kOffset = 3 * 32768 + 1000;
+
+	std::vector<byte> data(kOffset);
+	ASSERT_EQ(decompressed.read(&data[0], kOffset), kOffset);
+
+	const size_t inputRead = input->getBytesRead();
+
+	// Seek back over the wrap, but still within the last 32KB
+	static const size_t kBack = 30000;
+
+	decompressed.seek(kOffset - kBack);
+	ASSERT_EQ(decompressed.read(&data[0], kBack), kBack);
+
+	for (size_t i = 0; i < kBack; i++)
+		ASSERT_EQ(data[i], uncompressed[kOffset - kBack + i]) << "At offset " << (kOffset - kBack + i);
+
+	// That should have come straight out of the ring buffer, without inflating anything again
+	EXPECT_EQ(input->getBytesRead(), inputRead);
+}
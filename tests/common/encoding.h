@@ -28,9 +28,12 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include <vector>
+
 #include "tests/skip.h"
 
 #include "src/common/encoding.h"
+#include "src/common/threads.h"
 
 static void testSupport(Common::Encoding encoding) {
 	if (Common::hasSupportEncoding(encoding))
@@ -36,6 +36,22 @@ GTEST_TEST(XOREOS_ENCODINGNAME, readString) {
 	EXPECT_STREQ(string.c_str(), stringUString.c_str());
 }
 
+GTEST_TEST(XOREOS_ENCODINGNAME, readStringParallel) {
+	testSupport(kEncoding);
+
+	// Lots of conversions at the same time must not trip over each other's state
+	std::vector<Common::UString> strings(256);
+
+	Common::runParallel(strings.size(), [&strings](size_t i) {
+		Common::MemoryReadStream stream(stringData0X);
+
+		strings[i] = Common::readString(stream, kEncoding);
+	});
+
+	for (size_t i = 0; i < strings.size(); i++)
+		EXPECT_STREQ(strings[i].c_str(), stringUString.c_str()) << "At index " << i;
+}
+
 GTEST_TEST(XOREOS_ENCODINGNAME, readStringFixed) {
 	testSupport(kEncoding);
 
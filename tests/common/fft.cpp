@@ -0,0 +1,228 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the FFT, and the MDCT, RDFT and DCT built on it.
+ */
+
+#include <cmath>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/maths.h"
+#include "src/common/fft.h"
+#include "src/common/mdct.h"
+#include "src/common/rdft.h"
+#include "src/common/dct.h"
+
+static const Common::TransformKernels kSIMDKernels[] = {
+	Common::kTransformKernelsSSE,
+	Common::kTransformKernelsAVX
+};
+
+static const char * const kKernelNames[] = { "auto", "scalar", "SSE", "AVX" };
+
+/** Fill with reproducible values between -1.0 and 1.0. */
+static void fillRandom(std::vector<float> &data, uint32 seed) {
+	for (std::vector<float>::iterator d = data.begin(); d != data.end(); ++d) {
+		seed = seed * 1664525 + 1013904223;
+
+		*d = ((seed >> 8) / (float) (1 << 23)) - 1.0f;
+	}
+}
+
+/** Expect both outputs to be the same, within float precision. */
+static void expectSame(const std::vector<float> &expected, const std::vector<float> &actual,
+                       const char *transform, int bits, Common::TransformKernels kernels) {
+
+	ASSERT_EQ(expected.size(), actual.size());
+
+	float maxValue = 1.0f;
+	for (size_t i = 0; i < expected.size(); i++)
+		maxValue = MAX(maxValue, ABS(expected[i]));
+
+	const float tolerance = maxValue * 1e-5f;
+
+	for (size_t i = 0; i < expected.size(); i++)
+		ASSERT_NEAR(expected[i], actual[i], tolerance) << transform << ", " << bits << " bits, " <<
+		                                               kKernelNames[kernels] << " kernels, at index " << i;
+}
+
+GTEST_TEST(FFT, kernels) {
+	EXPECT_TRUE(Common::hasTransformKernels(Common::kTransformKernelsScalar));
+	EXPECT_TRUE(Common::hasTransformKernels(Common::getBestTransformKernels()));
+
+	Common::FFT fft(4, false, Common::kTransformKernelsScalar);
+	EXPECT_EQ(fft.getKernels(), Common::kTransformKernelsScalar);
+
+	Common::FFT fftAuto(4, false);
+	EXPECT_EQ(fftAuto.getKernels(), Common::getBestTransformKernels());
+}
+
+GTEST_TEST(FFT, reference) {
+	// Check the scalar FFT against a naive DFT
+	for (int bits = 2; bits <= 8; bits++) {
+		for (int inverse = 0; inverse < 2; inverse++) {
+			const int n = 1 << bits;
+
+			std::vector<float> input(2 * n);
+			fillRandom(input, bits);
+
+			std::vector<float> output(input);
+
+			Common::FFT fft(bits, inverse != 0, Common::kTransformKernelsScalar);
+			fft.permute(reinterpret_cast<Common::Complex *>(&output[0]));
+			fft.calc(reinterpret_cast<Common::Complex *>(&output[0]));
+
+			const double sign = inverse ? 1.0 : -1.0;
+
+			for (int k = 0; k < n; k++) {
+				double re = 0.0, im = 0.0;
+				for (int j = 0; j < n; j++) {
+					const double angle = sign * 2.0 * M_PI * j * k / n;
+
+					re += input[2 * j] * cos(angle) - input[2 * j + 1] * sin(angle);
+					im += input[2 * j] * sin(angle) + input[2 * j + 1] * cos(angle);
+				}
+
+				ASSERT_NEAR(output[2 * k    ], re, 1e-4) << bits << " bits, inverse " << inverse << ", at " << k;
+				ASSERT_NEAR(output[2 * k + 1], im, 1e-4) << bits << " bits, inverse " << inverse << ", at " << k;
+			}
+		}
+	}
+}
+
+GTEST_TEST(FFT, conformance) {
+	for (size_t k = 0; k < ARRAYSIZE(kSIMDKernels); k++) {
+		if (!Common::hasTransformKernels(kSIMDKernels[k]))
+			continue;
+
+		for (int bits = 2; bits <= 16; bits++) {
+			for (int inverse = 0; inverse < 2; inverse++) {
+				std::vector<float> expected(2 << bits);
+				fillRandom(expected, bits);
+
+				std::vector<float> actual(expected);
+
+				Common::FFT reference(bits, inverse != 0, Common::kTransformKernelsScalar);
+				reference.permute(reinterpret_cast<Common::Complex *>(&expected[0]));
+				reference.calc(reinterpret_cast<Common::Complex *>(&expected[0]));
+
+				Common::FFT fft(bits, inverse != 0, kSIMDKernels[k]);
+				fft.permute(reinterpret_cast<Common::Complex *>(&actual[0]));
+				fft.calc(reinterpret_cast<Common::Complex *>(&actual[0]));
+
+				expectSame(expected, actual, inverse ? "IFFT" : "FFT", bits, kSIMDKernels[k]);
+			}
+		}
+	}
+}
+
+GTEST_TEST(MDCT, conformance) {
+	for (size_t k = 0; k < ARRAYSIZE(kSIMDKernels); k++) {
+		if (!Common::hasTransformKernels(kSIMDKernels[k]))
+			continue;
+
+		for (int bits = 4; bits <= 18; bits++) {
+			const size_t n = 1 << bits;
+
+			std::vector<float> input(n);
+			fillRandom(input, bits);
+
+			Common::MDCT referenceIMDCT(bits, true, 1.0, Common::kTransformKernelsScalar);
+			Common::MDCT imdct(bits, true, 1.0, kSIMDKernels[k]);
+
+			std::vector<float> expected(n), actual(n);
+			referenceIMDCT.calcIMDCT(&expected[0], &input[0]);
+			imdct.calcIMDCT(&actual[0], &input[0]);
+
+			expectSame(expected, actual, "IMDCT", bits, kSIMDKernels[k]);
+
+			Common::MDCT referenceMDCT(bits, false, -1.0, Common::kTransformKernelsScalar);
+			Common::MDCT mdct(bits, false, -1.0, kSIMDKernels[k]);
+
+			std::vector<float> expectedHalf(n / 2), actualHalf(n / 2);
+			referenceMDCT.calcMDCT(&expectedHalf[0], &input[0]);
+			mdct.calcMDCT(&actualHalf[0], &input[0]);
+
+			expectSame(expectedHalf, actualHalf, "MDCT", bits, kSIMDKernels[k]);
+		}
+	}
+}
+
+GTEST_TEST(RDFT, conformance) {
+	static const Common::RDFT::TransformType kTypes[] = {
+		Common::RDFT::DFT_R2C, Common::RDFT::IDFT_C2R, Common::RDFT::IDFT_R2C, Common::RDFT::DFT_C2R
+	};
+
+	for (size_t k = 0; k < ARRAYSIZE(kSIMDKernels); k++) {
+		if (!Common::hasTransformKernels(kSIMDKernels[k]))
+			continue;
+
+		for (int bits = 4; bits <= 16; bits++) {
+			for (size_t t = 0; t < ARRAYSIZE(kTypes); t++) {
+				std::vector<float> expected(1 << bits);
+				fillRandom(expected, bits);
+
+				std::vector<float> actual(expected);
+
+				Common::RDFT reference(bits, kTypes[t], Common::kTransformKernelsScalar);
+				reference.calc(&expected[0]);
+
+				Common::RDFT rdft(bits, kTypes[t], kSIMDKernels[k]);
+				rdft.calc(&actual[0]);
+
+				expectSame(expected, actual, "RDFT", bits, kSIMDKernels[k]);
+			}
+		}
+	}
+}
+
+GTEST_TEST(DCT, conformance) {
+	static const Common::DCT::TransformType kTypes[] = {
+		Common::DCT::DCT_II, Common::DCT::DCT_III, Common::DCT::DCT_I, Common::DCT::DST_I
+	};
+
+	for (size_t k = 0; k < ARRAYSIZE(kSIMDKernels); k++) {
+		if (!Common::hasTransformKernels(kSIMDKernels[k]))
+			continue;
+
+		for (int bits = 4; bits <= 14; bits++) {
+			for (size_t t = 0; t < ARRAYSIZE(kTypes); t++) {
+				// DCT-I works on n + 1 values
+				std::vector<float> expected((1 << bits) + 1);
+				fillRandom(expected, bits);
+
+				std::vector<float> actual(expected);
+
+				Common::DCT reference(bits, kTypes[t], Common::kTransformKernelsScalar);
+				reference.calc(&expected[0]);
+
+				Common::DCT dct(bits, kTypes[t], kSIMDKernels[k]);
+				dct.calc(&actual[0]);
+
+				expectSame(expected, actual, "DCT", bits, kSIMDKernels[k]);
+			}
+		}
+	}
+}
@@ -24,6 +24,7 @@
 
 #include "gtest/gtest.h"
 
+#include "src/common/util.h"
 #include "src/common/hash.h"
 
 static const char *kString = "Foobar";
@@ -63,3 +64,37 @@ GTEST_TEST(Hash, CRC32Encoding) {
 GTEST_TEST(Hash, formatHash) {
 	EXPECT_STREQ(Common::formatHash(UINT64_C(0x1234567890ABCDEF)).c_str(), "0x1234567890ABCDEF");
 }
+
+GTEST_TEST(Hash, hasher) {
+	const Common::UString kStrings[] = { "", "Foobar", "foo.bar/Baz", "\xC3\xA4\xC3\x84 Umlaut" };
+
+	for (size_t i = 0; i < ARRAYSIZE(kStrings); i++) {
+		for (int algo = 0; algo < Common::kHashMAX; algo++) {
+			Common::Hasher hasher((Common::HashAlgo) algo);
+
+			// Character by character, in two parts
+			Common::UString::iterator half = kStrings[i].begin();
+			for (size_t j = 0; j < (kStrings[i].size() / 2); j++)
+				hasher.add(*half++);
+
+			hasher.add(Common::UString(half, kStrings[i].end()));
+
+			EXPECT_EQ(hasher.getHash(), Common::hashString(kStrings[i], (Common::HashAlgo) algo)) << i << ", " << algo;
+		}
+	}
+
+	EXPECT_EQ(Common::Hasher(Common::kHashNone).getHash(), 0U);
+}
+
+GTEST_TEST(Hash, hashStringLower) {
+	const Common::UString kStrings[] = { "", "Foobar", "FOOBAR.TGA", "\xC3\xA4\xC3\x84 Umlaut" };
+
+	for (size_t i = 0; i < ARRAYSIZE(kStrings); i++) {
+		for (int algo = 0; algo < Common::kHashMAX; algo++) {
+			EXPECT_EQ(Common::hashStringLower(kStrings[i], (Common::HashAlgo) algo),
+			          Common::hashString(kStrings[i].toLower(), (Common::HashAlgo) algo)) << i << ", " << algo;
+		}
+	}
+
+	EXPECT_EQ(Common::hashStringLower("FooBar", Common::kHashDJB2), Common::hashString("foobar", Common::kHashDJB2));
+}
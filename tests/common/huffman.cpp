@@ -22,6 +22,8 @@
  *  Unit tests for our Huffman decoder.
  */
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "src/common/huffman.h"
@@ -29,6 +31,11 @@
 #include "src/common/util.h"
 #include "src/common/memreadstream.h"
 #include "src/common/bitstream.h"
+#include "src/common/membitstream.h"
+
+#include "src/sound/decoders/wmadata.h"
+
+#include "src/video/binkdata.h"
 
 static const uint32 kCodes  [] = {  0,   4,   5,   6,   7  };
 static const uint8  kLengths[] = {  1,   3,   3,   3,   3  };
@@ -120,3 +127,230 @@ GTEST_TEST(Huffman, invalidSymbol) {
 
 	EXPECT_THROW(huffman.getSymbol(bitStream), Common::Exception);
 }
+
+/** A set of canonical codes, with lengths up to 16 bits, spanning several table levels. */
+class LongCodes {
+public:
+	LongCodes() {
+		static const uint16 kLengthCounts[][2] = { { 3, 4 }, { 5, 6 }, { 8, 40 }, { 12, 500 }, { 16, 1000 } };
+
+		uint32 code = 0;
+		uint8 length = 0;
+
+		for (size_t i = 0; i < ARRAYSIZE(kLengthCounts); i++) {
+			code <<= kLengthCounts[i][0] - length;
+			length = kLengthCounts[i][0];
+
+			for (size_t j = 0; j < kLengthCounts[i][1]; j++, code++) {
+				codesMSB.push_back(code);
+				lengths.push_back(length);
+			}
+		}
+
+		// Shuffle the codes around, so that they're not sorted by length anymore
+		for (size_t i = 0; i < codesMSB.size(); i++) {
+			const size_t j = (i * 7919) % codesMSB.size();
+
+			std::swap(codesMSB[i], codesMSB[j]);
+			std::swap(lengths [i], lengths [j]);
+		}
+
+		for (size_t i = 0; i < codesMSB.size(); i++) {
+			uint32 reversed = 0;
+			for (uint8 j = 0; j < lengths[i]; j++)
+				reversed |= ((codesMSB[i] >> j) & 1) << (lengths[i] - 1 - j);
+
+			codesLSB.push_back(reversed);
+			symbols.push_back(i * 7 + 3);
+		}
+	}
+
+	/** Encode this sequence of code indices into a bit stream. */
+	void encode(const std::vector<size_t> &indices, std::vector<byte> &data, bool msbFirst) const {
+		size_t bitCount = 0;
+
+		data.clear();
+		for (std::vector<size_t>::const_iterator i = indices.begin(); i != indices.end(); ++i) {
+			for (uint8 j = 0; j < lengths[*i]; j++, bitCount++) {
+				if ((bitCount % 8) == 0)
+					data.push_back(0);
+
+				if ((codesMSB[*i] >> (lengths[*i] - 1 - j)) & 1)
+					data.back() |= msbFirst ? (0x80 >> (bitCount % 8)) : (1 << (bitCount % 8));
+			}
+		}
+
+		// Pad to full 32-bit words
+		while ((data.size() % 4) != 0)
+			data.push_back(0);
+	}
+
+	std::vector<uint32> codesMSB;
+	std::vector<uint32> codesLSB;
+	std::vector<uint8>  lengths;
+	std::vector<uint32> symbols;
+};
+
+static void createIndices(std::vector<size_t> &indices, size_t codeCount) {
+	uint32 random = 0x12345678;
+
+	for (size_t i = 0; i < 10000; i++) {
+		random = random * 1664525 + 1013904223;
+
+		indices.push_back((random >> 8) % codeCount);
+	}
+}
+
+GTEST_TEST(Huffman, longCodesMSB) {
+	const LongCodes codes;
+
+	std::vector<size_t> indices;
+	createIndices(indices, codes.codesMSB.size());
+
+	std::vector<byte> data;
+	codes.encode(indices, data, true);
+
+	Common::MemoryReadStream byteStream(&data[0], data.size());
+	Common::BitStream8MSB    bitStream (byteStream);
+
+	Common::Huffman huffman(0, codes.codesMSB.size(), &codes.codesMSB[0], &codes.lengths[0], &codes.symbols[0]);
+
+	for (size_t i = 0; i < indices.size(); i++)
+		ASSERT_EQ(huffman.getSymbol(bitStream), codes.symbols[indices[i]]) << "At index " << i;
+}
+
+GTEST_TEST(Huffman, longCodesLSB) {
+	const LongCodes codes;
+
+	std::vector<size_t> indices;
+	createIndices(indices, codes.codesLSB.size());
+
+	std::vector<byte> data;
+	codes.encode(indices, data, false);
+
+	Common::MemoryReadStream byteStream(&data[0], data.size());
+	Common::BitStream32LELSB bitStream (byteStream);
+
+	Common::Huffman huffman(0, codes.codesLSB.size(), &codes.codesLSB[0], &codes.lengths[0], 0);
+
+	for (size_t i = 0; i < indices.size(); i++)
+		ASSERT_EQ(huffman.getSymbol(bitStream), indices[i]) << "At index " << i;
+}
+
+/** The original Huffman decoder, reading a code bit by bit and comparing it against all codes of that length. */
+class ReferenceHuffman {
+public:
+	ReferenceHuffman(size_t codeCount, const uint32 *codes, const uint8 *lengths, const uint32 *symbols) {
+		uint8 maxLength = 0;
+		for (size_t i = 0; i < codeCount; i++)
+			maxLength = MAX(maxLength, lengths[i]);
+
+		_codes.resize(maxLength);
+		for (size_t i = 0; i < codeCount; i++)
+			_codes[lengths[i] - 1].push_back(Symbol(codes[i], symbols ? symbols[i] : i));
+	}
+
+	uint32 getSymbol(Common::BitStream &bits) const {
+		uint32 code = 0;
+
+		for (size_t i = 0; i < _codes.size(); i++) {
+			bits.addBit(code, i);
+
+			for (CodeList::const_iterator c = _codes[i].begin(); c != _codes[i].end(); ++c)
+				if (code == c->code)
+					return c->symbol;
+		}
+
+		throw Common::Exception("Unknown Huffman code");
+	}
+
+private:
+	struct Symbol {
+		uint32 code;
+		uint32 symbol;
+
+		Symbol(uint32 c, uint32 s) : code(c), symbol(s) {
+		}
+	};
+
+	typedef std::vector<Symbol> CodeList;
+
+	std::vector<CodeList> _codes;
+};
+
+/** Decode random data with both the table decoder and the reference decoder, and compare the results.
+ *
+ *  Both decoders have to return the same symbols and consume the same number of bits. For
+ *  incomplete codes, both have to fail on the same invalid code, after which decoding stops.
+ */
+template<class BitStreamType, class MemoryBitStreamType>
+static void compareReference(size_t codeCount, const uint32 *codes, const uint8 *lengths, const uint32 *symbols) {
+	std::vector<byte> data(16384);
+
+	uint32 random = codeCount;
+	for (size_t i = 0; i < data.size(); i++) {
+		random = random * 1664525 + 1013904223;
+
+		data[i] = random >> 24;
+	}
+
+	const ReferenceHuffman reference(codeCount, codes, lengths, symbols);
+	const Common::Huffman  huffman  (0, codeCount, codes, lengths, symbols);
+
+	uint8 maxLength = 0;
+	for (size_t i = 0; i < codeCount; i++)
+		maxLength = MAX(maxLength, lengths[i]);
+
+	Common::MemoryReadStream referenceStream(&data[0], data.size()), tableStream(&data[0], data.size());
+	BitStreamType referenceBits(referenceStream), tableBits(tableStream);
+
+	MemoryBitStreamType memoryBits(&data[0], data.size());
+
+	for (size_t i = 0; (referenceBits.size() - referenceBits.pos()) >= maxLength; i++) {
+		uint32 symbol = 0;
+		try {
+			symbol = reference.getSymbol(referenceBits);
+		} catch (...) {
+			EXPECT_THROW(huffman.getSymbol(tableBits) , Common::Exception) << "At index " << i;
+			EXPECT_THROW(huffman.getSymbol(memoryBits), Common::Exception) << "At index " << i;
+			return;
+		}
+
+		ASSERT_EQ(huffman.getSymbol(tableBits) , symbol) << "At index " << i;
+		ASSERT_EQ(huffman.getSymbol(memoryBits), symbol) << "At index " << i;
+
+		ASSERT_EQ(tableBits.pos() , referenceBits.pos()) << "At index " << i;
+		ASSERT_EQ(memoryBits.pos(), referenceBits.pos()) << "At index " << i;
+	}
+}
+
+GTEST_TEST(Huffman, referenceLongCodes) {
+	const LongCodes codes;
+
+	compareReference<Common::BitStream8MSB, Common::MemoryBitStream8MSB>(codes.codesMSB.size(),
+			&codes.codesMSB[0], &codes.lengths[0], &codes.symbols[0]);
+	compareReference<Common::BitStream32LELSB, Common::MemoryBitStream32LELSB>(codes.codesLSB.size(),
+			&codes.codesLSB[0], &codes.lengths[0], 0);
+}
+
+GTEST_TEST(Huffman, referenceWMA) {
+	for (size_t i = 0; i < ARRAYSIZE(Sound::coefHuffmanParam); i++) {
+		const Sound::WMACoefHuffmanParam &param = Sound::coefHuffmanParam[i];
+
+		SCOPED_TRACE(i);
+		compareReference<Common::BitStream8MSB, Common::MemoryBitStream8MSB>(param.n, param.huffCodes, param.huffBits, 0);
+	}
+
+	compareReference<Common::BitStream8MSB, Common::MemoryBitStream8MSB>(ARRAYSIZE(Sound::scaleHuffCodes),
+			Sound::scaleHuffCodes, Sound::scaleHuffBits, 0);
+	compareReference<Common::BitStream8MSB, Common::MemoryBitStream8MSB>(ARRAYSIZE(Sound::hgainHuffCodes),
+			Sound::hgainHuffCodes, Sound::hgainHuffBits, 0);
+}
+
+GTEST_TEST(Huffman, referenceBink) {
+	for (size_t i = 0; i < ARRAYSIZE(binkHuffmanCodes); i++) {
+		SCOPED_TRACE(i);
+		compareReference<Common::BitStream32LELSB, Common::MemoryBitStream32LELSB>(ARRAYSIZE(binkHuffmanCodes[i]),
+				binkHuffmanCodes[i], binkHuffmanLengths[i], 0);
+	}
+}
@@ -0,0 +1,257 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our memory bit stream.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/memreadstream.h"
+#include "src/common/bitstream.h"
+#include "src/common/membitstream.h"
+#include "src/common/huffman.h"
+
+static void createData(std::vector<byte> &data, size_t size) {
+	uint32 random = 0x12345678;
+
+	data.resize(size);
+	for (std::vector<byte>::iterator d = data.begin(); d != data.end(); ++d) {
+		random = random * 1664525 + 1013904223;
+
+		*d = random >> 24;
+	}
+}
+
+/** Read the same data with a BitStreamImpl and a MemoryBitStreamImpl, and compare. */
+template<int valueBits, bool isLE, bool isMSB2LSB>
+static void compareBitStreams() {
+	typedef Common::BitStreamImpl      <valueBits, isLE, isMSB2LSB> BitStreamType;
+	typedef Common::MemoryBitStreamImpl<valueBits, isLE, isMSB2LSB> MemoryBitStreamType;
+
+	// Not a multiple of the value size, to check that the tail is ignored
+	std::vector<byte> data;
+	createData(data, 1027);
+
+	Common::MemoryReadStream stream(&data[0], data.size());
+
+	BitStreamType       bitStream1(stream);
+	MemoryBitStreamType bitStream2(&data[0], data.size());
+
+	ASSERT_EQ(bitStream2.size(), bitStream1.size());
+	ASSERT_EQ(bitStream2.isMSBFirst(), bitStream1.isMSBFirst());
+
+	uint32 random = 0xABCDEF01;
+
+	for (size_t i = 0; ; i++) {
+		random = random * 1664525 + 1013904223;
+
+		const size_t n = (random >> 8) % 33;
+		if ((bitStream1.pos() + 3 * n) > bitStream1.size())
+			break;
+
+		ASSERT_EQ(bitStream2.peekBits(n), bitStream1.peekBits(n)) << "At index " << i;
+
+		switch ((random >> 4) % 4) {
+			case 0:
+				ASSERT_EQ(bitStream2.getBits(n), bitStream1.getBits(n)) << "At index " << i;
+				break;
+
+			case 1:
+				bitStream1.skip(n * 3);
+				bitStream2.skip(n * 3);
+				break;
+
+			case 2:
+				ASSERT_EQ(bitStream2.getBit(), bitStream1.getBit()) << "At index " << i;
+				break;
+
+			default:
+				{
+					uint32 x1 = 1, x2 = 1;
+					bitStream1.addBit(x1, 1);
+					bitStream2.addBit(x2, 1);
+
+					ASSERT_EQ(x2, x1) << "At index " << i;
+				}
+				break;
+		}
+
+		ASSERT_EQ(bitStream2.pos(), bitStream1.pos()) << "At index " << i;
+	}
+
+	// Read the remaining bits
+	while (bitStream1.pos() < bitStream1.size()) {
+		const size_t n = MIN<size_t>(bitStream1.size() - bitStream1.pos(), 32);
+
+		ASSERT_EQ(bitStream2.peekBits(32), bitStream1.peekBits(32));
+		ASSERT_EQ(bitStream2.getBits(n), bitStream1.getBits(n));
+	}
+
+	EXPECT_TRUE(bitStream2.eos());
+	EXPECT_EQ(bitStream2.peekBits(8), 0);
+	EXPECT_THROW(bitStream2.getBit(), Common::Exception);
+
+	bitStream1.rewind();
+	bitStream2.rewind();
+
+	EXPECT_EQ(bitStream2.pos(), 0);
+	EXPECT_EQ(bitStream2.getBits(32), bitStream1.getBits(32));
+}
+
+GTEST_TEST(MemoryBitStream, compare8MSB) {
+	compareBitStreams<8, false, true>();
+}
+
+GTEST_TEST(MemoryBitStream, compare8LSB) {
+	compareBitStreams<8, false, false>();
+}
+
+GTEST_TEST(MemoryBitStream, compare16LEMSB) {
+	compareBitStreams<16, true, true>();
+}
+
+GTEST_TEST(MemoryBitStream, compare16LELSB) {
+	compareBitStreams<16, true, false>();
+}
+
+GTEST_TEST(MemoryBitStream, compare16BEMSB) {
+	compareBitStreams<16, false, true>();
+}
+
+GTEST_TEST(MemoryBitStream, compare16BELSB) {
+	compareBitStreams<16, false, false>();
+}
+
+GTEST_TEST(MemoryBitStream, compare32LEMSB) {
+	compareBitStreams<32, true, true>();
+}
+
+GTEST_TEST(MemoryBitStream, compare32LELSB) {
+	compareBitStreams<32, true, false>();
+}
+
+GTEST_TEST(MemoryBitStream, compare32BEMSB) {
+	compareBitStreams<32, false, true>();
+}
+
+GTEST_TEST(MemoryBitStream, compare32BELSB) {
+	compareBitStreams<32, false, false>();
+}
+
+GTEST_TEST(MemoryBitStream, compare64LEMSB) {
+	compareBitStreams<64, true, true>();
+}
+
+GTEST_TEST(MemoryBitStream, compare64LELSB) {
+	compareBitStreams<64, true, false>();
+}
+
+GTEST_TEST(MemoryBitStream, compare64BEMSB) {
+	compareBitStreams<64, false, true>();
+}
+
+GTEST_TEST(MemoryBitStream, compare64BELSB) {
+	compareBitStreams<64, false, false>();
+}
+
+GTEST_TEST(MemoryBitStream, skipPastEnd) {
+	static const byte data[4] = { 0 };
+	Common::MemoryBitStream8MSB bitStream(data, sizeof(data));
+
+	bitStream.skip(20);
+	EXPECT_EQ(bitStream.pos(), 20);
+
+	EXPECT_THROW(bitStream.skip(20), Common::Exception);
+}
+
+GTEST_TEST(MemoryBitStream, huffman) {
+	static const uint32 kCodes  [] = {  0,   4,   5,   6,   7  };
+	static const uint8  kLengths[] = {  1,   3,   3,   3,   3  };
+	static const uint32 kSymbols[] = { 'A', 'B', 'C', 'D', 'E' };
+
+	static const byte   kHuffmanData[] = { 0x45, 0x67 };
+
+	static const uint32 kDeHuffmanDataSymbols[] = { 'A', 'B', 'A', 'C', 'A', 'D', 'A', 'E' };
+
+	Common::MemoryBitStream8MSB bitStream(kHuffmanData, sizeof(kHuffmanData));
+
+	Common::Huffman huffman(0, ARRAYSIZE(kCodes), kCodes, kLengths, kSymbols);
+
+	for (size_t i = 0; i < ARRAYSIZE(kDeHuffmanDataSymbols); i++)
+		EXPECT_EQ(huffman.getSymbol(bitStream), kDeHuffmanDataSymbols[i]) << "At index " << i;
+
+	EXPECT_THROW(huffman.getSymbol(bitStream), Common::Exception);
+}
+
+/** Read all the data in chunks of varying sizes, returning a checksum. */
+template<class BitStreamType>
+static uint32 readAllBits(BitStreamType &bitStream) {
+	static const size_t kCounts[] = { 1, 3, 7, 4, 12, 5, 2, 9, 16, 6, 1, 11 };
+
+	const size_t size = bitStream.size() - 32;
+
+	uint32 sum = 0;
+	for (size_t i = 0; bitStream.pos() < size; i = (i + 1) % ARRAYSIZE(kCounts))
+		sum += bitStream.getBits(kCounts[i]);
+
+	return sum;
+}
+
+/** Read the same data with both bit stream implementations with this layout, and compare. */
+template<int valueBits, bool isLE, bool isMSB2LSB>
+static void compareImplementations(const char *name, const std::vector<byte> &data) {
+	typedef Common::BitStreamImpl      <valueBits, isLE, isMSB2LSB> BitStreamType;
+	typedef Common::MemoryBitStreamImpl<valueBits, isLE, isMSB2LSB> MemoryBitStreamType;
+
+	Common::MemoryReadStream stream(&data[0], data.size());
+
+	BitStreamType       bitStream1(stream);
+	MemoryBitStreamType bitStream2(&data[0], data.size());
+
+	const uint32 sum1 = readAllBits(static_cast<Common::BitStream &>(bitStream1));
+	const uint32 sum2 = readAllBits(bitStream2);
+
+	EXPECT_EQ(sum2, sum1) << name;
+}
+
+GTEST_TEST(MemoryBitStream, compareBitStream) {
+	std::vector<byte> data;
+	createData(data, 64 * 1024);
+
+	compareImplementations< 8, false, true >("8MSB"   , data);
+	compareImplementations< 8, false, false>("8LSB"   , data);
+	compareImplementations<16, true , true >("16LEMSB", data);
+	compareImplementations<16, true , false>("16LELSB", data);
+	compareImplementations<16, false, true >("16BEMSB", data);
+	compareImplementations<16, false, false>("16BELSB", data);
+	compareImplementations<32, true , true >("32LEMSB", data);
+	compareImplementations<32, true , false>("32LELSB", data);
+	compareImplementations<32, false, true >("32BEMSB", data);
+	compareImplementations<32, false, false>("32BELSB", data);
+	compareImplementations<64, true , true >("64LEMSB", data);
+	compareImplementations<64, true , false>("64LELSB", data);
+	compareImplementations<64, false, true >("64BEMSB", data);
+	compareImplementations<64, false, false>("64BELSB", data);
+}
@@ -100,6 +100,11 @@ tests_common_test_bitstream_SOURCES  = tests/common/bitstream.cpp
 tests_common_test_bitstream_LDADD    = $(common_LIBS)
 tests_common_test_bitstream_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                         += tests/common/test_membitstream
+tests_common_test_membitstream_SOURCES  = tests/common/membitstream.cpp
+tests_common_test_membitstream_LDADD    = $(common_LIBS)
+tests_common_test_membitstream_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                            += tests/common/test_bitstreamwriter
 tests_common_test_bitstreamwriter_SOURCES  = tests/common/bitstreamwriter.cpp
 tests_common_test_bitstreamwriter_LDADD    = $(common_LIBS)
@@ -260,3 +265,18 @@ check_PROGRAMS                     += tests/common/test_aabbnode
 tests_common_test_aabbnode_SOURCES  = tests/common/aabbnode.cpp
 tests_common_test_aabbnode_LDADD    = $(common_LIBS)
 tests_common_test_aabbnode_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                += tests/common/test_fft
+tests_common_test_fft_SOURCES  = tests/common/fft.cpp
+tests_common_test_fft_LDADD    = $(common_LIBS)
+tests_common_test_fft_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                    += tests/common/test_threads
+tests_common_test_threads_SOURCES  = tests/common/threads.cpp
+tests_common_test_threads_LDADD    = $(common_LIBS)
+tests_common_test_threads_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                        += tests/common/test_stringarena
+tests_common_test_stringarena_SOURCES  = tests/common/stringarena.cpp
+tests_common_test_stringarena_LDADD    = $(common_LIBS)
+tests_common_test_stringarena_CXXFLAGS = $(test_CXXFLAGS)
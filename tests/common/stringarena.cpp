@@ -0,0 +1,113 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our string arena.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/threads.h"
+#include "src/common/stringarena.h"
+
+GTEST_TEST(StringArena, add) {
+	Common::StringArena arena(64);
+
+	const Common::StringView foo = arena.add("foo", 3);
+	const Common::StringView bar = arena.add(Common::UString("barbaz"));
+
+	EXPECT_STREQ(foo.data, "foo");
+	EXPECT_EQ(foo.size, 3U);
+
+	EXPECT_STREQ(bar.data, "barbaz");
+	EXPECT_EQ(bar.size, 6U);
+
+	EXPECT_EQ(arena.getStringCount(), 2U);
+	EXPECT_EQ(arena.getSize(), 11U);
+
+	EXPECT_STREQ(foo.toString().c_str(), "foo");
+}
+
+GTEST_TEST(StringArena, addPartial) {
+	Common::StringArena arena;
+
+	// Only the given bytes are copied, and the copy is terminated
+	const Common::StringView view = arena.add("foobar", 3);
+
+	EXPECT_STREQ(view.data, "foo");
+	EXPECT_EQ(view.size, 3U);
+}
+
+GTEST_TEST(StringArena, addEmpty) {
+	Common::StringArena arena;
+
+	const Common::StringView view = arena.add("", 0);
+
+	EXPECT_TRUE(view.empty());
+	EXPECT_STREQ(view.data, "");
+}
+
+GTEST_TEST(StringArena, intern) {
+	Common::StringArena arena(64);
+
+	const Common::StringView foo1 = arena.add("foo", 3);
+	const Common::StringView bar  = arena.add("bar", 3);
+	const Common::StringView foo2 = arena.add(Common::UString("foo"));
+
+	EXPECT_EQ(foo1.data, foo2.data);
+	EXPECT_NE(foo1.data, bar.data);
+
+	EXPECT_EQ(arena.getStringCount(), 2U);
+	EXPECT_EQ(arena.getSize(), 8U);
+}
+
+GTEST_TEST(StringArena, stable) {
+	Common::StringArena arena(64);
+
+	// Lots of strings over lots of blocks, some of them too big for a block
+	std::vector<Common::StringView> views;
+	for (size_t i = 0; i < 1000; i++)
+		views.push_back(arena.add(Common::UString::format("%u%s", (uint) i, Common::UString('x', i % 40).c_str())));
+
+	for (size_t i = 0; i < views.size(); i++)
+		EXPECT_STREQ(views[i].data, Common::UString::format("%u%s", (uint) i, Common::UString('x', i % 40).c_str()).c_str());
+
+	EXPECT_EQ(arena.getStringCount(), 1000U);
+}
+
+GTEST_TEST(StringArena, threads) {
+	Common::StringArena arena;
+
+	std::vector<Common::StringView> views(1000);
+
+	Common::runParallel(views.size(), [&arena, &views](size_t i) {
+		views[i] = arena.add(Common::UString::format("%u", (uint) (i % 100)));
+	});
+
+	for (size_t i = 0; i < views.size(); i++) {
+		EXPECT_STREQ(views[i].data, Common::UString::format("%u", (uint) (i % 100)).c_str());
+		EXPECT_EQ(views[i].data, views[i % 100].data);
+	}
+
+	EXPECT_EQ(arena.getStringCount(), 100U);
+}
@@ -0,0 +1,132 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our threading system helpers.
+ */
+
+#include <vector>
+#include <atomic>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/threads.h"
+
+GTEST_TEST(Threads, runParallel) {
+	static const size_t kCount = 1000;
+
+	std::vector<std::atomic<int> > calls(kCount);
+	for (size_t i = 0; i < kCount; i++)
+		calls[i] = 0;
+
+	Common::runParallel(kCount, [&](size_t i) {
+		calls[i]++;
+	});
+
+	for (size_t i = 0; i < kCount; i++)
+		EXPECT_EQ(calls[i], 1) << "At index " << i;
+}
+
+GTEST_TEST(Threads, runParallelEmpty) {
+	bool called = false;
+
+	Common::runParallel(0, [&](size_t UNUSED(i)) {
+		called = true;
+	});
+
+	EXPECT_FALSE(called);
+}
+
+GTEST_TEST(Threads, runParallelException) {
+	std::atomic<size_t> calls(0);
+
+	try {
+		Common::runParallel(100, [&](size_t i) {
+			calls++;
+
+			if ((i % 10) == 5)
+				throw Common::Exception("%u", (uint) i);
+		});
+
+		ADD_FAILURE() << "No exception thrown";
+
+	} catch (Common::Exception &e) {
+		// The exception of the lowest index is rethrown
+		EXPECT_STREQ(e.what(), "5");
+	}
+
+	// All calls still happened
+	EXPECT_EQ(calls, 100);
+}
+
+GTEST_TEST(Threads, runParallelNested) {
+	static const size_t kCount = 16;
+
+	std::atomic<size_t> calls(0);
+
+	Common::runParallel(kCount, [&](size_t UNUSED(i)) {
+		Common::runParallel(kCount, [&](size_t UNUSED(j)) {
+			calls++;
+		});
+	});
+
+	EXPECT_EQ(calls, kCount * kCount);
+}
+
+GTEST_TEST(Threads, runParallelRepeated) {
+	// The worker threads stay around between calls
+	for (size_t n = 0; n < 1000; n++) {
+		std::atomic<size_t> calls(0);
+
+		Common::runParallel(4, [&](size_t UNUSED(i)) {
+			calls++;
+		});
+
+		ASSERT_EQ(calls, 4U) << "In run " << n;
+	}
+}
+
+GTEST_TEST(Threads, runInBackground) {
+	std::atomic<bool> called(false);
+
+	std::future<void> result = Common::runInBackground([&]() {
+		called = true;
+	});
+
+	result.get();
+	EXPECT_TRUE(called);
+}
+
+GTEST_TEST(Threads, runInBackgroundException) {
+	std::future<void> result = Common::runInBackground([]() {
+		throw Common::Exception("Background");
+	});
+
+	try {
+		result.get();
+
+		ADD_FAILURE() << "No exception thrown";
+
+	} catch (Common::Exception &e) {
+		EXPECT_STREQ(e.what(), "Background");
+	}
+}
@@ -562,3 +562,81 @@ GTEST_TEST(UString, append) {
 
 	EXPECT_STREQ(str.c_str(), "Foobar Barfoo Quux");
 }
+
+GTEST_TEST(UString, isASCII) {
+	Common::UString str(kTestString1);
+	EXPECT_TRUE(str.isASCII());
+
+	str += 0xF6;
+	EXPECT_FALSE(str.isASCII());
+
+	str.truncate(str.size() - 1);
+	EXPECT_TRUE(str.isASCII());
+
+	str = reinterpret_cast<const char *>(kTestStringUTF8);
+	EXPECT_FALSE(str.isASCII());
+
+	str.replaceAll(0xF6, 'o');
+	str.replaceAll(0xE4, 'a');
+	EXPECT_TRUE(str.isASCII());
+	EXPECT_STREQ(str.c_str(), "Foobar");
+
+	str.clear();
+	EXPECT_TRUE(str.isASCII());
+}
+
+GTEST_TEST(UString, compareUTF8) {
+	const Common::UString strUTF8(reinterpret_cast<const char *>(kTestStringUTF8));
+
+	// Comparing the bytes has to order the same as comparing the characters
+	EXPECT_LT(Common::UString("Fz").strcmp(strUTF8), 0);
+	EXPECT_GT(strUTF8.strcmp("Fz"), 0);
+	EXPECT_EQ(strUTF8.strcmp(strUTF8), 0);
+	EXPECT_LT(Common::UString("F").strcmp(strUTF8), 0);
+
+	EXPECT_LT(Common::UString("fZ").stricmp(strUTF8), 0);
+	EXPECT_GT(strUTF8.stricmp("fZ"), 0);
+	EXPECT_EQ(strUTF8.stricmp(strUTF8.toUpper()), 0);
+	EXPECT_LT(Common::UString("f").stricmp(strUTF8), 0);
+
+	// 0x100 encodes to a lead byte higher than the one for 0xFF
+	const Common::UString str1(0xFF), str2(0x100);
+	EXPECT_LT(str1.strcmp(str2), 0);
+	EXPECT_LT(str1.stricmp(str2), 0);
+}
+
+GTEST_TEST(UString, caseFoldUTF8) {
+	const Common::UString str(reinterpret_cast<const char *>(kTestStringUTF8));
+
+	// Only the ASCII characters change
+	static const byte kUpper[10] = { 'F', 0xC3, 0xB6, 0xC3, 0xB6, 'B', 0xC3, 0xA4, 'R', 0 };
+
+	EXPECT_STREQ(str.toUpper().c_str(), reinterpret_cast<const char *>(kUpper));
+	EXPECT_EQ(str.toUpper().size(), str.size());
+	EXPECT_FALSE(str.toUpper().isASCII());
+}
+
+static size_t hashCharacters(const Common::UString &str, bool lower) {
+	size_t seed = 0;
+
+	for (Common::UString::iterator it = str.begin(); it != str.end(); ++it)
+		boost::hash_combine<uint32>(seed, lower ? Common::UString::toLower(*it) : *it);
+
+	return seed;
+}
+
+GTEST_TEST(UString, hash) {
+	const Common::UString strASCII(kTestString1);
+	const Common::UString strUTF8(reinterpret_cast<const char *>(kTestStringUTF8));
+
+	Common::hashUStringCaseSensitive   hashSensitive;
+	Common::hashUStringCaseInsensitive hashInsensitive;
+
+	EXPECT_EQ(hashSensitive(strASCII), hashCharacters(strASCII, false));
+	EXPECT_EQ(hashSensitive(strUTF8) , hashCharacters(strUTF8 , false));
+
+	EXPECT_EQ(hashInsensitive(strASCII), hashCharacters(strASCII, true));
+	EXPECT_EQ(hashInsensitive(strUTF8) , hashCharacters(strUTF8 , true));
+
+	EXPECT_EQ(hashInsensitive(strASCII), hashInsensitive(strASCII.toUpper()));
+}
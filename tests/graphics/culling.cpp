@@ -0,0 +1,361 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for culling world objects against the view frustum, and picking them.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "external/glm/gtc/matrix_transform.hpp"
+
+#include "src/common/boundingbox.h"
+
+#include "src/graphics/frustum.h"
+#include "src/graphics/bvh.h"
+
+/** A small, deterministic random number generator. */
+class SceneRandom {
+public:
+	SceneRandom(uint32 seed) : _state(seed) {
+	}
+
+	float get(float min, float max) {
+		_state = _state * 1664525 + 1013904223;
+
+		return min + (max - min) * ((_state >> 8) / 16777216.0f);
+	}
+
+private:
+	uint32 _state;
+};
+
+struct SceneBox {
+	glm::vec3 min;
+	glm::vec3 max;
+
+	int proxy;
+};
+
+static SceneBox createBox(SceneRandom &random) {
+	SceneBox box;
+
+	box.min = glm::vec3(random.get(-500.0f, 500.0f), random.get(-500.0f, 500.0f), random.get(-20.0f, 20.0f));
+	box.max = box.min + glm::vec3(random.get(0.1f, 10.0f), random.get(0.1f, 10.0f), random.get(0.1f, 10.0f));
+
+	box.proxy = Graphics::BVH::kInvalidProxy;
+
+	return box;
+}
+
+/** A camera at this position, looking at this point. */
+static glm::mat4 createCamera(const glm::vec3 &eye, const glm::vec3 &center) {
+	const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 4.0f / 3.0f, 1.0f, 300.0f);
+	const glm::mat4 view       = glm::lookAt(eye, center, glm::vec3(0.0f, 0.0f, 1.0f));
+
+	return projection * view;
+}
+
+/** Cull the scene by testing every single box. */
+static std::vector<SceneBox *> cullBruteForce(const Graphics::Frustum &frustum, std::vector<SceneBox> &scene) {
+	std::vector<SceneBox *> visible;
+
+	for (std::vector<SceneBox>::iterator b = scene.begin(); b != scene.end(); ++b)
+		if ((b->proxy != Graphics::BVH::kInvalidProxy) && frustum.isBoxIn(b->min, b->max))
+			visible.push_back(&*b);
+
+	std::sort(visible.begin(), visible.end());
+	return visible;
+}
+
+static std::vector<SceneBox *> cullBVH(const Graphics::Frustum &frustum, const Graphics::BVH &bvh) {
+	std::vector<void *> data;
+	bvh.cull(frustum, data);
+
+	std::vector<SceneBox *> visible;
+	for (std::vector<void *>::const_iterator d = data.begin(); d != data.end(); ++d)
+		visible.push_back(static_cast<SceneBox *>(*d));
+
+	std::sort(visible.begin(), visible.end());
+	return visible;
+}
+
+GTEST_TEST(Frustum, planes) {
+	const Graphics::Frustum frustum(createCamera(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+	// Looking along the y axis, from 1 to 300 units in front of the camera
+	EXPECT_TRUE(frustum.isIn(glm::vec3(0.0f,    2.0f, 0.0f)));
+	EXPECT_TRUE(frustum.isIn(glm::vec3(0.0f,  299.0f, 0.0f)));
+	EXPECT_TRUE(frustum.isIn(glm::vec3(10.0f,  50.0f, 5.0f)));
+
+	EXPECT_FALSE(frustum.isIn(glm::vec3(0.0f,   0.5f, 0.0f)));
+	EXPECT_FALSE(frustum.isIn(glm::vec3(0.0f, 301.0f, 0.0f)));
+	EXPECT_FALSE(frustum.isIn(glm::vec3(0.0f, -10.0f, 0.0f)));
+	EXPECT_FALSE(frustum.isIn(glm::vec3(100.0f, 10.0f, 0.0f)));
+	EXPECT_FALSE(frustum.isIn(glm::vec3(0.0f,  10.0f, 100.0f)));
+
+	// The planes are normalized
+	for (size_t i = 0; i < 6; i++)
+		EXPECT_NEAR(glm::length(glm::vec3(frustum.getPlane(i))), 1.0f, 1e-5f);
+}
+
+GTEST_TEST(Frustum, boxes) {
+	const Graphics::Frustum frustum(createCamera(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+	EXPECT_EQ(frustum.classifyBox(glm::vec3(-1.0f, 10.0f, -1.0f), glm::vec3(1.0f, 12.0f, 1.0f)),
+	          Graphics::Frustum::kIntersectionInside);
+	EXPECT_EQ(frustum.classifyBox(glm::vec3(-1.0f, -5.0f, -1.0f), glm::vec3(1.0f, 12.0f, 1.0f)),
+	          Graphics::Frustum::kIntersectionPartial);
+	EXPECT_EQ(frustum.classifyBox(glm::vec3(-1.0f, -12.0f, -1.0f), glm::vec3(1.0f, -10.0f, 1.0f)),
+	          Graphics::Frustum::kIntersectionOutside);
+	EXPECT_EQ(frustum.classifyBox(glm::vec3(-1.0f, 290.0f, -1.0f), glm::vec3(1.0f, 310.0f, 1.0f)),
+	          Graphics::Frustum::kIntersectionPartial);
+
+	// A box enclosing the camera is always visible
+	EXPECT_TRUE(frustum.isBoxIn(glm::vec3(-1000.0f), glm::vec3(1000.0f)));
+
+	// The default frustum contains everything
+	const Graphics::Frustum everything;
+	EXPECT_EQ(everything.classifyBox(glm::vec3(-1e6f), glm::vec3(1e6f)), Graphics::Frustum::kIntersectionInside);
+}
+
+GTEST_TEST(BVH, insertRemove) {
+	Graphics::BVH bvh;
+
+	EXPECT_EQ(bvh.size(), 0U);
+	EXPECT_EQ(bvh.getHeight(), 0);
+	EXPECT_TRUE(bvh.validate());
+
+	SceneRandom random(1);
+
+	std::vector<SceneBox> scene;
+	for (size_t i = 0; i < 1000; i++)
+		scene.push_back(createBox(random));
+
+	for (std::vector<SceneBox>::iterator b = scene.begin(); b != scene.end(); ++b)
+		b->proxy = bvh.insert(b->min, b->max, &*b);
+
+	EXPECT_EQ(bvh.size(), 1000U);
+	EXPECT_TRUE(bvh.validate());
+
+	// A reasonably balanced tree: log2(1000) is about 10
+	EXPECT_LE(bvh.getHeight(), 25);
+
+	for (std::vector<SceneBox>::iterator b = scene.begin(); b != scene.end(); ++b) {
+		EXPECT_EQ(bvh.getData(b->proxy), &*b);
+
+		glm::vec3 min, max;
+		bvh.getBox(b->proxy, min, max);
+		EXPECT_EQ(min, b->min);
+		EXPECT_EQ(max, b->max);
+	}
+
+	std::vector<void *> all;
+	bvh.getAll(all);
+	EXPECT_EQ(all.size(), 1000U);
+
+	for (size_t i = 0; i < scene.size(); i += 2) {
+		bvh.remove(scene[i].proxy);
+		scene[i].proxy = Graphics::BVH::kInvalidProxy;
+	}
+
+	EXPECT_EQ(bvh.size(), 500U);
+	EXPECT_TRUE(bvh.validate());
+
+	bvh.clear();
+
+	EXPECT_EQ(bvh.size(), 0U);
+	EXPECT_TRUE(bvh.validate());
+}
+
+GTEST_TEST(BVH, move) {
+	Graphics::BVH bvh;
+
+	glm::vec3 min(0.0f), max(1.0f);
+	const int proxy = bvh.insert(min, max, 0);
+
+	// Small moves stay within the enlarged box
+	EXPECT_FALSE(bvh.move(proxy, min + glm::vec3(0.05f), max + glm::vec3(0.05f)));
+
+	glm::vec3 boxMin, boxMax;
+	bvh.getBox(proxy, boxMin, boxMax);
+	EXPECT_EQ(boxMin, min + glm::vec3(0.05f));
+
+	// Large ones don't
+	EXPECT_TRUE(bvh.move(proxy, min + glm::vec3(10.0f), max + glm::vec3(10.0f)));
+
+	EXPECT_TRUE(bvh.validate());
+}
+
+GTEST_TEST(BVH, cull) {
+	SceneRandom random(42);
+
+	Graphics::BVH bvh;
+
+	std::vector<SceneBox> scene;
+	for (size_t i = 0; i < 5000; i++)
+		scene.push_back(createBox(random));
+
+	for (std::vector<SceneBox>::iterator b = scene.begin(); b != scene.end(); ++b)
+		b->proxy = bvh.insert(b->min, b->max, &*b);
+
+	for (size_t frame = 0; frame < 50; frame++) {
+		// Move the camera around the scene
+		const glm::vec3 eye(random.get(-400.0f, 400.0f), random.get(-400.0f, 400.0f), random.get(-10.0f, 50.0f));
+		const glm::vec3 center = eye + glm::vec3(random.get(-1.0f, 1.0f), random.get(-1.0f, 1.0f), random.get(-0.5f, 0.5f));
+
+		const Graphics::Frustum frustum(createCamera(eye, center));
+
+		// Move, remove and readd objects in between frames
+		for (size_t i = 0; i < 200; i++) {
+			SceneBox &box = scene[(size_t) random.get(0.0f, scene.size() - 1.0f)];
+
+			if (box.proxy == Graphics::BVH::kInvalidProxy) {
+				box.proxy = bvh.insert(box.min, box.max, &box);
+				continue;
+			}
+
+			if ((i % 10) == 0) {
+				bvh.remove(box.proxy);
+				box.proxy = Graphics::BVH::kInvalidProxy;
+				continue;
+			}
+
+			const float scale = (i % 3) ? 0.5f : 50.0f;
+			const glm::vec3 offset(random.get(-scale, scale), random.get(-scale, scale), random.get(-scale, scale));
+
+			box.min += offset;
+			box.max += offset;
+
+			bvh.move(box.proxy, box.min, box.max);
+		}
+
+		ASSERT_TRUE(bvh.validate()) << "In frame " << frame;
+
+		const std::vector<SceneBox *> expected = cullBruteForce(frustum, scene);
+		const std::vector<SceneBox *> culled   = cullBVH(frustum, bvh);
+
+		ASSERT_EQ(culled, expected) << "In frame " << frame;
+
+		// Looking at a 1000x1000 scene from the inside, a lot should be culled away
+		EXPECT_LT(culled.size(), bvh.size() / 2) << "In frame " << frame;
+	}
+}
+
+GTEST_TEST(BVH, raycastSimple) {
+	Graphics::BVH bvh;
+
+	int a = 1, b = 2, c = 3;
+	bvh.insert(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f), &a);
+	bvh.insert(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(1.0f, 1.0f, 6.0f), &b);
+	bvh.insert(glm::vec3(5.0f, 5.0f, 0.0f), glm::vec3(6.0f, 6.0f, 1.0f), &c);
+
+	// Straight down through the first two boxes, nearest first
+	std::vector<Graphics::BVH::RayHit> hits;
+	bvh.raycast(glm::vec3(0.5f, 0.5f, 10.0f), glm::vec3(0.5f, 0.5f, -10.0f), hits);
+
+	ASSERT_EQ(hits.size(), 2U);
+	EXPECT_EQ(hits[0].data, &b);
+	EXPECT_EQ(hits[1].data, &a);
+	EXPECT_FLOAT_EQ(hits[0].distance, 0.2f);
+	EXPECT_FLOAT_EQ(hits[1].distance, 0.45f);
+
+	// Stopping short of the lower box
+	hits.clear();
+	bvh.raycast(glm::vec3(0.5f, 0.5f, 10.0f), glm::vec3(0.5f, 0.5f, 3.0f), hits);
+
+	ASSERT_EQ(hits.size(), 1U);
+	EXPECT_EQ(hits[0].data, &b);
+
+	// Starting inside a box, which is hit where the ray leaves it
+	hits.clear();
+	bvh.raycast(glm::vec3(5.5f, 5.5f, 0.5f), glm::vec3(20.0f, 20.0f, 0.5f), hits);
+
+	ASSERT_EQ(hits.size(), 1U);
+	EXPECT_EQ(hits[0].data, &c);
+	EXPECT_FLOAT_EQ(hits[0].distance, 0.5f / 14.5f);
+
+	// A box in front of the far side of the one around the start comes first
+	int d = 4;
+	bvh.insert(glm::vec3(5.6f, 5.0f, 0.0f), glm::vec3(5.7f, 6.0f, 1.0f), &d);
+
+	hits.clear();
+	bvh.raycast(glm::vec3(5.5f, 5.5f, 0.5f), glm::vec3(20.0f, 5.5f, 0.5f), hits);
+
+	ASSERT_EQ(hits.size(), 2U);
+	EXPECT_EQ(hits[0].data, &d);
+	EXPECT_EQ(hits[1].data, &c);
+
+	// Missing everything
+	hits.clear();
+	bvh.raycast(glm::vec3(3.0f, 3.0f, 10.0f), glm::vec3(3.0f, 3.0f, -10.0f), hits);
+
+	EXPECT_TRUE(hits.empty());
+}
+
+GTEST_TEST(BVH, raycast) {
+	SceneRandom random(23);
+
+	Graphics::BVH bvh;
+
+	std::vector<SceneBox> scene;
+	for (size_t i = 0; i < 5000; i++)
+		scene.push_back(createBox(random));
+
+	for (std::vector<SceneBox>::iterator b = scene.begin(); b != scene.end(); ++b)
+		b->proxy = bvh.insert(b->min, b->max, &*b);
+
+	for (size_t i = 0; i < 200; i++) {
+		// Rays looking down into the scene, like clicking on the ground
+		const glm::vec3 start(random.get(-500.0f, 500.0f), random.get(-500.0f, 500.0f), 100.0f);
+		const glm::vec3 end = start + glm::vec3(random.get(-50.0f, 50.0f), random.get(-50.0f, 50.0f), -200.0f);
+
+		std::vector<Graphics::BVH::RayHit> hits;
+		bvh.raycast(start, end, hits);
+
+		std::vector<SceneBox *> found;
+		for (size_t j = 0; j < hits.size(); j++) {
+			found.push_back(static_cast<SceneBox *>(hits[j].data));
+
+			if (j > 0) {
+				ASSERT_LE(hits[j - 1].distance, hits[j].distance) << "In ray " << i;
+			}
+		}
+
+		// Compare against testing every single box
+		std::vector<SceneBox *> expected;
+		for (std::vector<SceneBox>::iterator b = scene.begin(); b != scene.end(); ++b) {
+			Common::BoundingBox box;
+			box.add(b->min.x, b->min.y, b->min.z);
+			box.add(b->max.x, b->max.y, b->max.z);
+
+			if (box.isIn(start.x, start.y, start.z, end.x, end.y, end.z))
+				expected.push_back(&*b);
+		}
+
+		std::sort(found.begin(), found.end());
+		std::sort(expected.begin(), expected.end());
+
+		ASSERT_EQ(found, expected) << "In ray " << i;
+	}
+}
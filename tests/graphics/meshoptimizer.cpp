@@ -0,0 +1,373 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for optimizing the layout of meshes.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/graphics/vertexbuffer.h"
+#include "src/graphics/indexbuffer.h"
+
+#include "src/graphics/mesh/meshoptimizer.h"
+
+/** A small, deterministic random number generator. */
+class MeshRandom {
+public:
+	MeshRandom(uint32 seed) : _state(seed) {
+	}
+
+	size_t get(size_t max) {
+		_state = _state * 1664525 + 1013904223;
+
+		return (_state >> 8) % max;
+	}
+
+private:
+	uint32 _state;
+};
+
+/** A regular grid of quads, as a triangle list in row order. */
+static std::vector<uint32> createGrid(size_t width, size_t height) {
+	std::vector<uint32> indices;
+
+	for (size_t y = 0; y < height; y++) {
+		for (size_t x = 0; x < width; x++) {
+			const uint32 v = y * (width + 1) + x;
+
+			const uint32 quad[6] = { v, v + 1, v + (uint32) width + 1, v + 1, v + (uint32) width + 2, v + (uint32) width + 1 };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+
+	return indices;
+}
+
+/** Put the triangles of a triangle list into a random order. */
+static void shuffleTriangles(std::vector<uint32> &indices, uint32 seed) {
+	MeshRandom random(seed);
+
+	const size_t triangleCount = indices.size() / 3;
+	for (size_t i = triangleCount - 1; i > 0; i--) {
+		const size_t j = random.get(i + 1);
+
+		for (size_t k = 0; k < 3; k++)
+			std::swap(indices[i * 3 + k], indices[j * 3 + k]);
+	}
+}
+
+/** Return the triangles of a triangle list, each as the indices it uses, in a canonical order. */
+static std::vector<std::vector<uint32> > getTriangles(const std::vector<uint32> &indices) {
+	std::vector<std::vector<uint32> > triangles;
+	for (size_t i = 0; i < indices.size(); i += 3)
+		triangles.push_back(std::vector<uint32>(indices.begin() + i, indices.begin() + i + 3));
+
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+GTEST_TEST(MeshOptimizer, acmr) {
+	// No vertex reused at all
+	const uint32 soup[9] = { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+	EXPECT_FLOAT_EQ(Graphics::Mesh::getACMR(std::vector<uint32>(soup, soup + 9)), 3.0f);
+
+	// Two triangles sharing an edge
+	const uint32 quad[6] = { 0, 1, 2, 2, 1, 3 };
+	EXPECT_FLOAT_EQ(Graphics::Mesh::getACMR(std::vector<uint32>(quad, quad + 6)), 2.0f);
+
+	// A cache too small to hold the shared vertices
+	const uint32 fan[9] = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+	EXPECT_FLOAT_EQ(Graphics::Mesh::getACMR(std::vector<uint32>(fan, fan + 9), 4), 3.0f);
+	EXPECT_FLOAT_EQ(Graphics::Mesh::getACMR(std::vector<uint32>(fan, fan + 9), 6), 2.0f);
+
+	EXPECT_EQ(Graphics::Mesh::getACMR(std::vector<uint32>()), 0.0f);
+}
+
+GTEST_TEST(MeshOptimizer, deduplicate) {
+	const float vertices[6][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 0.0f }, { 2.0f, 2.0f } };
+
+	std::vector<uint32> remap;
+	const size_t uniqueCount = Graphics::Mesh::deduplicateVertices(reinterpret_cast<const byte *>(vertices), 6,
+	                                                               2 * sizeof(float), remap);
+
+	EXPECT_EQ(uniqueCount, 4U);
+
+	ASSERT_EQ(remap.size(), 6U);
+	EXPECT_EQ(remap[0], 0U);
+	EXPECT_EQ(remap[1], 1U);
+	EXPECT_EQ(remap[2], 0U);
+	EXPECT_EQ(remap[3], 2U);
+	EXPECT_EQ(remap[4], 1U);
+	EXPECT_EQ(remap[5], 3U);
+}
+
+GTEST_TEST(MeshOptimizer, vertexCache) {
+	// A large grid, with its triangles in the worst possible order
+	std::vector<uint32> indices = createGrid(100, 100);
+	shuffleTriangles(indices, 1);
+
+	const std::vector<std::vector<uint32> > triangles = getTriangles(indices);
+
+	const float before = Graphics::Mesh::getACMR(indices);
+
+	Graphics::Mesh::optimizeVertexCache(indices, 101 * 101);
+
+	const float after = Graphics::Mesh::getACMR(indices);
+
+	std::printf("Shuffled 100x100 grid: ACMR %.3f before, %.3f after\n", before, after);
+
+	// Still the same triangles, with the same winding
+	ASSERT_EQ(indices.size(), 100U * 100U * 6U);
+	EXPECT_EQ(getTriangles(indices), triangles);
+
+	EXPECT_GT(before, 2.5f);
+	EXPECT_LT(after, 0.8f);
+}
+
+GTEST_TEST(MeshOptimizer, vertexFetch) {
+	const uint32 triangles[6] = { 5, 3, 4, 4, 3, 0 };
+	std::vector<uint32> indices(triangles, triangles + 6);
+
+	std::vector<uint32> remap;
+	EXPECT_EQ(Graphics::Mesh::optimizeVertexFetch(indices, 7, remap), 4U);
+
+	const uint32 expected[6] = { 0, 1, 2, 2, 1, 3 };
+	EXPECT_EQ(indices, std::vector<uint32>(expected, expected + 6));
+
+	ASSERT_EQ(remap.size(), 7U);
+	EXPECT_EQ(remap[5], 0U);
+	EXPECT_EQ(remap[0], 3U);
+	EXPECT_EQ(remap[1], 0xFFFFFFFFU);
+	EXPECT_EQ(remap[6], 0xFFFFFFFFU);
+}
+
+/** A vertex of a test mesh. */
+struct MeshVertex {
+	float position[3];
+	float normal[3];
+	float uv[2];
+
+	bool operator<(const MeshVertex &v) const {
+		return std::memcmp(this, &v, sizeof(MeshVertex)) < 0;
+	}
+
+	bool operator==(const MeshVertex &v) const {
+		return std::memcmp(this, &v, sizeof(MeshVertex)) == 0;
+	}
+};
+
+/** A UV sphere, with its vertices and triangles in the order a model exporter would write them. */
+static void createSphere(size_t rings, size_t segments, std::vector<MeshVertex> &vertices, std::vector<uint32> &indices) {
+	for (size_t r = 0; r <= rings; r++) {
+		const float theta = r * 3.14159265f / rings;
+
+		for (size_t s = 0; s <= segments; s++) {
+			const float phi = s * 2.0f * 3.14159265f / segments;
+
+			MeshVertex v;
+			v.normal[0] = std::sin(theta) * std::cos(phi);
+			v.normal[1] = std::sin(theta) * std::sin(phi);
+			v.normal[2] = std::cos(theta);
+
+			for (int i = 0; i < 3; i++)
+				v.position[i] = v.normal[i] * 2.0f;
+
+			v.uv[0] = s / (float) segments;
+			v.uv[1] = r / (float) rings;
+
+			vertices.push_back(v);
+		}
+	}
+
+	indices = createGrid(segments, rings);
+}
+
+/** Fill a vertex buffer in the linear layout, and an index buffer with 32-bit indices. */
+static void fillBuffers(const std::vector<MeshVertex> &vertices, const std::vector<uint32> &indices,
+                        Graphics::VertexBuffer &vertexBuffer, Graphics::IndexBuffer &indexBuffer) {
+
+	Graphics::VertexDecl decl;
+	decl.push_back(Graphics::VertexAttrib(Graphics::VPOSITION, 3, GL_FLOAT));
+	decl.push_back(Graphics::VertexAttrib(Graphics::VNORMAL  , 3, GL_FLOAT));
+	decl.push_back(Graphics::VertexAttrib(Graphics::VTCOORD  , 2, GL_FLOAT));
+
+	vertexBuffer.setVertexDeclLinear(vertices.size(), decl);
+
+	float *position = static_cast<float *>(vertexBuffer.getData(0));
+	float *normal   = static_cast<float *>(vertexBuffer.getData(1));
+	float *uv       = static_cast<float *>(vertexBuffer.getData(2));
+
+	for (size_t i = 0; i < vertices.size(); i++) {
+		std::memcpy(position + i * 3, vertices[i].position, sizeof(vertices[i].position));
+		std::memcpy(normal   + i * 3, vertices[i].normal  , sizeof(vertices[i].normal));
+		std::memcpy(uv       + i * 2, vertices[i].uv      , sizeof(vertices[i].uv));
+	}
+
+	indexBuffer.setSize(indices.size(), sizeof(uint32), GL_UNSIGNED_INT);
+	std::memcpy(indexBuffer.getData(), &indices[0], indices.size() * sizeof(uint32));
+}
+
+/** Return the triangles of a mesh, each as the vertices it uses, in a canonical order. */
+static std::vector<std::vector<MeshVertex> > getTriangles(const Graphics::VertexBuffer &vertexBuffer,
+                                                          const Graphics::IndexBuffer &indexBuffer) {
+
+	const Graphics::VertexDecl &decl = vertexBuffer.getVertexDecl();
+
+	std::vector<std::vector<MeshVertex> > triangles;
+	for (size_t i = 0; i < indexBuffer.getCount(); i += 3) {
+		std::vector<MeshVertex> triangle;
+
+		for (size_t j = 0; j < 3; j++) {
+			uint32 index;
+			if (indexBuffer.getType() == GL_UNSIGNED_SHORT)
+				index = static_cast<const uint16 *>(indexBuffer.getData())[i + j];
+			else
+				index = static_cast<const uint32 *>(indexBuffer.getData())[i + j];
+
+			MeshVertex v;
+			float *attributes[3] = { v.position, v.normal, v.uv };
+
+			for (size_t a = 0; a < 3; a++) {
+				const size_t size   = decl[a].size * sizeof(float);
+				const size_t stride = decl[a].stride ? decl[a].stride : size;
+
+				std::memcpy(attributes[a], static_cast<const byte *>(decl[a].pointer) + index * stride, size);
+			}
+
+			triangle.push_back(v);
+		}
+
+		triangles.push_back(triangle);
+	}
+
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+static std::vector<uint32> readIndices(const Graphics::IndexBuffer &indexBuffer) {
+	std::vector<uint32> indices(indexBuffer.getCount());
+
+	for (size_t i = 0; i < indices.size(); i++) {
+		if (indexBuffer.getType() == GL_UNSIGNED_SHORT)
+			indices[i] = static_cast<const uint16 *>(indexBuffer.getData())[i];
+		else
+			indices[i] = static_cast<const uint32 *>(indexBuffer.getData())[i];
+	}
+
+	return indices;
+}
+
+/** Optimize a mesh, and check that it still holds the same triangles. */
+static void testOptimizeMesh(const char *name, const std::vector<MeshVertex> &vertices,
+                             const std::vector<uint32> &indices, size_t uniqueCount) {
+
+	Graphics::VertexBuffer vertexBuffer;
+	Graphics::IndexBuffer indexBuffer;
+	fillBuffers(vertices, indices, vertexBuffer, indexBuffer);
+
+	const std::vector<std::vector<MeshVertex> > triangles = getTriangles(vertexBuffer, indexBuffer);
+
+	const float before = Graphics::Mesh::getACMR(indices);
+
+	ASSERT_TRUE(Graphics::Mesh::optimizeMesh(vertexBuffer, indexBuffer)) << name;
+
+	const float after = Graphics::Mesh::getACMR(readIndices(indexBuffer));
+
+	std::printf("%s: %zu vertices, ACMR %.3f before; %u vertices, ACMR %.3f after\n",
+	            name, vertices.size(), before, vertexBuffer.getCount(), after);
+
+	EXPECT_EQ(vertexBuffer.getCount(), uniqueCount) << name;
+	EXPECT_EQ(indexBuffer.getCount(), indices.size()) << name;
+	EXPECT_EQ(indexBuffer.getType(), (GLenum) GL_UNSIGNED_SHORT) << name;
+
+	// All attributes are interleaved, in their original order
+	const Graphics::VertexDecl &decl = vertexBuffer.getVertexDecl();
+	ASSERT_EQ(decl.size(), 3U) << name;
+	EXPECT_EQ(decl[0].index, (GLuint) Graphics::VPOSITION) << name;
+	EXPECT_EQ(decl[1].index, (GLuint) Graphics::VNORMAL) << name;
+	EXPECT_EQ(decl[2].index, (GLuint) Graphics::VTCOORD) << name;
+
+	for (size_t a = 0; a < decl.size(); a++)
+		EXPECT_EQ(decl[a].stride, (GLsizei) sizeof(MeshVertex)) << name;
+
+	EXPECT_EQ(getTriangles(vertexBuffer, indexBuffer), triangles) << name;
+
+	EXPECT_LE(after, before) << name;
+}
+
+GTEST_TEST(MeshOptimizer, optimizeSphere) {
+	std::vector<MeshVertex> vertices;
+	std::vector<uint32> indices;
+	createSphere(32, 48, vertices, indices);
+
+	testOptimizeMesh("Sphere", vertices, indices, vertices.size());
+}
+
+GTEST_TEST(MeshOptimizer, optimizeSoup) {
+	std::vector<MeshVertex> sphereVertices;
+	std::vector<uint32> sphereIndices;
+	createSphere(32, 48, sphereVertices, sphereIndices);
+
+	/* Every triangle with its own three vertices, and an index buffer
+	 * counting up. That's how the NWN binary model loader builds meshes. */
+	std::vector<MeshVertex> vertices;
+	std::vector<uint32> indices;
+	for (size_t i = 0; i < sphereIndices.size(); i++) {
+		vertices.push_back(sphereVertices[sphereIndices[i]]);
+		indices.push_back(i);
+	}
+
+	testOptimizeMesh("Triangle soup", vertices, indices, sphereVertices.size());
+}
+
+GTEST_TEST(MeshOptimizer, optimizeShuffled) {
+	std::vector<MeshVertex> vertices;
+	std::vector<uint32> indices;
+	createSphere(64, 64, vertices, indices);
+
+	shuffleTriangles(indices, 2);
+
+	testOptimizeMesh("Shuffled sphere", vertices, indices, vertices.size());
+}
+
+GTEST_TEST(MeshOptimizer, invalid) {
+	Graphics::VertexBuffer vertexBuffer;
+	Graphics::IndexBuffer indexBuffer;
+
+	// Nothing to optimize
+	EXPECT_FALSE(Graphics::Mesh::optimizeMesh(vertexBuffer, indexBuffer));
+
+	// Indices out of range
+	std::vector<MeshVertex> vertices(3);
+	const uint32 triangle[3] = { 0, 1, 3 };
+	fillBuffers(vertices, std::vector<uint32>(triangle, triangle + 3), vertexBuffer, indexBuffer);
+
+	EXPECT_FALSE(Graphics::Mesh::optimizeMesh(vertexBuffer, indexBuffer));
+	EXPECT_EQ(vertexBuffer.getCount(), 3U);
+	EXPECT_EQ(indexBuffer.getType(), (GLenum) GL_UNSIGNED_INT);
+}
@@ -0,0 +1,249 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the render queue's sorting.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "external/glm/gtc/matrix_transform.hpp"
+
+#include "src/common/ptrvector.h"
+
+#include "src/graphics/shader/shader.h"
+#include "src/graphics/shader/shadermaterial.h"
+#include "src/graphics/shader/shadersurface.h"
+#include "src/graphics/mesh/mesh.h"
+
+#include "src/graphics/render/renderqueue.h"
+
+/** A small, deterministic random number generator. */
+class SceneRandom {
+public:
+	SceneRandom(uint32 seed) : _state(seed) {
+	}
+
+	size_t get(size_t max) {
+		_state = _state * 1664525 + 1013904223;
+
+		return (_state >> 8) % max;
+	}
+
+private:
+	uint32 _state;
+};
+
+/** A synthetic scene, with resources that are never used for any actual rendering. */
+class SyntheticScene {
+public:
+	static const size_t kProgramCount  =  16;
+	static const size_t kMaterialCount = 400;
+	static const size_t kSurfaceCount  = 100;
+	static const size_t kMeshCount     = 600;
+
+	SyntheticScene() {
+		_vertexShader.reset(new Graphics::Shader::ShaderObject);
+		_fragmentShader.reset(new Graphics::Shader::ShaderObject);
+
+		for (size_t i = 0; i < kProgramCount; i++) {
+			_programs.push_back(new Graphics::Shader::ShaderProgram);
+			_programs.back()->glid = i + 1;
+		}
+
+		for (size_t i = 0; i < kMaterialCount; i++)
+			_materials.push_back(new Graphics::Shader::ShaderMaterial(_fragmentShader.get()));
+		for (size_t i = 0; i < kSurfaceCount; i++)
+			_surfaces.push_back(new Graphics::Shader::ShaderSurface(_vertexShader.get()));
+		for (size_t i = 0; i < kMeshCount; i++)
+			_meshes.push_back(new Graphics::Mesh::Mesh);
+	}
+
+	/** Queue this many nodes, in a random order. */
+	void queue(Graphics::Render::RenderQueue &queue, size_t count, uint32 seed) {
+		SceneRandom random(seed);
+
+		_transforms.resize(count);
+
+		for (size_t i = 0; i < count; i++) {
+			// Every material and every surface belongs to one program
+			const size_t material = random.get(kMaterialCount);
+			const size_t surface  = (material % (kSurfaceCount / kProgramCount)) * kProgramCount + (material % kProgramCount);
+			const size_t program  = material % kProgramCount;
+			const size_t mesh     = random.get(kMeshCount);
+
+			_transforms[i] = glm::translate(glm::mat4(), glm::vec3(random.get(1000), random.get(1000), random.get(100)));
+
+			queue.queueItem(_programs[program], _surfaces[surface], _materials[material], _meshes[mesh], &_transforms[i], 1.0f);
+		}
+	}
+
+private:
+	Common::ScopedPtr<Graphics::Shader::ShaderObject> _vertexShader;
+	Common::ScopedPtr<Graphics::Shader::ShaderObject> _fragmentShader;
+
+	Common::PtrVector<Graphics::Shader::ShaderProgram>  _programs;
+	Common::PtrVector<Graphics::Shader::ShaderMaterial> _materials;
+	Common::PtrVector<Graphics::Shader::ShaderSurface>  _surfaces;
+	Common::PtrVector<Graphics::Mesh::Mesh>             _meshes;
+
+	std::vector<glm::mat4> _transforms;
+};
+
+GTEST_TEST(RenderQueue, sortShader) {
+	SyntheticScene scene;
+
+	Graphics::Render::RenderQueue queue;
+	scene.queue(queue, 20000, 1);
+
+	EXPECT_EQ(queue.getSize(), 20000U);
+
+	const Graphics::Render::RenderQueue::Statistics unsorted = queue.countStateChanges();
+	EXPECT_EQ(unsorted.drawCalls, 20000U);
+
+	queue.sortShader();
+	EXPECT_EQ(queue.getSize(), 20000U);
+
+	const Graphics::Render::RenderQueue::Statistics sorted = queue.countStateChanges();
+	EXPECT_EQ(sorted.drawCalls, 20000U);
+
+	// Every program, and every material, is bound exactly once
+	EXPECT_EQ(sorted.programChanges , (uint32) SyntheticScene::kProgramCount);
+	EXPECT_EQ(sorted.materialChanges, (uint32) SyntheticScene::kMaterialCount);
+
+	// At most one mesh change for every combination of material and mesh
+	EXPECT_LE(sorted.meshChanges, (uint32) (SyntheticScene::kMaterialCount * SyntheticScene::kMeshCount));
+	EXPECT_LT(sorted.meshChanges, unsorted.meshChanges);
+
+	EXPECT_LT(sorted.getStateChanges(), unsorted.getStateChanges() / 2);
+
+	// Instancing only ever merges draw calls
+	const Graphics::Render::RenderQueue::Statistics instanced = queue.countStateChanges(true);
+	EXPECT_EQ(instanced.drawCalls + instanced.drawsSaved, 20000U);
+	EXPECT_EQ(instanced.getStateChanges(), sorted.getStateChanges());
+
+	// Sorting again doesn't change anything anymore
+	queue.sortShader();
+
+	const Graphics::Render::RenderQueue::Statistics resorted = queue.countStateChanges();
+	EXPECT_EQ(resorted.getStateChanges(), sorted.getStateChanges());
+
+	queue.clear();
+	EXPECT_EQ(queue.getSize(), 0U);
+	EXPECT_EQ(queue.countStateChanges().drawCalls, 0U);
+}
+
+GTEST_TEST(RenderQueue, sortDepth) {
+	SyntheticScene scene;
+
+	Graphics::Render::RenderQueue queue;
+	queue.setCameraReference(glm::vec3(500.0f, 500.0f, 0.0f));
+
+	scene.queue(queue, 5000, 2);
+
+	queue.sortDepth();
+
+	const std::vector<Graphics::Render::RenderQueue::RenderQueueNode> &nodes = queue.getNodes();
+	ASSERT_EQ(nodes.size(), 5000U);
+
+	for (size_t i = 1; i < nodes.size(); i++)
+		ASSERT_LE(nodes[i - 1].reference, nodes[i].reference) << "At node " << i;
+
+	const Graphics::Render::RenderQueue::Statistics sorted = queue.countStateChanges();
+	EXPECT_EQ(sorted.drawCalls, 5000U);
+
+	// Sorting by depth only ignores the state
+	queue.sortShader();
+	EXPECT_LT(queue.countStateChanges().getStateChanges(), sorted.getStateChanges());
+}
+
+GTEST_TEST(RenderQueue, instancing) {
+	Graphics::Shader::ShaderObject vertexShader, fragmentShader;
+
+	Graphics::Shader::ShaderProgram instancedProgram, program;
+	instancedProgram.glid = 1;
+	instancedProgram.instanced = true;
+	program.glid = 2;
+
+	Graphics::Shader::ShaderMaterial material(&fragmentShader);
+	Graphics::Shader::ShaderSurface surface(&vertexShader);
+
+	Graphics::Mesh::Mesh tile, grass, placeable;
+
+	std::vector<glm::mat4> transforms(19);
+	for (size_t i = 0; i < transforms.size(); i++)
+		transforms[i] = glm::translate(glm::mat4(), glm::vec3(i, 2.0f * i, 3.0f * i));
+
+	Graphics::Render::RenderQueue queue;
+
+	/* 10 tiles to draw instanced, 3 grass patches too few to be worth it,
+	 * and 6 placeables whose program doesn't take the instance inputs. */
+	for (size_t i = 0; i < 19; i++) {
+		if      ((i % 2) == 0)
+			queue.queueItem(&instancedProgram, &surface, &material, &tile, &transforms[i], 0.05f * i);
+		else if ((i % 6) == 1)
+			queue.queueItem(&instancedProgram, &surface, &material, &grass, &transforms[i], 1.0f);
+		else
+			queue.queueItem(&program, &surface, &material, &placeable, &transforms[i], 1.0f);
+	}
+
+	// Without sorting, there are no runs of nodes to speak of
+	EXPECT_EQ(queue.countStateChanges(true).instancedBatches, 0U);
+
+	queue.sortShader();
+
+	const Graphics::Render::RenderQueue::Statistics plain = queue.countStateChanges();
+	EXPECT_EQ(plain.drawCalls, 19U);
+	EXPECT_EQ(plain.instancedBatches, 0U);
+	EXPECT_EQ(plain.drawsSaved, 0U);
+
+	const Graphics::Render::RenderQueue::Statistics instanced = queue.countStateChanges(true);
+	EXPECT_EQ(instanced.drawCalls, 1U + 3U + 6U);
+	EXPECT_EQ(instanced.instancedBatches, 1U);
+	EXPECT_EQ(instanced.drawsSaved, 9U);
+	EXPECT_EQ(instanced.getStateChanges(), plain.getStateChanges());
+
+	std::vector<Graphics::Render::RenderQueue::InstanceBatch> batches;
+	std::vector<Graphics::Render::RenderQueue::InstanceData> instances;
+	queue.gatherInstances(batches, instances);
+
+	ASSERT_EQ(batches.size(), 1U);
+	ASSERT_EQ(instances.size(), 10U);
+	EXPECT_EQ(batches[0].count, 10U);
+	EXPECT_EQ(batches[0].offset, 0U);
+
+	// The instance data follows the nodes of the run, in order
+	const std::vector<Graphics::Render::RenderQueue::RenderQueueNode> &nodes = queue.getNodes();
+	for (size_t i = 0; i < batches[0].count; i++) {
+		const Graphics::Render::RenderQueue::RenderQueueNode &node = nodes[batches[0].start + i];
+		EXPECT_EQ(node.mesh, &tile);
+
+		EXPECT_FLOAT_EQ(instances[i].alpha, node.alpha);
+		for (int j = 0; j < 16; j++)
+			EXPECT_FLOAT_EQ(instances[i].transform[j], (&(*node.transform)[0][0])[j]);
+	}
+
+	queue.clear();
+	queue.gatherInstances(batches, instances);
+	EXPECT_TRUE(batches.empty());
+	EXPECT_TRUE(instances.empty());
+}
@@ -0,0 +1,59 @@
+# xoreos - A reimplementation of BioWare's Aurora engine
+#
+# xoreos is the legal property of its developers, whose names
+# can be found in the AUTHORS file distributed with this source
+# distribution.
+#
+# xoreos is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# xoreos is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+
+# Unit tests for the CPU-side parts of the Graphics namespace.
+
+graphics_LIBS = \
+    $(test_LIBS) \
+    src/graphics/libgraphics.la \
+    src/aurora/libaurora.la \
+    src/common/libcommon.la \
+    src/events/libevents.la \
+    tests/version/libversion.la \
+    $(LDADD)
+
+check_PROGRAMS                               += tests/graphics/test_textureresidency
+tests_graphics_test_textureresidency_SOURCES  = tests/graphics/textureresidency.cpp
+tests_graphics_test_textureresidency_LDADD    = $(graphics_LIBS)
+tests_graphics_test_textureresidency_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                       += tests/graphics/test_yuvtorgb
+tests_graphics_test_yuvtorgb_SOURCES  = tests/graphics/yuvtorgb.cpp
+tests_graphics_test_yuvtorgb_LDADD    = $(graphics_LIBS)
+tests_graphics_test_yuvtorgb_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                      += tests/graphics/test_culling
+tests_graphics_test_culling_SOURCES  = tests/graphics/culling.cpp
+tests_graphics_test_culling_LDADD    = $(graphics_LIBS)
+tests_graphics_test_culling_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                          += tests/graphics/test_renderqueue
+tests_graphics_test_renderqueue_SOURCES  = tests/graphics/renderqueue.cpp
+tests_graphics_test_renderqueue_LDADD    = $(graphics_LIBS)
+tests_graphics_test_renderqueue_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                            += tests/graphics/test_meshoptimizer
+tests_graphics_test_meshoptimizer_SOURCES  = tests/graphics/meshoptimizer.cpp
+tests_graphics_test_meshoptimizer_LDADD    = $(graphics_LIBS)
+tests_graphics_test_meshoptimizer_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                         += tests/graphics/test_textlayout
+tests_graphics_test_textlayout_SOURCES  = tests/graphics/textlayout.cpp
+tests_graphics_test_textlayout_LDADD    = $(graphics_LIBS)
+tests_graphics_test_textlayout_CXXFLAGS = $(test_CXXFLAGS)
@@ -0,0 +1,267 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for laying out texts into quads.
+ */
+
+#include "gtest/gtest.h"
+
+#include "src/common/ustring.h"
+
+#include "src/graphics/font.h"
+#include "src/graphics/textlayout.h"
+
+/** A font with fixed-size characters, spread over two texture pages.
+ *
+ *  Spaces are 4 pixels wide and not drawn, an 'i' is 5 pixels wide, all
+ *  other characters are 10 pixels wide. Characters from 'n' onwards are
+ *  on the second page.
+ */
+class TestFont : public Graphics::Font {
+public:
+	float getWidth(uint32 c) const {
+		if (c == ' ')
+			return 4.0f;
+		if (c == 'i')
+			return 5.0f;
+
+		return 10.0f;
+	}
+
+	float getHeight() const {
+		return 16.0f;
+	}
+
+	float getLineSpacing() const {
+		return 2.0f;
+	}
+
+	void draw(uint32 UNUSED(c)) const {
+	}
+
+	bool getCharQuad(uint32 c, CharQuad &quad) const {
+		if (c == ' ')
+			return false;
+
+		quad.page = (c >= 'n') ? 1 : 0;
+
+		const float width = getWidth(c);
+
+		quad.vX[0] = 0.0f;  quad.vY[0] = 0.0f;
+		quad.vX[1] = width; quad.vY[1] = 0.0f;
+		quad.vX[2] = width; quad.vY[2] = 16.0f;
+		quad.vX[3] = 0.0f;  quad.vY[3] = 16.0f;
+
+		for (int i = 0; i < 4; i++) {
+			quad.tX[i] = c / 256.0f;
+			quad.tY[i] = i / 4.0f;
+		}
+
+		return true;
+	}
+};
+
+/** Return the position of the lower left corner of a quad. */
+static void getQuadPosition(const Graphics::TextLayout &layout, size_t page, size_t quad, float &x, float &y) {
+	ASSERT_LT(page, layout.getPageCount());
+	ASSERT_LT(quad, layout.getPage(page).getQuadCount());
+
+	x = layout.getPage(page).vertices[quad * 12 + 0];
+	y = layout.getPage(page).vertices[quad * 12 + 1];
+}
+
+/** Return the character a quad shows, by way of the test font's texture coordinates. */
+static uint32 getQuadChar(const Graphics::TextLayout &layout, size_t page, size_t quad) {
+	return (uint32) (layout.getPage(page).texCoords[quad * 8] * 256.0f + 0.5f);
+}
+
+GTEST_TEST(TextLayout, line) {
+	TestFont font;
+	Graphics::TextLayout layout;
+
+	layout.build(font, "abc", Graphics::ColorPositions(), 100.0f, 50.0f, 0.0f, 1.0f);
+
+	EXPECT_EQ(layout.getLineCount(), 1U);
+	EXPECT_EQ(layout.getQuadCount(), 3U);
+	ASSERT_EQ(layout.getPageCount(), 1U);
+
+	const Graphics::TextLayout::Page &page = layout.getPage(0);
+	ASSERT_EQ(page.getQuadCount(), 3U);
+	ASSERT_EQ(page.vertices.size(), 3U * 4U * 3U);
+	ASSERT_EQ(page.texCoords.size(), 3U * 4U * 2U);
+	ASSERT_EQ(page.colors.size(), 3U * 4U * 4U);
+
+	// Top-aligned in a 50 pixel high box: the line's bottom is at 50 - 18
+	for (size_t i = 0; i < 3; i++) {
+		float x, y;
+		getQuadPosition(layout, 0, i, x, y);
+
+		EXPECT_FLOAT_EQ(x, i * 10.0f);
+		EXPECT_FLOAT_EQ(y, 32.0f);
+
+		EXPECT_EQ(getQuadChar(layout, 0, i), (uint32) ('a' + i));
+
+		// The upper right vertex
+		EXPECT_FLOAT_EQ(page.vertices[i * 12 + 6], i * 10.0f + 10.0f);
+		EXPECT_FLOAT_EQ(page.vertices[i * 12 + 7], 48.0f);
+		EXPECT_FLOAT_EQ(page.vertices[i * 12 + 8], 0.0f);
+	}
+
+	layout.build(font, "", Graphics::ColorPositions(), 100.0f, 50.0f, 0.0f, 1.0f);
+	EXPECT_EQ(layout.getLineCount(), 0U);
+	EXPECT_EQ(layout.getQuadCount(), 0U);
+}
+
+GTEST_TEST(TextLayout, pages) {
+	TestFont font;
+	Graphics::TextLayout layout;
+
+	layout.build(font, "an ox", Graphics::ColorPositions(), 100.0f, 50.0f, 0.0f, 1.0f);
+
+	// The space isn't drawn at all
+	EXPECT_EQ(layout.getQuadCount(), 4U);
+	ASSERT_EQ(layout.getPageCount(), 2U);
+	ASSERT_EQ(layout.getPage(0).getQuadCount(), 1U);
+	ASSERT_EQ(layout.getPage(1).getQuadCount(), 3U);
+
+	EXPECT_EQ(getQuadChar(layout, 0, 0), (uint32) 'a');
+	EXPECT_EQ(getQuadChar(layout, 1, 0), (uint32) 'n');
+	EXPECT_EQ(getQuadChar(layout, 1, 1), (uint32) 'o');
+	EXPECT_EQ(getQuadChar(layout, 1, 2), (uint32) 'x');
+
+	// But it still moves the pen along
+	float x, y;
+	getQuadPosition(layout, 1, 1, x, y);
+	EXPECT_FLOAT_EQ(x, 24.0f);
+	getQuadPosition(layout, 1, 2, x, y);
+	EXPECT_FLOAT_EQ(x, 34.0f);
+
+	// Only characters on the second page
+	layout.build(font, "on", Graphics::ColorPositions(), 100.0f, 50.0f, 0.0f, 1.0f);
+	ASSERT_EQ(layout.getPageCount(), 2U);
+	EXPECT_EQ(layout.getPage(0).getQuadCount(), 0U);
+	EXPECT_EQ(layout.getPage(1).getQuadCount(), 2U);
+}
+
+GTEST_TEST(TextLayout, align) {
+	TestFont font;
+	Graphics::TextLayout layout;
+
+	const float kHAlign[3] = { 0.0f, 0.5f, 1.0f };
+	const float kVAlign[3] = { 1.0f, 0.5f, 0.0f };
+
+	const float kX[3] = { 0.0f, 40.0f, 80.0f };
+	const float kY[3] = { 32.0f, 16.0f, 0.0f };
+
+	for (size_t h = 0; h < 3; h++) {
+		for (size_t v = 0; v < 3; v++) {
+			layout.build(font, "ab", Graphics::ColorPositions(), 100.0f, 50.0f, kHAlign[h], kVAlign[v]);
+
+			float x, y;
+			getQuadPosition(layout, 0, 0, x, y);
+
+			EXPECT_FLOAT_EQ(x, kX[h]) << h << ", " << v;
+			EXPECT_FLOAT_EQ(y, kY[v]) << h << ", " << v;
+		}
+	}
+}
+
+GTEST_TEST(TextLayout, wrap) {
+	TestFont font;
+	Graphics::TextLayout layout;
+
+	layout.build(font, "aaa bbb\nci", Graphics::ColorPositions(), 45.0f, 60.0f, 0.0f, 1.0f);
+
+	ASSERT_EQ(layout.getLineCount(), 3U);
+	ASSERT_EQ(layout.getPageCount(), 1U);
+	ASSERT_EQ(layout.getQuadCount(), 8U);
+
+	// Lines are 18 pixels apart, starting from the top
+	float x, y;
+
+	getQuadPosition(layout, 0, 0, x, y);
+	EXPECT_FLOAT_EQ(x, 0.0f);
+	EXPECT_FLOAT_EQ(y, 42.0f);
+
+	// The second line starts with the space the line was broken at
+	getQuadPosition(layout, 0, 3, x, y);
+	EXPECT_FLOAT_EQ(x, 4.0f);
+	EXPECT_FLOAT_EQ(y, 24.0f);
+
+	getQuadPosition(layout, 0, 7, x, y);
+	EXPECT_FLOAT_EQ(x, 10.0f);
+	EXPECT_FLOAT_EQ(y, 6.0f);
+
+	// Right-aligned, by the width of each line
+	layout.build(font, "aaa bbb\nci", Graphics::ColorPositions(), 45.0f, 60.0f, 1.0f, 1.0f);
+
+	getQuadPosition(layout, 0, 0, x, y);
+	EXPECT_FLOAT_EQ(x, 15.0f);
+	getQuadPosition(layout, 0, 3, x, y);
+	EXPECT_FLOAT_EQ(x, 15.0f);
+	getQuadPosition(layout, 0, 6, x, y);
+	EXPECT_FLOAT_EQ(x, 30.0f);
+}
+
+static void expectQuadColor(const Graphics::TextLayout &layout, size_t quad, float r, float g, float b, float a) {
+	const float *colors = &layout.getPage(0).colors[quad * 16];
+
+	for (size_t i = 0; i < 4; i++) {
+		EXPECT_FLOAT_EQ(colors[i * 4 + 0], r) << quad << ", " << i;
+		EXPECT_FLOAT_EQ(colors[i * 4 + 1], g) << quad << ", " << i;
+		EXPECT_FLOAT_EQ(colors[i * 4 + 2], b) << quad << ", " << i;
+		EXPECT_FLOAT_EQ(colors[i * 4 + 3], a) << quad << ", " << i;
+	}
+}
+
+GTEST_TEST(TextLayout, colors) {
+	TestFont font;
+	Graphics::TextLayout layout;
+
+	// "a<cFF000080>b</c>c"
+	Graphics::ColorPositions colors(2);
+
+	colors[0].position     = 1;
+	colors[0].defaultColor = false;
+	colors[0].r            = 1.0f;
+	colors[0].g            = 0.0f;
+	colors[0].b            = 0.0f;
+	colors[0].a            = 0.5f;
+
+	colors[1].position     = 2;
+	colors[1].defaultColor = true;
+
+	layout.setDefaultColor(0.2f, 0.4f, 0.6f, 0.8f);
+	layout.build(font, "abc", colors, 100.0f, 50.0f, 0.0f, 1.0f);
+
+	ASSERT_EQ(layout.getQuadCount(), 3U);
+
+	expectQuadColor(layout, 0, 0.2f, 0.4f, 0.6f, 0.8f);
+	expectQuadColor(layout, 1, 1.0f, 0.0f, 0.0f, 0.5f);
+	expectQuadColor(layout, 2, 0.2f, 0.4f, 0.6f, 0.8f);
+
+	// Changing the default color doesn't touch the color token's color
+	layout.setDefaultColor(0.0f, 1.0f, 0.0f, 1.0f);
+
+	expectQuadColor(layout, 0, 0.0f, 1.0f, 0.0f, 1.0f);
+	expectQuadColor(layout, 1, 1.0f, 0.0f, 0.0f, 0.5f);
+	expectQuadColor(layout, 2, 0.0f, 1.0f, 0.0f, 1.0f);
+}
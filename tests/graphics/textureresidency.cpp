@@ -0,0 +1,308 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our texture memory bookkeeping.
+ */
+
+#include <cstring>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/graphics/images/decoder.h"
+
+#include "src/graphics/aurora/textureresidency.h"
+
+using Graphics::Aurora::TextureResidency;
+
+/** An uncompressed RGBA image with a full mip map chain. */
+class MipMappedImage : public Graphics::ImageDecoder {
+public:
+	MipMappedImage(int size, size_t layers = 1) {
+		_layerCount = layers;
+
+		for (size_t i = 0; i < layers; i++) {
+			for (int s = size; s >= 1; s /= 2) {
+				MipMap *mipMap = new MipMap(this);
+
+				mipMap->width  = s;
+				mipMap->height = s;
+				mipMap->size   = s * s * 4;
+
+				mipMap->data.reset(new byte[mipMap->size]);
+				std::memset(mipMap->data.get(), i, mipMap->size);
+
+				_mipMaps.push_back(mipMap);
+			}
+		}
+	}
+};
+
+static std::vector<size_t> getSizes(const Graphics::ImageDecoder &image) {
+	std::vector<size_t> sizes;
+	for (size_t i = 0; i < image.getMipMapCount(); i++)
+		sizes.push_back(image.getMipMapSize(i));
+
+	return sizes;
+}
+
+GTEST_TEST(TextureResidency, imageSize) {
+	const MipMappedImage image(8, 2);
+
+	ASSERT_EQ(image.getMipMapCount(), 4);
+
+	EXPECT_EQ(image.getMipMapSize(0), 2 * 8 * 8 * 4);
+	EXPECT_EQ(image.getMipMapSize(3), 2 * 1 * 1 * 4);
+
+	EXPECT_EQ(image.getSize(), 2 * (256 + 64 + 16 + 4));
+}
+
+GTEST_TEST(TextureResidency, imageDropMipMaps) {
+	MipMappedImage image(8, 2);
+
+	image.dropMipMaps(2);
+
+	ASSERT_EQ(image.getMipMapCount(), 2);
+	ASSERT_EQ(image.getLayerCount(), 2);
+
+	EXPECT_EQ(image.getMipMap(0, 0).width, 2);
+	EXPECT_EQ(image.getMipMap(0, 1).width, 2);
+	EXPECT_EQ(image.getMipMap(1, 1).width, 1);
+
+	// The layers must not get mixed up
+	EXPECT_EQ(image.getMipMap(0, 0).data[0], 0);
+	EXPECT_EQ(image.getMipMap(0, 1).data[0], 1);
+
+	EXPECT_EQ(image.getSize(), 2 * (16 + 4));
+
+	// The smallest mip map always stays
+	image.dropMipMaps(10);
+
+	ASSERT_EQ(image.getMipMapCount(), 1);
+	EXPECT_EQ(image.getMipMap(0, 0).width, 1);
+	EXPECT_EQ(image.getMipMap(0, 1).width, 1);
+}
+
+GTEST_TEST(TextureResidency, accounting) {
+	TextureResidency residency;
+
+	const MipMappedImage image(8);
+
+	TextureResidency::Entry *entry1 = residency.addTexture(getSizes(image));
+	TextureResidency::Entry *entry2 = residency.addTexture(getSizes(image));
+
+	EXPECT_EQ(residency.getTextureCount(), 2);
+
+	EXPECT_EQ(residency.getCPUSize(), 2 * image.getSize());
+	EXPECT_EQ(residency.getGPUSize(), 0);
+
+	residency.setUploaded(entry1, true);
+
+	EXPECT_EQ(residency.getCPUSize(), 2 * image.getSize());
+	EXPECT_EQ(residency.getGPUSize(), image.getSize());
+	EXPECT_EQ(residency.getSize(), 3 * image.getSize());
+
+	residency.setBaseLevel(entry1, 1);
+
+	EXPECT_EQ(residency.getCPUSize(), image.getSize() + 64 + 16 + 4);
+	EXPECT_EQ(residency.getGPUSize(), 64 + 16 + 4);
+
+	residency.removeTexture(entry1);
+
+	EXPECT_EQ(residency.getTextureCount(), 1);
+	EXPECT_EQ(residency.getCPUSize(), image.getSize());
+	EXPECT_EQ(residency.getGPUSize(), 0);
+
+	residency.removeTexture(entry2);
+
+	EXPECT_EQ(residency.getCPUSize(), 0);
+}
+
+GTEST_TEST(TextureResidency, unlimited) {
+	TextureResidency residency;
+
+	const MipMappedImage image(64);
+
+	for (size_t i = 0; i < 16; i++)
+		residency.addTexture(getSizes(image));
+
+	TextureResidency::Changes changes;
+	residency.update(changes);
+
+	EXPECT_TRUE(changes.empty());
+}
+
+GTEST_TEST(TextureResidency, evictLeastRecentlyUsed) {
+	const MipMappedImage image(8);
+	const size_t size = image.getSize();
+
+	TextureResidency residency(3 * size - 256);
+
+	TextureResidency::Entry *entryOld = residency.addTexture(getSizes(image));
+	residency.nextFrame();
+	TextureResidency::Entry *entryNew = residency.addTexture(getSizes(image));
+	residency.nextFrame();
+	TextureResidency::Entry *entryCur = residency.addTexture(getSizes(image));
+
+	// Dropping the largest mip map of the oldest texture is enough
+	TextureResidency::Changes changes;
+	residency.update(changes);
+
+	ASSERT_EQ(changes.size(), 1);
+	EXPECT_EQ(changes[0].entry, entryOld);
+	EXPECT_EQ(changes[0].baseLevel, 1);
+
+	residency.setBaseLevel(entryOld, 1);
+	EXPECT_LE(residency.getSize(), residency.getBudget());
+
+	residency.update(changes);
+	EXPECT_TRUE(changes.empty());
+
+	// Use the oldest one again, now the second one is least recently used
+	residency.nextFrame();
+	residency.touch(entryOld, 100.0);
+	residency.touch(entryCur, 100.0);
+	residency.setBudget(size);
+
+	residency.update(changes);
+
+	ASSERT_FALSE(changes.empty());
+	EXPECT_EQ(changes[0].entry, entryNew);
+	EXPECT_EQ(changes[0].baseLevel, 3);
+}
+
+GTEST_TEST(TextureResidency, evictFarthest) {
+	const MipMappedImage image(8);
+	const size_t size = image.getSize();
+
+	TextureResidency residency(3 * size - 256);
+	residency.setStreamDistance(10.0);
+
+	TextureResidency::Entry *entryNear = residency.addTexture(getSizes(image));
+	TextureResidency::Entry *entryMid  = residency.addTexture(getSizes(image));
+	TextureResidency::Entry *entryFar  = residency.addTexture(getSizes(image));
+
+	residency.nextFrame();
+	residency.touch(entryNear,   5.0);
+	residency.touch(entryMid ,  50.0);
+	residency.touch(entryFar , 500.0);
+
+	TextureResidency::Changes changes;
+	residency.update(changes);
+
+	ASSERT_EQ(changes.size(), 1);
+	EXPECT_EQ(changes[0].entry, entryFar);
+	EXPECT_EQ(changes[0].baseLevel, 1);
+}
+
+GTEST_TEST(TextureResidency, keepSmallestMipMap) {
+	const MipMappedImage image(8);
+
+	TextureResidency residency(1);
+
+	TextureResidency::Entry *entry = residency.addTexture(getSizes(image));
+
+	TextureResidency::Changes changes;
+	residency.update(changes);
+
+	ASSERT_EQ(changes.size(), 1);
+	EXPECT_EQ(changes[0].entry, entry);
+	EXPECT_EQ(changes[0].baseLevel, 3);
+
+	residency.setBaseLevel(entry, 3);
+
+	residency.update(changes);
+	EXPECT_TRUE(changes.empty());
+}
+
+GTEST_TEST(TextureResidency, notStreamable) {
+	const MipMappedImage image(8);
+
+	TextureResidency residency(1);
+
+	residency.addTexture(getSizes(image), false);
+	residency.addTexture(std::vector<size_t>(1, 256));
+
+	TextureResidency::Changes changes;
+	residency.update(changes);
+
+	EXPECT_TRUE(changes.empty());
+}
+
+GTEST_TEST(TextureResidency, streamIn) {
+	const MipMappedImage image(8);
+
+	TextureResidency residency;
+	residency.setStreamDistance(10.0);
+
+	TextureResidency::Entry *entry = residency.addTexture(getSizes(image));
+	residency.setBaseLevel(entry, 2);
+
+	residency.nextFrame();
+
+	// Not used this frame
+	TextureResidency::Changes changes;
+	residency.update(changes);
+
+	EXPECT_TRUE(changes.empty());
+
+	// Used, but too far away
+	residency.touch(entry, 20.0);
+	residency.update(changes);
+
+	EXPECT_TRUE(changes.empty());
+
+	// Something closer used it as well
+	residency.touch(entry, 5.0);
+	residency.update(changes);
+
+	ASSERT_EQ(changes.size(), 1);
+	EXPECT_EQ(changes[0].entry, entry);
+	EXPECT_EQ(changes[0].baseLevel, 0);
+}
+
+GTEST_TEST(TextureResidency, streamInEvictsOthers) {
+	const MipMappedImage image(8);
+	const size_t size = image.getSize();
+
+	TextureResidency residency(size + 16 + 4);
+	residency.setStreamDistance(10.0);
+
+	TextureResidency::Entry *entryNear = residency.addTexture(getSizes(image));
+	TextureResidency::Entry *entryIdle = residency.addTexture(getSizes(image));
+
+	residency.setBaseLevel(entryNear, 2);
+
+	residency.nextFrame();
+	residency.touch(entryNear, 1.0);
+
+	TextureResidency::Changes changes;
+	residency.update(changes);
+
+	ASSERT_EQ(changes.size(), 2);
+
+	EXPECT_EQ(changes[0].entry, entryNear);
+	EXPECT_EQ(changes[0].baseLevel, 0);
+
+	EXPECT_EQ(changes[1].entry, entryIdle);
+	EXPECT_EQ(changes[1].baseLevel, 2);
+}
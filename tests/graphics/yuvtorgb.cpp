@@ -0,0 +1,145 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our YUV to RGB conversion.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+
+#include "src/graphics/yuv_to_rgb.h"
+
+typedef Graphics::YUVToRGBManager::LuminanceScale LuminanceScale;
+
+static const LuminanceScale kScaleFull = Graphics::YUVToRGBManager::kScaleFull;
+static const LuminanceScale kScaleITU  = Graphics::YUVToRGBManager::kScaleITU;
+
+/** A YUV420 image with an alpha plane, filled with pseudo-random data. */
+struct YUVImage {
+	int width, height;
+	int yPitch, uvPitch;
+
+	std::vector<byte> y, u, v, a;
+
+	YUVImage(int w, int h, uint32 seed) : width(w), height(h), yPitch(w + 8), uvPitch((w >> 1) + 4) {
+		y.resize(yPitch  * h);
+		a.resize(yPitch  * h);
+		u.resize(uvPitch * (h >> 1));
+		v.resize(uvPitch * (h >> 1));
+
+		fill(y, seed);
+		fill(a, seed + 1);
+		fill(u, seed + 2);
+		fill(v, seed + 3);
+	}
+
+	static void fill(std::vector<byte> &data, uint32 random) {
+		for (std::vector<byte>::iterator d = data.begin(); d != data.end(); ++d) {
+			random = random * 1664525 + 1013904223;
+
+			*d = random >> 24;
+		}
+	}
+};
+
+/** Convert one pixel the way the lookup tables do. */
+static void convertPixel(LuminanceScale scale, byte *dst, int y, int u, int v, byte a) {
+	const int16 cr = v - 128, cb = u - 128;
+
+	const int dR = (int16) ( (0.419 / 0.299) * cr);
+	const int dG = (int16) (-(0.299 / 0.419) * cr) + (int16) (-(0.114 / 0.331) * cb);
+	const int dB = (int16) ( (0.587 / 0.331) * cb);
+
+	const int values[3] = { y + dB, y + dG, y + dR };
+	for (int i = 0; i < 3; i++) {
+		if (scale == kScaleFull)
+			dst[i] = CLIP(values[i], 0, 255);
+		else
+			dst[i] = (CLIP(values[i], 16, 235) - 16) * 255 / 219;
+	}
+
+	dst[3] = a;
+}
+
+/** Convert an image, and compare it with the per-pixel conversion. */
+static void compareConversion(LuminanceScale scale, int width, int height, bool alpha, int threads) {
+	YUVImage image(width, height, width * height + (alpha ? 1 : 0));
+
+	const int dstPitch = width * 4 + 12;
+	std::vector<byte> dst(dstPitch * height, 0);
+
+	YUVToRGBMan.setThreadCount(threads);
+
+	if (alpha)
+		YUVToRGBMan.convert420(scale, &dst[0], dstPitch, &image.y[0], &image.u[0], &image.v[0], &image.a[0],
+		                       width, height, image.yPitch, image.uvPitch);
+	else
+		YUVToRGBMan.convert420(scale, &dst[0], dstPitch, &image.y[0], &image.u[0], &image.v[0],
+		                       width, height, image.yPitch, image.uvPitch);
+
+	YUVToRGBMan.setThreadCount(1);
+
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			byte expected[4];
+			convertPixel(scale, expected, image.y[y * image.yPitch + x],
+			             image.u[(y >> 1) * image.uvPitch + (x >> 1)], image.v[(y >> 1) * image.uvPitch + (x >> 1)],
+			             alpha ? image.a[y * image.yPitch + x] : 0xFF);
+
+			// The image is flipped vertically
+			const byte *pixel = &dst[(height - 1 - y) * dstPitch + x * 4];
+
+			for (int i = 0; i < 4; i++)
+				ASSERT_NEAR(pixel[i], expected[i], 1) << "At " << x << ", " << y << ", component " << i;
+		}
+	}
+}
+
+GTEST_TEST(YUVToRGB, full) {
+	compareConversion(kScaleFull, 64, 32, false, 1);
+}
+
+GTEST_TEST(YUVToRGB, fullAlpha) {
+	compareConversion(kScaleFull, 64, 32, true, 1);
+}
+
+GTEST_TEST(YUVToRGB, itu) {
+	compareConversion(kScaleITU, 64, 32, false, 1);
+}
+
+GTEST_TEST(YUVToRGB, ituAlpha) {
+	compareConversion(kScaleITU, 64, 32, true, 1);
+}
+
+GTEST_TEST(YUVToRGB, oddSizes) {
+	// Widths that don't fill whole vectors
+	compareConversion(kScaleFull, 2, 2, true, 1);
+	compareConversion(kScaleITU, 30, 6, false, 1);
+	compareConversion(kScaleITU, 46, 10, true, 1);
+}
+
+GTEST_TEST(YUVToRGB, threads) {
+	compareConversion(kScaleITU, 640, 480, true, 4);
+	compareConversion(kScaleFull, 1280, 720, false, 3);
+}
@@ -0,0 +1,307 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for decoding audio streams ahead of playback.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
+#include "src/common/thread.h"
+
+#include "src/sound/decodeahead.h"
+
+/** A stream counting up, sample by sample. */
+class CountingStream : public Sound::AudioStream {
+public:
+	CountingStream(int channels, size_t length) : _channels(channels), _length(length), _pos(0) {
+	}
+
+	size_t readBuffer(int16 *buffer, const size_t numSamples) {
+		const size_t n = MIN(numSamples, _length - _pos);
+
+		for (size_t i = 0; i < n; i++)
+			buffer[i] = (int16) _pos++;
+
+		return n;
+	}
+
+	int getChannels() const {
+		return _channels;
+	}
+
+	int getRate() const {
+		return 22050;
+	}
+
+	bool endOfData() const {
+		return _pos >= _length;
+	}
+
+private:
+	int _channels;
+
+	size_t _length;
+	size_t _pos;
+};
+
+/** A stream failing on every read. */
+class BrokenStream : public Sound::AudioStream {
+public:
+	BrokenStream() : _reads(0) {
+	}
+
+	size_t readBuffer(int16 *UNUSED(buffer), const size_t UNUSED(numSamples)) {
+		_reads++;
+
+		return kSizeInvalid;
+	}
+
+	int getChannels() const {
+		return 1;
+	}
+
+	int getRate() const {
+		return 22050;
+	}
+
+	bool endOfData() const {
+		return false;
+	}
+
+	size_t getReads() const {
+		return _reads;
+	}
+
+private:
+	size_t _reads;
+};
+
+/** Read the whole stream, checking that it's counting up. */
+static void readCounting(Sound::AudioStream &stream, size_t length, size_t chunk) {
+	std::vector<int16> buffer(chunk);
+
+	size_t pos = 0;
+	while (!stream.endOfStream()) {
+		const size_t n = stream.readBuffer(&buffer[0], chunk);
+		if (n == 0) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		for (size_t i = 0; i < n; i++, pos++)
+			ASSERT_EQ(buffer[i], (int16) pos) << "At sample " << pos;
+	}
+
+	EXPECT_EQ(pos, length);
+}
+
+GTEST_TEST(SampleRingBuffer, wrapAround) {
+	Sound::SampleRingBuffer ring(10);
+
+	EXPECT_EQ(ring.getCapacity(), 10U);
+	EXPECT_EQ(ring.getFill(), 0U);
+	EXPECT_EQ(ring.getFree(), 10U);
+
+	int16 data[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+	int16 read[12];
+
+	EXPECT_EQ(ring.write(data, 12), 10U);
+	EXPECT_EQ(ring.getFree(), 0U);
+
+	EXPECT_EQ(ring.read(read, 7), 7U);
+	for (int i = 0; i < 7; i++)
+		EXPECT_EQ(read[i], i);
+
+	// Wraps around the end of the buffer
+	EXPECT_EQ(ring.write(data, 5), 5U);
+	EXPECT_EQ(ring.getFill(), 8U);
+
+	EXPECT_EQ(ring.read(read, 12), 8U);
+	for (int i = 0; i < 3; i++)
+		EXPECT_EQ(read[i], i + 7);
+	for (int i = 0; i < 5; i++)
+		EXPECT_EQ(read[i + 3], i);
+
+	EXPECT_EQ(ring.read(read, 12), 0U);
+
+	// The write pointer only ever offers contiguous space
+	size_t space;
+	int16 *dest = ring.getWritePointer(space);
+	EXPECT_EQ(space, 5U);
+
+	dest[0] = 42;
+	ring.commitWrite(1);
+
+	EXPECT_EQ(ring.read(read, 1), 1U);
+	EXPECT_EQ(read[0], 42);
+}
+
+static void produce(Sound::SampleRingBuffer *ring, size_t length) {
+	size_t pos = 0;
+	for (size_t chunk = 1; pos < length; chunk = (chunk * 7) % 113 + 1) {
+		int16 data[128];
+
+		const size_t n = MIN(chunk, length - pos);
+		for (size_t i = 0; i < n; i++)
+			data[i] = (int16) (pos + i);
+
+		const size_t written = ring->write(data, n);
+		if (written == 0)
+			std::this_thread::yield();
+
+		pos += written;
+	}
+}
+
+GTEST_TEST(SampleRingBuffer, threads) {
+	static const size_t kLength = 1000000;
+
+	Sound::SampleRingBuffer ring(1000);
+
+	std::thread producer(&produce, &ring, kLength);
+
+	size_t pos = 0;
+	for (size_t chunk = 1; pos < kLength; chunk = (chunk * 5) % 127 + 1) {
+		int16 data[128];
+
+		const size_t n = ring.read(data, chunk);
+		if (n == 0)
+			std::this_thread::yield();
+
+		for (size_t i = 0; i < n; i++, pos++)
+			ASSERT_EQ(data[i], (int16) pos) << "At sample " << pos;
+	}
+
+	producer.join();
+
+	EXPECT_EQ(ring.getFill(), 0U);
+}
+
+GTEST_TEST(DecodeAhead, fill) {
+	Sound::DecodeAheadStream stream(new CountingStream(2, 30000), true, 10001);
+
+	EXPECT_EQ(stream.getChannels(), 2);
+	EXPECT_EQ(stream.getRate(), 22050);
+
+	// Nothing decoded yet
+	int16 buffer[16];
+	EXPECT_EQ(stream.readBuffer(buffer, 16), 0U);
+	EXPECT_EQ(stream.getUnderruns(), 1U);
+	EXPECT_FALSE(stream.endOfData());
+
+	// Whole frames only: 10000 samples fit
+	stream.fill();
+	EXPECT_FALSE(stream.endOfData());
+
+	std::vector<int16> data(20000);
+	EXPECT_EQ(stream.readBuffer(&data[0], data.size()), 10000U);
+	for (size_t i = 0; i < 10000; i++)
+		ASSERT_EQ(data[i], (int16) i) << "At sample " << i;
+
+	stream.fill();
+	EXPECT_EQ(stream.readBuffer(&data[0], data.size()), 10000U);
+	stream.fill();
+	EXPECT_EQ(stream.readBuffer(&data[0], data.size()), 10000U);
+	EXPECT_EQ(data[9999], (int16) 29999);
+
+	stream.fill();
+	EXPECT_TRUE(stream.endOfData());
+	EXPECT_TRUE(stream.endOfStream());
+
+	// Running dry at the end isn't an underrun
+	EXPECT_EQ(stream.readBuffer(buffer, 16), 0U);
+	EXPECT_EQ(stream.getUnderruns(), 1U);
+}
+
+GTEST_TEST(DecodeAhead, seed) {
+	Sound::DecodeAheadStream stream(new CountingStream(1, 100000), true, 65536);
+
+	// Only one chunk, not the whole buffer
+	stream.seed();
+
+	std::vector<int16> data(65536);
+	const size_t n = stream.readBuffer(&data[0], data.size());
+	EXPECT_GT(n, 0U);
+	EXPECT_LT(n, data.size());
+
+	for (size_t i = 0; i < n; i++)
+		ASSERT_EQ(data[i], (int16) i) << "At sample " << i;
+
+	EXPECT_FALSE(stream.endOfData());
+	EXPECT_EQ(stream.getUnderruns(), 0U);
+}
+
+GTEST_TEST(DecodeAhead, brokenStream) {
+	BrokenStream *broken = new BrokenStream;
+	Sound::DecodeAheadStream stream(broken, true, 4096);
+
+	// A failed read ends the stream, instead of being retried over and over
+	stream.fill();
+	EXPECT_EQ(broken->getReads(), 1U);
+
+	EXPECT_TRUE(stream.endOfData());
+	EXPECT_TRUE(stream.endOfStream());
+
+	stream.fill();
+	EXPECT_EQ(broken->getReads(), 1U);
+}
+
+GTEST_TEST(DecodeAhead, pool) {
+	static const size_t kStreams = 8;
+	static const size_t kLength  = 200000;
+
+	Sound::DecoderPool pool(2);
+
+	Common::PtrVector<Sound::DecodeAheadStream> streams;
+	for (size_t i = 0; i < kStreams; i++) {
+		streams.push_back(new Sound::DecodeAheadStream(new CountingStream(1 + (i % 2), kLength), true, 4096));
+
+		pool.addStream(streams.back());
+	}
+
+	for (size_t i = 0; i < kStreams; i++)
+		readCounting(*streams[i], kLength, 1000 + i * 17);
+
+	for (size_t i = 0; i < kStreams; i++)
+		pool.removeStream(streams[i]);
+}
+
+GTEST_TEST(DecodeAhead, remove) {
+	Sound::DecoderPool pool(2);
+
+	// Streams going away in the middle of decoding them
+	for (size_t i = 0; i < 50; i++) {
+		Sound::DecodeAheadStream stream(new CountingStream(2, 1000000), true, 8192);
+		pool.addStream(&stream);
+
+		int16 buffer[100];
+		for (size_t j = 0; j < i; j++)
+			stream.readBuffer(buffer, 100);
+
+		if (i % 2)
+			pool.removeStream(&stream);
+	}
+}
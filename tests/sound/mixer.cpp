@@ -0,0 +1,367 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the software mixer and its outputs.
+ */
+
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/scopedptr.h"
+#include "src/common/readfile.h"
+
+#include "src/sound/mixer.h"
+#include "src/sound/output.h"
+#include "src/sound/audiostream.h"
+
+#include "src/sound/decoders/wave.h"
+
+/** An audio stream playing a fixed list of samples. */
+class TestStream : public Sound::AudioStream {
+public:
+	TestStream(int channels, int rate, const std::vector<int16> &samples) :
+		_channels(channels), _rate(rate), _samples(samples), _pos(0) {
+	}
+
+	size_t readBuffer(int16 *buffer, const size_t numSamples) {
+		const size_t n = MIN(numSamples, _samples.size() - _pos);
+
+		for (size_t i = 0; i < n; i++)
+			buffer[i] = _samples[_pos++];
+
+		return n;
+	}
+
+	int getChannels() const {
+		return _channels;
+	}
+
+	int getRate() const {
+		return _rate;
+	}
+
+	bool endOfData() const {
+		return _pos >= _samples.size();
+	}
+
+private:
+	int _channels;
+	int _rate;
+
+	std::vector<int16> _samples;
+	size_t _pos;
+};
+
+/** A stream with all samples set to the same value. */
+static TestStream *makeConstant(int channels, int rate, size_t frames, int16 value) {
+	return new TestStream(channels, rate, std::vector<int16>(frames * channels, value));
+}
+
+/** A mono stream with samples rising from 0 by step. */
+static TestStream *makeRamp(int rate, size_t frames, int16 step) {
+	std::vector<int16> samples(frames);
+	for (size_t i = 0; i < frames; i++)
+		samples[i] = (int16) (i * step);
+
+	return new TestStream(1, rate, samples);
+}
+
+/** Mix this many frames and return the result. */
+static std::vector<int16> mix(Sound::Mixer &mixer, size_t frames) {
+	std::vector<int16> buffer(frames * 2, 0x7FFF);
+	mixer.mix(&buffer[0], frames);
+
+	return buffer;
+}
+
+GTEST_TEST(Mixer, silence) {
+	Sound::Mixer mixer(44100);
+
+	const std::vector<int16> output = mix(mixer, 100);
+	for (size_t i = 0; i < output.size(); i++)
+		ASSERT_EQ(output[i], 0) << "At index " << i;
+}
+
+GTEST_TEST(Mixer, gain) {
+	Sound::Mixer mixer(44100);
+
+	Common::ScopedPtr<TestStream> stream(makeConstant(1, 44100, 4000, 1000));
+
+	const size_t source = mixer.addSource(stream.get());
+	mixer.setSourceGain(source, 0.5f);
+	mixer.setListenerGain(0.8f);
+
+	// Not yet started
+	std::vector<int16> output = mix(mixer, 100);
+	EXPECT_EQ(output[0], 0);
+	EXPECT_EQ(mixer.getSourceSamplesPlayed(source), 0U);
+
+	mixer.setSourcePlaying(source, true);
+
+	output = mix(mixer, 3000);
+	for (size_t i = 0; i < output.size(); i++)
+		ASSERT_EQ(output[i], 400) << "At index " << i;
+
+	EXPECT_EQ(mixer.getSourceSamplesPlayed(source), 3000U);
+	EXPECT_FALSE(mixer.isSourceFinished(source));
+
+	// A paused source doesn't advance
+	mixer.setSourcePlaying(source, false);
+
+	output = mix(mixer, 100);
+	EXPECT_EQ(output[0], 0);
+	EXPECT_EQ(mixer.getSourceSamplesPlayed(source), 3000U);
+}
+
+GTEST_TEST(Mixer, stereo) {
+	Sound::Mixer mixer(22050);
+
+	std::vector<int16> samples;
+	for (int i = 0; i < 2000; i++) {
+		samples.push_back( i);
+		samples.push_back(-i);
+	}
+
+	Common::ScopedPtr<TestStream> stream(new TestStream(2, 22050, samples));
+
+	const size_t source = mixer.addSource(stream.get());
+	mixer.setSourcePlaying(source, true);
+
+	// Stereo sources are never positioned
+	mixer.setSourceRelative(source, false);
+	mixer.setSourcePosition(source, 100.0f, 0.0f, 0.0f);
+	mixer.setSourceDistance(source, 1.0f, 2.0f);
+
+	const std::vector<int16> output = mix(mixer, 2000);
+	for (size_t i = 0; i < output.size(); i++)
+		ASSERT_EQ(output[i], samples[i]) << "At index " << i;
+}
+
+GTEST_TEST(Mixer, finished) {
+	Sound::Mixer mixer(44100);
+
+	Common::ScopedPtr<TestStream> stream(makeConstant(1, 44100, 1500, 123));
+
+	const size_t source = mixer.addSource(stream.get());
+	mixer.setSourcePlaying(source, true);
+
+	const std::vector<int16> output = mix(mixer, 2000);
+	for (size_t i = 0; i < 1500 * 2; i++)
+		ASSERT_EQ(output[i], 123) << "At index " << i;
+	for (size_t i = 1500 * 2; i < output.size(); i++)
+		ASSERT_EQ(output[i], 0) << "At index " << i;
+
+	EXPECT_TRUE(mixer.isSourceFinished(source));
+	EXPECT_EQ(mixer.getSourceSamplesPlayed(source), 1500U);
+
+	mixer.removeSource(source);
+	EXPECT_THROW(mixer.isSourceFinished(source), Common::Exception);
+}
+
+GTEST_TEST(Mixer, resample) {
+	Sound::Mixer mixer(44100);
+
+	// Half the rate: every other output frame is halfway between two input frames
+	Common::ScopedPtr<TestStream> stream(makeRamp(22050, 3000, 10));
+
+	const size_t source = mixer.addSource(stream.get());
+	mixer.setSourcePlaying(source, true);
+
+	const std::vector<int16> output = mix(mixer, 5000);
+	for (size_t i = 0; i < 5000; i++) {
+		ASSERT_EQ(output[i * 2 + 0], (int16) (i * 5)) << "At frame " << i;
+		ASSERT_EQ(output[i * 2 + 1], (int16) (i * 5)) << "At frame " << i;
+	}
+
+	EXPECT_EQ(mixer.getSourceSamplesPlayed(source), 2500U);
+}
+
+GTEST_TEST(Mixer, pitch) {
+	Sound::Mixer mixer(44100);
+
+	Common::ScopedPtr<TestStream> stream(makeRamp(44100, 3000, 10));
+
+	const size_t source = mixer.addSource(stream.get());
+	mixer.setSourcePitch(source, 2.0f);
+	mixer.setSourcePlaying(source, true);
+
+	// Double the pitch: every other input frame is skipped
+	const std::vector<int16> output = mix(mixer, 1400);
+	for (size_t i = 0; i < 1400; i++)
+		ASSERT_EQ(output[i * 2], (int16) (i * 20)) << "At frame " << i;
+
+	EXPECT_EQ(mixer.getSourceSamplesPlayed(source), 2800U);
+
+	mix(mixer, 200);
+	EXPECT_TRUE(mixer.isSourceFinished(source));
+	EXPECT_EQ(mixer.getSourceSamplesPlayed(source), 3000U);
+}
+
+GTEST_TEST(Mixer, distance) {
+	Sound::Mixer mixer(44100);
+
+	Common::ScopedPtr<TestStream> stream(makeConstant(1, 44100, 1000, 1000));
+
+	const size_t source = mixer.addSource(stream.get());
+	mixer.setSourcePlaying(source, true);
+	mixer.setSourceRelative(source, false);
+	mixer.setSourceDistance(source, 2.0f, 10.0f);
+
+	mixer.setListenerPosition(1.0f, 2.0f, 3.0f);
+
+	// Straight ahead, halfway between the minimum and maximum distance
+	mixer.setSourcePosition(source, 1.0f, 2.0f, -3.0f);
+
+	std::vector<int16> output = mix(mixer, 100);
+	EXPECT_EQ(output[0], 500);
+	EXPECT_EQ(output[1], 500);
+
+	// Closer than the minimum distance
+	mixer.setSourcePosition(source, 1.0f, 2.0f, 2.0f);
+
+	output = mix(mixer, 100);
+	EXPECT_EQ(output[0], 1000);
+	EXPECT_EQ(output[1], 1000);
+
+	// Further away than the maximum distance
+	mixer.setSourcePosition(source, 1.0f, 2.0f, 30.0f);
+
+	output = mix(mixer, 100);
+	EXPECT_EQ(output[0], 0);
+	EXPECT_EQ(output[1], 0);
+}
+
+GTEST_TEST(Mixer, panning) {
+	Sound::Mixer mixer(44100);
+
+	Common::ScopedPtr<TestStream> stream(makeConstant(1, 44100, 1000, 1000));
+
+	const size_t source = mixer.addSource(stream.get());
+	mixer.setSourcePlaying(source, true);
+
+	// Relative sources are in the listener's coordinate system, with +X to the right
+	mixer.setSourcePosition(source, 1.0f, 0.0f, 0.0f);
+
+	std::vector<int16> output = mix(mixer, 100);
+	EXPECT_EQ(output[0], 0);
+	EXPECT_EQ(output[1], 1000);
+
+	// Looking along +X, a source at +Z is to the right
+	mixer.setSourceRelative(source, false);
+	mixer.setSourcePosition(source, 0.0f, 0.0f, 1.0f);
+	mixer.setListenerOrientation(1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f);
+
+	output = mix(mixer, 100);
+	EXPECT_EQ(output[0], 0);
+	EXPECT_EQ(output[1], 1000);
+
+	// Diagonally in front and to the left
+	mixer.setSourcePosition(source, 1.0f, 0.0f, -1.0f);
+
+	output = mix(mixer, 100);
+	EXPECT_EQ(output[0], 1000);
+	EXPECT_EQ(output[1], 293);
+}
+
+GTEST_TEST(Mixer, downmix) {
+	Sound::Mixer mixer(44100);
+
+	std::vector<int16> samples;
+	for (int i = 0; i < 100; i++) {
+		static const int16 frame[6] = { 1000, 2000, 100, 30000, 10, 20 };
+		samples.insert(samples.end(), frame, frame + 6);
+	}
+
+	Common::ScopedPtr<TestStream> stream(new TestStream(6, 44100, samples));
+
+	const size_t source = mixer.addSource(stream.get());
+	mixer.setSourcePlaying(source, true);
+
+	// The LFE channel is dropped, the center and rear channels are spread over the front
+	const std::vector<int16> output = mix(mixer, 100);
+	EXPECT_EQ(output[0], 1078);
+	EXPECT_EQ(output[1], 2085);
+}
+
+GTEST_TEST(Mixer, saturate) {
+	Sound::Mixer mixer(44100);
+
+	Common::ScopedPtr<TestStream> stream1(makeConstant(1, 44100, 1000,  30000));
+	Common::ScopedPtr<TestStream> stream2(makeConstant(1, 44100, 1000,  30000));
+	Common::ScopedPtr<TestStream> stream3(makeConstant(2, 44100, 1000, -30000));
+
+	const size_t source1 = mixer.addSource(stream1.get());
+	const size_t source2 = mixer.addSource(stream2.get());
+	mixer.setSourcePlaying(source1, true);
+	mixer.setSourcePlaying(source2, true);
+
+	std::vector<int16> output = mix(mixer, 500);
+	EXPECT_EQ(output[0], 32767);
+	EXPECT_EQ(output[999], 32767);
+
+	mixer.removeSource(source1);
+	mixer.removeSource(source2);
+
+	const size_t source3 = mixer.addSource(stream3.get());
+	mixer.setSourceGain(source3, 2.0f);
+	mixer.setSourcePlaying(source3, true);
+
+	output = mix(mixer, 500);
+	EXPECT_EQ(output[0], -32768);
+	EXPECT_EQ(output[999], -32768);
+}
+
+GTEST_TEST(Mixer, wavOutput) {
+	const boost::filesystem::path file = boost::filesystem::temp_directory_path() /
+	                                     boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.wav");
+
+	std::vector<int16> samples;
+	for (int i = 0; i < 500; i++) {
+		samples.push_back( i * 3);
+		samples.push_back(-i * 7);
+	}
+
+	{
+		Sound::WAVSoundOutput output(file.generic_string(), 22050);
+
+		output.write(&samples[0], 200);
+		output.write(&samples[400], 300);
+	}
+
+	Common::ScopedPtr<Sound::RewindableAudioStream>
+		wav(Sound::makeWAVStream(new Common::ReadFile(file.generic_string()), true));
+
+	ASSERT_EQ(wav->getChannels(), 2);
+	ASSERT_EQ(wav->getRate(), 22050);
+
+	std::vector<int16> read(samples.size() + 10);
+	ASSERT_EQ(wav->readBuffer(&read[0], read.size()), samples.size());
+
+	for (size_t i = 0; i < samples.size(); i++)
+		ASSERT_EQ(read[i], samples[i]) << "At index " << i;
+
+	wav.reset();
+	boost::filesystem::remove(file);
+}
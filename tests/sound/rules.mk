@@ -0,0 +1,43 @@
+# xoreos - A reimplementation of BioWare's Aurora engine
+#
+# xoreos is the legal property of its developers, whose names
+# can be found in the AUTHORS file distributed with this source
+# distribution.
+#
+# xoreos is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# xoreos is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+
+
+# Unit tests for the Sound namespace.
+
+sound_LIBS = \
+    $(test_LIBS) \
+    src/sound/libsound.la \
+    src/common/libcommon.la \
+    tests/version/libversion.la \
+    $(LDADD)
+
+check_PROGRAMS                 += tests/sound/test_mixer
+tests_sound_test_mixer_SOURCES  = tests/sound/mixer.cpp
+tests_sound_test_mixer_LDADD    = $(sound_LIBS)
+tests_sound_test_mixer_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                       += tests/sound/test_decodeahead
+tests_sound_test_decodeahead_SOURCES  = tests/sound/decodeahead.cpp
+tests_sound_test_decodeahead_LDADD    = $(sound_LIBS)
+tests_sound_test_decodeahead_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                         += tests/sound/test_soundbankdata
+tests_sound_test_soundbankdata_SOURCES  = tests/sound/soundbankdata.cpp
+tests_sound_test_soundbankdata_LDADD    = $(sound_LIBS)
+tests_sound_test_soundbankdata_CXXFLAGS = $(test_CXXFLAGS)
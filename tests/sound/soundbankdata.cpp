@@ -0,0 +1,215 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for reading sounds out of shared sound bank data.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+#include "src/common/thread.h"
+
+#include "src/sound/soundbankdata.h"
+#include "src/sound/xactwavebank_binary.h"
+#include "src/sound/audiostream.h"
+
+static const byte kBankData[] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F
+};
+
+/** A stream of the bank data that's not in memory, as far as the bank knows. */
+static Common::SeekableReadStream *createFileBank() {
+	return new Common::SeekableSubReadStream(new Common::MemoryReadStream(kBankData), 0, sizeof(kBankData), true);
+}
+
+static void testBankStream(const std::shared_ptr<const Sound::SoundBankData> &bank) {
+	Sound::SoundBankReadStream stream1(bank,  4, 8);
+	Sound::SoundBankReadStream stream2(bank, 10, 6);
+
+	EXPECT_EQ(stream1.size(), 8U);
+	EXPECT_EQ(stream2.size(), 6U);
+
+	// Both streams have their own position
+	EXPECT_EQ(stream1.readByte(), 0x04);
+	EXPECT_EQ(stream2.readByte(), 0x0A);
+	EXPECT_EQ(stream1.readByte(), 0x05);
+	EXPECT_EQ(stream2.readByte(), 0x0B);
+
+	EXPECT_EQ(stream1.pos(), 2U);
+	EXPECT_EQ(stream2.pos(), 2U);
+
+	byte data[16];
+	EXPECT_EQ(stream1.read(data, 16), 6U);
+	EXPECT_TRUE(stream1.eos());
+	for (size_t i = 0; i < 6; i++)
+		EXPECT_EQ(data[i], 0x06 + i) << "At index " << i;
+
+	stream1.seek(-3, Common::SeekableReadStream::kOriginEnd);
+	EXPECT_FALSE(stream1.eos());
+	EXPECT_EQ(stream1.readByte(), 0x09);
+
+	EXPECT_THROW(stream1.seek(9), Common::Exception);
+
+	EXPECT_EQ(stream2.read(data, 4), 4U);
+	EXPECT_FALSE(stream2.eos());
+	EXPECT_EQ(data[3], 0x0F);
+}
+
+GTEST_TEST(SoundBankData, inMemory) {
+	std::shared_ptr<const Sound::SoundBankData> bank =
+		std::make_shared<const Sound::SoundBankData>(new Common::MemoryReadStream(kBankData));
+
+	EXPECT_TRUE(bank->isInMemory());
+	EXPECT_EQ(bank->size(), sizeof(kBankData));
+
+	testBankStream(bank);
+}
+
+GTEST_TEST(SoundBankData, fromStream) {
+	std::shared_ptr<const Sound::SoundBankData> bank = std::make_shared<const Sound::SoundBankData>(createFileBank());
+
+	EXPECT_FALSE(bank->isInMemory());
+	EXPECT_EQ(bank->size(), sizeof(kBankData));
+
+	testBankStream(bank);
+}
+
+GTEST_TEST(SoundBankData, outOfRange) {
+	std::shared_ptr<const Sound::SoundBankData> bank =
+		std::make_shared<const Sound::SoundBankData>(new Common::MemoryReadStream(kBankData));
+
+	EXPECT_THROW(Sound::SoundBankReadStream(bank, 8, 9), Common::Exception);
+	EXPECT_THROW(Sound::SoundBankReadStream(bank, 17, 0), Common::Exception);
+	EXPECT_NO_THROW(Sound::SoundBankReadStream(bank, 16, 0));
+}
+
+GTEST_TEST(SoundBankData, keepAlive) {
+	std::shared_ptr<const Sound::SoundBankData> bank = std::make_shared<const Sound::SoundBankData>(createFileBank());
+
+	Sound::SoundBankReadStream stream(bank, 8, 8);
+
+	// The stream still needs the bank
+	bank.reset();
+
+	EXPECT_EQ(stream.readUint32BE(), 0x08090A0BU);
+}
+
+static void readBank(const std::shared_ptr<const Sound::SoundBankData> *bank, size_t offset, bool *good) {
+	Sound::SoundBankReadStream stream(*bank, offset, sizeof(kBankData) - offset);
+
+	for (size_t i = 0; i < 10000; i++) {
+		stream.seek(0);
+
+		for (size_t j = offset; j < sizeof(kBankData); j++)
+			if (stream.readByte() != j)
+				*good = false;
+	}
+}
+
+GTEST_TEST(SoundBankData, threads) {
+	std::shared_ptr<const Sound::SoundBankData> bank = std::make_shared<const Sound::SoundBankData>(createFileBank());
+
+	bool good[4] = { true, true, true, true };
+
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < ARRAYSIZE(good); i++)
+		threads.push_back(std::thread(&readBank, &bank, i, &good[i]));
+
+	for (std::vector<std::thread>::iterator t = threads.begin(); t != threads.end(); ++t)
+		t->join();
+
+	for (size_t i = 0; i < ARRAYSIZE(good); i++)
+		EXPECT_TRUE(good[i]) << "In thread " << i;
+}
+
+/** Create a binary XWB with two 8-bit mono PCM waves. */
+static Common::SeekableReadStream *createXWB() {
+	Common::MemoryWriteStreamDynamic xwb(true);
+
+	xwb.writeUint32BE(MKTAG('W', 'B', 'N', 'D'));
+	xwb.writeUint32LE(3);
+
+	// Segments: bank data, entry meta data, entry names, wave data
+	xwb.writeUint32LE(40);  xwb.writeUint32LE(36);
+	xwb.writeUint32LE(76);  xwb.writeUint32LE(48);
+	xwb.writeUint32LE(0);   xwb.writeUint32LE(0);
+	xwb.writeUint32LE(124); xwb.writeUint32LE(12);
+
+	xwb.writeUint32LE(0); // Flags
+	xwb.writeUint32LE(2); // Wave count
+	xwb.writeString("testbank");
+	xwb.writeZeros(8);
+	xwb.writeUint32LE(24); // Wave meta data size
+	xwb.writeUint32LE(0);
+	xwb.writeUint32LE(0);
+
+	// PCM, 1 channel, 22050Hz, 8 bits
+	const uint32 format = (1 << 2) | (22050 << 5);
+
+	for (uint32 i = 0; i < 2; i++) {
+		xwb.writeUint32LE(0);
+		xwb.writeUint32LE(format);
+		xwb.writeUint32LE(i * 4); // Offset
+		xwb.writeUint32LE(4 + i * 4); // Size
+		xwb.writeUint32LE(0);
+		xwb.writeUint32LE(0);
+	}
+
+	static const byte kWaves[] = { 0x80, 0x81, 0x82, 0x83, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97 };
+	xwb.write(kWaves, sizeof(kWaves));
+
+	xwb.setDisposable(false);
+	return new Common::MemoryReadStream(xwb.getData(), xwb.size(), true);
+}
+
+GTEST_TEST(XACTWaveBank_Binary, getWave) {
+	Sound::XACTWaveBank_Binary bank(createXWB());
+
+	EXPECT_STREQ(bank.getName().c_str(), "testbank");
+	ASSERT_EQ(bank.getWaveCount(), 2U);
+
+	std::unique_ptr<Sound::RewindableAudioStream> wave0(bank.getWave(0));
+	std::unique_ptr<Sound::RewindableAudioStream> wave1(bank.getWave(1));
+
+	EXPECT_EQ(wave0->getChannels(), 1);
+	EXPECT_EQ(wave0->getRate(), 22050);
+
+	// Both waves decode independently from the same bank
+	int16 samples0[8], samples1[8];
+	EXPECT_EQ(wave0->readBuffer(samples0, 2), 2U);
+	EXPECT_EQ(wave1->readBuffer(samples1, 8), 8U);
+	EXPECT_EQ(wave0->readBuffer(samples0 + 2, 6), 2U);
+
+	for (int i = 0; i < 4; i++)
+		EXPECT_EQ(samples0[i], i << 8) << "At sample " << i;
+	for (int i = 0; i < 8; i++)
+		EXPECT_EQ(samples1[i], (0x10 + i) << 8) << "At sample " << i;
+
+	EXPECT_TRUE(wave0->endOfData());
+	EXPECT_TRUE(wave0->rewind());
+	EXPECT_EQ(wave0->readBuffer(samples0, 1), 1U);
+	EXPECT_EQ(samples0[0], 0);
+}
@@ -0,0 +1,171 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the Bink video DSP routines.
+ */
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+
+#include "src/video/binkdsp.h"
+
+namespace BinkDSP = Video::BinkDSP;
+
+static const uint32 kPitch = 24;
+
+/** A simple, deterministic pseudo-random number generator. */
+class Random {
+public:
+	Random(uint32 seed) : _state(seed) {
+	}
+
+	uint32 next() {
+		_state = _state * 1664525 + 1013904223;
+		return _state >> 8;
+	}
+
+private:
+	uint32 _state;
+};
+
+/** Fill a block with random coefficients, similar to what a Bink video contains. */
+static void createBlock(Random &random, int16 *block, int range, int coefficients) {
+	std::memset(block, 0, 64 * sizeof(int16));
+
+	block[0] = (int16) ((int) (random.next() % (2 * range + 1)) - range);
+
+	for (int i = 0; i < coefficients; i++)
+		block[random.next() % 64] = (int16) ((int) (random.next() % (2 * range + 1)) - range);
+}
+
+static void createPixels(Random &random, byte *pixels, size_t size) {
+	for (size_t i = 0; i < size; i++)
+		pixels[i] = random.next();
+}
+
+/** Run all DSP functions on random blocks and compare them with the plain C implementations. */
+static void compareDSP(int range, int coefficients) {
+	Random random(range * 64 + coefficients);
+
+	for (int n = 0; n < 1000; n++) {
+		int16 block[64];
+		createBlock(random, block, range, coefficients);
+
+		int16 idct1[64], idct2[64];
+		BinkDSP::Reference::idct(idct1, block);
+		BinkDSP::idct(idct2, block);
+
+		for (int i = 0; i < 64; i++)
+			ASSERT_EQ(idct2[i], idct1[i]) << "At block " << n << ", coefficient " << i;
+
+		byte pixels1[16 * kPitch], pixels2[16 * kPitch];
+		createPixels(random, pixels1, sizeof(pixels1));
+		std::memcpy(pixels2, pixels1, sizeof(pixels1));
+
+		BinkDSP::Reference::idctPut(pixels1, kPitch, block);
+		BinkDSP::idctPut(pixels2, kPitch, block);
+		ASSERT_EQ(std::memcmp(pixels2, pixels1, sizeof(pixels1)), 0) << "At block " << n;
+
+		BinkDSP::Reference::idctAdd(pixels1 + 3, kPitch, block);
+		BinkDSP::idctAdd(pixels2 + 3, kPitch, block);
+		ASSERT_EQ(std::memcmp(pixels2, pixels1, sizeof(pixels1)), 0) << "At block " << n;
+
+		BinkDSP::Reference::addPixels(pixels1 + 5, kPitch, block);
+		BinkDSP::addPixels(pixels2 + 5, kPitch, block);
+		ASSERT_EQ(std::memcmp(pixels2, pixels1, sizeof(pixels1)), 0) << "At block " << n;
+
+		BinkDSP::Reference::putPixelsScaled(pixels1 + 1, kPitch, idct1);
+		BinkDSP::putPixelsScaled(pixels2 + 1, kPitch, idct2);
+		ASSERT_EQ(std::memcmp(pixels2, pixels1, sizeof(pixels1)), 0) << "At block " << n;
+
+		byte raw[64];
+		createPixels(random, raw, sizeof(raw));
+
+		BinkDSP::Reference::putPixelsScaled(pixels1 + 7, kPitch, raw);
+		BinkDSP::putPixelsScaled(pixels2 + 7, kPitch, raw);
+		ASSERT_EQ(std::memcmp(pixels2, pixels1, sizeof(pixels1)), 0) << "At block " << n;
+	}
+}
+
+GTEST_TEST(BinkDSP, dcOnly) {
+	compareDSP(2048, 0);
+}
+
+GTEST_TEST(BinkDSP, sparse) {
+	compareDSP(512, 6);
+}
+
+GTEST_TEST(BinkDSP, dense) {
+	compareDSP(2048, 64);
+}
+
+GTEST_TEST(BinkDSP, fullRange) {
+	compareDSP(32767, 64);
+}
+
+GTEST_TEST(BinkDSP, narrowPlane) {
+	Random random(9);
+
+	// A 16x16 area in a plane narrower than 16 pixels overlaps itself
+	for (uint32 pitch = 8; pitch < 16; pitch++) {
+		byte raw[64];
+		createPixels(random, raw, sizeof(raw));
+
+		int16 block[64];
+		for (int i = 0; i < 64; i++)
+			block[i] = (int16) random.next();
+
+		byte pixels1[18 * 16], pixels2[18 * 16];
+		std::memset(pixels1, 0, sizeof(pixels1));
+		std::memset(pixels2, 0, sizeof(pixels2));
+
+		BinkDSP::Reference::putPixelsScaled(pixels1, pitch, raw);
+		BinkDSP::putPixelsScaled(pixels2, pitch, raw);
+		ASSERT_EQ(std::memcmp(pixels2, pixels1, sizeof(pixels1)), 0) << "With pitch " << pitch;
+
+		BinkDSP::Reference::putPixelsScaled(pixels1, pitch, block);
+		BinkDSP::putPixelsScaled(pixels2, pitch, block);
+		ASSERT_EQ(std::memcmp(pixels2, pixels1, sizeof(pixels1)), 0) << "With pitch " << pitch;
+	}
+}
+
+GTEST_TEST(BinkDSP, referenceDC) {
+	int16 block[64] = { 0 };
+	block[0] = 64 << 8;
+
+	// A DC-only block results in a flat block of DC / 256
+	int16 result[64];
+	BinkDSP::Reference::idct(result, block);
+
+	for (int i = 0; i < 64; i++)
+		EXPECT_EQ(result[i], 64) << "At index " << i;
+
+	byte pixels[8 * 8];
+	std::memset(pixels, 0xFF, sizeof(pixels));
+
+	BinkDSP::idctAdd(pixels, 8, block);
+
+	for (int i = 0; i < 64; i++)
+		EXPECT_EQ(pixels[i], 63) << "At index " << i;
+}